@@ -52,6 +52,7 @@
 #include "../mod_misc/filesystools.h"
 #include "../mod_misc/lib_conversions.h"
 #include "../mod_video/crrc_graphics.h"
+#include "../mod_video/offscreen.h"
 
 
 #ifdef linux
@@ -100,6 +101,22 @@ static void robot_rm_all_cb(puObject*);
 
 #define VERBOSITY_FONT_FILE "textures/Helvetica_iso8859-15.txf"
 
+
+/**
+ *  Window callbacks for PUI when rendering offscreen: there is no
+ *  SDL video surface to ask for the window size.
+ */
+static int offscreenGetWindow()
+{
+  return 0;
+}
+
+static void offscreenGetWindowSize(int* width, int* height)
+{
+  *width  = Video::window_xsize;
+  *height = Video::window_ysize;
+}
+
 /** \brief Create the GUI object.
  *
  *  Creates the GUI and sets its "visible" state.
@@ -109,6 +126,10 @@ CGUIMain::CGUIMain(bool vis) : visible(vis)
 {
   fntInit();
   puInit();
+  if (Video::offscreenEnabled())
+  {
+    puSetWindowFuncs(offscreenGetWindow, NULL, offscreenGetWindowSize, NULL);
+  }
   puSetDefaultStyle(PUSTYLE_SMALL_BEVELLED);
 
   // Light grey, no transparency
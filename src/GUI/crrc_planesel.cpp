@@ -813,9 +813,65 @@ void CGUIPlaneSelGraphicsCallback(puObject *obj)
 }
 
 
+/** \brief Called when the selected plane has been loaded.
+ *
+ *  Apply the default launch settings if the user wants them and
+ *  start the new model.
+ */
+static void CGUIPlaneSelLoaded(std::string const& strError)
+{
+  if (strError != "")
+  {
+    std::string s = "Unable to load airplane file:\n";
+    s += strError;
+    fprintf(stderr, "%s\n", s.c_str());
+    crrc_exit(CRRC_EXIT_FAILURE, s.c_str());
+    return;
+  }
+
+  // check if the user wants to load the default launch settings
+  // for this airplane
+  if (cfgfile->getInt("airplane.use_default_launch", 0) == 1)
+  {
+    // first check if there's a default at all...
+    SimpleXMLTransfer *presets;
+    presets = Global::aircraft->getFDMInterface()->getLaunchPresets();
+    if (presets != NULL)
+    {
+      // o.k., take the values from the first preset
+      SimpleXMLTransfer *def_launch = presets->getChildAt(0);
+      cfgfile->setAttributeOverwrite("launch.altitude", 
+                                     def_launch->getString("altitude", "0.0"));
+
+      cfgfile->setAttributeOverwrite("launch.velocity_rel", 
+                                     def_launch->getString("velocity_rel", "0.0"));
+      
+      cfgfile->setAttributeOverwrite("launch.angle", 
+                                     def_launch->getString("angle", "0.0"));
+      
+      cfgfile->setAttributeOverwrite("launch.sal", 
+                                     def_launch->getString("sal", "0"));
+      cfgfile->setAttributeOverwrite("launch.rel_to_player", 
+                                     def_launch->getString("rel_to_player", "1"));
+      cfgfile->setAttributeOverwrite("launch.rel_front",     
+                                     def_launch->getString("rel_front", doubleToString(MODELSTART_REL_FRONT)));
+      cfgfile->setAttributeOverwrite("launch.rel_right", 
+                                     def_launch->getString("rel_right", doubleToString(MODELSTART_REL_RIGHT)));
+    }
+    
+  }
+          
+  initialize_flight_model();
+  if (Global::soundserver != (CRRCAudioServer*)0)
+    Global::soundserver->pause(false);
+}
+
+
 /** \brief The dialog's callback.
  *
- *  Determine if a plane was selected and load the new model.
+ *  Determine if a plane was selected and load the new model. The
+ *  current model stays in use until the new one has been loaded in
+ *  the background.
  */
 void CGUIPlaneSelCallback(puObject *obj)
 {
@@ -829,58 +885,10 @@ void CGUIPlaneSelCallback(puObject *obj)
       // User selected an existing airplane, load the new model
             
       //~ std::cout << "selected: " << fname << std::endl;
-      Global::aircraft->setModel(NULL);
-
       cfgfile->setAttributeOverwrite("airplane.use_default_launch",
                                       (dlg->getLoadLaunchDefault() == 0) ? "0" : "1");
       
-      try
-      {
-        loadAirplane();
-        
-        // check if the user wants to load the default launch settings
-        // for this airplane
-        if (dlg->getLoadLaunchDefault() == 1)
-        {
-          // first check if there's a default at all...
-          SimpleXMLTransfer *presets;
-          presets = Global::aircraft->getFDMInterface()->getLaunchPresets();
-          if (presets != NULL)
-          {
-            // o.k., take the values from the first preset
-            SimpleXMLTransfer *def_launch = presets->getChildAt(0);
-            cfgfile->setAttributeOverwrite("launch.altitude", 
-                                           def_launch->getString("altitude", "0.0"));
-
-            cfgfile->setAttributeOverwrite("launch.velocity_rel", 
-                                           def_launch->getString("velocity_rel", "0.0"));
-            
-            cfgfile->setAttributeOverwrite("launch.angle", 
-                                           def_launch->getString("angle", "0.0"));
-            
-            cfgfile->setAttributeOverwrite("launch.sal", 
-                                           def_launch->getString("sal", "0"));
-            cfgfile->setAttributeOverwrite("launch.rel_to_player", 
-                                           def_launch->getString("rel_to_player", "1"));
-            cfgfile->setAttributeOverwrite("launch.rel_front",     
-                                           def_launch->getString("rel_front", doubleToString(MODELSTART_REL_FRONT)));
-            cfgfile->setAttributeOverwrite("launch.rel_right", 
-                                           def_launch->getString("rel_right", doubleToString(MODELSTART_REL_RIGHT)));
-          }
-          
-        }
-                
-        initialize_flight_model();
-        if (Global::soundserver != (CRRCAudioServer*)0)
-          Global::soundserver->pause(false);
-      }
-      catch (std::runtime_error& e)
-      {
-        std::string s = "Unable to load airplane file:\n";
-        s += e.what();
-        fprintf(stderr, "%s\n", s.c_str());
-        crrc_exit(CRRC_EXIT_FAILURE, s.c_str());
-      }
+      loadAirplaneInBackground(CGUIPlaneSelLoaded);
     }
   }
   
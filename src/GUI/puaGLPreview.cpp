@@ -45,6 +45,7 @@
  */
 
 #include "puaGLPreview.h"
+#include "../mod_video/asset_cache.h"
 
 // graphics parameters for the preview
 //
@@ -114,6 +115,7 @@ puaGLPreview::~puaGLPreview()
   if (geometry != NULL)
   {
     transInitial->removeKid(geometry);
+    Video::releaseModel(geometry);
   }
   transGeometry->removeKid(transInitial);
   scene->removeKid(transGeometry);
@@ -241,11 +243,14 @@ bool puaGLPreview::loadGeometry( const char * modelPath, const char * texturePat
   if (geometry != NULL)
   {     // free up any previous model
     transInitial->removeKid(geometry);
+    Video::releaseModel(geometry);
     geometry = NULL;
   }
 
-  ssgTexturePath(texturePath);    // load the model and textures via ssg
-  geometry = ssgLoad(modelPath);
+  // load the model and textures via ssg. going back and forth in the plane selection
+  // loads the same models again and again, so they are kept in the cache.
+  bool fNew;
+  geometry = Video::loadModel(modelPath, texturePath, "preview", fNew);
 
   // if the geometry load fails, we will setup the legend to indicate "huston, we have a problem."  otherwise, add
   // the geometry to the scene graph (as a child of the initial transform).  the initial transform is set to
@@ -44,6 +44,94 @@
 #include "mod_windfield/windfield.h"
 #include "robots.h"
 #include "record.h"
+#include "sim_thread.h"
+#include "latency_trace.h"
+#include "telemetry.h"
+
+/**
+ *  Simulation time after the last step of the flight model [s]
+ */
+static double dSubstepTime = 0;
+
+/**
+ *  Integrates the aircraft's EOMs and moves the thermals by multiloop
+ *  steps of Global::dt.
+ */
+void simulation_step(TSimInputs* inputs, int multiloop)
+{
+  // the inputs as the flight model gets them, it consumes the keys
+  TSimInputs recorded;
+  bool       fRecord = Global::recorder->IsDeterministic();
+  
+  if (fRecord)
+    recorded.CopyFrom(inputs);
+  
+  update_thermals(Global::dt * multiloop);
+
+  // the flight model reports its steps to simulation_substep()
+  dSubstepTime = Global::Simulation->getSimulationSecondsSinceReset();
+  Global::aircraft->getFDMInterface()->update(inputs, Global::dt, multiloop);
+  Global::Simulation->incSimSteps(multiloop);
+
+  if (fRecord)
+    Global::recorder->SimulationStep(multiloop, &recorded,
+                                     Global::aircraft->getFDMInterface()->fdm);
+
+  if (Global::latencyTrace && multiloop > 0)
+    Global::latencyTrace->step(inputs);
+}
+
+/**
+ *  The game mode and the telemetry look at every step of the flight
+ *  model, not only at the frames.
+ */
+void simulation_substep(double dt, FDMBase* fdm, TSimInputs* inputs)
+{
+  dSubstepTime += dt;
+
+  if (Global::gameHandler->followsSteps())
+  {
+    CRRCMath::Vector3 pos = fdm->getPos();
+    Global::gameHandler->step(dSubstepTime, pos.r[0], pos.r[1], -1*pos.r[2]);
+  }
+  if (Global::telemetry)
+    Global::telemetry->step(dSubstepTime, inputs, fdm);
+}
+
+/**
+ *  Everything which follows the aircraft once per frame: game mode,
+ *  recorder, robots, camera. multiloop is the number of simulation
+ *  steps since the last frame.
+ */
+static void frame_update(int multiloop)
+{
+  /**
+   * One if the aircraft is outside of the windfield simulation,
+   * zero otherwise.
+   */
+  int nAircraftOutsideWindfieldSim = 0;
+
+  if (nAircraftOutsideWindfieldSim)
+    Global::verboseString += " Outside windfield simulation!";
+
+  double X_cg_rwy =    Global::aircraft->getPos().r[0];
+  double Y_cg_rwy =    Global::aircraft->getPos().r[1];
+  double H_cg_rwy = -1*Global::aircraft->getPos().r[2];
+
+  Global::gameHandler->update(X_cg_rwy,Y_cg_rwy,H_cg_rwy, Global::recorder, Global::robots);
+  
+  Global::recorder->AirplanePosition(Global::dt, multiloop, Global::aircraft->getFDMInterface()->fdm);
+
+  // the states of the robots are updated by the simulation thread,
+  // they are published with its snapshots
+  if (Global::simThread == NULL)
+    Global::robots->Update(Global::dt, multiloop);  
+  
+  if(! Global::testmode.test_mode)//the camera is still on test_mode
+        Video::UpdateCamera(Global::dt * multiloop);
+  
+  Global::TXInterface->update(Global::dt * multiloop);
+}
 
 /// \todo current_time may be provided by the caller as a parameter
 void idle(TSimInputs* inputs)
@@ -55,11 +143,13 @@ void idle(TSimInputs* inputs)
   int   multiloop;
   int   current_time;
 
-  /**
-   * One if the aircraft is outside of the windfield simulation,
-   * zero otherwise.
-   */
-  int nAircraftOutsideWindfieldSim = 0;
+  // with a simulation thread, only the steps done since the last
+  // frame are followed
+  if (Global::simThread)
+  {
+    frame_update(Global::simThread->takeSteps());
+    return;
+  }
 
   current_time = Global::Simulation->getTotalTime();
   if (Global::Simulation->getState() == STATE_RESUMING)
@@ -78,28 +168,21 @@ void idle(TSimInputs* inputs)
   // The flight model should be calculated every dt seconds.
   multiloop=(int)(nDeltaTicks/1000.0/Global::dt - dDeltaT + 0.5);
   dDeltaT += multiloop*Global::dt - nDeltaTicks/1000.0;
-  update_thermals(Global::dt * multiloop);
-
-  Global::aircraft->getFDMInterface()->update(inputs, Global::dt, multiloop);
-  Global::Simulation->incSimSteps(multiloop);
-  
-  if (nAircraftOutsideWindfieldSim)
-    Global::verboseString += " Outside windfield simulation!";
 
-  double X_cg_rwy =    Global::aircraft->getPos().r[0];
-  double Y_cg_rwy =    Global::aircraft->getPos().r[1];
-  double H_cg_rwy = -1*Global::aircraft->getPos().r[2];
+  simulation_step(inputs, multiloop);
+  frame_update(multiloop);
+}
 
-  Global::gameHandler->update(X_cg_rwy,Y_cg_rwy,H_cg_rwy, Global::recorder, Global::robots);
-  
-  Global::recorder->AirplanePosition(Global::dt, multiloop, Global::aircraft->getFDMInterface()->fdm);
+/**
+ *  One step of the simulation thread.
+ */
+void simulation_thread_step(TSimInputs* inputs)
+{
+  if (Global::Simulation->getState() == STATE_RESUMING)
+    Global::Simulation->setState(STATE_RUN);
 
-  Global::robots->Update(Global::dt, multiloop);  
-  
-  if(! Global::testmode.test_mode)//the camera is still on test_mode
-        Video::UpdateCamera(Global::dt * multiloop);
-  
-  Global::TXInterface->update(Global::dt * multiloop);
+  simulation_step(inputs, 1);
+  Global::robots->UpdateStates(Global::dt, 1);
 }
 
 
@@ -109,9 +192,9 @@ void idle(TSimInputs* inputs)
  *
  */
 SimStateHandler::SimStateHandler()
-  : EventListener(Event::Generic),
-    nState(STATE_RESUMING), IdleFunc(idle), OldIdleFunc(NULL),
-    sim_steps(0), pause_time(0), accum_pause_time(0), reset_time(0)
+  : nState(STATE_RESUMING), IdleFunc(idle), OldIdleFunc(NULL),
+    sim_steps(0), pause_time(0), accum_pause_time(0), reset_time(0),
+    frame_time(0), fixed_clock(0), fCrashPending(false)
 {
 }
 
@@ -137,7 +220,7 @@ void SimStateHandler::resume()
     
     // add the time we spent in pause mode to the
     // accumulated pause time counter
-    accum_pause_time += SDL_GetTicks() - pause_time;
+    accum_pause_time += getTotalTime() - pause_time;
     
     if (Global::soundserver != NULL)
     {
@@ -158,7 +241,7 @@ void SimStateHandler::pause()
   {
     // entering pause mode from a different mode
     nState = STATE_PAUSED;
-    pause_time = SDL_GetTicks();
+    pause_time = getTotalTime();
   }
   if (Global::soundserver != NULL)
   {
@@ -187,7 +270,7 @@ void SimStateHandler::reset()
 
   sim_steps = 0;
   
-  current = SDL_GetTicks();
+  current = getTotalTime();
   reset_time = current;
   pause_time = current;
   accum_pause_time = 0;
@@ -198,8 +281,21 @@ void SimStateHandler::reset()
   */
   
   nState = STATE_RESUMING;
+  
+  // A recorded flight has to start from the same windfield every
+  // time. The random streams of the flight models are restarted by
+  // initAirplaneState().
+  if (Global::recorder->IsDeterministic())
+  {
+    clear_wind_field();
+    Init_mod_windfield();
+  }
+  
   initialize_flight_model();
     
+  if (Global::telemetry)
+    Global::telemetry->reset(Global::dt);
+  
   Global::gameHandler->reset();
   Global::robots->Reset();
   Global::TXInterface->reset();
@@ -238,14 +334,28 @@ void SimStateHandler::crash()
 
 
 /**
- *  Interface to the event dispatcher
+ *  Interface to the event bus
  */
-void SimStateHandler::operator()(const Event* ev)
+void SimStateHandler::operator()(const CrashEvent& ev)
 {
-  if (ev->getType() == Event::CrashEvent)
-  {
+  // the simulation thread must not touch the sound and the console,
+  // the next doIdle() handles the crash
+  if (Global::simThread && Global::simThread->isCurrentThread())
+    fCrashPending = true;
+  else
     crash();
-  }
+}
+
+
+/**
+ *  True if the simulation steps are to be run.
+ */
+bool SimStateHandler::isStepping() const
+{
+  if (Global::testmode.test_mode)
+    return true;
+  return (nState != STATE_EXIT) && (nState != STATE_PAUSED) &&
+         (nState != STATE_CRASHED) && !fCrashPending;
 }
 
 
@@ -256,13 +366,15 @@ void SimStateHandler::operator()(const Event* ev)
  */
 void SimStateHandler::doIdle(TSimInputs* in)
 {
+  if (fCrashPending)
+  {
+    fCrashPending = false;
+    crash();
+  }
+
   if (Global::gui && Global::gui->isVisible()) Global::gui->GUI_IdleFunction(in);
  
-  if ( Global::testmode.test_mode) idle(in);
-  else  if (
-      (nState != STATE_EXIT) &&
-      (nState != STATE_PAUSED) &&
-      (nState != STATE_CRASHED))
+  if (isStepping())
   {
     idle(in);
   }
@@ -305,7 +417,7 @@ void SimStateHandler::resetIdle()
  */
 unsigned long int SimStateHandler::getTotalTimeSinceReset()
 {
-  return (SDL_GetTicks() - reset_time);
+  return (getTotalTime() - reset_time);
 }
 
 
@@ -320,7 +432,7 @@ unsigned long int SimStateHandler::getGameTimeSinceReset()
   unsigned long int total_pause;
   unsigned long int current;
   
-  current = SDL_GetTicks();
+  current = getTotalTime();
   total_pause = accum_pause_time;
   if (nState == STATE_PAUSED)
   {
@@ -342,3 +454,15 @@ unsigned long int SimStateHandler::getSimulationTimeSinceReset()
 }
 
 
+/**
+ *  Returns the simulation time since the last reset()
+ *  (number of sim steps * dt, in s)
+ *
+ *  \return simulation time since last reset
+ */
+double SimStateHandler::getSimulationSecondsSinceReset()
+{
+  return sim_steps*Global::dt;
+}
+
+
@@ -36,9 +36,11 @@
 #define SIMSTATEHANDLER_H
 
 #include "mod_fdm/fdm_inputs.h"
-#include "mod_main/EventDispatcher.h"
+#include "mod_main/EventBus.h"
 #include <SDL.h>
 
+class FDMBase;
+
 // Typedef section :
 
 /// Function pointer to the "idle" function
@@ -55,6 +57,16 @@ typedef enum
 } T_SimState;  
 
 
+/// One step of the simulation thread, see SimThread
+void simulation_thread_step(TSimInputs* inputs);
+
+/// Thermals and aircraft only, multiloop steps, see ReplayVerifier
+void simulation_step(TSimInputs* inputs, int multiloop);
+
+/// Called after every step of the flight model, see FDMEnviroment::StepCallback()
+void simulation_substep(double dt, FDMBase* fdm, TSimInputs* inputs);
+
+
 /*****************************************************************************/
 // Classes section :
 
@@ -65,7 +77,7 @@ typedef enum
  *  in-game-time, ...).
  *  
  */
-class SimStateHandler : public EventListener
+class SimStateHandler : public EventListener<CrashEvent>
 {
   private:
     T_SimState    nState;         ///< state of the simulation
@@ -75,6 +87,9 @@ class SimStateHandler : public EventListener
     unsigned long int pause_time; ///< time when pause mode was entered
     unsigned long int accum_pause_time; ///< pause time since last reset
     unsigned long int reset_time; ///< time of the last reset
+    unsigned long int frame_time; ///< fixed time per frame, 0 to use the real time clock
+    unsigned long int fixed_clock; ///< current time if frame_time is used
+    bool          fCrashPending;  ///< crash seen by the simulation thread
   
     /// Handle a crash
     void crash();
@@ -107,6 +122,9 @@ class SimStateHandler : public EventListener
     /// run the current "idle" function
     void doIdle(TSimInputs* in);
     
+    /// true if the simulation is running (or in test mode)
+    bool isStepping() const;
+    
     /// temporarily switch to a different idle function
     void setNewIdle(TIdleFuncPtr new_idle);
     
@@ -117,7 +135,18 @@ class SimStateHandler : public EventListener
     void incSimSteps(int multiloop) {sim_steps += multiloop;};
     
     /// get the total time since the sim was launched (in ms)
-    unsigned long int getTotalTime() const {return SDL_GetTicks();};
+    unsigned long int getTotalTime() const
+      {return frame_time ? fixed_clock : SDL_GetTicks();};
+    
+    /// let the time advance by a fixed amount per frame instead of
+    /// following the real time clock (in ms, 0 to use the real time clock)
+    void setFixedFrameTime(unsigned long int ms) {frame_time = ms;};
+    
+    /// true if the time advances by a fixed amount per frame
+    bool isFixedFrameTime() const {return frame_time != 0;};
+    
+    /// advance the time by one frame if a fixed frame time is used
+    void nextFrame() {fixed_clock += frame_time;};
     
     /// get the time since the last reset (including pause time, in ms)
     unsigned long int getTotalTimeSinceReset();
@@ -127,9 +156,12 @@ class SimStateHandler : public EventListener
 
     /// get the simulation time since the last reset (number of sim steps * dt, in ms)
     unsigned long int getSimulationTimeSinceReset();
+
+    /// get the simulation time since the last reset (number of sim steps * dt, in s)
+    double getSimulationSecondsSinceReset();
     
-    /// interface to the EventDispatcher
-    void operator()(const Event* ev);
+    /// interface to the EventBus
+    void operator()(const CrashEvent& ev);
 };
 
 #endif  // SIMSTATEHANDLER_H
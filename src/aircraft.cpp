@@ -37,7 +37,8 @@
  * Create an Aircraft
  */
 Aircraft::Aircraft()
-: model_(NULL), fdmInterface(new ModFDMInterface()), fdmInterfaceBackup(NULL), latest_configfile(NULL)
+: model_(NULL), fdmInterface(new ModFDMInterface()), fdmInterfaceBackup(NULL), latest_configfile(NULL),
+  displayFDM(NULL)
 {
 }
 
@@ -80,6 +81,18 @@ CRRCMath::Vector3 Aircraft::getPos()
 }
 
 
+/**
+ * Get the FDM which is to be displayed: the Aircraft's FDM, or the
+ * one set by setDisplayFDM().
+ */
+FDMBase* Aircraft::getDisplayFDM() const
+{
+  if (displayFDM != NULL)
+    return displayFDM;
+  return getFDM();
+}
+
+
 /**
  * Set the Aircraft's FDM interface
  */
@@ -200,19 +213,29 @@ int Aircraft::loadDemo(std::string demofilename)
   return(0);
 }
 
-int Aircraft::load(SimpleXMLTransfer *configfile, FDMEnviroment* fdmEnvironment,
-                   bool fReloadOnly)
+/**
+ * The exception for an error in an airplane file.
+ */
+static std::runtime_error airplaneFileError(std::string const& filename, XMLException& e)
 {
-  int nRetCode = 1;
-  
-  if (!fReloadOnly)
-  {
-    latest_configfile = configfile;
-    cleanup();
-    fdmInterface = new ModFDMInterface();
-  }
+  std::string msg = "Error opening airplane specification file: ";
+  msg += filename;
+  msg += ": ";
+  msg += e.what();
 
-  std::string filename = configfile->getString("airplane.file", "models/allegro.xml");
+  return(std::runtime_error(msg));
+}
+
+
+/**
+ * Read the airplane file specified in configfile, with the graphics
+ * and config preferences of configfile.
+ *
+ * \param filename  set to the name of the file which has been read
+ */
+static SimpleXMLTransfer* loadAirplaneFile(SimpleXMLTransfer *configfile, std::string& filename)
+{
+  filename = configfile->getString("airplane.file", "models/allegro.xml");
   filename = air_to_xml_file_load(filename);
 
   try
@@ -227,33 +250,113 @@ int Aircraft::load(SimpleXMLTransfer *configfile, FDMEnviroment* fdmEnvironment,
     XMLModelFile::SetGraphics(xml, ap->attributeAsInt("graphics", 0));
     XMLModelFile::SetConfig  (xml, ap->attributeAsInt("config",   0));
 
-    if (fReloadOnly)
-      nRetCode = fdmInterface->ReloadParams(xml, configfile);
-    else
+    return(xml);
+  }
+  catch (XMLException e)
+  {
+    throw airplaneFileError(filename, e);
+  }  
+}
+
+
+AircraftStage::~AircraftStage()
+{
+  delete model;
+  delete fdmInterface;
+  delete xml;
+}
+
+
+AircraftStage* Aircraft::stage(SimpleXMLTransfer *configfile, FDMEnviroment* fdmEnvironment)
+{
+  AircraftStage* staged = new AircraftStage();
+  std::string    filename;
+
+  try
+  {
+    staged->xml          = loadAirplaneFile(configfile, filename);
+    staged->fdmInterface = new ModFDMInterface();
+    staged->fdmInterface->loadAirplane(staged->xml, fdmEnvironment, configfile);
+    if (staged->fdmInterface->fdm == NULL)
     {
-      fdmInterface->loadAirplane(xml, fdmEnvironment, configfile);
-      if (configfile->getInt("video.enabled", 1))
-      {
-        model_ = new CRRCAirplaneV2(xml);
-      }
+      throw std::runtime_error("Unable to load airplane specification file.");
     }
 
-    delete xml;
+    // last, a staged model has to be deleted by the main thread
+    if (configfile->getInt("video.enabled", 1))
+    {
+      staged->model = new CRRCAirplaneV2(staged->xml, false);
+    }
   }
   catch (XMLException e)
   {
-    std::string msg = "Error opening airplane specification file: ";
-    msg += filename;
-    msg += ": ";
-    msg += e.what();
-
-    throw std::runtime_error(msg);    
+    delete staged;
+    throw airplaneFileError(filename, e);
   }  
-  if (getFDM() == NULL)
+  catch (std::runtime_error&)
   {
-    throw std::runtime_error("Unable to load airplane specification file.");
+    delete staged;
+    throw;
   }
-  
+
+  return(staged);
+}
+
+
+void Aircraft::commit(AircraftStage* staged, SimpleXMLTransfer *configfile)
+{
+  latest_configfile = configfile;
+  cleanup();
+
+  fdmInterface         = staged->fdmInterface;
+  staged->fdmInterface = NULL;
+
+  try
+  {
+    if (staged->model != NULL)
+      staged->model->activate(staged->xml);
+  }
+  catch (std::runtime_error&)
+  {
+    delete staged;
+    throw;
+  }
+  model_        = staged->model;
+  staged->model = NULL;
+
+  delete staged;
+}
+
+
+int Aircraft::load(SimpleXMLTransfer *configfile, FDMEnviroment* fdmEnvironment,
+                   bool fReloadOnly)
+{
+  if (!fReloadOnly)
+  {
+    // the old airplane is gone before the new one is loaded
+    latest_configfile = configfile;
+    cleanup();
+    fdmInterface = new ModFDMInterface();
+
+    commit(stage(configfile, fdmEnvironment), configfile);
+    return(1);
+  }
+
+  std::string        filename;
+  SimpleXMLTransfer* xml      = loadAirplaneFile(configfile, filename);
+  int                nRetCode = 0;
+
+  try
+  {
+    nRetCode = fdmInterface->ReloadParams(xml, configfile);
+  }
+  catch (XMLException e)
+  {
+    delete xml;
+    throw airplaneFileError(filename, e);
+  }
+
+  delete xml;
   return(nRetCode);
 }
 
@@ -30,6 +30,21 @@
 #include "mod_fdm/fdm.h"
 #include "crrc_loadair.h"
 
+/**
+ * An airplane which has been loaded by Aircraft::stage(), but is not
+ * in use yet.
+ */
+class AircraftStage
+{
+  public:
+    AircraftStage() : xml(NULL), fdmInterface(NULL), model(NULL) {}
+    ~AircraftStage();
+
+    SimpleXMLTransfer* xml;            ///< the airplane file, as configured
+    ModFDMInterface*   fdmInterface;   ///< the loaded FDM
+    CRRCAirplaneV2*    model;          ///< not activated yet, NULL without video
+};
+
 class Aircraft
 {
   public:
@@ -43,6 +58,14 @@ class Aircraft
 
     FDMBase*  getFDM() const;
 
+    /**
+     * The FDM to be used for drawing the aircraft and for the sound.
+     * This is getFDM(), unless a SimThread updates the FDM while the
+     * frame is drawn: then it is an interpolated copy of its state.
+     */
+    FDMBase*  getDisplayFDM() const;
+    void      setDisplayFDM(FDMBase* fdm) {displayFDM = fdm;}
+
     CRRCAirplane*     getModel() const {return model_;}
     void              setModel(CRRCAirplane* model);
 
@@ -60,6 +83,28 @@ class Aircraft
     int  load(SimpleXMLTransfer *configfile, FDMEnviroment* fdmEnvironment,
               bool fReloadOnly = false);
   
+    /**
+     * The part of load() which doesn't change anything in use: reads
+     * the airplane specified in configfile and creates its FDM, its
+     * sounds and stages its visual model (the scenegraph, the decoded
+     * textures, the shadow and the coarse copy). This may be run on a
+     * background thread, if configfile isn't changed meanwhile and the
+     * main thread calls Video::service_staging(). The result has to be
+     * deleted by the main thread. Throws a std::runtime_error on
+     * failure.
+     */
+    static AircraftStage* stage(SimpleXMLTransfer *configfile,
+                                FDMEnviroment* fdmEnvironment);
+
+    /**
+     * Replaces the airplane by one returned by stage() and deletes
+     * staged. This uploads the textures, adds the visualization to the
+     * scenegraph and starts the sounds, so it has to be called by the
+     * main thread, between two frames.
+     * Throw a std::runtime_error on failure.
+     */
+    void commit(AircraftStage* staged, SimpleXMLTransfer *configfile);
+  
     /**
      * load demo/robot file
      */
@@ -84,6 +129,7 @@ class Aircraft
     ModFDMInterface*   fdmInterface;         ///< The fdm which is in use.
     ModFDMInterface*   fdmInterfaceBackup;   ///< Backup pointer when in test mode.
     SimpleXMLTransfer* latest_configfile;    ///< most currently used configfile
+    FDMBase*           displayFDM;           ///< see getDisplayFDM()
   
     void cleanup();
   
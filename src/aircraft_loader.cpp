@@ -0,0 +1,214 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+/** \file aircraft_loader.cpp
+ *
+ *  Loads another airplane while the simulation keeps running.
+ */
+
+#include <cstdio>
+#include <stdexcept>
+#include <SDL.h>
+#include <SDL_thread.h>
+
+#include "aircraft_loader.h"
+#include "aircraft.h"
+#include "global.h"
+#include "global_video.h"
+#include "mod_misc/scheduler.h"
+
+/// frames which are measured after the commit
+#define LOADER_FRAMES_AFTER  10
+
+
+AircraftLoader::AircraftLoader()
+  : thread(NULL), configfile(NULL), snapshot(NULL), env(NULL), done(NULL),
+    fFinished(false), staged(NULL),
+    dStart(0), dLoaded(0), dCommit(0), dLastFrame(0), dFrameAvg(0), dFrameMax(0),
+    nFramesLeft(0), fMeasuring(false)
+{
+  mutex = SDL_CreateMutex();
+}
+
+
+AircraftLoader::~AircraftLoader()
+{
+  join();
+  SDL_DestroyMutex(mutex);
+}
+
+
+void AircraftLoader::join()
+{
+  if (thread != NULL)
+  {
+    // the thread may be waiting for the main thread to make a texture
+    for (;;)
+    {
+      SDL_LockMutex(mutex);
+      bool fReady = fFinished;
+      SDL_UnlockMutex(mutex);
+      if (fReady)
+        break;
+
+      Video::service_staging();
+      SDL_Delay(1);
+    }
+    SDL_WaitThread(thread, NULL);
+    thread = NULL;
+  }
+
+  delete staged;
+  delete snapshot;
+  staged   = NULL;
+  snapshot = NULL;
+}
+
+
+void AircraftLoader::start(SimpleXMLTransfer* configfile, FDMEnviroment* fdmEnvironment,
+                           T_Done done)
+{
+  join();
+
+  this->configfile = configfile;
+  this->env        = fdmEnvironment;
+  this->done       = done;
+  snapshot         = new SimpleXMLTransfer(configfile);
+  fFinished        = false;
+  strError         = "";
+
+  dStart      = Scheduler::getSeconds();
+  dFrameMax   = 0;
+  nFramesLeft = LOADER_FRAMES_AFTER;
+  fMeasuring  = true;
+
+  thread = SDL_CreateThread(loaderThread, this);
+  if (thread == NULL)
+  {
+    // load it right here then
+    loaderThread(this);
+  }
+}
+
+
+int AircraftLoader::loaderThread(void* loader)
+{
+  AircraftLoader* l      = (AircraftLoader*)loader;
+  AircraftStage*  staged = NULL;
+  std::string     strError;
+
+  try
+  {
+    staged = Aircraft::stage(l->snapshot, l->env);
+  }
+  catch (std::exception& e)
+  {
+    strError = e.what();
+  }
+
+  SDL_LockMutex(l->mutex);
+  l->staged    = staged;
+  l->strError  = strError;
+  l->dLoaded   = Scheduler::getSeconds() - l->dStart;
+  l->fFinished = true;
+  SDL_UnlockMutex(l->mutex);
+
+  return(0);
+}
+
+
+void AircraftLoader::poll()
+{
+  Video::service_staging();
+
+  SDL_LockMutex(mutex);
+  bool fReady = fFinished;
+  SDL_UnlockMutex(mutex);
+
+  if (!fReady)
+    return;
+
+  if (thread != NULL)
+  {
+    SDL_WaitThread(thread, NULL);
+    thread = NULL;
+  }
+  fFinished = false;
+
+  double dBegin = Scheduler::getSeconds();
+
+  AircraftStage* commit = staged;
+  staged = NULL;
+  if (commit != NULL)
+  {
+    try
+    {
+      Global::aircraft->commit(commit, configfile);
+    }
+    catch (std::runtime_error& e)
+    {
+      strError = e.what();
+    }
+  }
+  delete snapshot;
+  snapshot = NULL;
+
+  if (done != NULL)
+    done(strError);
+
+  dCommit = Scheduler::getSeconds() - dBegin;
+}
+
+
+void AircraftLoader::frame()
+{
+  double now    = Scheduler::getSeconds();
+  double dFrame = now - dLastFrame;
+
+  if (dLastFrame == 0)
+    dFrame = 0;
+  dLastFrame = now;
+
+  if (!fMeasuring)
+  {
+    if (dFrameAvg == 0)
+      dFrameAvg = dFrame;
+    else
+      dFrameAvg += 0.05 * (dFrame - dFrameAvg);
+    return;
+  }
+
+  if (dFrame > dFrameMax)
+    dFrameMax = dFrame;
+
+  if (!isBusy() && --nFramesLeft <= 0)
+  {
+    printStats();
+    fMeasuring = false;
+  }
+}
+
+
+void AircraftLoader::printStats()
+{
+  printf("Airplane switch: loaded in %.0f ms in the background, committed in %.1f ms,\n"
+         "  longest frame %.1f ms (%.1f ms on average before)\n",
+         1e3 * dLoaded, 1e3 * dCommit, 1e3 * dFrameMax, 1e3 * dFrameAvg);
+}
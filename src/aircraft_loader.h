@@ -0,0 +1,134 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+/** \file aircraft_loader.h
+ *
+ *  Loads another airplane while the simulation keeps running.
+ */
+
+#ifndef AIRCRAFT_LOADER_H
+# define AIRCRAFT_LOADER_H
+
+# include <string>
+
+struct SDL_Thread;
+struct SDL_mutex;
+class  AircraftStage;
+class  FDMEnviroment;
+class  SimpleXMLTransfer;
+
+/**
+ * Replaces Global::aircraft by another airplane in two stages:
+ *
+ * - Aircraft::stage() runs on a thread of its own: it parses the
+ *   airplane file, creates the FDM, loads the sound samples and
+ *   stages the visual model: the scenegraph is loaded from the model
+ *   or its bundle, the textures are decoded, the coarse copy and the
+ *   shadow are made, and a missing bundle is written. Meanwhile the
+ *   old airplane is still drawn and flown.
+ * - Aircraft::commit() is called by poll() in the main loop, between
+ *   two frames. It only swaps the FDM, uploads the textures, adds the
+ *   animations and the visualization to the scenegraph and starts
+ *   the sounds.
+ *
+ * OpenGL is used by the main thread only: poll() makes the empty
+ * texture objects the loader thread asks for while it stages.
+ *
+ * The longest frame from start() until a few frames after the commit
+ * is measured and printed, to see if the switch can be noticed.
+ */
+class AircraftLoader
+{
+  public:
+
+    /**
+     * Called by poll() when a load is done: strError is empty if the
+     * new airplane is in use.
+     */
+    typedef void (*T_Done)(std::string const& strError);
+
+    AircraftLoader();
+
+    /**
+     * Waits for a load which is still running and drops its result.
+     */
+    ~AircraftLoader();
+
+    /**
+     * Starts loading the airplane specified in configfile. A copy of
+     * configfile is used by the loader thread, the original becomes
+     * the airplane's config when it is committed. If another airplane
+     * is being loaded, that one is waited for and dropped.
+     */
+    void start(SimpleXMLTransfer* configfile, FDMEnviroment* fdmEnvironment,
+               T_Done done);
+
+    /**
+     * Serves the requests of the loader thread, commits the airplane
+     * if it has been loaded and calls done. To be called by the main
+     * thread between two frames, while the simulation thread is
+     * locked.
+     */
+    void poll();
+
+    /**
+     * To be called once per frame.
+     */
+    void frame();
+
+    /**
+     * An airplane is being loaded, but hasn't been committed yet.
+     */
+    bool isBusy() const { return(snapshot != NULL); };
+
+  private:
+    static int loaderThread(void* loader);
+
+    /**
+     * Waits for the thread to finish and drops its result.
+     */
+    void join();
+
+    void printStats();
+
+    SDL_Thread*        thread;
+    SDL_mutex*         mutex;
+    SimpleXMLTransfer* configfile;       ///< the config to commit the airplane with
+    SimpleXMLTransfer* snapshot;         ///< copy of configfile for the thread, NULL if idle
+    FDMEnviroment*     env;
+    T_Done             done;
+
+    // results of the thread, protected by mutex
+    bool               fFinished;
+    AircraftStage*     staged;
+    std::string        strError;
+
+    // measurement, in seconds
+    double             dStart;           ///< start() was called
+    double             dLoaded;          ///< time taken by the thread
+    double             dCommit;          ///< time taken by the commit
+    double             dLastFrame;
+    double             dFrameAvg;        ///< frame time outside of switches
+    double             dFrameMax;        ///< longest frame of the current switch
+    int                nFramesLeft;      ///< frames to measure after the commit
+    bool               fMeasuring;
+};
+
+#endif
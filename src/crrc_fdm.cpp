@@ -24,12 +24,23 @@
 #include "crrc_fdm.h"
 
 #include "global.h"
+#include "SimStateHandler.h"
 #include "mod_landscape/crrc_scenery.h"
 #include "mod_windfield/windfield.h"
 #include "mod_env/earth/atmos_62.h"
 #include "mod_env/earth/ls_gravity.h"
 #include "mod_fdm/fdm.h"
 
+/**
+ * Upper end of the environment tables [ft]
+ */
+#define ENV_TABLE_MAX_ALT 40000
+
+/**
+ * Maximum relative error of the environment tables
+ */
+#define ENV_TABLE_MAX_ERR 1e-7
+
 CRRC_FDM_Env::CRRC_FDM_Env(SimpleXMLTransfer* cfg)
 {
   // instantiate list of controllers from global config file,
@@ -38,6 +49,13 @@ CRRC_FDM_Env::CRRC_FDM_Env(SimpleXMLTransfer* cfg)
   int idx = cfg->indexOfChild("controllers");
   if (idx >= 0)
     Controller::LoadList(cfg->getChildAt(idx), controllers);
+  
+  // The atmosphere tables are in altitude above sea level, so they
+  // cover any scenery below ENV_TABLE_MAX_ALT and don't have to be
+  // rebuilt when another scenery is loaded. Outside of the tables the
+  // analytic models are used.
+  rhoTable.init(ls_atmos_rho, 0, ENV_TABLE_MAX_ALT, 500, ENV_TABLE_MAX_ERR);
+  gTable.init(ls_gravity_g, -ENV_TABLE_MAX_ALT, ENV_TABLE_MAX_ALT, 2000, ENV_TABLE_MAX_ERR);
 }
 
 float CRRC_FDM_Env::GetSceneryHeight(float x_north, float y_east)
@@ -47,6 +65,14 @@ float CRRC_FDM_Env::GetSceneryHeight(float x_north, float y_east)
          );
 }
 
+float CRRC_FDM_Env::GetSceneryPatch(float x_north, float y_east, TerrainPatch& patch)
+{
+  return(
+         Global::scenery->getHeightAndPatch(x_north, y_east, patch.plane,
+                                            patch.tri, patch.rect, patch.fValid)
+         );
+}
+
 int CRRC_FDM_Env::CalculateWind(double  X_cg,      double  Y_cg,     double  Z_cg,
                                 double& Vel_north, double& Vel_east, double& Vel_down)
 {
@@ -57,12 +83,12 @@ int CRRC_FDM_Env::CalculateWind(double  X_cg,      double  Y_cg,     double  Z_c
 double CRRC_FDM_Env::GetRho(double altitude)
 {
   double origin_altitude = Global::scenery->getOriginAltitude();
-  return(ls_atmos_rho(altitude + origin_altitude));
+  return(rhoTable.get(altitude + origin_altitude));
 }
 
 double CRRC_FDM_Env::GetG(double altitude)
 {
-  return(ls_gravity_g(altitude));
+  return(gTable.get(altitude));
 }
 
 void CRRC_FDM_Env::ControllerCallback(double      dt, 
@@ -77,6 +103,13 @@ void CRRC_FDM_Env::ControllerCallback(double      dt,
     controllers[n]->Calc(dt, fdm, pInputsFromUser, pInputsToFDM);
 }
 
+void CRRC_FDM_Env::StepCallback(double      dt,
+                                FDMBase*    fdm,
+                                TSimInputs* pInputsFromUser)
+{
+  simulation_substep(dt, fdm, pInputsFromUser);
+}
+
 void CRRC_FDM_Env::ResetControllers()
 {
   for (unsigned int n=0; n<controllers.size(); n++)
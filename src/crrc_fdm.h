@@ -26,6 +26,7 @@
 #include "mod_misc/SimpleXMLTransfer.h"
 #include "mod_fdm/fdm_env.h"
 #include "mod_cntrl/controller.h"
+#include "mod_env/earth/envtable.h"
 
 /**
  * Connects CRRCSim to the module "FDM"
@@ -47,6 +48,12 @@ public:
    */
   virtual float GetSceneryHeight(float x_north, float y_east);
   
+  /**
+   *  Get the height at a distinct point and the part of the terrain
+   *  around it, see FDMEnviroment::GetSceneryPatch().
+   */
+  virtual float GetSceneryPatch(float x_north, float y_east, TerrainPatch& patch);
+  
   /**
    * Calculate the wind velocities in all three axes in the given position.
    * Returns 1 if this position is outside of the grid.
@@ -73,6 +80,11 @@ public:
    */
   virtual void ControllerCallback(double dt, FDMBase* fdm, TSimInputs* pInputsFromUser, TSimInputs* pInputsToFDM);
 
+  /**
+   * Passes every step of the FDM on to simulation_substep().
+   */
+  virtual void StepCallback(double dt, FDMBase* fdm, TSimInputs* pInputsFromUser);
+
   void ResetControllers();
   
   virtual void AddLogMsg(std::string message);
@@ -83,6 +95,14 @@ private:
    * List of active controllers
    */
   std::vector<Controller*> controllers;
+  
+  /**
+   * Density over altitude above sea level,
+   * gravity over altitude above origin. These are evaluated several
+   * times on every FDM step, the tables replace the analytic models.
+   */
+  T_EnvTable rhoTable;
+  T_EnvTable gTable;
 };
 
 #endif
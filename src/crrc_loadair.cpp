@@ -58,11 +58,13 @@ CRRCAirplane::~CRRCAirplane()
 /*****************************************************************************/
 
 CRRCAirplaneV2::CRRCAirplaneV2()
+  : lVisID(INVALID_AIRPLANE_VISUALIZATION), staged(NULL)
 {
 }
 
 
-CRRCAirplaneV2::CRRCAirplaneV2(SimpleXMLTransfer* xml)
+CRRCAirplaneV2::CRRCAirplaneV2(SimpleXMLTransfer* xml, bool fActivate)
+  : lVisID(INVALID_AIRPLANE_VISUALIZATION), staged(NULL)
 {
   printf("CRRCAirplaneV2(xml)\n");
 
@@ -75,7 +77,6 @@ CRRCAirplaneV2::CRRCAirplaneV2(SimpleXMLTransfer* xml)
   s = XMLModelFile::getGraphics(xml)->getString("model");
         
   // Offset of center of gravity
-  CRRCMath::Vector3  pCG;         
   pCG = CRRCMath::Vector3(0, 0, 0);
   if (xml->indexOfChild("CG") >= 0)
   {
@@ -90,26 +91,52 @@ CRRCAirplaneV2::CRRCAirplaneV2(SimpleXMLTransfer* xml)
   }
   // plib automatically loads the texture file, but it does not know which directory to use.
   // where is the object file?
-  std::string    of  = FileSysTools::getDataPath("objects/" + s);
+  model_file   = FileSysTools::getDataPath("objects/" + s);
   // compile and set relative texture path
-  std::string    tp  = of.substr(0, of.length()-s.length()-1-7) + "textures";    
+  texture_path = model_file.substr(0, model_file.length()-s.length()-1-7) + "textures";    
 
-  lVisID = Video::new_visualization(of, tp, pCG, xml);
+  if (fActivate)
+    activate(xml);
+  else
+    staged = Video::stage_visualization(model_file, texture_path, pCG, xml);
+}
+
+
+void CRRCAirplaneV2::activate(SimpleXMLTransfer* xml)
+{
+  if (lVisID != INVALID_AIRPLANE_VISUALIZATION)
+    return;
+
+  if (staged != NULL)
+  {
+    lVisID = Video::new_visualization(staged, xml);
+    staged = NULL;
+  }
+  else
+  {
+    lVisID = Video::new_visualization(model_file, texture_path, pCG, xml);
+  }
   
   if (lVisID == INVALID_AIRPLANE_VISUALIZATION)
   {
     std::string msg = "Unable to open airplane model file \"";
-    msg += s;
+    msg += XMLModelFile::getGraphics(xml)->getString("model");
     msg += "\"\nspecified in \"";
     msg += xml->getSourceDescr();
     msg += "\"";
     throw std::runtime_error(msg);
   }
 
+  for (int i = 0; i < (int)sound.size(); i++)
+    sound[i]->setChannel(Global::soundserver->playSample((T_SoundSample*)sound[i]));
 }
 
 CRRCAirplaneV2::~CRRCAirplaneV2()
 {
+  if (staged != NULL)
+  {
+    Video::delete_staged_visualization(staged);
+  }
   if (lVisID != INVALID_AIRPLANE_VISUALIZATION)
   {
     Video::delete_visualization(lVisID);
@@ -203,7 +230,6 @@ void CRRCAirplaneV2::initSound(SimpleXMLTransfer* xml)
         sample->setType(sound_type);
         sample->setPitchFactor(dPitchFactor);
         sample->setMaxVolume(dMaxVolume);
-        sample->setChannel(Global::soundserver->playSample((T_SoundSample*)sample));
         sound.push_back(sample);
       }
     }
@@ -78,19 +78,44 @@ class CRRCAirplaneV2 : public CRRCAirplane
 {
   public:
     CRRCAirplaneV2();
-    CRRCAirplaneV2(SimpleXMLTransfer* xml);
+
+    /**
+     * Loads the airplane described by xml.
+     *
+     * If fActivate is false, the sounds are loaded and the visual
+     * model is staged (see Video::stage_visualization()), but neither
+     * the sound server nor the scenegraph are touched: that may be
+     * done on any thread. activate() has to be called by the main
+     * thread before the airplane is used then, and the airplane has to
+     * be deleted by the main thread.
+     */
+    CRRCAirplaneV2(SimpleXMLTransfer* xml, bool fActivate = true);
     ~CRRCAirplaneV2();
 
+    /**
+     * Creates the visualization and starts the sounds of an airplane
+     * which has been loaded with fActivate = false. Throws a
+     * std::runtime_error if the model file can't be loaded.
+     */
+    void activate(SimpleXMLTransfer* xml);
+
     void draw(FDMBase* airplane);
   
   private:
     long lVisID;    ///< ID for the airplane visualization
 
+    Video::StagedVisualization* staged;   ///< until activate(), if not activated right away
+
+    std::string       model_file;     ///< file of the visual model
+    std::string       texture_path;   ///< directory of its textures
+    CRRCMath::Vector3 pCG;            ///< offset of the center of gravity
+
   protected:
    
   /** \brief Initialize the airplane's sound.
     *
     *  Reads all sound related parameters from an xml description.
+    *  The samples are started by activate().
     *  \todo Make this method search all possible paths on Linux!
     */
    virtual void  initSound(SimpleXMLTransfer* xml);
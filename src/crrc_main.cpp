@@ -80,6 +80,8 @@ If you'd like to help with CRRCSIM, then send me an email!
 #include "aircraft.h"
 #include "global_video.h"
 #include "mod_video/crrc_graphics.h"
+#include "mod_video/offscreen.h"
+#include "mod_video/render_stats.h"
 
 #include "mod_main/eventhandler.h"
 #include "mod_main/crrc_checkopts.h"
@@ -101,6 +103,11 @@ If you'd like to help with CRRCSIM, then send me an email!
 
 #include "record.h"
 #include "robots.h"
+#include "sim_thread.h"
+#include "latency_trace.h"
+#include "replay_verifier.h"
+#include "telemetry.h"
+#include "aircraft_loader.h"
 
 
 #include <math.h>
@@ -126,6 +133,9 @@ int vario_sound_channel = -1;
 // Enviroment interface to FDM
 FDMEnviroment* fdmenv = 0;
 
+// Field of view of the current frame
+float field_of_view;
+
 
 /*****************************************************************************/
 void activate_test_mode()
@@ -492,10 +502,16 @@ void write_globals_into_config()
 /*****************************************************************************/
 void initializeRandomNumberGenerator()
 {
-  time_t sometime = time(0);
-  srand((unsigned int) sometime);
-  CRRC_Random::insertData(rand());
-  std::cout << "RAND_MAX = " << RAND_MAX << "\n";
+  // A seed of zero means "different every time"; a fixed seed
+  // makes windfield and FDM noise repeatable.
+  int nSeed = cfgfile->getInt("simulation.random.seed", 0);
+  
+  if (nSeed == 0)
+    CRRC_Random::setSeed((uint64_t)time(0));
+  else
+    CRRC_Random::setSeed((uint64_t)nSeed);
+  
+  std::cout << "Random seed: " << CRRC_Random::getSeed() << "\n";
 }
 
 /*****************************************************************************/
@@ -535,6 +551,29 @@ void loadAirplane()
   Global::aircraft->load(cfgfile, fdmenv);
 }
 
+/**
+ * Description: see header file
+ */
+void loadAirplaneInBackground(void (*done)(std::string const& strError))
+{
+  if (Global::aircraftLoader)
+  {
+    Global::aircraftLoader->start(cfgfile, fdmenv, done);
+    return;
+  }
+
+  std::string strError;
+  try
+  {
+    loadAirplane();
+  }
+  catch (std::runtime_error& e)
+  {
+    strError = e.what();
+  }
+  done(strError);
+}
+
 
 void set_aux(int aux_num, int setting)
 {
@@ -556,6 +595,92 @@ void set_aux(int aux_num, int setting)
   }
 }
 
+/*****************************************************************************/
+/**
+ * Builds the informational text, as much as the verbosity level asks for.
+ * Runs ten times a second.
+ */
+void update_verbose_text()
+{
+  switch (Global::nVerbosity)
+  {
+   case 3:
+    Global::verboseString += "FPS: " + itoStr(Global::nFPS, ' ', 1) + " ";
+    if (Video::getPrimitivesPerFrame() >= 0)
+      Global::verboseString += "Prims: " + itoStr(Video::getPrimitivesPerFrame(), ' ', 1) + " ";
+    //fallthrough
+   case 2:
+    Global::verboseString += "FoV: " + ftoStr(field_of_view, 2, 1, false, false);
+    //fallthrough
+   case 1:
+    {
+      int NrOfMixers = T_TX_Mixer::NUM_MIXERS;
+      int mixer_on = false;
+      std::string drate = "OFF";
+      std::string mixers = "";
+      
+      if (Global::TXInterface->mixer->enabled)
+      {
+        if (Global::TXInterface->mixer->dr_enabled)
+          drate = "ON";
+          
+        for (int n=0; n<NrOfMixers; n++)
+          if (Global::TXInterface->mixer->mixer_enabled[n])
+          {
+            if (mixer_on)
+              mixers += ",";
+            mixers += itoStr(n+1, ' ', 1);
+            mixer_on = true;
+          }
+      }
+      if (!mixer_on)
+        mixers += "-"; 
+
+      Global::verboseString += 
+          "\nAil: " + ftoStr(Global::inputs.aileron,  2, 2, true, false)
+        + " Ele: "  + ftoStr(Global::inputs.elevator, 2, 2, true, false)
+        + " Rud: "  + ftoStr(Global::inputs.rudder,   2, 2, true, false)
+        + " Thr: "  + ftoStr(Global::inputs.throttle, 2, 2, true, false)
+        + " | D/r: " + drate
+        + "\nFlp: " + ftoStr(Global::inputs.flap,     2, 2, true, false)
+        + " Spo: "  + ftoStr(Global::inputs.spoiler,  2, 2, true, false)
+        + " Ret: "  + ftoStr(Global::inputs.retract,  2, 2, true, false)
+        + " Pit: "  + ftoStr(Global::inputs.pitch,    2, 2, true, false)
+        + " | Mix: " + mixers;
+    }
+    if (Global::gui)
+      Global::gui->setVerboseText(Global::verboseString.c_str());
+    else
+    {
+      // twice a second
+      static int verbose_print_c = 0;
+      if (++verbose_print_c >= 5)
+      {
+        Global::verboseString += "\n";
+        std::cout << Global::verboseString;
+        verbose_print_c = 0;
+      }
+    }
+    break;
+
+   default:
+    if (Global::gui)
+    {
+      Global::gui->setVerboseText("");
+    }
+    break;
+  }
+}
+
+/*****************************************************************************/
+void update_hud_compass()
+{
+  if (Global::gui)
+  {
+    Global::gui->doHUDCompass(field_of_view);
+  }
+}
+
 /** Raise an event containing the actual input values
  *
  *  \param inputs   input value structure with current values
@@ -572,7 +697,7 @@ void raiseInputEvent(TSimInputs const& inputs)
             inputs.spoiler,
             inputs.retract,
             inputs.pitch);
-  EventDispatcher::getInstance()->raise(&event);
+  EventBus<AxisUpdateEvent>::raise(event);
 }
 /*****************************************************************************
 *
@@ -615,8 +740,9 @@ void load_initial_scenery(T_Config *cfg)
 /*****************************************************************************/
 int main(int argc,char **argv)
 {
-  float field_of_view;
-
+  ReplayVerifier* verifier  = NULL;
+  int             nExitCode = CRRC_EXIT_SUCCESS;
+  
   if (crrc_checkversionopt(argc, argv))
   {
     crrc_exit(CRRC_EXIT_SUCCESS);
@@ -668,8 +794,6 @@ int main(int argc,char **argv)
       }
     }
 
-    initializeRandomNumberGenerator();
-
     {
       unsigned int SDLFlags = SDL_INIT_JOYSTICK;
       int nRetCodeCmdline;
@@ -704,9 +828,31 @@ int main(int argc,char **argv)
         if (nRetCodeCmdline)
           crrc_exit(CRRC_EXIT_FAILURE);
 
+        // Replay (option -p): the airplane of the record. The section
+        // is removed, it must not be saved.
+        if (cfgfile->indexOfChild("replay") >= 0)
+        {
+          int                nIndex  = cfgfile->indexOfChild("replay");
+          SimpleXMLTransfer* section = cfgfile->getChildAt(nIndex);
+          
+          verifier = new ReplayVerifier(section->getString("file"));
+          cfgfile->removeChildAt(nIndex);
+          delete section;
+          
+          if (verifier->getAirplaneFile().length())
+            cfgfile->setAttributeOverwrite("airplane.file", verifier->getAirplaneFile());
+        }
+
+        initializeRandomNumberGenerator();
+        if (verifier)
+        {
+          CRRC_Random::setSeed(verifier->getSeed());
+          std::cout << "Random seed of the record: " << CRRC_Random::getSeed() << "\n";
+        }
+
         // must be after crrc_checkopts because crrc_checkopts can change
         //   video.enabled and sound.enabled based on command line options
-        if (cfgfile->getInt("video.enabled", 1))
+        if (cfgfile->getInt("video.enabled", 1) && !Video::offscreenEnabled())
           SDLFlags |= SDL_INIT_VIDEO;
         if (cfgfile->getInt("sound.enabled", 1))
           SDLFlags |= SDL_INIT_AUDIO;
@@ -720,6 +866,35 @@ int main(int argc,char **argv)
         
         read_config_into_globals();
 
+        // Deterministic recording (option -e); a replay must not
+        // overwrite the records
+        Global::recorder->SetDeterministic(verifier || cfgfile->getInt("record.deterministic", 0));
+        // Compressed positions (record type 0x05) can't be read by
+        // older versions, so they have to be turned on
+        Global::recorder->SetCompress(cfgfile->getInt("record.compress", 0) != 0);
+        if (verifier)
+        {
+          Global::recorder->Disable();
+          if (verifier->getDt() > 0)
+            Global::dt = verifier->getDt();
+        }
+        
+        // Telemetry export (option -k)
+        std::string sTelemetry = cfgfile->getString("telemetry.shm", "");
+        if (sTelemetry.length())
+        {
+          Global::telemetry = new TelemetryExport(sTelemetry,
+                                                  cfgfile->getInt("telemetry.samples", CRRC_TELEMETRY_CAPACITY));
+          if (Global::telemetry->isOpen())
+            printf("Exporting telemetry to shared memory %s.\n", sTelemetry.c_str());
+          else
+          {
+            fprintf(stderr, "Can't create shared memory %s for telemetry.\n", sTelemetry.c_str());
+            delete Global::telemetry;
+            Global::telemetry = NULL;
+          }
+        }
+
         std::string msg = reconfigureInputMethod();
         if (msg.length())
           printf("%s", msg.c_str());
@@ -855,17 +1030,89 @@ int main(int argc,char **argv)
        Global::gameHandler= new HandlerF3F();
      }  
         
+    // Stress test (option -r): the same flight record as many robots.
+    // The section is removed, it must not be saved.
+    if (cfgfile->indexOfChild("robots") >= 0)
+    {
+      int         nRobots = cfgfile->getInt("robots.stress.count", 0);
+      std::string file    = cfgfile->getString("robots.stress.file", "");
+
+      for (int n = 0; n < nRobots; n++)
+        Global::robots->AddRobot(file);
+      printf("Stress test: %d robots from %s\n", nRobots, file.c_str());
+
+      int                nIndex  = cfgfile->indexOfChild("robots");
+      SimpleXMLTransfer* section = cfgfile->getChildAt(nIndex);
+      cfgfile->removeChildAt(nIndex);
+      delete section;
+    }
+    
+    // Offscreen rendering: the simulation time advances by the same
+    // amount for every frame, no matter how long it took to render.
+    if (Video::offscreenEnabled())
+    {
+      Global::Simulation->setFixedFrameTime(cfgfile->getInt("video.offscreen.interval", 40));
+    }
+    
     Global::Simulation->reset();
     
+    // Replay (option -p): verify the record instead of flying
+    if (verifier)
+    {
+      if (verifier->Run(std::cout, simulation_step, Global::aircraft->getFDMInterface()) != 0)
+        nExitCode = CRRC_EXIT_FAILURE;
+      Global::Simulation->quit();
+    }
+    
     Scheduler scheduler;
     EventHandler eventHandler(&scheduler);
+
+    Scheduler        uiScheduler;
+    RunnableFunction hudCompassTask(update_hud_compass);
+    RunnableFunction verboseTextTask(update_verbose_text);
+    uiScheduler.Register(&hudCompassTask,  "HUD compass",  Scheduler::NORMAL);
+    uiScheduler.Register(&verboseTextTask, "verbose text", Scheduler::LOW, 100);
+    
+    // The simulation thread needs the real time clock. It is stopped
+    // before anything it uses is destroyed.
+    if (cfgfile->getInt("simulation.thread", 0) && !Global::Simulation->isFixedFrameTime() && !verifier)
+    {
+      Global::simThread = new SimThread();
+      Global::aircraft->setDisplayFDM(Global::simThread->getDisplayFDM());
+      Global::simThread->start();
+      printf("Running the simulation on its own thread.\n");
+    }
+    
+    // -1: no trace, 0: trace stick movements, else period of synthetic steps in ms
+    int nLatencySteps = cfgfile->getInt("simulation.latency.steps", -1);
+    if (nLatencySteps >= 0)
+    {
+      Global::latencyTrace = new LatencyTrace(cfgfile->getString("inputMethod.method", "?"),
+                                              nLatencySteps / 1000.0);
+    }
+    
+    // another airplane is loaded while the current one is flown
+    Global::aircraftLoader = new AircraftLoader();
     
     while (Global::Simulation->getState() != STATE_EXIT)
     {
-      crrc_time->update();
-      scheduler.Run();
+      if (Global::Simulation->isFixedFrameTime())
+        Global::Simulation->nextFrame();
+      else
+        crrc_time->update();
+      
+      if (Global::simThread)
+        Global::simThread->lock();
+      
+      scheduler.Run(Global::Simulation->getTotalTime(),
+                    Global::Simulation->getSimulationTimeSinceReset());
+
+      // swap in an airplane which has been loaded in the background
+      Global::aircraftLoader->poll();
 
       Global::TXInterface->getInputData(&Global::inputs);
+      if (Global::latencyTrace)
+        Global::latencyTrace->input(&Global::inputs);
       raiseInputEvent(Global::inputs);
       
       if (Global::training_mode)
@@ -877,18 +1124,29 @@ int main(int argc,char **argv)
         Global::inputs.heli_fixed_z = EOM01_FIXED_Z_OFF;
       }
 
+      if (Global::simThread)
+        Global::simThread->setInputs(Global::inputs);
+      
       Global::Simulation->doIdle(&Global::inputs);
 
       Global::inputs.ClearKeys();
-      
-      // random data
+
+      if (Global::simThread)
       {
-        CRRC_Random::insertData(SDL_GetTicks());
-        CRRC_Random::insertData(Global::inputs.getRandNum());                   
+        Global::simThread->unlock();
+        Global::simThread->updateDisplay();
+
+        const T_SimSnapshot* snap = Global::simThread->getSnapshot();
+        if (snap)
+          Global::robots->Publish(snap->robots);
       }
 
+      // the state which is drawn in this frame
+      if (Global::latencyTrace)
+        Global::latencyTrace->display();
+
       // get aircraft position from FDM
-      CRRCMath::Vector3 vFdmPos = Global::aircraft->getPos();
+      CRRCMath::Vector3 vFdmPos = Global::aircraft->getDisplayFDM()->getPos();
       CRRCMath::Vector3 vAircraftPos(     vFdmPos.r[0],
                                      -1 * vFdmPos.r[2],
                                           vFdmPos.r[1]);
@@ -910,83 +1168,25 @@ int main(int argc,char **argv)
       Global::verboseString += " Psi: " + ftoStr(Global::aircraft->getFDM()->getPsi() * SG_RADIANS_TO_DEGREES, 2, 2, true, false);
       if (Global::gui)
         Global::gui->setVerboseText(Global::verboseString.c_str());
-      #else
-      switch (Global::nVerbosity)
-      {
-       case 3:
-        Global::verboseString += "FPS: " + itoStr(Global::nFPS, ' ', 1) + " ";
-        //fallthrough
-       case 2:
-        Global::verboseString += "FoV: " + ftoStr(field_of_view, 2, 1, false, false);
-        //fallthrough
-       case 1:
-        {
-          int NrOfMixers = T_TX_Mixer::NUM_MIXERS;
-          int mixer_on = false;
-          std::string drate = "OFF";
-          std::string mixers = "";
-          
-          if (Global::TXInterface->mixer->enabled)
-          {
-            if (Global::TXInterface->mixer->dr_enabled)
-              drate = "ON";
-              
-            for (int n=0; n<NrOfMixers; n++)
-              if (Global::TXInterface->mixer->mixer_enabled[n])
-              {
-                if (mixer_on)
-                  mixers += ",";
-                mixers += itoStr(n+1, ' ', 1);
-                mixer_on = true;
-              }
-          }
-          if (!mixer_on)
-            mixers += "-"; 
-
-          Global::verboseString += 
-              "\nAil: " + ftoStr(Global::inputs.aileron,  2, 2, true, false)
-            + " Ele: "  + ftoStr(Global::inputs.elevator, 2, 2, true, false)
-            + " Rud: "  + ftoStr(Global::inputs.rudder,   2, 2, true, false)
-            + " Thr: "  + ftoStr(Global::inputs.throttle, 2, 2, true, false)
-            + " | D/r: " + drate
-            + "\nFlp: " + ftoStr(Global::inputs.flap,     2, 2, true, false)
-            + " Spo: "  + ftoStr(Global::inputs.spoiler,  2, 2, true, false)
-            + " Ret: "  + ftoStr(Global::inputs.retract,  2, 2, true, false)
-            + " Pit: "  + ftoStr(Global::inputs.pitch,    2, 2, true, false)
-            + " | Mix: " + mixers;
-        }
-        if (Global::gui)
-          Global::gui->setVerboseText(Global::verboseString.c_str());
-        else
-        {
-          static int verbose_print_c = 0;
-          if (++verbose_print_c >= 30)
-          {
-            Global::verboseString += "\n";
-            std::cout << Global::verboseString;
-            verbose_print_c = 0;
-          }
-        }
-        break;
-
-       default:
-        if (Global::gui)
-        {
-          Global::gui->setVerboseText("");
-        }
-        break;
-      }
       #endif
 
-      if (Global::gui)
-      {
-          Global::gui->doHUDCompass(field_of_view);
-      }
-      
+      // GUI work, deferred to the next frame if the frame is busy
+      if (Global::simThread)
+        Global::simThread->lock();
+      uiScheduler.Run(Global::Simulation->getTotalTime(),
+                      Global::Simulation->getSimulationTimeSinceReset());
+      if (Global::simThread)
+        Global::simThread->unlock();
+
       if (Global::gui)
       {
         Video::display();
+        if (Video::offscreenCaptureDone())
+          Global::Simulation->quit();
       }
+      if (Global::latencyTrace)
+        Global::latencyTrace->frame();
+      Global::aircraftLoader->frame();
       Global::verboseString = "";
 
 #ifdef LOG_FRAMES
@@ -996,17 +1196,46 @@ int main(int argc,char **argv)
       // sound calculations
       if (Global::soundserver != (CRRCAudioServer*)0)
       {
+        FDMBase* fdm = Global::aircraft->getDisplayFDM();
         soundUpdate3D(distance_to_model,
-                      Global::aircraft->getFDM()->getPropFreq(),
+                      fdm->getPropFreq(),
                       -1*vFdmPos.r[2],
-                      Global::aircraft->getFDM()->getVRelAirmass()/Global::aircraft->getFDM()->getTrimmedFlightVelocity());
+                      fdm->getVRelAirmass()/fdm->getTrimmedFlightVelocity());
+        Global::soundserver->reclaimChannels();
       }
     }
 #ifdef LOG_FRAMES
     fclose(fp);
 #endif
+
+    delete Global::aircraftLoader;
+    Global::aircraftLoader = NULL;
+
+    if (Global::simThread)
+    {
+      Global::simThread->stop();
+      Global::simThread->printStats(std::cout);
+      Global::aircraft->setDisplayFDM(NULL);
+      delete Global::simThread;
+      Global::simThread = NULL;
+    }
+
+    scheduler.printStats(std::cout);
+    uiScheduler.printStats(std::cout);
+    Global::robots->printStats(std::cout);
+    
+    if (Global::latencyTrace)
+    {
+      Global::latencyTrace->printStats(std::cout);
+      delete Global::latencyTrace;
+      Global::latencyTrace = NULL;
+    }
+    
+    delete Global::telemetry;
+    Global::telemetry = NULL;
     
     Global::recorder->Stop();
+    delete verifier;
   }
   catch (std::exception& e)
   {
@@ -1030,7 +1259,7 @@ int main(int argc,char **argv)
   }
   delete Global::Simulation;
 
-  crrc_exit(CRRC_EXIT_SUCCESS, NULL);
+  crrc_exit(nExitCode, NULL);
 
   // crrc_exit() will never return, keep the compiler happy anyway:
   return 0;
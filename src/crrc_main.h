@@ -94,6 +94,14 @@ void Init_mod_windfield();
  */
 void loadAirplane();
 
+/**
+ * Starts loading the airplane specified in the config file in the
+ * background, while the current one is still flown. done is called
+ * between two frames once the new airplane is in use, or with an
+ * error message. See AircraftLoader.
+ */
+void loadAirplaneInBackground(void (*done)(std::string const& strError));
+
 void write_globals_into_config();
 
 /// Exit from CRRCsim as clean as possible
@@ -44,7 +44,10 @@
  *
  *  The data in this structure will be filled in by soundUpdate3D().
  *  The sound thread uses it to calculate the absolute pitch value and
- *  volume setting for playing the sample.
+ *  volume setting for playing the sample. The values are written
+ *  with relaxed atomic stores and read with audio3D(), so the sound
+ *  thread may see a mix of two updates for one buffer. The next
+ *  buffer gets it right.
  */
 struct tagAudio3D
 {
@@ -54,6 +57,16 @@ struct tagAudio3D
   float flRelVelocity;  ///< relative velocity
 } Audio3D;
 
+/** \brief Read one value of Audio3D in the sound thread.
+ */
+static inline float audio3D(float *value)
+{
+  float ret;
+
+  __atomic_load(value, &ret, __ATOMIC_RELAXED);
+  return ret;
+}
+
 
 
 // --- Implementation of class T_AirplaneSound
@@ -87,6 +100,24 @@ Uint8* T_AirplaneSound::getMixableData(Uint32 playpos, Uint32 *len)
 }
 
 
+#if CRRC_SOUND_STEREO == 0
+/** \brief Describe a chunk of data for the mixer.
+ *
+ *  Calculates pitch and volume, then lets the mixer
+ *  resample the loop.
+ *
+ *  \param  playpos   The current playback position.
+ *  \param  len       Requested data size.
+ *  \param  src       The mixer source.
+ */
+void T_AirplaneSound::getMixSource(Uint32 playpos, Uint32 *len, T_MixSource *src)
+{
+  calculate();
+  T_PitchVariableLoop::getMixSource(playpos, len, src);
+}
+#endif
+
+
 /** \brief Calculate the pitch shift caused by the Doppler effect
  *
  *  The movement of a sound source relative to the listener causes
@@ -150,27 +181,19 @@ T_EngineSound::~T_EngineSound()
 #define VOLUME_ATT_MIN_VOLUME         7
 
 
-/** \brief Calculate pitch and volume for the engine sample
- *
+/** \brief Volume of an engine
  *
+ *  \param flDist        distance to the engine
+ *  \param flPropFreq    propeller frequency
+ *  \param dMaxVolume    maximum volume of the sample
+ *  \param flModelVolume volume for all models (0 ... 1)
+ *  \return volume (0 ... SDL_MIX_MAXVOLUME)
  */
-void T_EngineSound::calculate()
+static unsigned char engineVolume(float flDist, float flPropFreq,
+                                  double dMaxVolume, float flModelVolume)
 {
-  CRRCAudioServer *server = CRRCAudioServer::getRunningInstance();
-
   unsigned char nEngineVol;
-  float flPropFreq;
-  float flDist;
-  float C_doppler;
-  float flModelVolume;
-
-  // get input values from inter-process swap buffer
-  flPropFreq    = Audio3D.flPropFreq;
-  flDist        = Audio3D.flDist;
-  flModelVolume = (float)server->getModelVolume() / (float)SDL_MIX_MAXVOLUME;
 
-  C_doppler = calculate_Doppler(flDist);
-  
   // Distance-dependend attenuation:
   if (flPropFreq < 0.001)
   {
@@ -192,12 +215,92 @@ void T_EngineSound::calculate()
       nEngineVol = VOLUME_ATT_MIN_VOLUME;
     }
   }
+  return nEngineVol;
+}
+
+
+/** \brief Calculate pitch and volume for the engine sample
+ *
+ *
+ */
+void T_EngineSound::calculate()
+{
+  CRRCAudioServer *server = CRRCAudioServer::getRunningInstance();
+
+  unsigned char nEngineVol;
+  float flPropFreq;
+  float flDist;
+  float C_doppler;
+  float flModelVolume;
+
+  // get input values from inter-process swap buffer
+  flPropFreq    = audio3D(&Audio3D.flPropFreq);
+  flDist        = audio3D(&Audio3D.flDist);
+  flModelVolume = (float)server->getModelVolume() / (float)SDL_MIX_MAXVOLUME;
+
+  C_doppler = calculate_Doppler(flDist);
+  
+  nEngineVol = engineVolume(flDist, flPropFreq, dMaxVolume, flModelVolume);
+
   float pitch = 0.8 * flPropFreq*dPitchFactor / C_doppler;
   setPitch(pitch);
   server->setChannelVolume(channel, nEngineVol);
 }
 
 
+// --- Implementation of class T_EngineVoice --------------
+
+/** \brief Create an engine voice.
+ *
+ *  The sample is loaded from a file. If it is already used
+ *  by another sound, its data is shared. A std::runtime_error
+ *  will be thrown if it can't be loaded.
+ *
+ *  \param filename    the file to be loaded
+ *  \param pitchfactor relation of sample pitch to motor speed
+ *  \param maxvolume   maximum volume of the sample
+ */
+T_EngineVoice::T_EngineVoice(const char *filename, double pitchfactor, double maxvolume)
+  : sample(NULL), voice(-1), dPitchFactor(pitchfactor), dMaxVolume(maxvolume)
+{
+  CRRCAudioServer *server = CRRCAudioServer::getRunningInstance();
+
+  sample = new T_SoundSample(filename, server->getAudioSpec());
+  voice  = server->addVoice(sample);
+}
+
+
+T_EngineVoice::~T_EngineVoice()
+{
+  CRRCAudioServer::getRunningInstance()->removeVoice(voice);
+  delete sample;
+}
+
+
+/** \brief Update pitch and volume of the voice.
+ *
+ *  Uses the same attenuation as T_EngineSound, but an
+ *  engine which is farther away than the attenuation
+ *  distance is silent, so its voice doesn't cost anything.
+ *  There's no Doppler effect.
+ *
+ *  \param flDist     distance to the engine
+ *  \param flPropFreq propeller frequency
+ */
+void T_EngineVoice::update(float flDist, float flPropFreq)
+{
+  CRRCAudioServer *server = CRRCAudioServer::getRunningInstance();
+  unsigned char    nVol   = 0;
+
+  if (flDist < VOLUME_ATT_MAX_DISTANCE_FT)
+  {
+    float flModelVolume = (float)server->getModelVolume() / (float)SDL_MIX_MAXVOLUME;
+    nVol = engineVolume(flDist, flPropFreq, dMaxVolume, flModelVolume);
+  }
+  server->setVoice(voice, 0.8 * flPropFreq*dPitchFactor, nVol);
+}
+
+
 // --- Implementation of class T_GliderSound --------------
 T_GliderSound::T_GliderSound(const char *filename, SDL_AudioSpec *fmt)
   : T_AirplaneSound(filename, fmt),
@@ -222,8 +325,8 @@ void T_GliderSound::calculate()
   CRRCAudioServer *server = CRRCAudioServer::getRunningInstance();
 
   // get input values from inter-process swap buffer
-  float flDist        = Audio3D.flDist;
-  float flRelV        = Audio3D.flRelVelocity;
+  float flDist        = audio3D(&Audio3D.flDist);
+  float flRelV        = audio3D(&Audio3D.flRelVelocity);
   float flModelVolume = (float)server->getModelVolume() / (float)SDL_MIX_MAXVOLUME;;
 
   // calculate Doppler effect
@@ -374,7 +477,7 @@ void T_VariometerSound::calculate()
   float         flSndTimeDiff = (float)Global::soundserver->getBufferSize() 
                                 / (float)Global::soundserver->getSampleRate();
   // get input values from inter-process swap buffer
-  flHIn       = Audio3D.flH;
+  flHIn       = audio3D(&Audio3D.flH);
   
   // feet per second
   float flHDiff = (flHIn - flHOld) / flSndTimeDiff;
@@ -520,12 +623,10 @@ Uint8* T_VariometerSound::getMixableData(Uint32 playpos, Uint32 *len)
  */
 void soundUpdate3D(float flDist, float flPropFreq, float flH, float flRelV)
 {
-  SDL_LockAudio();
-  Audio3D.flPropFreq    = flPropFreq;
-  Audio3D.flDist        = flDist;
-  Audio3D.flH           = flH;
-  Audio3D.flRelVelocity = flRelV;
-  SDL_UnlockAudio();
+  __atomic_store(&Audio3D.flPropFreq,    &flPropFreq, __ATOMIC_RELAXED);
+  __atomic_store(&Audio3D.flDist,        &flDist,     __ATOMIC_RELAXED);
+  __atomic_store(&Audio3D.flH,           &flH,        __ATOMIC_RELAXED);
+  __atomic_store(&Audio3D.flRelVelocity, &flRelV,     __ATOMIC_RELAXED);
 }
 
 
@@ -58,6 +58,10 @@ class T_AirplaneSound : public T_PitchVariableLoop
   
     // Get a pointer to a chunk of data. Description: see implementation.
     Uint8* getMixableData(Uint32 playpos, Uint32 *len);
+#if CRRC_SOUND_STEREO == 0
+    // Describe a chunk of data for the mixer. Description: see implementation.
+    void   getMixSource(Uint32 playpos, Uint32 *len, T_MixSource *src);
+#endif
   
     /// Get the pitch factor for this sound sample
     double  getPitchFactor() const {return dPitchFactor;};
@@ -117,6 +121,30 @@ class T_EngineSound : public T_AirplaneSound
 };
 
 
+/** \brief An engine sound played on a voice of the sound server.
+ *
+ *  Unlike T_EngineSound, which gets its input from
+ *  soundUpdate3D(), the pitch and volume of an engine voice
+ *  are set by the main thread. It is meant for engines of
+ *  which many may be audible at the same time, like those
+ *  of robots.
+ */
+class T_EngineVoice
+{
+  public:
+    T_EngineVoice(const char *filename, double pitchfactor, double maxvolume);
+    ~T_EngineVoice();
+
+    void update(float flDist, float flPropFreq);
+
+  private:
+    T_SoundSample*  sample;         ///< the sample, its data is shared
+    int             voice;          ///< the voice of the sound server
+    double          dPitchFactor;   ///< The relation of sample pitch to e.g. motor speed
+    double          dMaxVolume;     ///< The maximum sample volume
+};
+
+
 /** \brief The CRRCsim-specific glider sound class.
  *
  *  This class extends T_PitchVariableLoop with a
@@ -0,0 +1,390 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+/**
+ *  \file crrc_soundmix.cpp
+ *
+ *  The mixer of the sound server, see crrc_soundmix.h
+ */
+#include "crrc_soundmix.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# include <emmintrin.h>
+# define CRRC_SOUNDMIX_SSE2 1
+#endif
+
+/// size of the temporary buffer of snd_mix_scalar()
+#define SND_MIX_CHUNK (256)
+
+/// number of voices passed to snd_mix() at once
+#define SND_MIX_VOICE_BATCH (32)
+
+
+const char* snd_mix_implementation()
+{
+#if defined(CRRC_SOUNDMIX_SSE2)
+  return "SSE2";
+#else
+  return "scalar";
+#endif
+}
+
+
+/*******************************************************************************************/
+/* scalar reference versions                                                              */
+/*******************************************************************************************/
+
+uint32_t snd_resample(const int16_t* data, uint32_t length, uint32_t pos, uint32_t step,
+                      int16_t* out, uint32_t count)
+{
+  uint32_t uiSoundlen = length << SND_MIX_EIS;  // length in integer-arithmetic
+
+  while (count--)
+  {
+    pos += step;
+    while (pos >= uiSoundlen)
+    {
+      pos -= uiSoundlen;
+    }
+
+    // linear interpolation in integer arithmetic
+    uint32_t pos1      = (pos >> SND_MIX_EIS);
+    int32_t  sample_l1 = data[pos1];
+
+    if (++pos1 >= length)
+      pos1 = 0;
+
+    int32_t sample_l2 = data[pos1];
+    int32_t diff      = pos & ((1 << SND_MIX_EIS) - 1);
+    int32_t out_l     = sample_l1 + (((sample_l2 - sample_l1)*diff) >> SND_MIX_EIS);
+
+    // Limit to 16 bit samples
+    if (out_l > 32767)
+      out_l = 32767;
+    else if (out_l < -32767)
+      out_l = -32767;
+
+    *out++ = out_l;
+  }
+  return pos;
+}
+
+
+uint32_t snd_advance(uint32_t length, uint32_t pos, uint32_t step, uint32_t count)
+{
+  // Every step is taken modulo the length, so the result is the same
+  // as taking all of them at once.
+  uint64_t uiSoundlen = (uint64_t)length << SND_MIX_EIS;
+
+  return (uint32_t)(((uint64_t)pos + (uint64_t)step * count) % uiSoundlen);
+}
+
+
+void snd_mixaudio(int16_t* stream, const int16_t* data, uint32_t count, int volume)
+{
+  if (volume == 0)
+    return;
+
+  while (count--)
+  {
+    int32_t sample = ((int32_t)*data++ * volume) / SND_MIX_MAXVOLUME;
+    int32_t out    = *stream + sample;
+
+    if (out > 32767)
+      out = 32767;
+    else if (out < -32768)
+      out = -32768;
+    *stream++ = out;
+  }
+}
+
+
+void snd_mix_scalar(int16_t* stream, uint32_t n, const T_MixSource* src, int nSources)
+{
+  int16_t buffer[SND_MIX_CHUNK];
+
+  for (int s = 0; s < nSources; s++)
+  {
+    uint32_t count = (src[s].count < n) ? src[s].count : n;
+
+    if (src[s].length == 0)
+    {
+      snd_mixaudio(stream, src[s].data, count, src[s].volume);
+    }
+    else
+    {
+      uint32_t pos = src[s].pos;
+      for (uint32_t k = 0; k < count; k += SND_MIX_CHUNK)
+      {
+        uint32_t nChunk = (count - k < SND_MIX_CHUNK) ? count - k : SND_MIX_CHUNK;
+        pos = snd_resample(src[s].data, src[s].length, pos, src[s].step, buffer, nChunk);
+        snd_mixaudio(stream + k, buffer, nChunk, src[s].volume);
+      }
+    }
+  }
+}
+
+
+/*******************************************************************************************/
+/* voices                                                                                 */
+/*******************************************************************************************/
+
+int snd_mix_voices(int16_t* stream, uint32_t n, T_MixVoice* voice, int nVoices, int nReal)
+{
+  int nCount[SND_MIX_MAXVOLUME+1];
+  int nAudible  = 0;
+  int nMixed    = 0;
+  int nLimit    = 0;    // voices below this volume are virtual
+  int nAtLimit;         // number of voices which may be mixed at the limit
+
+  // Volumes are small integers, so the loudest voices can be found
+  // by counting instead of sorting.
+  for (int v = 0; v <= SND_MIX_MAXVOLUME; v++)
+    nCount[v] = 0;
+  for (int v = 0; v < nVoices; v++)
+  {
+    if (voice[v].data != NULL && voice[v].volume > 0)
+    {
+      nCount[voice[v].volume]++;
+      nAudible++;
+    }
+  }
+
+  if (nAudible > nReal)
+  {
+    int nLouder = 0;
+
+    nLimit = SND_MIX_MAXVOLUME;
+    while (nLouder + nCount[nLimit] < nReal)
+      nLouder += nCount[nLimit--];
+    nAtLimit = nReal - nLouder;
+  }
+  else
+  {
+    nAtLimit = nAudible;
+  }
+
+  T_MixSource src[SND_MIX_VOICE_BATCH];
+  int         nSources = 0;
+
+  for (int v = 0; v < nVoices; v++)
+  {
+    T_MixVoice& m = voice[v];
+
+    if (m.data == NULL)
+      continue;
+
+    if (m.volume > nLimit || (m.volume == nLimit && m.volume > 0 && nAtLimit-- > 0))
+    {
+      T_MixSource& s = src[nSources++];
+      s.data   = m.data;
+      s.count  = n;
+      s.length = m.length;
+      s.pos    = m.pos;
+      s.step   = m.step;
+      s.volume = m.volume;
+      nMixed++;
+      if (nSources == SND_MIX_VOICE_BATCH)
+      {
+        snd_mix(stream, n, src, nSources);
+        nSources = 0;
+      }
+    }
+    m.pos = snd_advance(m.length, m.pos, m.step, n);
+  }
+  if (nSources)
+    snd_mix(stream, n, src, nSources);
+
+  return nMixed;
+}
+
+
+#if defined(CRRC_SOUNDMIX_SSE2)
+/*******************************************************************************************/
+/* SSE2                                                                                   */
+/*******************************************************************************************/
+
+/// maximum number of sources processed in one pass
+#define SND_MIX_MAX_SOURCES (32)
+
+/**
+ *  (x * volume) / SND_MIX_MAXVOLUME, rounded towards zero like the
+ *  integer division of the scalar version
+ */
+static inline __m128i snd_mix_scale(__m128i x, __m128i vol)
+{
+  __m128i lo   = _mm_mullo_epi16(x, vol);
+  __m128i hi   = _mm_mulhi_epi16(x, vol);
+  __m128i p0   = _mm_unpacklo_epi16(lo, hi);
+  __m128i p1   = _mm_unpackhi_epi16(lo, hi);
+  __m128i bias = _mm_set1_epi32(SND_MIX_MAXVOLUME - 1);
+
+  p0 = _mm_srai_epi32(_mm_add_epi32(p0, _mm_and_si128(_mm_srai_epi32(p0, 31), bias)), 7);
+  p1 = _mm_srai_epi32(_mm_add_epi32(p1, _mm_and_si128(_mm_srai_epi32(p1, 31), bias)), 7);
+
+  return _mm_packs_epi32(p0, p1);
+}
+
+/**
+ *  Mixes up to 8 samples (nValid) of the sources into out.
+ */
+static inline void snd_mix_block(int16_t* out, uint32_t k, uint32_t nValid,
+                                 const T_MixSource* src, int nSources, uint32_t* pos)
+{
+  int16_t tmp[8];
+  __m128i acc;
+
+  if (nValid == 8)
+  {
+    acc = _mm_loadu_si128((const __m128i*)out);
+  }
+  else
+  {
+    for (uint32_t j = 0; j < 8; j++)
+      tmp[j] = (j < nValid) ? out[j] : 0;
+    acc = _mm_loadu_si128((const __m128i*)tmp);
+  }
+
+  for (int s = 0; s < nSources; s++)
+  {
+    const T_MixSource& m = src[s];
+    uint32_t           nSrc;
+    __m128i            x;
+
+    if (m.count <= k)
+      continue;
+    nSrc = m.count - k;
+    if (nSrc > nValid)
+      nSrc = nValid;
+
+    if (m.length == 0)
+    {
+      if (nSrc == 8)
+      {
+        x = _mm_loadu_si128((const __m128i*)(m.data + k));
+      }
+      else
+      {
+        for (uint32_t j = 0; j < 8; j++)
+          tmp[j] = (j < nSrc) ? m.data[k+j] : 0;
+        x = _mm_loadu_si128((const __m128i*)tmp);
+      }
+    }
+    else
+    {
+      // Fetch both neighbours and the fraction, then interpolate as
+      // (s1*(1-f) + s2*f) >> EIS, which is the same as s1 + ((s2-s1)*f >> EIS).
+      int16_t  s1[8];
+      int16_t  s2[8];
+      int16_t  f[8];
+      uint32_t p   = pos[s];
+      uint32_t len = m.length << SND_MIX_EIS;
+
+      for (uint32_t j = 0; j < 8; j++)
+      {
+        if (j < nSrc)
+        {
+          p += m.step;
+          while (p >= len)
+            p -= len;
+
+          uint32_t p1 = p >> SND_MIX_EIS;
+          uint32_t p2 = p1 + 1;
+          if (p2 >= m.length)
+            p2 = 0;
+          s1[j] = m.data[p1];
+          s2[j] = m.data[p2];
+          f[j]  = p & ((1 << SND_MIX_EIS) - 1);
+        }
+        else
+        {
+          s1[j] = s2[j] = f[j] = 0;
+        }
+      }
+      pos[s] = p;
+
+      __m128i vs1 = _mm_loadu_si128((const __m128i*)s1);
+      __m128i vs2 = _mm_loadu_si128((const __m128i*)s2);
+      __m128i vf  = _mm_loadu_si128((const __m128i*)f);
+      __m128i vf1 = _mm_sub_epi16(_mm_set1_epi16(1 << SND_MIX_EIS), vf);
+      __m128i a0  = _mm_madd_epi16(_mm_unpacklo_epi16(vs1, vs2), _mm_unpacklo_epi16(vf1, vf));
+      __m128i a1  = _mm_madd_epi16(_mm_unpackhi_epi16(vs1, vs2), _mm_unpackhi_epi16(vf1, vf));
+
+      a0 = _mm_srai_epi32(a0, SND_MIX_EIS);
+      a1 = _mm_srai_epi32(a1, SND_MIX_EIS);
+      x  = _mm_max_epi16(_mm_packs_epi32(a0, a1), _mm_set1_epi16(-32767));
+    }
+
+    if (m.volume != SND_MIX_MAXVOLUME)
+      x = snd_mix_scale(x, _mm_set1_epi16(m.volume));
+
+    acc = _mm_adds_epi16(acc, x);
+  }
+
+  if (nValid == 8)
+  {
+    _mm_storeu_si128((__m128i*)out, acc);
+  }
+  else
+  {
+    _mm_storeu_si128((__m128i*)tmp, acc);
+    for (uint32_t j = 0; j < nValid; j++)
+      out[j] = tmp[j];
+  }
+}
+
+void snd_mix(int16_t* stream, uint32_t n, const T_MixSource* src, int nSources)
+{
+  T_MixSource active[SND_MIX_MAX_SOURCES];
+  uint32_t    pos[SND_MIX_MAX_SOURCES];
+  int         nActive = 0;
+
+  // Silent sources don't contribute anything. More sources than fit
+  // into one pass are added in further passes, which keeps the order
+  // of the saturating additions.
+  for (int s = 0; s < nSources; s++)
+  {
+    if (src[s].volume != 0 && src[s].count != 0)
+    {
+      active[nActive] = src[s];
+      pos[nActive]    = src[s].pos;
+      nActive++;
+    }
+    if (nActive == SND_MIX_MAX_SOURCES || (s == nSources-1 && nActive > 0))
+    {
+      for (uint32_t k = 0; k < n; k += 8)
+      {
+        uint32_t nValid = (n - k < 8) ? n - k : 8;
+        snd_mix_block(stream + k, k, nValid, active, nActive, pos);
+      }
+      nActive = 0;
+    }
+  }
+}
+
+#else
+
+void snd_mix(int16_t* stream, uint32_t n, const T_MixSource* src, int nSources)
+{
+  snd_mix_scalar(stream, n, src, nSources);
+}
+
+#endif
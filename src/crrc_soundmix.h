@@ -0,0 +1,130 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+/**
+ *  \file crrc_soundmix.h
+ *
+ *  The mixer of the sound server.
+ *
+ *  snd_mix() takes the data of all channels and adds it to the output
+ *  stream in one pass: for every block of output samples, each channel
+ *  is resampled (if it has a pitch), scaled by its volume and added
+ *  with saturation. This is done with SSE2 if the compiler generates
+ *  code for it and falls back to the scalar functions otherwise.
+ *
+ *  The result is exactly the same as resampling every channel into a
+ *  buffer (snd_resample(), the interpolation of T_PitchVariableLoop)
+ *  and mixing the buffers one after the other (snd_mixaudio(), which
+ *  does the same as SDL_MixAudio() for 16 bit signed samples).
+ *
+ *  snd_mix_voices() plays a large number of loops (voices), but only
+ *  mixes the loudest ones. All others are virtual: they only keep
+ *  track of their position, which costs next to nothing.
+ *
+ *  Samples are 16 bit signed, native byte order (AUDIO_S16SYS). This
+ *  file doesn't depend on SDL, so the mixer can be tested offline.
+ */
+#ifndef CRRC_SOUNDMIX_H
+#define CRRC_SOUNDMIX_H
+
+#include <stdint.h>
+
+/// maximum volume, the same as SDL_MIX_MAXVOLUME
+#define SND_MIX_MAXVOLUME (128)
+
+/// integer interpolation constant of resampled sources
+#define SND_MIX_EIS       (12)
+
+
+/** \brief One channel of the mixer.
+ *
+ *  A source is either played as it is (length == 0) or it is a loop
+ *  which is resampled with linear interpolation.
+ */
+typedef struct
+{
+  const int16_t* data;    ///< sample data
+  uint32_t       count;   ///< number of output samples this source contributes
+  uint32_t       length;  ///< length of the loop in samples, 0 for plain data
+  uint32_t       pos;     ///< loops only: position (<< SND_MIX_EIS) before the first sample
+  uint32_t       step;    ///< loops only: pitch (<< SND_MIX_EIS)
+  int            volume;  ///< 0 ... SND_MIX_MAXVOLUME
+} T_MixSource;
+
+
+/** \brief A voice of snd_mix_voices().
+ *
+ *  A voice is a loop which is resampled like a T_MixSource, its
+ *  position is kept from one call to the next.
+ */
+typedef struct
+{
+  const int16_t* data;    ///< sample data, NULL if the voice is unused
+  uint32_t       length;  ///< length of the loop in samples
+  uint32_t       pos;     ///< position (<< SND_MIX_EIS)
+  uint32_t       step;    ///< pitch (<< SND_MIX_EIS)
+  int            volume;  ///< 0 ... SND_MIX_MAXVOLUME, 0 is inaudible
+} T_MixVoice;
+
+
+/**
+ *  Name of the instruction set snd_mix() has been compiled for
+ *  ("SSE2" or "scalar").
+ */
+const char* snd_mix_implementation();
+
+/**
+ *  Adds all sources to the first n samples of the stream. The sources
+ *  are added one after the other, each one with saturation.
+ */
+void snd_mix       (int16_t* stream, uint32_t n, const T_MixSource* src, int nSources);
+void snd_mix_scalar(int16_t* stream, uint32_t n, const T_MixSource* src, int nSources);
+
+/**
+ *  Adds n samples of up to nReal voices to the stream. These are the
+ *  loudest ones, voices of the same volume are taken in the order of
+ *  the list. The positions of all voices are advanced by n samples,
+ *  no matter if they have been mixed or not.
+ *  \return number of voices mixed
+ */
+int snd_mix_voices(int16_t* stream, uint32_t n, T_MixVoice* voice, int nVoices, int nReal);
+
+/**
+ *  Resamples count samples of the loop data[0 ... length-1], starting
+ *  behind position pos (<< SND_MIX_EIS), and writes them to out.
+ *  \return position after the last sample
+ */
+uint32_t snd_resample(const int16_t* data, uint32_t length, uint32_t pos, uint32_t step,
+                      int16_t* out, uint32_t count);
+
+/**
+ *  Position of a loop after count samples, the same as the value
+ *  returned by snd_resample().
+ */
+uint32_t snd_advance(uint32_t length, uint32_t pos, uint32_t step, uint32_t count);
+
+/**
+ *  Scales count samples by volume and adds them to the stream, with
+ *  saturation. This is what SDL_MixAudio() does.
+ */
+void snd_mixaudio(int16_t* stream, const int16_t* data, uint32_t count, int volume);
+
+#endif  // CRRC_SOUNDMIX_H
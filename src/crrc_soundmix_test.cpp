@@ -0,0 +1,521 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+/**
+ * \file crrc_soundmix_test.cpp
+ *
+ * Compares the mixer of the sound server to the way the callback
+ * used to mix: every pitch variable loop is interpolated into a
+ * buffer, then each channel is added with SDL_MixAudio().
+ *
+ * Usage: soundmix_test [-n buffers]
+ *
+ * Eight channels are played for a number of buffers of 4096 samples
+ * (the buffer size at 48 kHz): pitch variable loops with changing
+ * pitch and volume, one-shot samples which end in the middle of a
+ * buffer, a silent channel and a loud square wave which drives the
+ * output into saturation. snd_mix() and snd_mix_scalar() have to
+ * produce exactly the same output as the old code.
+ *
+ * The second part renders 64 engines which share one sample and
+ * move around the listener, some of them out of hearing range. They
+ * are played the old way (one pitch variable loop per engine), with
+ * snd_mix_voices() mixing all of them and with snd_mix_voices()
+ * mixing only the 16 loudest ones. The first two have to be the
+ * same, and all voices have to end at the same position.
+ *
+ * The CPU time per buffer is printed for all versions. The return
+ * value is the number of buffers which are different.
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <vector>
+#include <math.h>
+
+#include "crrc_soundmix.h"
+
+#define TEST_CHANNELS (8)
+#define TEST_SAMPLES  (4096)
+#define TEST_VOICES   (64)
+#define TEST_REAL     (16)
+
+
+// --- the old code ----------------------------------------
+
+/**
+ * The interpolation of T_PitchVariableLoop::getMixableData()
+ * (mono), as it used to be.
+ */
+static uint32_t old_resample(const int16_t* sndptr, uint32_t uiSoundlenSamples,
+                             uint32_t uiSoundpos, float pitch,
+                             int16_t* writeptr, int nSamplesToCopy)
+{
+  uint32_t uiSoundlen = uiSoundlenSamples << SND_MIX_EIS;
+  uint32_t uiPitch    = (uint32_t)( (1<<SND_MIX_EIS) * pitch);
+  while (nSamplesToCopy--)
+  {
+    uiSoundpos += uiPitch;
+    while (uiSoundpos >= uiSoundlen)
+    {
+      uiSoundpos -= uiSoundlen;
+    }
+
+    int      diff;
+    int32_t  out_l;
+    uint32_t pos1      = (uiSoundpos >> SND_MIX_EIS);
+    int32_t  sample_l1 = *(sndptr + pos1);
+    int32_t  sample_l2;
+
+    if (++pos1 >= uiSoundlenSamples)
+      pos1 = 0;
+
+    sample_l2 = *(sndptr + pos1);
+
+    diff  = uiSoundpos & ((1 << SND_MIX_EIS) - 1);
+    diff  = (((sample_l2 - sample_l1)*diff) >> SND_MIX_EIS);
+    out_l = sample_l1 + diff;
+
+    if (out_l > 32767)
+      out_l = 32767;
+    else if (out_l < -32767)
+      out_l = -32767;
+
+    *writeptr++ = out_l;
+  }
+  return uiSoundpos;
+}
+
+/**
+ * SDL_MixAudio() of SDL 1.2 for AUDIO_S16SYS
+ */
+static void old_mixaudio(int16_t* dst, const int16_t* src, uint32_t len, int volume)
+{
+  const int max_audioval = ((1<<(16-1))-1);
+  const int min_audioval = -(1<<(16-1));
+
+  if (volume == 0)
+    return;
+
+  len /= 2;
+  while (len--)
+  {
+    int src1 = *src;
+    src1 = (src1*volume)/SND_MIX_MAXVOLUME;
+    int src2 = *dst;
+    src++;
+
+    int dst_sample = src1+src2;
+    if (dst_sample > max_audioval)
+      dst_sample = max_audioval;
+    else if (dst_sample < min_audioval)
+      dst_sample = min_audioval;
+    *dst++ = dst_sample;
+  }
+}
+
+
+// --- the test scenario -----------------------------------
+
+/**
+ * One channel of the test
+ */
+struct TestChannel
+{
+  std::vector<int16_t> data;
+  bool     fLoop;     ///< pitch variable loop or plain sample
+  int      nStart;    ///< first buffer in which the channel plays
+  uint32_t playpos;   ///< bytes played
+  uint32_t soundpos;  ///< position of the loop
+  float    pitch;
+  int      volume;
+};
+
+static uint32_t lcg_state = 12345;
+
+static int16_t noise()
+{
+  lcg_state = lcg_state*1664525 + 1013904223;
+  return (int16_t)(lcg_state >> 16);
+}
+
+static void setup(std::vector<TestChannel>& ch)
+{
+  lcg_state = 12345;
+  ch.resize(TEST_CHANNELS);
+  for (int c = 0; c < TEST_CHANNELS; c++)
+  {
+    ch[c].fLoop    = true;
+    ch[c].nStart   = 0;
+    ch[c].playpos  = 0;
+    ch[c].soundpos = 0;
+    ch[c].pitch    = 1;
+    ch[c].volume   = SND_MIX_MAXVOLUME;
+  }
+
+  // engine: saw tooth with noise
+  for (int n = 0; n < 7919; n++)
+    ch[0].data.push_back((int16_t)((n % 97)*500 - 24000 + noise()/8));
+
+  // glider: noise, very low pitch
+  for (int n = 0; n < 4801; n++)
+    ch[1].data.push_back(noise()/2);
+
+  // one-shot sine, ends in the middle of the fourth buffer
+  ch[2].fLoop = false;
+  for (int n = 0; n < 3*TEST_SAMPLES + 1234; n++)
+    ch[2].data.push_back((int16_t)(20000*sin(n*0.05)));
+
+  // short one-shot, starts later
+  ch[3].fLoop  = false;
+  ch[3].nStart = 2;
+  for (int n = 0; n < 101; n++)
+    ch[3].data.push_back(noise());
+
+  // silent loop
+  ch[4].volume = 0;
+  for (int n = 0; n < 1000; n++)
+    ch[4].data.push_back(noise());
+
+  // loud square wave
+  for (int n = 0; n < 480; n++)
+    ch[5].data.push_back((n < 240) ? 32767 : -32768);
+
+  // full scale noise, short loop
+  for (int n = 0; n < 37; n++)
+    ch[6].data.push_back((n & 1) ? -32768 : noise());
+
+  // vario-like plain sample, odd volume
+  ch[7].fLoop = false;
+  ch[7].volume = 77;
+  for (int n = 0; n < 60*TEST_SAMPLES; n++)
+    ch[7].data.push_back((int16_t)(32767*sin(n*0.3)));
+}
+
+/**
+ * Pitch and volume change for every buffer, like the engine sound
+ * does in T_AirplaneSound::calculate().
+ */
+static void update(std::vector<TestChannel>& ch, int nBuffer)
+{
+  ch[0].pitch  = 1.5 + 1.4*sin(nBuffer*0.1);
+  ch[0].volume = 64 + (int)(63*sin(nBuffer*0.37));
+  ch[1].pitch  = (nBuffer % 5 == 0) ? 0.0001 : 0.01 + 0.005*nBuffer;
+  ch[4].pitch  = 1.1;
+  ch[5].pitch  = 0.7 + 0.001*nBuffer;
+  ch[5].volume = (nBuffer % 3 == 0) ? SND_MIX_MAXVOLUME : 101;
+  ch[6].pitch  = 3.7;
+  ch[6].volume = 120;
+}
+
+/**
+ * Mixes one buffer the old way
+ */
+static void mix_old(std::vector<TestChannel>& ch, int nBuffer, int16_t* stream)
+{
+  static int16_t dyn_buffer[TEST_SAMPLES];
+
+  for (int c = 0; c < TEST_CHANNELS; c++)
+  {
+    TestChannel& t   = ch[c];
+    uint32_t     len = TEST_SAMPLES*2;
+
+    if (nBuffer < t.nStart)
+      continue;
+    if (t.fLoop)
+    {
+      t.soundpos = old_resample(&t.data[0], t.data.size(), t.soundpos, t.pitch,
+                                dyn_buffer, len/2);
+      old_mixaudio(stream, dyn_buffer, len, t.volume);
+    }
+    else
+    {
+      uint32_t left = t.data.size()*2 - t.playpos;
+      if (len >= left)
+        len = left;
+      if (len == 0)
+        continue;
+      old_mixaudio(stream, &t.data[t.playpos/2], len, t.volume);
+    }
+    t.playpos += len;
+  }
+}
+
+/**
+ * Mixes one buffer with snd_mix() or snd_mix_scalar()
+ */
+static void mix_new(std::vector<TestChannel>& ch, int nBuffer, int16_t* stream, bool fScalar)
+{
+  T_MixSource src[TEST_CHANNELS];
+  int         nSources = 0;
+
+  for (int c = 0; c < TEST_CHANNELS; c++)
+  {
+    TestChannel& t   = ch[c];
+    T_MixSource& s   = src[nSources];
+    uint32_t     len = TEST_SAMPLES*2;
+
+    if (nBuffer < t.nStart)
+      continue;
+    if (t.fLoop)
+    {
+      s.data     = &t.data[0];
+      s.count    = len/2;
+      s.length   = t.data.size();
+      s.pos      = t.soundpos;
+      s.step     = (uint32_t)( (1<<SND_MIX_EIS) * t.pitch);
+      t.soundpos = snd_advance(s.length, s.pos, s.step, s.count);
+    }
+    else
+    {
+      uint32_t left = t.data.size()*2 - t.playpos;
+      if (len >= left)
+        len = left;
+      if (len == 0)
+        continue;
+      s.data   = &t.data[t.playpos/2];
+      s.count  = len/2;
+      s.length = 0;
+      s.pos    = 0;
+      s.step   = 0;
+    }
+    s.volume = t.volume;
+    nSources++;
+    t.playpos += len;
+  }
+
+  if (fScalar)
+    snd_mix_scalar(stream, TEST_SAMPLES, src, nSources);
+  else
+    snd_mix(stream, TEST_SAMPLES, src, nSources);
+}
+
+/**
+ * Runs the scenario with one of the mixers, returns the CPU time in
+ * seconds. The output of all buffers is appended to out.
+ */
+static double run(int nMixer, int nBuffers, std::vector<int16_t>& out)
+{
+  std::vector<TestChannel> ch;
+  std::vector<int16_t>     stream(TEST_SAMPLES);
+  double                   dTime = 0;
+
+  setup(ch);
+  out.clear();
+  for (int b = 0; b < nBuffers; b++)
+  {
+    update(ch, b);
+    memset(&stream[0], 0, TEST_SAMPLES*2);
+
+    clock_t start = clock();
+    switch (nMixer)
+    {
+     case 0:
+      mix_old(ch, b, &stream[0]);
+      break;
+     case 1:
+      mix_new(ch, b, &stream[0], true);
+      break;
+     default:
+      mix_new(ch, b, &stream[0], false);
+      break;
+    }
+    dTime += (double)(clock()-start)/CLOCKS_PER_SEC;
+    out.insert(out.end(), stream.begin(), stream.end());
+  }
+  return dTime;
+}
+
+// --- voices ----------------------------------------------
+
+/**
+ * Volume and pitch of engine v, like T_EngineVoice::update(): linear
+ * attenuation up to 1800 ft, silent beyond.
+ */
+static void engine(int v, int nBuffer, int& volume, uint32_t& step)
+{
+  float flDist = 1000 + 950*sin(0.02*nBuffer + 0.7*v);
+  float pitch  = 0.6 + 0.02*v + 0.2*sin(0.05*nBuffer + v);
+
+  if (flDist >= 1800)
+    volume = 0;
+  else
+  {
+    volume = (int)(SND_MIX_MAXVOLUME - SND_MIX_MAXVOLUME*flDist/1800);
+    if (volume < 7)
+      volume = 7;
+  }
+  step = (uint32_t)( (1<<SND_MIX_EIS) * pitch);
+}
+
+/**
+ * Renders the engines, returns the CPU time in seconds. nReal == 0
+ * plays them the old way. The output is appended to out, the final
+ * positions are stored in pos.
+ */
+static double run_voices(int nReal, int nBuffers, std::vector<int16_t>& out,
+                         std::vector<uint32_t>& pos, double& dMixed)
+{
+  std::vector<int16_t> data;
+  std::vector<int16_t> stream(TEST_SAMPLES);
+  std::vector<int16_t> dyn_buffer(TEST_SAMPLES);
+  T_MixVoice           voice[TEST_VOICES];
+  double               dTime = 0;
+
+  lcg_state = 4711;
+  for (int n = 0; n < 7919; n++)
+    data.push_back((int16_t)((n % 97)*500 - 24000 + noise()/8));
+
+  for (int v = 0; v < TEST_VOICES; v++)
+  {
+    voice[v].data   = &data[0];
+    voice[v].length = data.size();
+    voice[v].pos    = (v*977) << SND_MIX_EIS;
+  }
+
+  dMixed = 0;
+  out.clear();
+  for (int b = 0; b < nBuffers; b++)
+  {
+    for (int v = 0; v < TEST_VOICES; v++)
+      engine(v, b, voice[v].volume, voice[v].step);
+    memset(&stream[0], 0, TEST_SAMPLES*2);
+
+    clock_t start = clock();
+    if (nReal == 0)
+    {
+      for (int v = 0; v < TEST_VOICES; v++)
+      {
+        voice[v].pos = old_resample(voice[v].data, voice[v].length, voice[v].pos,
+                                    (float)voice[v].step / (1<<SND_MIX_EIS),
+                                    &dyn_buffer[0], TEST_SAMPLES);
+        old_mixaudio(&stream[0], &dyn_buffer[0], TEST_SAMPLES*2, voice[v].volume);
+      }
+      dMixed += TEST_VOICES;
+    }
+    else
+    {
+      dMixed += snd_mix_voices(&stream[0], TEST_SAMPLES, voice, TEST_VOICES, nReal);
+    }
+    dTime += (double)(clock()-start)/CLOCKS_PER_SEC;
+    out.insert(out.end(), stream.begin(), stream.end());
+  }
+
+  pos.clear();
+  for (int v = 0; v < TEST_VOICES; v++)
+    pos.push_back(voice[v].pos);
+  dMixed /= nBuffers;
+
+  return dTime;
+}
+
+/**
+ * Renders the engines three times, returns the number of errors.
+ */
+static int test_voices(int nBuffers)
+{
+  std::vector<int16_t>  ref;
+  std::vector<int16_t>  res;
+  std::vector<int16_t>  culled;
+  std::vector<uint32_t> refPos;
+  std::vector<uint32_t> resPos;
+  std::vector<uint32_t> culledPos;
+  double                dMixed[3];
+  double                dTime[3];
+  int                   nDiff = 0;
+
+  dTime[0] = run_voices(0,           nBuffers, ref,    refPos,    dMixed[0]);
+  dTime[1] = run_voices(TEST_VOICES, nBuffers, res,    resPos,    dMixed[1]);
+  dTime[2] = run_voices(TEST_REAL,   nBuffers, culled, culledPos, dMixed[2]);
+
+  for (int b = 0; b < nBuffers; b++)
+  {
+    if (memcmp(&res[b*TEST_SAMPLES], &ref[b*TEST_SAMPLES], TEST_SAMPLES*2) != 0)
+    {
+      if (nDiff == 0)
+        printf("  snd_mix_voices: first difference in buffer %d\n", b);
+      nDiff++;
+    }
+  }
+  printf("snd_mix_voices: %d buffers different\n", nDiff);
+
+  if (refPos != resPos || refPos != culledPos)
+  {
+    printf("snd_mix_voices: voices are out of phase\n");
+    nDiff++;
+  }
+
+  printf("%d engines, old        %8.2f us per buffer\n", TEST_VOICES, 1e6*dTime[0]/nBuffers);
+  printf("%d engines, all mixed  %8.2f us per buffer, %5.1f voices mixed\n",
+         TEST_VOICES, 1e6*dTime[1]/nBuffers, dMixed[1]);
+  printf("%d engines, %d real    %8.2f us per buffer, %5.1f voices mixed\n",
+         TEST_VOICES, TEST_REAL, 1e6*dTime[2]/nBuffers, dMixed[2]);
+
+  return nDiff;
+}
+
+int main(int argc, char** argv)
+{
+  int nBuffers = 2000;
+  int nErrors  = 0;
+
+  for (int i=1; i<argc; i++)
+  {
+    if (strcmp(argv[i], "-n") == 0 && i+1 < argc)
+      nBuffers = atoi(argv[++i]);
+  }
+
+  std::vector<int16_t> ref;
+  std::vector<int16_t> res;
+  const char*          name[3] = { "old", "snd_mix_scalar", "snd_mix" };
+  double               dTime[3];
+
+  dTime[0] = run(0, nBuffers, ref);
+  for (int m = 1; m < 3; m++)
+  {
+    int nDiff = 0;
+
+    dTime[m] = run(m, nBuffers, res);
+    for (int b = 0; b < nBuffers; b++)
+    {
+      for (int n = 0; n < TEST_SAMPLES; n++)
+      {
+        if (res[b*TEST_SAMPLES+n] != ref[b*TEST_SAMPLES+n])
+        {
+          if (nDiff == 0)
+            printf("  %s: first difference in buffer %d, sample %d: %d/%d\n",
+                   name[m], b, n, res[b*TEST_SAMPLES+n], ref[b*TEST_SAMPLES+n]);
+          nDiff++;
+          break;
+        }
+      }
+    }
+    nErrors += nDiff;
+    printf("%s: %d buffers different\n", name[m], nDiff);
+  }
+
+  printf("snd_mix implementation: %s\n", snd_mix_implementation());
+  for (int m = 0; m < 3; m++)
+    printf("%-15s %8.2f us per buffer\n", name[m], 1e6*dTime[m]/nBuffers);
+
+  nErrors += test_voices(nBuffers);
+
+  return nErrors;
+}
@@ -35,6 +35,7 @@
 #include "crrc_soundserver.h"
 #include "crrc_main.h"
 #include "mod_misc/lib_conversions.h"
+#include <map>
 
 
 // --- generic functions ----------------------------------
@@ -62,34 +63,80 @@ void PrintFormat(const char *title, SDL_AudioSpec *fmt)
  *  interfaces the sound server to SDL. It is called by the
  *  SDL routines whenever the sound card accepts new input
  *  data.
+ *
+ *  All channels are collected first and then mixed into
+ *  the stream in one pass (see snd_mix()). The callback
+ *  doesn't lock anything: a sample which has come to its
+ *  end is only marked as finished, the main thread removes
+ *  it later (see CRRCAudioServer::reclaimChannels()).
+ *
+ *  fInCallback and the channel and voice pointers are
+ *  accessed sequentially consistent, so either the main
+ *  thread sees the callback running or the callback sees
+ *  a pointer which has been taken out of the list.
  */
 void snd_callback(void *_unused, Uint8 *stream, int len)
 {
-  Uint32 samples;
+  T_MixSource src[CRRC_AUDIO_CHANNELS];
+  int         nSources = 0;
+  T_MixVoice  mv[CRRC_AUDIO_VOICES];
+  T_VoiceContainer *vc[CRRC_AUDIO_VOICES];
+  int         nVoices = 0;
   CRRCAudioServer *server = CRRCAudioServer::getRunningInstance();
   
-  if (!server->is_paused)
+  __atomic_store_n(&server->fInCallback, true, __ATOMIC_SEQ_CST);
+
+  if (!__atomic_load_n(&server->is_paused, __ATOMIC_RELAXED))
   {
     for (int i = 0; i < CRRC_AUDIO_CHANNELS; i++)
     {
-      if (server->channel[i] != NULL && server->channel[i]->sample != NULL)
+      T_PlaybackContainer *pb = __atomic_load_n(&server->channel[i], __ATOMIC_SEQ_CST);
+
+      if (pb != NULL && pb->sample != NULL && !__atomic_load_n(&pb->finished, __ATOMIC_RELAXED))
       {
-        samples = len;
-        Uint8  *pos = server->channel[i]->sample->getMixableData(server->channel[i]->playpos, &samples);
+        Uint32 samples = len;
+        pb->sample->getMixSource(pb->playpos, &samples, &src[nSources]);
         
         // end of sample reached?
         if (samples == 0)
         {
-          server->stopChannel(i);
+          __atomic_store_n(&pb->finished, true, __ATOMIC_RELEASE);
         }
         else
         {
-          SDL_MixAudio(stream, pos, samples, server->channel[i]->volume);
-          server->channel[i]->playpos += samples;
+          // read the volume after getMixSource(), which may have set it
+          src[nSources++].volume = __atomic_load_n(&server->ucChannelVolume[i], __ATOMIC_RELAXED);
+          pb->playpos += samples;
         }
       }
     }
+    snd_mix((int16_t*)stream, len/2, src, nSources);
+
+    for (int v = 0; v < CRRC_AUDIO_VOICES; v++)
+    {
+      T_VoiceContainer *p = __atomic_load_n(&server->voice[v], __ATOMIC_SEQ_CST);
+
+      if (p != NULL)
+      {
+        mv[nVoices].data   = (const int16_t*)p->sample->getSamples();
+        mv[nVoices].length = p->sample->getLength()/2;
+        mv[nVoices].pos    = p->pos;
+        mv[nVoices].step   = __atomic_load_n(&p->step, __ATOMIC_RELAXED);
+        mv[nVoices].volume = __atomic_load_n(&p->volume, __ATOMIC_RELAXED);
+        vc[nVoices++]      = p;
+      }
+    }
+    int nReal = snd_mix_voices((int16_t*)stream, len/2, mv, nVoices,
+                               CRRC_AUDIO_REAL_VOICES);
+    __atomic_store_n(&server->nRealVoices, nReal, __ATOMIC_RELAXED);
+    for (int v = 0; v < nVoices; v++)
+    {
+      vc[v]->pos = mv[v].pos;
+    }
   }
+
+  __atomic_store_n(&server->fInCallback, false, __ATOMIC_RELEASE);
+  __atomic_add_fetch(&server->nCallbacks, 1, __ATOMIC_RELEASE);
 }
 
 
@@ -102,7 +149,7 @@ CRRCAudioServer* CRRCAudioServer::instance = NULL;
  *  \param config Pointer to the XML config file.
  */
 CRRCAudioServer::CRRCAudioServer(SimpleXMLTransfer *config)
-  : audio_spec(NULL), is_paused(true)
+  : audio_spec(NULL), is_paused(true), nRealVoices(0), fInCallback(false), nCallbacks(0)
 {
   // Prepare config files
   config->makeSureAttributeExists("sound.samplerate", "48000");
@@ -126,6 +173,11 @@ CRRCAudioServer::CRRCAudioServer(SimpleXMLTransfer *config)
   for (int i = 0; i < CRRC_AUDIO_CHANNELS; i++)
   {
     channel[i] = NULL;
+    ucChannelVolume[i] = 0;
+  }
+  for (int v = 0; v < CRRC_AUDIO_VOICES; v++)
+  {
+    voice[v] = NULL;
   }
 
   // try to open
@@ -165,20 +217,10 @@ CRRCAudioServer::~CRRCAudioServer()
   SDL_PauseAudio(1);
 
   // free any allocated samples
-  for (int i = 0; i < CRRC_AUDIO_CHANNELS; i++)
+  stopAllChannels();
+  for (int v = 0; v < CRRC_AUDIO_VOICES; v++)
   {
-    if (channel[i] != NULL)
-    {
-      if (channel[i]->discard)
-      {
-        #if DEBUG_SOUND_SERVER > 0
-        printf("Discarding sample %s.\n", channel[i]->sample->getName().c_str());
-        #endif
-        delete channel[i]->sample;
-      }
-      delete channel[i];
-      channel[i] = NULL;
-    }
+    removeVoice(v);
   }
   free(audio_spec);
   SDL_CloseAudio();
@@ -196,7 +238,7 @@ void CRRCAudioServer::putBackIntoConfig(SimpleXMLTransfer *config) const
 {
   if (config != NULL)
   {
-    float flModelVol = (float)ucModelVolume / (float)SDL_MIX_MAXVOLUME;
+    float flModelVol = (float)getModelVolume() / (float)SDL_MIX_MAXVOLUME;
     std::string s = ftoStr(flModelVol, 1, 3);
     std::cout << "CRRCAudioServer::putBackIntoConfig: sound.model.vol == " << s << std::endl;
     config->setAttributeOverwrite("sound.model.vol", s);
@@ -273,6 +315,9 @@ int CRRCAudioServer::playSample(const char *filename, unsigned int volume)
  *  from all flavours of playSample(). It returns the
  *  number of the channel to which the sample was assigned
  *  or -1 if there was no more free channel.
+ *
+ *  The container is filled completely before it is published
+ *  to the callback, so there's no need to lock the audio.
  *  \param sample Pointer to the sample to be played.
  *  \param volume playback volume
  *  \param disc   Discard sample after playback?
@@ -294,17 +339,22 @@ int CRRCAudioServer::addSample(T_SoundSample *sample,
     sample->convert(audio_spec);
   }
   
-  SDL_LockAudio();
+  if (volume > SDL_MIX_MAXVOLUME)
+  {
+    volume = SDL_MIX_MAXVOLUME;
+  }
+
   for (int i = 0; i < CRRC_AUDIO_CHANNELS; i++)
   {
-    if (channel[i] == NULL)
+    if (__atomic_load_n(&channel[i], __ATOMIC_RELAXED) == NULL)
     {
       T_PlaybackContainer *pb = new T_PlaybackContainer;
       pb->sample = sample;
-      pb->volume = volume;
       pb->discard = disc;
       pb->playpos = 0;
-      channel[i] = pb;
+      pb->finished = false;
+      __atomic_store_n(&ucChannelVolume[i], (Uint8)volume, __ATOMIC_RELAXED);
+      __atomic_store_n(&channel[i], pb, __ATOMIC_SEQ_CST);
       ret = i;
       #if DEBUG_SOUND_SERVER > 0
       printf("Added sample %s to channel %d.\n", sample->getName().c_str(), i);
@@ -312,7 +362,6 @@ int CRRCAudioServer::addSample(T_SoundSample *sample,
       break;
     }
   }
-  SDL_UnlockAudio();
   
   #if DEBUG_SOUND_SERVER > 0
   if (ret < 0)
@@ -340,29 +389,57 @@ SDL_AudioSpec* CRRCAudioServer::getAudioSpec() const
  *  sample was created by the server, it will automatically
  *  be deleted.
  *
+ *  The channel is removed from the list first. If the
+ *  callback is running at that moment, it may still use
+ *  the sample, so the method waits for it to finish before
+ *  anything is deleted.
+ *
  *  \param c channel number
  */
 void CRRCAudioServer::stopChannel(int c)
 {
   if ((c >= 0) && (c < CRRC_AUDIO_CHANNELS))
   {
-    if (channel[c] != NULL)
+    T_PlaybackContainer *pb = __atomic_load_n(&channel[c], __ATOMIC_RELAXED);
+
+    if (pb != NULL)
     {
       #if DEBUG_SOUND_SERVER > 0
-      printf("Stopping sample %s on channel %d.\n", channel[c]->sample->getName().c_str(), c);
+      printf("Stopping sample %s on channel %d.\n", pb->sample->getName().c_str(), c);
       #endif
-      SDL_LockAudio();
-      if (channel[c]->discard)
+      __atomic_store_n(&channel[c], (T_PlaybackContainer*)NULL, __ATOMIC_SEQ_CST);
+      waitForCallback();
+
+      if (pb->discard)
       {
         #if DEBUG_SOUND_SERVER > 0
-        printf("Discarding sample %s.\n", channel[c]->sample->getName().c_str());
+        printf("Discarding sample %s.\n", pb->sample->getName().c_str());
         #endif
-        delete channel[c]->sample;
+        delete pb->sample;
         
       }
-      delete channel[c];
-      channel[c] = NULL;
-      SDL_UnlockAudio();
+      delete pb;
+    }
+  }
+}
+
+
+/** \brief Wait for a running callback.
+ *
+ *  Returns immediately if the callback isn't running, else
+ *  it returns as soon as the callback has finished. A
+ *  callback started after the call to this method doesn't
+ *  see anything removed before the call.
+ */
+void CRRCAudioServer::waitForCallback()
+{
+  Uint32 n = __atomic_load_n(&nCallbacks, __ATOMIC_ACQUIRE);
+
+  if (__atomic_load_n(&fInCallback, __ATOMIC_SEQ_CST))
+  {
+    while (__atomic_load_n(&nCallbacks, __ATOMIC_ACQUIRE) == n)
+    {
+      SDL_Delay(0);
     }
   }
 }
@@ -383,6 +460,44 @@ void CRRCAudioServer::stopAllChannels()
 }
 
 
+/** \brief Free the channels which have finished playing.
+ *
+ *  The callback only marks a sample which has come to its end
+ *  as finished. The main thread calls this method once per
+ *  frame to take those channels out of the list and delete
+ *  them, waiting at most once for a running callback.
+ */
+void CRRCAudioServer::reclaimChannels()
+{
+  T_PlaybackContainer *done[CRRC_AUDIO_CHANNELS];
+  int nDone = 0;
+
+  for (int c = 0; c < CRRC_AUDIO_CHANNELS; c++)
+  {
+    T_PlaybackContainer *pb = __atomic_load_n(&channel[c], __ATOMIC_RELAXED);
+
+    if (pb != NULL && __atomic_load_n(&pb->finished, __ATOMIC_ACQUIRE))
+    {
+      __atomic_store_n(&channel[c], (T_PlaybackContainer*)NULL, __ATOMIC_SEQ_CST);
+      done[nDone++] = pb;
+    }
+  }
+
+  if (nDone > 0)
+  {
+    waitForCallback();
+    for (int i = 0; i < nDone; i++)
+    {
+      if (done[i]->discard)
+      {
+        delete done[i]->sample;
+      }
+      delete done[i];
+    }
+  }
+}
+
+
 /** \brief Set the volume of a channel.
  *
  *  Set a channel's playback volume to the given level. The
@@ -396,13 +511,115 @@ void CRRCAudioServer::setChannelVolume(int c, unsigned char vol)
 {
   if ((c >= 0) && (c < CRRC_AUDIO_CHANNELS))
   {
-    if (channel[c] != NULL)
+    if (__atomic_load_n(&channel[c], __ATOMIC_RELAXED) != NULL)
     {
       if (vol > SDL_MIX_MAXVOLUME)
       {
         vol = SDL_MIX_MAXVOLUME;
       }
-      channel[c]->volume = vol;
+      __atomic_store_n(&ucChannelVolume[c], vol, __ATOMIC_RELAXED);
+    }
+  }
+}
+
+
+/** \brief Add a voice.
+ *
+ *  Plays the sample as a loop on a voice. The voice is
+ *  silent until setVoice() is called. The sample is not
+ *  copied, so a number of voices can play the same sample
+ *  without using any additional memory. It has to be in the
+ *  format of the server and must not be deleted before the
+ *  voice has been removed.
+ *
+ *  \param sample Pointer to the sample to be played.
+ *  \return voice number or -1 if there's no free voice
+ */
+int CRRCAudioServer::addVoice(T_SoundSample *sample)
+{
+  if ((sample->getFrequency() != audio_spec->freq)
+        ||
+      (sample->getFormat() != audio_spec->format)
+        ||
+      (sample->getNumChannels() != audio_spec->channels))
+  {
+    sample->convert(audio_spec);
+  }
+
+  if (sample->getLength() < 2)
+  {
+    return -1;
+  }
+
+  for (int v = 0; v < CRRC_AUDIO_VOICES; v++)
+  {
+    if (__atomic_load_n(&voice[v], __ATOMIC_RELAXED) == NULL)
+    {
+      T_VoiceContainer *p = new T_VoiceContainer;
+      p->sample = sample;
+      p->pos    = 0;
+      p->step   = 1 << EIS;
+      p->volume = 0;
+      __atomic_store_n(&voice[v], p, __ATOMIC_SEQ_CST);
+      return v;
+    }
+  }
+  return -1;
+}
+
+
+/** \brief Set pitch and volume of a voice.
+ *
+ *  A voice with a volume of zero doesn't use any time in
+ *  the callback. If there are more audible voices than
+ *  CRRC_AUDIO_REAL_VOICES, the quietest ones are not mixed.
+ *
+ *  \param v voice number
+ *  \param pitch pitch, 1.0 plays the sample at the original pitch
+ *  \param vol desired volume (0 ... SDL_MIX_MAXVOLUME)
+ */
+void CRRCAudioServer::setVoice(int v, float pitch, unsigned char vol)
+{
+  T_VoiceContainer *p = NULL;
+
+  if ((v >= 0) && (v < CRRC_AUDIO_VOICES))
+  {
+    p = __atomic_load_n(&voice[v], __ATOMIC_RELAXED);
+  }
+  if (p != NULL)
+  {
+    if (pitch < 0.0001)
+    {
+      pitch = 0.0001;
+    }
+    if (vol > SDL_MIX_MAXVOLUME)
+    {
+      vol = SDL_MIX_MAXVOLUME;
+    }
+    __atomic_store_n(&p->step, (Uint32)( (1<<EIS) * pitch), __ATOMIC_RELAXED);
+    __atomic_store_n(&p->volume, (Uint8)vol, __ATOMIC_RELAXED);
+  }
+}
+
+
+/** \brief Remove a voice.
+ *
+ *  Like stopChannel(), this may wait for a running callback.
+ *  The sample is not deleted.
+ *
+ *  \param v voice number
+ */
+void CRRCAudioServer::removeVoice(int v)
+{
+  if ((v >= 0) && (v < CRRC_AUDIO_VOICES))
+  {
+    T_VoiceContainer *p = __atomic_load_n(&voice[v], __ATOMIC_RELAXED);
+
+    if (p != NULL)
+    {
+      __atomic_store_n(&voice[v], (T_VoiceContainer*)NULL, __ATOMIC_SEQ_CST);
+      waitForCallback();
+      delete p;
     }
   }
 }
@@ -419,14 +636,49 @@ void CRRCAudioServer::setModelVolume(unsigned char vol)
   {
     vol = SDL_MIX_MAXVOLUME;
   }
-  SDL_LockAudio();
-  ucModelVolume = vol;
-  SDL_UnlockAudio();
+  __atomic_store_n(&ucModelVolume, vol, __ATOMIC_RELAXED);
 }
 
 
 // --- Implementation of class T_SoundSample --------------
 
+/// sample data which has been loaded from a file, see T_SoundSample
+static std::map<std::string, T_SharedSampleData*> sharedData;
+
+/// protects sharedData, samples may be loaded on a background thread
+static SDL_mutex* sharedLock = NULL;
+
+/** \brief Lock sharedData.
+ *
+ *  The mutex is created by the main thread, which loads the
+ *  first sample before any other thread is started.
+ */
+static void lockSharedData()
+{
+  if (sharedLock == NULL)
+    sharedLock = SDL_CreateMutex();
+  SDL_LockMutex(sharedLock);
+}
+
+/** \brief Release shared sample data.
+ *
+ *  The data is freed if it isn't used by any other sample.
+ */
+static void releaseSharedData(T_SharedSampleData* s)
+{
+  lockSharedData();
+  bool fLast = (--s->nRefs == 0);
+  if (fLast)
+    sharedData.erase(s->key);
+  SDL_UnlockMutex(sharedLock);
+
+  if (fLast)
+  {
+    SDL_FreeWAV(s->buffer);
+    delete s;
+  }
+}
+
 /** \brief Create an empty sound sample.
  *
  *  This ctor is mainly useful for derived classes which
@@ -434,7 +686,7 @@ void CRRCAudioServer::setModelVolume(unsigned char vol)
  *  data.
  */
 T_SoundSample::T_SoundSample(SDL_AudioSpec *fmt)
-  : samplename(""), length(0), buffer(NULL)
+  : samplename(""), length(0), buffer(NULL), shared(NULL)
 {
   spec.format = fmt->format;
   spec.freq   = fmt->freq;
@@ -455,12 +707,35 @@ T_SoundSample::T_SoundSample(SDL_AudioSpec *fmt)
  * the SDL_mixer library. Many thanks to the original
  * author(s).
  *
+ * If the file has already been loaded and converted to the
+ * same format for another sample which still exists, the
+ * data of that sample is used.
+ *
  * \param filename the file to be loaded
  * \param fmt desired audio format
  */
 T_SoundSample::T_SoundSample(const char *filename, SDL_AudioSpec *fmt)
-  : samplename(""), length(0), buffer(NULL)
+  : samplename(""), length(0), buffer(NULL), shared(NULL)
 {
+  std::string key = filename;
+  key += "|" + itoStr(fmt->freq, ' ', 1) + "|" + itoStr(fmt->format, ' ', 1)
+         + "|" + itoStr(fmt->channels, ' ', 1);
+
+  lockSharedData();
+  std::map<std::string, T_SharedSampleData*>::iterator it = sharedData.find(key);
+  if (it != sharedData.end())
+  {
+    shared = it->second;
+    shared->nRefs++;
+    buffer     = shared->buffer;
+    length     = shared->length;
+    spec       = shared->spec;
+    samplename = filename;
+    SDL_UnlockMutex(sharedLock);
+    return;
+  }
+  SDL_UnlockMutex(sharedLock);
+
   SDL_AudioSpec *ret = SDL_LoadWAV(filename, &spec, &buffer, &length);
   if (NULL == ret)
   {
@@ -479,6 +754,21 @@ T_SoundSample::T_SoundSample(const char *filename, SDL_AudioSpec *fmt)
   samplename    = filename;
 
   convert(fmt);
+
+  // another thread might have loaded the same file in the meantime,
+  // then this sample keeps its own copy
+  lockSharedData();
+  if (sharedData.find(key) == sharedData.end())
+  {
+    shared = new T_SharedSampleData;
+    shared->key    = key;
+    shared->buffer = buffer;
+    shared->length = length;
+    shared->spec   = spec;
+    shared->nRefs  = 1;
+    sharedData[key] = shared;
+  }
+  SDL_UnlockMutex(sharedLock);
 }
 
 
@@ -493,6 +783,8 @@ T_SoundSample::T_SoundSample(const char *filename, SDL_AudioSpec *fmt)
 void T_SoundSample::convert(SDL_AudioSpec *fmt)
 {
   SDL_AudioCVT  wavecvt;
+
+  unshare();
   
   /* Build the audio converter and create conversion buffers */
   if (SDL_BuildAudioCVT(&wavecvt,
@@ -550,7 +842,32 @@ void T_SoundSample::convert(SDL_AudioSpec *fmt)
  */
 T_SoundSample::~T_SoundSample()
 {
-  SDL_FreeWAV(buffer);
+  if (shared != NULL)
+  {
+    releaseSharedData(shared);
+  }
+  else
+  {
+    SDL_FreeWAV(buffer);
+  }
+}
+
+
+/** \brief Use a data buffer of its own.
+ *
+ *  If the data buffer is shared with other samples, it is
+ *  copied, so it can be modified.
+ */
+void T_SoundSample::unshare()
+{
+  if (shared != NULL)
+  {
+    buffer = (Uint8*)malloc(length);
+    memcpy(buffer, shared->buffer, length);
+
+    releaseSharedData(shared);
+    shared = NULL;
+  }
 }
 
 
@@ -586,6 +903,26 @@ Uint8*  T_SoundSample::getMixableData(Uint32 playCount, Uint32 *len)
 }
 
 
+/** \brief Describe a chunk of data for the mixer.
+ *
+ *  This method fills in the mixer source for the next
+ *  <code>len</code> bytes, based on getMixableData(). Derived
+ *  classes which can be resampled by the mixer itself
+ *  override it. The volume is set by the caller.
+ *  \param  playpos   The current playback position.
+ *  \param  len       Requested data size, will be set to number of actually remaining samples.
+ *  \param  src       The mixer source.
+ */
+void T_SoundSample::getMixSource(Uint32 playpos, Uint32 *len, T_MixSource *src)
+{
+  src->data   = (const int16_t*)getMixableData(playpos, len);
+  src->count  = *len / 2;
+  src->length = 0;
+  src->pos    = 0;
+  src->step   = 0;
+}
+
+
 /** \brief Get the number of bytes per sample.
  *
  *  This method returns the number of bytes per sample.
@@ -696,7 +1033,9 @@ Uint8* T_PitchVariableLoop::getMixableData(Uint32 playpos, Uint32 *len)
   Sint16  *writeptr   = (Sint16*)&dyn_buffer[0];
   Uint32  uiSoundpos  = soundpos;         // position in integer-arithmetic (<< EIS), local copy for fast access
   Sint16* sndptr      = (Sint16*)buffer;  // local copy for fast access
-  Uint32  uiPitch     = (Uint32)( (1<<EIS) * pitch); // pitch in integer-arithmetic
+  float   p;
+  __atomic_load(&pitch, &p, __ATOMIC_RELAXED);        // setPitch() may be called at any time
+  Uint32  uiPitch     = (Uint32)( (1<<EIS) * p);     // pitch in integer-arithmetic
   while (nSamplesToCopy--)
   {
     uiSoundpos += uiPitch;
@@ -763,25 +1102,49 @@ Uint8* T_PitchVariableLoop::getMixableData(Uint32 playpos, Uint32 *len)
 }
 
 
+#if CRRC_SOUND_STEREO == 0
+/** \brief Describe a chunk of data for the mixer.
+ *
+ *  Instead of interpolating into the dynamic buffer, the
+ *  mixer is told to resample the loop at the current pitch
+ *  while mixing. The result is the same as mixing the data
+ *  returned by getMixableData().
+ *
+ *  \param  playpos   The current playback position.
+ *  \param  len       Requested data size, won't change.
+ *  \param  src       The mixer source.
+ */
+void T_PitchVariableLoop::getMixSource(Uint32 playpos, Uint32 *len, T_MixSource *src)
+{
+  float p;
+
+  __atomic_load(&pitch, &p, __ATOMIC_RELAXED);  // setPitch() may be called at any time
+
+  src->data   = (const int16_t*)buffer;
+  src->count  = *len/2;
+  src->length = getLength()/2;
+  src->pos    = soundpos;
+  src->step   = (Uint32)( (1<<EIS) * p);
+  soundpos    = snd_advance(src->length, src->pos, src->step, src->count);
+}
+#endif
+
+
 /** \brief Set the pitch value for the sound loop.
  *
  *  This method controls the sample's pitch. A value
  *  of 1.0 will play the sample at the original pitch.
  *  Pitch values are automatically clamped to positive
- *  non-zero values.
+ *  non-zero values. The new value is used for the next
+ *  chunk of data.
  */
 void T_PitchVariableLoop::setPitch(float p)
 {
-  SDL_LockAudio();
   if (p < 0.0001)
   {
-    pitch = 0.0001;
-  }
-  else
-  {
-    pitch = p;
+    p = 0.0001;
   }
-  SDL_UnlockAudio();
+  __atomic_store(&pitch, &p, __ATOMIC_RELAXED);
 }
 
 
@@ -40,6 +40,7 @@
 #include <math.h>
 #include <SDL.h>
 #include "mod_misc/SimpleXMLTransfer.h"
+#include "crrc_soundmix.h"
 
 /// set this to 1 to generate some debug messages
 #define DEBUG_SOUND_SERVER (0)
@@ -47,6 +48,12 @@
 /// maximum number of simultaneous playing samples
 #define CRRC_AUDIO_CHANNELS (8) 
 
+/// maximum number of voices (see CRRCAudioServer::addVoice())
+#define CRRC_AUDIO_VOICES   (256)
+
+/// maximum number of voices which are actually mixed
+#define CRRC_AUDIO_REAL_VOICES (16)
+
 
 // Stereo sound is experimental. Right now the variometer
 // is simply copied to both channels so it appears to be
@@ -54,7 +61,7 @@
 // as a mono sound right now, using only the left channel.
 #define CRRC_SOUND_STEREO   (0)   ///< 0: mono, 1: stereo
 
-#define EIS 12      ///< integer interpolation constant
+#define EIS SND_MIX_EIS   ///< integer interpolation constant
 
 
 class T_SoundSample;
@@ -68,22 +75,72 @@ void PrintFormat(const char *title, SDL_AudioSpec *fmt);
  *  This container holds one sample while it is fed to
  *  the audio stream. It keeps track of all playback
  *  parameters needed by the callback.
+ *
+ *  A container is created by the main thread and published
+ *  in CRRCAudioServer::channel[]. From then on, playpos and
+ *  finished are written by the audio callback only. The
+ *  volume is kept in CRRCAudioServer::ucChannelVolume[].
+ *  finished is only accessed with __atomic_load_n() and
+ *  __atomic_store_n().
  */
 typedef struct
 {
   T_SoundSample* sample;  ///< The sample to be played.
   Uint32 playpos;         ///< Current playback position.
-  Uint8  volume;          ///< Playback volume of the sample.
   bool   discard;         ///< Free sample after playback has finished?
+  bool   finished;        ///< End of sample reached, set by the callback.
 } T_PlaybackContainer;
 
 
+/** \brief A voice container struct.
+ *
+ *  This container holds a sound loop which is played as a
+ *  voice. The step and volume are set by the main thread with
+ *  __atomic_store_n(), the position is advanced by the callback.
+ */
+typedef struct
+{
+  T_SoundSample*  sample;   ///< The loop to be played.
+  Uint32          pos;      ///< Current position (<< EIS).
+  Uint32          step;     ///< Pitch (<< EIS).
+  Uint8           volume;   ///< Playback volume, 0 makes the voice virtual.
+} T_VoiceContainer;
+
+
+/** \brief Sample data shared by all samples which have been
+ *  loaded from the same file and converted to the same format.
+ */
+typedef struct
+{
+  std::string   key;        ///< file name and format
+  Uint8*        buffer;     ///< the sample data
+  Uint32        length;     ///< length of the sample data
+  SDL_AudioSpec spec;       ///< format of the sample data
+  int           nRefs;      ///< number of samples using it
+} T_SharedSampleData;
+
+
 /** \brief The sound server
  *
  *  The sound server offers a range of services to the main
  *  application:
  *    - Initializing the audio hardware
  *    - Playback of sound samples
+ *
+ *  The audio callback never waits for the main thread: samples
+ *  are added and removed by the main thread only, volumes and
+ *  pitch values are relaxed atomic stores which the callback
+ *  picks up with the next buffer. Channels and voices are
+ *  published with __atomic_store_n() and read by the callback
+ *  with __atomic_load_n(). Only stopChannel() and removeVoice()
+ *  may have to wait until a running callback has finished,
+ *  before the sample is deleted. One-shot samples which have
+ *  finished are freed by reclaimChannels().
+ *
+ *  Besides the channels, there are voices for sound loops of
+ *  which many may play at the same time, like the engines of
+ *  robots. Only the loudest CRRC_AUDIO_REAL_VOICES voices are
+ *  mixed, the other ones are virtual and cost next to nothing.
  */
 class CRRCAudioServer
 {
@@ -100,9 +157,19 @@ class CRRCAudioServer
 
     void stopChannel(int c);
     void stopAllChannels();
+    void reclaimChannels();
 
     void setChannelVolume(int c, unsigned char vol);
 
+    int  addVoice(T_SoundSample *sample);
+    void setVoice(int v, float pitch, unsigned char vol);
+    void removeVoice(int v);
+
+    /**
+     *  Get the number of voices mixed during the last callback.
+     */
+    int getRealVoices() const {return __atomic_load_n(&nRealVoices, __ATOMIC_RELAXED);};
+
     SDL_AudioSpec* getAudioSpec() const;
   
     /**
@@ -121,7 +188,7 @@ class CRRCAudioServer
      *  This method stops the audio server. All samples are
      *  halted at their current playback position.
      */
-    void pause(bool do_pause = true) {int val = do_pause ? 1 : 0; SDL_PauseAudio(val); is_paused = do_pause;};
+    void pause(bool do_pause = true) {int val = do_pause ? 1 : 0; SDL_PauseAudio(val); __atomic_store_n(&is_paused, do_pause, __ATOMIC_RELAXED);};
     
     /**
      *  Get a pointer to the currently running sound server instance
@@ -140,18 +207,24 @@ class CRRCAudioServer
      *  Get the volume for all model sounds.
      *  \return model volume (0...SDL_MIX_MAXVOLUME)
      */
-    unsigned char getModelVolume() const {return ucModelVolume;};
+    unsigned char getModelVolume() const {return __atomic_load_n(&ucModelVolume, __ATOMIC_RELAXED);};
 
   private:
     SDL_AudioSpec*  audio_spec;       ///< the server's internal sample format
     bool            is_paused;        ///< the state of the sound server (playing or not)
     unsigned char   ucModelVolume;    ///< volume for model sounds
-    T_PlaybackContainer *channel[CRRC_AUDIO_CHANNELS];  ///< the sound channels
+    T_PlaybackContainer* channel[CRRC_AUDIO_CHANNELS];  ///< the sound channels
+    Uint8           ucChannelVolume[CRRC_AUDIO_CHANNELS];        ///< volume of the channels
+    T_VoiceContainer* voice[CRRC_AUDIO_VOICES];      ///< the voices
+    int             nRealVoices;      ///< voices mixed during the last callback
+    bool            fInCallback;      ///< the callback is running
+    Uint32          nCallbacks;       ///< number of finished callbacks
     static CRRCAudioServer *instance;                   ///< the currently active instance
 
     int addSample(T_SoundSample *sample,
                                  unsigned int volume,
                                  bool disc);
+    void waitForCallback();
 
 };
 
@@ -176,6 +249,13 @@ class T_SoundSample
     virtual void    convert(SDL_AudioSpec *fmt);
     virtual Uint32  getLength() const;
     virtual Uint8*  getMixableData(Uint32 playpos, Uint32 *len);
+    virtual void    getMixSource(Uint32 playpos, Uint32 *len, T_MixSource *src);
+
+    /**
+     *  Get the sample data, 16 bit signed samples in the
+     *  format of the sound server.
+     */
+    const Sint16* getSamples() const {return (const Sint16*)buffer;};
 
     /** 
      *  Get the sample's sample rate.
@@ -207,7 +287,9 @@ class T_SoundSample
     SDL_AudioSpec spec;         ///< sample format
     Uint32        length;       ///< length of the sample data
     Uint8         *buffer;      ///< data buffer containing the sample data
+    T_SharedSampleData *shared; ///< the data buffer is shared with other samples
    
+    void  unshare();
     int   getSampleSize();
     int   bits();
     bool  isSigned();
@@ -225,11 +307,14 @@ class T_PitchVariableLoop : protected T_SoundSample
     T_PitchVariableLoop(const char *filename, SDL_AudioSpec *fmt);
     virtual ~T_PitchVariableLoop();
     virtual Uint8*  getMixableData(Uint32 playpos, Uint32 *len);
+#if CRRC_SOUND_STEREO == 0
+    virtual void    getMixSource(Uint32 playpos, Uint32 *len, T_MixSource *src);
+#endif
     virtual void    setPitch(float p);
   
   protected:
     std::vector<Uint8>  dyn_buffer;   ///< a buffer for the interpolated sample fragment
-    float               pitch;        ///< current pitch
+    float               pitch;        ///< current pitch, shared with the callback
     Uint32              soundpos;     ///< current playback position in the sample
 };
 
@@ -0,0 +1,193 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+/**
+ * \file crrc_telemetry.cpp
+ *
+ * Follows the telemetry which crrcsim exports with -k (see
+ * telemetry_shm.h) and prints it.
+ *
+ * Usage: crrc_telemetry [-k name] [-a] [-c count] [-s] [-w]
+ *
+ *   -k name   shared memory object (default /crrcsim)
+ *   -a        start with the oldest sample in the ring instead of
+ *             the next new one
+ *   -c count  exit after count samples
+ *   -s        only print the number of samples and lost samples
+ *             per second
+ *   -w        wait for crrcsim to start
+ *
+ * Every sample is printed as one line of whitespace separated
+ * columns, the first line names them. Samples are read in batches;
+ * if there is no new one the program sleeps for a millisecond, the
+ * ring holds enough samples for that.
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+#include "mod_misc/telemetry_shm.h"
+#include "mod_misc/scheduler.h"
+
+/// samples per read
+#define BATCH  1024
+
+
+static void printInfo(const crrc_telemetry_info& info)
+{
+  fprintf(stderr, "pid %i, dt %g s, %u slots, reset %u, aircraft %s\n",
+          info.pid, info.dt, info.capacity, info.reset, info.aircraft);
+}
+
+
+static void printSample(const crrc_telemetry_sample& s)
+{
+  printf("%llu %u %.6f", (unsigned long long)s.index, s.reset, s.time);
+  for (int i = 0; i < 3; i++)
+    printf(" %.4f", s.pos[i]);
+  for (int i = 0; i < 3; i++)
+    printf(" %.4f", s.vel[i]);
+  for (int i = 0; i < 3; i++)
+    printf(" %.4f", s.accel[i]);
+  for (int i = 0; i < 3; i++)
+    printf(" %.5f", s.pqr[i]);
+  for (int i = 0; i < 3; i++)
+    printf(" %.5f", s.euler[i]);
+  for (int i = 0; i < 3; i++)
+    printf(" %.4f", s.wind[i]);
+  printf(" %.4f", s.v_rel_airmass);
+  for (int i = 0; i < CRRC_TELEMETRY_INPUTS; i++)
+    printf(" %.3f", s.inputs[i]);
+  printf("\n");
+}
+
+
+int main(int argc, char** argv)
+{
+  const char*   name     = CRRC_TELEMETRY_NAME;
+  bool          fOldest  = false;
+  bool          fStats   = false;
+  bool          fWait    = false;
+  unsigned long nCount   = 0;
+  int           c;
+
+  while ((c = getopt(argc, argv, "k:ac:sw")) != -1)
+  {
+    switch (c)
+    {
+      case 'k':
+        name = optarg;
+        break;
+      case 'a':
+        fOldest = true;
+        break;
+      case 'c':
+        nCount = strtoul(optarg, NULL, 10);
+        break;
+      case 's':
+        fStats = true;
+        break;
+      case 'w':
+        fWait = true;
+        break;
+      default:
+        fprintf(stderr, "Usage: %s [-k name] [-a] [-c count] [-s] [-w]\n", argv[0]);
+        return(1);
+    }
+  }
+
+  CrrcTelemetry t = crrc_telemetry_open(name);
+  while (t == NULL && fWait)
+  {
+    usleep(100000);
+    t = crrc_telemetry_open(name);
+  }
+  if (t == NULL)
+  {
+    fprintf(stderr, "Can't open %s, is crrcsim running with -k %s?\n", name, name);
+    return(1);
+  }
+  if (fOldest)
+    crrc_telemetry_rewind(t);
+
+  crrc_telemetry_info info;
+  memset(&info, 0, sizeof(info));
+  if (crrc_telemetry_get_info(t, &info) == 0)
+    printInfo(info);
+
+  if (!fStats)
+    printf("index reset time x y z vx vy vz ax ay az p q r phi theta psi"
+           " wind_n wind_e wind_d v_rel aileron elevator rudder throttle"
+           " flap spoiler retract pitch aux0 aux1 aux2 aux3\n");
+
+  crrc_telemetry_sample* buf       = new crrc_telemetry_sample[BATCH];
+  unsigned long          nTotal    = 0;
+  unsigned long          nPeriod   = 0;
+  uint64_t               nLost     = 0;
+  uint64_t               nReported = 0;
+  uint32_t               nReset    = info.reset;
+  double                 dPeriod   = Scheduler::getSeconds();
+
+  while (nCount == 0 || nTotal < nCount)
+  {
+    long n = crrc_telemetry_read(t, buf, BATCH, &nLost);
+
+    if (nCount && nTotal + n > nCount)
+      n = nCount - nTotal;
+    nTotal  += n;
+    nPeriod += n;
+
+    if (!fStats)
+    {
+      for (long i = 0; i < n; i++)
+        printSample(buf[i]);
+      if (nLost != nReported)
+      {
+        fprintf(stderr, "%lu samples lost\n", (unsigned long)(nLost - nReported));
+        nReported = nLost;
+      }
+    }
+
+    // the aircraft might have changed
+    if (n && buf[n-1].reset != nReset && crrc_telemetry_get_info(t, &info) == 0)
+    {
+      nReset = info.reset;
+      printInfo(info);
+    }
+
+    double now = Scheduler::getSeconds();
+    if (fStats && now - dPeriod >= 1)
+    {
+      printf("%.0f samples/s, %lu lost\n", nPeriod / (now - dPeriod),
+             (unsigned long)(nLost - nReported));
+      nReported = nLost;
+      fflush(stdout);
+      nPeriod = 0;
+      dPeriod = now;
+    }
+
+    if (n < BATCH)
+      usleep(1000);
+  }
+
+  delete[] buf;
+  crrc_telemetry_close(&t);
+  return(0);
+}
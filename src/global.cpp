@@ -50,3 +50,7 @@ TInputDev*        Global::inputDev;
 Aircraft*         Global::aircraft;
 FlightRecorder*   Global::recorder;
 Robots*           Global::robots;
+SimThread*        Global::simThread = NULL;
+LatencyTrace*     Global::latencyTrace = NULL;
+TelemetryExport*  Global::telemetry = NULL;
+AircraftLoader*   Global::aircraftLoader = NULL;
@@ -32,12 +32,13 @@
 #define GLOBAL_H
 
 #include <string>
+#include <iostream>
 #include "mod_fdm/fdm_inputs.h"
 #include "mod_inputdev/inputdev.h"
 #include "mouse_kbd.h"
 
 // needed to make LOG() work without add. headers
-#include "mod_main/EventDispatcher.h"
+#include "mod_main/EventBus.h"
 
 // There's no need to pull in the full headers here.
 // Just declare the classes and leave the responsibility
@@ -54,6 +55,10 @@ class TInputDev;
 class Aircraft;
 class FlightRecorder;
 class Robots;
+class SimThread;
+class LatencyTrace;
+class TelemetryExport;
+class AircraftLoader;
 
 /**
  * Contains data related to test mode.
@@ -96,13 +101,17 @@ class Global
     static Aircraft*        aircraft;       ///< A complete Aircraft (model & FDM).
     static FlightRecorder*  recorder;
     static Robots*          robots;
+    static SimThread*       simThread;      ///< NULL if the simulation runs in the main loop
+    static LatencyTrace*    latencyTrace;   ///< NULL unless input latency is traced
+    static TelemetryExport* telemetry;      ///< NULL unless telemetry is exported
+    static AircraftLoader*  aircraftLoader; ///< NULL outside of the main loop
 };
 
 
 /** This macro logs a line of text to the console */
 #define LOG(_x)     do{                                               \
                         LogMessageEvent msg(_x);                      \
-                        EventDispatcher::getInstance()->raise(&msg);  \
+                        EventBus<LogMessageEvent>::raise(msg);        \
                       }while(0)
 
 #endif //GLOBAL_H
@@ -42,6 +42,8 @@ namespace Video
 
 #define INVALID_AIRPLANE_VISUALIZATION -1
 
+class StagedVisualization;
+
 #if defined(__APPLE__) || defined(MACOSX)
 #define DEFAULT_SKYBOX_TEXTURE_OFFSET (0.0009f)
 #else
@@ -93,6 +95,38 @@ long new_visualization( std::string const& model_name,
                         CRRCMath::Vector3 const& pCG,
                         SimpleXMLTransfer *xml);
 
+/**
+ * Load an airplane visualization without using it yet: the model and
+ * its textures are loaded into memory, the shadow and the coarse copy
+ * are made. May be called on any thread, while the main thread calls
+ * service_staging().
+ */
+StagedVisualization* stage_visualization(std::string const& model_name,
+                                         std::string const& texture_path,
+                                         CRRCMath::Vector3 const& pCG,
+                                         SimpleXMLTransfer *xml);
+
+/**
+ * Create a new airplane visualization from a staged one, which is
+ * deleted. Only the textures are uploaded and the animations added,
+ * unless the model couldn't be staged: then it is loaded here.
+ * Main thread only.
+ */
+long new_visualization(StagedVisualization* staged,
+                       SimpleXMLTransfer *xml);
+
+/**
+ * Deallocate a staged airplane visualization which isn't used.
+ * Main thread only.
+ */
+void delete_staged_visualization(StagedVisualization* staged);
+
+/**
+ * Make what stage_visualization() has requested from the main thread.
+ * To be called by the main thread once per frame.
+ */
+void service_staging();
+
 /**
  * Deallocate an airplane visualization
  */
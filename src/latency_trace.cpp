@@ -0,0 +1,257 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+/** \file latency_trace.cpp
+ *
+ *  Measures the time from a control input to the frame which shows it.
+ */
+
+#include <SDL.h>
+#include <SDL_thread.h>
+#include <cstdio>
+#include <cstring>
+#include <math.h>
+
+#include "latency_trace.h"
+#include "mod_misc/scheduler.h"
+
+/// aileron of the synthetic steps
+#define LATENCY_TRACE_STEP       (0.25)
+
+/// smallest change of the aileron which is traced as a step
+#define LATENCY_TRACE_THRESHOLD  (0.05)
+
+/// a probe which hasn't reached the screen after this time (s) is dropped
+#define LATENCY_TRACE_TIMEOUT    (1.0)
+
+
+LatencyTrace::LatencyTrace(std::string sInputMethod, double dStepPeriod)
+  : sInputMethod(sInputMethod), dStepPeriod(dStepPeriod), dNextStep(0),
+    flStep(-LATENCY_TRACE_STEP), dStepTime(0), flLast(0), fHaveLast(false),
+    idLast(0), fShowsSurface(false), fShowsStep(false),
+    nProbes(0), nDropped(0)
+{
+  static const char* names[STAGE_COUNT] =
+  {
+    "sample to read", "read to sim step", "sim step to photon",
+    "sample to surface", "sample to photon"
+  };
+
+  mutex = SDL_CreateMutex();
+  memset(&probe, 0, sizeof(probe));
+  for (int i = 0; i < STAGE_COUNT; i++)
+  {
+    stages[i].name   = names[i];
+    stages[i].dTotal = 0;
+    stages[i].dMin   = 1e9;
+    stages[i].dMax   = 0;
+  }
+  memset(histSurface, 0, sizeof(histSurface));
+  memset(histPhoton,  0, sizeof(histPhoton));
+}
+
+
+LatencyTrace::~LatencyTrace()
+{
+  SDL_DestroyMutex(mutex);
+}
+
+
+void LatencyTrace::input(TSimInputs* inputs)
+{
+  double now = Scheduler::getSeconds();
+
+  inputs->sample_time = now;
+
+  // synthetic transmitter: the stick jumps between two positions
+  if (dStepPeriod > 0)
+  {
+    if (now >= dNextStep)
+    {
+      flStep    = -flStep;
+      dStepTime = (dNextStep > 0) ? dNextStep : now;
+      dNextStep = dStepTime + dStepPeriod;
+      if (dNextStep < now)
+        dNextStep = now + dStepPeriod;
+    }
+    inputs->aileron     = flStep;
+    inputs->sample_time = dStepTime;
+  }
+
+  SDL_LockMutex(mutex);
+
+  if (probe.id != 0 && now - probe.dInput > LATENCY_TRACE_TIMEOUT)
+  {
+    // the simulation is paused, or the aircraft has been reset
+    nDropped++;
+    probe.id = 0;
+  }
+
+  if (fHaveLast && probe.id == 0
+      && fabs(inputs->aileron - flLast) >= LATENCY_TRACE_THRESHOLD)
+  {
+    memset(&probe, 0, sizeof(probe));
+    probe.id      = ++idLast;
+    probe.dSample = inputs->sample_time;
+    probe.dInput  = now;
+    fShowsSurface = false;
+    fShowsStep    = false;
+  }
+  flLast    = inputs->aileron;
+  fHaveLast = true;
+
+  // every input after the step shows it, until the next probe
+  inputs->trace_id = idLast;
+
+  SDL_UnlockMutex(mutex);
+}
+
+
+void LatencyTrace::step(const TSimInputs* inputs)
+{
+  SDL_LockMutex(mutex);
+  if (probe.id != 0 && inputs->trace_id == probe.id && probe.dStep == 0)
+    probe.dStep = Scheduler::getSeconds();
+  SDL_UnlockMutex(mutex);
+}
+
+
+void LatencyTrace::display()
+{
+  SDL_LockMutex(mutex);
+  if (probe.id != 0)
+  {
+    fShowsSurface = (probe.dSurface == 0);
+    fShowsStep    = (probe.dStep != 0);
+  }
+  SDL_UnlockMutex(mutex);
+}
+
+
+void LatencyTrace::frame()
+{
+  double now = Scheduler::getSeconds();
+
+  SDL_LockMutex(mutex);
+  if (probe.id != 0)
+  {
+    if (fShowsSurface)
+      probe.dSurface = now;
+    if (fShowsStep)
+    {
+      probe.dPhoton = now;
+      addProbe();
+      probe.id = 0;
+    }
+  }
+  fShowsSurface = false;
+  fShowsStep    = false;
+  SDL_UnlockMutex(mutex);
+}
+
+
+void LatencyTrace::addStage(int nStage, double dLatency)
+{
+  T_Stage& stage = stages[nStage];
+
+  stage.dTotal += dLatency;
+  if (dLatency < stage.dMin)
+    stage.dMin = dLatency;
+  if (dLatency > stage.dMax)
+    stage.dMax = dLatency;
+}
+
+
+void LatencyTrace::addProbe()
+{
+  double dSurface = probe.dSurface - probe.dSample;
+  double dPhoton  = probe.dPhoton  - probe.dSample;
+
+  addStage(STAGE_READ,    probe.dInput   - probe.dSample);
+  addStage(STAGE_STEP,    probe.dStep    - probe.dInput);
+  addStage(STAGE_DISPLAY, probe.dPhoton  - probe.dStep);
+  addStage(STAGE_SURFACE, dSurface);
+  addStage(STAGE_PHOTON,  dPhoton);
+
+  int nSurface = (int)(dSurface / LATENCY_TRACE_BIN_SIZE);
+  int nPhoton  = (int)(dPhoton  / LATENCY_TRACE_BIN_SIZE);
+  histSurface[(nSurface < LATENCY_TRACE_BINS) ? nSurface : LATENCY_TRACE_BINS]++;
+  histPhoton [(nPhoton  < LATENCY_TRACE_BINS) ? nPhoton  : LATENCY_TRACE_BINS]++;
+  nProbes++;
+}
+
+
+void LatencyTrace::printHistogram(std::ostream& out, const char* title, const unsigned long* hist)
+{
+  char          line[200];
+  unsigned long nMax = 1;
+
+  for (int i = 0; i <= LATENCY_TRACE_BINS; i++)
+    if (hist[i] > nMax)
+      nMax = hist[i];
+
+  out << title << ":" << std::endl;
+  for (int i = 0; i <= LATENCY_TRACE_BINS; i++)
+  {
+    if (hist[i] == 0)
+      continue;
+
+    int  nBar = (int)(40 * hist[i] / nMax);
+    char bar[41];
+    memset(bar, '#', nBar);
+    bar[nBar] = 0;
+
+    if (i < LATENCY_TRACE_BINS)
+      snprintf(line, sizeof(line), "  %3.0f-%3.0f ms %6lu %s",
+               1e3*i*LATENCY_TRACE_BIN_SIZE, 1e3*(i+1)*LATENCY_TRACE_BIN_SIZE, hist[i], bar);
+    else
+      snprintf(line, sizeof(line), "  %3.0f+    ms %6lu %s",
+               1e3*i*LATENCY_TRACE_BIN_SIZE, hist[i], bar);
+    out << line << std::endl;
+  }
+}
+
+
+void LatencyTrace::printStats(std::ostream& out)
+{
+  char line[200];
+
+  // the synthetic steps replace the device's aileron, whichever
+  // input method is selected
+  out << "Input latency (";
+  if (dStepPeriod > 0)
+    out << "synthetic steps every " << (int)(1e3*dStepPeriod + 0.5) << " ms";
+  else
+    out << sInputMethod << ", stick movements";
+  out << "): " << nProbes << " steps, " << nDropped << " dropped" << std::endl;
+
+  if (nProbes == 0)
+    return;
+
+  for (int i = 0; i < STAGE_COUNT; i++)
+  {
+    snprintf(line, sizeof(line), "  %-20s avg %7.2f ms  min %7.2f ms  max %7.2f ms",
+             stages[i].name, 1e3*stages[i].dTotal/nProbes,
+             1e3*stages[i].dMin, 1e3*stages[i].dMax);
+    out << line << std::endl;
+  }
+  printHistogram(out, "Sample to control surface", histSurface);
+  printHistogram(out, "Sample to simulation response", histPhoton);
+}
@@ -0,0 +1,151 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+/** \file latency_trace.h
+ *
+ *  Measures the time from a control input to the frame which shows it.
+ */
+
+#ifndef LATENCY_TRACE_H
+#define LATENCY_TRACE_H
+
+#include <iostream>
+#include <string>
+#include "mod_fdm/fdm_inputs.h"
+
+struct SDL_mutex;
+
+/// number of histogram bins
+#define LATENCY_TRACE_BINS     (25)
+
+/// width of a histogram bin in s
+#define LATENCY_TRACE_BIN_SIZE (0.004)
+
+
+/**
+ *  Follows aileron steps from the input device to the screen. A step
+ *  is a probe: its inputs are tagged with the probe's id, and it is
+ *  timed when
+ *  - the input has been sampled
+ *  - the main loop has read it (TXInterface->getInputData(), mixer)
+ *  - the first simulation step has used it
+ *  - the first frame has been swapped which shows the control surface
+ *    (driven by the input events of the frame which read it)
+ *  - the first frame has been swapped which shows the simulation step
+ *
+ *  Only one probe is traced at a time. The steps are either made by
+ *  the trace itself, replacing the aileron input of the device at a
+ *  fixed period (a synthetic transmitter), or they are the stick
+ *  movements of the device. The synthetic steps are put in after
+ *  the device has been read, so they don't depend on the input
+ *  method and aren't labelled with it. For stick movements the time
+ *  of the sample is the time it has been read, the delay of the
+ *  device itself isn't known.
+ *
+ *  input(), display() and frame() are called by the main loop, step()
+ *  by whoever runs the simulation.
+ */
+class LatencyTrace
+{
+  public:
+    /**
+     *  \param sInputMethod  name of the input method, printed by
+     *                       printStats() when tracing stick movements
+     *  \param dStepPeriod   seconds between synthetic steps, 0 to
+     *                       trace stick movements
+     */
+    LatencyTrace(std::string sInputMethod, double dStepPeriod);
+    ~LatencyTrace();
+
+    /// The main loop has read the inputs. Makes the synthetic steps,
+    /// starts probes and tags the inputs.
+    void input(TSimInputs* inputs);
+
+    /// A simulation step has used these inputs.
+    void step(const TSimInputs* inputs);
+
+    /// The main loop has taken the state which is about to be drawn.
+    void display();
+
+    /// The frame has been swapped.
+    void frame();
+
+    /**
+     *  Prints the latencies of all stages and histograms of the
+     *  input-to-photon latencies.
+     */
+    void printStats(std::ostream& out);
+
+    /// Number of probes which have reached the screen
+    unsigned long getProbes() const { return nProbes; };
+
+  private:
+    /// Times of a probe in s, 0 until it gets there
+    typedef struct
+    {
+      unsigned long id;
+      double        dSample;
+      double        dInput;
+      double        dStep;
+      double        dSurface;
+      double        dPhoton;
+    } T_Probe;
+
+    /// Latencies of a stage
+    typedef struct
+    {
+      const char*   name;
+      double        dTotal;
+      double        dMin;
+      double        dMax;
+    } T_Stage;
+
+    enum { STAGE_READ = 0, STAGE_STEP, STAGE_DISPLAY, STAGE_SURFACE, STAGE_PHOTON, STAGE_COUNT };
+
+    void addStage(int nStage, double dLatency);
+    void addProbe();
+    void printHistogram(std::ostream& out, const char* title, const unsigned long* hist);
+
+    // not copyable, the lock belongs to one instance
+    LatencyTrace(const LatencyTrace&);
+    LatencyTrace& operator=(const LatencyTrace&);
+
+    std::string   sInputMethod;
+    double        dStepPeriod;
+    double        dNextStep;     ///< when the next synthetic step is due
+    float         flStep;        ///< aileron of the synthetic transmitter
+    double        dStepTime;     ///< time of the last synthetic step
+    float         flLast;        ///< last aileron which has been read
+    bool          fHaveLast;
+
+    SDL_mutex*    mutex;         ///< step() might be called by another thread
+    unsigned long idLast;
+    T_Probe       probe;         ///< probe.id is 0 if none is traced
+    bool          fShowsSurface; ///< the next frame shows the control surface
+    bool          fShowsStep;    ///< the next frame shows the simulation step
+
+    unsigned long nProbes;
+    unsigned long nDropped;      ///< probes which didn't get to the screen
+    T_Stage       stages[STAGE_COUNT];
+    unsigned long histSurface[LATENCY_TRACE_BINS + 1];
+    unsigned long histPhoton[LATENCY_TRACE_BINS + 1];
+};
+
+#endif
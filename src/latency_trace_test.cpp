@@ -0,0 +1,98 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+/**
+ * \file latency_trace_test.cpp
+ *
+ * Runs a LatencyTrace with synthetic steps through a main loop
+ * without a window, like crrc_main.cpp does it.
+ *
+ * Usage: latency_trace_test [-n frames] [-f frame_ms] [-p step_ms]
+ *
+ * Every frame (default 10 ms) the inputs are read and the simulation
+ * is stepped. In the first run the steps use the inputs of the
+ * current frame, like SimStateHandler::idle(). In the second one they
+ * use the inputs of the frame before, like a simulation thread which
+ * is behind. A synthetic step is made every step_ms (default 60).
+ *
+ * The latencies are printed. The return value is the number of runs
+ * in which not about every synthetic step has reached the screen.
+ */
+#include <SDL.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "latency_trace.h"
+#include "mod_misc/scheduler.h"
+
+
+int main(int argc, char** argv)
+{
+  int nFrames = 200;
+  int nFrame  = 10;
+  int nPeriod = 60;
+  int nErrors = 0;
+
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "-n") == 0 && i+1 < argc)
+      nFrames = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-f") == 0 && i+1 < argc)
+      nFrame = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-p") == 0 && i+1 < argc)
+      nPeriod = atoi(argv[++i]);
+  }
+
+  for (int nDelay = 0; nDelay < 2; nDelay++)
+  {
+    LatencyTrace trace(nDelay ? "test, one frame behind" : "test", nPeriod / 1000.0);
+    TSimInputs   inputs;
+    TSimInputs   last;
+    double       dStart = Scheduler::getSeconds();
+
+    for (int f = 0; f < nFrames; f++)
+    {
+      trace.input(&inputs);
+
+      // the simulation
+      trace.step(nDelay ? &last : &inputs);
+      last = inputs;
+
+      trace.display();
+      SDL_Delay(nFrame);
+      trace.frame();
+    }
+
+    double dTime    = Scheduler::getSeconds() - dStart;
+    long   nMissing = (long)(1e3 * dTime / nPeriod) - (long)trace.getProbes();
+
+    trace.printStats(std::cout);
+
+    // the first step starts the synthetic transmitter, the last one
+    // might not be on the screen yet
+    if (trace.getProbes() == 0 || nMissing > 2 || nMissing < -1)
+    {
+      printf("%li steps missing\n", nMissing);
+      nErrors++;
+    }
+  }
+
+  return nErrors;
+}
@@ -35,6 +35,20 @@ Cntrl_SetUserInput::Cntrl_SetUserInput(SimpleXMLTransfer* cfg)
   for (int n=0; n<NUM_AUX_INPUTS; n++)
     flVal_AUX[n] = cfg->attributeAsDouble("aux" + itoStr(n, ' ', 1), 999);
   
+  value[0] = &flVal_aileron;   name[0] = "aileron";
+  value[1] = &flVal_elevator;  name[1] = "elevator";
+  value[2] = &flVal_rudder;    name[2] = "rudder";
+  value[3] = &flVal_throttle;  name[3] = "throttle";
+  value[4] = &flVal_flap;      name[4] = "flap";
+  value[5] = &flVal_spoiler;   name[5] = "spoiler";
+  value[6] = &flVal_retract;   name[6] = "retract";
+  value[7] = &flVal_pitch;     name[7] = "pitch";
+  for (int n=0; n<NUM_AUX_INPUTS; n++)
+  {
+    value[8+n] = &(flVal_AUX[n]);
+    name[8+n]  = "aux" + itoStr(n, ' ', 1);
+  }
+  
   if (cfg->indexOfAttribute("file") < 0)
   {
     infile = 0;
@@ -44,6 +58,7 @@ Cntrl_SetUserInput::Cntrl_SetUserInput(SimpleXMLTransfer* cfg)
     infile = new SimpleXMLTransfer(cfg->getString("file"));
     idx    = 0;
     dTime  = 0;
+    SetEntries();
   }
 }
 
@@ -53,16 +68,29 @@ Cntrl_SetUserInput::~Cntrl_SetUserInput()
     delete infile;
 }
 
-void Cntrl_SetUserInput::Interp(float*             vptr,
-                                SimpleXMLTransfer* from,
-                                SimpleXMLTransfer* to,
-                                std::string        name,
-                                double             fact)
+void Cntrl_SetUserInput::SetEntries()
 {
-  if (*vptr < 888 && from->indexOfAttribute(name) >= 0)
+  SimpleXMLTransfer* from = infile->getChildAt(idx);
+  SimpleXMLTransfer* to   = infile->getChildAt(idx+1);
+  
+  hTimeFrom = from->getHandle("time");
+  hTimeTo   = to  ->getHandle("time");
+  for (int n=0; n<NUM_VALUES; n++)
   {
-    double v0 = from->getDouble(name);
-    *vptr = v0 + (to->getDouble(name) - v0) * fact;
+    hFrom[n] = from->getHandle(name[n]);
+    hTo[n]   = to  ->getHandle(name[n]);
+  }
+}
+
+void Cntrl_SetUserInput::Interp(float*     vptr,
+                                XMLHandle& from,
+                                XMLHandle& to,
+                                double     fact)
+{
+  if (*vptr < 888 && from.exists())
+  {
+    double v0 = from.getDouble();
+    *vptr = v0 + (to.getDouble() - v0) * fact;
   }
 }
 
@@ -75,12 +103,7 @@ void Cntrl_SetUserInput::Calc(double      dt,
   {
     dTime += dt;
   
-    SimpleXMLTransfer* from;
-    SimpleXMLTransfer* to;
-
-    to = infile->getChildAt(idx+1);
-    
-    if (to->getDouble("time") < dTime)
+    if (hTimeTo.getDouble() < dTime)
     {
       if (infile->getChildCount() <= idx+2)
       {
@@ -90,30 +113,19 @@ void Cntrl_SetUserInput::Calc(double      dt,
       else                  
       {
         idx++;
-        to = infile->getChildAt(idx+1);
+        SetEntries();
       }
     }
      
-    if (infile && to->getDouble("time") > dTime)
+    if (infile && hTimeTo.getDouble() > dTime)
     {
-      from = infile->getChildAt(idx);
-      
-      double time_from = from->getDouble("time");
-      double time_to   = to  ->getDouble("time");
+      double time_from = hTimeFrom.getDouble();
+      double time_to   = hTimeTo.getDouble();
 
       double fact = (dTime-time_from)/(time_to-time_from);
 
-      Interp(&flVal_aileron,  from, to, "aileron",  fact);
-      Interp(&flVal_elevator, from, to, "elevator", fact);
-      Interp(&flVal_rudder,   from, to, "rudder",   fact);
-      Interp(&flVal_throttle, from, to, "throttle", fact);
-      Interp(&flVal_flap,     from, to, "flap",     fact);
-      Interp(&flVal_spoiler,  from, to, "spoiler",  fact);
-      Interp(&flVal_retract,  from, to, "retract",  fact);
-      Interp(&flVal_pitch,    from, to, "pitch",    fact);
-      
-      for (int n=0; n<NUM_AUX_INPUTS; n++)
-        Interp(&(flVal_AUX[n]), from, to, "aux" + itoStr(n, ' ', 1), fact);
+      for (int n=0; n<NUM_VALUES; n++)
+        Interp(value[n], hFrom[n], hTo[n], fact);
     }        
   }
   
@@ -54,7 +54,7 @@ public:
   virtual ~Cntrl_SetUserInput();
   
 private:
-  enum { NUM_AUX_INPUTS = 4};  
+  enum { NUM_AUX_INPUTS = 4, NUM_VALUES = 8 + NUM_AUX_INPUTS };  
   float flVal_AUX[NUM_AUX_INPUTS];
   
   float flVal_aileron; 
@@ -70,11 +70,27 @@ private:
   SimpleXMLTransfer* infile;
   int idx;
   
-  void Interp(float*             vptr,
-              SimpleXMLTransfer* from,
-              SimpleXMLTransfer* to,
-              std::string        name,
-              double             fact);
+  /**
+   * The values which are interpolated, their attribute names and
+   * handles to them in the two entries of infile around dTime.
+   * The handles are made when idx changes, not on every step.
+   */
+  float*      value[NUM_VALUES];
+  std::string name[NUM_VALUES];
+  XMLHandle   hFrom[NUM_VALUES];
+  XMLHandle   hTo[NUM_VALUES];
+  XMLHandle   hTimeFrom;
+  XMLHandle   hTimeTo;
+  
+  /**
+   * Makes the handles for the entries idx and idx+1.
+   */
+  void SetEntries();
+  
+  void Interp(float*     vptr,
+              XMLHandle& from,
+              XMLHandle& to,
+              double     fact);
   
 };
 
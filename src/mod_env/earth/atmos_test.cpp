@@ -0,0 +1,161 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <math.h>
+
+#include "atmos_62.h"
+#include "ls_gravity.h"
+#include "envtable.h"
+
+/**
+ * Same settings as in crrc_fdm.cpp
+ */
+#define MAX_ALT 40000
+#define MAX_ERR 1e-7
+
+/**
+ * Default FDM step (simulation.flightModel.dt)
+ */
+#define FDM_DT  0.002777
+
+/**
+ * Number of altitudes used in the benchmark, the sequence
+ * resembles a slow climb like in a real flight.
+ */
+#define N_ALT   4096
+
+static double alt[N_ALT];
+
+/**
+ * Checks the error bound of table against func on a grid much finer
+ * than the one used by T_EnvTable::init(). Returns the number of errors.
+ */
+static int checkTable(const char* name, const T_EnvTable& table, double (*func)(double),
+                      double xmin, double xmax)
+{
+  double maxerr = 0;
+  int    n      = 200000;
+  
+  for (int i=0; i<=n; i++)
+  {
+    double x   = xmin + (xmax - xmin) * i / n;
+    double ref = func(x);
+    double err = fabs(table.get(x) - ref) / fabs(ref);
+    
+    if (err > maxerr)
+      maxerr = err;
+  }
+  
+  std::cout.width(16);
+  std::cout << name << ": " << table.size() << " points, step " << table.getStep()
+            << " ft, max. rel. error " << maxerr << "\n";
+  
+  if (maxerr > MAX_ERR)
+  {
+    std::cout << "FAILED: error bound of " << MAX_ERR << " exceeded\n";
+    return(1);
+  }
+  return(0);
+}
+
+static double timeFunc(double (*func)(double), int nLoops)
+{
+  double  sum   = 0;
+  clock_t start = clock();
+  
+  for (int l=0; l<nLoops; l++)
+    for (int i=0; i<N_ALT; i++)
+      sum += func(alt[i]);
+  
+  double ns = 1e9 * (clock() - start) / (double)CLOCKS_PER_SEC / ((double)nLoops * N_ALT);
+  
+  // keep sum alive
+  if (sum == 42)
+    std::cout << " ";
+  return(ns);
+}
+
+static const T_EnvTable* pTable;
+
+static double tableFunc(double x)
+{
+  return(pTable->get(x));
+}
+
+static double timeTable(const T_EnvTable& table, int nLoops)
+{
+  pTable = &table;
+  return(timeFunc(tableFunc, nLoops));
+}
+
+/**
+ * Checks the tables used by CRRC_FDM_Env against the analytic models
+ * and measures the time needed per FDM step.
+ * 
+ * -n <loops> number of benchmark loops (0: no benchmark)
+ */
+int main(int argc, char** argv)
+{
+  int nLoops = 2000;
+  int nErrors = 0;
+  
+  for (int i=1; i<argc; i++)
+  {
+    if (strcmp(argv[i], "-n") == 0 && i+1 < argc)
+      nLoops = atoi(argv[++i]);
+  }
+  
+  T_EnvTable rho;
+  T_EnvTable g;
+  
+  rho.init(ls_atmos_rho, 0, MAX_ALT, 500, MAX_ERR);
+  g.init(ls_gravity_g, -MAX_ALT, MAX_ALT, 2000, MAX_ERR);
+  
+  nErrors += checkTable("density", rho, ls_atmos_rho, 0, MAX_ALT);
+  nErrors += checkTable("gravity", g, ls_gravity_g, -MAX_ALT, MAX_ALT);
+  
+  if (nLoops > 0)
+  {
+    for (int i=0; i<N_ALT; i++)
+      alt[i] = 500 + 0.5*i;
+    
+    double t_rho_a = timeFunc(ls_atmos_rho, nLoops);
+    double t_rho_t = timeTable(rho, nLoops);
+    double t_g_a   = timeFunc(ls_gravity_g, nLoops);
+    double t_g_t   = timeTable(g, nLoops);
+    
+    std::cout << "density:  " << t_rho_a << " ns analytic, " << t_rho_t << " ns table\n";
+    std::cout << "gravity:  " << t_g_a   << " ns analytic, " << t_g_t   << " ns table\n";
+    
+    // EOM01 (fdm_larcsim, heli01, mcopter01) calls GetG and GetRho
+    // in every step, fdm_002 calls GetRho.
+    double steps = 1/FDM_DT;
+    std::cout << "per simulated second at dt=" << FDM_DT << " (" << steps << " steps):\n";
+    std::cout << "  fdm_larcsim: " << steps*(t_rho_a + t_g_a)*1e-3 << " us -> "
+              << steps*(t_rho_t + t_g_t)*1e-3 << " us\n";
+    std::cout << "  fdm_002:     " << steps*t_rho_a*1e-3 << " us -> "
+              << steps*t_rho_t*1e-3 << " us\n";
+  }
+  
+  return(nErrors);
+}
@@ -0,0 +1,107 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include "envtable.h"
+
+#include <math.h>
+
+/**
+ * Upper limit for the number of grid points. If the error bound
+ * can't be reached with this, the function is not smooth enough.
+ */
+#define ENVTABLE_MAX_SIZE 65536
+
+/**
+ * Number of points per interval at which the table is checked.
+ */
+#define ENVTABLE_CHECK_POINTS 8
+
+T_EnvTable::T_EnvTable()
+  : fnc(0), dXMin(0), dXMax(-1), dStep(1), dInvStep(1),
+    nIntervals(0), dMaxRelErr(0)
+{
+}
+
+bool T_EnvTable::init(double (*func)(double), double xmin, double xmax,
+                      double step, double max_rel_err)
+{
+  fnc   = func;
+  dXMin = xmin;
+  dXMax = xmax;
+  dStep = step;
+  
+  while (true)
+  {
+    nIntervals = (int)ceil((dXMax - dXMin) / dStep);
+    if (nIntervals < 2)
+      nIntervals = 2;
+    dStep    = (dXMax - dXMin) / nIntervals;
+    dInvStep = 1/dStep;
+    
+    fill();
+    dMaxRelErr = check();
+    
+    if (dMaxRelErr <= max_rel_err)
+      return(true);
+    
+    if (2*nIntervals+1 > ENVTABLE_MAX_SIZE)
+    {
+      // give up, make sure the table isn't used
+      dXMax = dXMin - 1;
+      return(false);
+    }
+    
+    dStep *= 0.5;
+  }
+}
+
+void T_EnvTable::fill()
+{
+  y.resize(nIntervals+3);
+  
+  for (int i=0; i<=nIntervals; i++)
+    y[i+1] = fnc(dXMin + i*dStep);
+  
+  y[0]            = 3*y[1]          - 3*y[2]            + y[3];
+  y[nIntervals+2] = 3*y[nIntervals+1] - 3*y[nIntervals] + y[nIntervals-1];
+}
+
+double T_EnvTable::check() const
+{
+  double maxerr = 0;
+  
+  for (int i=0; i<nIntervals; i++)
+  {
+    for (int n=1; n<ENVTABLE_CHECK_POINTS; n++)
+    {
+      double x   = dXMin + (i + n/(double)ENVTABLE_CHECK_POINTS)*dStep;
+      double ref = fnc(x);
+      double err = fabs(interpolate(x) - ref);
+      
+      if (ref != 0)
+        err /= fabs(ref);
+      
+      if (err > maxerr)
+        maxerr = err;
+    }
+  }
+  
+  return(maxerr);
+}
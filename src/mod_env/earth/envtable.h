@@ -0,0 +1,129 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef ENVTABLE_H
+#define ENVTABLE_H
+
+#include <vector>
+
+/**
+ * A function of one variable (altitude), sampled on an equidistant
+ * grid and interpolated by cubic Hermite splines whose slopes are
+ * central differences (Catmull-Rom). At both ends of the table the
+ * missing neighbour is extrapolated quadratically.
+ * 
+ * init() samples the function and afterwards compares the table to
+ * the function between all grid points. If the relative error is
+ * above the limit, the step size is halved and everything is done
+ * again. So after init() the table is known to be within the given
+ * error bound of the function it replaces.
+ * 
+ * The function is expected to be smooth within the range. Kinks are
+ * only handled correctly if they are at the ends of the table.
+ */
+class T_EnvTable
+{
+  public:
+   
+   T_EnvTable();
+   
+   /**
+    * @param func         function to tabulate
+    * @param xmin         lower end of range
+    * @param xmax         upper end of range
+    * @param step         initial step size
+    * @param max_rel_err  maximum relative error of the interpolation
+    * @return true if the error bound could be reached
+    */
+   bool init(double (*func)(double), double xmin, double xmax,
+             double step, double max_rel_err);
+   
+   /**
+    * Is x within the table?
+    */
+   bool inRange(double x) const
+   {
+     return(x >= dXMin && x <= dXMax);
+   };
+   
+   /**
+    * Interpolated value at x. x has to be inRange(), see get().
+    */
+   double interpolate(double x) const
+   {
+     double t   = (x - dXMin) * dInvStep;
+     int    i   = (int)t;
+     
+     if (i >= nIntervals)
+       i = nIntervals-1;
+     t -= i;
+     
+     // y[0] is the extrapolated value left of the table
+     const double* p = &y[i];
+     double a = p[2] - p[0];           // 2 * h * slope at left node
+     double b = p[3] - p[1];           // 2 * h * slope at right node
+     double d = p[2] - p[1];
+     
+     return(p[1] + t*(0.5*a + t*(3*d - a - 0.5*b + t*(0.5*(a + b) - 2*d))));
+   };
+   
+   /**
+    * Value at x, uses the original function outside of the table.
+    */
+   double get(double x) const
+   {
+     if (inRange(x))
+       return(interpolate(x));
+     else
+       return(fnc(x));
+   };
+   
+   /**
+    * Maximum relative error found when checking the table.
+    */
+   double getMaxRelError() const { return(dMaxRelErr); };
+   
+   /**
+    * Number of grid points.
+    */
+   int    size() const { return(nIntervals+1); };
+   
+   double getStep() const { return(dStep); };
+
+  private:
+   
+   void   fill();
+   double check() const;
+   
+   double (*fnc)(double);
+   double dXMin;
+   double dXMax;
+   double dStep;
+   double dInvStep;
+   int    nIntervals;
+   double dMaxRelErr;
+   
+   /**
+    * nIntervals+3 values: extrapolated value, grid points, extrapolated value
+    */
+   std::vector<double> y;
+};
+
+#endif
@@ -102,6 +102,7 @@ void CRRC_AirplaneSim_002::initAirplaneState(double dRelVel,
                  CRRCMath::Matrix33( I_xx,    0,    -I_xz,
                                      0,       I_yy,  0,
                                     -I_xz,    0,     I_zz));
+  eom.setIntegrationMethod(eomMethod, eomTolerance);
 
 #if (EOM_TEST != 0)
   eom.setGravity(0);
@@ -121,6 +122,8 @@ void CRRC_AirplaneSim_002::initAirplaneState(double dRelVel,
   aero_init();
   
   power->InitStates(CRRCMath::Vector3()); // todo
+
+  wheelsys.resetTerrainCache();
 }
 
 
@@ -197,6 +200,16 @@ void CRRC_AirplaneSim_002::update(TSimInputs* inputs,
     break;
   }
 #endif
+
+  // With a Runge-Kutta method the model may use larger steps than the
+  // simulation does.
+  if (eomMethod != CRRCMath::INTGR_AB2 && eomStep > dt && multiloop > 0)
+  {
+    double dTotal = multiloop*dt;
+    
+    multiloop = (int)ceil(dTotal/eomStep - 1e-6);
+    dt        = dTotal/multiloop;
+  }
   
   for (int n=0; n<multiloop; n++)
   {        
@@ -215,8 +228,14 @@ void CRRC_AirplaneSim_002::update(TSimInputs* inputs,
     
     env->ControllerCallback(dt, this, inputs, &myInputs);
     
+    // A Runge-Kutta method evaluates aero() and gear() through calcForces()
+    // for each of its stages, so they are needed up front with AB2 only.
+    // The engine still needs the airspeed at the start of the step.
 #if (EOM_TEST != 2)
-    aero( dt, &myInputs);
+    if (eomMethod == CRRCMath::INTGR_AB2)
+      aero( dt, &myInputs);
+    else
+      v_V_body = eom.vel.val - eom.conv.body(v_V_local_airmass);
 #endif
 
 #if FDM_LOG_AERO_OUT != 0
@@ -236,7 +255,8 @@ void CRRC_AirplaneSim_002::update(TSimInputs* inputs,
       v_F_engine *= N_TO_LBF;
       v_M_engine *= NM_TO_LBFFT;
     }
-    gear(&myInputs);
+    if (eomMethod == CRRCMath::INTGR_AB2)
+      gear(&myInputs);
 
 #if (EOM_TEST == 2)
     CRRCMath::Vector3 v_F, v_M_cg;
@@ -296,9 +316,12 @@ void CRRC_AirplaneSim_002::update(TSimInputs* inputs,
     eom.step(dt, v_F, v_M_cg);
     eom.conv.updateEuler();
 #else
-    eom.step(dt, 
-             v_F_aero + v_F_engine + v_F_gear,
-             v_M_aero + v_M_engine + v_M_gear);
+    if (eomMethod == CRRCMath::INTGR_AB2)
+      eom.step(dt, 
+               v_F_aero + v_F_engine + v_F_gear,
+               v_M_aero + v_M_engine + v_M_gear);
+    else
+      eom.step(dt, this);
     
     // Update the position they are interested in outside of this fdm. I have to
     // do it inside of the loop because gear() also needs it.
@@ -306,6 +329,8 @@ void CRRC_AirplaneSim_002::update(TSimInputs* inputs,
 #endif
     
 //    eom.conv.convTest1();
+
+    env->StepCallback(dt, this, inputs);
   }
      
   /*
@@ -410,6 +435,23 @@ void CRRC_AirplaneSim_002::LoadFromXML(SimpleXMLTransfer* xml)
   SimpleXMLTransfer* i;
   SimpleXMLTransfer* cfg = XMLModelFile::getConfig(xml);
   
+  // Integration method, optional:
+  //   <integration method="rk45" tolerance="1e-6" dt="0.01" />
+  eomMethod    = CRRCMath::INTGR_AB2;
+  eomTolerance = 1e-6;
+  eomStep      = 0;
+  if (xml->indexOfChild("integration") >= 0)
+  {
+    i = xml->getChild("integration");
+    eomMethod    = CRRCMath::IntegrationMethodFromString(i->getString("method", "ab2"));
+    eomTolerance = i->getDouble("tolerance", 1e-6);
+    eomStep      = i->getDouble("dt", 0);
+    std::cout << "Integration method " << CRRCMath::IntegrationMethodToString(eomMethod);
+    if (eomStep > 0)
+      std::cout << ", dt=" << eomStep;
+    std::cout << "\n";
+  }
+  
   {
     double to_ft;
     
@@ -613,6 +655,21 @@ CRRCMath::Vector3 CRRC_AirplaneSim_002::getPos()
  *
  *  \param inputs   Current control inputs
  */
+void CRRC_AirplaneSim_002::calcForces(double             dt,
+                                      CRRCMath::Vector3& FBody,
+                                      CRRCMath::Vector3& MBody)
+{
+  // gear() needs psi
+  eom.conv.updateEuler();
+  
+  aero(dt, &myInputs);
+  gear(&myInputs);
+  
+  FBody = v_F_aero + v_F_engine + v_F_gear;
+  MBody = v_M_aero + v_M_engine + v_M_gear;
+}
+
+
 void CRRC_AirplaneSim_002::gear(TSimInputs* inputs)      
 {
   wheelsys.update(inputs,
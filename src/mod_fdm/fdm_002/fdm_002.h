@@ -41,7 +41,7 @@
  * We don't need more for usual model airplane use.
  *
  */  
-class CRRC_AirplaneSim_002 : public FDMBase
+class CRRC_AirplaneSim_002 : public FDMBase, public EOM_6DOF_Forces
 {
    friend class ModFDMInterface;
   public:
@@ -128,10 +128,35 @@ class CRRC_AirplaneSim_002 : public FDMBase
    
    virtual ~CRRC_AirplaneSim_002();
 
+   /**
+    * Forces and moments for the Runge-Kutta methods in EOM_6DOF. Aerodynamics
+    * and gear are evaluated for the current state of eom, the engine's forces
+    * are those of the start of the step.
+    */
+   virtual void calcForces(double             dt,
+                           CRRCMath::Vector3& FBody,
+                           CRRCMath::Vector3& MBody);
+
   private:
    
    EOM_6DOF   eom;
 
+   /// @name Integration of the equations of motion, read from file
+   //@{
+   CRRCMath::IntegrationMethod eomMethod;
+   
+   /**
+    * Allowed local error per step for INTGR_RK45
+    */
+   double eomTolerance;
+   
+   /**
+    * Step size to be used instead of the simulation's dt [s] (only
+    * for the Runge-Kutta methods, 0 means 'use dt')
+    */
+   double eomStep;
+   //@}
+
    /// @name Aerodynamic data
    //@{
    SCALAR  C_ref;    //  reference chord (ft)
@@ -23,6 +23,70 @@
 class FDMBase;
 class TSimInputs;
 
+/**
+ * A part of the terrain in which the height is described by a single
+ * plane: a triangle, clipped to a rectangle. It is handed out by
+ * FDMEnviroment::GetSceneryPatch() and can be used to get the height
+ * at nearby points without asking the scenery again.
+ *
+ * Coordinates are x (positive north) and y (positive east), like
+ * in FDMEnviroment::GetSceneryHeight().
+ */
+class TerrainPatch
+{
+public:
+  TerrainPatch() : fValid(false) {};
+
+  /**
+   * Returns true if the patch is valid and (x_north|y_east) is inside
+   * of the triangle and the rectangle. Points on the border are
+   * considered to be outside.
+   */
+  bool contains(float x_north, float y_east) const
+  {
+    if (!fValid ||
+        x_north <= rect[0] || x_north >= rect[1] ||
+        y_east  <= rect[2] || y_east  >= rect[3])
+      return(false);
+
+    float d1 = (tri[1][0]-tri[0][0])*(y_east-tri[0][1]) - (x_north-tri[0][0])*(tri[1][1]-tri[0][1]);
+    float d2 = (tri[2][0]-tri[1][0])*(y_east-tri[1][1]) - (x_north-tri[1][0])*(tri[2][1]-tri[1][1]);
+    float d3 = (tri[0][0]-tri[2][0])*(y_east-tri[2][1]) - (x_north-tri[2][0])*(tri[0][1]-tri[2][1]);
+
+    return((d1 > 0 && d2 > 0 && d3 > 0) || (d1 < 0 && d2 < 0 && d3 < 0));
+  };
+
+  /**
+   * Terrain height [ft] at (x_north|y_east), calculated from the plane.
+   * This is exactly what the scenery would return for a point inside of
+   * the patch.
+   */
+  float getHeight(float x_north, float y_east) const
+  {
+    return(-(-plane[2]*x_north + plane[0]*y_east + plane[3]) / plane[1]);
+  };
+
+  /**
+   * Set to false to invalidate the patch.
+   */
+  bool  fValid;
+
+  /**
+   * Plane equation in scenery coordinates (x east, y up, z south).
+   */
+  float plane[4];
+
+  /**
+   * Corners of the triangle, tri[n][0] is north, tri[n][1] is east [ft]
+   */
+  float tri[3][2];
+
+  /**
+   * Rectangle: north min, north max, east min, east max [ft]
+   */
+  float rect[4];
+};
+
 /**
  * This is the interface used by the (various) FDMs to get information from the outside:
  *   - scenery for collision detection
@@ -54,6 +118,28 @@ public:
    *  \return terrain height at this point in ft
    */
   virtual float GetSceneryHeight(float x_north, float y_east) = 0;
+
+  /**
+   *  Get the height at a distinct point and the part of the terrain
+   *  around it which has the same plane. Use this for points which
+   *  are queried again and again while moving slowly, like a wheel
+   *  rolling on the ground: as long as the next point is inside the
+   *  patch, TerrainPatch::getHeight() gives the same result as asking
+   *  the scenery.
+   *
+   *  The default implementation only calls GetSceneryHeight() and
+   *  invalidates the patch.
+   *
+   *  \param x_north x coordinate (positive north)
+   *  \param y_east  y coordinate (positive east)
+   *  \param patch   the patch will be stored here
+   *  \return terrain height at this point in ft
+   */
+  virtual float GetSceneryPatch(float x_north, float y_east, TerrainPatch& patch)
+  {
+    patch.fValid = false;
+    return(GetSceneryHeight(x_north, y_east));
+  };
   
   /**
    * Calculate the wind velocities in all three axes in the given position.
@@ -81,6 +167,14 @@ public:
    */
   virtual void ControllerCallback(double dt, FDMBase* fdm, TSimInputs* pInputsFromUser, TSimInputs* pInputsToFDM) = 0;
   
+  /**
+   * Called at the end of every step inside of FDMBase::update(), so the
+   * state can be looked at on every step even if update() makes many of
+   * them. dt is the length of this step: an FDM may merge steps, so it
+   * can be longer than the dt passed to update().
+   */
+  virtual void StepCallback(double dt, FDMBase* fdm, TSimInputs* pInputsFromUser) {};
+  
   /**
    * Add a message to some kind of log file or message list visible to 
    * the user -- actual behaviour depends on application.
@@ -37,6 +37,11 @@
 #define PITCH_FIXED_PITCH          1.0
 #define THROTTLE_COLLECTIVE_PITCH  1.0
 
+/**
+ * Instances made so far, tells their disturbances apart
+ */
+static uint64_t nInstances = 0;
+
 /**
  * *****************************************************************************
  */
@@ -82,7 +87,12 @@ void CRRC_AirplaneSim_Heli01::initAirplaneState(double dRelVel,
   
   power->InitStates(CRRCMath::Vector3());
   
+  // the disturbances start again, see InitStates()
+  InitStates();
+  
   ls_step_init();
+
+  wheels.resetTerrainCache();
 }
 
 
@@ -129,6 +139,8 @@ void CRRC_AirplaneSim_Heli01::update(TSimInputs* inputs,
         
     ls_accel(v_F_aero + v_F_engine + v_F_gear, v_M_aero + v_M_engine + v_M_gear,
              myInputs.heli_fixed_z, fFixedHorizon);
+
+    env->StepCallback(dt, this, inputs);
   }
 }
 
@@ -140,6 +152,8 @@ CRRC_AirplaneSim_Heli01::CRRC_AirplaneSim_Heli01(const char* filename, FDMEnviro
   SimpleXMLTransfer* fileinmemory = new SimpleXMLTransfer(filename);
   
   power = 0;
+  uInstance = ++nInstances;
+  uLaunch   = 0;
   LoadFromXML(fileinmemory, cfg->getInt("airplane.verbosity", 5));
   InitStates();
   
@@ -150,6 +164,8 @@ CRRC_AirplaneSim_Heli01::CRRC_AirplaneSim_Heli01(const char* filename, FDMEnviro
 CRRC_AirplaneSim_Heli01::CRRC_AirplaneSim_Heli01(SimpleXMLTransfer* xml, FDMEnviroment* myEnv, SimpleXMLTransfer* cfg) : EOM01("fdm_heli01.dat", myEnv)
 {
   power = 0;
+  uInstance = ++nInstances;
+  uLaunch   = 0;
   LoadFromXML(xml, cfg->getInt("airplane.verbosity", 5));
   InitStates();
 }
@@ -426,6 +442,17 @@ void CRRC_AirplaneSim_Heli01::InitStates()
   filt_rnd_roll.init(0);
   filt_rnd_pitch.init(0);
   dist_t = 0;
+  
+  // A recorded flight has to get the same disturbances when it is
+  // replayed by a new instance, so in deterministic mode the streams
+  // start again with every launch. Otherwise every instance and every
+  // launch gets disturbances of its own.
+  uint64_t nStream = 0;
+  if (!CRRC_Random::isDeterministic())
+    nStream = (uInstance << 32) + (++uLaunch);
+  rnd_yaw.seed("heli01.yaw", nStream);
+  rnd_roll.seed("heli01.roll", nStream);
+  rnd_pitch.seed("heli01.pitch", nStream);
 }
 
 CRRC_AirplaneSim_Heli01::~CRRC_AirplaneSim_Heli01()
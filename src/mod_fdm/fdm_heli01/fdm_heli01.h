@@ -210,6 +210,8 @@ class CRRC_AirplaneSim_Heli01 : public EOM01
   double in_rnd_pitch;
   double dist_t;
   double dist_t_init;
+  uint64_t uInstance;        ///< number of this instance, see InitStates()
+  uint64_t uLaunch;          ///< launches so far, see InitStates()
   
   double dHeadingHold;
   double dHeadingHoldInt;
@@ -58,6 +58,18 @@ class TSimInputs
    * Any value < EOM01_FIXED_Z_OFF causes helicopters to stay fixed at that z-coordinate [feet].
    */
   float heli_fixed_z;
+
+  /**
+   * When these values have been read from the input device, in seconds
+   * (Scheduler::getSeconds()). 0 if unknown.
+   */
+  double sample_time;
+
+  /**
+   * Latency trace probe these values belong to, 0 if none. See
+   * LatencyTrace.
+   */
+  unsigned long trace_id;
     
   /**
    * 
@@ -78,6 +90,9 @@ class TSimInputs
     
     this->heli_fixed_z = source->heli_fixed_z;
     
+    this->sample_time  = source->sample_time;
+    this->trace_id     = source->trace_id;
+    
     this->keys = source->keys;
   };
   
@@ -109,30 +124,6 @@ class TSimInputs
      }
    }
   
-   /**
-    * maybe this does help to get some kind of random number
-    */
-   int getRandNum() const
-   {
-     int tmp = 0;
-
-     // Just mix values in some way.
-     // In this case multiplying surely leads to the result being zero.
-     // What to do?
-     // Add?
-     // XOR?
-     tmp = floatToInt(aileron);
-     tmp ^= floatToInt(rudder);
-     tmp ^= floatToInt(elevator);
-     tmp ^= floatToInt(throttle);
-     tmp ^= floatToInt(flap);
-     tmp ^= floatToInt(spoiler);
-     tmp ^= floatToInt(retract);
-     tmp ^= floatToInt(pitch);
-     
-     return(tmp);
-   }
-
    TSimInputs()
    {
      int i;
@@ -148,6 +139,9 @@ class TSimInputs
        aux[i] = 0;
      
      heli_fixed_z = EOM01_FIXED_Z_OFF;
+     
+     sample_time  = 0;
+     trace_id     = 0;
    };
    
    void print()
@@ -192,6 +186,14 @@ class TSimInputs
     }
   }
   
+  /**
+   * Keypresses which have not been consumed yet.
+   */
+  const std::set<int>& GetKeys() const
+  {
+    return(keys);
+  }
+  
 private:
   
   /**
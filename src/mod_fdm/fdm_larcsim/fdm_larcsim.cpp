@@ -92,6 +92,8 @@ void CRRC_AirplaneSim_Larcsim::initAirplaneState(double dRelVel,
   ls_step_init();
   
   power->InitStates(v_V_wind_body * FT_TO_M);  
+
+  wheels.resetTerrainCache();
 }
 
 
@@ -193,6 +195,8 @@ void CRRC_AirplaneSim_Larcsim::update(TSimInputs* inputs,
 
     /* Sum forces and moments at reference point (center of gravity) */
     ls_accel(v_F_aero + v_F_engine + v_F_gear, v_M_aero + v_M_engine*effectivePropellerTorqueFactor + v_M_gear);
+
+    env->StepCallback(dt, this, inputs);
   }
 }
 
@@ -222,6 +226,15 @@ void CRRC_AirplaneSim_Larcsim::LoadFromXML(SimpleXMLTransfer* xml, int nVerbosit
   SimpleXMLTransfer* cfg = XMLModelFile::getConfig(xml);
   SimpleXMLTransfer* aero;
   
+  // The equations of motion in EOM01 are integrated with Adams-Bashforth
+  // only. Models asking for another method are left to CRRC_AirplaneSim_002,
+  // which reads the same aero description.
+  if (xml->indexOfChild("integration") >= 0 &&
+      xml->getString("integration.method", "ab2").compare("ab2") != 0)
+  {
+    throw XMLException("integration method " + xml->getString("integration.method") + " not supported");
+  }
+  
   // File format extension: an aero section inside of config takes
   // precedence over the general aero section.
   {
@@ -37,6 +37,12 @@
 #define PITCH_FIXED_PITCH          1.0
 
 
+/**
+ * Instances made so far, tells their disturbances apart
+ */
+static uint64_t nInstances = 0;
+
+
 Propdata::Propdata(SimpleXMLTransfer* cfg)
 {
   x = cfg->getDouble("x");
@@ -84,10 +90,12 @@ void CRRC_AirplaneSim_MCopter01::initAirplaneState(double dRelVel,
   for (unsigned int n=0; n<controllers.size(); n++)
     controllers[n]->Reset();
   
-  for (unsigned int n=0; n<power.size(); n++)
-    power[n]->InitStates(CRRCMath::Vector3());
+  // power system and disturbances, see InitStates()
+  InitStates();
   
   ls_step_init();
+
+  wheels.resetTerrainCache();
 }
 
 
@@ -138,6 +146,8 @@ void CRRC_AirplaneSim_MCopter01::update(TSimInputs* inputs,
     gear(&myInputs, v_F_gear, v_M_gear);
         
     ls_accel(v_F_aero + v_F_engine + v_F_gear, v_M_aero + v_M_engine + v_M_gear);        
+
+    env->StepCallback(dt, this, inputs);
   }
 }
 
@@ -149,6 +159,9 @@ CRRC_AirplaneSim_MCopter01::CRRC_AirplaneSim_MCopter01(const char* filename, FDM
   SimpleXMLTransfer* fileinmemory = new SimpleXMLTransfer(filename);
 
   power.clear();
+  batch = (Power::RotorBatch*)0;
+  uInstance = ++nInstances;
+  uLaunch   = 0;
   LoadFromXML(fileinmemory, cfg->getInt("airplane.verbosity", 5));
   InitStates();
   
@@ -159,6 +172,9 @@ CRRC_AirplaneSim_MCopter01::CRRC_AirplaneSim_MCopter01(const char* filename, FDM
 CRRC_AirplaneSim_MCopter01::CRRC_AirplaneSim_MCopter01(SimpleXMLTransfer* xml, FDMEnviroment* myEnv, SimpleXMLTransfer* cfg) : EOM01("fdm_mcopter01.dat", myEnv)
 {
   power.clear();
+  batch = (Power::RotorBatch*)0;
+  uInstance = ++nInstances;
+  uLaunch   = 0;
   LoadFromXML(xml, cfg->getInt("airplane.verbosity", 5));
   InitStates();
 }
@@ -240,17 +256,35 @@ void CRRC_AirplaneSim_MCopter01::LoadFromXML(SimpleXMLTransfer* xml, int nVerbos
   for (int n=0; n<i->getChildCount(); n++)
     props.push_back(Propdata(i->getChildAt(n)));
 
-  if (power.size() == 0)
-  {    
-    for (unsigned int n=0; n<props.size(); n++)
-      power.push_back(new Power::Power(cfg, nVerbosity));
+  if (power.size() == 0 && batch == (Power::RotorBatch*)0)
+  {
+    // All rotors use the same power system. If possible, they are
+    // evaluated at once, otherwise every rotor gets a Power of its own.
+    Power::Power* proto = new Power::Power(cfg, nVerbosity);
+    
+    if (Power::RotorBatch::isSuitable(proto))
+    {
+      bool fShared = (cfg->getInt("power.battery.shared", 0) != 0);
+      batch = new Power::RotorBatch(proto, props.size(), fShared);
+    }
+    else
+    {
+      if (cfg->getInt("power.battery.shared", 0) != 0)
+        throw std::runtime_error("mcopter01: power.battery.shared needs one battery, shaft, engine and propeller");
+      power.push_back(proto);
+      for (unsigned int n=1; n<props.size(); n++)
+        power.push_back(new Power::Power(cfg, nVerbosity));
+    }
     dURef = 0.7 * cfg->getDouble("power.battery.U_0");
   }
   else
   {
+    if (batch)
+      batch->ReloadParams(cfg, nVerbosity);
     for (unsigned int n=0; n<power.size(); n++)
       power[n]->ReloadParams(cfg, nVerbosity);
   }
+  rotor_throttle.resize(props.size());
   
   controllers.clear();  
   Controller::LoadList(cfg->getChild("controllers"), controllers);  
@@ -258,16 +292,30 @@ void CRRC_AirplaneSim_MCopter01::LoadFromXML(SimpleXMLTransfer* xml, int nVerbos
 
 void CRRC_AirplaneSim_MCopter01::InitStates()
 {
+  if (batch)
+    batch->InitStates(CRRCMath::Vector3());
   for (unsigned int n=0; n<power.size(); n++)
     power[n]->InitStates(CRRCMath::Vector3());
   filt_rnd_yaw.init(0);
   filt_rnd_roll.init(0);
   filt_rnd_pitch.init(0);
   dist_t = 0;
+  
+  // A recorded flight has to get the same disturbances when it is
+  // replayed by a new instance, so in deterministic mode the streams
+  // start again with every launch. Otherwise every instance and every
+  // launch gets disturbances of its own.
+  uint64_t nStream = 0;
+  if (!CRRC_Random::isDeterministic())
+    nStream = (uInstance << 32) + (++uLaunch);
+  rnd_yaw.seed("mcopter01.yaw", nStream);
+  rnd_roll.seed("mcopter01.roll", nStream);
+  rnd_pitch.seed("mcopter01.pitch", nStream);
 }
 
 CRRC_AirplaneSim_MCopter01::~CRRC_AirplaneSim_MCopter01()
 {
+ delete batch;
  for (unsigned int n=0; n<power.size(); n++)
     delete power[n];
 }
@@ -325,7 +373,12 @@ void CRRC_AirplaneSim_MCopter01::engine(SCALAR             dt,
   inputs->pitch = PITCH_FIXED_PITCH;
   double thr_in = inputs->throttle;
   
-  for (unsigned int n=0; n<power.size(); n++)
+  CRRCMath::Vector3 VRelAir = CRRCMath::Vector3(-v_V_wind_body.r[2],
+                                                v_V_wind_body.r[1],
+                                                v_V_wind_body.r[0]
+                                                )*FT_TO_M;
+  
+  for (unsigned int n=0; n<props.size(); n++)
   {
     double x = props[n].x;
     double y = props[n].y;
@@ -342,27 +395,40 @@ void CRRC_AirplaneSim_MCopter01::engine(SCALAR             dt,
       thr = 0;
     
     // Try to behave independent of battery voltage:
-    inputs->throttle = thr * dURef/power[n]->GetVoltageAvg();
+    if (batch)
+      rotor_throttle[n] = thr * dURef/batch->GetVoltageAvg(n);
+    else
+      rotor_throttle[n] = thr * dURef/power[n]->GetVoltageAvg();
     
     // Die Reglerverstärkung ist:
     //   UDiff = omega_diff * kp * dURef
     // Der Integrator gibt nach der Zeit t mit der Regelabweichung omega die Spannung
     //   UDiff = t * omega * ki * dURef
     // aus.
-    
-    F = CRRCMath::Vector3();
-    M = CRRCMath::Vector3();
-    power[n]->step(dt, inputs, 
-                   CRRCMath::Vector3(-v_V_wind_body.r[2],
-                                     v_V_wind_body.r[1],
-                                     v_V_wind_body.r[0]
-                                     )*FT_TO_M,
-                   &F, &M);
+  }
+  
+  if (batch)
+    batch->step(dt, &rotor_throttle[0], inputs->pitch, VRelAir);
+  
+  for (unsigned int n=0; n<props.size(); n++)
+  {
+    if (batch)
+    {
+      F = batch->getForce(n);
+      M = batch->getMoment(n);
+    }
+    else
+    {
+      inputs->throttle = rotor_throttle[n];
+      F = CRRCMath::Vector3();
+      M = CRRCMath::Vector3();
+      power[n]->step(dt, inputs, VRelAir, &F, &M);
+    }
     
     v_F += CRRCMath::Vector3(0, 0, -F.r[0]);    
-    v_M += CRRCMath::Vector3(y*F.r[0], x*F.r[0], M.r[0] * props[n].mul_r);
+    v_M += CRRCMath::Vector3(props[n].y*F.r[0], props[n].x*F.r[0], M.r[0] * props[n].mul_r);
     
-    //std::cout << inputs->throttle << " " << power[n]->getPropFreq() << " ";
+    //std::cout << rotor_throttle[n] << " " << getPropFreq() << " ";
   }
   //std::cout << "\n";
     
@@ -442,6 +508,15 @@ void CRRC_AirplaneSim_MCopter01::ls_step_init()
 
 double CRRC_AirplaneSim_MCopter01::getPropFreq() 
 {
+  if (batch)
+  {
+    double max = batch->getPropFreq(0);
+    for (unsigned int n=1; n<batch->size(); n++)
+      if (max < batch->getPropFreq(n))
+        max = batch->getPropFreq(n);
+    return(max);
+  }
+  
   double max = power[0]->getPropFreq();
   for (unsigned int n=1; n<power.size(); n++)
     if (max < power[n]->getPropFreq())
@@ -449,6 +524,13 @@ double CRRC_AirplaneSim_MCopter01::getPropFreq()
   return(max);
 }
 
+double CRRC_AirplaneSim_MCopter01::getBatCapLeft()
+{
+  if (batch)
+    return(batch->getBatteryMin());
+  return(power[0]->getBatteryMin());
+}
+
 int CRRC_AirplaneSim_MCopter01::ReloadParams(SimpleXMLTransfer* xml,
                                           SimpleXMLTransfer* cfg)
 {
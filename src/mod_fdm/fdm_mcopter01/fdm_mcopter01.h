@@ -30,6 +30,7 @@
 # include "../../mod_math/vector3.h"
 # include "../../mod_math/matrix33.h"
 # include "../power/power.h"
+# include "../power/rotorbatch.h"
 # include "../../mod_misc/crrc_rand.h"
 # include "../gear01/gear.h"
 # include "../../mod_cntrl/controller.h"
@@ -74,7 +75,7 @@ public:
   /**
    * Returns relative battery capacity/fuel left (0..1).
    */
-  virtual double getBatCapLeft() { return(power[0]->getBatteryMin()); };
+  virtual double getBatCapLeft();
   
   /**
    * the longest distance from any of the aircrafts points to the CG
@@ -161,9 +162,21 @@ private:
   
   /**
    * Propulsion system: batteries, shafts, engines, propellers.
+   * One for every rotor, only used if the system can't be handled by
+   * Power::RotorBatch.
    */
   std::vector<Power::Power*> power;
   
+  /**
+   * Propulsion system of all rotors, evaluated at once.
+   */
+  Power::RotorBatch* batch;
+  
+  /**
+   * Throttle command of every rotor
+   */
+  std::vector<float> rotor_throttle;
+  
   std::vector<Propdata> props;
   
   /**
@@ -204,6 +217,8 @@ private:
   double in_rnd_pitch;
   double dist_t;
   double dist_t_init;
+  uint64_t uInstance;        ///< number of this instance, see InitStates()
+  uint64_t uLaunch;          ///< launches so far, see InitStates()
     
   /**
    * Ground effect parameters, see code
@@ -0,0 +1,60 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+/** \file fdm_test_env.h
+ *
+ *  The environment of the tests which fly a model without a scenery.
+ */
+#ifndef FDM_TEST_ENV_H
+# define FDM_TEST_ENV_H
+
+# include "fdm_env.h"
+# include "fdm_inputs.h"
+
+/**
+ * Calm air above a flat ground far below, with the gravity and the
+ * air density at sea level. The inputs are passed to the FDM as they
+ * are. Tests derive from it to put in a terrain or to look at every
+ * step.
+ */
+class FDMTestEnviroment : public FDMEnviroment
+{
+public:
+  float GetSceneryHeight(float x_north, float y_east)
+  {
+    return(-1000);
+  };
+
+  int CalculateWind(double  X_cg,      double  Y_cg,     double  Z_cg,
+                    double& Vel_north, double& Vel_east, double& Vel_down)
+  {
+    Vel_north = Vel_east = Vel_down = 0;
+    return(0);
+  };
+
+  double GetG(double altitude)   { return(32.174); };
+  double GetRho(double altitude) { return(0.0023769); };
+
+  void ControllerCallback(double dt, FDMBase* fdm, TSimInputs* pInputsFromUser, TSimInputs* pInputsToFDM)
+  {
+    pInputsToFDM->CopyFrom(pInputsFromUser);
+  };
+};
+
+#endif
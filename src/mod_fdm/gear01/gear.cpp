@@ -28,9 +28,10 @@
 
 #include "gear.h"
 #include <stdexcept>
+#include <iostream>
 #include "../../mod_misc/ls_constants.h"
 #include "../xmlmodelfile.h"
-#include "../../mod_main/EventDispatcher.h"
+#include "../../mod_main/EventBus.h"
 
 
 /**
@@ -370,7 +371,16 @@ void Wheel::update( FDMEnviroment* env,
 
   reaction_normal_force = 0.;
 
-  SCALAR z_earth = -1*env->GetSceneryHeight(v_P_wheel_rwy_local.r[0], v_P_wheel_rwy_local.r[1]);
+  /* Terrain height: the plane of the last update is used as long as the
+     wheel stays inside of it */
+  float  x_north = v_P_wheel_rwy_local.r[0];
+  float  y_east  = v_P_wheel_rwy_local.r[1];
+  SCALAR z_earth;
+
+  if (terrain.contains(x_north, y_east))
+    z_earth = -1*terrain.getHeight(x_north, y_east);
+  else
+    z_earth = -1*env->GetSceneryPatch(x_north, y_east, terrain);
   
   if (v_P_wheel_rwy_local.r[2] > z_earth)
   {
@@ -388,7 +398,7 @@ void Wheel::update( FDMEnviroment* env,
   {
     /* emit a crash event */
     CrashEvent ev;
-    EventDispatcher::getInstance()->raise(&ev);
+    EventBus<CrashEvent>::raise(ev);
     std::cout << "Hardpoint " << nID << ": max_force exceeded (";
     std::cout << -reaction_normal_force << " lbf > " << max_force << " lbf)" << std::endl;
   }
@@ -479,6 +489,17 @@ void WheelSystem::update( TSimInputs* inputs,
     v_Moments += wheels[i].tempM;
   }
 }
+
+/**
+ * Invalidate the terrain patches of all wheels, so the next update
+ * asks the scenery again.
+ */
+void WheelSystem::resetTerrainCache()
+{
+  for (unsigned int i=0; i<wheels.size(); i++)
+    wheels[i].terrain.fValid = false;
+}
+
 #if 0
   /*
   * Calculate height minimum of the horizontal plane  so that this wheel is above the ground  
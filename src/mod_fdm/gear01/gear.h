@@ -131,6 +131,12 @@ class Wheel
     double steering_max_angle; ///<  Indicates maximum angle of steering wheel
     double percent_brake;
     double caster_angle_rad;   ///<  Alignment of the wheel
+
+    /**
+     * The part of the terrain the wheel has been in during the last
+     * update. As long as it stays inside, the scenery is not asked.
+     */
+    TerrainPatch terrain;
 };
 
 
@@ -175,6 +181,12 @@ class WheelSystem
     */
     double getZHigh() const { return(dZHigh); };
 
+   /**
+    * Forget the terrain below the wheels. Call this if the
+    * scenery might have been changed.
+    */
+    void resetTerrainCache();
+
   private:
     std::vector<Wheel>  wheels;
     CRRCMath::Vector3   v_Forces;
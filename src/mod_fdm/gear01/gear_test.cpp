@@ -0,0 +1,463 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+/**
+ * \file gear_test.cpp
+ *
+ * Terrain queries of the wheels with and without terrain patches.
+ *
+ * Usage: gear_test [-t seconds] model.xml [model.xml ...]
+ *
+ * The hardpoints of every model are moved along three trajectories
+ * (taxiing, takeoff and landing) over a triangulated terrain. The
+ * movement is prescribed, only the forces of the wheels are computed.
+ * Every trajectory is run twice: with an environment which only knows
+ * GetSceneryHeight() and with one which also hands out terrain patches.
+ *
+ * The same terrain is also sorted into the grid of HD_TilingTerrain,
+ * which is what a model based scenery uses. Its patches are clipped
+ * to the cells of the grid, so the wheels keep crossing the edges of
+ * patches and have to ask for new ones. This grid only covers some
+ * 1500 ft around the origin, so these runs last TILING_DURATION at
+ * most.
+ *
+ * The number of terrain queries per simulated second and the time
+ * needed are printed. Forces and moments have to be exactly the same.
+ * The return value is the number of runs with different results.
+ */
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+#include <math.h>
+
+#include <plib/ssg.h>
+
+#include "gear.h"
+#include "../fdm_test_env.h"
+#include "../../mod_misc/SimpleXMLTransfer.h"
+#include "../../mod_landscape/hd_tilingterrain.h"
+
+/**
+ * Default FDM step (simulation.flightModel.dt)
+ */
+#define FDM_DT      0.002777
+
+/**
+ * Size of the squares of the terrain [ft], each one is made of two
+ * triangles.
+ */
+#define TERRAIN_GRID 25.0
+
+/**
+ * Longest run on HD_TilingTerrain [s]
+ */
+#define TILING_DURATION 30.0
+
+/**
+ * A gently rolling terrain made of triangles. It counts the queries.
+ * If tiling is set, the terrain is looked up there instead of being
+ * calculated.
+ */
+class TestTerrain : public FDMTestEnviroment
+{
+  public:
+   TestTerrain(bool fUsePatches, HD_TilingTerrain* tiling = NULL)
+     : fPatches(fUsePatches), nQueries(0), tiling(tiling) {};
+
+   float GetSceneryHeight(float x_north, float y_east)
+   {
+     TerrainPatch patch;
+
+     nQueries++;
+     if (tiling != NULL)
+       return(tiling->getHeightAndPlane(x_north, y_east, NULL));
+     return(find(x_north, y_east, patch));
+   };
+
+   float GetSceneryPatch(float x_north, float y_east, TerrainPatch& patch)
+   {
+     if (!fPatches)
+       return(FDMEnviroment::GetSceneryPatch(x_north, y_east, patch));
+
+     nQueries++;
+     return(find(x_north, y_east, patch));
+   };
+
+   /**
+    * Height of the terrain [ft] at a corner of the grid
+    */
+   static float node(int i, int j)
+   {
+     return((float)(0.8*sin(0.37*i) * cos(0.23*j) + 0.3*sin(0.71*j + 1)));
+   };
+
+   /**
+    * Height of the terrain [ft], the same as GetSceneryHeight()
+    */
+   float height(float x_north, float y_east)
+   {
+     TerrainPatch patch;
+     return(find(x_north, y_east, patch));
+   };
+
+   /**
+    * Corner i|j of the grid in scenery coordinates (x east, y up, z south)
+    */
+   static void corner(float p[3], int i, int j)
+   {
+     p[0] = j*TERRAIN_GRID;
+     p[1] = node(i, j);
+     p[2] = -i*TERRAIN_GRID;
+   };
+
+   bool              fPatches;
+   unsigned long     nQueries;
+   HD_TilingTerrain* tiling;
+
+  private:
+
+   /**
+    * Looks up the triangle below x|y. Like the real scenery, the height is
+    * calculated from a plane in scenery coordinates (x east, y up, z south).
+    */
+   float find(float x_north, float y_east, TerrainPatch& patch)
+   {
+     if (tiling != NULL)
+       return(tiling->getHeightAndPatch(x_north, y_east, patch.plane,
+                                        patch.tri, patch.rect, patch.fValid));
+
+     int   i  = (int)floor(x_north / TERRAIN_GRID);
+     int   j  = (int)floor(y_east  / TERRAIN_GRID);
+     float n0 = i*TERRAIN_GRID;
+     float e0 = j*TERRAIN_GRID;
+     float u  = (x_north - n0) / TERRAIN_GRID;
+     float v  = (y_east  - e0) / TERRAIN_GRID;
+     float p[3][3];
+
+     // corners in scenery coordinates
+     if (u + v < 1)
+     {
+       corner(p[0], i,   j);
+       corner(p[1], i+1, j);
+       corner(p[2], i,   j+1);
+     }
+     else
+     {
+       corner(p[0], i+1, j);
+       corner(p[1], i+1, j+1);
+       corner(p[2], i,   j+1);
+     }
+
+     float a[3] = { p[1][0]-p[0][0], p[1][1]-p[0][1], p[1][2]-p[0][2] };
+     float b[3] = { p[2][0]-p[0][0], p[2][1]-p[0][1], p[2][2]-p[0][2] };
+     patch.plane[0] = a[1]*b[2] - a[2]*b[1];
+     patch.plane[1] = a[2]*b[0] - a[0]*b[2];
+     patch.plane[2] = a[0]*b[1] - a[1]*b[0];
+     patch.plane[3] = -(patch.plane[0]*p[0][0] + patch.plane[1]*p[0][1] + patch.plane[2]*p[0][2]);
+
+     for (int c=0; c<3; c++)
+     {
+       patch.tri[c][0] = -p[c][2];
+       patch.tri[c][1] =  p[c][0];
+     }
+     patch.rect[0] = n0;
+     patch.rect[1] = n0 + TERRAIN_GRID;
+     patch.rect[2] = e0;
+     patch.rect[3] = e0 + TERRAIN_GRID;
+     patch.fValid  = true;
+
+     return(patch.getHeight(x_north, y_east));
+   };
+};
+
+/**
+ * Puts the triangles of TestTerrain into a scenegraph and lets
+ * HD_TilingTerrain sort them into its grid. The terrain covers
+ * everything the trajectories reach within TILING_DURATION.
+ */
+static HD_TilingTerrain* makeTilingTerrain()
+{
+  ssgVertexArray* vertices = new ssgVertexArray();
+
+  for (int i=-12; i<60; i++)
+  {
+    for (int j=-4; j<20; j++)
+    {
+      sgVec3 p00, p10, p01, p11;
+
+      TestTerrain::corner(p00, i,   j);
+      TestTerrain::corner(p10, i+1, j);
+      TestTerrain::corner(p01, i,   j+1);
+      TestTerrain::corner(p11, i+1, j+1);
+
+      // the same triangles as TestTerrain::find()
+      vertices->add(p00);
+      vertices->add(p10);
+      vertices->add(p01);
+      vertices->add(p10);
+      vertices->add(p11);
+      vertices->add(p01);
+    }
+  }
+
+  ssgRoot* root = new ssgRoot();
+  root->addKid(new ssgVtxTable(GL_TRIANGLES, vertices, NULL, NULL, NULL));
+
+  HD_TilingTerrain* tiling = new HD_TilingTerrain(root);
+  ssgDeRefDelete(root);
+
+  return(tiling);
+}
+
+/**
+ * Position, attitude and velocity of the aircraft at some time
+ */
+class Pose
+{
+  public:
+   CRRCMath::Vector3 pos;   ///< north, east, down [ft]
+   CRRCMath::Vector3 euler; ///< phi, theta, psi [rad]
+};
+
+/**
+ * Prescribed movement
+ */
+typedef Pose (*Trajectory)(TestTerrain* terrain, double zLow, double t, double dDuration);
+
+/**
+ * Rolling around on the ground at walking speed
+ */
+static Pose taxi(TestTerrain* terrain, double zLow, double t, double dDuration)
+{
+  Pose p;
+
+  p.euler  = CRRCMath::Vector3(0, 0, 1.5*sin(0.05*t));
+  p.pos    = CRRCMath::Vector3(150*sin(0.05*t), 8*t, 0);
+  p.pos.r[2] = -terrain->height(p.pos.r[0], p.pos.r[1]) - zLow + 0.05;
+
+  return(p);
+}
+
+/**
+ * Accelerating, lift off after 2/3 of the time and climbing out
+ */
+static Pose takeoff(TestTerrain* terrain, double zLow, double t, double dDuration)
+{
+  Pose   p;
+  double tLift = 2*dDuration/3;
+  double acc   = 60 / tLift;
+
+  p.pos = CRRCMath::Vector3(0.5*acc*t*t, 3, 0);
+  p.pos.r[2] = -terrain->height(p.pos.r[0], p.pos.r[1]) - zLow + 0.05;
+  if (t > tLift)
+  {
+    double dt = t - tLift;
+    p.pos.r[2]  -= 6*dt*dt;
+    p.euler.r[1] = 0.15*(1 - exp(-dt));
+  }
+
+  return(p);
+}
+
+/**
+ * Descending, touching down after 1/3 of the time and rolling out
+ */
+static Pose landing(TestTerrain* terrain, double zLow, double t, double dDuration)
+{
+  Pose   p;
+  double tTouch = dDuration/3;
+  double v0     = 45;
+  double tStop  = dDuration - tTouch;
+
+  if (t < tTouch)
+  {
+    double dt = tTouch - t;
+    p.pos = CRRCMath::Vector3(v0*t, 3, 0);
+    p.pos.r[2] = -terrain->height(p.pos.r[0], p.pos.r[1]) - zLow + 0.05 - 2*dt;
+    p.euler.r[1] = 0.05;
+  }
+  else
+  {
+    double dt = t - tTouch;
+    p.pos = CRRCMath::Vector3(v0*tTouch + v0*(dt - 0.5*dt*dt/tStop), 3, 0);
+    p.pos.r[2] = -terrain->height(p.pos.r[0], p.pos.r[1]) - zLow + 0.05;
+  }
+
+  return(p);
+}
+
+/**
+ * Matrix 'local to body' for the euler angles
+ */
+static CRRCMath::Matrix33 localToBody(const CRRCMath::Vector3& euler)
+{
+  double sp = sin(euler.r[0]), cp = cos(euler.r[0]);
+  double st = sin(euler.r[1]), ct = cos(euler.r[1]);
+  double ss = sin(euler.r[2]), cs = cos(euler.r[2]);
+
+  return(CRRCMath::Matrix33(ct*cs,            ct*ss,            -st,
+                            sp*st*cs - cp*ss, sp*st*ss + cp*cs, sp*ct,
+                            cp*st*cs + sp*ss, cp*st*ss - sp*cs, cp*ct));
+}
+
+/**
+ * Moves the wheels along the trajectory and records all forces and moments.
+ * Returns the time needed [s].
+ */
+static double run(WheelSystem& wheels, TestTerrain* terrain, Trajectory traj,
+                  double dDuration, std::vector<double>& res)
+{
+  unsigned int nSteps = (unsigned int)(dDuration/FDM_DT);
+  TSimInputs   inputs;
+  clock_t      start;
+
+  // the trajectory is the same in both runs
+  std::vector<Pose> poses(nSteps+1);
+  for (unsigned int s=0; s<=nSteps; s++)
+    poses[s] = traj(terrain, wheels.getZLow(), s*FDM_DT, dDuration);
+
+  res.resize(6*nSteps);
+  wheels.resetTerrainCache();
+  terrain->nQueries = 0;
+
+  start = clock();
+  for (unsigned int s=0; s<nSteps; s++)
+  {
+    const Pose&       p     = poses[s];
+    const Pose&       pNext = poses[s+1];
+    CRRCMath::Vector3 vel   = (pNext.pos - p.pos) * (1/FDM_DT);
+    CRRCMath::Vector3 omega = (pNext.euler - p.euler) * (1/FDM_DT);
+
+    wheels.update(&inputs, terrain, localToBody(p.euler), p.pos, omega, vel, p.euler.r[2]);
+
+    for (int n=0; n<3; n++)
+    {
+      res[6*s+n]   = wheels.getForces().r[n];
+      res[6*s+n+3] = wheels.getMoments().r[n];
+    }
+  }
+  return((double)(clock()-start)/CLOCKS_PER_SEC);
+}
+
+/**
+ * Runs a trajectory without and with patches and prints the results.
+ * Returns the number of differences.
+ */
+static int compare(WheelSystem& wheels, HD_TilingTerrain* tiling, Trajectory traj,
+                   double dDuration, const char* name)
+{
+  TestTerrain         plain(false, tiling);
+  TestTerrain         patches(true, tiling);
+  std::vector<double> resPlain;
+  std::vector<double> resPatches;
+  double              tPlain   = run(wheels, &plain,   traj, dDuration, resPlain);
+  double              tPatches = run(wheels, &patches, traj, dDuration, resPatches);
+  int                 nDiff    = 0;
+
+  for (unsigned int n=0; n<resPlain.size(); n++)
+  {
+    if (resPlain[n] != resPatches[n])
+    {
+      if (nDiff == 0)
+        printf("  first difference at t=%.3f s: %g/%g\n",
+               (n/6)*FDM_DT, resPlain[n], resPatches[n]);
+      nDiff++;
+    }
+  }
+
+  printf("%s: %.0f/%.0f terrain queries per second, %.3f/%.3f s, %d differences\n",
+         name, plain.nQueries / dDuration, patches.nQueries / dDuration,
+         tPlain, tPatches, nDiff);
+
+  return(nDiff);
+}
+
+int main(int argc, char** argv)
+{
+  double             dDuration = 60;
+  int                nErrors   = 0;
+  const char*        names[]   = { "taxi", "takeoff", "landing" };
+  Trajectory         trajs[]   = { taxi, takeoff, landing };
+  HD_TilingTerrain*  tiling    = makeTilingTerrain();
+
+  for (int i=1; i<argc; i++)
+  {
+    if (strcmp(argv[i], "-t") == 0 && i+1 < argc)
+    {
+      dDuration = atof(argv[++i]);
+      continue;
+    }
+
+    try
+    {
+      SimpleXMLTransfer xml(argv[i]);
+      WheelSystem       wheels;
+
+      if (xml.indexOfChild("wheels") < 0)
+        continue;
+
+      // the wheel system talks about animations while loading
+      std::streambuf* buf = std::cout.rdbuf(0);
+      try
+      {
+        wheels.init(&xml, 0);
+      }
+      catch (...)
+      {
+        std::cout.rdbuf(buf);
+        std::cout.clear();
+        throw;
+      }
+      std::cout.rdbuf(buf);
+      std::cout.clear();
+
+      for (int t=0; t<3; t++)
+      {
+        std::string name = std::string(argv[i]) + ", " + names[t];
+
+        if (compare(wheels, NULL, trajs[t], dDuration, name.c_str()))
+          nErrors++;
+
+        name += ", tiling terrain";
+        if (compare(wheels, tiling, trajs[t],
+                    dDuration < TILING_DURATION ? dDuration : TILING_DURATION,
+                    name.c_str()))
+          nErrors++;
+      }
+    }
+    catch (XMLException e)
+    {
+      std::cout << argv[i] << ": " << e.what() << "\n";
+      nErrors++;
+    }
+    catch (std::exception& e)
+    {
+      std::cout << argv[i] << ": " << e.what() << "\n";
+      nErrors++;
+    }
+  }
+
+  delete tiling;
+
+  return(nErrors);
+}
@@ -23,12 +23,14 @@
 //
 //
 #include "eom.h"
+#include "../../mod_math/mathkernels.h"
 
 #include <iostream>
 #include <math.h>
 #include <cstdlib>
 
 EOM_6DOF::EOM_6DOF()
+  : method(CRRCMath::INTGR_AB2), stepForces(0), nEvaluations(0)
 {
 }
 
@@ -37,6 +39,7 @@ EOM_6DOF::EOM_6DOF(CRRCMath::Vector3  initPosEarth,
                    CRRCMath::Vector3  initVelBody,
                    double             initMass,
                    CRRCMath::Matrix33 initInertia)   
+  : method(CRRCMath::INTGR_AB2), stepForces(0), nEvaluations(0)
 {
   inertia     = initInertia;
   dMass_inv   = 1.0/initMass;
@@ -136,3 +139,94 @@ void EOM_6DOF::step(double             dT,
 */
 }
 
+
+void EOM_6DOF::setIntegrationMethod(CRRCMath::IntegrationMethod iMethod,
+                                    double                      dTolerance)
+{
+  method      = iMethod;
+  rk45.relTol = dTolerance;
+  rk45.absTol = dTolerance;
+  rk45.reset();
+}
+
+
+void EOM_6DOF::step(double dT, EOM_6DOF_Forces* forces)
+{
+  CRRCMath::Vector3 FBody;
+  CRRCMath::Vector3 MBody;
+  double            y[13];
+
+  switch (method)
+  {
+   case CRRCMath::INTGR_RK4:
+   case CRRCMath::INTGR_RK45:
+    stepForces = forces;
+    getState(y);
+    if (method == CRRCMath::INTGR_RK4)
+      rk4.step(*this, 0, y, dT);
+    else
+      rk45.integrate(*this, 0, y, dT);
+    setState(y);
+    stepForces = 0;
+    break;
+
+   default:
+    forces->calcForces(0, FBody, MBody);
+    nEvaluations++;
+    step(dT, FBody, MBody);
+    break;
+  }
+}
+
+
+void EOM_6DOF::getState(double* y)
+{
+  for (int n=0; n<3; n++)
+  {
+    y[n]   = pos.val.r[n];
+    y[n+3] = vel.val.r[n];
+    y[n+6] = angvel.val.r[n];
+  }
+  conv.getQuat(y+9);
+}
+
+
+void EOM_6DOF::setState(const double* y)
+{
+  for (int n=0; n<3; n++)
+  {
+    pos.val.r[n]    = y[n];
+    vel.val.r[n]    = y[n+3];
+    angvel.val.r[n] = y[n+6];
+  }
+  conv.setQuat(y+9);
+}
+
+
+void EOM_6DOF::derivative(double t, const double* y, double* dydt)
+{
+  CRRCMath::Vector3 FBody;
+  CRRCMath::Vector3 MBody;
+  
+  // The forces are calculated from the members, so the state to be
+  // evaluated is copied there first.
+  setState(y);
+  stepForces->calcForces(t, FBody, MBody);
+  nEvaluations++;
+
+  // Same equations as in step(dT, FBody, MBody)
+  CRRCMath::Vector3 velEarth      = conv.local(vel.val);
+  CRRCMath::Vector3 accel_body    = conv.body(CRRCMath::Vector3(0, 0, dGravity)) + (FBody*dMass_inv) + (vel.val*angvel.val);
+  CRRCMath::Vector3 angaccel_body = inertia_inv*( MBody - (angvel.val*(inertia*angvel.val)) );
+
+  for (int n=0; n<3; n++)
+  {
+    dydt[n]   = velEarth.r[n];
+    dydt[n+3] = accel_body.r[n];
+    dydt[n+6] = angaccel_body.r[n];
+  }
+  
+  // Use the quaternion as it is in y, not the normalized one. The
+  // length is forced to one at the end of the step.
+  CRRCMath::Kernels::quat_rate(y+9, angvel.val.r, dydt+9);
+}
@@ -28,6 +28,29 @@
 
 // jwtodo: Welches Integrationsverfahren ist zu benutzen?
 
+/**
+ * Supplies forces and moments to EOM_6DOF::step() if it has to evaluate
+ * them by itself. This is the case for the Runge-Kutta methods, which
+ * need the derivatives at intermediate states during a step.
+ */
+class EOM_6DOF_Forces
+{
+  public:
+   virtual ~EOM_6DOF_Forces() {};
+
+   /**
+    * Calculate forces and moments for the current state of eom (pos, vel,
+    * angvel and conv.mat are set, conv.euler is not).
+    *
+    * @param dt     time since the start of the step
+    * @param FBody  forces in body axes
+    * @param MBody  moments about the body axes
+    */
+   virtual void calcForces(double             dt,
+                           CRRCMath::Vector3& FBody,
+                           CRRCMath::Vector3& MBody) = 0;
+};
+
 /**
  * Equations of motion with six degrees of freedom.
  * 
@@ -38,7 +61,7 @@
  * 
  * @author Jens Wilhelm Wulf
  */
-class EOM_6DOF
+class EOM_6DOF : public CRRCMath::ODESystem
 {
   public:
       
@@ -72,6 +95,36 @@ class EOM_6DOF
              CRRCMath::Vector3 FBody,
              CRRCMath::Vector3 MBody);
 
+   /**
+    * Simulation step using the method set by setIntegrationMethod().
+    * forces is asked for forces and moments as often as the method
+    * needs them: once for INTGR_AB2 (which is the same as the step above),
+    * four times for INTGR_RK4 and at least seven times for INTGR_RK45.
+    */
+   void step(double dT, EOM_6DOF_Forces* forces);
+
+   /**
+    * Selects the integration method used by step(dT, forces). The
+    * tolerance is the relative and absolute local error allowed per
+    * step for INTGR_RK45 and is ignored otherwise. Default is INTGR_AB2.
+    */
+   void setIntegrationMethod(CRRCMath::IntegrationMethod iMethod,
+                             double                      dTolerance = 1e-6);
+
+   CRRCMath::IntegrationMethod getIntegrationMethod() { return(method); };
+
+   /**
+    * Number of evaluations of the forces so far.
+    */
+   unsigned long getEvaluations() { return(nEvaluations); };
+
+   /**
+    * State vector for the Runge-Kutta methods: position, velocity,
+    * angular velocity and the quaternion (scalar part first).
+    */
+   virtual int  getSize() { return(13); };
+   virtual void derivative(double t, const double* y, double* dydt);
+
    void print(std::string name);
 
   public:
@@ -115,6 +168,15 @@ class EOM_6DOF
     */
    double   dMass_inv;   
 
+   CRRCMath::IntegrationMethod method;
+   CRRCMath::RungeKutta4       rk4;
+   CRRCMath::DormandPrince45   rk45;
+   EOM_6DOF_Forces*            stepForces;
+   unsigned long               nEvaluations;
+
+   void setState(const double* y);
+   void getState(double* y);
+
 };
 
 #endif
@@ -0,0 +1,453 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+/**
+ * \file eom_test.cpp
+ *
+ * Accuracy versus cost of the integration methods of EOM_6DOF.
+ *
+ * Usage: eom_test [-t seconds] model.xml [model.xml ...]
+ *
+ * Every model is flown through a sequence of control inputs, using
+ * its aerodynamic coefficients, mass and inertia (first config). The
+ * aerodynamics are those of CRRC_AirplaneSim_002 without stall and
+ * without wind, so the flight is smooth and the difference between
+ * the methods is the integration error only. A trajectory computed
+ * with a very tight tolerance is the reference.
+ *
+ * For every method the number of evaluations of the forces and the
+ * largest position error is printed. The return value is the number
+ * of models for which a method failed to reach the expected accuracy.
+ */
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <vector>
+#include <math.h>
+
+#include "eom.h"
+#include "../../mod_misc/SimpleXMLTransfer.h"
+#include "../../mod_misc/ls_constants.h"
+
+/**
+ * Time between two frames [s], the error is checked after every frame.
+ */
+#define FRAME_DT  0.02
+
+/**
+ * Default FDM step (simulation.flightModel.dt)
+ */
+#define FDM_DT    0.002777
+
+/**
+ * Sea level density [slug/ft^3] and gravity [ft/s^2]
+ */
+#define RHO       0.0023769
+#define GRAVITY   32.174
+
+/**
+ * Aerodynamics of CRRC_AirplaneSim_002, without stall, Reynolds
+ * scaling and wind.
+ */
+class TestPlane : public EOM_6DOF_Forces
+{
+  public:
+   TestPlane() : t0(0), eom(0) {};
+
+   /**
+    * Reads aero, mass and inertia. Returns false if the file doesn't
+    * contain the data needed (helicopters, multicopters).
+    */
+   bool load(SimpleXMLTransfer* xml);
+
+   /**
+    * Starts a new flight with eom.
+    */
+   void init(EOM_6DOF* eomIn);
+
+   /**
+    * One frame, using method and step size dt
+    */
+   void frame(CRRCMath::IntegrationMethod method, double dt);
+
+   /**
+    * Without stall model and engine a statically unstable plane
+    * just tumbles until the velocity is gone.
+    */
+   bool isStable() { return(Cm_a < 0); };
+
+   virtual void calcForces(double dt, CRRCMath::Vector3& FBody, CRRCMath::Vector3& MBody);
+
+   double t0;
+   double Mass, I_xx, I_yy, I_zz, I_xz;
+   double vTrim;
+
+  private:
+   EOM_6DOF* eom;
+
+   double C_ref, B_ref, S_ref;
+   double Alpha_0;
+   double Cm_0, Cm_a, Cm_q, Cm_de;
+   double CL_0, CL_a, CL_q, CL_de, CL_CD0;
+   double CD_prof, CD_CLsq, span_eff;
+   double CY_b, CY_p, CY_r, CY_dr, CY_da;
+   double Cl_b, Cl_p, Cl_r, Cl_dr, Cl_da;
+   double Cn_b, Cn_p, Cn_r, Cn_dr, Cn_da;
+};
+
+bool TestPlane::load(SimpleXMLTransfer* xml)
+{
+  SimpleXMLTransfer* i;
+  SimpleXMLTransfer* aero;
+  SimpleXMLTransfer* cfg;
+  double             to_ft;
+  double             to_slug;
+  double             to_slug_ft_ft;
+
+  if (xml->indexOfChild("aero") < 0 || xml->indexOfChild("config") < 0)
+    return(false);
+  aero = xml->getChild("aero");
+  cfg  = xml->getChild("config");
+  if (aero->indexOfChild("ref") < 0 || cfg->indexOfChild("mass_inertia") < 0)
+    return(false);
+
+  to_ft = (aero->getInt("units") == 1) ? M_TO_FT : 1;
+  i = aero->getChild("ref");
+  C_ref = i->getDouble("chord") * to_ft;
+  B_ref = i->getDouble("span")  * to_ft;
+  S_ref = i->getDouble("area")  * to_ft * to_ft;
+
+  Alpha_0  = aero->getDouble("misc.Alpha_0");
+  span_eff = aero->getDouble("misc.span_eff");
+
+  i = aero->getChild("m");
+  Cm_0  = i->getDouble("Cm_0");
+  Cm_a  = i->getDouble("Cm_a");
+  Cm_q  = i->getDouble("Cm_q");
+  Cm_de = i->getDouble("Cm_de");
+
+  i = aero->getChild("lift");
+  CL_0   = i->getDouble("CL_0");
+  CL_a   = i->getDouble("CL_a");
+  CL_q   = i->getDouble("CL_q");
+  CL_de  = i->getDouble("CL_de");
+  CL_CD0 = i->getDouble("CL_CD0");
+
+  i = aero->getChild("drag");
+  CD_prof = i->getDouble("CD_prof");
+  CD_CLsq = i->getDouble("CD_CLsq");
+
+  i = aero->getChild("Y");
+  CY_b  = i->getDouble("CY_b");
+  CY_p  = i->getDouble("CY_p");
+  CY_r  = i->getDouble("CY_r");
+  CY_dr = i->getDouble("CY_dr");
+  CY_da = i->getDouble("CY_da");
+
+  i = aero->getChild("l");
+  Cl_b  = i->getDouble("Cl_b");
+  Cl_p  = i->getDouble("Cl_p");
+  Cl_r  = i->getDouble("Cl_r");
+  Cl_dr = i->getDouble("Cl_dr");
+  Cl_da = i->getDouble("Cl_da");
+
+  i = aero->getChild("n");
+  Cn_b  = i->getDouble("Cn_b");
+  Cn_p  = i->getDouble("Cn_p");
+  Cn_r  = i->getDouble("Cn_r");
+  Cn_dr = i->getDouble("Cn_dr");
+  Cn_da = i->getDouble("Cn_da");
+
+  i = cfg->getChild("mass_inertia");
+  if (i->getInt("units") == 1)
+  {
+    to_slug       = KG_TO_SLUG;
+    to_slug_ft_ft = KG_M_M_TO_SLUG_FT_FT;
+  }
+  else
+  {
+    to_slug       = 1;
+    to_slug_ft_ft = 1;
+  }
+  Mass = i->getDouble("Mass") * to_slug;
+  I_xx = i->getDouble("I_xx") * to_slug_ft_ft;
+  I_yy = i->getDouble("I_yy") * to_slug_ft_ft;
+  I_zz = i->getDouble("I_zz") * to_slug_ft_ft;
+  I_xz = i->getDouble("I_xz") * to_slug_ft_ft;
+
+  // trimmed flight velocity like in CRRC_AirplaneSim_002
+  {
+    double alpha = ((Cm_a * Alpha_0) - Cm_0 ) / Cm_a;
+    double cl    = CL_0 + CL_a * (alpha - Alpha_0);
+
+    if (cl < 0.2)
+      cl = 0.2;
+    vTrim = sqrt(Mass * GRAVITY * 2 / (S_ref * cl * RHO));
+  }
+
+  return(true);
+}
+
+void TestPlane::init(EOM_6DOF* eomIn)
+{
+  eom = eomIn;
+  t0  = 0;
+}
+
+void TestPlane::frame(CRRCMath::IntegrationMethod method, double dt)
+{
+  int nSteps = (int)ceil(FRAME_DT/dt - 1e-6);
+
+  dt = FRAME_DT/nSteps;
+
+  for (int n=0; n<nSteps; n++)
+  {
+    if (method == CRRCMath::INTGR_AB2)
+    {
+      CRRCMath::Vector3 F, M;
+
+      calcForces(0, F, M);
+      eom->step(dt, F, M);
+    }
+    else
+      eom->step(dt, this);
+    t0 += dt;
+  }
+}
+
+void TestPlane::calcForces(double dt, CRRCMath::Vector3& FBody, CRRCMath::Vector3& MBody)
+{
+  double t = t0 + dt;
+
+  // Smooth control inputs: a pitch doublet, a roll to the left and back
+  // and some rudder.
+  double elevator = 0.15*sin(2*M_PI*t/4.0)*exp(-0.1*t);
+  double aileron  = 0.3*sin(2*M_PI*t/6.0);
+  double rudder   = 0.1*sin(2*M_PI*t/5.0);
+
+  CRRCMath::Vector3 v_V_body = eom->vel.val;
+  double            V        = v_V_body.length();
+  double            Alpha    = atan2(v_V_body.r[2], v_V_body.r[0]);
+  double            Beta     = asin(v_V_body.r[1]/V);
+  double            Cos_alpha = cos(Alpha);
+  double            Sin_alpha = sin(Alpha);
+  double            Cos_beta  = cos(Beta);
+
+  double Phat = eom->angvel.val.r[0] * B_ref / (2.0*V);
+  double Qhat = eom->angvel.val.r[1] * C_ref / (2.0*V);
+  double Rhat = eom->angvel.val.r[2] * B_ref / (2.0*V);
+
+  double CL_wing  = CL_0 + CL_a*(Alpha-Alpha_0);
+  double CD_all   = CD_prof + CD_CLsq*(CL_wing-CL_CD0)*(CL_wing-CL_CD0);
+  double Cl_r_mod = Cl_r*CL_wing/CL_0;
+  double Cn_p_mod = Cn_p*CL_wing/CL_0;
+  double CL       = (CL_wing + CL_q*Qhat + CL_de*elevator)*Cos_alpha;
+  double Cl_w     = Cl_b*Beta + Cl_p*Phat + Cl_r_mod*Rhat + Cl_da*aileron;
+  double CD       = CD_all + (CL*CL + 32.0*Cl_w*Cl_w)*S_ref/(B_ref*B_ref*M_PI*span_eff);
+
+  CRRCMath::Vector3 C_xyz(-CD*Cos_alpha + CL*Sin_alpha*Cos_beta*Cos_beta,
+                          CY_b*Beta + CY_p*Phat + CY_r*Rhat + CY_dr*rudder,
+                          -CD*Sin_alpha - CL*Cos_alpha*Cos_beta*Cos_beta);
+
+  double Cl = Cl_b*Beta + Cl_p*Phat     + Cl_r_mod*Rhat + Cl_dr*rudder + Cl_da*aileron;
+  double Cn = Cn_b*Beta + Cn_p_mod*Phat + Cn_r*Rhat     + Cn_dr*rudder + Cn_da*aileron;
+  double Cm = Cm_0 + Cm_a*(Alpha-Alpha_0) + Cm_q*Qhat + Cm_de*elevator;
+
+  double QS = 0.5*RHO*V*V*S_ref;
+
+  FBody = C_xyz * QS;
+  MBody = CRRCMath::Vector3(Cl*QS*B_ref, Cm*QS*C_ref, Cn*QS*B_ref);
+}
+
+/**
+ * Result of a flight
+ */
+class Flight
+{
+  public:
+   std::vector<CRRCMath::Vector3> pos;
+   unsigned long                  nEval;
+   double                         dTime;
+};
+
+/**
+ * Flies plane for dDuration seconds. dParam is the step size for
+ * INTGR_AB2 and INTGR_RK4 and the tolerance for INTGR_RK45.
+ */
+static void fly(TestPlane& plane, CRRCMath::IntegrationMethod method, double dParam,
+                double dDuration, Flight& result)
+{
+  int     nFrames = (int)(dDuration/FRAME_DT + 0.5);
+  double  dt      = dParam;
+  clock_t start;
+
+  // The constructor prints the initial state, which isn't of interest here.
+  std::streambuf* buf = std::cout.rdbuf(0);
+  EOM_6DOF eom(CRRCMath::Vector3(0, 0, -100),
+               CRRCMath::Vector3(0.2, 0, 0.5),
+               CRRCMath::Vector3(plane.vTrim, 0.05*plane.vTrim, 0),
+               plane.Mass,
+               CRRCMath::Matrix33( plane.I_xx, 0,          -plane.I_xz,
+                                   0,          plane.I_yy,  0,
+                                  -plane.I_xz, 0,           plane.I_zz));
+  std::cout.rdbuf(buf);
+  std::cout.clear();
+
+  eom.setGravity(GRAVITY);
+  if (method == CRRCMath::INTGR_RK45)
+  {
+    eom.setIntegrationMethod(method, dParam);
+    dt = FRAME_DT;
+  }
+  else
+    eom.setIntegrationMethod(method);
+
+  plane.init(&eom);
+  result.pos.resize(nFrames);
+  result.nEval = 0;
+
+  start = clock();
+  for (int n=0; n<nFrames; n++)
+  {
+    plane.frame(method, dt);
+    result.pos[n] = eom.pos.val;
+  }
+  result.dTime = (double)(clock() - start)/CLOCKS_PER_SEC;
+
+  if (method == CRRCMath::INTGR_AB2)
+    result.nEval = nFrames * (unsigned long)ceil(FRAME_DT/dt - 1e-6);
+  else
+    result.nEval = eom.getEvaluations();
+}
+
+static double maxError(const Flight& a, const Flight& ref)
+{
+  double err = 0;
+
+  for (unsigned int n=0; n<a.pos.size(); n++)
+  {
+    double d = (a.pos[n] - ref.pos[n]).length();
+
+    // NaN if the method blew up
+    if (!(d <= err))
+      err = d;
+  }
+  return(err);
+}
+
+struct Run
+{
+  CRRCMath::IntegrationMethod method;
+  double                      param;
+};
+
+static const Run runs[] =
+{
+  { CRRCMath::INTGR_AB2,  0.01     },
+  { CRRCMath::INTGR_AB2,  FDM_DT   },
+  { CRRCMath::INTGR_AB2,  0.001    },
+  { CRRCMath::INTGR_RK4,  0.02     },
+  { CRRCMath::INTGR_RK4,  0.01     },
+  { CRRCMath::INTGR_RK4,  0.005    },
+  { CRRCMath::INTGR_RK45, 1e-4     },
+  { CRRCMath::INTGR_RK45, 1e-6     },
+  { CRRCMath::INTGR_RK45, 1e-8     },
+};
+
+#define N_RUNS (int)(sizeof(runs)/sizeof(runs[0]))
+
+int main(int argc, char** argv)
+{
+  double dDuration = 20;
+  int    nErrors   = 0;
+  int    nModels   = 0;
+
+  for (int i=1; i<argc; i++)
+  {
+    if (strcmp(argv[i], "-t") == 0 && i+1 < argc)
+    {
+      dDuration = atof(argv[++i]);
+      continue;
+    }
+
+    TestPlane plane;
+    try
+    {
+      SimpleXMLTransfer xml(argv[i]);
+
+      if (!plane.load(&xml))
+      {
+        std::cout << argv[i] << ": no aero description, skipped\n";
+        continue;
+      }
+      if (!plane.isStable())
+      {
+        std::cout << argv[i] << ": statically unstable (Cm_a >= 0), skipped\n";
+        continue;
+      }
+    }
+    catch (XMLException e)
+    {
+      std::cout << argv[i] << ": " << e.what() << "\n";
+      nErrors++;
+      continue;
+    }
+
+    Flight ref;
+    Flight res[N_RUNS];
+
+    fly(plane, CRRCMath::INTGR_RK45, 1e-12, dDuration, ref);
+
+    printf("%s, %.1f s, reference: %lu evaluations\n", argv[i], dDuration, ref.nEval);
+    printf("  method  dt/tol     evaluations  max. error [ft]  time [ms]\n");
+    for (int r=0; r<N_RUNS; r++)
+    {
+      fly(plane, runs[r].method, runs[r].param, dDuration, res[r]);
+      printf("  %-6s  %-9g  %11lu  %15.3e  %9.2f\n",
+             CRRCMath::IntegrationMethodToString(runs[r].method), runs[r].param,
+             res[r].nEval, maxError(res[r], ref), res[r].dTime*1000);
+    }
+
+    // RK45 has to be more accurate than AB2 with the default dt and has
+    // to stay near its tolerance (the error accumulates over many steps).
+    // RK4 isn't checked, some models are too stiff for it at these step
+    // sizes.
+    if (!(maxError(res[7], ref) < maxError(res[1], ref)))
+    {
+      printf("  ERROR: rk45 is less accurate than ab2\n");
+      nErrors++;
+    }
+    if (!(maxError(res[8], ref) < 1e-3))
+    {
+      printf("  ERROR: rk45 missed its tolerance\n");
+      nErrors++;
+    }
+    nModels++;
+  }
+
+  if (nModels == 0)
+  {
+    std::cout << "Usage: eom_test [-t seconds] model.xml [model.xml ...]\n";
+    nErrors++;
+  }
+
+  return(nErrors);
+}
@@ -111,6 +111,8 @@ namespace Power
    */
   class Battery
   {
+    friend class RotorBatch;
+
     public:
 
      /**
@@ -24,9 +24,6 @@
 #include "../../mod_misc/lib_conversions.h"
 #include "../../mod_math/linearreg.h"
 
-// Wirkungsgrad des Drehzahlstellers
-#define  ETA_STELLER  0.95
-
 #define  THR_P_S 3.0
 
 inline double sqr(double val) { return(val*val); };
@@ -151,23 +148,10 @@ void Power::Engine_DCM::step(PowerValuesStep* values)
   // is not that easy in any case and maybe a change like this would mean worse
   // realism regarding combustion engines?
   // 
-  // voltage applied to motor
-  double U_K = throttle.val * values->U * ETA_STELLER;
-
-  // Generatorspannung
-  double U_Gen = omega * k_M;
-
   //  motor current
-  double I_M = (U_K - U_Gen) / R_I;
+  double I_M = current(throttle.val, values->U, omega, k_M, R_I);
 
-  // Aeusseres Moment
-  M_M = k_M * I_M - k_r * omega;
-  
-  // Das Reibmoment wirkt immer der aktuellen Drehzahl entgegen
-  if (omega > 0)
-    M_M -= M_r;
-  else
-    M_M += M_r;
+  M_M = moment(I_M, omega, k_M, k_r, M_r);
 
   values->moment_shaft += M_M*i;
   
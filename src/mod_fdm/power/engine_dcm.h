@@ -28,6 +28,11 @@
 namespace Power
 {
 
+  /**
+   * Efficiency of the speed controller (Wirkungsgrad des Drehzahlstellers)
+   */
+  const double ETA_STELLER = 0.95;
+
   /**
    * This class is part of the power system. To simply use the system, you should not
    * access or call any of its members. Please take a look at Power instead.
@@ -168,6 +173,8 @@ namespace Power
    */
   class Engine_DCM : public Gearing
   {
+    friend class RotorBatch;
+
     public:
 
      /**
@@ -197,6 +204,41 @@ namespace Power
     
      virtual void InitStates(CRRCMath::Vector3 vInitialVelocity, double& dOmega);
 
+     /**
+      * Current drawn by the engine [A]. The speed controller applies
+      * <tt>throttle * U * ETA_STELLER</tt> to the engine, which rotates
+      * at omega [rad/s]. Also used by RotorBatch.
+      */
+     static double current(double throttle, double U, double omega,
+                           double k_M, double R_I)
+     {
+       // voltage applied to motor
+       double U_K = throttle * U * ETA_STELLER;
+
+       // Generatorspannung
+       double U_Gen = omega * k_M;
+
+       return((U_K - U_Gen) / R_I);
+     };
+
+     /**
+      * Torque of the engine [Nm] at current I_M and speed omega, see current().
+      */
+     static double moment(double I_M, double omega,
+                          double k_M, double k_r, double M_r)
+     {
+       // Aeusseres Moment
+       double M_M = k_M * I_M - k_r * omega;
+
+       // Das Reibmoment wirkt immer der aktuellen Drehzahl entgegen
+       if (omega > 0)
+         M_M -= M_r;
+       else
+         M_M += M_r;
+
+       return(M_M);
+     };
+
     private:
 
      /**
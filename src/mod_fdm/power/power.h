@@ -151,6 +151,8 @@ namespace Power
    */
   class Power
   {
+    friend class RotorBatch;
+
     public:
 
      /**
@@ -0,0 +1,383 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+/**
+ * \file power_test.cpp
+ *
+ * Compares Power::RotorBatch to a list of Power::Power objects.
+ *
+ * Usage: power_test [-t seconds] model.xml [model.xml ...]
+ *
+ * The power system of every config of every model is used for 4 and
+ * 8 rotors. Each rotor gets a throttle command of its own, which
+ * includes zero throttle and values above one. The simulation runs
+ * until the batteries are empty. Thrust, torque, propeller speed and
+ * voltage have to be exactly the same in both cases.
+ *
+ * A batch with a shared battery (<tt>power.battery.shared="1"</tt>) is
+ * compared to one Power object whose battery drives one shaft per
+ * rotor. As that one only takes a single throttle command, all rotors
+ * get the same one here.
+ *
+ * The time needed for both versions is printed. The return value is
+ * the number of systems which produced different results.
+ */
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <vector>
+#include <math.h>
+
+#include "power.h"
+#include "rotorbatch.h"
+#include "../../mod_misc/SimpleXMLTransfer.h"
+
+#define POWER_TEST_DT 0.01
+
+/**
+ * Throttle command of rotor n at time t
+ */
+static double throttle(unsigned int n, double t)
+{
+  double thr = 0.55 + 0.6*sin(0.7*t + n) + 0.1*sin(5.3*t + 2*n);
+  return(thr < 0 ? 0 : thr);
+}
+
+/**
+ * Equal, including NaN (a stiff system may blow up in both versions)
+ */
+static bool same(double a, double b)
+{
+  return(a == b || (a != a && b != b));
+}
+
+static CRRCMath::Vector3 wind(double t)
+{
+  return(CRRCMath::Vector3(8 + 6*sin(0.3*t), 2*sin(0.11*t), 1));
+}
+
+/**
+ * Creates a power system without letting it talk.
+ */
+static Power::Power* load(SimpleXMLTransfer* cfg)
+{
+  std::streambuf* buf   = std::cout.rdbuf(0);
+  Power::Power*   power = 0;
+  try
+  {
+    power = new Power::Power(cfg, 0);
+  }
+  catch (...)
+  {
+    std::cout.rdbuf(buf);
+    std::cout.clear();
+    throw;
+  }
+  std::cout.rdbuf(buf);
+  std::cout.clear();
+
+  return(power);
+}
+
+/**
+ * Runs both versions, returns the number of differences.
+ */
+static int compare(SimpleXMLTransfer* cfg, unsigned int nRotors, double dDuration,
+                   double& tPower, double& tBatch)
+{
+  std::vector<Power::Power*> power;
+  Power::RotorBatch*         batch;
+  unsigned int               nSteps = (unsigned int)(dDuration/POWER_TEST_DT);
+  int                        nDiff  = 0;
+  clock_t                    start;
+
+  // The first one replaces an automagic description by the real one
+  // (with rounded values), so it is not used.
+  delete load(cfg);
+  for (unsigned int n=0; n<nRotors; n++)
+    power.push_back(load(cfg));
+  Power::Power* proto = load(cfg);
+
+  if (!Power::RotorBatch::isSuitable(proto))
+  {
+    delete proto;
+    for (unsigned int n=0; n<nRotors; n++)
+      delete power[n];
+    return(-1);
+  }
+  batch = new Power::RotorBatch(proto, nRotors);
+
+  std::vector<float>             inThr(nSteps*nRotors);
+  std::vector<CRRCMath::Vector3> inWind(nSteps);
+  for (unsigned int s=0; s<nSteps; s++)
+  {
+    inWind[s] = wind(s*POWER_TEST_DT);
+    for (unsigned int n=0; n<nRotors; n++)
+      inThr[s*nRotors+n] = throttle(n, s*POWER_TEST_DT);
+  }
+
+  std::vector<double> resF(nSteps*nRotors);
+  std::vector<double> resM(nSteps*nRotors);
+  std::vector<double> resFreq(nSteps*nRotors);
+  std::vector<double> resVolt(nSteps*nRotors);
+
+  start = clock();
+  for (unsigned int s=0; s<nSteps; s++)
+  {
+    TSimInputs inputs;
+
+    inputs.pitch = 1;
+    for (unsigned int n=0; n<nRotors; n++)
+    {
+      CRRCMath::Vector3 f = CRRCMath::Vector3();
+      CRRCMath::Vector3 m = CRRCMath::Vector3();
+
+      inputs.throttle = inThr[s*nRotors+n];
+      power[n]->step(POWER_TEST_DT, &inputs, inWind[s], &f, &m);
+      resF   [s*nRotors+n] = f.r[0];
+      resM   [s*nRotors+n] = m.r[0];
+      resFreq[s*nRotors+n] = power[n]->getPropFreq();
+      resVolt[s*nRotors+n] = power[n]->GetVoltageAvg();
+    }
+  }
+  tPower += (double)(clock()-start)/CLOCKS_PER_SEC;
+
+  start = clock();
+  for (unsigned int s=0; s<nSteps; s++)
+    batch->step(POWER_TEST_DT, &inThr[s*nRotors], 1, inWind[s]);
+  tBatch += (double)(clock()-start)/CLOCKS_PER_SEC;
+
+  // once more, now comparing the results
+  batch->InitStates(CRRCMath::Vector3());
+  for (unsigned int s=0; s<nSteps; s++)
+  {
+    batch->step(POWER_TEST_DT, &inThr[s*nRotors], 1, inWind[s]);
+    for (unsigned int n=0; n<nRotors; n++)
+    {
+      if (!same(batch->getForce(n).r[0],  resF   [s*nRotors+n]) ||
+          !same(batch->getMoment(n).r[0], resM   [s*nRotors+n]) ||
+          !same(batch->getPropFreq(n),    resFreq[s*nRotors+n]) ||
+          !same(batch->GetVoltageAvg(n),  resVolt[s*nRotors+n]))
+      {
+        if (nDiff == 0)
+          printf("  first difference at t=%.2f s, rotor %u: F %g/%g, M %g/%g\n",
+                 s*POWER_TEST_DT, n, batch->getForce(n).r[0], resF[s*nRotors+n],
+                 batch->getMoment(n).r[0], resM[s*nRotors+n]);
+        nDiff++;
+      }
+    }
+  }
+
+  if (fabs(batch->getBatteryMin() - power[0]->getBatteryMin()) > 0.01)
+  {
+    printf("  battery: %g/%g\n", batch->getBatteryMin(), power[0]->getBatteryMin());
+    nDiff++;
+  }
+
+  delete batch;
+  for (unsigned int n=0; n<nRotors; n++)
+    delete power[n];
+
+  return(nDiff);
+}
+
+
+/**
+ * Runs a batch with a shared battery and a Power object with nRotors
+ * shafts on its battery, returns the number of differences.
+ */
+static int compareShared(SimpleXMLTransfer* cfg, unsigned int nRotors, double dDuration,
+                         double& tPower, double& tBatch)
+{
+  unsigned int nSteps = (unsigned int)(dDuration/POWER_TEST_DT);
+  int          nDiff  = 0;
+  clock_t      start;
+
+  delete load(cfg);
+  Power::Power* proto = load(cfg);
+  if (!Power::RotorBatch::isSuitable(proto))
+  {
+    delete proto;
+    return(-1);
+  }
+  Power::RotorBatch* batch = new Power::RotorBatch(proto, nRotors, true);
+
+  // the same system with one shaft per rotor
+  SimpleXMLTransfer  multi(cfg);
+  SimpleXMLTransfer* bat   = multi.getChild("power.battery");
+  SimpleXMLTransfer* shaft = bat->getChild("shaft");
+  for (unsigned int n=1; n<nRotors; n++)
+    bat->addChild(new SimpleXMLTransfer(shaft));
+  Power::Power* power = load(&multi);
+
+  std::vector<float>             inThr(nSteps*nRotors);
+  std::vector<CRRCMath::Vector3> inWind(nSteps);
+  for (unsigned int s=0; s<nSteps; s++)
+  {
+    inWind[s] = wind(s*POWER_TEST_DT);
+    for (unsigned int n=0; n<nRotors; n++)
+      inThr[s*nRotors+n] = throttle(0, s*POWER_TEST_DT);
+  }
+
+  std::vector<double> resF(nSteps);
+  std::vector<double> resM(nSteps);
+  std::vector<double> resFreq(nSteps);
+  std::vector<double> resVolt(nSteps);
+
+  start = clock();
+  for (unsigned int s=0; s<nSteps; s++)
+  {
+    TSimInputs        inputs;
+    CRRCMath::Vector3 f = CRRCMath::Vector3();
+    CRRCMath::Vector3 m = CRRCMath::Vector3();
+
+    inputs.pitch    = 1;
+    inputs.throttle = inThr[s*nRotors];
+    power->step(POWER_TEST_DT, &inputs, inWind[s], &f, &m);
+    resF   [s] = f.r[0];
+    resM   [s] = m.r[0];
+    resFreq[s] = power->getPropFreq();
+    resVolt[s] = power->GetVoltageAvg();
+  }
+  tPower += (double)(clock()-start)/CLOCKS_PER_SEC;
+
+  start = clock();
+  for (unsigned int s=0; s<nSteps; s++)
+    batch->step(POWER_TEST_DT, &inThr[s*nRotors], 1, inWind[s]);
+  tBatch += (double)(clock()-start)/CLOCKS_PER_SEC;
+
+  batch->InitStates(CRRCMath::Vector3());
+  for (unsigned int s=0; s<nSteps; s++)
+  {
+    CRRCMath::Vector3 f = CRRCMath::Vector3();
+    CRRCMath::Vector3 m = CRRCMath::Vector3();
+    bool              fSame;
+
+    batch->step(POWER_TEST_DT, &inThr[s*nRotors], 1, inWind[s]);
+    for (unsigned int n=0; n<nRotors; n++)
+    {
+      f += batch->getForce(n);
+      m += batch->getMoment(n);
+    }
+    fSame = same(f.r[0], resF[s]) && same(m.r[0], resM[s]);
+    for (unsigned int n=0; n<nRotors; n++)
+      fSame = fSame && same(batch->getPropFreq(n),   resFreq[s])
+                    && same(batch->GetVoltageAvg(n), resVolt[s]);
+    if (!fSame)
+    {
+      if (nDiff == 0)
+        printf("  first difference at t=%.2f s: F %g/%g, M %g/%g\n",
+               s*POWER_TEST_DT, f.r[0], resF[s], m.r[0], resM[s]);
+      nDiff++;
+    }
+  }
+
+  if (fabs(batch->getBatteryMin() - power->getBatteryMin()) > 0.01)
+  {
+    printf("  battery: %g/%g\n", batch->getBatteryMin(), power->getBatteryMin());
+    nDiff++;
+  }
+
+  delete batch;
+  delete power;
+
+  return(nDiff);
+}
+
+int main(int argc, char** argv)
+{
+  double dDuration = 600;
+  int    nErrors   = 0;
+
+  for (int i=1; i<argc; i++)
+  {
+    if (strcmp(argv[i], "-t") == 0 && i+1 < argc)
+    {
+      dDuration = atof(argv[++i]);
+      continue;
+    }
+
+    try
+    {
+      SimpleXMLTransfer xml(argv[i]);
+      int               nConfig = 0;
+
+      for (int c=0; c<xml.getChildCount(); c++)
+      {
+        SimpleXMLTransfer* cfg = xml.getChildAt(c);
+
+        if (cfg->getName().compare("config") != 0)
+          continue;
+        nConfig++;
+        if (cfg->indexOfChild("power") < 0)
+          continue;
+
+        for (unsigned int nRotors=4; nRotors<=8; nRotors+=4)
+        {
+          double tPower = 0;
+          double tBatch = 0;
+          int    nDiff;
+
+          try
+          {
+            nDiff = compare(cfg, nRotors, dDuration, tPower, tBatch);
+          }
+          catch (XMLException e)
+          {
+            // some configs refer to files which are not part of the package
+            printf("%s, config %d: %s, skipped\n", argv[i], nConfig, e.what());
+            break;
+          }
+
+          if (nDiff < 0)
+          {
+            printf("%s, config %d: not suitable for RotorBatch\n", argv[i], nConfig);
+            break;
+          }
+          printf("%s, config %d, %u rotors: Power %.3f s, RotorBatch %.3f s, %d differences\n",
+                 argv[i], nConfig, nRotors, tPower, tBatch, nDiff);
+          if (nDiff)
+            nErrors++;
+
+          tPower = 0;
+          tBatch = 0;
+          nDiff  = compareShared(cfg, nRotors, dDuration, tPower, tBatch);
+          printf("%s, config %d, %u rotors, shared battery: Power %.3f s, RotorBatch %.3f s, %d differences\n",
+                 argv[i], nConfig, nRotors, tPower, tBatch, nDiff);
+          if (nDiff)
+            nErrors++;
+        }
+      }
+    }
+    catch (XMLException e)
+    {
+      std::cout << argv[i] << ": " << e.what() << "\n";
+      nErrors++;
+    }
+    catch (std::exception& e)
+    {
+      std::cout << argv[i] << ": " << e.what() << "\n";
+      nErrors++;
+    }
+  }
+
+  return(nErrors);
+}
@@ -24,9 +24,6 @@
 #include "../../mod_misc/lib_conversions.h"
 
 
-#define RHO       1.225 // kg/m^3
-#define ETA_PROP  0.65
-
 Power::Propeller::Propeller() : Gearing()
 {
   omega_fold = 5;
@@ -119,34 +116,13 @@ void Power::Propeller::step(PowerValuesStep* values)
     double V_p = values->inputs->pitch * H * n;
     double V_X = values->VRelAir.r[0];
     filter.step(values->dt, V_p - V_X);
-    double F_X = M_PI * 0.25 * D*D * RHO * fabs(V_X + filter.val/2) * filter.val;
+    double F_X = force(D, V_X, filter.val);
   
     double P = F_X * (V_X + filter.val/2);
     double M = 0;
 
-    if (F_X > 0)
-    {
-      // Effective Translational Lift, see 
-      //   http://user.cs.tu-berlin.de/~calle/marvin/dissertation/aerodynamik.html
-      // This lift is 'for free', is does not mean more P or M!
-      // It is important to model this effect for helicopters, it is unimportant for
-      // fixed wing planes (but does no harm in this case).
-      float vw      = sqrt(values->VRelAir.r[1]*values->VRelAir.r[1] + values->VRelAir.r[2]*values->VRelAir.r[2]);
-      float x       = fabs(vw/V_p);
-      const float c = -0.20037;   
-      const float d = 0.0825119;  
-      const float e = -0.00997873;
-      
-      if (isfinite(x))
-      {
-        // I don't know about x>3. Maybe it will never happen, but limiting is save:
-        if (x>3)
-          x=3;
-        
-        float fact    = 1+c*(x*x)+d*(x*x*x)+e*(x*x*x*x);
-        F_X = F_X / fact;
-      }
-    }
+    float vw = sqrt(values->VRelAir.r[1]*values->VRelAir.r[1] + values->VRelAir.r[2]*values->VRelAir.r[2]);
+    F_X = translationalLift(F_X, vw, V_p);
     
     *values->force += mulForce * (F_X * ETA_PROP);
   
@@ -21,6 +21,7 @@
 #ifndef PROPELLER_H
 # define PROPELLER_H
 
+# include <math.h>
 # include "gearing.h"
 # include "values_step.h"
 # include "../../mod_math/pt1.h"
@@ -28,7 +29,17 @@
 
 namespace Power
 {
-   
+
+   /**
+    * Density of air used by the propeller [kg/m^3]
+    */
+   const double RHO      = 1.225;
+
+   /**
+    * Efficiency of the propeller
+    */
+   const double ETA_PROP = 0.65;
+
    /**
     * This class is part of the power system. To simply use the system, you should not
     * access or call any of its members. Please take a look at Power instead.
@@ -109,6 +120,8 @@ namespace Power
     */
    class Propeller : public Gearing
    {
+   friend class RotorBatch;
+
    public:
      
      /**
@@ -137,7 +150,50 @@ namespace Power
      virtual void step(PowerValuesStep* values);
      
      virtual void InitStates(CRRCMath::Vector3 vInitialVelocity, double& dOmega);
-     
+
+     /**
+      * Force created by a propeller of diameter D [N], without ETA_PROP.
+      * V_X is the airflow and dV the filtered difference between
+      * <tt>pitch * H * n</tt> and V_X [m/s]. Also used by RotorBatch.
+      */
+     static double force(double D, double V_X, double dV)
+     {
+       return(M_PI * 0.25 * D*D * RHO * fabs(V_X + dV/2) * dV);
+     };
+
+     /**
+      * Adds the effective translational lift to a force F_X from force().
+      * vw is the airflow perpendicular to the axis, V_p is
+      * <tt>pitch * H * n</tt> [m/s].
+      */
+     static double translationalLift(double F_X, float vw, double V_p)
+     {
+       if (F_X > 0)
+       {
+         // Effective Translational Lift, see
+         //   http://user.cs.tu-berlin.de/~calle/marvin/dissertation/aerodynamik.html
+         // This lift is 'for free', is does not mean more P or M!
+         // It is important to model this effect for helicopters, it is unimportant for
+         // fixed wing planes (but does no harm in this case).
+         float       x = fabs(vw/V_p);
+         const float c = -0.20037;
+         const float d = 0.0825119;
+         const float e = -0.00997873;
+
+         if (isfinite(x))
+         {
+           // I don't know about x>3. Maybe it will never happen, but limiting is save:
+           if (x>3)
+             x=3;
+
+           float fact = 1+c*(x*x)+d*(x*x*x)+e*(x*x*x*x);
+           F_X = F_X / fact;
+         }
+       }
+
+       return(F_X);
+     };
+
    private:
      
      /**
@@ -0,0 +1,352 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+#include "rotorbatch.h"
+
+#include <math.h>
+#include "battery.h"
+#include "shaft.h"
+#include "engine_dcm.h"
+#include "propeller.h"
+
+bool Power::RotorBatch::isSuitable(Power* power)
+{
+  if (power->batteries.size() != 1)
+    return(false);
+
+  Battery* bat = power->batteries[0];
+  if (bat->shafts.size() != 1)
+    return(false);
+
+  Shaft* shaft = bat->shafts[0];
+  if (shaft->gear.size() != 2)
+    return(false);
+
+  int nEngines    = 0;
+  int nPropellers = 0;
+  for (unsigned int n=0; n<shaft->gear.size(); n++)
+  {
+    if (dynamic_cast<Engine_DCM*>(shaft->gear[n]) != 0)
+      nEngines++;
+    else if (dynamic_cast<Propeller*>(shaft->gear[n]) != 0)
+      nPropellers++;
+  }
+
+  return(nEngines == 1 && nPropellers == 1);
+}
+
+Power::RotorBatch::RotorBatch(Power* proto, unsigned int nRotors, bool fSharedBattery)
+{
+  this->proto          = proto;
+  this->nRotors        = nRotors;
+  this->fSharedBattery = fSharedBattery;
+  nBatteries           = fSharedBattery ? 1 : nRotors;
+
+  Allocate();
+  CopyParams();
+  InitStates(CRRCMath::Vector3());
+
+  // Power::Power() starts with this value and it is never reset.
+  for (unsigned int n=0; n<nRotors; n++)
+    dVoltageAvg[n] = 1;
+}
+
+Power::RotorBatch::~RotorBatch()
+{
+  delete proto;
+}
+
+void Power::RotorBatch::Allocate()
+{
+  bat_C.resize(nBatteries);
+  bat_C_dot.resize(nBatteries);
+  bat_U.resize(nBatteries);
+  bat_capmin.resize(nBatteries);
+
+  thr_cmd.resize(nRotors);
+  throttle_old.resize(nRotors);
+  nUOffStatus.resize(nRotors);
+  U.resize(nRotors);
+  I.resize(nRotors);
+  omega.resize(nRotors);
+  omega_dot.resize(nRotors);
+  eng_throttle.resize(nRotors);
+  prop_filter.resize(nRotors);
+  prop_fFolded.resize(nRotors);
+  thrust.resize(nRotors);
+  torque.resize(nRotors);
+  dPropFreq.resize(nRotors);
+  dVoltageAvg.resize(nRotors);
+}
+
+void Power::RotorBatch::CopyParams()
+{
+  Battery* bat   = proto->batteries[0];
+  Shaft*   shaft = bat->shafts[0];
+
+  bat_C_0          = bat->C_0;
+  bat_R_I          = bat->R_I;
+  bat_U_off        = bat->U_off;
+  bat_throttle_min = bat->throttle_min;
+  bat_dInterpFact  = bat->dInterpFact;
+  bat_voltage      = bat->voltage;
+
+  shaft_J_inv  = shaft->J_inv;
+  shaft_fBrake = shaft->fBrake;
+
+  for (unsigned int n=0; n<shaft->gear.size(); n++)
+  {
+    Engine_DCM* eng  = dynamic_cast<Engine_DCM*>(shaft->gear[n]);
+    Propeller*  prop = dynamic_cast<Propeller*>(shaft->gear[n]);
+
+    if (eng != 0)
+    {
+      eng_i        = eng->i;
+      eng_R_I      = eng->R_I;
+      eng_M_r      = eng->M_r;
+      eng_k_r      = eng->k_r;
+      eng_k_M      = eng->k_M;
+      eng_rate_max = eng->throttle_rate_max;
+    }
+    else if (prop != 0)
+    {
+      prop_i          = prop->i;
+      prop_omega_fold = prop->omega_fold;
+      prop_H          = prop->H;
+      prop_D          = prop->D;
+      prop_mulForce   = prop->mulForce;
+      prop_mulMoment  = prop->mulMoment;
+      prop_dirThrust  = prop->dirThrust;
+    }
+  }
+}
+
+void Power::RotorBatch::ReloadParams(SimpleXMLTransfer* xml, int nVerbosity)
+{
+  proto->ReloadParams(xml, nVerbosity);
+  CopyParams();
+}
+
+void Power::RotorBatch::InitStates(CRRCMath::Vector3 vInitialVelocity)
+{
+  // Propeller::InitStates() tells the shaft about its initial speed
+  double dOmega = 0;
+  if (prop_omega_fold < 0)
+    dOmega = 2 * M_PI * vInitialVelocity.r[0] / prop_H;
+
+  for (unsigned int b=0; b<nBatteries; b++)
+  {
+    bat_U[b]      = bat_voltage[0];
+    bat_C[b]      = bat_C_0;
+    bat_C_dot[b]  = 0;
+    bat_capmin[b] = 1;
+  }
+
+  for (unsigned int n=0; n<nRotors; n++)
+  {
+    throttle_old[n] = 0;
+    nUOffStatus[n]  = 0;
+    omega[n]        = dOmega;
+    omega_dot[n]    = 0;
+    eng_throttle[n] = 0;
+    prop_filter[n]  = 0;
+    prop_fFolded[n] = 1;
+    thrust[n]       = 0;
+    torque[n]       = 0;
+    dPropFreq[n]    = 0;
+  }
+}
+
+void Power::RotorBatch::step(double dt, const float* throttle, float pitch, CRRCMath::Vector3 VRelAir)
+{
+  // Same as in Power::step(): two steps of dt/2.
+  const int    mul = 2;
+  const double h   = dt/mul;
+  const double V_X = VRelAir.r[0];
+  const float  vw  = sqrt(VRelAir.r[1]*VRelAir.r[1] + VRelAir.r[2]*VRelAir.r[2]);
+
+  for (unsigned int b=0; b<nBatteries; b++)
+    bat_capmin[b] = 1;
+
+  for (unsigned int n=0; n<nRotors; n++)
+    thr_cmd[n] = throttle[n];
+
+  for (int m=0; m<mul; m++)
+  {
+    // --- Battery: throttle_min and low voltage cut off -----------------
+    for (unsigned int n=0; n<nRotors; n++)
+    {
+      unsigned int b   = fSharedBattery ? 0 : n;
+      double       thr = thr_cmd[n];
+
+      if (thr < bat_throttle_min && throttle_old[n] > 0)
+      {
+        thr        = bat_throttle_min;
+        thr_cmd[n] = bat_throttle_min;
+      }
+      throttle_old[n] = thr;
+
+      if (bat_U[b] < bat_U_off || bat_C[b] <= 0 || nUOffStatus[n] == 1)
+      {
+        if (nUOffStatus[n] == 1 && thr < 0.05)
+          nUOffStatus[n] = 0;
+        else
+          nUOffStatus[n] = 1;
+        U[n] = 0;
+      }
+      else
+        U[n] = bat_U[b];
+    }
+
+    // --- Shaft, engine and propeller of every rotor --------------------
+    // See Shaft::step(), Engine_DCM::step() and Propeller::step().
+    for (unsigned int n=0; n<nRotors; n++)
+    {
+      double Un = U[n];
+
+      // engine: limit throttle change and value
+      double thr_e;
+      if (Un < 0.01)
+        thr_e = 0;
+      else
+      {
+        double in   = thr_cmd[n] > 1 ? 1 : thr_cmd[n];
+        double dmax = eng_rate_max * h;
+        double diff = in - eng_throttle[n];
+        if (diff > dmax)
+          diff = dmax;
+        else if (diff < -dmax)
+          diff = -dmax;
+        thr_e = eng_throttle[n] + diff;
+      }
+      eng_throttle[n] = thr_e;
+
+      double om_e = eng_i*omega[n];
+      double I_M  = Engine_DCM::current(thr_e, Un, om_e, eng_k_M, eng_R_I);
+      double M_M  = Engine_DCM::moment(I_M, om_e, eng_k_M, eng_k_r, eng_M_r);
+
+      double moment_shaft = M_M*eng_i;
+      I[n] = (I_M > 0) ? I_M * thr_e : 0;
+
+      // propeller
+      double om_p = prop_i*omega[n];
+      double rps  = om_p/(2*M_PI);
+      double M    = 0;
+
+      if (om_p < prop_omega_fold && prop_omega_fold > 0)
+      {
+        prop_fFolded[n] = 1;
+        dPropFreq[n]    = 0;
+        thrust[n]       = 0;
+      }
+      else
+      {
+        prop_fFolded[n] = 0;
+        dPropFreq[n]    = rps;
+
+        double V_p = pitch * prop_H * rps;
+        double f   = prop_filter[n];
+        f += ((V_p - V_X) - f)*1.0;   // PT1 with tau=0
+        prop_filter[n] = f;
+
+        double F_X = Propeller::force(prop_D, V_X, f);
+        double P   = F_X * (V_X + f/2);
+
+        thrust[n] = Propeller::translationalLift(F_X, vw, V_p) * ETA_PROP;
+
+        if (fabs(om_p) > 1E-5)
+          M = P/om_p * prop_i;
+      }
+      torque[n]     = M;
+      moment_shaft -= M;
+
+      // shaft
+      if ( (thr_cmd[n] < 0.05 || Un < 0.01) && shaft_fBrake)
+      {
+        omega[n]     = 0;
+        omega_dot[n] = 0;
+      }
+      else
+      {
+        double omega_dot_new = moment_shaft*shaft_J_inv;
+        omega[n]     = omega[n] + (omega_dot_new*3 - omega_dot[n])*0.5*h;
+        omega_dot[n] = omega_dot_new;
+      }
+    }
+
+    // --- Batteries: capacity and voltage -------------------------------
+    int idxmax = ((bat_voltage.size()-1)<<10)-1;
+    for (unsigned int b=0; b<nBatteries; b++)
+    {
+      double I_bat;
+      if (fSharedBattery)
+      {
+        I_bat = 0;
+        for (unsigned int n=0; n<nRotors; n++)
+          I_bat += I[n];
+      }
+      else
+        I_bat = I[b];
+
+      double C_dot = -1*I_bat;
+      bat_C[b]     = bat_C[b] + (C_dot*3 - bat_C_dot[b])*0.5*h;
+      bat_C_dot[b] = C_dot;
+      if (bat_C[b] < 0)
+      {
+        bat_C[b]     = 0;
+        bat_C_dot[b] = 0;
+      }
+
+      double dCapLeftRel = bat_C[b]/bat_C_0;
+      if (bat_capmin[b] > dCapLeftRel)
+        bat_capmin[b] = dCapLeftRel;
+
+      int idx = (int)(bat_dInterpFact * (bat_C_0-bat_C[b]));
+      if (idx > idxmax)
+        idx = idxmax;
+      int idxh = idx >> 10;
+      int idxl = idx & ((1<<10)-1);
+
+      bat_U[b]  = bat_voltage[idxh] + (idxl * (bat_voltage[idxh+1]-bat_voltage[idxh]))*(1.0/1024);
+      bat_U[b] -= bat_R_I * I_bat;
+    }
+  }
+
+  for (unsigned int n=0; n<nRotors; n++)
+    dVoltageAvg[n] = U[n];
+}
+
+CRRCMath::Vector3 Power::RotorBatch::getForce(unsigned int n) const
+{
+  return(prop_mulForce * thrust[n]);
+}
+
+CRRCMath::Vector3 Power::RotorBatch::getMoment(unsigned int n) const
+{
+  return(prop_dirThrust * torque[n] + prop_mulMoment * thrust[n]);
+}
+
+double Power::RotorBatch::getBatteryMin() const
+{
+  double min = 1;
+  for (unsigned int b=0; b<nBatteries; b++)
+    if (min > bat_capmin[b])
+      min = bat_capmin[b];
+  return(min);
+}
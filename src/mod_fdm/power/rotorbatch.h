@@ -0,0 +1,226 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+#ifndef ROTORBATCH_H
+# define ROTORBATCH_H
+
+# include <vector>
+# include "../../mod_misc/SimpleXMLTransfer.h"
+# include "../../mod_math/vector3.h"
+# include "power.h"
+
+namespace Power
+{
+
+  /**
+   * Evaluates a number of identical power systems at once.
+   *
+   * A multicopter has one power system per rotor and all of them are
+   * built from the same description. Instead of stepping one Power
+   * object per rotor (each of them walking its own tree of batteries,
+   * shafts and gears through virtual calls), this class keeps the
+   * parameters once and the states of all rotors in plain arrays
+   * (structure of arrays). One step is a couple of loops over the
+   * rotors which the compiler is able to vectorize.
+   *
+   * Only the simple layout is supported:
+   \verbatim
+   <power>
+     <battery ...>
+       <shaft ...>
+         <engine ... />
+         <propeller ... />
+       </shaft>
+     </battery>
+   </power>
+   \endverbatim
+   * Use isSuitable() to find out whether a system can be batched. The
+   * results are the same as the ones of Power::step(), bit by bit.
+   *
+   * By default every rotor has a battery of its own, just like a list of
+   * Power objects. If <tt>fSharedBattery</tt> is set, all engines are
+   * connected to one battery; its parameters then describe the whole pack.
+   */
+  class RotorBatch
+  {
+    public:
+
+     /**
+      * Returns true if the system consists of exactly one battery, one
+      * shaft, one Engine_DCM and one Propeller.
+      */
+     static bool isSuitable(Power* power);
+
+     /**
+      * Creates the batch. It takes ownership of <tt>proto</tt>, which is
+      * used to read the parameters of all rotors.
+      *
+      * @param proto          a power system for which isSuitable() is true
+      * @param nRotors        number of rotors
+      * @param fSharedBattery if true, all rotors drain the same battery
+      */
+     RotorBatch(Power* proto, unsigned int nRotors, bool fSharedBattery = false);
+
+     ~RotorBatch();
+
+     /**
+      * Reloads the parameters, see Power::ReloadParams().
+      */
+     void ReloadParams(SimpleXMLTransfer* xml, int nVerbosity = 3);
+
+     /**
+      * Resets battery status, initialize states
+      */
+     void InitStates(CRRCMath::Vector3 vInitialVelocity);
+
+     /**
+      * Go ahead dt seconds in the simulation. This does the same as
+      * calling Power::step() for every rotor.
+      *
+      * @param dt       timestep [s]
+      * @param throttle throttle command of every rotor (float, like TSimInputs)
+      * @param pitch    pitch command (the same for all rotors)
+      * @param VRelAir  Velocity of power system relative to airmass, [m/s].
+      */
+     void step(double dt, const float* throttle, float pitch, CRRCMath::Vector3 VRelAir);
+
+     /**
+      * Number of rotors
+      */
+     unsigned int size() const { return(nRotors); };
+
+     /**
+      * Force created by rotor n during the last step [N] (body axes).
+      */
+     CRRCMath::Vector3 getForce(unsigned int n) const;
+
+     /**
+      * Torque created by rotor n during the last step [Nm] (body axes).
+      */
+     CRRCMath::Vector3 getMoment(unsigned int n) const;
+
+     /**
+      * Returns revolutions per second of the propeller of rotor n [1/s].
+      */
+     double getPropFreq(unsigned int n) const { return(dPropFreq[n]); };
+
+     /**
+      * Returns voltage seen by rotor n during the last step, see
+      * Power::GetVoltageAvg().
+      */
+     double GetVoltageAvg(unsigned int n) const { return(dVoltageAvg[n]); };
+
+     /**
+      * Returns lowest relative battery capacity left (0..1).
+      */
+     double getBatteryMin() const;
+
+     bool isSharedBattery() const { return(fSharedBattery); };
+
+    private:
+
+     /**
+      * Copies the parameters from the prototype.
+      */
+     void CopyParams();
+
+     /**
+      * Resizes all state arrays.
+      */
+     void Allocate();
+
+     Power*       proto;
+     unsigned int nRotors;
+     bool         fSharedBattery;
+
+     /**
+      * Number of batteries: 1 or nRotors
+      */
+     unsigned int nBatteries;
+
+     /// @name parameters, see Battery, Shaft, Engine_DCM and Propeller
+     //@{
+     double              bat_C_0;
+     double              bat_R_I;
+     double              bat_U_off;
+     double              bat_throttle_min;
+     double              bat_dInterpFact;
+     std::vector<double> bat_voltage;
+
+     double shaft_J_inv;
+     bool   shaft_fBrake;
+
+     double eng_i;
+     double eng_R_I;
+     double eng_M_r;
+     double eng_k_r;
+     double eng_k_M;
+     double eng_rate_max;
+
+     double            prop_i;
+     double            prop_omega_fold;
+     double            prop_H;
+     double            prop_D;
+     CRRCMath::Vector3 prop_mulForce;
+     CRRCMath::Vector3 prop_mulMoment;
+     CRRCMath::Vector3 prop_dirThrust;
+     //@}
+
+     /// @name states of the batteries [nBatteries]
+     //@{
+     std::vector<double> bat_C;
+     std::vector<double> bat_C_dot;
+     std::vector<double> bat_U;
+     std::vector<double> bat_capmin;
+     //@}
+
+     /// @name states and temporary values of the rotors [nRotors]
+     //@{
+     /**
+      * throttle command, may be changed by throttle_min
+      */
+     std::vector<float>  thr_cmd;
+     std::vector<double> throttle_old;
+     std::vector<int>    nUOffStatus;
+     /**
+      * voltage seen by the engine
+      */
+     std::vector<double> U;
+     /**
+      * current drawn from the battery
+      */
+     std::vector<double> I;
+     std::vector<double> omega;
+     std::vector<double> omega_dot;
+     std::vector<double> eng_throttle;
+     std::vector<double> prop_filter;
+     std::vector<int>    prop_fFolded;
+     /**
+      * thrust F_X*ETA_PROP and shaft torque of the propeller
+      */
+     std::vector<double> thrust;
+     std::vector<double> torque;
+     std::vector<double> dPropFreq;
+     std::vector<double> dVoltageAvg;
+     //@}
+  };
+
+}
+
+#endif
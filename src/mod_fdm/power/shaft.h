@@ -55,6 +55,8 @@ namespace Power
    */
   class Shaft
   {
+    friend class RotorBatch;
+
     public:
      
      /**
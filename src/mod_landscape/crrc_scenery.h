@@ -126,6 +126,25 @@ class Scenery
      *  \return terrain height at this point in ft
      */
     virtual float getHeightAndPlane(float x, float z, float tplane[4]) = 0;
+
+    /**
+     *  get height and plane equation at x|z and the region around x|z
+     *  in which the plane is valid, see HeightData::getHeightAndPatch().
+     *  The default implementation doesn't know about such a region.
+     *  \param x x coordinate
+     *  \param z z coordinate
+     *  \param tplane this is where the plane equation will be stored
+     *  \param tri    corners of the triangle, tri[n][0] is x, tri[n][1] is z
+     *  \param rect   rectangle: x min, x max, z min, z max
+     *  \param fPatch will be set to true if tri and rect are valid
+     *  \return terrain height at this point in ft
+     */
+    virtual float getHeightAndPatch(float x, float z, float tplane[4],
+                                    float tri[3][2], float rect[4], bool& fPatch)
+    {
+      fPatch = false;
+      return(getHeightAndPlane(x, z, tplane));
+    };
     
     /**
      * get  wind on  directions  at position  X_cg, Y_cg,Z_cg
@@ -20,9 +20,22 @@
  */
 
 #include "hd_tilingterrain.h"
+#include <float.h>
 
 #define DEEPEST_HELL  -9999.0
 
+/**
+ * A patch ends this far [ft] from the border of its cell, so
+ * rounding can't move a point inside of it to another cell.
+ */
+#define HD_PATCH_MARGIN  0.01
+
+/**
+ * Triangles which overlap by less than this [ft] don't overlap.
+ * This makes sure that neighbours sharing an edge don't overlap.
+ */
+#define HD_PATCH_EPS     0.001
+
 
 HD_TilingTerrain::HD_TilingTerrain(ssgRoot * SceneGraph)
 {
@@ -58,14 +71,87 @@ float HD_TilingTerrain::getHeight(float x_north, float y_east)
 }
 
 float HD_TilingTerrain::getHeightAndPlane(float x_north, float y_east, float tplane[4])
+{
+  int ix, jy, numero;
+
+  return findTriangle(x_north, y_east, ix, jy, numero, tplane);
+}
+
+float HD_TilingTerrain::getHeightAndPatch(float x_north, float y_east, float tplane[4],
+                                          float tri[3][2], float rect[4], bool& fPatch)
+{
+  int    ix, jy, numero;
+  sgVec4 plane;
+  float  hot = findTriangle(x_north, y_east, ix, jy, numero, plane);
+
+  if (tplane)
+    sgCopyVec4(tplane, plane);
+
+  fPatch = false;
+  if (numero < 0)
+    return hot;
+
+  ssgVertexArray* tile = tile_table[ix][jy];
+  float* p[3];
+  p[0] = tile->get(numero);
+  p[1] = tile->get(numero+1);
+  p[2] = tile->get(numero+2);
+
+  // The highest triangle has been found at x|y. Somewhere else in this
+  // cell, another overlapping triangle might be higher. The difference
+  // of both planes is linear, so it is enough to look at the corners.
+  int n = tile->getNum();
+  for ( int i = 0 ; i < n ; i+=3 )
+  {
+    if (i == numero)
+      continue;
+
+    float *q1 = tile->get(i);
+    float *q2 = tile->get(i+1);
+    float *q3 = tile->get(i+2);
+    if (!overlap(p[0], p[1], p[2], q1, q2, q3))
+      continue;
+
+    sgVec4 qplane;
+    sgMakePlane ( qplane, q1, q2, q3);
+    if (qplane[1] == 0)
+      continue; // vertical, never found by on_triangle()
+
+    for (int c=0; c<3; c++)
+    {
+      float h = -(qplane[0]*p[c][0] + qplane[2]*p[c][2] + qplane[3]) / qplane[1];
+      if (!(h <= p[c][1]))
+        return hot;
+    }
+  }
+
+  float elo, ehi, slo, shi;
+  cellRange(ix, elo, ehi);
+  cellRange(jy, slo, shi);
+  rect[0] = -shi;
+  rect[1] = -slo;
+  rect[2] = elo;
+  rect[3] = ehi;
+  for (int c=0; c<3; c++)
+  {
+    tri[c][0] = -p[c][2];
+    tri[c][1] = p[c][0];
+  }
+  fPatch = true;
+
+  return hot;
+}
+
+float HD_TilingTerrain::findTriangle(float x_north, float y_east, int& ix, int& jy,
+                                     int& numero, float tplane[4])
 {
   float h,hot ;   /* H.O.T == Height Of Terrain */
 
   float   *p1,*p2,*p3;
-  int numero=-1;
+  numero=-1;
 
-  int ix = (int)(y_east/SIZE_CELL_GRID_PLANES) + SIZE_GRID_PLANES/2;
-  int jy = (int)(-x_north/SIZE_CELL_GRID_PLANES) + SIZE_GRID_PLANES/2;
+  ix = (int)(y_east/SIZE_CELL_GRID_PLANES) + SIZE_GRID_PLANES/2;
+  jy = (int)(-x_north/SIZE_CELL_GRID_PLANES) + SIZE_GRID_PLANES/2;
   if (ix<0) ix=0;
   if (ix>SIZE_GRID_PLANES)ix = SIZE_GRID_PLANES;
   if (jy<0) jy=0;
@@ -284,3 +370,50 @@ int HD_TilingTerrain::on_triangle(float x, float y, float *p1,float *p2,float *p
   test =  (t1==t2) && (t1==t3);
   return test;
 }
+
+// range of coordinates which end up in cell k (see findTriangle()), the
+// cell in the middle is twice as large, the outer ones are endless
+void HD_TilingTerrain::cellRange(int k, float& lo, float& hi)
+{
+  int q = k - SIZE_GRID_PLANES/2;
+
+  lo = (q <= 0 ? q-1 : q) * SIZE_CELL_GRID_PLANES + HD_PATCH_MARGIN;
+  hi = (q >= 0 ? q+1 : q) * SIZE_CELL_GRID_PLANES - HD_PATCH_MARGIN;
+  if (k <= 0)
+    lo = -FLT_MAX;
+  if (k >= SIZE_GRID_PLANES)
+    hi = FLT_MAX;
+}
+
+// separating axis test of the projections of two triangles on the
+// horizontal plane, the axes are the normals of the edges
+int HD_TilingTerrain::overlap(float *a1, float *a2, float *a3, float *b1, float *b2, float *b3)
+{
+  float* a[3] = { a1, a2, a3 };
+  float* b[3] = { b1, b2, b3 };
+
+  for (int t=0; t<2; t++)
+  {
+    float** e = (t == 0) ? a : b;
+    for (int i=0; i<3; i++)
+    {
+      float nx = e[(i+1)%3][2] - e[i][2];
+      float nz = e[i][0] - e[(i+1)%3][0];
+      float amin =  FLT_MAX, amax = -FLT_MAX;
+      float bmin =  FLT_MAX, bmax = -FLT_MAX;
+      for (int k=0; k<3; k++)
+      {
+        float da = nx*a[k][0] + nz*a[k][2];
+        float db = nx*b[k][0] + nz*b[k][2];
+        if (da < amin) amin = da;
+        if (da > amax) amax = da;
+        if (db < bmin) bmin = db;
+        if (db > bmax) bmax = db;
+      }
+      float eps = HD_PATCH_EPS * sqrt(nx*nx + nz*nz);
+      if (amax <= bmin + eps || bmax <= amin + eps)
+        return 0;
+    }
+  }
+  return 1;
+}
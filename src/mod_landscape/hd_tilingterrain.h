@@ -62,8 +62,42 @@ class HD_TilingTerrain : public HeightData
      *  \return terrain height at this point in ft
      */
     float getHeightAndPlane(float x_north, float y_east, float tplane[4]);
+
+    /**
+     *  Get height, plane equation and the region in which this plane is
+     *  valid. The region is the triangle below x|y, clipped to its cell
+     *  of the grid. If another triangle of the cell overlaps and might be
+     *  higher somewhere in this region, there is no region.
+     *
+     *  \see HeightData::getHeightAndPatch()
+     */
+    float getHeightAndPatch(float x_north, float y_east, float tplane[4],
+                            float tri[3][2], float rect[4], bool& fPatch);
     
   private:
+    /**
+     *  Finds the highest triangle below x|y.
+     *
+     *  \param ix      returns index of cell in east direction
+     *  \param jy      returns index of cell in south direction
+     *  \param numero  returns index of the first vertex of the triangle
+     *                 in the cell or -1 if no triangle has been found
+     *  \param tplane  if not NULL, the plane equation will be stored here
+     *  \return terrain height at this point in ft
+     */
+    float findTriangle(float x_north, float y_east, int& ix, int& jy, int& numero, float tplane[4]);
+
+    /**
+     *  Range of coordinates (east or south) which lead to cell index k.
+     */
+    void cellRange(int k, float& lo, float& hi);
+
+    /**
+     *  Returns true if the horizontal projections of the two triangles
+     *  overlap. Triangles which only share an edge don't overlap.
+     */
+    int overlap(float *a1, float *a2, float *a3, float *b1, float *b2, float *b3);
+
     void tiling_terrain(ssgEntity * e, sgMat4 xform);
 
     // test si point x,y, dans la projection du trianle p1, p2,p3 
@@ -70,6 +70,29 @@ class HeightData
      *  \return terrain height at this point in ft
      */
     virtual float getHeightAndPlane(float x_north, float y_east, float tplane[4]) = 0;
+
+    /**
+     *  Like getHeightAndPlane(), but also returns a region around x|y in
+     *  which the height is given by the same plane: the intersection of
+     *  a triangle and a rectangle. For every point inside of the region
+     *  (borders excluded) getHeight() would return the height of the plane.
+     *
+     *  The default implementation doesn't know about such a region.
+     *
+     *  \param x_north  x coordinate (x positive == north)
+     *  \param y_east   y coordinate (y positive == east)
+     *  \param tplane   this is where the plane equation will be stored
+     *  \param tri      corners of the triangle, tri[n][0] north, tri[n][1] east
+     *  \param rect     rectangle: north min, north max, east min, east max
+     *  \param fPatch   will be set to true if tri and rect are valid
+     *  \return terrain height at this point in ft
+     */
+    virtual float getHeightAndPatch(float x_north, float y_east, float tplane[4],
+                                    float tri[3][2], float rect[4], bool& fPatch)
+    {
+      fPatch = false;
+      return(getHeightAndPlane(x_north, y_east, tplane));
+    }
 };
 
 
@@ -48,9 +48,15 @@
 
 // This module uses some internal SSG stuff from the video module!
 #include "../mod_video/crrc_ssgutils.h"
+#include "../mod_video/asset_cache.h"
+#include "../mod_video/ssg_partition.h"
 
 const float FEET2METERS=0.3048;
 
+/// default distance beyond which objects which are not part of the
+/// terrain are left away, in multiples of their radius
+const float LOD_RANGE_FACTOR=1000;
+
 
 /****************************************************************************/
 /* Model based scenery                                                      */
@@ -61,6 +67,7 @@ ModelBasedScenery::ModelBasedScenery(SimpleXMLTransfer *xml, int sky_variant)
   ssgEntity *model = NULL;
   SimpleXMLTransfer *scene = xml->getChild("scene", true);
   getHeight_mode = scene->attributeAsInt("getHeight_mode", 2);
+  int partition  = scene->attributeAsInt("partition", 2000);
   //std::cout << "----getHeight_mode : " <<  getHeight_mode <<std::endl;
   SceneGraph = new ssgRoot();
 
@@ -103,6 +110,7 @@ ModelBasedScenery::ModelBasedScenery(SimpleXMLTransfer *xml, int sky_variant)
       std::string filename = kid->attribute("filename", "not_specified");
       bool is_terrain = (kid->attributeAsInt("terrain", 1) != 0);
       bool is_visible = (kid->attributeAsInt("visible", 1) != 0);
+      float lod_range = kid->attributeAsDouble("lod_range", -1);
 
       // PLIB automatically loads the texture file,
       // but it does not know which directory to use.
@@ -110,7 +118,6 @@ ModelBasedScenery::ModelBasedScenery(SimpleXMLTransfer *xml, int sky_variant)
       std::string    of  = FileSysTools::getDataPath("objects/" + filename, TRUE);
       // compile and set relative texture path
       std::string    tp  = of.substr(0, of.length()-filename.length()-1-7) + "textures";
-      ssgTexturePath(tp.c_str());
 
       // load model
       std::cout << "Loading 3D object \"" << of.c_str() << "\"";
@@ -123,7 +130,8 @@ ModelBasedScenery::ModelBasedScenery(SimpleXMLTransfer *xml, int sky_variant)
         std::cout << " (invisible)";
       }
       std::cout << std::endl;
-      model = ssgLoad(of.c_str());
+      // the model is changed below, so only its textures are shared
+      model = Video::loadModelUncached(of, tp);
       if (model != NULL)
       {
         if (!is_visible)
@@ -135,6 +143,22 @@ ModelBasedScenery::ModelBasedScenery(SimpleXMLTransfer *xml, int sky_variant)
         // integrated collision boxes). Parse these attributes now.
         evaluateNodeAttributes(model);
         
+        // Rebuild the geometry as a hierarchy of small parts, so that
+        // only the parts in view are drawn.
+        if (partition > 0)
+        {
+          ssgEntity *parts = SSGUtil::makePartitionedModel(model, partition);
+          ssgDeRefDelete(model);
+          model = parts;
+        }
+        
+        // Objects which are not part of the terrain are left away at
+        // a distance. The terrain has to stay in the scene graph for
+        // the height calculations.
+        if (lod_range < 0)
+        {
+          lod_range = model->getBSphere()->getRadius() * LOD_RANGE_FACTOR;
+        }
         
         // now parse the instances and place the model in the SceneGraph
         for (int cur_instance = 0; cur_instance < kid->getChildCount(); cur_instance++)
@@ -196,7 +220,18 @@ ModelBasedScenery::ModelBasedScenery(SimpleXMLTransfer *xml, int sky_variant)
               trans->clrTraversalMaskBits(SSGTRAV_CULL);
             }
             initial_trans->addKid(trans);
-            trans->addKid(model);
+            if (!is_terrain && lod_range > 0)
+            {
+              float ranges[2] = { 0, lod_range };
+              ssgRangeSelector *lod = new ssgRangeSelector();
+              lod->setRanges(ranges, 2);
+              trans->addKid(lod);
+              lod->addKid(model);
+            }
+            else
+            {
+              trans->addKid(model);
+            }
           }
         }
       }
@@ -414,6 +449,18 @@ float ModelBasedScenery::getHeightAndPlane(float x, float y, float tplane[4])
   }
 }
 
+float ModelBasedScenery::getHeightAndPatch(float x, float y, float tplane[4],
+                                           float tri[3][2], float rect[4], bool& fPatch)
+{
+  if (getHeight_mode==2)
+    return(heightdata->getHeightAndPatch(x, y, tplane, tri, rect, fPatch));
+
+  // the table (mode 1) interpolates between planes and ssgLOS (mode 0)
+  // doesn't tell about other objects near x|y
+  fPatch = false;
+  return(getHeightAndPlane(x, y, tplane));
+}
+
 float ModelBasedScenery::getHeightAndPlane_(float x_north, float y_east, float tplane[4])
 {
   ssgHit *results ;
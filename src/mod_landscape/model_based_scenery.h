@@ -81,6 +81,13 @@ class ModelBasedScenery : public Scenery
      *  \return terrain height at this point in ft
      */
     float getHeightAndPlane(float x, float z, float tplane[4]);
+
+    /**
+     *  get height, plane equation and the region in which the plane is
+     *  valid. Only getHeight_mode 2 knows about such regions.
+     */
+    float getHeightAndPatch(float x, float z, float tplane[4],
+                            float tri[3][2], float rect[4], bool& fPatch);
     
     /**
      *  Get an ID code for this location or scenery type
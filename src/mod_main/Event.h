@@ -22,6 +22,8 @@
 #ifndef EVENT_H_
 #define EVENT_H_
 
+#include <string>
+
 //#define DEBUG_CLASS_EVENT
 
 /** Base class for events
@@ -29,8 +31,10 @@
  *  All events are instances of classes that are derived
  *  from this base class. Common features for events:
  *
- *  - Each event belongs to an event group. Event receivers
- *    may choose only to receive events from certain groups.
+ *  - Each event belongs to an event group.
+ *  - Event receivers register for one event class with
+ *    EventBus (see EventBus.h) and receive only events of
+ *    exactly this class.
  *  - Each event has a certain type, e.g. the group of
  *    Joystick events may contain JoystickButton events,
  *    JoystickMovement events and so on.
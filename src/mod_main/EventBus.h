@@ -0,0 +1,249 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+/**
+ *  \file EventBus.h
+ *
+ *  \brief Typed distribution of events
+ *
+ *  Every event class has its own list of listeners, so raising an
+ *  event only calls the listeners which want to receive exactly this
+ *  type of event, without filtering and without casts. Events are
+ *  passed by reference and usually live on the stack of the sender.
+ *
+ *  Events which are sent more often than the listeners need them
+ *  (like the input values) can be posted instead of raised: a posted
+ *  event is copied into a single slot, a later one overwrites it, and
+ *  the last one is delivered by flush().
+ *
+ *  Example:
+ *
+ *    \code
+ *    class FooEventReceiver
+ *    {
+ *      public:
+ *        FooEventReceiver();
+ *        void myCallback(const CrashEvent& ev);
+ *
+ *      private:
+ *        EventAdapter<FooEventReceiver, CrashEvent> m_EventAdapter;
+ *    };
+ *
+ *    FooEventReceiver::FooEventReceiver()
+ *    : m_EventAdapter(this, &FooEventReceiver::myCallback)
+ *    {
+ *    }
+ *
+ *    ...
+ *    CrashEvent ev;
+ *    EventBus<CrashEvent>::raise(ev);
+ *    \endcode
+ */
+
+#ifndef EVENT_BUS_H_
+#define EVENT_BUS_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "Event.h"
+
+
+template < class T > class EventListener;
+
+
+/**
+ *  \brief Listeners and pending event of one event type
+ *
+ *  All methods are static, there is one list of listeners per event
+ *  type. The lists are function-local statics, so they are ready
+ *  for listeners which are constructed during static initialization.
+ */
+template < class T >
+class EventBus
+{
+  public:
+    /// Deliver an event to all listeners of its type now
+    static void raise(const T& ev)
+    {
+      std::vector< EventListener<T>* >& listeners = getListeners();
+      T_Raise                           r;
+
+      // a listener might register or unregister itself or others,
+      // so the size is checked every time and unregisterListener()
+      // moves r.n back if a listener before it is removed
+      for (r.n = 0; r.n < (int)listeners.size(); r.n++)
+        (*listeners[r.n])(ev);
+    }
+
+    /// Store an event for flush(), overwriting one which has been
+    /// posted before and not delivered yet
+    static void post(const T& ev)
+    {
+      getPending().ev       = ev;
+      getPending().fPending = true;
+    }
+
+    /// Deliver the last posted event, if there is one
+    static void flush()
+    {
+      if (getPending().fPending)
+      {
+        getPending().fPending = false;
+        raise(getPending().ev);
+      }
+    }
+
+    /// Number of listeners for this event type
+    static int getListenerCount()
+    {
+      return getListeners().size();
+    }
+
+    static bool registerListener(EventListener<T>* listener)
+    {
+      std::vector< EventListener<T>* >& listeners = getListeners();
+
+      for (unsigned int n = 0; n < listeners.size(); n++)
+        if (listeners[n] == listener)
+          return false;
+
+      listeners.push_back(listener);
+      return true;
+    }
+
+    static bool unregisterListener(EventListener<T>* listener)
+    {
+      std::vector< EventListener<T>* >& listeners = getListeners();
+
+      for (unsigned int n = 0; n < listeners.size(); n++)
+      {
+        if (listeners[n] == listener)
+        {
+          listeners.erase(listeners.begin() + n);
+
+          // raise() continues with the listener after the current one
+          for (T_Raise* r = getActive(); r != NULL; r = r->outer)
+            if ((int)n <= r->n)
+              r->n--;
+          return true;
+        }
+      }
+      return false;
+    }
+
+  private:
+    typedef struct
+    {
+      T    ev;
+      bool fPending;
+    } T_Pending;
+
+    /// Position of a raise() which is running. Nested raises of the
+    /// same type form a list, so all of them can be corrected.
+    class T_Raise
+    {
+      public:
+        T_Raise() : n(0), outer(getActive()) { getActive() = this; }
+        ~T_Raise()                           { getActive() = outer; }
+
+        int      n;       ///< index of the listener being called
+        T_Raise* outer;   ///< the raise() this one is nested in
+    };
+
+    static T_Raise*& getActive()
+    {
+      static T_Raise* active = NULL;
+      return active;
+    }
+
+    static std::vector< EventListener<T>* >& getListeners()
+    {
+      static std::vector< EventListener<T>* > listeners;
+      return listeners;
+    }
+
+    static T_Pending& getPending()
+    {
+      static T_Pending pending = { T(), false };
+      return pending;
+    }
+};
+
+
+/**
+ *  \brief Abstract base class for receivers of events of type T
+ *
+ *  Registers itself with EventBus<T> on construction and unregisters
+ *  on destruction. Derive from it and implement
+ *  void operator()(const T&), or use EventAdapter.
+ */
+template < class T >
+class EventListener
+{
+  public:
+    EventListener()
+    {
+      EventBus<T>::registerListener(this);
+    }
+
+    virtual ~EventListener()
+    {
+      EventBus<T>::unregisterListener(this);
+    }
+
+    /// This is the actual callback function that is called if
+    /// an event is received.
+    virtual void operator()(const T& ev) = 0;
+};
+
+
+/**
+ *  \brief Template for building EventListener adapter classes
+ *
+ *  Use it if direct inheritance from EventListener is not feasible,
+ *  for example because a class wants to receive several types of
+ *  events: add a callback method and a member of type
+ *  EventAdapter<myClass, myEvent> and initialize it with a pointer
+ *  to the current instance and the callback method.
+ */
+template < class Class, class T >
+class EventAdapter : public EventListener<T>
+{
+  public:
+    typedef void (Class::*CallBackMethod)(const T& ev);
+
+    EventAdapter(Class* instance, CallBackMethod method)
+    {
+      instance_  = instance;
+      callback_  = method;
+    };
+
+    void operator()(const T& ev)
+    {
+      (instance_->*callback_)(ev);
+    };
+
+  private:
+    Class*          instance_;
+    CallBackMethod  callback_;
+};
+
+#endif // EVENT_BUS_H_
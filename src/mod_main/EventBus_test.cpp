@@ -0,0 +1,343 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+/**
+ * \file EventBus_test.cpp
+ *
+ * Compares the EventBus to the way the EventDispatcher used to
+ * deliver events: one list of all listeners, each of them with a
+ * group mask, and a dynamic_cast in every animation callback.
+ *
+ * Usage: eventbus_test [-n frames] [-s surfaces] [-u updates]
+ *
+ * A number of control surface animations (default 128) listen to
+ * AxisUpdateEvent, a console listens to LogMessageEvent and the
+ * simulation listens to CrashEvent. Every frame raises a few axis
+ * updates (default 4) with different values. They are delivered
+ * the old way, raised on the EventBus, and posted on the EventBus
+ * with one flush per frame. After every frame all surfaces must
+ * have the values of the last update.
+ *
+ * Finally listeners unregister themselves and others while a crash
+ * event is raised, all remaining listeners still have to be called.
+ *
+ * The CPU time per frame is printed for all versions. The return
+ * value is the number of frames with wrong values.
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <vector>
+
+#include "EventBus.h"
+
+
+// --- the old dispatcher ----------------------------------
+
+class OldListener
+{
+  public:
+    virtual ~OldListener() {}
+    virtual void operator()(const Event* ev) = 0;
+};
+
+typedef struct
+{
+  OldListener*  theListener;
+  unsigned long ulGroupMask;
+} T_ListenerContainer;
+
+static std::deque< T_ListenerContainer > oldListeners;
+
+static void old_register(OldListener* listener, unsigned long ulGroups)
+{
+  T_ListenerContainer LC;
+  LC.theListener = listener;
+  LC.ulGroupMask = ulGroups;
+  oldListeners.push_back(LC);
+}
+
+static void old_raise(const Event* ev)
+{
+  std::deque< T_ListenerContainer >::const_iterator it = oldListeners.begin();
+  while (it != oldListeners.end())
+  {
+    if (((*it).ulGroupMask & ev->getGroup()) != 0)
+      (*(*it).theListener)(ev);
+    it++;
+  }
+}
+
+
+// --- listeners -------------------------------------------
+
+/**
+ * Stores the input values like CRRCControlSurfaceAnimation.
+ */
+class Surface
+{
+  public:
+    float aileron;
+    float elevator;
+    float rudder;
+    float throttle;
+    float flap;
+    float spoiler;
+    float retract;
+    float pitch;
+
+    void set(const AxisUpdateEvent& ev)
+    {
+      aileron  = ev.getAileron();
+      elevator = ev.getElevator();
+      rudder   = ev.getRudder();
+      throttle = ev.getThrottle();
+      flap     = ev.getFlap();
+      spoiler  = ev.getSpoiler();
+      retract  = ev.getRetract();
+      pitch    = ev.getPitch();
+    }
+};
+
+class OldSurface : public OldListener, public Surface
+{
+  public:
+    void operator()(const Event* ev)
+    {
+      const AxisUpdateEvent* aue = dynamic_cast<const AxisUpdateEvent*>(ev);
+      if (aue != NULL)
+        set(*aue);
+    }
+};
+
+class NewSurface : public Surface
+{
+  public:
+    NewSurface() : eventAdapter(this, &NewSurface::axisValueCallback) {}
+    void axisValueCallback(const AxisUpdateEvent& ev) { set(ev); }
+
+  private:
+    EventAdapter<NewSurface, AxisUpdateEvent> eventAdapter;
+};
+
+class OldOther : public OldListener
+{
+  public:
+    void operator()(const Event* ev) {}
+};
+
+class NewConsole : public EventListener<LogMessageEvent>
+{
+  public:
+    void operator()(const LogMessageEvent& ev) {}
+};
+
+class NewSim : public EventListener<CrashEvent>
+{
+  public:
+    void operator()(const CrashEvent& ev) {}
+};
+
+/**
+ * Counts the crash events, optionally unregisters a listener (maybe
+ * itself) when it receives one.
+ */
+class CrashCounter : public EventListener<CrashEvent>
+{
+  public:
+    CrashCounter() : nCalls(0), remove(NULL) {}
+
+    void operator()(const CrashEvent& ev)
+    {
+      nCalls++;
+      if (remove != NULL)
+        EventBus<CrashEvent>::unregisterListener(remove);
+      remove = NULL;
+    }
+
+    int                       nCalls;
+    EventListener<CrashEvent>* remove;
+};
+
+
+// --- test ------------------------------------------------
+
+/**
+ * Listeners which unregister during raise(), returns the number of
+ * listeners which have been called the wrong number of times.
+ */
+static int checkUnregister()
+{
+  CrashCounter c[5];
+  CrashEvent   ev;
+  int          nErrors = 0;
+
+  // c[1] removes itself, c[3] removes c[0] which has been called
+  // already, c[4] must still be called
+  c[1].remove = &c[1];
+  c[3].remove = &c[0];
+  EventBus<CrashEvent>::raise(ev);
+  for (int n = 0; n < 5; n++)
+    if (c[n].nCalls != 1)
+      nErrors++;
+
+  // c[2] removes c[4], which hasn't been called yet
+  c[2].remove = &c[4];
+  EventBus<CrashEvent>::raise(ev);
+  if (c[0].nCalls != 1 || c[1].nCalls != 1 || c[2].nCalls != 2
+      || c[3].nCalls != 2 || c[4].nCalls != 1)
+    nErrors++;
+
+  if (nErrors > 0)
+    printf("unregistering during raise: wrong listeners called\n");
+  return nErrors;
+}
+
+/**
+ * Input values of update u in frame f.
+ */
+static void values(int f, int u, AxisUpdateEvent& ev)
+{
+  float x = 0.001f*(f*7 + u);
+  ev.set(x, -x, 2*x, 0.5f + x, 0.1f, 0.2f, 0.3f, x/2);
+}
+
+static int check(std::vector<Surface*>& surfaces, const AxisUpdateEvent& ev)
+{
+  for (unsigned int n = 0; n < surfaces.size(); n++)
+  {
+    if (surfaces[n]->aileron  != ev.getAileron()
+        || surfaces[n]->elevator != ev.getElevator()
+        || surfaces[n]->rudder   != ev.getRudder()
+        || surfaces[n]->throttle != ev.getThrottle()
+        || surfaces[n]->pitch    != ev.getPitch())
+      return 1;
+  }
+  return 0;
+}
+
+/**
+ * Runs all frames with one of the versions (0: old, 1: raise,
+ * 2: post and flush), returns the CPU time in seconds.
+ */
+static double run(int v, int nFrames, int nUpdates,
+                  std::vector<Surface*>& surfaces, int& nErrors)
+{
+  double dTime = 0;
+
+  for (int f = 0; f < nFrames; f++)
+  {
+    static AxisUpdateEvent event;
+
+    clock_t start = clock();
+    for (int u = 0; u < nUpdates; u++)
+    {
+      values(f, u, event);
+      switch (v)
+      {
+       case 0:
+        old_raise(&event);
+        break;
+       case 1:
+        EventBus<AxisUpdateEvent>::raise(event);
+        break;
+       default:
+        EventBus<AxisUpdateEvent>::post(event);
+        break;
+      }
+    }
+    if (v == 2)
+      EventBus<AxisUpdateEvent>::flush();
+    dTime += (double)(clock()-start)/CLOCKS_PER_SEC;
+
+    nErrors += check(surfaces, event);
+  }
+  return dTime;
+}
+
+int main(int argc, char** argv)
+{
+  int nFrames   = 10000;
+  int nSurfaces = 128;
+  int nUpdates  = 4;
+  int nErrors   = 0;
+
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "-n") == 0 && i+1 < argc)
+      nFrames = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-s") == 0 && i+1 < argc)
+      nSurfaces = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-u") == 0 && i+1 < argc)
+      nUpdates = atoi(argv[++i]);
+  }
+
+  std::vector<Surface*> oldSurfaces;
+  std::vector<Surface*> newSurfaces;
+  OldOther              oldConsole;
+  OldOther              oldSim;
+  NewConsole            newConsole;
+  NewSim                newSim;
+
+  // the console and the simulation were registered first
+  old_register(&oldConsole, Event::Logging);
+  old_register(&oldSim,     Event::Generic);
+  for (int n = 0; n < nSurfaces; n++)
+  {
+    OldSurface* s = new OldSurface();
+    old_register(s, Event::Input);
+    oldSurfaces.push_back(s);
+    newSurfaces.push_back(new NewSurface());
+  }
+
+  if (EventBus<AxisUpdateEvent>::getListenerCount() != nSurfaces
+      || EventBus<CrashEvent>::getListenerCount() != 1)
+  {
+    printf("wrong number of listeners\n");
+    nErrors++;
+  }
+
+  int    nErr[3] = {0, 0, 0};
+  double dTime[3];
+  dTime[0] = run(0, nFrames, nUpdates, oldSurfaces, nErr[0]);
+  dTime[1] = run(1, nFrames, nUpdates, newSurfaces, nErr[1]);
+  dTime[2] = run(2, nFrames, nUpdates, newSurfaces, nErr[2]);
+
+  printf("%i surfaces, %i updates per frame, us/frame: old %.2f  raise %.2f  post+flush %.2f\n",
+         nSurfaces, nUpdates,
+         1e6*dTime[0]/nFrames, 1e6*dTime[1]/nFrames, 1e6*dTime[2]/nFrames);
+  printf("wrong frames: old %i  raise %i  post+flush %i\n", nErr[0], nErr[1], nErr[2]);
+  nErrors += nErr[0] + nErr[1] + nErr[2];
+  nErrors += checkUnregister();
+
+  for (int n = 0; n < nSurfaces; n++)
+  {
+    delete (OldSurface*)oldSurfaces[n];
+    delete (NewSurface*)newSurfaces[n];
+  }
+  if (EventBus<AxisUpdateEvent>::getListenerCount() != 0)
+  {
+    printf("listeners left after destruction\n");
+    nErrors++;
+  }
+
+  return nErrors;
+}
@@ -29,6 +29,7 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <ctype.h>
 
 #include <crrc_config.h>
@@ -43,7 +44,7 @@ extern int    optind;
 static void crrc_version_info();
 static void crrc_usage(char *progname);
 
-#define OPTION_STRING "b:c:d:fg:hi:j:l:m:s:u:vVw:x:y:"
+#define OPTION_STRING "a:b:c:d:efg:hi:j:k:l:m:n:o:p:r:s:tu:vVw:x:y:"
 
 /**
  * Print usage information and exit
@@ -58,14 +59,23 @@ static void crrc_usage(char *progname)
   fprintf(stderr,  "         -h             : display this message\n");
   fprintf(stderr,  "         -l <string>    : location/scenery file with path (e.g. scenery/davis-orig.xml)\n");
   fprintf(stderr,  "                          Use this option before others, otherwise they might be overwritten.\n");
+  fprintf(stderr,  "         -a <value>     : trace input latency, synthetic aileron steps every <value> ms (0: stick movements)\n");
   fprintf(stderr,  "         -b <nr:string> : joystick buttonnr function: RESUME|RESET|PAUSE|ZOOMIN|ZOOMOUT|INCTHROTTLE|DECTHROTTLE\n");
   fprintf(stderr,  "         -c <value>     : color_depth in bits per pixel\n");
   fprintf(stderr,  "         -d <value>     : wind direction in deg (0-360)\n");
+  fprintf(stderr,  "         -e             : record deterministically (inputs, steps and state of every simulation step)\n");
   fprintf(stderr,  "         -f             : use fullscreen\n");
   fprintf(stderr,  "         -g <string>    : specify config file\n");
   fprintf(stderr,  "         -i <string>    : input method : KEYBOARD|MOUSE|JOYSTICK|RCTRAN|SERIAL2|PARALLEL|AUDIO|MNAV|ZHENHUA\n");
+  fprintf(stderr,  "         -k <string>    : export every simulation step to this shared memory object (e.g. /crrcsim)\n");
   fprintf(stderr,  "         -m <string>    : mouse x motion : AILERON|RUDDER\n");
+  fprintf(stderr,  "         -n <value>     : number of frames to render offscreen, then exit\n");
+  fprintf(stderr,  "         -o <string>    : render offscreen, write frames to this directory\n");
+  fprintf(stderr,  "         -p <string>    : replay a record made with -e, compare every step and exit\n");
+  fprintf(stderr,  "                          (same location, wind and thermal settings as when it was recorded)\n");
+  fprintf(stderr,  "         -r <n:string>  : load a flight record n times as robots (stress test)\n");
   fprintf(stderr,  "         -s <on/off>    : sound on/off\n");
+  fprintf(stderr,  "         -t             : run the simulation on its own thread\n");
   fprintf(stderr,  "         -u <on/off>    : user interface on/off\n");
   fprintf(stderr,  "         -w <value>     : wind velocity in ft/sec\n");
   fprintf(stderr,  "         -x <value>     : x_resolution in pixels\n");
@@ -97,6 +107,9 @@ int crrc_checkopts (int                argc,
   {
     switch (c)
     {
+      case 'a':
+        cfgfile->setAttributeOverwrite("simulation.latency.steps", optarg);
+        break;
       case 'b':
         if (! isdigit(optarg[0]) || optarg[1] != ':')
         {
@@ -131,6 +144,9 @@ int crrc_checkopts (int                argc,
       case 'd':
         cfg->wind->setDirection((float)atof(optarg), cfg);
         break;
+      case 'e':
+        cfgfile->setAttributeOverwrite("record.deterministic", "1");
+        break;
       case 'f':
         cfgfile->setAttributeOverwrite("video.fullscreen.fUse", "1");
         break;
@@ -144,6 +160,9 @@ int crrc_checkopts (int                argc,
       case 'i':
         cfgfile->setAttributeOverwrite("inputMethod.method", optarg);
         break;
+      case 'k':
+        cfgfile->setAttributeOverwrite("telemetry.shm", optarg);
+        break;
       case 'l': /* airport location */
         cfg->setLocation(optarg, cfgfile);
         break;
@@ -153,12 +172,38 @@ int crrc_checkopts (int                argc,
         else if (strcasecmp(optarg,"RUDDER")==0)
           Global::inputDev->mouse_bind_x = T_AxisMapper::RUDDER;
         break;
+      case 'n':
+        cfgfile->setAttributeOverwrite("video.offscreen.frames", optarg);
+        break;
+      case 'o':
+        cfgfile->setAttributeOverwrite("video.offscreen.enabled", "1");
+        cfgfile->setAttributeOverwrite("video.offscreen.dir", optarg);
+        cfgfile->setAttributeOverwrite("video.enabled", "1");
+        break;
+      case 'p':
+        cfgfile->setAttributeOverwrite("replay.file", optarg);
+        break;
+      case 'r':
+        {
+          const char* file = strchr(optarg, ':');
+          if (! isdigit(optarg[0]) || file == NULL)
+          {
+            opt_err = 1;
+            break;
+          }
+          cfgfile->setAttributeOverwrite("robots.stress.count", std::string(optarg, file - optarg));
+          cfgfile->setAttributeOverwrite("robots.stress.file", file + 1);
+        }
+        break;
       case 's':
         if      (strcasecmp(optarg,"ON")==0)
           cfgfile->setAttributeOverwrite("sound.enabled", "1");
         if      (strcasecmp(optarg,"OFF")==0)
           cfgfile->setAttributeOverwrite("sound.enabled", "0");
         break;
+      case 't':
+        cfgfile->setAttributeOverwrite("simulation.thread", "1");
+        break;
       case 'u':
         if      (strcasecmp(optarg,"ON")==0)
           cfgfile->setAttributeOverwrite("video.enabled", "1");
@@ -299,4 +344,12 @@ static void crrc_version_info()
   std::cout << "  wind data import not supported";
   #endif
   std::cout << std::endl;
+  
+  // Offscreen rendering support
+  #if OFFSCREEN > 0
+  std::cout << "  offscreen rendering supported";
+  #else
+  std::cout << "  offscreen rendering not supported";
+  #endif
+  std::cout << std::endl;
 }
@@ -42,7 +42,7 @@ extern void zoom_out();
 EventHandler::EventHandler(Scheduler *_s)
 {
   myScheduler= _s;
-  _s->Register( this);
+  _s->Register( this, "SDL events");
 }
 
 EventHandler::~EventHandler()
@@ -21,6 +21,9 @@
  */
 #include "intgr.h"
 
+#include <math.h>
+#include <stdexcept>
+
 namespace CRRCMath
 {
 
@@ -64,4 +67,246 @@ namespace CRRCMath
      val    = val + AblNeu*dT;
   }
 
+  /*******************************************************************************************/
+
+  RungeKutta4::RungeKutta4() : nSize(0)
+  {
+  }
+
+  void RungeKutta4::resize(int n)
+  {
+    nSize = n;
+    k1.resize(n);
+    k2.resize(n);
+    k3.resize(n);
+    k4.resize(n);
+    tmp.resize(n);
+  }
+
+  int RungeKutta4::step(ODESystem& sys, double t, double* y, double dT)
+  {
+    int          n  = sys.getSize();
+    const double h2 = 0.5*dT;
+
+    if (n != nSize)
+      resize(n);
+
+    sys.derivative(t, y, &k1[0]);
+    for (int i=0; i<n; i++)
+      tmp[i] = y[i] + h2*k1[i];
+
+    sys.derivative(t+h2, &tmp[0], &k2[0]);
+    for (int i=0; i<n; i++)
+      tmp[i] = y[i] + h2*k2[i];
+
+    sys.derivative(t+h2, &tmp[0], &k3[0]);
+    for (int i=0; i<n; i++)
+      tmp[i] = y[i] + dT*k3[i];
+
+    sys.derivative(t+dT, &tmp[0], &k4[0]);
+    for (int i=0; i<n; i++)
+      y[i] += (dT/6.0)*(k1[i] + 2*(k2[i] + k3[i]) + k4[i]);
+
+    return(4);
+  }
+
+  /*******************************************************************************************/
+
+  // Butcher tableau of DOPRI5
+  static const double dp_c2  = 1.0/5,  dp_c3 = 3.0/10, dp_c4 = 4.0/5, dp_c5 = 8.0/9;
+  static const double dp_a21 = 1.0/5;
+  static const double dp_a31 = 3.0/40,       dp_a32 = 9.0/40;
+  static const double dp_a41 = 44.0/45,      dp_a42 = -56.0/15,      dp_a43 = 32.0/9;
+  static const double dp_a51 = 19372.0/6561, dp_a52 = -25360.0/2187, dp_a53 = 64448.0/6561,
+                      dp_a54 = -212.0/729;
+  static const double dp_a61 = 9017.0/3168,  dp_a62 = -355.0/33,     dp_a63 = 46732.0/5247,
+                      dp_a64 = 49.0/176,     dp_a65 = -5103.0/18656;
+  // fifth order weights, also row 7 of the tableau (first same as last)
+  static const double dp_a71 = 35.0/384,     dp_a73 = 500.0/1113,    dp_a74 = 125.0/192,
+                      dp_a75 = -2187.0/6784, dp_a76 = 11.0/84;
+  // difference between fifth and fourth order weights
+  static const double dp_e1  = 71.0/57600,   dp_e3  = -71.0/16695,   dp_e4  = 71.0/1920,
+                      dp_e5  = -17253.0/339200, dp_e6 = 22.0/525,    dp_e7  = -1.0/40;
+
+  DormandPrince45::DormandPrince45()
+    : relTol(1e-6), absTol(1e-6), hMin(0), hMax(0),
+      nAccepted(0), nRejected(0), nSize(0), h(0)
+  {
+  }
+
+  void DormandPrince45::reset()
+  {
+    h = 0;
+  }
+
+  void DormandPrince45::resize(int n)
+  {
+    nSize = n;
+    k1.resize(n);
+    k2.resize(n);
+    k3.resize(n);
+    k4.resize(n);
+    k5.resize(n);
+    k6.resize(n);
+    k7.resize(n);
+    ytmp.resize(n);
+    ynew.resize(n);
+  }
+
+  int DormandPrince45::integrate(ODESystem& sys, double t, double* y, double dT)
+  {
+    int          n     = sys.getSize();
+    int          nEval = 0;
+    const double tEnd  = t + dT;
+
+    if (n != nSize)
+    {
+      resize(n);
+      h = 0;
+    }
+
+    if (dT <= 0)
+      return(0);
+
+    // The derivative at the start of the step is needed anyway. When a
+    // step is accepted, k7 holds the derivative at its end.
+    sys.derivative(t, y, &k1[0]);
+    nEval++;
+
+    if (h <= 0)
+      h = dT;
+
+    while (t < tEnd)
+    {
+      bool fLast = false;
+
+      if (hMax > 0 && h > hMax)
+        h = hMax;
+      if (h < hMin)
+        h = hMin;
+
+      // h is the step size the error control asks for, hs the one used.
+      // Don't leave a tiny step at the end.
+      double hs = h;
+      if (t + 1.01*hs >= tEnd)
+      {
+        hs    = tEnd - t;
+        fLast = true;
+      }
+
+      for (int i=0; i<n; i++)
+        ytmp[i] = y[i] + hs*dp_a21*k1[i];
+      sys.derivative(t+dp_c2*hs, &ytmp[0], &k2[0]);
+
+      for (int i=0; i<n; i++)
+        ytmp[i] = y[i] + hs*(dp_a31*k1[i] + dp_a32*k2[i]);
+      sys.derivative(t+dp_c3*hs, &ytmp[0], &k3[0]);
+
+      for (int i=0; i<n; i++)
+        ytmp[i] = y[i] + hs*(dp_a41*k1[i] + dp_a42*k2[i] + dp_a43*k3[i]);
+      sys.derivative(t+dp_c4*hs, &ytmp[0], &k4[0]);
+
+      for (int i=0; i<n; i++)
+        ytmp[i] = y[i] + hs*(dp_a51*k1[i] + dp_a52*k2[i] + dp_a53*k3[i] + dp_a54*k4[i]);
+      sys.derivative(t+dp_c5*hs, &ytmp[0], &k5[0]);
+
+      for (int i=0; i<n; i++)
+        ytmp[i] = y[i] + hs*(dp_a61*k1[i] + dp_a62*k2[i] + dp_a63*k3[i] + dp_a64*k4[i]
+                            + dp_a65*k5[i]);
+      sys.derivative(t+hs, &ytmp[0], &k6[0]);
+
+      for (int i=0; i<n; i++)
+        ynew[i] = y[i] + hs*(dp_a71*k1[i] + dp_a73*k3[i] + dp_a74*k4[i] + dp_a75*k5[i]
+                            + dp_a76*k6[i]);
+      sys.derivative(t+hs, &ynew[0], &k7[0]);
+      nEval += 6;
+
+      // error estimate, scaled to the tolerance (RMS norm)
+      double err = 0;
+      for (int i=0; i<n; i++)
+      {
+        double e  = hs*(dp_e1*k1[i] + dp_e3*k3[i] + dp_e4*k4[i] + dp_e5*k5[i]
+                       + dp_e6*k6[i] + dp_e7*k7[i]);
+        double ya = fabs(y[i]);
+        double yb = fabs(ynew[i]);
+        double sc = absTol + relTol*(ya > yb ? ya : yb);
+
+        err += (e/sc)*(e/sc);
+      }
+      err = sqrt(err/n);
+
+      // new step size, with the usual safety factor and limits
+      double fac;
+      if (err != err)
+        fac = 0.2;  // NaN: the step went totally wrong
+      else if (err == 0)
+        fac = 5;
+      else
+      {
+        fac = 0.9*pow(err, -0.2);
+        if (fac > 5)
+          fac = 5;
+        else if (fac < 0.2)
+          fac = 0.2;
+      }
+
+      // Accept the step if the error is small enough or if the step
+      // size can't be reduced anymore.
+      if (err <= 1 || hs <= hMin || hs <= 1e-10*dT)
+      {
+        // accept
+        t = fLast ? tEnd : t + hs;
+        for (int i=0; i<n; i++)
+        {
+          y[i]  = ynew[i];
+          k1[i] = k7[i];
+        }
+        nAccepted++;
+
+        // There's no point in going on with tiny steps if the
+        // derivatives can't be calculated anymore.
+        if (err != err)
+          break;
+
+        // A step which has been cut to hit tEnd may only shrink h.
+        if (!fLast || hs*fac < h)
+          h = hs*fac;
+      }
+      else
+      {
+        nRejected++;
+        h = hs*fac;
+      }
+    }
+
+    return(nEval);
+  }
+
+  /*******************************************************************************************/
+
+  IntegrationMethod IntegrationMethodFromString(std::string name)
+  {
+    if (name.compare("ab2") == 0)
+      return(INTGR_AB2);
+    else if (name.compare("rk4") == 0)
+      return(INTGR_RK4);
+    else if (name.compare("rk45") == 0)
+      return(INTGR_RK45);
+    else
+      throw std::runtime_error("Unknown integration method " + name);
+  }
+
+  const char* IntegrationMethodToString(IntegrationMethod method)
+  {
+    switch (method)
+    {
+     case INTGR_RK4:
+      return("rk4");
+     case INTGR_RK45:
+      return("rk45");
+     default:
+      return("ab2");
+    }
+  }
+
 };
@@ -22,6 +22,8 @@
 #ifndef INTGR_H
 # define INTGR_H
 
+# include <string>
+# include <vector>
 # include "vector3.h"
 
 /** \brief this namespace contains pure math
@@ -172,6 +174,126 @@ namespace CRRCMath
       */
      C val;
   };
-  
+
+  /**
+   * A system of ordinary differential equations y' = f(t, y) with a
+   * fixed number of states. This is what the Runge-Kutta methods below
+   * need: unlike the classes above they have to evaluate the derivative
+   * at intermediate points of a step, so they can't be fed with
+   * derivatives from outside.
+   */
+  class ODESystem
+  {
+    public:
+     virtual ~ODESystem() {};
+
+     /**
+      * number of states
+      */
+     virtual int  getSize() = 0;
+
+     /**
+      * Calculates dydt = f(t, y). y and dydt point to getSize() values.
+      */
+     virtual void derivative(double t, const double* y, double* dydt) = 0;
+  };
+
+  /**
+   * Classical Runge-Kutta method of fourth order with fixed step size.
+   *
+   * Abschnitt 9.3.4 in [2]
+   *
+   * Four evaluations of the derivative per step.
+   */
+  class RungeKutta4
+  {
+    public:
+     RungeKutta4();
+
+     /**
+      * Integrates the system from t to t+dT in one step, y is updated.
+      *
+      * @return number of evaluations of the derivative
+      */
+     int step(ODESystem& sys, double t, double* y, double dT);
+
+    private:
+     void resize(int n);
+
+     int                 nSize;
+     std::vector<double> k1, k2, k3, k4, tmp;
+  };
+
+  /**
+   * Embedded Runge-Kutta method of order 5(4) by Dormand and Prince
+   * (DOPRI5) with automatic step size control.
+   *
+   * J. R. Dormand, P. J. Prince, 'A family of embedded Runge-Kutta
+   * formulae', J. Comp. Appl. Math. 6 (1980), and Hairer/Norsett/Wanner,
+   * 'Solving Ordinary Differential Equations I', section II.4.
+   *
+   * integrate() always advances by exactly the requested time, using as
+   * many internal steps as needed to keep the estimated local error below
+   * absTol + relTol*|y| for every state. The step size is remembered from
+   * one call to the next, so a smooth flight needs one step (six
+   * evaluations, the seventh is reused) per call.
+   */
+  class DormandPrince45
+  {
+    public:
+     DormandPrince45();
+
+     /**
+      * Integrates the system from t to t+dT, y is updated.
+      *
+      * @return number of evaluations of the derivative
+      */
+     int integrate(ODESystem& sys, double t, double* y, double dT);
+
+     /**
+      * Forget the step size used so far, start with a guess on the next call.
+      */
+     void reset();
+
+     /// tolerances of the local error
+     double relTol;
+     double absTol;
+
+     /// limits of the step size [s]; 0 means 'no limit'
+     double hMin;
+     double hMax;
+
+     /// statistics: accepted and rejected steps
+     unsigned long nAccepted;
+     unsigned long nRejected;
+
+    private:
+     void resize(int n);
+
+     int                 nSize;
+     double              h;
+     std::vector<double> k1, k2, k3, k4, k5, k6, k7, ytmp, ynew;
+  };
+
+  /**
+   * Methods selectable for the equations of motion.
+   */
+  enum IntegrationMethod
+  {
+    INTGR_AB2  = 0,  ///< Adams-Bashforth 2, one evaluation per step (default)
+    INTGR_RK4  = 1,  ///< Runge-Kutta 4, fixed step size
+    INTGR_RK45 = 2   ///< Dormand-Prince 5(4), adaptive step size
+  };
+
+  /**
+   * Parses "ab2", "rk4" or "rk45". Throws std::runtime_error for anything else.
+   */
+  IntegrationMethod IntegrationMethodFromString(std::string name);
+
+  /**
+   * Inverse of IntegrationMethodFromString()
+   */
+  const char* IntegrationMethodToString(IntegrationMethod method);
+
 }
 #endif
@@ -0,0 +1,317 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+#include "mathkernels.h"
+
+#include <math.h>
+
+#if defined(__AVX__)
+# include <immintrin.h>
+# define CRRC_KERNELS_AVX  1
+# define CRRC_KERNELS_SSE2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# include <emmintrin.h>
+# define CRRC_KERNELS_SSE2 1
+#endif
+
+namespace CRRCMath
+{
+  namespace Kernels
+  {
+
+    const char* implementation()
+    {
+#if defined(CRRC_KERNELS_AVX)
+      return "AVX";
+#elif defined(CRRC_KERNELS_SSE2)
+      return "SSE2";
+#else
+      return "scalar";
+#endif
+    }
+
+    /*******************************************************************************************/
+    /* scalar reference versions                                                              */
+    /*******************************************************************************************/
+
+    void mat33_mul_vec3_scalar(const double m[3][3], const double b[3], double out[3])
+    {
+      out[0] = m[0][0]*b[0] + m[0][1]*b[1] + m[0][2]*b[2];
+      out[1] = m[1][0]*b[0] + m[1][1]*b[1] + m[1][2]*b[2];
+      out[2] = m[2][0]*b[0] + m[2][1]*b[1] + m[2][2]*b[2];
+    }
+
+    void mat33_multrans_vec3_scalar(const double m[3][3], const double b[3], double out[3])
+    {
+      out[0] = m[0][0]*b[0] + m[1][0]*b[1] + m[2][0]*b[2];
+      out[1] = m[0][1]*b[0] + m[1][1]*b[1] + m[2][1]*b[2];
+      out[2] = m[0][2]*b[0] + m[1][2]*b[1] + m[2][2]*b[2];
+    }
+
+    void mat33_mul_mat33_scalar(const double a[3][3], const double b[3][3], double out[3][3])
+    {
+      for (int m=0; m<3; m++)
+      {
+        for (int n=0; n<3; n++)
+          out[m][n] = a[m][0]*b[0][n] + a[m][1]*b[1][n] + a[m][2]*b[2][n];
+      }
+    }
+
+    void quat_rate_scalar(const double q[4], const double w[3], double qdot[4])
+    {
+      qdot[0] = 0.5*( -w[0]*q[1] - w[1]*q[2] - w[2]*q[3] );
+      qdot[1] = 0.5*(  w[0]*q[0] - w[1]*q[3] + w[2]*q[2] );
+      qdot[2] = 0.5*(  w[0]*q[3] + w[1]*q[0] - w[2]*q[1] );
+      qdot[3] = 0.5*( -w[0]*q[2] + w[1]*q[1] + w[2]*q[0] );
+    }
+
+    void quat_normalize_scalar(double q[4])
+    {
+      double inv_eps = 1/sqrt(q[0]*q[0] + q[1]*q[1] + q[2]*q[2] + q[3]*q[3]);
+
+      q[0] *= inv_eps;
+      q[1] *= inv_eps;
+      q[2] *= inv_eps;
+      q[3] *= inv_eps;
+    }
+
+    void quat_to_mat33_scalar(const double q[4], double m[3][3])
+    {
+      m[0][0] = q[0]*q[0] + q[1]*q[1] - q[2]*q[2] - q[3]*q[3];
+      m[0][1] = 2*(q[1]*q[2] + q[0]*q[3]);
+      m[0][2] = 2*(q[1]*q[3] - q[0]*q[2]);
+      m[1][0] = 2*(q[1]*q[2] - q[0]*q[3]);
+      m[1][1] = q[0]*q[0] - q[1]*q[1] + q[2]*q[2] - q[3]*q[3];
+      m[1][2] = 2*(q[2]*q[3] + q[0]*q[1]);
+      m[2][0] = 2*(q[1]*q[3] + q[0]*q[2]);
+      m[2][1] = 2*(q[2]*q[3] - q[0]*q[1]);
+      m[2][2] = q[0]*q[0] - q[1]*q[1] - q[2]*q[2] + q[3]*q[3];
+    }
+
+    /*******************************************************************************************/
+    /* vectorized versions                                                                    */
+    /*******************************************************************************************/
+
+#if defined(CRRC_KERNELS_SSE2)
+
+    void mat33_mul_vec3(const double m[3][3], const double b[3], double out[3])
+    {
+      // Rows 0 and 1 are done in parallel: the products of the first two
+      // columns are summed horizontally by unpacking, the third column
+      // is added afterwards. Row 2 is cheaper in scalar code.
+      __m128d b01 = _mm_loadu_pd(b);
+      __m128d p0  = _mm_mul_pd(_mm_loadu_pd(&m[0][0]), b01);
+      __m128d p1  = _mm_mul_pd(_mm_loadu_pd(&m[1][0]), b01);
+      __m128d s   = _mm_add_pd(_mm_unpacklo_pd(p0, p1), _mm_unpackhi_pd(p0, p1));
+      __m128d c2  = _mm_set_pd(m[1][2], m[0][2]);
+
+      s = _mm_add_pd(s, _mm_mul_pd(c2, _mm_set1_pd(b[2])));
+      _mm_storeu_pd(out, s);
+      out[2] = m[2][0]*b[0] + m[2][1]*b[1] + m[2][2]*b[2];
+    }
+
+# if defined(CRRC_KERNELS_AVX)
+
+    /**
+     * Loads/stores three doubles of a matrix row. The fourth lane is
+     * masked, so nothing beyond the end of the matrix is touched.
+     */
+    static inline __m256i row_mask()
+    {
+      return _mm256_set_epi64x(0, -1, -1, -1);
+    }
+
+    void mat33_multrans_vec3(const double m[3][3], const double b[3], double out[3])
+    {
+      __m256i mask = row_mask();
+      __m256d s;
+
+      s = _mm256_mul_pd(_mm256_maskload_pd(m[0], mask), _mm256_set1_pd(b[0]));
+      s = _mm256_add_pd(s, _mm256_mul_pd(_mm256_maskload_pd(m[1], mask), _mm256_set1_pd(b[1])));
+      s = _mm256_add_pd(s, _mm256_mul_pd(_mm256_maskload_pd(m[2], mask), _mm256_set1_pd(b[2])));
+      _mm256_maskstore_pd(out, mask, s);
+    }
+
+    void mat33_mul_mat33(const double a[3][3], const double b[3][3], double out[3][3])
+    {
+      __m256i mask = row_mask();
+      __m256d b0   = _mm256_maskload_pd(b[0], mask);
+      __m256d b1   = _mm256_maskload_pd(b[1], mask);
+      __m256d b2   = _mm256_maskload_pd(b[2], mask);
+
+      for (int m=0; m<3; m++)
+      {
+        __m256d s;
+
+        s = _mm256_mul_pd(_mm256_set1_pd(a[m][0]), b0);
+        s = _mm256_add_pd(s, _mm256_mul_pd(_mm256_set1_pd(a[m][1]), b1));
+        s = _mm256_add_pd(s, _mm256_mul_pd(_mm256_set1_pd(a[m][2]), b2));
+        _mm256_maskstore_pd(out[m], mask, s);
+      }
+    }
+
+    void quat_rate(const double q[4], const double w[3], double qdot[4])
+    {
+      // qdot = 0.5 * Omega(w) * q, evaluated column by column
+      __m256d s;
+
+      s = _mm256_mul_pd(_mm256_set1_pd(q[0]), _mm256_set_pd( w[2],  w[1],  w[0],     0));
+      s = _mm256_add_pd(s, _mm256_mul_pd(_mm256_set1_pd(q[1]), _mm256_set_pd( w[1], -w[2],     0, -w[0])));
+      s = _mm256_add_pd(s, _mm256_mul_pd(_mm256_set1_pd(q[2]), _mm256_set_pd(-w[0],     0,  w[2], -w[1])));
+      s = _mm256_add_pd(s, _mm256_mul_pd(_mm256_set1_pd(q[3]), _mm256_set_pd(    0,  w[0], -w[1], -w[2])));
+      _mm256_storeu_pd(qdot, _mm256_mul_pd(s, _mm256_set1_pd(0.5)));
+    }
+
+# else
+
+    void mat33_multrans_vec3(const double m[3][3], const double b[3], double out[3])
+    {
+      // out = b0*row0 + b1*row1 + b2*row2, first two elements in parallel
+      __m128d s;
+
+      s = _mm_mul_pd(_mm_loadu_pd(&m[0][0]), _mm_set1_pd(b[0]));
+      s = _mm_add_pd(s, _mm_mul_pd(_mm_loadu_pd(&m[1][0]), _mm_set1_pd(b[1])));
+      s = _mm_add_pd(s, _mm_mul_pd(_mm_loadu_pd(&m[2][0]), _mm_set1_pd(b[2])));
+      _mm_storeu_pd(out, s);
+      out[2] = m[0][2]*b[0] + m[1][2]*b[1] + m[2][2]*b[2];
+    }
+
+    void mat33_mul_mat33(const double a[3][3], const double b[3][3], double out[3][3])
+    {
+      __m128d b0 = _mm_loadu_pd(&b[0][0]);
+      __m128d b1 = _mm_loadu_pd(&b[1][0]);
+      __m128d b2 = _mm_loadu_pd(&b[2][0]);
+
+      for (int m=0; m<3; m++)
+      {
+        __m128d a0 = _mm_set1_pd(a[m][0]);
+        __m128d a1 = _mm_set1_pd(a[m][1]);
+        __m128d a2 = _mm_set1_pd(a[m][2]);
+        __m128d s;
+
+        s = _mm_mul_pd(a0, b0);
+        s = _mm_add_pd(s, _mm_mul_pd(a1, b1));
+        s = _mm_add_pd(s, _mm_mul_pd(a2, b2));
+        _mm_storeu_pd(&out[m][0], s);
+        out[m][2] = a[m][0]*b[0][2] + a[m][1]*b[1][2] + a[m][2]*b[2][2];
+      }
+    }
+
+    void quat_rate(const double q[4], const double w[3], double qdot[4])
+    {
+      // qdot = 0.5 * Omega(w) * q, evaluated column by column,
+      // elements 0/1 and 2/3 in separate registers
+      __m128d q0 = _mm_set1_pd(q[0]);
+      __m128d q1 = _mm_set1_pd(q[1]);
+      __m128d q2 = _mm_set1_pd(q[2]);
+      __m128d q3 = _mm_set1_pd(q[3]);
+      __m128d lo;
+      __m128d hi;
+
+      lo = _mm_mul_pd(q0, _mm_set_pd( w[0],     0));
+      lo = _mm_add_pd(lo, _mm_mul_pd(q1, _mm_set_pd(    0, -w[0])));
+      lo = _mm_add_pd(lo, _mm_mul_pd(q2, _mm_set_pd( w[2], -w[1])));
+      lo = _mm_add_pd(lo, _mm_mul_pd(q3, _mm_set_pd(-w[1], -w[2])));
+
+      hi = _mm_mul_pd(q0, _mm_set_pd( w[2],  w[1]));
+      hi = _mm_add_pd(hi, _mm_mul_pd(q1, _mm_set_pd( w[1], -w[2])));
+      hi = _mm_add_pd(hi, _mm_mul_pd(q2, _mm_set_pd(-w[0],     0)));
+      hi = _mm_add_pd(hi, _mm_mul_pd(q3, _mm_set_pd(    0,  w[0])));
+
+      __m128d half = _mm_set1_pd(0.5);
+      _mm_storeu_pd(qdot,   _mm_mul_pd(lo, half));
+      _mm_storeu_pd(qdot+2, _mm_mul_pd(hi, half));
+    }
+
+# endif
+
+    void quat_normalize(double q[4])
+    {
+      __m128d lo = _mm_loadu_pd(q);
+      __m128d hi = _mm_loadu_pd(q+2);
+      __m128d sq = _mm_add_pd(_mm_mul_pd(lo, lo), _mm_mul_pd(hi, hi));
+
+      sq = _mm_add_sd(sq, _mm_unpackhi_pd(sq, sq));
+
+      // full precision division, not the approximate reciprocal: the
+      // result has to match the scalar version
+      __m128d inv = _mm_div_sd(_mm_set_sd(1.0), _mm_sqrt_sd(sq, sq));
+      inv = _mm_unpacklo_pd(inv, inv);
+
+      _mm_storeu_pd(q,   _mm_mul_pd(lo, inv));
+      _mm_storeu_pd(q+2, _mm_mul_pd(hi, inv));
+    }
+
+#else
+
+    void mat33_mul_vec3(const double m[3][3], const double b[3], double out[3])
+    {
+      mat33_mul_vec3_scalar(m, b, out);
+    }
+
+    void mat33_multrans_vec3(const double m[3][3], const double b[3], double out[3])
+    {
+      mat33_multrans_vec3_scalar(m, b, out);
+    }
+
+    void mat33_mul_mat33(const double a[3][3], const double b[3][3], double out[3][3])
+    {
+      mat33_mul_mat33_scalar(a, b, out);
+    }
+
+    void quat_rate(const double q[4], const double w[3], double qdot[4])
+    {
+      quat_rate_scalar(q, w, qdot);
+    }
+
+    void quat_normalize(double q[4])
+    {
+      quat_normalize_scalar(q);
+    }
+
+#endif
+
+    void quat_to_mat33(const double q[4], double m[3][3])
+    {
+      // There is nothing to gain from SIMD here, but the mixed products
+      // are only computed once instead of twice.
+      double s0 = q[0]*q[0];
+      double s1 = q[1]*q[1];
+      double s2 = q[2]*q[2];
+      double s3 = q[3]*q[3];
+      double q12 = 2*q[1]*q[2];
+      double q03 = 2*q[0]*q[3];
+      double q13 = 2*q[1]*q[3];
+      double q02 = 2*q[0]*q[2];
+      double q23 = 2*q[2]*q[3];
+      double q01 = 2*q[0]*q[1];
+
+      m[0][0] = s0 + s1 - s2 - s3;
+      m[0][1] = q12 + q03;
+      m[0][2] = q13 - q02;
+      m[1][0] = q12 - q03;
+      m[1][1] = s0 - s1 + s2 - s3;
+      m[1][2] = q23 + q01;
+      m[2][0] = q13 + q02;
+      m[2][1] = q23 - q01;
+      m[2][2] = s0 - s1 - s2 + s3;
+    }
+
+  }
+}
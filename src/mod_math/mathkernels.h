@@ -0,0 +1,87 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+#ifndef MATHKERNELS_H
+# define MATHKERNELS_H
+
+/**
+ * \file mathkernels.h
+ *
+ * Low level kernels behind Matrix33 and the Quaternion classes.
+ *
+ * Every kernel exists as a plain scalar reference version (suffix
+ * <tt>_scalar</tt>) and as the version which is actually used by
+ * the math classes. The latter uses SSE2 or AVX if the compiler
+ * has been told to generate code for it (__SSE2__ is always set
+ * on x86_64, __AVX__ needs -mavx or -march=native) and falls back
+ * to the scalar code otherwise.
+ *
+ * Matrices are 3x3 row-major, quaternions are stored with the scalar
+ * part first: q = (s, x, y, z). Input and output may not overlap.
+ */
+namespace CRRCMath
+{
+  namespace Kernels
+  {
+    /**
+     * Name of the instruction set the kernels have been compiled for
+     * ("AVX", "SSE2" or "scalar").
+     */
+    const char* implementation();
+
+    /**
+     * out = m * b
+     */
+    void mat33_mul_vec3       (const double m[3][3], const double b[3], double out[3]);
+    void mat33_mul_vec3_scalar(const double m[3][3], const double b[3], double out[3]);
+
+    /**
+     * out = transposed(m) * b
+     */
+    void mat33_multrans_vec3       (const double m[3][3], const double b[3], double out[3]);
+    void mat33_multrans_vec3_scalar(const double m[3][3], const double b[3], double out[3]);
+
+    /**
+     * out = a * b
+     */
+    void mat33_mul_mat33       (const double a[3][3], const double b[3][3], double out[3][3]);
+    void mat33_mul_mat33_scalar(const double a[3][3], const double b[3][3], double out[3][3]);
+
+    /**
+     * Time derivative of the quaternion q for the angular velocity
+     * omega (p, q, r) in body axes.
+     */
+    void quat_rate       (const double q[4], const double omega[3], double qdot[4]);
+    void quat_rate_scalar(const double q[4], const double omega[3], double qdot[4]);
+
+    /**
+     * Scales q to unit length. Like the original code there is no
+     * check for a quaternion of length zero.
+     */
+    void quat_normalize       (double q[4]);
+    void quat_normalize_scalar(double q[4]);
+
+    /**
+     * Direction cosine matrix 'local to body' of the unit quaternion q.
+     */
+    void quat_to_mat33       (const double q[4], double m[3][3]);
+    void quat_to_mat33_scalar(const double q[4], double m[3][3]);
+  }
+}
+#endif
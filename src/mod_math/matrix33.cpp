@@ -18,6 +18,7 @@
  *
  */
 #include "matrix33.h"
+#include "mathkernels.h"
 
 #include <iostream>
 
@@ -103,9 +104,7 @@ namespace CRRCMath
   {
     Vector3 tmp;
 
-    for (unsigned char m=0; m<3; m++)
-      for (unsigned char n=0; n<3; n++)
-        tmp.r[m] += v[m][n]*b.r[n];
+    Kernels::mat33_mul_vec3(v, b.r, tmp.r);
 
     return tmp;
   }
@@ -114,9 +113,7 @@ namespace CRRCMath
   {
     Vector3 tmp;
 
-    for (unsigned char m=0; m<3; m++)
-      for (unsigned char n=0; n<3; n++)
-        tmp.r[m] += v[n][m]*b.r[n];
+    Kernels::mat33_multrans_vec3(v, b.r, tmp.r);
 
     return tmp;
   }
@@ -125,15 +122,7 @@ namespace CRRCMath
   {
     Matrix33 tmp;
 
-    for (unsigned char m=0; m<3; m++)
-    {
-      for (unsigned char n=0; n<3; n++)
-      {
-        tmp.v[m][n] = 0;
-        for (unsigned char i=0; i<3; i++)
-          tmp.v[m][n] += v[m][i]*b.v[i][n];
-      }
-    }
+    Kernels::mat33_mul_mat33(v, b.v, tmp.v);
 
     return tmp;
   }
@@ -18,11 +18,16 @@
  *
  */
 #include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <math.h>
 
 #include "quaternion.h"
 #include "vector3.h"
 #include "matrix33.h"
 #include "intgr.h"
+#include "mathkernels.h"
 
 /**
  * Quaternion test.
@@ -32,8 +37,9 @@
  *          = integral(sin(x)*sin(x)) dt
  *          = -0.5 cos(x) sin(x) + 0.5 x
  *              
+ * Prints a table which can be plotted.
  */
-int main()
+int plotTrajectory()
 {
   const int                   nSteps = 20;
   CRRCMath::Quaternion_002    q1;
@@ -123,3 +129,254 @@ int main()
   }
   return(0);
 }
+
+/*******************************************************************************************/
+
+/**
+ * Number of random input sets for the kernel tests and
+ * the benchmark.
+ */
+#define N_SETS 1024
+
+/**
+ * Relative tolerance when comparing a vectorized kernel to
+ * the scalar reference. Both do the same operations, but the
+ * order of the additions may differ.
+ */
+#define TOLERANCE 1e-14
+
+static double m_a[N_SETS][3][3];
+static double m_b[N_SETS][3][3];
+static double v_b[N_SETS][3];
+static double q_a[N_SETS][4];
+
+static double rnd()
+{
+  return(2.0*rand()/(double)RAND_MAX - 1.0);
+}
+
+static void fillInputs()
+{
+  srand(42);
+  for (int i=0; i<N_SETS; i++)
+  {
+    for (int m=0; m<3; m++)
+    {
+      v_b[i][m] = 100*rnd();
+      for (int n=0; n<3; n++)
+      {
+        m_a[i][m][n] = rnd();
+        m_b[i][m][n] = rnd();
+      }
+    }
+    for (int n=0; n<4; n++)
+      q_a[i][n] = rnd();
+  }
+}
+
+/**
+ * Returns false and prints a message if a and b differ by
+ * more than TOLERANCE (relative to the magnitude of a).
+ */
+static bool compare(const char* name, int set, const double* a, const double* b, int n)
+{
+  for (int i=0; i<n; i++)
+  {
+    double d   = fabs(a[i] - b[i]);
+    double ref = fabs(a[i]) > 1 ? fabs(a[i]) : 1;
+
+    if (d > TOLERANCE*ref)
+    {
+      std::cout << "FAILED: " << name << ", set " << set << ", element " << i
+                << ": " << a[i] << " != " << b[i] << "\n";
+      return(false);
+    }
+  }
+  return(true);
+}
+
+static int checkKernels()
+{
+  int nErrors = 0;
+
+  for (int i=0; i<N_SETS; i++)
+  {
+    double r1[4];
+    double r2[4];
+    double m1[3][3];
+    double m2[3][3];
+
+    CRRCMath::Kernels::mat33_mul_vec3_scalar(m_a[i], v_b[i], r1);
+    CRRCMath::Kernels::mat33_mul_vec3       (m_a[i], v_b[i], r2);
+    nErrors += !compare("mat33_mul_vec3", i, r1, r2, 3);
+
+    CRRCMath::Kernels::mat33_multrans_vec3_scalar(m_a[i], v_b[i], r1);
+    CRRCMath::Kernels::mat33_multrans_vec3       (m_a[i], v_b[i], r2);
+    nErrors += !compare("mat33_multrans_vec3", i, r1, r2, 3);
+
+    CRRCMath::Kernels::mat33_mul_mat33_scalar(m_a[i], m_b[i], m1);
+    CRRCMath::Kernels::mat33_mul_mat33       (m_a[i], m_b[i], m2);
+    nErrors += !compare("mat33_mul_mat33", i, &m1[0][0], &m2[0][0], 9);
+
+    CRRCMath::Kernels::quat_rate_scalar(q_a[i], v_b[i], r1);
+    CRRCMath::Kernels::quat_rate       (q_a[i], v_b[i], r2);
+    nErrors += !compare("quat_rate", i, r1, r2, 4);
+
+    memcpy(r1, q_a[i], sizeof(r1));
+    memcpy(r2, q_a[i], sizeof(r2));
+    CRRCMath::Kernels::quat_normalize_scalar(r1);
+    CRRCMath::Kernels::quat_normalize       (r2);
+    nErrors += !compare("quat_normalize", i, r1, r2, 4);
+
+    CRRCMath::Kernels::quat_to_mat33_scalar(r1, m1);
+    CRRCMath::Kernels::quat_to_mat33       (r1, m2);
+    nErrors += !compare("quat_to_mat33", i, &m1[0][0], &m2[0][0], 9);
+  }
+
+  // The public API has to give the same results as the kernels.
+  for (int i=0; i<N_SETS; i++)
+  {
+    CRRCMath::Matrix33 A(m_a[i][0][0], m_a[i][0][1], m_a[i][0][2],
+                         m_a[i][1][0], m_a[i][1][1], m_a[i][1][2],
+                         m_a[i][2][0], m_a[i][2][1], m_a[i][2][2]);
+    CRRCMath::Vector3  b(v_b[i][0], v_b[i][1], v_b[i][2]);
+    CRRCMath::Vector3  r1 = A.trans() * b;
+    CRRCMath::Vector3  r2 = A.multrans(b);
+
+    nErrors += !compare("Matrix33::multrans", i, r1.r, r2.r, 3);
+  }
+
+  // Quaternion_003 and Quaternion_002 use different conventions internally,
+  // but have to agree on the resulting transformation.
+  {
+    CRRCMath::Quaternion_002 q2;
+    CRRCMath::Quaternion_003 q3;
+    CRRCMath::Vector3        eul(0.1, -0.4, 1.2);
+
+    q2.init(eul);
+    q3.init(eul);
+    for (int i=0; i<N_SETS; i++)
+    {
+      CRRCMath::Vector3 omega(v_b[i][0]*0.01, v_b[i][1]*0.01, v_b[i][2]*0.01);
+
+      q2.step(0.002, omega);
+      q3.step(0.002, omega);
+    }
+    CRRCMath::Matrix33 mmt = q3.mat * q3.mat.trans();
+    double             unit[9] = { 1, 0, 0,  0, 1, 0,  0, 0, 1 };
+
+    if (fabs(mmt.det() - 1) > 1e-12 || !compare("Quaternion_003 orthonormal", 0, unit, &mmt.v[0][0], 9))
+    {
+      std::cout << "FAILED: Quaternion_003 does not stay orthonormal\n";
+      nErrors++;
+    }
+    // Both integrate the same rates, so differences are integration
+    // errors of order dt^2, not rounding errors.
+    for (int m=0; m<3; m++)
+      for (int n=0; n<3; n++)
+        if (fabs(q2.mat.v[m][n] - q3.mat.v[m][n]) > 1e-3)
+        {
+          std::cout << "FAILED: Quaternion_002 and _003 differ at [" << m << "][" << n << "]\n";
+          nErrors++;
+        }
+  }
+
+  return(nErrors);
+}
+
+/**
+ * Runs func nLoops times over all input sets and prints the
+ * time per call, returns the time per call in ns.
+ */
+template<class F> static double bench(const char* name, F func, int nLoops)
+{
+  double  sum   = 0;
+  clock_t start = clock();
+
+  for (int l=0; l<nLoops; l++)
+    for (int i=0; i<N_SETS; i++)
+      sum += func(i);
+
+  double ns = 1e9 * (clock() - start) / (double)CLOCKS_PER_SEC / ((double)nLoops * N_SETS);
+
+  std::cout.width(28);
+  std::cout << name << ": ";
+  std::cout.width(8);
+  std::cout << ns << " ns/call    (checksum " << sum << ")\n";
+  return(ns);
+}
+
+/*
+ * One wrapper per kernel, so the compiler can't hoist the calls.
+ * The return value only serves to keep the results alive.
+ */
+#define KERNEL_MV(K)  static double b_##K(int i) { double r[3]; CRRCMath::Kernels::K(m_a[i], v_b[i], r); return(r[0]+r[1]+r[2]); }
+#define KERNEL_MM(K)  static double b_##K(int i) { double r[3][3]; CRRCMath::Kernels::K(m_a[i], m_b[i], r); return(r[0][0]+r[1][1]+r[2][2]); }
+#define KERNEL_QR(K)  static double b_##K(int i) { double r[4]; CRRCMath::Kernels::K(q_a[i], v_b[i], r); return(r[0]+r[3]); }
+#define KERNEL_QN(K)  static double b_##K(int i) { double r[4]; memcpy(r, q_a[i], sizeof(r)); CRRCMath::Kernels::K(r); return(r[0]+r[3]); }
+#define KERNEL_QM(K)  static double b_##K(int i) { double r[3][3]; CRRCMath::Kernels::K(q_a[i], r); return(r[0][0]+r[2][1]); }
+
+KERNEL_MV(mat33_mul_vec3_scalar)
+KERNEL_MV(mat33_mul_vec3)
+KERNEL_MV(mat33_multrans_vec3_scalar)
+KERNEL_MV(mat33_multrans_vec3)
+KERNEL_MM(mat33_mul_mat33_scalar)
+KERNEL_MM(mat33_mul_mat33)
+KERNEL_QR(quat_rate_scalar)
+KERNEL_QR(quat_rate)
+KERNEL_QN(quat_normalize_scalar)
+KERNEL_QN(quat_normalize)
+KERNEL_QM(quat_to_mat33_scalar)
+KERNEL_QM(quat_to_mat33)
+
+static void benchmarkKernels(int nLoops)
+{
+  std::cout << "Kernels compiled for " << CRRCMath::Kernels::implementation() << "\n";
+
+#define BENCH_PAIR(K) \
+  { \
+    double t_s = bench(#K "_scalar", b_##K##_scalar, nLoops); \
+    double t_v = bench(#K,           b_##K,          nLoops); \
+    std::cout << "    speedup: " << (t_v > 0 ? t_s/t_v : 0) << "\n"; \
+  }
+
+  BENCH_PAIR(mat33_mul_vec3);
+  BENCH_PAIR(mat33_multrans_vec3);
+  BENCH_PAIR(mat33_mul_mat33);
+  BENCH_PAIR(quat_rate);
+  BENCH_PAIR(quat_normalize);
+  BENCH_PAIR(quat_to_mat33);
+
+#undef BENCH_PAIR
+}
+
+/**
+ * Without arguments the kernels are checked against their scalar
+ * reference versions and benchmarked. The return value is the
+ * number of failed checks.
+ *
+ * -p         print the trajectory table of the original quaternion test
+ * -n <loops> number of benchmark loops over all input sets (0: no benchmark)
+ */
+int main(int argc, char** argv)
+{
+  int nLoops = 2000;
+
+  for (int i=1; i<argc; i++)
+  {
+    if (strcmp(argv[i], "-p") == 0)
+      return(plotTrajectory());
+    else if (strcmp(argv[i], "-n") == 0 && i+1 < argc)
+      nLoops = atoi(argv[++i]);
+  }
+
+  fillInputs();
+
+  int nErrors = checkKernels();
+  std::cout << "Kernel checks: " << (nErrors ? "FAILED" : "OK") << "\n";
+
+  if (nLoops > 0)
+    benchmarkKernels(nLoops);
+
+  return(nErrors);
+}
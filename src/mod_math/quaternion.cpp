@@ -20,6 +20,7 @@
  */
 //
 #include "quaternion.h"
+#include "mathkernels.h"
 
 #include <math.h>
 #include <iostream>
@@ -193,44 +194,42 @@ void CRRCMath::Quaternion_002::step(double            dT,
 {
 //  std::cout << "length_A= " << length() << "\n";
 
-  // Gleichung (2.13) aus [1]:
-  double ep0 = 0.5 * (                   +omega.r[2]*e1.val -omega.r[1]*e2.val +omega.r[0]*e3.val);
-  double ep1 = 0.5 * (-omega.r[2]*e0.val                    +omega.r[0]*e2.val +omega.r[1]*e3.val);
-  double ep2 = 0.5 * (+omega.r[1]*e0.val -omega.r[0]*e1.val                    +omega.r[2]*e3.val);
-  double ep3 = 0.5 * (-omega.r[0]*e0.val -omega.r[1]*e1.val -omega.r[2]*e2.val                   );
+  // Gleichung (2.13) aus [1]. Der Skalarteil ist hier e3, die Kernel
+  // erwarten ihn an erster Stelle.
+  double q[4] = { e3.val, e0.val, e1.val, e2.val };
+  double qdot[4];
 
-  e0.step(dT, ep0);
-  e1.step(dT, ep1);
-  e2.step(dT, ep2);
-  e3.step(dT, ep3);
+  Kernels::quat_rate(q, omega.r, qdot);
+
+  e0.step(dT, qdot[1]);
+  e1.step(dT, qdot[2]);
+  e2.step(dT, qdot[3]);
+  e3.step(dT, qdot[0]);
 
   // Lnge wird erzwungen:
-  double inv_eps = 1/length();
+  q[0] = e3.val;
+  q[1] = e0.val;
+  q[2] = e1.val;
+  q[3] = e2.val;
+  Kernels::quat_normalize(q);
   
 //  std::cout << "length_B= " << length() << "\n";
   
-  e0.val *= inv_eps;
-  e1.val *= inv_eps;
-  e2.val *= inv_eps;
-  e3.val *= inv_eps;
+  e0.val = q[1];
+  e1.val = q[2];
+  e2.val = q[3];
+  e3.val = q[0];
   
   update_mat();
 }
 
 void CRRCMath::Quaternion_002::update_mat()
 {
-  // Matrix nach Gleichung (2.8) aus [1]:
-  mat.v[0][0] =  e0.val*e0.val - e1.val*e1.val - e2.val*e2.val + e3.val*e3.val;
-  mat.v[0][1] =  2*(e0.val*e1.val + e2.val*e3.val);
-  mat.v[0][2] =  2*(e0.val*e2.val - e1.val*e3.val);
-
-  mat.v[1][0] =  2*(e0.val*e1.val - e2.val*e3.val);
-  mat.v[1][1] = -e0.val*e0.val + e1.val*e1.val - e2.val*e2.val + e3.val*e3.val;
-  mat.v[1][2] =  2*(e1.val*e2.val + e0.val*e3.val);
-
-  mat.v[2][0] =  2*(e0.val*e2.val + e1.val*e3.val);
-  mat.v[2][1] =  2*(e1.val*e2.val - e0.val*e3.val);
-  mat.v[2][2] = -e0.val*e0.val - e1.val*e1.val + e2.val*e2.val + e3.val*e3.val;  
+  // Matrix nach Gleichung (2.8) aus [1]; mit dem Skalarteil e3 an erster
+  // Stelle ist das dieselbe Matrix wie bei Quaternion_003.
+  double q[4] = { e3.val, e0.val, e1.val, e2.val };
+
+  Kernels::quat_to_mat33(q, mat.v);
 }
 
 void CRRCMath::Quaternion_002::updateEuler()
@@ -310,57 +309,67 @@ void CRRCMath::Quaternion_002::convTest1()
   (mat2-mat).print();
 }
 
+void CRRCMath::Quaternion_002::getQuat(double q[4])
+{
+  q[0] = e3.val;
+  q[1] = e0.val;
+  q[2] = e1.val;
+  q[3] = e2.val;
+}
+
+void CRRCMath::Quaternion_002::setQuat(const double q[4])
+{
+  double qn[4] = { q[0], q[1], q[2], q[3] };
+
+  Kernels::quat_normalize(qn);
+
+  e0.val = qn[1];
+  e1.val = qn[2];
+  e2.val = qn[3];
+  e3.val = qn[0];
+
+  update_mat();
+}
+
 /*******************************************************************************************/
 
 void CRRCMath::Quaternion_003::step(double            dT,
                                     CRRCMath::Vector3 omega)
 {
-  double e_0 = e0.val;
-  double e_1 = e1.val;
-  double e_2 = e2.val;
-  double e_3 = e3.val;
+  double e[4] = { e0.val, e1.val, e2.val, e3.val };
+  double e_dot[4];
   
   /* Transform to quaternion rates (see Appendix E in [2]) */  
-  double e_dot_0 = 0.5*( -omega.r[0]*e_1 - omega.r[1]*e_2 - omega.r[2]*e_3 );
-  double e_dot_1 = 0.5*(  omega.r[0]*e_0 - omega.r[1]*e_3 + omega.r[2]*e_2 );
-  double e_dot_2 = 0.5*(  omega.r[0]*e_3 + omega.r[1]*e_0 - omega.r[2]*e_1 );
-  double e_dot_3 = 0.5*( -omega.r[0]*e_2 + omega.r[1]*e_1 + omega.r[2]*e_0 );
+  Kernels::quat_rate(e, omega.r, e_dot);
   
   /* Integrate using trapezoidal as before */
-  e0.step(dT, e_dot_0);
-  e1.step(dT, e_dot_1);
-  e2.step(dT, e_dot_2);
-  e3.step(dT, e_dot_3);
+  e0.step(dT, e_dot[0]);
+  e1.step(dT, e_dot[1]);
+  e2.step(dT, e_dot[2]);
+  e3.step(dT, e_dot[3]);
 
   /* calculate orthagonality correction  - scale quaternion to unity length */
-  double inv_eps = 1/length();
+  e[0] = e0.val;
+  e[1] = e1.val;
+  e[2] = e2.val;
+  e[3] = e3.val;
+  Kernels::quat_normalize(e);
   
 //  std::cout << "length= " << length() << "\n";
   
-  e0.val *= inv_eps;
-  e1.val *= inv_eps;
-  e2.val *= inv_eps;
-  e3.val *= inv_eps;
+  e0.val = e[0];
+  e1.val = e[1];
+  e2.val = e[2];
+  e3.val = e[3];
   
   update_mat();
 }
 
 void CRRCMath::Quaternion_003::update_mat()
 {
-  double e_0 = e0.val;
-  double e_1 = e1.val;
-  double e_2 = e2.val;
-  double e_3 = e3.val;
+  double e[4] = { e0.val, e1.val, e2.val, e3.val };
   
-  mat.v[0][0] = e_0*e_0 + e_1*e_1 - e_2*e_2 - e_3*e_3;
-  mat.v[0][1] = 2*(e_1*e_2 + e_0*e_3);
-  mat.v[0][2] = 2*(e_1*e_3 - e_0*e_2);
-  mat.v[1][0] = 2*(e_1*e_2 - e_0*e_3);
-  mat.v[1][1] = e_0*e_0 - e_1*e_1 + e_2*e_2 - e_3*e_3;
-  mat.v[1][2] = 2*(e_2*e_3 + e_0*e_1);
-  mat.v[2][0] = 2*(e_1*e_3 + e_0*e_2);
-  mat.v[2][1] = 2*(e_2*e_3 - e_0*e_1);
-  mat.v[2][2] = e_0*e_0 - e_1*e_1 - e_2*e_2 + e_3*e_3;
+  Kernels::quat_to_mat33(e, mat.v);
 }
 
 void CRRCMath::Quaternion_003::updateEuler()
@@ -149,6 +149,17 @@ namespace CRRCMath
       */
      void convTest1();
 
+     /**
+      * Copies the quaternion to q, scalar part first.
+      */
+     void getQuat(double q[4]);
+
+     /**
+      * Sets the quaternion from q (scalar part first), scales it to
+      * unit length and updates mat. The euler angles are not updated.
+      */
+     void setQuat(const double q[4]);
+
     private:
 
      Matrix33 initFromEuler(CRRCMath::Vector3 eul);
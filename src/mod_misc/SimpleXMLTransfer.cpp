@@ -46,6 +46,9 @@
 # include <stdio.h>
 #endif
 
+/// minimum number of children for building a hash table
+#define CHILD_INDEX_MIN  (8)
+
 XMLException::XMLException(std::string message)
 {
   myMessage = message;
@@ -61,13 +64,17 @@ const char *XMLException::what()
  */
 SimpleXMLTransfer::SimpleXMLTransfer()
 {
-  myName      = "data";
-  content     = (std::string *) 0;
-  sourcedescr = "default constructor";
+  myName          = "data";
+  nameHash        = hashName(myName.data(), myName.length());
+  parent          = (SimpleXMLTransfer*)0;
+  content         = (std::string *) 0;
+  sourcedescr     = "default constructor";
 }
 
 SimpleXMLTransfer::SimpleXMLTransfer(std::istream & in, int data)
 {
+  nameHash        = 0;
+  parent          = (SimpleXMLTransfer*)0;
   content     = (std::string *) 0;
   sourcedescr = "istream";
   readStream(in, data);
@@ -84,6 +91,8 @@ SimpleXMLTransfer::SimpleXMLTransfer(std::string source)
 {
   std::ifstream in;
 
+  nameHash        = 0;
+  parent          = (SimpleXMLTransfer*)0;
   content = (std::string*) 0;
 
   in.open(source.c_str());
@@ -102,6 +111,8 @@ SimpleXMLTransfer::SimpleXMLTransfer(std::string source)
 
 SimpleXMLTransfer::SimpleXMLTransfer(std::istream& in)
 {
+  nameHash        = 0;
+  parent          = (SimpleXMLTransfer*)0;
   content = (std::string*) 0;
   sourcedescr = "stream";
   readStream(in, -2);
@@ -109,6 +120,8 @@ SimpleXMLTransfer::SimpleXMLTransfer(std::istream& in)
 
 SimpleXMLTransfer::SimpleXMLTransfer(SimpleXMLTransfer* source)
 {
+  nameHash        = 0;
+  parent          = (SimpleXMLTransfer*)0;
   content     = (std::string *) 0;
   sourcedescr = "copy constructor";
 
@@ -401,6 +414,8 @@ void SimpleXMLTransfer::readStream(std::istream & in, int data)
            && isspace(content->at(content->length() - 1)) == true)
       content->replace(content->length() - 1, 1, "");
 
+  nameHash = hashName(myName.data(), myName.length());
+
   if (fGeschlossen == false)
   {
     throw XMLException(sourcedescr + ": XML-Element wurde nicht abgeschlossen: " +
@@ -502,17 +517,7 @@ int SimpleXMLTransfer::getContentInt()
  */
 std::string SimpleXMLTransfer::getString(std::string path)
 {
-  std::string::size_type pos = path.rfind('.');
-
-  if (pos != std::string::npos)
-  {
-    SimpleXMLTransfer *item = getChild(path.substr(0, pos));
-    return (item->attribute(path.substr(pos + 1)));
-  }
-  else
-  {
-    return (attribute(path));
-  }
+  return (getHandle(path).getString());
 }
 
 /**
@@ -524,17 +529,7 @@ std::string SimpleXMLTransfer::getString(std::string path)
  */
 int SimpleXMLTransfer::getInt(std::string path)
 {
-  std::string::size_type pos = path.rfind('.');
-
-  if (pos != std::string::npos)
-  {
-    SimpleXMLTransfer *item = getChild(path.substr(0, pos));
-    return (item->attributeAsInt(path.substr(pos + 1)));
-  }
-  else
-  {
-    return (attributeAsInt(path));
-  }
+  return (getHandle(path).getInt());
 }
 
 /**
@@ -543,34 +538,14 @@ int SimpleXMLTransfer::getInt(std::string path)
  */
 double SimpleXMLTransfer::getDouble(std::string path)
 {
-  std::string::size_type pos = path.rfind('.');
-
-  if (pos != std::string::npos)
-  {
-    SimpleXMLTransfer *item = getChild(path.substr(0, pos));
-    return (item->attributeAsDouble(path.substr(pos + 1)));
-  }
-  else
-  {
-    return (attributeAsDouble(path));
-  }
+  return (getHandle(path).getDouble());
 }
 
 std::string SimpleXMLTransfer::getString(std::string path, std::string stringDefault)
 {
   try
   {
-    std::string::size_type pos = path.rfind('.');
-
-    if (pos != std::string::npos)
-    {
-      SimpleXMLTransfer *item = getChild(path.substr(0, pos));
-      return (item->attribute(path.substr(pos + 1)));
-    }
-    else
-    {
-      return (attribute(path));
-    }
+    return (getHandle(path).getString());
   }
   catch (XMLException e)
   {
@@ -590,17 +565,7 @@ int SimpleXMLTransfer::getInt(std::string path, int nDefault)
 {
   try
   {
-    std::string::size_type pos = path.rfind('.');
-
-    if (pos != std::string::npos)
-    {
-      SimpleXMLTransfer *item = getChild(path.substr(0, pos));
-      return (item->attributeAsInt(path.substr(pos + 1)));
-    }
-    else
-    {
-      return (attributeAsInt(path));
-    }
+    return (getHandle(path).getInt());
   }
   catch (XMLException e)
   {
@@ -617,17 +582,7 @@ double SimpleXMLTransfer::getDouble(std::string path, double dDefault)
 {
   try
   {
-    std::string::size_type pos = path.rfind('.');
-
-    if (pos != std::string::npos)
-    {
-      SimpleXMLTransfer *item = getChild(path.substr(0, pos));
-      return (item->attributeAsDouble(path.substr(pos + 1)));
-    }
-    else
-    {
-      return (attributeAsDouble(path));
-    }
+    return (getHandle(path).getDouble());
   }
   catch (XMLException e)
   {
@@ -636,6 +591,55 @@ double SimpleXMLTransfer::getDouble(std::string path, double dDefault)
   }
 }
 
+/**
+ * Lst den Pfad einmal auf und liefert einen Verweis auf das Attribut.
+ */
+XMLHandle SimpleXMLTransfer::getHandle(std::string path)
+{
+  std::string::size_type pos = path.rfind('.');
+
+  if (pos != std::string::npos)
+    return (XMLHandle(findPath(path, pos), path.substr(pos + 1)));
+  else
+    return (XMLHandle(this, path));
+}
+
+XMLHandle SimpleXMLTransfer::getHandle(std::string path, std::string stringDefault)
+{
+  makeSureAttributeExists(path, stringDefault.c_str());
+  return (getHandle(path));
+}
+
+/**
+ * Liefert das Element zum Pfad <code>path</code> bis zur Position
+ * <code>end</code>, ohne Teilstrings anzulegen.
+ */
+SimpleXMLTransfer* SimpleXMLTransfer::findPath(const std::string& path,
+                                               std::string::size_type end)
+{
+  SimpleXMLTransfer*     item  = this;
+  const char*            name  = path.data();
+  std::string::size_type begin = 0;
+
+  while (begin <= end)
+  {
+    std::string::size_type pos = path.find('.', begin);
+    if (pos == std::string::npos || pos > end)
+      pos = end;
+
+    int index = item->indexOfChild(name + begin, pos - begin,
+                                   hashName(name + begin, pos - begin));
+    if (index < 0)
+      throw XMLException("No item named " + path.substr(begin, pos - begin) +
+                         " in " + path.substr(0, begin > 0 ? begin - 1 : 0));
+
+    item  = item->children[index];
+    begin = pos + 1;
+  }
+
+  return (item);
+}
+
 #if 1 == 2
 
 /**
@@ -760,6 +764,7 @@ void SimpleXMLTransfer::setAttributeOverwrite(std::string attribute, std::string
     {
       attrName.erase(attrName.begin() + index);
       attrVal.erase(attrVal.begin() + index);
+      attrHash.erase(attrHash.begin() + index);
     }
 
     addAttribute(attribute, value);
@@ -933,6 +938,7 @@ SimpleXMLTransfer::addAttribute(std::string attributeName,
   //
   attrName.push_back(attributeName);
   attrVal.push_back(attributeVal);
+  attrHash.push_back(hashName(attributeName.data(), attributeName.length()));
 }
 
 /**
@@ -952,7 +958,13 @@ SimpleXMLTransfer::addAttribute(std::string attributeName,
  */
 void SimpleXMLTransfer::addChild(SimpleXMLTransfer * child)
 {
+  child->parent = this;
   children.push_back(child);
+
+  if (childIndex.size() < 2 * children.size())
+    buildChildIndex();
+  else
+    addToChildIndex(children.size() - 1);
 }
 
 void SimpleXMLTransfer::print()
@@ -1186,14 +1198,7 @@ int SimpleXMLTransfer::indexOfAttribute(std::string attr) const
 #if DEBUG == 1
   printf("int SimpleXMLTransfer::indexOfAttribute(\"%s\")\n", attr.c_str());
 #endif
-  if (attrName.size() == 0)
-    return (-1);
-
-  int index = -1;
-
-  for (unsigned int i = 0; i < attrName.size() && index == -1; i++)
-    if (attr.compare(attrName[i]) == 0)
-      index = i;
+  int index = indexOfAttribute(attr, hashName(attr.data(), attr.length()));
 
 #if DEBUG == 1
   printf("int SimpleXMLTransfer::indexOfAttribute(\"%s\") = %i\n",
@@ -1202,6 +1207,16 @@ int SimpleXMLTransfer::indexOfAttribute(std::string attr) const
   return (index);
 }
 
+int SimpleXMLTransfer::indexOfAttribute(const std::string& attr,
+                                        unsigned int       hash) const
+{
+  for (unsigned int i = 0; i < attrName.size(); i++)
+    if (attrHash[i] == hash && attr.compare(attrName[i]) == 0)
+      return (i);
+
+  return (-1);
+}
+
 double SimpleXMLTransfer::convToDouble(std::string value)
 {
   char*       ptr;
@@ -1358,17 +1373,8 @@ SimpleXMLTransfer *SimpleXMLTransfer::getChild(std::string child, bool fCreate)
  */
 int SimpleXMLTransfer::indexOfChild(std::string child)
 {
-  if (children.size() == 0)
-    return (-1);
-
-  int index = -1;
-  int size  = children.size();
-
-  for (int i = 0; i < size && index == -1; i++)
-    if (child.compare(children[i]->getName()) == 0)
-      index = i;
-
-  return (index);
+  return (indexOfChild(child.data(), child.length(),
+                       hashName(child.data(), child.length())));
 }
 
 int SimpleXMLTransfer::indexOfChild(std::string child, int nStartIdx)
@@ -1379,23 +1385,120 @@ int SimpleXMLTransfer::indexOfChild(std::string child, int nStartIdx)
   if (nStartIdx < 0 || nStartIdx >= (int)(children.size()))
     nStartIdx = 0;
 
-  int index = -1;
-  int size  = children.size();
+  unsigned int hash  = hashName(child.data(), child.length());
+  int          index = -1;
+  int          size  = children.size();
 
   for (int i = nStartIdx; i < size && index == -1; i++)
-    if (child.compare(children[i]->getName()) == 0)
+    if (children[i]->nameHash == hash && child.compare(children[i]->myName) == 0)
       index = i;
 
   if (index < 0)
   {
     for (int i = 0; i < nStartIdx && index == -1; i++)
-      if (child.compare(children[i]->getName()) == 0)
+      if (children[i]->nameHash == hash && child.compare(children[i]->myName) == 0)
         index = i;
   }
 
   return (index);
 }
 
+/**
+ * Sucht ein Kind ber den Hashwert seines Namens, bei vielen Kindern in
+ * der Hashtabelle.
+ */
+int SimpleXMLTransfer::indexOfChild(const char*            name,
+                                    std::string::size_type len,
+                                    unsigned int           hash) const
+{
+  if (childIndex.size() == 0)
+  {
+    for (unsigned int i = 0; i < children.size(); i++)
+      if (children[i]->nameHash == hash
+          && children[i]->myName.compare(0, std::string::npos, name, len) == 0)
+        return (i);
+
+    return (-1);
+  }
+
+  unsigned int mask = childIndex.size() - 1;
+  unsigned int slot = hash & mask;
+
+  while (childIndex[slot] >= 0)
+  {
+    SimpleXMLTransfer* child = children[childIndex[slot]];
+
+    if (child->nameHash == hash
+        && child->myName.compare(0, std::string::npos, name, len) == 0)
+      return (childIndex[slot]);
+
+    slot = (slot + 1) & mask;
+  }
+
+  return (-1);
+}
+
+/**
+ * Baut die Hashtabelle der Kinder neu auf (offene Adressierung mit
+ * linearem Sondieren). Bei wenigen Kindern gibt es keine.
+ */
+void SimpleXMLTransfer::buildChildIndex()
+{
+  unsigned int size = children.size();
+
+  if (size < CHILD_INDEX_MIN)
+  {
+    childIndex.clear();
+    return;
+  }
+
+  // at least twice as many slots as children, and room for as many
+  // children again, so addChild() rarely has to rebuild the table
+  unsigned int nSlots = 2 * CHILD_INDEX_MIN;
+  while (nSlots < 4 * size)
+    nSlots *= 2;
+
+  childIndex.assign(nSlots, -1);
+  for (unsigned int i = 0; i < size; i++)
+    addToChildIndex(i);
+}
+
+/**
+ * Trgt das Kind <code>nIndex</code> in die Hashtabelle ein, falls es
+ * nicht schon ein frheres Kind mit diesem Namen gibt.
+ */
+void SimpleXMLTransfer::addToChildIndex(int nIndex)
+{
+  SimpleXMLTransfer* child = children[nIndex];
+  unsigned int       mask  = childIndex.size() - 1;
+  unsigned int       slot  = child->nameHash & mask;
+
+  while (childIndex[slot] >= 0
+         && (children[childIndex[slot]]->nameHash != child->nameHash
+             || children[childIndex[slot]]->myName != child->myName))
+    slot = (slot + 1) & mask;
+
+  if (childIndex[slot] < 0)
+    childIndex[slot] = nIndex;
+}
+
+/**
+ * FNV-1a
+ */
+unsigned int SimpleXMLTransfer::hashName(const char*            name,
+                                         std::string::size_type len)
+{
+  unsigned int hash = 2166136261u;
+
+  for (std::string::size_type i = 0; i < len; i++)
+  {
+    hash ^= (unsigned char)name[i];
+    hash *= 16777619u;
+  }
+
+  return (hash);
+}
+
 void SimpleXMLTransfer::removeChildAt(int nIndex)
 {
   if (children.size() <= (unsigned int) nIndex)
@@ -1404,7 +1507,9 @@ void SimpleXMLTransfer::removeChildAt(int nIndex)
     ("void SimpleXMLTransfer::removeChildAt(int nIndex): Index out of bounds in "
      + getName());
 
+  children[nIndex]->parent = (SimpleXMLTransfer*)0;
   children.erase(children.begin() + nIndex);
+  buildChildIndex();
 }
 
 void SimpleXMLTransfer::removeChild(SimpleXMLTransfer* XMLPtr)
@@ -1418,7 +1523,9 @@ void SimpleXMLTransfer::removeChild(SimpleXMLTransfer* XMLPtr)
       if (children[nIndex] == XMLPtr)
       {
         fErr = false;
+        XMLPtr->parent = (SimpleXMLTransfer*)0;
         children.erase(children.begin() + nIndex);
+        buildChildIndex();
         nIndex = children.size() + 1;
       }
     }
@@ -1442,7 +1549,10 @@ void SimpleXMLTransfer::replaceChild(SimpleXMLTransfer* XMLPtrOld,
       if (children[nIndex] == XMLPtrOld)
       {
         fErr = false;
+        XMLPtrOld->parent = (SimpleXMLTransfer*)0;
+        XMLPtrNew->parent = this;
         children[nIndex] = XMLPtrNew;
+        buildChildIndex();
         nIndex = children.size() + 1;
       }
     }
@@ -1459,7 +1569,12 @@ void SimpleXMLTransfer::replaceChild(SimpleXMLTransfer* XMLPtrOld,
  */
 void SimpleXMLTransfer::setName(std::string name)
 {
-  myName = name;
+  myName   = name;
+  nameHash = hashName(myName.data(), myName.length());
+
+  // the parent finds its children by name
+  if (parent != (SimpleXMLTransfer*)0)
+    parent->buildChildIndex();
 }
 
 /**
@@ -1521,6 +1636,9 @@ void SimpleXMLTransfer::sortChildrenString(std::string attributeName)
       }
     }
   }
+
+  // the first child of a name might be another one now
+  buildChildIndex();
 }
 
 void SimpleXMLTransfer::sortChildrenDouble(std::string attributeName)
@@ -1571,6 +1689,9 @@ void SimpleXMLTransfer::sortChildrenDouble(std::string attributeName)
       }
     }
   }
+
+  // the first child of a name might be another one now
+  buildChildIndex();
 }
 
 void SimpleXMLTransfer::delAttribute(std::string attribute)
@@ -1582,6 +1703,7 @@ void SimpleXMLTransfer::delAttribute(std::string attribute)
 
   attrName.erase(attrName.begin() + n);
   attrVal.erase(attrVal.begin() + n);
+  attrHash.erase(attrHash.begin() + n);
 }
 
 bool SimpleXMLTransfer::equals(SimpleXMLTransfer* item)
@@ -1760,3 +1882,94 @@ std::string SimpleXMLTransfer::attributeVal(unsigned int index)
     return(attrVal[index]);
 }
 
+
+XMLHandle::XMLHandle()
+{
+  item   = (SimpleXMLTransfer*)0;
+  hash   = 0;
+  nIndex = -1;
+}
+
+XMLHandle::XMLHandle(SimpleXMLTransfer* item, std::string attr)
+{
+  this->item = item;
+  this->attr = attr;
+  hash       = SimpleXMLTransfer::hashName(attr.data(), attr.length());
+  nIndex     = item->indexOfAttribute(attr, hash);
+}
+
+/**
+ * Meistens steht das Attribut noch an derselben Stelle wie beim letzten
+ * Zugriff, sonst wird es neu gesucht.
+ */
+int XMLHandle::indexOfAttribute()
+{
+  if (item == (SimpleXMLTransfer*)0)
+    throw XMLException("XMLHandle: no item");
+
+  if (nIndex < 0 || nIndex >= (int)item->attrName.size()
+      || item->attrHash[nIndex] != hash
+      || item->attrName[nIndex] != attr)
+    nIndex = item->indexOfAttribute(attr, hash);
+
+  return (nIndex);
+}
+
+std::string XMLHandle::getString()
+{
+  int index = indexOfAttribute();
+
+  if (index < 0)
+    throw XMLException("No Attribute named " + attr + " in " + item->getName());
+
+  return (item->attrVal[index]);
+}
+
+int XMLHandle::getInt()
+{
+  int index = indexOfAttribute();
+
+  if (index < 0)
+    throw XMLException("No Attribute named " + attr + " in " + item->getName());
+
+  return (item->convToInt(item->attrVal[index]));
+}
+
+double XMLHandle::getDouble()
+{
+  int index = indexOfAttribute();
+
+  if (index < 0)
+    throw XMLException("No Attribute named " + attr + " in " + item->getName());
+
+  return (item->convToDouble(item->attrVal[index]));
+}
+
+bool XMLHandle::exists()
+{
+  return (indexOfAttribute() >= 0);
+}
+
+std::string XMLHandle::getString(std::string stringDefault)
+{
+  if (indexOfAttribute() < 0)
+    return (stringDefault);
+
+  return (getString());
+}
+
+int XMLHandle::getInt(int nDefault)
+{
+  if (indexOfAttribute() < 0)
+    return (nDefault);
+
+  return (getInt());
+}
+
+double XMLHandle::getDouble(double dDefault)
+{
+  if (indexOfAttribute() < 0)
+    return (dDefault);
+
+  return (getDouble());
+}
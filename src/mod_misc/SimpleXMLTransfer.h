@@ -76,6 +76,94 @@ class XMLException
 
 class SimpleXMLTransfer;
 
+/** \brief Compiled path to an attribute.
+ *
+ * A handle is obtained from SimpleXMLTransfer::getHandle(). The path is
+ * resolved once, reading the value later on neither parses the path nor
+ * searches the children. The handle stays valid as long as the element
+ * it points to exists; the attribute itself may be removed, overwritten
+ * or created again in the meantime.
+ *
+ * Reading a value doesn't change the tree, so several threads may read
+ * it at the same time. A handle remembers where it found the attribute
+ * though, each thread needs handles of its own.
+ */
+class XMLHandle
+{
+  public:
+    /**
+     * Creates a handle which doesn't point to anything.
+     */
+    XMLHandle();
+
+    /**
+     * Returns <code>true</code> if the handle points to an element.
+     */
+    bool isValid() const { return(item != (SimpleXMLTransfer*)0); };
+
+    /**
+     * Returns the element the handle points to.
+     */
+    SimpleXMLTransfer* getItem() const { return(item); };
+
+    /**
+     * Returns the value of the attribute.
+     * Throws exception if the attribute doesn't exist.
+     */
+    std::string getString();
+
+    /**
+     * Returns the value of the attribute as an integer.
+     * Throws exception if the attribute doesn't exist.
+     */
+    int getInt();
+
+    /**
+     * Returns the value of the attribute as a double.
+     * Throws exception if the attribute doesn't exist.
+     */
+    double getDouble();
+
+    /**
+     * Returns <code>true</code> if the attribute exists.
+     */
+    bool exists();
+
+    /**
+     * Returns the value of the attribute or the default value if it
+     * doesn't exist. Unlike SimpleXMLTransfer::getString(), the
+     * attribute is not created.
+     */
+    std::string getString(std::string stringDefault);
+
+    /**
+     * Returns the value of the attribute as an integer or the default
+     * value if it doesn't exist.
+     */
+    int getInt(int nDefault);
+
+    /**
+     * Returns the value of the attribute as a double or the default
+     * value if it doesn't exist.
+     */
+    double getDouble(double dDefault);
+
+  private:
+    friend class SimpleXMLTransfer;
+
+    XMLHandle(SimpleXMLTransfer* item, std::string attr);
+
+    /**
+     * Index of the attribute in the element or -1.
+     */
+    int indexOfAttribute();
+
+    SimpleXMLTransfer* item;
+    std::string        attr;
+    unsigned int       hash;
+    int                nIndex;
+};
+
 /** \brief Simple XML parser class.
  *
  * This class should correspond to the Java-class jCoCo.SimpleXMLTransfer.
@@ -314,6 +402,21 @@ class SimpleXMLTransfer
      */
     double getDouble(std::string path, double dDefault);
 
+    /**
+     * Resolves <code>path</code> (see getString()) once and returns a
+     * handle to the attribute, for values which are read often.
+     * Throws exception if the element containing the attribute can't
+     * be found; the attribute itself doesn't have to exist yet.
+     */
+    XMLHandle getHandle(std::string path);
+
+    /**
+     * Resolves <code>path</code> (see getString()) once and returns a
+     * handle to the attribute. If the attribute doesn't exist, it is
+     * created with the default value.
+     */
+    XMLHandle getHandle(std::string path, std::string stringDefault);
+
 #if 1 == 2
 
     /**
@@ -464,10 +567,14 @@ class SimpleXMLTransfer
    std::string attributeVal (unsigned int index);
       
   private:
+    friend class XMLHandle;
+
     std::string                          myName;
     std::vector<SimpleXMLTransfer*>      children;
     std::vector<std::string>             attrName;
     std::vector<std::string>             attrVal;
+    unsigned int                         nameHash;
+    std::vector<unsigned int>            attrHash;
     std::vector<std::string>             comment;
     std::vector<int>                     commentPos;
     std::string*                         content;
@@ -481,6 +588,55 @@ class SimpleXMLTransfer
     SimpleXMLTransfer(std::istream&  in,
                       int            data);
 
+    /**
+     * Hash table of the children of elements with many children,
+     * empty otherwise. Each slot holds the index of a child or -1.
+     * Only the first child of a name is entered. It is kept up to date
+     * whenever the children change, so looking up a child never
+     * changes the tree.
+     */
+    std::vector<int>                     childIndex;
+
+    /**
+     * The element this one is a child of, which has to rebuild its
+     * table when this element is renamed.
+     */
+    SimpleXMLTransfer*                   parent;
+
+    /**
+     * Builds <code>childIndex</code> from scratch.
+     */
+    void buildChildIndex();
+
+    /**
+     * Enters the child at <code>nIndex</code> into <code>childIndex</code>.
+     */
+    void addToChildIndex(int nIndex);
+
+    /**
+     * Hash value of a name.
+     */
+    static unsigned int hashName(const char* name, std::string::size_type len);
+
+    /**
+     * Returns the index of the first child named <code>name</code>
+     * (<code>len</code> characters, hash value <code>hash</code>)
+     * or -1 if none exists.
+     */
+    int indexOfChild(const char* name, std::string::size_type len, unsigned int hash) const;
+
+    /**
+     * Index of the first attribute named <code>attr</code> with hash
+     * value <code>hash</code> or -1.
+     */
+    int indexOfAttribute(const std::string& attr, unsigned int hash) const;
+
+    /**
+     * Returns the element at <code>path</code> up to
+     * <code>end</code>. Throws exception if it can't be found.
+     */
+    SimpleXMLTransfer* findPath(const std::string& path, std::string::size_type end);
+
 
     /**
      * Possible notation for integer-values: decimal, hexadecimal with 
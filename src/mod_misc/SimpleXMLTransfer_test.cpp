@@ -0,0 +1,280 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+/**
+ * \file SimpleXMLTransfer_test.cpp
+ *
+ * Compares the lookup of attributes by path the way it used to be
+ * done (the path is split into substrings, every child and every
+ * attribute is compared by name) to getString() and to handles from
+ * getHandle().
+ *
+ * Usage: xml_test [-n rounds] file.xml [file.xml ...]
+ *
+ * The path of every attribute in every file is looked up in all three
+ * ways, the results have to be the same. Then all files are put below
+ * one root element, like the sections of the configuration file, and
+ * the lookups are done again on this document. Only the first child
+ * of a name can be reached by a path, attributes of later children of
+ * the same name are left out. Finally sections are renamed and removed
+ * in this document, the lookup of children has to follow.
+ *
+ * The CPU time per lookup is printed for all versions. The return
+ * value is the number of lookups which are different.
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include "SimpleXMLTransfer.h"
+
+
+/**
+ * Index of the first child named child, like indexOfChild() used to
+ * do it.
+ */
+static int old_indexOfChild(SimpleXMLTransfer* item, std::string child)
+{
+  int size = item->getChildCount();
+
+  for (int i = 0; i < size; i++)
+    if (child.compare(item->getChildAt(i)->getName()) == 0)
+      return i;
+  return -1;
+}
+
+/**
+ * Value of the attribute at path, like getString() used to do it.
+ */
+static std::string old_getString(SimpleXMLTransfer* item, std::string path)
+{
+  std::string::size_type pos = path.rfind('.');
+
+  if (pos != std::string::npos)
+  {
+    std::string child = path.substr(0, pos);
+    std::string::size_type dot;
+
+    path = path.substr(pos + 1);
+    do
+    {
+      dot = child.find('.');
+      int index = old_indexOfChild(item, child.substr(0, dot));
+      if (index < 0)
+        throw XMLException("No item named " + child);
+      item = item->getChildAt(index);
+      if (dot != std::string::npos)
+        child = child.substr(dot + 1);
+    }
+    while (dot != std::string::npos);
+  }
+
+  for (int i = 0; i < item->getAttributeCount(); i++)
+    if (path.compare(item->attributeName(i)) == 0)
+      return item->attributeVal(i);
+
+  throw XMLException("No Attribute named " + path);
+}
+
+/**
+ * Collects the paths of all attributes which can be reached.
+ */
+static void collect(SimpleXMLTransfer* item, std::string prefix,
+                    std::vector<std::string>& paths)
+{
+  for (int i = 0; i < item->getAttributeCount(); i++)
+  {
+    std::string name = item->attributeName(i);
+    if (name.find('.') == std::string::npos && item->indexOfAttribute(name) == i)
+      paths.push_back(prefix + name);
+  }
+
+  for (int i = 0; i < item->getChildCount(); i++)
+  {
+    SimpleXMLTransfer* child = item->getChildAt(i);
+    std::string        name  = child->getName();
+    if (name.find('.') == std::string::npos && item->indexOfChild(name) == i)
+      collect(child, prefix + name + ".", paths);
+  }
+}
+
+/**
+ * Looks up all paths of a document in all three ways, returns the
+ * number of errors.
+ */
+static int run(const char* descr, SimpleXMLTransfer* xml, int nRounds)
+{
+  std::vector<std::string> paths;
+  std::vector<XMLHandle>   handles;
+  int                      nErrors = 0;
+  size_t                   nChars  = 0;
+  double                   dTime[3];
+
+  collect(xml, "", paths);
+  for (unsigned int n = 0; n < paths.size(); n++)
+  {
+    handles.push_back(xml->getHandle(paths[n]));
+
+    std::string val = old_getString(xml, paths[n]);
+    if (xml->getString(paths[n]) != val || handles[n].getString() != val)
+    {
+      printf("  %s: different values\n", paths[n].c_str());
+      nErrors++;
+    }
+  }
+  if (paths.size() == 0)
+    return nErrors;
+
+  for (int v = 0; v < 3; v++)
+  {
+    clock_t start = clock();
+    for (int r = 0; r < nRounds; r++)
+    {
+      for (unsigned int n = 0; n < paths.size(); n++)
+      {
+        switch (v)
+        {
+         case 0:
+          nChars += old_getString(xml, paths[n]).length();
+          break;
+         case 1:
+          nChars += xml->getString(paths[n]).length();
+          break;
+         default:
+          nChars += handles[n].getString().length();
+          break;
+        }
+      }
+    }
+    dTime[v] = (double)(clock()-start)/CLOCKS_PER_SEC;
+  }
+
+  double dLookups = (double)nRounds * paths.size();
+  printf("%-30s %6i paths, ns/lookup: old %7.1f  getString %7.1f  handle %7.1f\n",
+         descr, (int)paths.size(),
+         1e9*dTime[0]/dLookups, 1e9*dTime[1]/dLookups, 1e9*dTime[2]/dLookups);
+
+  // keeps the compiler from dropping the lookups
+  if (nChars == 0)
+    printf("  no values\n");
+
+  return nErrors;
+}
+
+/**
+ * Renames the last child of the document and removes the first one,
+ * then checks that children are found by their new names only. Reading
+ * a default from a handle must not create the attribute.
+ */
+static int checkChanges(SimpleXMLTransfer* xml)
+{
+  int                nErrors = 0;
+  int                nLast   = xml->getChildCount() - 1;
+  SimpleXMLTransfer* last    = xml->getChildAt(nLast);
+  std::string        name    = last->getName();
+
+  last->setName("renamed_section");
+  if (xml->indexOfChild("renamed_section") != nLast)
+  {
+    printf("  renamed child not found\n");
+    nErrors++;
+  }
+  if (xml->indexOfChild(name) != old_indexOfChild(xml, name))
+  {
+    printf("  %s still found after renaming it\n", name.c_str());
+    nErrors++;
+  }
+
+  SimpleXMLTransfer* first = xml->getChildAt(0);
+  xml->removeChildAt(0);
+  if (xml->indexOfChild("renamed_section") != nLast - 1)
+  {
+    printf("  renamed child not found after removing another one\n");
+    nErrors++;
+  }
+  first->setName("removed_section");
+  if (xml->indexOfChild("removed_section") >= 0)
+  {
+    printf("  removed child still found\n");
+    nErrors++;
+  }
+  delete first;
+
+  XMLHandle handle     = xml->getHandle("renamed_section.no_such_attribute");
+  int       nAttribute = last->getAttributeCount();
+  if (handle.getInt(42) != 42 || handle.exists() || last->getAttributeCount() != nAttribute)
+  {
+    printf("  default value has changed the document\n");
+    nErrors++;
+  }
+
+  return nErrors;
+}
+
+int main(int argc, char** argv)
+{
+  int                             nRounds = 100;
+  int                             nErrors = 0;
+  std::vector<SimpleXMLTransfer*> docs;
+  SimpleXMLTransfer*              config  = new SimpleXMLTransfer();
+
+  config->setName("crrcsimConfig");
+
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "-n") == 0 && i+1 < argc)
+      nRounds = atoi(argv[++i]);
+    else
+    {
+      try
+      {
+        SimpleXMLTransfer* xml = new SimpleXMLTransfer(std::string(argv[i]));
+        const char*        name = strrchr(argv[i], '/');
+
+        name = (name == NULL) ? argv[i] : name + 1;
+        nErrors += run(name, xml, nRounds);
+
+        // one section per file
+        std::string section = name;
+        section = section.substr(0, section.find('.'));
+        xml->setName(section);
+        config->addChild(xml);
+      }
+      catch (XMLException e)
+      {
+        printf("%s: %s\n", argv[i], e.what());
+        nErrors++;
+      }
+    }
+  }
+
+  if (config->getChildCount() > 1)
+  {
+    nErrors += run("all files in one document", config, nRounds);
+    nErrors += checkChanges(config);
+  }
+
+  delete config;
+
+  printf("%i errors\n", nErrors);
+  return nErrors;
+}
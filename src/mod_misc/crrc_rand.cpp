@@ -23,63 +23,122 @@
 
 #include <cmath>
 
-unsigned int CRRC_Random::uRandState16;
-unsigned int CRRC_Random::uRandState32;
+#ifndef M_PI
+# define M_PI 3.14159265359
+#endif
 
-void CRRC_Random::insertData(int nData)
+uint64_t CRRC_Random::uSeed          = 0;
+bool     CRRC_Random::fDeterministic = false;
+
+uint64_t CRRC_Random::streamId(const char* name)
 {
-  uRandState16 += nData;
+  // FNV-1a
+  uint64_t id = 0xCBF29CE484222325ULL;
   
-  const int a = 1103515245;
-  const int c = 12345;
-  uRandState16 = (a * uRandState16 + c) % 0x7FFF;
+  while (*name)
+  {
+    id ^= (unsigned char)*name++;
+    id *= 0x100000001B3ULL;
+  }
   
-  uRandState32 = (uRandState32 << 5) ^ (uRandState16 << 3) ^ nData;
+  return(id);
+}
+
+CRRC_RandomStream::CRRC_RandomStream()
+{
+  seed(0, 0);
+}
+
+CRRC_RandomStream::CRRC_RandomStream(uint64_t nSeed, uint64_t nStream)
+{
+  seed(nSeed, nStream);
+}
+
+void CRRC_RandomStream::seed(uint64_t nSeed, uint64_t nStream)
+{
+  uSeed   = nSeed;
+  uStream = nStream;
+  // Both values are mixed, so similar seeds or stream ids don't
+  // lead to similar keys.
+  uKey    = mix64(mix64(nSeed) ^ (nStream + GAMMA));
+  setCounter(0);
+}
+
+void CRRC_RandomStream::setCounter(uint64_t nCounter)
+{
+  uCounter   = nCounter;
+  fGaussNext = false;
+}
+
+double CRRC_RandomStream::gauss()
+{
+  if (fGaussNext)
+  {
+    fGaussNext = false;
+    return(dGaussNext);
+  }
   
-  //  std::cout << uRandState32 << "\n";
-  // Histogramm of uRandState32, test with 106557 values:
-  // Only two values occured twice, all the others only once.
-  // Groups showed good distribution:
-  //    1000:   most once, lots two times, 10 three times.
-  //    2000:   like 1000, but more three times, one four times.
-  //    5000:   everything fine
-  //   50000:   everything fine
-  //  500000:   everything fine
-  // Value over time is equally distributed, too.
+  // Box-Muller. u1 is in (0, 1], so log(u1) is finite.
+  double u1  = 1.0 - uniform();
+  double u2  = uniform();
+  double r   = sqrt(-2 * log(u1));
+  double phi = 2 * M_PI * u2;
   
-  srand(uRandState32);
+  dGaussNext = r * sin(phi);
+  fGaussNext = true;
+  
+  return(r * cos(phi));
 }
 
-RandGauss::RandGauss()
+void CRRC_RandomStream::uniform(double* dst, int n)
 {
-  phase = 0;
+  const uint64_t base = uKey + uCounter * GAMMA;
+  
+  for (int i=0; i<n; i++)
+    dst[i] = (mix64(base + (uint64_t)(i+1) * GAMMA) >> 11) * (1.0/9007199254740992.0);
+  
+  uCounter += n;
 }
 
-double RandGauss::Get()
+void CRRC_RandomStream::gauss(double* dst, int n)
 {
-  double S, Z, U1, U2, V1;
+  // The values are generated in pairs from two uniform numbers each,
+  // so first fill dst with uniform numbers and then transform them
+  // in place. An odd element at the end gets a pair of its own.
+  int nEven = n & ~1;
   
-  if (phase)
-    Z = V2 * fac;
-  else
+  uniform(dst, nEven);
+  for (int i=0; i<nEven; i+=2)
   {
-    do
-    {
-      U1 = (double)rand() / RAND_MAX;
-      U2 = (double)rand() / RAND_MAX;
-
-      V1 = 2 * U1 - 1;
-      V2 = 2 * U2 - 1;
-      S = V1 * V1 + V2 * V2;
-    }
-    while(S >= 1);
-
-    fac = sqrt (-2 * log(S) / S);
-    Z = V1 * fac;
+    double r   = sqrt(-2 * log(1.0 - dst[i]));
+    double phi = 2 * M_PI * dst[i+1];
+    
+    dst[i]   = r * cos(phi);
+    dst[i+1] = r * sin(phi);
   }
+  
+  if (n & 1)
+  {
+    fGaussNext = false;
+    dst[n-1]   = gauss();
+  }
+}
 
-  phase = 1 - phase;
+RandGauss::RandGauss()
+{
+}
 
-  return Z;  
+void RandGauss::seed(const char* name)
+{
+  rnd = CRRC_Random::createStream(name);
 }
 
+void RandGauss::seed(const char* name, uint64_t nNumber)
+{
+  rnd = CRRC_Random::createStream(name, nNumber);
+}
+
+double RandGauss::Get()
+{
+  return(rnd.gauss());
+}
@@ -22,38 +22,129 @@
 #ifndef CRRC_RAND
 #define CRRC_RAND
 
-#include <stdlib.h>
+#include <stdint.h>
 
 /**
- * This is just a wrapper around standard functions rand and srand which
- * allows for easy re-seeding.
+ * A counter-based pseudo random number generator.
  * 
- * From libc manual:
+ * The n-th number of a stream is calculated directly from
+ * (key, n) by the SplitMix64 finalizer:
  * 
- * All functions have in common that they use the same congruential formula 
- * with the same constants. The formula is
+ *    x = key + n * 0x9E3779B97F4A7C15
+ *    y = mix64(x)
  * 
- *    Y = (a * X + c) mod m
- *
- * where X is the state of the generator at the beginning and Y the state at
- * the end. a and c are constants determining the way the generator works.
- * By default they are
- *
- *     a = 0x5DEECE66D = 25214903917
- *     c = 0xb = 11
- *
- * From man rand:
- *  POSIX 1003.1?2003 gives the following example of an implementation of 
- *  rand() and srand(), possibly useful when one needs the same sequence
- *  on two different machines.
- *
- *       static unsigned long next = 1;
- *       * 
- *       // RAND_MAX assumed to be 32767 
- *       int myrand(void) {
- *       next = next * 1103515245 + 12345;
- *       return((unsigned)(next/65536) % 32768);
- *       }
+ * The key is derived from a seed and a stream id, so every
+ * consumer (windfield, each FDM noise source...) can have its own
+ * stream of numbers which does not depend on how often anybody else
+ * draws numbers. There is no hidden global state, a stream can be
+ * saved and restored by its counter and different streams can be
+ * used from different threads without locking.
+ * 
+ * As the numbers do not depend on each other, filling an array with
+ * uniform() or gauss() values is a loop without dependencies between
+ * iterations which the compiler can vectorize.
+ * 
+ * SplitMix64 passes BigCrush, which is a lot better than the
+ * libc rand() used before.
+ */
+class CRRC_RandomStream
+{
+  public:
+   
+   /**
+    * Creates an unseeded stream (seed 0, stream 0).
+    */
+   CRRC_RandomStream();
+   
+   CRRC_RandomStream(uint64_t nSeed, uint64_t nStream);
+   
+   /**
+    * Restarts the stream with a new seed and stream id.
+    */
+   void seed(uint64_t nSeed, uint64_t nStream);
+   
+   uint64_t getSeed()    const { return(uSeed);    };
+   uint64_t getStream()  const { return(uStream);  };
+   
+   /**
+    * Number of 64 bit values drawn so far. Together with seed and
+    * stream id this is the complete state of the stream.
+    */
+   uint64_t getCounter() const { return(uCounter); };
+   
+   /**
+    * Jump to a position in the stream, for example to restore a
+    * state saved using getCounter().
+    */
+   void     setCounter(uint64_t nCounter);
+   
+   /**
+    * Returns the next 64 bits.
+    */
+   uint64_t next64()
+   {
+     return(mix64(uKey + (++uCounter) * GAMMA));
+   };
+   
+   /**
+    * Returns the next 32 bits.
+    */
+   uint32_t next32()
+   {
+     return((uint32_t)(next64() >> 32));
+   };
+   
+   /**
+    * Returns a uniformly distributed number in [0, 1).
+    */
+   double uniform()
+   {
+     return((next64() >> 11) * (1.0/9007199254740992.0));
+   };
+   
+   /**
+    * Returns a number with standard normal distribution
+    * (mean 0, variance 1).
+    */
+   double gauss();
+   
+   /**
+    * Fills dst with n uniformly distributed numbers in [0, 1).
+    */
+   void uniform(double* dst, int n);
+   
+   /**
+    * Fills dst with n numbers with standard normal distribution.
+    */
+   void gauss(double* dst, int n);
+
+   static uint64_t mix64(uint64_t x)
+   {
+     x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+     x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+     return(x ^ (x >> 31));
+   };
+   
+  private:
+   
+   static const uint64_t GAMMA = 0x9E3779B97F4A7C15ULL;
+   
+   uint64_t uSeed;
+   uint64_t uStream;
+   uint64_t uKey;
+   uint64_t uCounter;
+   
+   /**
+    * gauss() creates two values at once, the second one is kept here.
+    */
+   double   dGaussNext;
+   bool     fGaussNext;
+};
+
+/**
+ * Holds the seed of the simulation. Every random number consumer
+ * derives its own CRRC_RandomStream from it, so a run can be repeated
+ * by using the same seed again (config file: simulation.random.seed).
  * 
  * @author Jens Wilhelm Wulf
  */
@@ -62,30 +153,60 @@ class CRRC_Random
   public:
    
    /**
-    * Returns a random number between 0 and max().
+    * Sets the seed of the simulation. Streams which have already been
+    * created are not affected.
     */
-   static inline int rand() { return(::rand()); };
-
-   static inline int max() { return(RAND_MAX); };
+   static void     setSeed(uint64_t nSeed) { uSeed = nSeed; };
+   
+   static uint64_t getSeed() { return(uSeed); };
    
    /**
-    * Call this using some random data you have, anytime you want to.
+    * In deterministic mode (option -e) the flight models restart
+    * their streams with every launch, so a recorded flight can be
+    * replayed. Otherwise every launch gets numbers of its own.
     */
-   static void insertData(int nData);
+   static void     setDeterministic(bool fDet) { fDeterministic = fDet; };
    
-  private:
+   static bool     isDeterministic() { return(fDeterministic); };
+   
+   /**
+    * Returns a stream id for some name, e.g. "windfield".
+    */
+   static uint64_t streamId(const char* name);
+   
+   /**
+    * Returns a stream id for some name and a number which tells
+    * several streams of the same consumer apart. Number 0 gives the
+    * id of the name alone.
+    */
+   static uint64_t streamId(const char* name, uint64_t nNumber)
+   {
+     return(streamId(name) ^ CRRC_RandomStream::mix64(nNumber));
+   };
    
    /**
-    * random state
+    * Returns a new stream for the consumer <code>name</code>, seeded
+    * with the seed of the simulation.
     */
-   static unsigned int uRandState16;
-   static unsigned int uRandState32;
+   static CRRC_RandomStream createStream(const char* name)
+   {
+     return(CRRC_RandomStream(uSeed, streamId(name)));
+   };
    
+   static CRRC_RandomStream createStream(const char* name, uint64_t nNumber)
+   {
+     return(CRRC_RandomStream(uSeed, streamId(name, nNumber)));
+   };
+   
+  private:
+   
+   static uint64_t uSeed;
+   static bool     fDeterministic;
 };
 
 /**
  * Based on the code from mod_windfield/windfield.cpp, which in turn is
- * by rhoads@paul.rutgers.edu.
+ * by rhoads@paul.rutgers.edu. Now just a gaussian CRRC_RandomStream.
  * 
  * @author Jens W. Wulf
  */
@@ -93,11 +214,23 @@ class RandGauss
 {
 public:
   RandGauss();
+  
+  /**
+   * Seeds the generator with the seed of the simulation and the 
+   * stream id of <code>name</code>.
+   */
+  void   seed(const char* name);
+  
+  /**
+   * Seeds the generator with stream nNumber of <code>name</code>,
+   * see CRRC_Random::streamId().
+   */
+  void   seed(const char* name, uint64_t nNumber);
+  
   double Get();
+  
 private:
-  double V2, fac;
-  int phase;
+  CRRC_RandomStream rnd;
 };
 
 #endif
-
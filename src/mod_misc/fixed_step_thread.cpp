@@ -0,0 +1,173 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+/** \file fixed_step_thread.cpp
+ *
+ *  A thread which runs steps at a fixed rate of the wall clock.
+ */
+
+#include <SDL.h>
+#include <SDL_thread.h>
+#include <cstdio>
+
+#include "fixed_step_thread.h"
+#include "scheduler.h"
+
+/// steps which may be run back to back, the rest is skipped
+#define FIXED_STEP_MAX_BEHIND  (50)
+
+
+FixedStepThread::FixedStepThread(double dStep)
+  : dStep(dStep), dStart(0), stepper(NULL), ulThreadID(0), fStop(false),
+    nSteps(0), nSkipped(0), nWakeups(0), nMaxBurst(0),
+    dTotalLate(0), dMaxLate(0)
+{
+  mutex = SDL_CreateMutex();
+}
+
+
+FixedStepThread::~FixedStepThread()
+{
+  stop();
+  SDL_DestroyMutex(mutex);
+}
+
+
+void FixedStepThread::start()
+{
+  if (stepper != NULL)
+    return;
+
+  // the thread takes the lock before its first step, so it sees
+  // ulThreadID
+  lock();
+  fStop      = false;
+  dStart     = Scheduler::getSeconds();
+  stepper    = SDL_CreateThread(thread, this);
+  ulThreadID = (stepper != NULL) ? SDL_GetThreadID(stepper) : 0;
+  unlock();
+}
+
+
+void FixedStepThread::stop()
+{
+  if (stepper == NULL)
+    return;
+
+  lock();
+  fStop = true;
+  unlock();
+  SDL_WaitThread(stepper, NULL);
+  stepper = NULL;
+}
+
+
+void FixedStepThread::lock()
+{
+  SDL_LockMutex(mutex);
+}
+
+
+void FixedStepThread::unlock()
+{
+  SDL_UnlockMutex(mutex);
+}
+
+
+bool FixedStepThread::isCurrentThread() const
+{
+  return stepper != NULL && SDL_ThreadID() == ulThreadID;
+}
+
+
+int FixedStepThread::thread(void* self)
+{
+  ((FixedStepThread*)self)->run();
+  return 0;
+}
+
+
+void FixedStepThread::run()
+{
+  unsigned long nNext = 0;   // next step to run
+
+  for (;;)
+  {
+    double now  = Scheduler::getSeconds();
+    long   nDue = (long)((now - dStart) / dStep) + 1 - (long)nNext;
+
+    if (nDue <= 0)
+    {
+      // SDL_Delay() sleeps at least 1 ms, don't oversleep a short step
+      if (getStepTime(nNext) - now > 0.0015)
+        SDL_Delay(1);
+      else
+        SDL_Delay(0);
+      continue;
+    }
+
+    lock();
+    if (fStop)
+    {
+      unlock();
+      break;
+    }
+
+    // another thread might have held the lock for a while
+    nDue = (long)((Scheduler::getSeconds() - dStart) / dStep) + 1 - (long)nNext;
+    if (nDue > FIXED_STEP_MAX_BEHIND)
+    {
+      nSkipped += nDue - FIXED_STEP_MAX_BEHIND;
+      nNext    += nDue - FIXED_STEP_MAX_BEHIND;
+      nDue      = FIXED_STEP_MAX_BEHIND;
+    }
+    for (long i = 0; i < nDue; i++)
+    {
+      double dLate = Scheduler::getSeconds() - getStepTime(nNext);
+      dTotalLate += dLate;
+      if (dLate > dMaxLate)
+        dMaxLate = dLate;
+
+      Step(nNext);
+      nNext++;
+      nSteps++;
+    }
+    nWakeups++;
+    if ((unsigned long)nDue > nMaxBurst)
+      nMaxBurst = nDue;
+    unlock();
+  }
+}
+
+
+void FixedStepThread::printStats(std::ostream& out)
+{
+  char line[200];
+
+  if (nSteps == 0)
+    return;
+
+  snprintf(line, sizeof(line),
+           "Steps: %lu of %.2f ms, skipped %lu, late avg %.3f ms max %.3f ms, steps per wakeup avg %.2f max %lu",
+           nSteps, 1e3*dStep, nSkipped,
+           1e3*dTotalLate/nSteps, 1e3*dMaxLate,
+           (double)nSteps/nWakeups, nMaxBurst);
+  out << line << std::endl;
+}
@@ -0,0 +1,111 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+/** \file fixed_step_thread.h
+ *
+ *  A thread which runs steps at a fixed rate of the wall clock.
+ */
+
+#ifndef FIXED_STEP_THREAD_H
+#define FIXED_STEP_THREAD_H
+
+#include <iostream>
+
+struct SDL_Thread;
+struct SDL_mutex;
+
+
+/**
+ *  Calls Step() once per step period on its own thread. Step n is
+ *  due at getStepTime(n); steps which are late are run back to back.
+ *  If the thread falls behind by more than a few steps (the machine
+ *  was busy, a debugger stopped it), the missing steps are skipped.
+ *
+ *  Steps run with the lock held. Other threads take the lock while
+ *  they work on data which is changed by Step().
+ *
+ *  Derived classes have to call stop() in their destructor, Step()
+ *  must not be called on a partly destroyed object.
+ */
+class FixedStepThread
+{
+  public:
+    /**
+     *  \param dStep  step period in seconds
+     */
+    FixedStepThread(double dStep);
+
+    virtual ~FixedStepThread();
+
+    /// Starts the thread, step 0 is due now
+    void start();
+
+    /// Stops the thread after the current steps
+    void stop();
+
+    void lock();
+    void unlock();
+
+    /// True if called by the stepping thread
+    bool isCurrentThread() const;
+
+    double getStep() const { return dStep; };
+
+    /// Wall clock time (Scheduler::getSeconds()) at which step n is due
+    double getStepTime(unsigned long nStep) const { return dStart + nStep*dStep; };
+
+    /**
+     *  Prints how late the steps have been.
+     */
+    void printStats(std::ostream& out);
+
+  protected:
+    /**
+     *  Runs step nStep, with the lock held. It is due at
+     *  getStepTime(nStep); after skipped steps nStep jumps ahead, so
+     *  it is not the number of steps which have been run.
+     */
+    virtual void Step(unsigned long nStep) = 0;
+
+  private:
+    static int thread(void* self);
+    void run();
+
+    // not copyable
+    FixedStepThread(const FixedStepThread&);
+    FixedStepThread& operator=(const FixedStepThread&);
+
+    double        dStep;
+    double        dStart;       ///< time of step 0
+    SDL_Thread*   stepper;
+    unsigned long ulThreadID;
+    SDL_mutex*    mutex;
+    bool          fStop;
+
+    // statistics
+    unsigned long nSteps;
+    unsigned long nSkipped;     ///< steps which have not been run
+    unsigned long nWakeups;     ///< times the thread had steps to run
+    unsigned long nMaxBurst;    ///< most steps in one wakeup
+    double        dTotalLate;   ///< sum of the start delays in s
+    double        dMaxLate;     ///< longest start delay in s
+};
+
+#endif
@@ -0,0 +1,351 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+/**
+ * \file fixed_step_thread_test.cpp
+ *
+ * Latency and jitter of the displayed simulation state, with the
+ * simulation in the main loop and on a FixedStepThread.
+ *
+ * Usage: fixed_step_thread_test [-n frames] [-f frame_ms]
+ *                               [-s spike_ms] [-k spike_every] [-b]
+ *                               [-x stall_ms]
+ *
+ * A toy model moves at constant speed, so its true position is known
+ * for every point in time. Every frame the renderer takes frame_ms
+ * (default 10), every spike_every'th frame (default 20) it takes
+ * spike_ms (default 60) instead. With -b the renderer keeps the CPU
+ * busy, otherwise it sleeps.
+ *
+ * In the first run the main loop catches up on all steps which are
+ * due before every frame and displays the last one, like
+ * SimStateHandler::idle() with multiloop. In the second run the steps
+ * are done by a FixedStepThread which publishes every step through a
+ * TripleBuffer, the main loop interpolates between the last two steps
+ * like SimThread::updateDisplay(). In the middle of this run the
+ * main loop holds the thread's lock for stall_ms (default 500), so
+ * the thread has to skip steps; the time published with every step
+ * has to stay the time at which it was due.
+ *
+ * For both runs the time by which the displayed position lags the
+ * true one (avg, standard deviation, max) and how late the steps
+ * were started is printed. The return value is the number of
+ * snapshots which were torn or older than the one before, plus the
+ * number of steps published with a wrong time.
+ */
+#include <SDL.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <math.h>
+
+#include "fixed_step_thread.h"
+#include "triple_buffer.h"
+#include "scheduler.h"
+
+/// default FDM step (simulation.flightModel.dt)
+#define FDM_DT     0.002777
+
+/// steps which are caught up on at most, like FIXED_STEP_MAX_BEHIND
+#define MAX_BEHIND 50
+
+/// speed of the toy model, position units per second
+#define SPEED      10.0
+
+/// size of the model state; all of it is checked for torn copies
+#define STATE_SIZE 64
+
+
+/**
+ * State of the toy model after step n: all values are n.
+ */
+typedef struct
+{
+  unsigned long n;
+  double        x[STATE_SIZE];
+} T_State;
+
+/**
+ * Like T_SimSnapshot
+ */
+typedef struct
+{
+  double  dTime;
+  T_State cur;
+  T_State prev;
+} T_Snapshot;
+
+
+/// keeps the work in doStep() from being optimized away
+static volatile double dWork;
+
+
+/**
+ * Makes the model take some time per step.
+ */
+static void doStep(T_State& state)
+{
+  double sum = 0;
+
+  for (int i = 0; i < 2000; i++)
+    sum += sin(i * 0.001);
+  dWork = sum;
+
+  state.n++;
+  for (int i = 0; i < STATE_SIZE; i++)
+    state.x[i] = (double)state.n;
+}
+
+
+static double position(const T_State& state)
+{
+  return SPEED * state.n * FDM_DT;
+}
+
+
+static bool isTorn(const T_State& state)
+{
+  for (int i = 0; i < STATE_SIZE; i++)
+    if (state.x[i] != (double)state.n)
+      return true;
+  return false;
+}
+
+
+/**
+ * Renders a frame: waits or keeps the CPU busy.
+ */
+static void render(double dSeconds, bool fBusy)
+{
+  if (fBusy)
+  {
+    double dEnd = Scheduler::getSeconds() + dSeconds;
+    while (Scheduler::getSeconds() < dEnd)
+      ;
+  }
+  else
+    SDL_Delay((Uint32)(1e3 * dSeconds + 0.5));
+}
+
+
+/**
+ * Lag of the displayed position behind the true one, in seconds.
+ */
+class LagStats
+{
+  public:
+    LagStats() : nCount(0), dSum(0), dSum2(0), dMax(0) {};
+
+    void add(double dLag)
+    {
+      nCount++;
+      dSum  += dLag;
+      dSum2 += dLag*dLag;
+      if (fabs(dLag) > dMax)
+        dMax = fabs(dLag);
+    }
+
+    void print(const char* name)
+    {
+      double dAvg = dSum / nCount;
+      double dDev = sqrt(fabs(dSum2 / nCount - dAvg*dAvg));
+
+      printf("%s: displayed lag avg %.3f ms, jitter %.3f ms, max %.3f ms\n",
+             name, 1e3*dAvg, 1e3*dDev, 1e3*dMax);
+    }
+
+  private:
+    int    nCount;
+    double dSum;
+    double dSum2;
+    double dMax;
+};
+
+
+/**
+ * Steps the toy model like SimThread.
+ */
+class ModelThread : public FixedStepThread
+{
+  public:
+    ModelThread() : FixedStepThread(FDM_DT), nWrongTime(0)
+    {
+      memset(&state, 0, sizeof(state));
+    }
+
+    ~ModelThread()
+    {
+      stop();
+    }
+
+    TripleBuffer<T_Snapshot> snapshots;
+
+    /// steps which were run long after the time they were published with
+    int nWrongTime;
+
+  protected:
+    void Step(unsigned long nStep)
+    {
+      T_Snapshot& snap = snapshots.getWriteBuffer();
+
+      snap.prev  = state;
+      doStep(state);
+      snap.cur   = state;
+      snap.dTime = getStepTime(nStep + 1);
+      snapshots.publish();
+
+      // at most MAX_BEHIND steps are caught up on, anything later has
+      // been skipped
+      if (Scheduler::getSeconds() - snap.dTime > (MAX_BEHIND + 10) * FDM_DT)
+        nWrongTime++;
+    }
+
+  private:
+    T_State state;
+};
+
+
+int main(int argc, char** argv)
+{
+  int    nFrames = 150;
+  double dFrame  = 0.010;
+  double dSpike  = 0.060;
+  int    nSpike  = 20;
+  bool   fBusy   = false;
+  double dStall  = 0.500;
+  int    nErrors = 0;
+
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "-n") == 0 && i+1 < argc)
+      nFrames = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-f") == 0 && i+1 < argc)
+      dFrame = 1e-3 * atof(argv[++i]);
+    else if (strcmp(argv[i], "-s") == 0 && i+1 < argc)
+      dSpike = 1e-3 * atof(argv[++i]);
+    else if (strcmp(argv[i], "-k") == 0 && i+1 < argc)
+      nSpike = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-b") == 0)
+      fBusy = true;
+    else if (strcmp(argv[i], "-x") == 0 && i+1 < argc)
+      dStall = 1e-3 * atof(argv[++i]);
+  }
+  if (nSpike < 1)
+    nSpike = 1;
+
+  printf("%i frames of %.1f ms, every %i. frame %.1f ms, %s renderer, step %.3f ms\n",
+         nFrames, 1e3*dFrame, nSpike, 1e3*dSpike, fBusy ? "busy" : "sleeping", 1e3*FDM_DT);
+
+  // the simulation in the main loop
+  {
+    T_State       state;
+    LagStats      lag;
+    double        dLateSum = 0;
+    double        dLateMax = 0;
+    unsigned long nSteps   = 0;
+    double        dStart   = Scheduler::getSeconds();
+
+    memset(&state, 0, sizeof(state));
+    for (int f = 0; f < nFrames; f++)
+    {
+      double now  = Scheduler::getSeconds();
+      long   nDue = (long)((now - dStart) / FDM_DT) + 1 - (long)state.n;
+
+      if (nDue > MAX_BEHIND)
+      {
+        // skipped steps move the model's time, not its position
+        dStart += (nDue - MAX_BEHIND) * FDM_DT;
+        nDue    = MAX_BEHIND;
+      }
+      for (long i = 0; i < nDue; i++)
+      {
+        double dLate = Scheduler::getSeconds() - (dStart + state.n*FDM_DT);
+        dLateSum += dLate;
+        if (dLate > dLateMax)
+          dLateMax = dLate;
+        doStep(state);
+        nSteps++;
+      }
+
+      now = Scheduler::getSeconds();
+      lag.add(now - dStart - position(state) / SPEED);
+
+      render((f % nSpike == nSpike - 1) ? dSpike : dFrame, fBusy);
+    }
+    lag.print("main loop");
+    printf("Steps: %lu, late avg %.3f ms max %.3f ms\n",
+           nSteps, nSteps ? 1e3*dLateSum/nSteps : 0, 1e3*dLateMax);
+  }
+
+  // the simulation on its own thread
+  {
+    ModelThread   model;
+    LagStats      lag;
+    unsigned long nLast = 0;
+    bool          fHave = false;
+    int           nErr  = 0;
+
+    model.start();
+    for (int f = 0; f < nFrames; f++)
+    {
+      if (model.snapshots.update())
+        fHave = true;
+
+      if (fHave)
+      {
+        const T_Snapshot& snap = model.snapshots.getReadBuffer();
+
+        if (isTorn(snap.cur) || isTorn(snap.prev) || snap.cur.n != snap.prev.n + 1)
+          nErr++;
+        if (snap.cur.n < nLast)
+          nErr++;
+        nLast = snap.cur.n;
+
+        double now = Scheduler::getSeconds();
+        double a   = (now - snap.dTime) / model.getStep() + 1;
+        if (a < 0)
+          a = 0;
+        else if (a > 1)
+          a = 1;
+
+        double x      = position(snap.prev) + a * (position(snap.cur) - position(snap.prev));
+        double dModel = snap.dTime - position(snap.cur) / SPEED;  // time of step 0
+        lag.add(now - dModel - x / SPEED);
+      }
+
+      render((f % nSpike == nSpike - 1) ? dSpike : dFrame, fBusy);
+
+      if (f == nFrames / 2 && dStall > 0)
+      {
+        model.lock();
+        render(dStall, fBusy);
+        model.unlock();
+      }
+    }
+    model.stop();
+
+    lag.print("thread");
+    model.printStats(std::cout);
+    printf("torn or old snapshots: %i, steps published with a wrong time: %i\n",
+           nErr, model.nWrongTime);
+    nErrors += nErr + model.nWrongTime;
+  }
+
+  return nErrors;
+}
@@ -23,51 +23,300 @@
   
 
 #include <iostream>
+#include <algorithm>
+#include <cstdio>
 #include "scheduler.h"
 using namespace std;
 
-Scheduler::Scheduler() {};
+#ifdef WIN32
+# include <windows.h>
+#else
+# include <sys/time.h>
+#endif
+
+/// default time budget for tasks which are not critical, in seconds
+#define SCHEDULER_DEFAULT_BUDGET  (0.002)
+
+
+double Scheduler::getSeconds()
+{
+#ifdef WIN32
+  LARGE_INTEGER freq;
+  LARGE_INTEGER count;
+  QueryPerformanceFrequency(&freq);
+  QueryPerformanceCounter(&count);
+  return (double)count.QuadPart / freq.QuadPart;
+#else
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + 1e-6*tv.tv_usec;
+#endif
+}
+
+/**
+ *  A due task: its index and how late it is in ms.
+ */
+typedef struct
+{
+  int           nIndex;
+  int           nPrio;
+  unsigned long ulLate;
+} T_DueTask;
+
+/**
+ *  Sort by priority, the most overdue first.
+ */
+static bool dueOrder(const T_DueTask& a, const T_DueTask& b)
+{
+  if (a.nPrio != b.nPrio)
+    return a.nPrio < b.nPrio;
+  return a.ulLate > b.ulLate;
+}
+
+
+Scheduler::Scheduler()
+{
+  dFrameBudget = SCHEDULER_DEFAULT_BUDGET;
+  fRunning     = false;
+  fRemoved     = false;
+}
+
 Scheduler::~Scheduler() {};
 
-void Scheduler::Register( void *object)
+void Scheduler::Register(RunnableObject* object, std::string name,
+                         T_Priority prio, unsigned long ulPeriod, T_Clock clock)
 {
-  cout << "Scheduler::Register("<< object << ")" << endl;
-  lObject.push_back( object);
+  cout << "Scheduler::Register("<< object << ", " << name << ")" << endl;
+
+  T_Task task;
+  task.object          = object;
+  task.clock           = clock;
+  task.ulPeriod        = ulPeriod;
+  task.ulNextDue       = 0;
+  task.ulLastTime      = 0;
+  task.fStarted        = false;
+  task.stats.name      = name;
+  task.stats.prio      = prio;
+  task.stats.nRuns     = 0;
+  task.stats.nDeferred = 0;
+  task.stats.nMissed   = 0;
+  task.stats.dTotal    = 0;
+  task.stats.dMax      = 0;
+
+  object->myScheduler = this;
+  tasks.push_back(task);
 }
 
-void Scheduler::UnRegister( void *object)
+void Scheduler::UnRegister(RunnableObject* object)
 {
-  lObject.remove( object);
+  for (unsigned int n = 0; n < tasks.size(); n++)
+  {
+    if (tasks[n].object == object)
+    {
+      // Run() is iterating over the tasks, remove it afterwards
+      if (fRunning)
+      {
+        tasks[n].object = NULL;
+        fRemoved        = true;
+      }
+      else
+        tasks.erase(tasks.begin() + n);
+      break;
+    }
+  }
   cout << "Scheduler::UnRegister("<< object << ")" << endl;
 }
 
-void Scheduler::Run()
+void Scheduler::Run(unsigned long ulWallTime, unsigned long ulSimTime)
 {
-  list<void *>::iterator _it;
+  std::vector<T_DueTask> due;
+  double                 dUsed = 0;
+
   // cout << "Scheduler::Run" << endl;
-  for( _it= lObject.begin(); _it!= lObject.end(); _it++)
+  for (unsigned int n = 0; n < tasks.size(); n++)
   {
-    ((RunnableObject *)(*_it))-> Run();
+    T_Task&       task  = tasks[n];
+    unsigned long ulNow = (task.clock == SIM_TIME) ? ulSimTime : ulWallTime;
+
+    // first run or the clock has been reset
+    if (!task.fStarted || ulNow < task.ulLastTime)
+    {
+      task.ulNextDue = ulNow;
+      task.fStarted  = true;
+    }
+    task.ulLastTime = ulNow;
+
+    if (ulNow >= task.ulNextDue)
+    {
+      T_DueTask d;
+      d.nIndex = n;
+      d.nPrio  = task.stats.prio;
+      d.ulLate = ulNow - task.ulNextDue;
+      due.push_back(d);
+    }
+  }
+  std::stable_sort(due.begin(), due.end(), dueOrder);
+
+  fRunning = true;
+  for (unsigned int n = 0; n < due.size(); n++)
+  {
+    T_Task& task = tasks[due[n].nIndex];
+
+    if (task.object == NULL)
+      continue;
+
+    if (task.stats.prio != CRITICAL && dUsed > dFrameBudget)
+    {
+      // stays due for the next frame
+      task.stats.nDeferred++;
+      if (task.ulPeriod == 0)
+        task.stats.nMissed++;
+      continue;
+    }
+
+    if (task.ulPeriod > 0 && due[n].ulLate >= task.ulPeriod)
+      task.stats.nMissed++;
+
+    double dTaskStart = getSeconds();
+    task.object->Run();
+    double dTime = getSeconds() - dTaskStart;
+
+    // the task might have unregistered itself or others, but the
+    // vector has not been changed
+    if (task.stats.prio != CRITICAL)
+      dUsed += dTime;
+    task.stats.nRuns++;
+    task.stats.dTotal += dTime;
+    if (dTime > task.stats.dMax)
+      task.stats.dMax = dTime;
+
+    // don't try to catch up with runs which have been missed
+    task.ulNextDue += task.ulPeriod;
+    if (task.ulNextDue <= task.ulLastTime)
+      task.ulNextDue = task.ulLastTime + task.ulPeriod;
+  }
+  fRunning = false;
+
+  if (fRemoved)
+  {
+    for (unsigned int n = tasks.size(); n > 0; n--)
+      if (tasks[n-1].object == NULL)
+        tasks.erase(tasks.begin() + n - 1);
+    fRemoved = false;
+  }
+}
+
+void Scheduler::getStats(std::vector<T_TaskStats>& stats)
+{
+  stats.clear();
+  for (unsigned int n = 0; n < tasks.size(); n++)
+    if (tasks[n].object != NULL)
+      stats.push_back(tasks[n].stats);
+}
+
+void Scheduler::printStats(std::ostream& out)
+{
+  char line[200];
+
+  out << "Task                 prio     runs   avg [us]   max [us]  deferred    missed" << endl;
+  for (unsigned int n = 0; n < tasks.size(); n++)
+  {
+    const T_TaskStats& st = tasks[n].stats;
+
+    if (tasks[n].object == NULL)
+      continue;
+    snprintf(line, sizeof(line), "%-20s %4i %8lu %10.1f %10.1f %9lu %9lu",
+             st.name.c_str(), (int)st.prio, st.nRuns,
+             st.nRuns ? 1e6*st.dTotal/st.nRuns : 0.0, 1e6*st.dMax,
+             st.nDeferred, st.nMissed);
+    out << line << endl;
   }
 }
 
 #ifdef TEST_SCHEDULER
 
+/**
+ *  Usage: scheduler_test
+ *
+ *  Runs a few tasks for 1000 frames of 10 ms and checks how often
+ *  they have been run. The return value is the number of errors.
+ */
+
 class Test1: public RunnableObject
 {
   public:
-  Test1(Scheduler *_s) {
-    cout << "registering "<< this  << endl;
-    _s->Register(this);}
-  void Run() {cout << "running " << this << endl;} 
+  Test1(double dSeconds = 0) : dBusy(dSeconds), nRuns(0) {}
+  void Run()
+  {
+    double dEnd = Scheduler::getSeconds() + dBusy;
+    while (Scheduler::getSeconds() < dEnd)
+      ;
+    nRuns++;
+  }
+  double dBusy;
+  int    nRuns;
 };
 
+static int expect(const char* name, int nRuns, int nMin, int nMax)
+{
+  cout << name << ": " << nRuns << " runs" << endl;
+  if (nRuns < nMin || nRuns > nMax)
+  {
+    cout << "  expected " << nMin << "..." << nMax << endl;
+    return 1;
+  }
+  return 0;
+}
+
 int main (int argc, char ** argv)
 {
   Scheduler s;
-  Test1 t1(&s);
-  Test1 t11(&s);
-  s.Run();
+  Test1     critical(0.001);
+  Test1     frame;
+  Test1     rate;
+  Test1     sim;
+  Test1     slow1(0.002);
+  Test1     slow2(0.002);
+  int       nErrors = 0;
+
+  s.setBudget(0.001);
+  s.Register(&critical, "critical");
+  s.Register(&slow1,    "slow1",  Scheduler::LOW);
+  s.Register(&slow2,    "slow2",  Scheduler::LOW);
+  s.Register(&frame,    "frame",  Scheduler::HIGH);
+  s.Register(&rate,     "100ms",  Scheduler::HIGH, 100);
+  s.Register(&sim,      "sim50ms", Scheduler::HIGH, 50, Scheduler::SIM_TIME);
+
+  // simulation is paused during the second half
+  for (int n = 0; n < 1000; n++)
+    s.Run(10*n, n < 500 ? 10*n : 5000);
+
+  s.printStats(cout);
+
+  // critical time doesn't count, high priority runs first
+  nErrors += expect("critical", critical.nRuns, 1000, 1000);
+  nErrors += expect("frame",    frame.nRuns,    1000, 1000);
+  nErrors += expect("100ms",    rate.nRuns,     100, 100);
+  nErrors += expect("sim50ms",  sim.nRuns,      100, 101);
+  // one slow task exceeds the budget, they take turns
+  nErrors += expect("slow1",    slow1.nRuns,    499, 501);
+  nErrors += expect("slow2",    slow2.nRuns,    499, 501);
+
+  std::vector<Scheduler::T_TaskStats> stats;
+  s.getStats(stats);
+  if (stats.size() != 6 || stats[1].nDeferred + stats[1].nRuns != 1000
+      || stats[1].nMissed != stats[1].nDeferred)
+  {
+    cout << "wrong statistics" << endl;
+    nErrors++;
+  }
+
+  s.UnRegister(&slow2);
+  s.getStats(stats);
+  if (stats.size() != 5)
+    nErrors++;
+
+  return nErrors;
 }
 
 #endif
@@ -26,19 +26,122 @@
 #define SCHEDULER_H
 
 #include <list>
+#include <vector>
+#include <string>
+#include <iostream>
 using namespace std;
 
+class RunnableObject;
+
+/**
+ *  Runs tasks once per frame, or at a lower rate.
+ *
+ *  Every task has a priority and a period, which is counted either
+ *  in wall clock time or in simulation time (which doesn't advance
+ *  while the simulation is paused). Due tasks are run by priority,
+ *  the most overdue first within a priority. Critical tasks always
+ *  run. Once the other tasks of a frame have used up the time
+ *  budget, the remaining ones are deferred to the next frame.
+ *
+ *  The execution time of every task is measured, so frame time
+ *  spikes can be attributed to tasks. A task misses its deadline if
+ *  it runs more than one period after it became due, or if it has
+ *  to run every frame and is deferred.
+ */
 class Scheduler 
 {
   public:
+    typedef enum
+    {
+      CRITICAL = 0,   ///< runs every time it is due, never deferred
+      HIGH,
+      NORMAL,
+      LOW
+    } T_Priority;
+
+    typedef enum
+    {
+      WALL_TIME,
+      SIM_TIME
+    } T_Clock;
+
+    /// Statistics of a task
+    typedef struct
+    {
+      std::string   name;
+      T_Priority    prio;
+      unsigned long nRuns;       ///< number of runs
+      unsigned long nDeferred;   ///< times it was due, but deferred
+      unsigned long nMissed;     ///< missed deadlines
+      double        dTotal;      ///< total execution time in s
+      double        dMax;        ///< longest execution time in s
+    } T_TaskStats;
+
     Scheduler();
     ~Scheduler();
-    void Register( void *);
-    void UnRegister( void *);
-    void Run();
+
+    /**
+     *  Adds a task.
+     *
+     *  \param object    the task
+     *  \param name      name for the statistics
+     *  \param prio      priority
+     *  \param ulPeriod  period in ms, 0 means every frame
+     *  \param clock     time base of the period
+     */
+    void Register(RunnableObject* object,
+                  std::string     name     = "",
+                  T_Priority      prio     = CRITICAL,
+                  unsigned long   ulPeriod = 0,
+                  T_Clock         clock    = WALL_TIME);
+
+    void UnRegister(RunnableObject* object);
+
+    /**
+     *  Sets the time which may be used by tasks which are not
+     *  critical in a frame, in seconds.
+     */
+    void setBudget(double dBudget) { dFrameBudget = dBudget; };
+
+    /**
+     *  Runs the due tasks.
+     *
+     *  \param ulWallTime  wall clock time in ms
+     *  \param ulSimTime   simulation time in ms
+     */
+    void Run(unsigned long ulWallTime, unsigned long ulSimTime);
+
+    /**
+     *  Statistics of all tasks, in order of registration.
+     */
+    void getStats(std::vector<T_TaskStats>& stats);
+
+    /**
+     *  Prints the statistics of all tasks.
+     */
+    void printStats(std::ostream& out);
+
+    /**
+     *  Time in seconds with a fine resolution, for measuring tasks.
+     */
+    static double getSeconds();
 
   private:
-    list< void *> lObject;
+    typedef struct
+    {
+      RunnableObject* object;
+      T_Clock         clock;
+      unsigned long   ulPeriod;
+      unsigned long   ulNextDue;
+      unsigned long   ulLastTime;
+      bool            fStarted;
+      T_TaskStats     stats;
+    } T_Task;
+
+    std::vector<T_Task> tasks;
+    double              dFrameBudget;
+    bool                fRunning;      ///< inside Run()
+    bool                fRemoved;      ///< a task has been removed inside Run()
 };
 
 class RunnableObject
@@ -50,5 +153,17 @@ class RunnableObject
     Scheduler *myScheduler;
 };
 
-#endif
+/**
+ *  Runs a function as a task.
+ */
+class RunnableFunction : public RunnableObject
+{
+  public:
+    RunnableFunction(void (*function)()) : function_(function) {};
+    void Run() { function_(); };
 
+  private:
+    void (*function_)();
+};
+
+#endif
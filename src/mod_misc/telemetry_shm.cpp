@@ -0,0 +1,352 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+/** \file telemetry_shm.cpp
+ *
+ *  The telemetry ring in shared memory, see telemetry_shm.h.
+ */
+
+#include "telemetry_shm.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#ifndef WIN32
+# include <fcntl.h>
+# include <unistd.h>
+# include <sched.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+#endif
+
+/// a reader gives up on the header after this many tries
+#define TELEMETRY_INFO_TRIES  100000
+
+/// after this many tries the reader lets the writer run
+#define TELEMETRY_INFO_SPIN   100
+
+
+#ifndef WIN32
+
+/**
+ * The beginning of the shared memory object. Everything after
+ * seq up to written is protected by the sequence lock.
+ */
+typedef struct
+{
+  uint32_t magic;
+  uint32_t version;
+  uint32_t header_size;
+  uint32_t sample_size;
+  uint32_t capacity;
+  uint32_t seq;       ///< odd while the writer changes the fields below
+  double   dt;
+  uint32_t reset;
+  int32_t  pid;
+  char     aircraft[CRRC_TELEMETRY_AIRCRAFT_LEN];
+  uint64_t written;   ///< number of samples in the ring, not protected by seq
+} T_TelemetryHeader;
+
+/**
+ * A slot of the ring. seq is 2*index+1 while sample number index is
+ * written and 2*index+2 after that.
+ */
+typedef struct
+{
+  uint64_t              seq;
+  crrc_telemetry_sample sample;
+} T_TelemetrySlot;
+
+
+struct CrrcTelemetryInt
+{
+  T_TelemetryHeader* header;
+  T_TelemetrySlot*   slots;
+  size_t             size;     ///< size of the mapping
+  uint64_t           next;     ///< next sample to write or to read
+  uint32_t           mask;     ///< capacity - 1
+  char*              name;     ///< set for the writer only
+};
+
+
+static size_t mappingSize(uint32_t capacity)
+{
+  return(CRRC_TELEMETRY_HEADER_SIZE + (size_t)capacity * sizeof(T_TelemetrySlot));
+}
+
+
+CrrcTelemetry crrc_telemetry_create(const char* name, unsigned int capacity)
+{
+  uint32_t nSlots = 2;
+  while (nSlots < capacity && nSlots < 0x80000000u)
+    nSlots <<= 1;
+
+  shm_unlink(name);
+  int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0644);
+  if (fd < 0)
+    return(NULL);
+
+  size_t nSize = mappingSize(nSlots);
+  void*  mem   = MAP_FAILED;
+  if (ftruncate(fd, nSize) == 0)
+    mem = mmap(NULL, nSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mem == MAP_FAILED)
+  {
+    shm_unlink(name);
+    return(NULL);
+  }
+
+  CrrcTelemetry t = (CrrcTelemetry)malloc(sizeof(struct CrrcTelemetryInt));
+  t->header = (T_TelemetryHeader*)mem;
+  t->slots  = (T_TelemetrySlot*)((char*)mem + CRRC_TELEMETRY_HEADER_SIZE);
+  t->size   = nSize;
+  t->next   = 0;
+  t->mask   = nSlots - 1;
+  t->name   = strdup(name);
+
+  // the object is all zeros, a reader doesn't accept it before magic is set
+  T_TelemetryHeader* h = t->header;
+  h->version     = CRRC_TELEMETRY_VERSION;
+  h->header_size = CRRC_TELEMETRY_HEADER_SIZE;
+  h->sample_size = sizeof(crrc_telemetry_sample);
+  h->capacity    = nSlots;
+  h->pid         = getpid();
+  __atomic_store_n(&h->magic, CRRC_TELEMETRY_MAGIC, __ATOMIC_RELEASE);
+
+  return(t);
+}
+
+
+void crrc_telemetry_set_info(CrrcTelemetry t, double dt, uint32_t reset, const char* aircraft)
+{
+  T_TelemetryHeader* h   = t->header;
+  uint32_t           seq = h->seq;
+
+  __atomic_store_n(&h->seq, seq + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+
+  h->dt    = dt;
+  h->reset = reset;
+  strncpy(h->aircraft, aircraft, CRRC_TELEMETRY_AIRCRAFT_LEN - 1);
+  h->aircraft[CRRC_TELEMETRY_AIRCRAFT_LEN - 1] = 0;
+
+  __atomic_store_n(&h->seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+
+void crrc_telemetry_write(CrrcTelemetry t, const crrc_telemetry_sample* sample)
+{
+  uint64_t         index = t->next;
+  T_TelemetrySlot* slot  = &t->slots[index & t->mask];
+
+  __atomic_store_n(&slot->seq, 2*index + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+
+  slot->sample       = *sample;
+  slot->sample.index = index;
+
+  __atomic_store_n(&slot->seq, 2*index + 2, __ATOMIC_RELEASE);
+  __atomic_store_n(&t->header->written, index + 1, __ATOMIC_RELEASE);
+  t->next = index + 1;
+}
+
+
+CrrcTelemetry crrc_telemetry_open(const char* name)
+{
+  int fd = shm_open(name, O_RDONLY, 0);
+  if (fd < 0)
+    return(NULL);
+
+  struct stat st;
+  void*       mem = MAP_FAILED;
+  if (fstat(fd, &st) == 0 && (size_t)st.st_size >= mappingSize(0))
+    mem = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mem == MAP_FAILED)
+    return(NULL);
+
+  // the writer may still be setting up the header
+  T_TelemetryHeader* h = (T_TelemetryHeader*)mem;
+  if (__atomic_load_n(&h->magic, __ATOMIC_ACQUIRE) != CRRC_TELEMETRY_MAGIC ||
+      h->version     != CRRC_TELEMETRY_VERSION ||
+      h->header_size != CRRC_TELEMETRY_HEADER_SIZE ||
+      h->sample_size != sizeof(crrc_telemetry_sample) ||
+      h->capacity == 0 || (h->capacity & (h->capacity - 1)) != 0 ||
+      mappingSize(h->capacity) > (size_t)st.st_size)
+  {
+    munmap(mem, st.st_size);
+    return(NULL);
+  }
+
+  CrrcTelemetry t = (CrrcTelemetry)malloc(sizeof(struct CrrcTelemetryInt));
+  t->header = h;
+  t->slots  = (T_TelemetrySlot*)((char*)mem + CRRC_TELEMETRY_HEADER_SIZE);
+  t->size   = st.st_size;
+  t->next   = __atomic_load_n(&h->written, __ATOMIC_ACQUIRE);
+  t->mask   = h->capacity - 1;
+  t->name   = NULL;
+  return(t);
+}
+
+
+int crrc_telemetry_get_info(CrrcTelemetry t, crrc_telemetry_info* info)
+{
+  T_TelemetryHeader* h = t->header;
+
+  for (int n = 0; n < TELEMETRY_INFO_TRIES; n++)
+  {
+    uint32_t seq = __atomic_load_n(&h->seq, __ATOMIC_ACQUIRE);
+    if (seq & 1)
+    {
+      // the writer might have been interrupted while changing it
+      if (n >= TELEMETRY_INFO_SPIN)
+        sched_yield();
+      continue;
+    }
+
+    info->dt    = h->dt;
+    info->reset = h->reset;
+    memcpy(info->aircraft, h->aircraft, CRRC_TELEMETRY_AIRCRAFT_LEN);
+
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (__atomic_load_n(&h->seq, __ATOMIC_RELAXED) == seq)
+    {
+      info->aircraft[CRRC_TELEMETRY_AIRCRAFT_LEN - 1] = 0;
+      info->pid      = h->pid;
+      info->capacity = h->capacity;
+      info->written  = __atomic_load_n(&h->written, __ATOMIC_ACQUIRE);
+      return(0);
+    }
+  }
+  return(-1);
+}
+
+
+long crrc_telemetry_read(CrrcTelemetry t, crrc_telemetry_sample* samples, long count, uint64_t* lost)
+{
+  uint64_t written  = __atomic_load_n(&t->header->written, __ATOMIC_ACQUIRE);
+  uint64_t capacity = (uint64_t)t->mask + 1;
+  uint64_t nLost    = 0;
+  long     n        = 0;
+
+  while (n < count && t->next < written)
+  {
+    // lapped: jump to the oldest sample which will still be there
+    // for a while
+    if (written - t->next > capacity - capacity/8)
+    {
+      uint64_t next = written - (capacity - capacity/8);
+      nLost  += next - t->next;
+      t->next = next;
+    }
+
+    T_TelemetrySlot* slot = &t->slots[t->next & t->mask];
+    uint64_t         seq  = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+
+    if (seq == 2*t->next + 2)
+    {
+      samples[n] = slot->sample;
+      __atomic_thread_fence(__ATOMIC_ACQUIRE);
+      if (__atomic_load_n(&slot->seq, __ATOMIC_RELAXED) == seq)
+        n++;
+      else
+        nLost++;
+    }
+    else
+    {
+      // overwritten before it could be read
+      nLost++;
+    }
+    t->next++;
+
+    if (t->next == written)
+      written = __atomic_load_n(&t->header->written, __ATOMIC_ACQUIRE);
+  }
+
+  if (lost)
+    *lost += nLost;
+  return(n);
+}
+
+
+void crrc_telemetry_rewind(CrrcTelemetry t)
+{
+  uint64_t written  = __atomic_load_n(&t->header->written, __ATOMIC_ACQUIRE);
+  uint64_t capacity = (uint64_t)t->mask + 1;
+
+  t->next = (written > capacity - capacity/8) ? written - (capacity - capacity/8) : 0;
+}
+
+
+void crrc_telemetry_close(CrrcTelemetry* t)
+{
+  if (*t == NULL)
+    return;
+
+  munmap((*t)->header, (*t)->size);
+  if ((*t)->name)
+  {
+    shm_unlink((*t)->name);
+    free((*t)->name);
+  }
+  free(*t);
+  *t = NULL;
+}
+
+#else // WIN32
+
+CrrcTelemetry crrc_telemetry_create(const char* name, unsigned int capacity)
+{
+  return(NULL);
+}
+
+void crrc_telemetry_set_info(CrrcTelemetry t, double dt, uint32_t reset, const char* aircraft)
+{
+}
+
+void crrc_telemetry_write(CrrcTelemetry t, const crrc_telemetry_sample* sample)
+{
+}
+
+CrrcTelemetry crrc_telemetry_open(const char* name)
+{
+  return(NULL);
+}
+
+int crrc_telemetry_get_info(CrrcTelemetry t, crrc_telemetry_info* info)
+{
+  return(-1);
+}
+
+long crrc_telemetry_read(CrrcTelemetry t, crrc_telemetry_sample* samples, long count, uint64_t* lost)
+{
+  return(0);
+}
+
+void crrc_telemetry_rewind(CrrcTelemetry t)
+{
+}
+
+void crrc_telemetry_close(CrrcTelemetry* t)
+{
+}
+
+#endif // WIN32
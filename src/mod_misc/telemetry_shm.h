@@ -0,0 +1,171 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+/** \file telemetry_shm.h
+ *
+ *  C interface to the telemetry ring in shared memory.
+ *
+ *  The simulation writes one sample per step of the flight model
+ *  into a ring in a POSIX shared memory object (default name
+ *  CRRC_TELEMETRY_NAME). Any number of other processes can open it
+ *  and follow the samples, the writer never waits for them:
+ *
+ *    CrrcTelemetry t = crrc_telemetry_open(CRRC_TELEMETRY_NAME);
+ *    crrc_telemetry_sample buf[256];
+ *    uint64_t lost = 0;
+ *    while (...)
+ *    {
+ *      long n = crrc_telemetry_read(t, buf, 256, &lost);
+ *      ...
+ *    }
+ *    crrc_telemetry_close(&t);
+ *
+ *  The object starts with a header of CRRC_TELEMETRY_HEADER_SIZE
+ *  bytes, followed by the slots of the ring. The fields which only
+ *  change on a reset (time step, aircraft, ...) are protected by a
+ *  sequence lock in the header. Every slot has a sequence number of
+ *  its own, so a reader which is lapped by the writer notices it and
+ *  counts the samples as lost.
+ *
+ *  This header can be used from C and C++, it only needs stdint.h.
+ *  Not available on Windows: crrc_telemetry_create() and
+ *  crrc_telemetry_open() return NULL there.
+ */
+
+#ifndef TELEMETRY_SHM_H
+#define TELEMETRY_SHM_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/// default name of the shared memory object
+#define CRRC_TELEMETRY_NAME         "/crrcsim"
+
+/// "CRRT"
+#define CRRC_TELEMETRY_MAGIC        0x54525243
+#define CRRC_TELEMETRY_VERSION      1
+
+/// the slots start at this offset
+#define CRRC_TELEMETRY_HEADER_SIZE  4096
+
+/// default number of slots
+#define CRRC_TELEMETRY_CAPACITY     65536
+
+/// length of crrc_telemetry_info::aircraft, including the 0
+#define CRRC_TELEMETRY_AIRCRAFT_LEN 256
+
+/// aileron, elevator, rudder, throttle, flap, spoiler, retract, pitch, aux[4]
+#define CRRC_TELEMETRY_INPUTS       12
+
+/**
+ * One step of the flight model.
+ */
+typedef struct
+{
+  uint64_t index;     ///< number of the sample, counted from the start of the writer
+  uint32_t reset;     ///< number of resets of the simulation before this sample
+  uint32_t flags;     ///< reserved, 0
+  double   time;      ///< simulation time since the last reset [s]
+  double   pos[3];    ///< position north, east, down [ft]
+  double   vel[3];    ///< velocity w.r.t. the ground, north, east, down [ft/s]
+  double   accel[3];  ///< acceleration, as the flight model reports it [ft/s^2]
+  double   pqr[3];    ///< angular velocity, body axes [rad/s]
+  double   euler[3];  ///< phi, theta, psi [rad]
+  double   wind[3];   ///< wind north, east, down at the aircraft [ft/s]
+  double   v_rel_airmass; ///< velocity relative to the air [ft/s]
+  float    inputs[CRRC_TELEMETRY_INPUTS]; ///< control inputs, as in TSimInputs
+} crrc_telemetry_sample;
+
+/**
+ * What the header says about the writer.
+ */
+typedef struct
+{
+  double   dt;        ///< time step of the flight model [s]
+  uint32_t reset;     ///< number of resets of the simulation
+  int32_t  pid;       ///< process id of the writer
+  uint32_t capacity;  ///< number of slots in the ring
+  uint64_t written;   ///< number of samples written so far
+  char     aircraft[CRRC_TELEMETRY_AIRCRAFT_LEN]; ///< model file of the aircraft
+} crrc_telemetry_info;
+
+struct CrrcTelemetryInt;
+typedef struct CrrcTelemetryInt *CrrcTelemetry;
+
+/**
+ * Creates the shared memory object (a stale one of the same name is
+ * replaced) with capacity slots, which is rounded up to a power of
+ * two. Returns NULL on error.
+ */
+CrrcTelemetry crrc_telemetry_create(const char* name, unsigned int capacity);
+
+/**
+ * Writer: updates the header. Readers never see a mix of old and new
+ * values.
+ */
+void crrc_telemetry_set_info(CrrcTelemetry t, double dt, uint32_t reset, const char* aircraft);
+
+/**
+ * Writer: appends a sample, its index is set here. Overwrites the
+ * oldest one when the ring is full.
+ */
+void crrc_telemetry_write(CrrcTelemetry t, const crrc_telemetry_sample* sample);
+
+/**
+ * Opens an existing object for reading. The first read returns the
+ * samples written after this call. Returns NULL if there is no
+ * object or it doesn't fit this version of the interface.
+ */
+CrrcTelemetry crrc_telemetry_open(const char* name);
+
+/**
+ * Reader: copies the header. Returns 0, or -1 if the writer seems to
+ * have died while it was changing the header.
+ */
+int crrc_telemetry_get_info(CrrcTelemetry t, crrc_telemetry_info* info);
+
+/**
+ * Reader: copies up to count samples which haven't been read yet,
+ * oldest first, and returns their number. Does not wait, 0 means that
+ * there is no new sample. Samples which have been overwritten before
+ * they could be read are added to *lost (if lost isn't NULL).
+ */
+long crrc_telemetry_read(CrrcTelemetry t, crrc_telemetry_sample* samples, long count, uint64_t* lost);
+
+/**
+ * Reader: the next read starts at the oldest sample in the ring.
+ */
+void crrc_telemetry_rewind(CrrcTelemetry t);
+
+/**
+ * Unmaps the object and sets *t to NULL. The writer removes the
+ * object, readers which still have it open can read what is left.
+ */
+void crrc_telemetry_close(CrrcTelemetry* t);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
@@ -0,0 +1,266 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+/**
+ * \file telemetry_shm_test.cpp
+ *
+ * A writer and a reader process on the telemetry ring (telemetry_shm.h).
+ *
+ * Usage: telemetry_shm_test [-n samples] [-c capacity] [-p pause_every]
+ *
+ * The writer process writes samples (default 10 million) as fast as
+ * it can into a ring of capacity slots (default 4096), and changes the
+ * header every 100000 samples. The reader process follows it; after
+ * every pause_every samples (default 1 million) it sleeps for 20 ms,
+ * so the writer laps it now and then.
+ *
+ * Both rates are printed. The return value is the number of samples
+ * which were torn, out of order or not counted as either read or
+ * lost, plus the number of inconsistent headers.
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "telemetry_shm.h"
+#include "scheduler.h"
+
+/// the writer changes the header after this many samples
+#define INFO_EVERY  100000
+
+/// the reader gives up if nothing arrives for this time (s)
+#define TIMEOUT     5.0
+
+
+/**
+ * Sample number n: every value is derived from n.
+ */
+static void makeSample(crrc_telemetry_sample& s, uint64_t n)
+{
+  double d = (double)n;
+
+  memset(&s, 0, sizeof(s));
+  s.reset = (uint32_t)(n / INFO_EVERY);
+  s.time  = d;
+  for (int i = 0; i < 3; i++)
+  {
+    s.pos[i]   = d + i;
+    s.vel[i]   = d - i;
+    s.accel[i] = d * 2;
+    s.pqr[i]   = -d;
+    s.euler[i] = d + 0.5;
+    s.wind[i]  = d * 3;
+  }
+  s.v_rel_airmass = d;
+  for (int i = 0; i < CRRC_TELEMETRY_INPUTS; i++)
+    s.inputs[i] = (float)((n + i) % 1000);
+}
+
+
+static bool checkSample(const crrc_telemetry_sample& s)
+{
+  crrc_telemetry_sample expected;
+
+  makeSample(expected, s.index);
+  expected.index = s.index;
+  return(memcmp(&s, &expected, sizeof(s)) == 0);
+}
+
+
+static void makeAircraft(char* buf, uint32_t reset)
+{
+  snprintf(buf, CRRC_TELEMETRY_AIRCRAFT_LEN, "models/test_%u.xml", reset);
+}
+
+
+static int writer(const char* name, uint64_t nSamples, unsigned int nCapacity)
+{
+  CrrcTelemetry t = crrc_telemetry_create(name, nCapacity);
+  if (t == NULL)
+  {
+    printf("writer: can't create %s\n", name);
+    return(1);
+  }
+
+  // give the reader some time to find the object
+  usleep(200000);
+
+  crrc_telemetry_sample sample;
+  char                  aircraft[CRRC_TELEMETRY_AIRCRAFT_LEN];
+  double                dStart = Scheduler::getSeconds();
+
+  for (uint64_t n = 0; n < nSamples; n++)
+  {
+    if (n % INFO_EVERY == 0)
+    {
+      uint32_t reset = (uint32_t)(n / INFO_EVERY);
+      makeAircraft(aircraft, reset);
+      crrc_telemetry_set_info(t, reset * 1e-3, reset, aircraft);
+    }
+    makeSample(sample, n);
+    crrc_telemetry_write(t, &sample);
+  }
+
+  double dTime = Scheduler::getSeconds() - dStart;
+  printf("writer: %lu samples, %.1f million samples/s\n",
+         (unsigned long)nSamples, 1e-6 * nSamples / dTime);
+
+  // the reader still has it mapped
+  crrc_telemetry_close(&t);
+  return(0);
+}
+
+
+static int reader(const char* name, uint64_t nSamples, uint64_t nPauseEvery)
+{
+  CrrcTelemetry t      = NULL;
+  double        dStart = Scheduler::getSeconds();
+
+  while (t == NULL && Scheduler::getSeconds() - dStart < TIMEOUT)
+  {
+    t = crrc_telemetry_open(name);
+    if (t == NULL)
+      usleep(1000);
+  }
+  if (t == NULL)
+  {
+    printf("reader: can't open %s\n", name);
+    return(1);
+  }
+  crrc_telemetry_rewind(t);
+
+  crrc_telemetry_sample buf[256];
+  crrc_telemetry_info   info;
+  char                  aircraft[CRRC_TELEMETRY_AIRCRAFT_LEN];
+  uint64_t              nRead      = 0;
+  uint64_t              nLost      = 0;
+  uint64_t              nGaps      = 0;
+  uint64_t              nNext      = 0;
+  uint64_t              nNextPause = nPauseEvery;
+  int                   nErrors    = 0;
+  int                   nInfos     = 0;
+  double                dLast      = Scheduler::getSeconds();
+
+  dStart = dLast;
+  while (nNext < nSamples)
+  {
+    long n = crrc_telemetry_read(t, buf, 256, &nLost);
+
+    double now = Scheduler::getSeconds();
+    if (n == 0)
+    {
+      if (now - dLast > TIMEOUT)
+      {
+        printf("reader: timeout after sample %lu\n", (unsigned long)nNext);
+        nErrors++;
+        break;
+      }
+      usleep(100);
+      continue;
+    }
+    dLast = now;
+
+    for (long i = 0; i < n; i++)
+    {
+      if (buf[i].index < nNext || !checkSample(buf[i]))
+        nErrors++;
+      else
+        nGaps += buf[i].index - nNext;
+      nNext = buf[i].index + 1;
+    }
+    nRead += n;
+
+    // the header must never be half old and half new
+    if (crrc_telemetry_get_info(t, &info) != 0)
+      nErrors++;
+    else
+    {
+      makeAircraft(aircraft, info.reset);
+      if (info.dt != info.reset * 1e-3 || strcmp(info.aircraft, aircraft) != 0)
+        nErrors++;
+      nInfos++;
+    }
+
+    if (nPauseEvery && nRead >= nNextPause)
+    {
+      usleep(20000);
+      nNextPause += nPauseEvery;
+    }
+  }
+
+  double dTime = Scheduler::getSeconds() - dStart;
+  printf("reader: %lu samples read, %lu lost, %.1f million samples/s, %i headers\n",
+         (unsigned long)nRead, (unsigned long)nLost, 1e-6 * nRead / dTime, nInfos);
+
+  if (nGaps != nLost)
+  {
+    printf("reader: %lu samples missing, but %lu reported as lost\n",
+           (unsigned long)nGaps, (unsigned long)nLost);
+    nErrors++;
+  }
+  printf("reader: %i errors\n", nErrors);
+
+  crrc_telemetry_close(&t);
+  return(nErrors);
+}
+
+
+int main(int argc, char** argv)
+{
+  uint64_t     nSamples    = 10000000;
+  unsigned int nCapacity   = 4096;
+  uint64_t     nPauseEvery = 1000000;
+  char         name[64];
+
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "-n") == 0 && i+1 < argc)
+      nSamples = strtoul(argv[++i], NULL, 10);
+    else if (strcmp(argv[i], "-c") == 0 && i+1 < argc)
+      nCapacity = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-p") == 0 && i+1 < argc)
+      nPauseEvery = strtoul(argv[++i], NULL, 10);
+  }
+
+  snprintf(name, sizeof(name), "/crrcsim_test_%i", (int)getpid());
+
+  CrrcTelemetry none = crrc_telemetry_open(name);
+  if (none != NULL)
+  {
+    printf("opened %s before it was created\n", name);
+    crrc_telemetry_close(&none);
+    return(1);
+  }
+
+  fflush(stdout);
+  pid_t pid = fork();
+  if (pid == 0)
+    exit(writer(name, nSamples, nCapacity));
+
+  int nErrors = reader(name, nSamples, nPauseEvery);
+
+  int status;
+  if (waitpid(pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+    nErrors++;
+
+  return(nErrors);
+}
@@ -0,0 +1,110 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+/** \file triple_buffer.h
+ *
+ *  Hands the latest version of some data from one thread to another
+ *  without making either of them wait for the other.
+ */
+
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <SDL.h>
+#include <SDL_thread.h>
+
+
+/**
+ *  Three instances of T: the writer fills one of them, the reader
+ *  looks at another one, and the third one holds the latest data
+ *  which has been published, but not taken by the reader yet.
+ *  Publishing and taking only swap indices, the lock is never held
+ *  while data is copied. The reader skips versions if the writer is
+ *  faster.
+ *
+ *  There must be only one writer thread and one reader thread.
+ */
+template < class T >
+class TripleBuffer
+{
+  public:
+    TripleBuffer()
+      : nWrite(0), nReady(1), nRead(2), fNew(false)
+    {
+      lock = SDL_CreateMutex();
+    }
+
+    ~TripleBuffer()
+    {
+      SDL_DestroyMutex(lock);
+    }
+
+    /// The instance which may be filled by the writer
+    T& getWriteBuffer() { return buffers[nWrite]; };
+
+    /// Makes the write buffer the latest version
+    void publish()
+    {
+      SDL_LockMutex(lock);
+      int n  = nReady;
+      nReady = nWrite;
+      nWrite = n;
+      fNew   = true;
+      SDL_UnlockMutex(lock);
+    }
+
+    /**
+     *  Takes the latest version if there is a new one. Returns true
+     *  if getReadBuffer() has changed.
+     */
+    bool update()
+    {
+      bool fChanged = false;
+
+      SDL_LockMutex(lock);
+      if (fNew)
+      {
+        int n  = nReady;
+        nReady = nRead;
+        nRead  = n;
+        fNew   = false;
+        fChanged = true;
+      }
+      SDL_UnlockMutex(lock);
+      return fChanged;
+    }
+
+    /// The instance which belongs to the reader
+    const T& getReadBuffer() const { return buffers[nRead]; };
+
+  private:
+    // not copyable, the lock belongs to one instance
+    TripleBuffer(const TripleBuffer&);
+    TripleBuffer& operator=(const TripleBuffer&);
+
+    T          buffers[3];
+    int        nWrite;
+    int        nReady;
+    int        nRead;
+    bool       fNew;     ///< nReady has not been taken by the reader
+    SDL_mutex* lock;
+};
+
+#endif
@@ -0,0 +1,177 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+/** \file worker_pool.cpp
+ *
+ *  A fixed number of threads which run a job for every item of an
+ *  array.
+ */
+
+#include <SDL.h>
+#include <SDL_thread.h>
+
+#ifdef WIN32
+# include <windows.h>
+#else
+# include <unistd.h>
+#endif
+
+#include "worker_pool.h"
+
+/// upper limit for the number of threads
+#define WORKER_POOL_MAX_THREADS  (16)
+
+
+WorkerPool::WorkerPool(int nThreads)
+  : job(NULL), jobData(NULL), nItems(0), nNext(0), nChunk(1),
+    nBusy(0), ulJob(0), fStop(false)
+{
+  if (nThreads <= 0)
+    nThreads = getProcessorCount();
+  if (nThreads > WORKER_POOL_MAX_THREADS)
+    nThreads = WORKER_POOL_MAX_THREADS;
+
+  lock  = SDL_CreateMutex();
+  start = SDL_CreateCond();
+  done  = SDL_CreateCond();
+
+  // the caller of run() is the first thread
+  for (int i = 1; i < nThreads; i++)
+  {
+    SDL_Thread* thread = SDL_CreateThread(workerThread, this);
+    if (thread == NULL)
+      break;
+    threads.push_back(thread);
+  }
+}
+
+
+WorkerPool::~WorkerPool()
+{
+  SDL_LockMutex(lock);
+  fStop = true;
+  SDL_CondBroadcast(start);
+  SDL_UnlockMutex(lock);
+
+  for (unsigned int i = 0; i < threads.size(); i++)
+    SDL_WaitThread(threads[i], NULL);
+  threads.clear();
+
+  SDL_DestroyCond(done);
+  SDL_DestroyCond(start);
+  SDL_DestroyMutex(lock);
+}
+
+
+int WorkerPool::getProcessorCount()
+{
+#ifdef WIN32
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  int n = info.dwNumberOfProcessors;
+#elif defined(_SC_NPROCESSORS_ONLN)
+  int n = sysconf(_SC_NPROCESSORS_ONLN);
+#else
+  int n = 1;
+#endif
+  return (n < 1) ? 1 : n;
+}
+
+
+void WorkerPool::run(T_Job job, void* data, int nItems, int nChunk)
+{
+  if (nItems <= 0)
+    return;
+
+  if (nChunk <= 0)
+  {
+    nChunk = nItems / (4 * getThreadCount());
+    if (nChunk < 1)
+      nChunk = 1;
+  }
+
+  // not worth waking up anybody
+  if (threads.size() == 0 || nItems <= nChunk)
+  {
+    for (int n = 0; n < nItems; n++)
+      job(data, n);
+    return;
+  }
+
+  SDL_LockMutex(lock);
+  this->job     = job;
+  this->jobData = data;
+  this->nItems  = nItems;
+  this->nChunk  = nChunk;
+  nNext         = 0;
+  ulJob++;
+  SDL_CondBroadcast(start);
+
+  nBusy++;
+  work();
+  nBusy--;
+  while (nBusy > 0)
+    SDL_CondWait(done, lock);
+  SDL_UnlockMutex(lock);
+}
+
+
+void WorkerPool::work()
+{
+  while (nNext < nItems)
+  {
+    int nFirst = nNext;
+    int nLast  = nFirst + nChunk;
+    if (nLast > nItems)
+      nLast = nItems;
+    nNext = nLast;
+
+    SDL_UnlockMutex(lock);
+    for (int n = nFirst; n < nLast; n++)
+      job(jobData, n);
+    SDL_LockMutex(lock);
+  }
+}
+
+
+int WorkerPool::workerThread(void* pool)
+{
+  WorkerPool*   self   = (WorkerPool*)pool;
+  unsigned long ulSeen = 0;
+
+  SDL_LockMutex(self->lock);
+  for (;;)
+  {
+    while (self->ulJob == ulSeen && !self->fStop)
+      SDL_CondWait(self->start, self->lock);
+    if (self->fStop)
+      break;
+    ulSeen = self->ulJob;
+
+    self->nBusy++;
+    self->work();
+    self->nBusy--;
+    if (self->nBusy == 0)
+      SDL_CondBroadcast(self->done);
+  }
+  SDL_UnlockMutex(self->lock);
+
+  return 0;
+}
@@ -0,0 +1,107 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+/** \file worker_pool.h
+ *
+ *  A fixed number of threads which run a job for every item of an
+ *  array.
+ */
+
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <vector>
+
+struct SDL_Thread;
+struct SDL_mutex;
+struct SDL_cond;
+
+
+/**
+ *  Runs a job for items 0..n-1 on several threads and waits until
+ *  all of them are done. The calling thread takes part in the work.
+ *
+ *  The items are handed out in chunks of consecutive indices, so a
+ *  job should only write to data which belongs to its item. Jobs must
+ *  not throw exceptions and must not call run() of the same pool.
+ */
+class WorkerPool
+{
+  public:
+    typedef void (*T_Job)(void* data, int nIndex);
+
+    /**
+     *  Starts the threads.
+     *
+     *  \param nThreads  number of threads including the caller of
+     *                   run(), 0 means one per processor
+     */
+    WorkerPool(int nThreads = 0);
+
+    /**
+     *  Stops the threads.
+     */
+    ~WorkerPool();
+
+    /**
+     *  Calls job(data, n) for n = 0..nItems-1 and returns when all
+     *  calls are done.
+     *
+     *  \param nChunk  number of items handed out at once, 0 means
+     *                 about four chunks per thread
+     */
+    void run(T_Job job, void* data, int nItems, int nChunk = 0);
+
+    /**
+     *  Number of threads including the caller of run().
+     */
+    int getThreadCount() const { return threads.size() + 1; };
+
+    /**
+     *  Number of processors which are online.
+     */
+    static int getProcessorCount();
+
+  private:
+    static int workerThread(void* pool);
+
+    /**
+     *  Takes chunks until all items have been handed out. Called and
+     *  returns with lock held.
+     */
+    void work();
+
+    std::vector<SDL_Thread*> threads;
+    SDL_mutex*               lock;
+    SDL_cond*                start;        ///< a job has been started
+    SDL_cond*                done;         ///< all threads are idle
+
+    // the current job, protected by lock
+    T_Job                    job;
+    void*                    jobData;
+    int                      nItems;
+    int                      nNext;        ///< next item to hand out
+    int                      nChunk;
+    int                      nBusy;        ///< threads inside work()
+    unsigned long            ulJob;        ///< counts the jobs
+    bool                     fStop;
+};
+
+#endif
@@ -0,0 +1,73 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+/**
+ * \file f3f_crossings.cpp
+ *
+ * Exact times of the base crossings of an F3F course.
+ */
+
+#include "f3f_crossings.h"
+
+
+F3FCrossings::F3FCrossings()
+{
+  reset();
+}
+
+
+void F3FCrossings::reset()
+{
+  have_step = false;
+  step_x    = 0;
+  step_time = 0;
+  for (int i=0; i<CROSS_COUNT; i++)
+    cross_time[i] = -1;
+}
+
+
+void F3FCrossings::step(float x, double t, float line)
+{
+  if (have_step)
+  {
+    check(x, t,  line, CROSS_LEFT_OUT, CROSS_LEFT_IN);
+    check(x, t, -line, CROSS_RIGHT_IN, CROSS_RIGHT_OUT);
+  }
+  step_x    = x;
+  step_time = t;
+  have_step = true;
+}
+
+
+/**
+ *  Checks whether the model has crossed the base at x = line between
+ *  the last step and this one.
+ *
+ *  \param up    crossing to record if x increases
+ *  \param down  crossing to record if x decreases
+ */
+void F3FCrossings::check(float x, double t, float line, int up, int down)
+{
+  if ((step_x > line) == (x > line))
+    return;
+
+  double frac = (line - step_x) / (x - step_x);
+  cross_time[(x > line) ? up : down] = step_time + frac * (t - step_time);
+}
@@ -0,0 +1,84 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+/**
+ * \file f3f_crossings.h
+ *
+ * Exact times of the base crossings of an F3F course.
+ */
+
+#ifndef F3F_CROSSINGS_H
+#define F3F_CROSSINGS_H
+
+// crossings of the bases: the left base is at x = line,
+// the right one at x = -line
+#define CROSS_LEFT_OUT  0
+#define CROSS_LEFT_IN   1
+#define CROSS_RIGHT_OUT 2
+#define CROSS_RIGHT_IN  3
+#define CROSS_COUNT     4
+
+/**
+ * Gets the F3F x of the model after every simulation step and records
+ * the last crossing of each base. The time of a crossing is
+ * interpolated between the two steps around it, so it is as accurate
+ * as the simulation step at any frame rate.
+ */
+class F3FCrossings
+{
+  public:
+    F3FCrossings();
+
+    /**
+     * Forgets the last step and all crossings.
+     */
+    void reset();
+
+    /**
+     * Records the crossings since the last step.
+     *
+     * \param x     F3F x of the model after this step
+     * \param t     time of this step (ms)
+     * \param line  x of the left base
+     */
+    void step(float x, double t, float line);
+
+    /**
+     * Time of the last crossing (ms), -1 if there has been none.
+     *
+     * \param crossing  one of CROSS_LEFT_OUT ... CROSS_RIGHT_IN
+     */
+    double getTime(int crossing) const { return(cross_time[crossing]); };
+
+    /**
+     * Time of the last step (ms)
+     */
+    double getStepTime() const { return(step_time); };
+
+  private:
+    void check(float x, double t, float line, int up, int down);
+
+    float  step_x;                  ///< F3F x of the last step
+    double step_time;               ///< time of the last step (ms)
+    bool   have_step;               ///< step_x and step_time are valid
+    double cross_time[CROSS_COUNT]; ///< last crossing of a base (ms)
+};
+
+#endif
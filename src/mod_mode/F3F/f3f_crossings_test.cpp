@@ -0,0 +1,302 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+/**
+ * \file f3f_crossings_test.cpp
+ *
+ * Times of F3F base crossings with several simulation steps per frame.
+ *
+ * Usage: f3f_crossings_test [-t seconds] model.xml [model.xml ...]
+ *
+ * First F3FCrossings is fed a model moving at a constant speed, the
+ * interpolated crossings have to be at the exact times (1 us).
+ *
+ * Then every model is flown straight east for some seconds, without a
+ * display, with an environment which only knows calm air and a ground
+ * far below. The FDM reports its steps through
+ * FDMEnviroment::StepCallback(), like CRRC_FDM_Env does to the game
+ * mode. The flight is made with 1 step per call of update() first,
+ * the bases are put around the middle of its path. It is repeated with
+ * more steps per call, as many as there are at low frame rates: all
+ * steps have to be reported, with the same positions, and the
+ * crossings have to be at the same times. Models which don't fly
+ * (helicopters) only get their path compared.
+ *
+ * The return value is the number of failed checks.
+ */
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <math.h>
+
+#include "f3f_crossings.h"
+#include "../../mod_fdm/fdm.h"
+#include "../../mod_fdm/fdm_test_env.h"
+#include "../../mod_fdm/xmlmodelfile.h"
+#include "../../mod_misc/SimpleXMLTransfer.h"
+
+/**
+ * Default FDM step (simulation.flightModel.dt)
+ */
+#define FDM_DT      0.002777
+
+/**
+ * Half the distance between the bases [ft]
+ */
+#define BASE_LINE   100.0
+
+/**
+ * Largest difference of a crossing time [ms]
+ */
+#define MAX_ERROR   0.01
+
+/**
+ * Largest difference of a position after a step [ft]
+ */
+#define MAX_PATH_ERROR 1e-6
+
+/**
+ * Steps per call of update() which are compared to a single step.
+ * 12 steps of FDM_DT are a frame at 30 fps.
+ */
+static const int multiloops[] = { 3, 12 };
+
+/**
+ * Calm air above a flat ground far below. Feeds the F3F x of the
+ * model (its east position, shifted by offset) to crossings on every
+ * step of the FDM.
+ */
+class TestEnv : public FDMTestEnviroment
+{
+  public:
+   TestEnv(double offset) : offset(offset), dTime(0), nSteps(0) {};
+
+   void StepCallback(double dt, FDMBase* fdm, TSimInputs* pInputsFromUser)
+   {
+     dTime += dt;
+     nSteps++;
+     path.push_back(fdm->getPos());
+     crossings.step(fdm->getPos().r[1] - offset, 1e3*dTime, BASE_LINE);
+   };
+
+   double              offset;
+   double              dTime;     ///< sum of the steps [s]
+   unsigned long       nSteps;    ///< number of calls of StepCallback()
+   std::vector<CRRCMath::Vector3> path; ///< position after every step [ft]
+   F3FCrossings        crossings;
+};
+
+
+/**
+ * A constant speed, steps of FDM_DT: the crossings have to be exact,
+ * within the precision of a float.
+ * \return number of errors
+ */
+static int checkConstantSpeed()
+{
+  const double speed = 0.07; // ft/ms
+  F3FCrossings crossings;
+  int          nErrors = 0;
+
+  // out of the left base, back in, out of the right base
+  for (int n = 0; n <= 3300; n++)
+  {
+    double t = n * FDM_DT * 1e3;
+    double x = speed*t - 20;
+
+    if (n > 1500)
+      x = speed*(2*1500*FDM_DT*1e3 - t) - 20;
+    crossings.step(x, t, 50);
+  }
+
+  double expected[CROSS_COUNT];
+  expected[CROSS_LEFT_OUT]  = 70 / speed;
+  expected[CROSS_LEFT_IN]   = 2*1500*FDM_DT*1e3 - 70 / speed;
+  expected[CROSS_RIGHT_OUT] = 2*1500*FDM_DT*1e3 - -30 / speed;
+  expected[CROSS_RIGHT_IN]  = -1;
+
+  for (int i = 0; i < CROSS_COUNT; i++)
+  {
+    if (fabs(crossings.getTime(i) - expected[i]) > 1e-3)
+    {
+      printf("constant speed: crossing %d at %.6f ms instead of %.6f ms\n",
+             i, crossings.getTime(i), expected[i]);
+      nErrors++;
+    }
+  }
+  return nErrors;
+}
+
+
+/**
+ * Flies the model east for nSteps steps, multiloop steps per call of
+ * update(). Returns NULL if it can't be loaded.
+ */
+static TestEnv* fly(const char* filename, double offset, int nSteps, int multiloop)
+{
+  TestEnv*          env = new TestEnv(offset);
+  ModFDMInterface   fdm;
+  SimpleXMLTransfer cfg;
+  TSimInputs        inputs;
+
+  try
+  {
+    SimpleXMLTransfer xml(filename);
+
+    XMLModelFile::SetGraphics(&xml, 0);
+    XMLModelFile::SetConfig  (&xml, 0);
+    fdm.loadAirplane(&xml, env, &cfg);
+  }
+  catch (XMLException& e)
+  {
+    printf("%s\n", e.what());
+    delete env;
+    return NULL;
+  }
+
+  fdm.initAirplaneState(1.0, 0, 0, M_PI/2, 0, 0, -300);
+  for (int n = 0; n < nSteps; n += multiloop)
+    fdm.update(&inputs, FDM_DT, multiloop);
+
+  return env;
+}
+
+
+/**
+ * Compares a flight with several steps per update() to the one with
+ * a single step. Problems are appended to msg.
+ * \return number of errors
+ */
+static int compare(TestEnv* ref, TestEnv* env, int multiloop, std::string& msg)
+{
+  char line[200];
+  int  nErrors = 0;
+
+  if (env->nSteps != ref->nSteps || fabs(env->dTime - ref->dTime) > 1e-9)
+  {
+    snprintf(line, sizeof(line),
+             "  %d steps per update(): %lu steps of %.3f s reported instead of %lu of %.3f s\n",
+             multiloop, env->nSteps, env->dTime, ref->nSteps, ref->dTime);
+    msg += line;
+    return 1;
+  }
+
+  double dMax = 0;
+  for (unsigned int n = 0; n < ref->path.size(); n++)
+  {
+    double d = (env->path[n] - ref->path[n]).length();
+    if (d > dMax)
+      dMax = d;
+  }
+  if (dMax > MAX_PATH_ERROR)
+  {
+    snprintf(line, sizeof(line), "  %d steps per update(): path differs by %g ft\n",
+             multiloop, dMax);
+    msg += line;
+    nErrors++;
+  }
+
+  for (int i = 0; i < CROSS_COUNT; i++)
+  {
+    if (fabs(env->crossings.getTime(i) - ref->crossings.getTime(i)) > MAX_ERROR)
+    {
+      snprintf(line, sizeof(line), "  %d steps per update(): crossing %d at %.3f ms instead of %.3f ms\n",
+               multiloop, i, env->crossings.getTime(i), ref->crossings.getTime(i));
+      msg += line;
+      nErrors++;
+    }
+  }
+  return nErrors;
+}
+
+
+int main(int argc, char** argv)
+{
+  double                   dDuration = 3.0;
+  std::vector<std::string> files;
+
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "-t") == 0 && i+1 < argc)
+      dDuration = atof(argv[++i]);
+    else
+      files.push_back(argv[i]);
+  }
+  if (files.size() == 0)
+  {
+    printf("Usage: f3f_crossings_test [-t seconds] model.xml [model.xml ...]\n");
+    return 1;
+  }
+
+  int         nErrors = checkConstantSpeed();
+  int         nSteps  = 12 * (int)(dDuration / (12*FDM_DT));
+  std::string results;
+
+  for (unsigned int f = 0; f < files.size(); f++)
+  {
+    const char* filename = files[f].c_str();
+    char        line[200];
+
+    // the bases go around the middle of the path, between two steps
+    TestEnv* ref = fly(filename, 0, nSteps, 1);
+    if (ref == NULL)
+    {
+      results += files[f] + ": can't be loaded\n";
+      nErrors++;
+      continue;
+    }
+    if (ref->nSteps != (unsigned long)nSteps)
+    {
+      snprintf(line, sizeof(line), "%s: %lu of %d steps reported\n",
+               filename, ref->nSteps, nSteps);
+      results += line;
+      nErrors++;
+      delete ref;
+      continue;
+    }
+    double x0     = ref->path[nSteps/2].r[1];
+    double x1     = ref->path[nSteps/2 + 1].r[1];
+    double offset = x0 + 0.37*(x1 - x0) - BASE_LINE;
+    delete ref;
+
+    ref = fly(filename, offset, nSteps, 1);
+    if (ref->crossings.getTime(CROSS_LEFT_OUT) < 0)
+      snprintf(line, sizeof(line), "%s: doesn't fly east, only the path is compared\n", filename);
+    else
+      snprintf(line, sizeof(line), "%s: crossing at %.3f ms\n", filename,
+               ref->crossings.getTime(CROSS_LEFT_OUT));
+    results += line;
+
+    for (unsigned int m = 0; m < sizeof(multiloops)/sizeof(multiloops[0]); m++)
+    {
+      TestEnv* env = fly(filename, offset, nSteps, multiloops[m]);
+
+      nErrors += compare(ref, env, multiloops[m], results);
+      delete env;
+    }
+    delete ref;
+  }
+
+  // the FDMs print a lot while loading
+  printf("\n%s%d errors\n", results.c_str(), nErrors);
+  return nErrors;
+}
@@ -38,6 +38,7 @@
 #include <stdio.h>
 #include <math.h>
 #include "../../global.h"
+#include "../../SimStateHandler.h"
 #include "../../crrc_soundserver.h"
 #include "../../global_video.h"
 #include "../../crrc_system.h"
@@ -524,7 +525,11 @@ void HandlerF3F::reset()
   runcurrentstop = 0;
   runcurrentturn = 0;
   runturntime = 0;
-  resettime=SDL_GetTicks();
+  resettime = Global::Simulation->getSimulationTimeSinceReset();
+
+  crossings.reset();
+  frame_time      = 0;
+  prev_frame_time = 0;
 
   for (int i=0; i<MAX_LAPS; i++) 
   {
@@ -600,16 +605,52 @@ int HandlerF3F::play (std::string soundName, int base)
 /** \brief Update internal timers
  *
  *  Updates the internal "current time" and actual "run time".
+ *  Both follow the simulation time, so they don't depend on the
+ *  frame rate and stand still while the simulation is paused.
  */
 void HandlerF3F::update_time ()
 {
-  // *** to replace by the parameter if needed
-  // *** preferable use the exact clock at the time of execution
-  currtime = SDL_GetTicks() - resettime;
+  currtime = Global::Simulation->getSimulationTimeSinceReset() - resettime;
   runtime = currtime - runstarttime - pausetime;
 }
 
 
+/** \brief Run time of a base crossing
+ *
+ *  Returns the run time at which the base crossing has happened if
+ *  it has happened during the steps since the last frame. Otherwise
+ *  (e.g. the model has already been outside of the base after a
+ *  reset) the current run time is returned.
+ *
+ *  \param crossing  one of CROSS_LEFT_OUT ... CROSS_RIGHT_IN
+ *  \return run time in ms
+ */
+int HandlerF3F::crossing_runtime(int crossing)
+{
+  update_time ();
+  if (crossings.getTime(crossing) > prev_frame_time)
+    return (int)(crossings.getTime(crossing) + 0.5) - runstarttime - pausetime;
+  else
+    return runtime;
+}
+
+
+/** \brief Called after every simulation step
+ *
+ *  Records the time of every base crossing. update() runs once per
+ *  frame and uses these times, so the timing is as accurate as the
+ *  simulation step at any frame rate.
+ */
+void HandlerF3F::step(double dSimTime, float a, float b, float c)
+{
+  double t = dSimTime*1000 - resettime;
+  float  x = - (b - center_base_position_east) * cos_dir
+             + (a - center_base_position_north) * sin_dir;
+
+  crossings.step(x, t, plan_limit);
+}
+
+
 /**
  *  Purpose: Get Time when starting the run
  */
@@ -635,11 +676,11 @@ void HandlerF3F::run_start()
         start_sound_id = -1;
       }
       play (f3f_soundFirst);
-      update_time ();
-      if (runtime > MAX_START_TIME)
+      int start = crossing_runtime(CROSS_LEFT_IN);
+      if (start > MAX_START_TIME)
         runstarttime = MAX_START_TIME;
       else
-        runstarttime = runtime;
+        runstarttime = start;
     }
   }
   else  /* start on right */ 
@@ -659,11 +700,11 @@ void HandlerF3F::run_start()
         start_sound_id = -1;
       }
       play (f3f_soundFirst);
-      update_time ();
-      if (runtime > MAX_START_TIME)
+      int start = crossing_runtime(CROSS_RIGHT_IN);
+      if (start > MAX_START_TIME)
         runstarttime = MAX_START_TIME;
       else 
-        runstarttime = runtime;
+        runstarttime = start;
     }
   }
 }
@@ -770,6 +811,8 @@ void HandlerF3F::update_lost_meters ()
  */
 void HandlerF3F::update_turntime ()
 {
+  int back_in = (next_base_to_cross == PYLON_RIGHT) ? CROSS_LEFT_IN : CROSS_RIGHT_IN;
+
   if ( ((XX_cg_rwy > plan_limit) && (next_base_to_cross == PYLON_RIGHT))
         ||
        ((XX_cg_rwy < -plan_limit) && (next_base_to_cross == PYLON_LEFT)) )
@@ -777,6 +820,11 @@ void HandlerF3F::update_turntime ()
     update_time ();
     runcurrentturn = runtime;
   }
+  else if (crossings.getTime(back_in) > prev_frame_time)
+  {
+    // the turn has ended during the steps since the last frame
+    runcurrentturn = crossing_runtime(back_in);
+  }
 }
 
 
@@ -794,6 +842,10 @@ void HandlerF3F::update(float a, float b, float c, FlightRecorder* recorder, Rob
   YY_cg_rwy =  + a * cos_dir + b * sin_dir;
   ZZ_cg_rwy =  c;
 
+  // crossings after prev_frame_time have happened since the last frame
+  prev_frame_time = frame_time;
+  frame_time      = crossings.getStepTime();
+
   // start countdown
   if (run_started == FALSE && run_completed == FALSE)
   {
@@ -838,17 +890,17 @@ void HandlerF3F::update(float a, float b, float c, FlightRecorder* recorder, Rob
 
     if (run_completed == FALSE) 
     {
+      int crossed = crossing_runtime(CROSS_LEFT_OUT);
       base_count++;
       turntime[base_count-1] = runcurrentturn - runcurrentstop;
       runturntime += (runcurrentturn - runcurrentstop);
-      update_time ();
       if (base_count > 0) 
       {
-        runcurrentstop = runtime;
+        runcurrentstop = crossed;
       }
       elapsed_time[base_count] = runcurrentstop - runcurrentstart;
       runlaststart = runcurrentstart;
-      runcurrentstart = runtime;
+      runcurrentstart = crossed;
       lostm[base_count-1] = lost_meters_rel;
       lost_meters_abs += lost_meters_rel;
       lost_meters_rel = 0;
@@ -867,17 +919,17 @@ void HandlerF3F::update(float a, float b, float c, FlightRecorder* recorder, Rob
 
       if (run_completed == FALSE) 
       {
+        int crossed = crossing_runtime(CROSS_RIGHT_OUT);
         base_count++;
         turntime[base_count-1] = runcurrentturn - runcurrentstop;
         runturntime += (runcurrentturn - runcurrentstop);
-        update_time ();
         if (base_count > 0) 
         {
-          runcurrentstop = runtime;
+          runcurrentstop = crossed;
         }
         elapsed_time[base_count] = runcurrentstop - runcurrentstart;
         runlaststart = runcurrentstart;
-        runcurrentstart = runtime;
+        runcurrentstart = crossed;
         lostm[base_count-1] = lost_meters_rel;
         lost_meters_abs += lost_meters_rel;
         lost_meters_rel = 0;
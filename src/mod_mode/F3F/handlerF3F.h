@@ -37,6 +37,7 @@
 #include <plib/fnt.h>   // for fntRenderer
 #include "../../config.h"
 #include "../T_GameHandler.h"
+#include "f3f_crossings.h"
 #define MAX_LAPS 10  
 #define PYLON_LEFT 1
 #define PYLON_RIGHT 2
@@ -51,6 +52,14 @@ class HandlerF3F : public  T_GameHandler
      */
     void update(float a, float b, float c, FlightRecorder* recorder, Robots* robots);
 
+    /** base crossings are timed on every simulation step */
+    bool followsSteps() const { return true; };
+
+    /**
+     * record the exact time of base crossings
+     */
+    void step(double dSimTime, float a, float b, float c);
+
     /**
      *  draw F3F bases and display flight informations
      */
@@ -131,6 +140,7 @@ class HandlerF3F : public  T_GameHandler
     void end_run(FlightRecorder* recorder);
     void update_turntime ();
     void update_lost_meters ();
+    int  crossing_runtime(int crossing);
 
     char f3f_score [1024];
     char f3f_time [256];
@@ -171,6 +181,11 @@ class HandlerF3F : public  T_GameHandler
     int penality_count;
     int start_from_ground ;
 
+    // base crossings, see step()
+    F3FCrossings crossings;         ///< times in ms, like currtime
+    double       frame_time;        ///< time of the last step at this update()
+    double       prev_frame_time;   ///< time of the last step at the last update()
+
     int elapsed_time[MAX_LAPS];
     int lostm[MAX_LAPS];
     int turntime[MAX_LAPS];
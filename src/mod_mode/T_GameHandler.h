@@ -55,6 +55,20 @@ class T_GameHandler
      */
     virtual void update(float a,float b, float c, FlightRecorder* recorder, Robots* robots) {};
 
+    /**
+     *  True if step() is to be called after every simulation step.
+     */
+    virtual bool followsSteps() const { return false; };
+
+    /**
+     *  Called after every simulation step if followsSteps() is true,
+     *  with the simulation time since the last reset (in s) and the
+     *  aircraft's position like in update(). Lets a game mode see what
+     *  happened between two frames, e.g. the exact time of a line
+     *  crossing.
+     */
+    virtual void step(double dSimTime, float a, float b, float c) {};
+
     /**
      *  draw game-specific stuff, like F3F turn markers or
      *  a game-specific text overlay
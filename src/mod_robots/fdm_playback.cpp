@@ -21,6 +21,7 @@
 #include "fdm_playback.h"
 #include "marker.h"
 #include "robotfile.h"
+#include "robotblock.h"
 
 #include <math.h>
 #include <iostream>
@@ -36,77 +37,21 @@ void CRRC_AirplaneSim_Playback::update(TSimInputs* inputs,
     
     dDeltaT -= dt * multiloop;
     
-    while ((dDeltaT < 0 || eF3FState == eF3F_Jump) && !infile.eof() && eF3FState != eF3F_WaitForUser)
+    while ((dDeltaT < 0 || eF3FState == eF3F_Jump) && !IsAtEnd() && eF3FState != eF3F_WaitForUser)
     {
-      int marker;
-      do 
-      {
-        infile.read(buf, 1);
-        switch (buf[0])
-        {
-          case 0x02: // marker            
-            marker = RobotFile::ReadInt32(infile);
-            
-            switch (marker)
-            {
-              case RECMARK_F3F_START:
-                switch (eF3FState)
-                {
-                  case eF3F_Prep:
-                    eF3FState = eF3F_WaitForUser;
-                    break;
-                    
-                  default:
-                    eF3FState = eF3F_Done;
-                    break;
-                }
-                break;
-                
-              default: // ignore
-                break;
-            }
-            break;
-            
-          case 0x03: // xml
-            {
-              SimpleXMLTransfer* data = 0;
-              try
-              {
-                data = new SimpleXMLTransfer(infile);
-              }
-              catch (XMLException e)
-              {
-                data = 0;
-              }
-              // todo: tell someone about this data...
-              if (data)
-                delete data;
-              // skip trailing '\n'
-              infile.read(&(buf[1]), 1);
-            }
-            break;
-            
-          case 0x00:
-            break;
-            
-          default:
-            std::cerr << "unknown record type: " << (int)(buf[0]) << "\n";
-            break;
-        }  
-      }
-      while (buf[0] != 0 && !infile.eof());
+      T_RobotPosition pos;
       
-      if (!infile.eof())
+      if (ReadPosition(pos))
       {
-        double timestep = RobotFile::ReadDouble(infile);
+        double timestep = pos.dt;
         if (eF3FState != eF3F_Jump)
           dDeltaT += timestep;
-        v3PosNew.r[0] = RobotFile::ReadFloat(infile);
-        v3PosNew.r[1] = RobotFile::ReadFloat(infile);
-        v3PosNew.r[2] = RobotFile::ReadFloat(infile);
-        v3Euler.r[0] = RobotFile::ReadInt16(infile) / ROBOT_EULER_TO_INT16;
-        v3Euler.r[1] = RobotFile::ReadInt16(infile) / ROBOT_EULER_TO_INT16;
-        v3Euler.r[2] = RobotFile::ReadInt16(infile) / ROBOT_EULER_TO_INT16;
+        v3PosNew.r[0] = pos.pos[0];
+        v3PosNew.r[1] = pos.pos[1];
+        v3PosNew.r[2] = pos.pos[2];
+        v3Euler.r[0] = pos.euler[0] / ROBOT_EULER_TO_INT16;
+        v3Euler.r[1] = pos.euler[1] / ROBOT_EULER_TO_INT16;
+        v3Euler.r[2] = pos.euler[2] / ROBOT_EULER_TO_INT16;
         
         if (fFirstPos)
         {
@@ -127,9 +72,107 @@ void CRRC_AirplaneSim_Playback::update(TSimInputs* inputs,
   }
 }
 
+bool CRRC_AirplaneSim_Playback::IsAtEnd()
+{
+  return(nBlockPos >= block.Size() && infile.eof());
+}
+
+bool CRRC_AirplaneSim_Playback::ReadPosition(T_RobotPosition& pos)
+{
+  int marker;
+  
+  if (nBlockPos < block.Size())
+  {
+    pos = block.Get(nBlockPos++);
+    return(true);
+  }
+  
+  while (infile.read(buf, 1))
+  {
+    switch (buf[0])
+    {
+      case 0x00:
+        pos.dt     = RobotFile::ReadDouble(infile);
+        pos.pos[0] = RobotFile::ReadFloat(infile);
+        pos.pos[1] = RobotFile::ReadFloat(infile);
+        pos.pos[2] = RobotFile::ReadFloat(infile);
+        pos.euler[0] = RobotFile::ReadInt16(infile);
+        pos.euler[1] = RobotFile::ReadInt16(infile);
+        pos.euler[2] = RobotFile::ReadInt16(infile);
+        return(!infile.eof());
+        
+      case 0x02: // marker            
+        marker = RobotFile::ReadInt32(infile);
+        
+        switch (marker)
+        {
+          case RECMARK_F3F_START:
+            switch (eF3FState)
+            {
+              case eF3F_Prep:
+                eF3FState = eF3F_WaitForUser;
+                break;
+                
+              default:
+                eF3FState = eF3F_Done;
+                break;
+            }
+            break;
+            
+          default: // ignore
+            break;
+        }
+        break;
+        
+      case 0x03: // xml
+        {
+          SimpleXMLTransfer* data = 0;
+          try
+          {
+            data = new SimpleXMLTransfer(infile);
+          }
+          catch (XMLException e)
+          {
+            data = 0;
+          }
+          // todo: tell someone about this data...
+          if (data)
+            delete data;
+          // skip trailing '\n'
+          infile.read(&(buf[1]), 1);
+        }
+        break;
+        
+      case 0x04: // simulation step
+        RobotFile::SkipStepRecord(infile);
+        break;
+        
+      case 0x05: // compressed positions
+        if (!block.Read(infile))
+        {
+          std::cerr << "damaged record: " << filename << "\n";
+          return(false);
+        }
+        nBlockPos = 0;
+        if (block.Size() > 0)
+        {
+          pos = block.Get(nBlockPos++);
+          return(true);
+        }
+        break;
+        
+      default:
+        std::cerr << "unknown record type: " << (int)(buf[0]) << "\n";
+        break;
+    }
+  }
+  return(false);
+}
+
 CRRC_AirplaneSim_Playback::CRRC_AirplaneSim_Playback(const char* filename) : RobotBase()
 {
   header = 0;
+  nBlockPos = 0;
   infile.open(filename, std::ios::binary);
   if (!infile)
   {
@@ -180,6 +223,9 @@ void CRRC_AirplaneSim_Playback::initAirplaneState(double dRelVel,
   // skip trailing '\n'
   infile.read(buf, 1);
 
+  block.Clear();
+  nBlockPos = 0;
+  
   eF3FState = eF3F_Off;
   fFirstPos = true;
 }
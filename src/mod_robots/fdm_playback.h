@@ -22,6 +22,7 @@
 # define FDM_PLAYBACK_H
 
 #include "robot.h"
+#include "robotblock.h"
 
 /**
  * This is not really a FDM, but reads position, attitude and more from
@@ -72,6 +73,19 @@ public:
   virtual void ReceiveMarker(int id);
   
 private:
+  /**
+   * Reads the next position, from the current block of compressed
+   * positions or from the file. Handles the records in between.
+   * 
+   * \return false at the end of the file
+   */
+  bool ReadPosition(T_RobotPosition& pos);
+  
+  /**
+   * true if there are no more positions
+   */
+  bool IsAtEnd();
+  
   enum enum_F3FState { eF3F_Off, eF3F_Prep, eF3F_WaitForUser, eF3F_Jump, eF3F_Done};
   enum_F3FState eF3FState;
   
@@ -81,6 +95,9 @@ private:
   CRRCMath::Vector3 v3PosOld;
   bool fFirstPos;
   
+  RobotPositionBlock block;
+  unsigned int       nBlockPos;  ///< next position in block
+  
   char buf[7*sizeof(double)+1];
 };
 
@@ -0,0 +1,504 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+/** \file robotblock.cpp
+ *
+ *  A compressed block of position records in a flight record.
+ */
+
+#include "robotblock.h"
+#include "robotfile.h"
+
+#include <cstring>
+#include <math.h>
+
+/// time step, x, y, z, phi, theta, psi, new time steps
+#define NUM_COLUMNS   8
+
+/// the time step is one of the last few ones most of the time
+#define NUM_RECENT_DT 8
+
+/// the bytes of a variable length integer are coded with three
+/// models: first byte, second byte, all others
+#define NUM_BYTE_CTX  3
+
+/// blocks larger than this are considered damaged
+#define MAX_BLOCK_SIZE (64*1024*1024)
+
+/// probabilities have 11 bits, they adapt by 1/32 of the difference
+#define PROB_BITS     11
+#define PROB_INIT     (1 << (PROB_BITS-1))
+#define PROB_SHIFT    5
+
+
+/**
+ * Adaptive models for the bytes of all columns: a binary tree of
+ * probabilities per byte context.
+ */
+class T_BlockModel
+{
+public:
+  T_BlockModel()
+  {
+    for (int c = 0; c < NUM_COLUMNS; c++)
+      for (int b = 0; b < NUM_BYTE_CTX; b++)
+        for (int i = 0; i < 256; i++)
+          probs[c][b][i] = PROB_INIT;
+  }
+
+  uint16_t* get(int nColumn, int nByte)
+  {
+    return(probs[nColumn][(nByte < NUM_BYTE_CTX) ? nByte : NUM_BYTE_CTX-1]);
+  }
+
+private:
+  uint16_t probs[NUM_COLUMNS][NUM_BYTE_CTX][256];
+};
+
+
+/**
+ * Binary range coder, like the one of LZMA.
+ */
+class T_RangeEncoder
+{
+public:
+  T_RangeEncoder(std::vector<unsigned char>& buf)
+    : out(buf), low(0), range(0xFFFFFFFF), cache(0), cacheSize(1)
+  {
+  }
+
+  void encodeBit(uint16_t& prob, int bit)
+  {
+    uint32_t bound = (range >> PROB_BITS) * prob;
+
+    if (bit == 0)
+    {
+      range = bound;
+      prob += ((1 << PROB_BITS) - prob) >> PROB_SHIFT;
+    }
+    else
+    {
+      low   += bound;
+      range -= bound;
+      prob  -= prob >> PROB_SHIFT;
+    }
+    while (range < (1U << 24))
+    {
+      range <<= 8;
+      shiftLow();
+    }
+  }
+
+  void encodeByte(uint16_t* probs, int byte)
+  {
+    unsigned int m = 1;
+
+    for (int i = 7; i >= 0; i--)
+    {
+      int bit = (byte >> i) & 1;
+      encodeBit(probs[m], bit);
+      m = (m << 1) | bit;
+    }
+  }
+
+  void flush()
+  {
+    for (int i = 0; i < 5; i++)
+      shiftLow();
+  }
+
+private:
+  void shiftLow()
+  {
+    if ((uint32_t)low < 0xFF000000U || (low >> 32) != 0)
+    {
+      unsigned char carry = (unsigned char)(low >> 32);
+      unsigned char temp  = cache;
+      do
+      {
+        out.push_back(temp + carry);
+        temp = 0xFF;
+      }
+      while (--cacheSize != 0);
+      cache = (unsigned char)(low >> 24);
+    }
+    cacheSize++;
+    low = (low & 0x00FFFFFF) << 8;
+  }
+
+  std::vector<unsigned char>& out;
+  uint64_t      low;
+  uint32_t      range;
+  unsigned char cache;
+  uint64_t      cacheSize;
+};
+
+
+class T_RangeDecoder
+{
+public:
+  T_RangeDecoder(const unsigned char* data, unsigned int size)
+    : in(data), end(data + size), range(0xFFFFFFFF), code(0), fOverrun(false)
+  {
+    for (int i = 0; i < 5; i++)
+      code = (code << 8) | nextByte();
+  }
+
+  int decodeBit(uint16_t& prob)
+  {
+    uint32_t bound = (range >> PROB_BITS) * prob;
+    int      bit;
+
+    if (code < bound)
+    {
+      range = bound;
+      prob += ((1 << PROB_BITS) - prob) >> PROB_SHIFT;
+      bit   = 0;
+    }
+    else
+    {
+      code  -= bound;
+      range -= bound;
+      prob  -= prob >> PROB_SHIFT;
+      bit    = 1;
+    }
+    while (range < (1U << 24))
+    {
+      range <<= 8;
+      code = (code << 8) | nextByte();
+    }
+    return(bit);
+  }
+
+  int decodeByte(uint16_t* probs)
+  {
+    unsigned int m = 1;
+
+    for (int i = 0; i < 8; i++)
+      m = (m << 1) | decodeBit(probs[m]);
+    return(m - 256);
+  }
+
+  /// true if the coder had to read beyond the data
+  bool overrun() const { return(fOverrun); };
+
+private:
+  unsigned char nextByte()
+  {
+    if (in < end)
+      return(*in++);
+    fOverrun = true;
+    return(0);
+  }
+
+  const unsigned char* in;
+  const unsigned char* end;
+  uint32_t             range;
+  uint32_t             code;
+  bool                 fOverrun;
+};
+
+
+static inline uint64_t zigzag(int64_t nVal)
+{
+  return(((uint64_t)nVal << 1) ^ (uint64_t)(nVal >> 63));
+}
+
+static inline int64_t unzigzag(uint64_t uVal)
+{
+  return((int64_t)(uVal >> 1) ^ -(int64_t)(uVal & 1));
+}
+
+static void encodeValue(T_RangeEncoder& rc, T_BlockModel& model, int nColumn, int64_t nVal)
+{
+  uint64_t uVal  = zigzag(nVal);
+  int      nByte = 0;
+
+  while (uVal >= 0x80)
+  {
+    rc.encodeByte(model.get(nColumn, nByte++), (int)(uVal & 0x7F) | 0x80);
+    uVal >>= 7;
+  }
+  rc.encodeByte(model.get(nColumn, nByte), (int)uVal);
+}
+
+static int64_t decodeValue(T_RangeDecoder& rc, T_BlockModel& model, int nColumn)
+{
+  uint64_t uVal  = 0;
+  int      nByte = 0;
+  int      byte;
+
+  do
+  {
+    byte  = rc.decodeByte(model.get(nColumn, nByte));
+    uVal |= (uint64_t)(byte & 0x7F) << (7*nByte);
+    nByte++;
+  }
+  while ((byte & 0x80) && nByte < 10);
+
+  return(unzigzag(uVal));
+}
+
+/**
+ * Linear extrapolation of the last two values.
+ */
+static inline int64_t predict(unsigned int n, int64_t a, int64_t b)
+{
+  if (n >= 2)
+    return(2*a - b);
+  else if (n == 1)
+    return(a);
+  else
+    return(0);
+}
+
+/**
+ * The last NUM_RECENT_DT different values, the latest first.
+ */
+class RecentList
+{
+public:
+  RecentList()
+  {
+    for (int i = 0; i < NUM_RECENT_DT; i++)
+      values[i] = 0;
+  }
+
+  /// index of the value, NUM_RECENT_DT if it isn't in the list
+  int find(uint64_t uVal) const
+  {
+    for (int i = 0; i < NUM_RECENT_DT; i++)
+      if (values[i] == uVal)
+        return(i);
+    return(NUM_RECENT_DT);
+  }
+
+  uint64_t get(int nIndex) const { return(values[nIndex]); };
+
+  /// moves the value at nIndex (or a new one) to the front
+  void use(int nIndex, uint64_t uVal)
+  {
+    if (nIndex == NUM_RECENT_DT)
+      nIndex = NUM_RECENT_DT - 1;
+    for (int i = nIndex; i > 0; i--)
+      values[i] = values[i-1];
+    values[0] = uVal;
+  }
+
+private:
+  uint64_t values[NUM_RECENT_DT];
+};
+
+static inline int64_t quantizePos(double dVal)
+{
+  return((int64_t)floor(dVal / ROBOT_POS_QUANTUM + 0.5));
+}
+
+static inline int toInt16(int nVal)
+{
+  return((int16_t)(uint16_t)(nVal & 0xFFFF));
+}
+
+
+RobotPositionBlock::RobotPositionBlock()
+{
+}
+
+void RobotPositionBlock::Add(double dt, const double* pos, const double* euler)
+{
+  T_RobotPosition p;
+
+  p.dt = dt;
+  for (int i = 0; i < 3; i++)
+  {
+    p.pos[i]   = (float)(quantizePos(pos[i]) * ROBOT_POS_QUANTUM);
+    // like RobotFile::WriteInt16()
+    p.euler[i] = toInt16((int)(euler[i]*ROBOT_EULER_TO_INT16 + 0.5));
+  }
+  positions.push_back(p);
+}
+
+void RobotPositionBlock::Encode(std::vector<unsigned char>& buf) const
+{
+  uint32_t       nCount = positions.size();
+  T_BlockModel*  model  = new T_BlockModel();
+
+  buf.clear();
+  buf.resize(4);
+  memcpy(&buf[0], &nCount, 4);
+
+  T_RangeEncoder rc(buf);
+
+  // time steps: a multiple of the FDM step, which varies from frame
+  // to frame. The index in the list of recent ones, or the value.
+  {
+    RecentList recent;
+    for (unsigned int n = 0; n < nCount; n++)
+    {
+      uint64_t bits;
+      memcpy(&bits, &positions[n].dt, 8);
+      int nIndex = recent.find(bits);
+      encodeValue(rc, *model, 0, nIndex);
+      if (nIndex == NUM_RECENT_DT)
+        encodeValue(rc, *model, 7, (int64_t)bits);
+      recent.use(nIndex, bits);
+    }
+  }
+
+  // position (the floats are multiples of ROBOT_POS_QUANTUM, so
+  // quantizing them again is exact)
+  for (int i = 0; i < 3; i++)
+  {
+    int64_t a = 0;
+    int64_t b = 0;
+    for (unsigned int n = 0; n < nCount; n++)
+    {
+      int64_t q = quantizePos(positions[n].pos[i]);
+      encodeValue(rc, *model, 1+i, q - predict(n, a, b));
+      b = a;
+      a = q;
+    }
+  }
+
+  // attitude, modulo 2^16 like the angles
+  for (int i = 0; i < 3; i++)
+  {
+    int a = 0;
+    int b = 0;
+    for (unsigned int n = 0; n < nCount; n++)
+    {
+      int e = positions[n].euler[i];
+      encodeValue(rc, *model, 4+i, toInt16(e - (int)predict(n, a, b)));
+      b = a;
+      a = e;
+    }
+  }
+
+  rc.flush();
+  delete model;
+}
+
+bool RobotPositionBlock::Decode(const std::vector<unsigned char>& buf)
+{
+  uint32_t nCount;
+
+  positions.clear();
+  if (buf.size() < 4)
+    return(false);
+  memcpy(&nCount, &buf[0], 4);
+  if (nCount > MAX_POSITIONS)
+    return(false);
+
+  T_BlockModel*  model = new T_BlockModel();
+  T_RangeDecoder rc(&buf[4], buf.size() - 4);
+
+  positions.resize(nCount);
+
+  {
+    RecentList recent;
+    for (unsigned int n = 0; n < nCount; n++)
+    {
+      int      nIndex = (int)decodeValue(rc, *model, 0);
+      uint64_t bits;
+      if (nIndex < 0 || nIndex > NUM_RECENT_DT)
+        nIndex = NUM_RECENT_DT;
+      if (nIndex == NUM_RECENT_DT)
+        bits = (uint64_t)decodeValue(rc, *model, 7);
+      else
+        bits = recent.get(nIndex);
+      recent.use(nIndex, bits);
+      memcpy(&positions[n].dt, &bits, 8);
+    }
+  }
+
+  for (int i = 0; i < 3; i++)
+  {
+    int64_t a = 0;
+    int64_t b = 0;
+    for (unsigned int n = 0; n < nCount; n++)
+    {
+      int64_t q = predict(n, a, b) + decodeValue(rc, *model, 1+i);
+      positions[n].pos[i] = (float)(q * ROBOT_POS_QUANTUM);
+      b = a;
+      a = q;
+    }
+  }
+
+  for (int i = 0; i < 3; i++)
+  {
+    int a = 0;
+    int b = 0;
+    for (unsigned int n = 0; n < nCount; n++)
+    {
+      int e = toInt16((int)predict(n, a, b) + (int)decodeValue(rc, *model, 4+i));
+      positions[n].euler[i] = e;
+      b = a;
+      a = e;
+    }
+  }
+
+  delete model;
+
+  if (rc.overrun())
+  {
+    positions.clear();
+    return(false);
+  }
+  return(true);
+}
+
+void RobotPositionBlock::Write(std::ofstream& out)
+{
+  if (positions.empty())
+    return;
+
+  Encode(buffer);
+
+  const char rt = 0x05;
+  out.write(&rt, 1);
+  RobotFile::WriteInt32(out, buffer.size());
+  out.write((const char*)&buffer[0], buffer.size());
+
+  positions.clear();
+}
+
+bool RobotPositionBlock::Read(std::ifstream& in)
+{
+  int nSize = RobotFile::ReadInt32(in);
+
+  positions.clear();
+  if (!in || nSize < 4 || nSize > MAX_BLOCK_SIZE)
+    return(false);
+
+  buffer.resize(nSize);
+  in.read((char*)&buffer[0], nSize);
+  if (in.gcount() != nSize)
+    return(false);
+
+  return(Decode(buffer));
+}
+
+void RobotPositionBlock::Skip(std::ifstream& in)
+{
+  int nSize = RobotFile::ReadInt32(in);
+
+  if (in && nSize > 0)
+    in.ignore(nSize);
+}
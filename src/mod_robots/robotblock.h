@@ -0,0 +1,122 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+/** \file robotblock.h
+ *
+ *  A compressed block of position records in a flight record.
+ */
+
+#ifndef ROBOTBLOCK_H
+# define ROBOTBLOCK_H
+
+# include <fstream>
+# include <vector>
+# include <stdint.h>
+
+/// positions are stored in multiples of this, in ft
+#define ROBOT_POS_QUANTUM (1.0/1024)
+
+/**
+ * What a position record (type 0x00) contains.
+ */
+typedef struct
+{
+  double  dt;        ///< time since the last position
+  float   pos[3];
+  int     euler[3];  ///< phi, theta, psi, times ROBOT_EULER_TO_INT16
+} T_RobotPosition;
+
+
+/**
+ * Up to MAX_POSITIONS position records, stored as one record of type
+ * 0x05 instead of one record per position:
+ *
+ *   uint32  size of the rest of the record in bytes
+ *   uint32  number of positions
+ *   ...     range coded columns
+ *
+ * The block is stored column by column: time steps, x, y, z, phi,
+ * theta, psi. A time step is stored as its index in a list of the
+ * recent ones. Position and attitude are predicted by a linear
+ * extrapolation of the last two values and only the difference is
+ * stored. All of these are zigzag encoded, as variable length
+ * integers. The bytes of these integers are coded by an adaptive
+ * binary range coder with a model for each column, so the frequent
+ * small differences take only a few bits.
+ *
+ * Time steps and attitude are stored exactly, positions are
+ * quantized to ROBOT_POS_QUANTUM. Every block can be decoded on its
+ * own.
+ */
+class RobotPositionBlock
+{
+public:
+
+  enum { MAX_POSITIONS = 4096 };
+
+  RobotPositionBlock();
+
+  /**
+   * Append a position (ft) and attitude (phi, theta, psi in rad).
+   * The position is quantized, the attitude is rounded like in a
+   * position record.
+   */
+  void Add(double dt, const double* pos, const double* euler);
+
+  unsigned int Size() const { return(positions.size()); };
+
+  bool IsFull() const { return(positions.size() >= MAX_POSITIONS); };
+
+  const T_RobotPosition& Get(unsigned int n) const { return(positions[n]); };
+
+  void Clear() { positions.clear(); };
+
+  /**
+   * Write the block as a record of type 0x05 (if it isn't empty)
+   * and clear it.
+   */
+  void Write(std::ofstream& out);
+
+  /**
+   * Read a record of type 0x05, the record type has already been
+   * read. Replaces the contents of the block.
+   *
+   * \return false if the file ends or the record is damaged
+   */
+  bool Read(std::ifstream& in);
+
+  /**
+   * Skip a record of type 0x05, the record type has already been read.
+   */
+  static void Skip(std::ifstream& in);
+
+  /**
+   * Encode/decode the positions to/from a buffer, without the
+   * record type and size.
+   */
+  void Encode(std::vector<unsigned char>& buf) const;
+  bool Decode(const std::vector<unsigned char>& buf);
+
+private:
+  std::vector<T_RobotPosition> positions;
+  std::vector<unsigned char>   buffer;
+};
+
+#endif
@@ -0,0 +1,338 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+/**
+ * \file robotblock_test.cpp
+ *
+ * Size and speed of compressed flight records (RobotPositionBlock).
+ *
+ * Usage: robotblock_test [-h hours] [-f frames_per_s] [-d dir]
+ *
+ * A synthetic flight of some hours (default 2) with one position per
+ * frame (default 60 frames/s) is written to dir (default: the current
+ * directory): a glider going up and down a slope, circling in thermals
+ * now and then, with some turbulence and a frame rate which varies a
+ * little. The flight is written as position records and as
+ * compressed blocks, like FlightRecorder does it.
+ *
+ * The compression ratio, the encode and decode speed (MB/s of position
+ * records) and the time RobotFile needs to load both files are
+ * printed. After that both files are played back by
+ * CRRC_AirplaneSim_Playback.
+ *
+ * The return value is the number of positions which differ from the
+ * original by more than the quantization, in the decoded blocks or in
+ * the playback, plus one if a block which claims more than
+ * MAX_POSITIONS positions is decoded.
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <math.h>
+
+#include "fdm_playback.h"
+#include "robotblock.h"
+#include "robotfile.h"
+#include "../mod_misc/scheduler.h"
+
+/// default FDM step (simulation.flightModel.dt)
+#define FDM_DT     0.002777
+
+/// size of a position record
+#define RECORD_SIZE (1+8+3*4+3*2)
+
+
+// These are defined next to ModFDMInterface and ModRobotInterface,
+// which need all flight models.
+FDMBase::FDMBase(const char* logfilename, FDMEnviroment* myEnv)
+{
+  env = myEnv;
+}
+
+FDMBase::~FDMBase()
+{
+}
+
+RobotBase::RobotBase() : FDMBase("", (FDMEnviroment*)0)
+{
+}
+
+
+/**
+ * A position of the synthetic flight.
+ */
+typedef struct
+{
+  double dt;
+  double pos[3];
+  double euler[3];
+} T_Sample;
+
+
+/**
+ * Flies the synthetic glider. The random numbers are from a fixed
+ * LCG, so the flight is the same every time.
+ */
+static void makeFlight(std::vector<T_Sample>& flight, double dHours, double dFrameRate)
+{
+  unsigned int  seed   = 12345;
+  unsigned long nCount = (unsigned long)(dHours * 3600 * dFrameRate);
+  int           nSteps = (int)(1.0 / (dFrameRate * FDM_DT) + 0.5);
+  double        t      = 0;
+  double        x      = 0;
+  double        y      = 0;
+  double        z      = -100;
+  double        psi    = 0;
+  double        gust   = 0;
+
+  flight.resize(nCount);
+  for (unsigned long n = 0; n < nCount; n++)
+  {
+    T_Sample& s = flight[n];
+
+    seed = seed * 1103515245 + 12345;
+    // a frame takes one FDM step more or less now and then
+    int multiloop = nSteps + (int)((seed >> 16) % 5) / 4 - (int)((seed >> 20) % 7) / 6;
+    s.dt = FDM_DT * multiloop;
+    t   += s.dt;
+
+    // every 5 minutes a thermal for one minute, slope passes otherwise
+    double dTurn;
+    if (fmod(t, 300) < 60)
+      dTurn = 0.6;
+    else
+      dTurn = 0.5 * sin(t * 2*M_PI / 40);
+
+    seed  = seed * 1103515245 + 12345;
+    gust  = 0.98*gust + 0.02*(((seed >> 16) & 0xFFFF) / 32768.0 - 1);
+
+    psi  += dTurn * s.dt;
+    x    += 40 * cos(psi) * s.dt;
+    y    += 40 * sin(psi) * s.dt;
+    z    += (2*gust - 1*sin(t * 2*M_PI / 600)) * s.dt;
+
+    s.pos[0]   = x;
+    s.pos[1]   = y;
+    s.pos[2]   = z;
+    s.euler[0] = 0.8*dTurn + 0.05*gust;
+    s.euler[1] = 0.03 + 0.02*gust;
+    s.euler[2] = fmod(psi, 2*M_PI);
+  }
+}
+
+
+static long fileSize(std::string filename)
+{
+  FILE* fp = fopen(filename.c_str(), "rb");
+  if (fp == NULL)
+    return 0;
+  fseek(fp, 0, SEEK_END);
+  long nSize = ftell(fp);
+  fclose(fp);
+  return nSize;
+}
+
+
+static void writeHeader(std::ofstream& out)
+{
+  SimpleXMLTransfer header;
+  header.setName("CRRCSim_record");
+  header.setAttribute("CRRCSim", "test");
+  header.print(out, 0);
+}
+
+
+int main(int argc, char** argv)
+{
+  double      dHours     = 2;
+  double      dFrameRate = 60;
+  std::string dir        = ".";
+  int         nErrors    = 0;
+
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "-h") == 0 && i+1 < argc)
+      dHours = atof(argv[++i]);
+    else if (strcmp(argv[i], "-f") == 0 && i+1 < argc)
+      dFrameRate = atof(argv[++i]);
+    else if (strcmp(argv[i], "-d") == 0 && i+1 < argc)
+      dir = argv[++i];
+  }
+
+  std::vector<T_Sample> flight;
+  makeFlight(flight, dHours, dFrameRate);
+
+  std::string rawFile   = dir + "/robotblock_test_raw.crrclog";
+  std::string blockFile = dir + "/robotblock_test_block.crrclog";
+  double      dRawMB    = (double)flight.size() * RECORD_SIZE / (1024*1024);
+
+  printf("%.1f h, %lu positions, %.1f MB of position records\n",
+         dHours, (unsigned long)flight.size(), dRawMB);
+
+  // position records, like FlightRecorder::AirplanePosition()
+  double dRawTime;
+  {
+    double        dStart = Scheduler::getSeconds();
+    std::ofstream out(rawFile.c_str(), std::ios::binary);
+    writeHeader(out);
+    for (unsigned long n = 0; n < flight.size(); n++)
+    {
+      const char rt = 0x00;
+      out.write(&rt, 1);
+      RobotFile::WriteDouble(out, flight[n].dt);
+      for (int i = 0; i < 3; i++)
+        RobotFile::WriteFloat(out, flight[n].pos[i]);
+      for (int i = 0; i < 3; i++)
+        RobotFile::WriteInt16(out, flight[n].euler[i]*ROBOT_EULER_TO_INT16);
+    }
+    out.close();
+    dRawTime = Scheduler::getSeconds() - dStart;
+  }
+
+  // compressed blocks
+  double dEncodeTime;
+  {
+    double             dStart = Scheduler::getSeconds();
+    RobotPositionBlock block;
+    std::ofstream      out(blockFile.c_str(), std::ios::binary);
+    writeHeader(out);
+    for (unsigned long n = 0; n < flight.size(); n++)
+    {
+      block.Add(flight[n].dt, flight[n].pos, flight[n].euler);
+      if (block.IsFull())
+        block.Write(out);
+    }
+    block.Write(out);
+    out.close();
+    dEncodeTime = Scheduler::getSeconds() - dStart;
+  }
+
+  long nRawSize   = fileSize(rawFile);
+  long nBlockSize = fileSize(blockFile);
+  printf("position records: %8.3f MB, write %7.1f MB/s\n",
+         nRawSize / (1024.0*1024), dRawMB / dRawTime);
+  printf("blocks:           %8.3f MB, encode and write %7.1f MB/s, ratio %.1f\n",
+         nBlockSize / (1024.0*1024), dRawMB / dEncodeTime, (double)nRawSize / nBlockSize);
+
+  // decode all blocks and compare them with the original flight
+  {
+    double             dStart = Scheduler::getSeconds();
+    RobotPositionBlock block;
+    std::ifstream      in(blockFile.c_str(), std::ios::binary);
+    unsigned long      nPos   = 0;
+    int                nErr   = 0;
+    char               rt;
+
+    SimpleXMLTransfer header(in);
+    in.read(&rt, 1);
+    while (in.read(&rt, 1))
+    {
+      if (rt != 0x05 || !block.Read(in))
+      {
+        printf("damaged block after %lu positions\n", nPos);
+        nErr++;
+        break;
+      }
+      for (unsigned int n = 0; n < block.Size() && nPos < flight.size(); n++, nPos++)
+      {
+        const T_RobotPosition& p = block.Get(n);
+        const T_Sample&        s = flight[nPos];
+        bool                   fOk = (p.dt == s.dt);
+
+        for (int i = 0; i < 3; i++)
+        {
+          int e = (int)(s.euler[i]*ROBOT_EULER_TO_INT16 + 0.5);
+          if (fabs(p.pos[i] - s.pos[i]) > ROBOT_POS_QUANTUM || p.euler[i] != (int16_t)e)
+            fOk = false;
+        }
+        if (!fOk)
+          nErr++;
+      }
+    }
+    if (nPos != flight.size())
+      nErr++;
+
+    double dTime = Scheduler::getSeconds() - dStart;
+    printf("blocks:           read and decode %7.1f MB/s, wrong positions: %i\n",
+           dRawMB / dTime, nErr);
+    nErrors += nErr;
+  }
+
+  // a damaged block which claims more positions than a block can have
+  {
+    RobotPositionBlock         block;
+    std::vector<unsigned char> buf(64, 0);
+    uint32_t                   nCount = RobotPositionBlock::MAX_POSITIONS + 1;
+
+    memcpy(&buf[0], &nCount, 4);
+    if (block.Decode(buf))
+    {
+      printf("a block of %u positions has been decoded\n", nCount);
+      nErrors++;
+    }
+  }
+
+  // what loading a robot file costs
+  {
+    double dStart = Scheduler::getSeconds();
+    { RobotFile rf(rawFile); }
+    double dMid   = Scheduler::getSeconds();
+    { RobotFile rf(blockFile); }
+    double dEnd   = Scheduler::getSeconds();
+    printf("RobotFile: position records %.3f s, blocks %.3f s\n", dMid - dStart, dEnd - dMid);
+  }
+
+  // play both back, in frames of about 0.1 s
+  {
+    CRRC_AirplaneSim_Playback raw(rawFile.c_str());
+    CRRC_AirplaneSim_Playback blocks(blockFile.c_str());
+    TSimInputs                dummy;
+    int                       nFrames = (int)(dHours * 3600 * 10);
+    int                       nErr    = 0;
+    double                    dStart  = Scheduler::getSeconds();
+
+    raw.initAirplaneState(0, 0, 0, 0, 0, 0, 0);
+    blocks.initAirplaneState(0, 0, 0, 0, 0, 0, 0);
+    for (int f = 0; f < nFrames; f++)
+    {
+      raw.update(&dummy, FDM_DT, 36);
+      blocks.update(&dummy, FDM_DT, 36);
+
+      // the interpolation mixes two positions, each of which can be
+      // off by half a quantum or less
+      CRRCMath::Vector3 d = raw.getPos() - blocks.getPos();
+      if (fabs(d.r[0]) > ROBOT_POS_QUANTUM || fabs(d.r[1]) > ROBOT_POS_QUANTUM ||
+          fabs(d.r[2]) > ROBOT_POS_QUANTUM ||
+          raw.getPhi()   != blocks.getPhi()   ||
+          raw.getTheta() != blocks.getTheta() ||
+          raw.getPsi()   != blocks.getPsi())
+        nErr++;
+    }
+    printf("playback: %i frames in %.3f s, different frames: %i\n",
+           nFrames, Scheduler::getSeconds() - dStart, nErr);
+    nErrors += nErr;
+  }
+
+  remove(rawFile.c_str());
+  remove(blockFile.c_str());
+
+  return nErrors;
+}
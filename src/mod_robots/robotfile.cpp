@@ -18,6 +18,7 @@
  *
  */
 #include "robotfile.h"
+#include "robotblock.h"
 
 #include <iostream>
 
@@ -57,6 +58,14 @@ RobotFile::RobotFile(std::string filename)
           xmls.push_back(tmp);
           break;
           
+        case 0x04: // simulation step
+          RobotFile::SkipStepRecord(infile);
+          break;
+          
+        case 0x05: // compressed positions
+          RobotPositionBlock::Skip(infile);
+          break;
+          
         default:
           std::cerr << "unknown record type: " << (int)(buf[0]) << "\n";
           break;
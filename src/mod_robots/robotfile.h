@@ -23,7 +23,9 @@
 # include <fstream>
 # include <vector>
 # include <string>
+# include <stdint.h>
 # include "../mod_misc/SimpleXMLTransfer.h"
+# include "../mod_fdm/fdm_inputs.h"
 
 #define ROBOT_EULER_TO_INT16 (32767.0/2/M_PI)
 
@@ -87,6 +89,33 @@ public:
     return(dVal);
   }
   
+  /**
+   * 
+   */
+  static inline uint64_t ReadUInt64(std::ifstream& in)
+  {
+    uint64_t nVal;
+    in.read((char*)&nVal, 8);
+    return(nVal);
+  }
+  
+  /**
+   * Skips the rest of a simulation step record (type 0x04), see
+   * FlightRecorder::SimulationStep().
+   */
+  static inline void SkipStepRecord(std::ifstream& in)
+  {
+    // multiloop, eight controls, aux inputs, heli_fixed_z
+    in.ignore(4 + (8 + TSimInputs::NUM_AUX_INPUTS + 1)*4);
+    
+    int nKeys = ReadInt32(in);
+    if (nKeys > 0 && !in.eof())
+      in.ignore(4*nKeys);
+    
+    // state hash
+    in.ignore(8);
+  }
+  
   /**
    * store double as double
    */
@@ -114,6 +143,14 @@ public:
     out.write((char*)&nVal, 4);
   }
   
+  /**
+   * 
+   */
+  static inline void WriteUInt64(std::ofstream& out, uint64_t nVal)
+  {
+    out.write((char*)&nVal, 8);
+  }
+  
   /**
    * 
    */
@@ -0,0 +1,259 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+/**
+ * \file robots_test.cpp
+ *
+ * Stress test for the update of many playback robots, like
+ * Robots::Update() does it.
+ *
+ * Usage: robots_test [-n frames] [-t threads] [-d dir] robots [robots ...]
+ *
+ * A few flight records with different tracks are written to dir
+ * (default: the current directory). For every number of robots
+ * (default: 100, 200 and 500) two populations of playback robots are
+ * loaded from them. Every frame the state of the first one is
+ * updated one robot after the other, the second one is updated on a
+ * WorkerPool. After that the poses of both are published to a scene,
+ * one robot after the other. The published poses have to be exactly
+ * the same.
+ *
+ * The wall clock time per frame is printed for both versions. The
+ * return value is the number of frames with different poses.
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <math.h>
+
+#include "fdm_playback.h"
+#include "robotfile.h"
+#include "../mod_misc/scheduler.h"
+#include "../mod_misc/worker_pool.h"
+
+/**
+ * Default FDM step (simulation.flightModel.dt) and steps per frame
+ */
+#define FDM_DT      0.002777
+#define MULTILOOP   12
+
+/// number of different flight records
+#define NUM_FILES   8
+
+
+// These are defined next to ModFDMInterface and ModRobotInterface,
+// which need all flight models.
+FDMBase::FDMBase(const char* logfilename, FDMEnviroment* myEnv)
+{
+  env = myEnv;
+}
+
+FDMBase::~FDMBase()
+{
+}
+
+RobotBase::RobotBase() : FDMBase("", (FDMEnviroment*)0)
+{
+}
+
+
+/**
+ * Writes a record of a circle which starts at an angle depending on
+ * nFile, with one position and one simulation step record every
+ * simulation step.
+ */
+static std::string writeRecord(std::string dir, int nFile, int nSteps)
+{
+  std::string   filename = dir + "/robots_test" + (char)('0' + nFile) + ".crrclog";
+  std::ofstream out(filename.c_str(), std::ios::binary);
+
+  SimpleXMLTransfer header;
+  header.setName("CRRCSim_record");
+  header.setAttribute("CRRCSim", "test");
+  header.print(out, 0);
+
+  for (int n = 0; n < nSteps; n++)
+  {
+    double     a  = 0.7*nFile + n*FDM_DT*0.3;
+    const char rt = 0x00;
+    out.write(&rt, 1);
+    RobotFile::WriteDouble(out, FDM_DT);
+    RobotFile::WriteFloat(out, 100*cos(a));
+    RobotFile::WriteFloat(out, 100*sin(a));
+    RobotFile::WriteFloat(out, -30 - 5*nFile);
+    RobotFile::WriteInt16(out, 0.3*ROBOT_EULER_TO_INT16);
+    RobotFile::WriteInt16(out, 0.05*nFile*ROBOT_EULER_TO_INT16);
+    RobotFile::WriteInt16(out, fmod(a, M_PI)*ROBOT_EULER_TO_INT16);
+
+    // like a deterministic record (FlightRecorder::SimulationStep()),
+    // which has to be skipped
+    const char st = 0x04;
+    out.write(&st, 1);
+    RobotFile::WriteInt32(out, 1);
+    for (int i = 0; i < 13; i++)
+      RobotFile::WriteFloat(out, 0.1*i);
+    RobotFile::WriteInt32(out, n % 2);
+    if (n % 2)
+      RobotFile::WriteInt32(out, 'l');
+    RobotFile::WriteUInt64(out, n);
+  }
+  return filename;
+}
+
+
+/**
+ * A population of robots with the state in arrays, like Robots.
+ */
+class Population
+{
+  public:
+    Population(std::vector<std::string>& files, int nRobots)
+      : pos(nRobots), euler(nRobots), scene(nRobots*12)
+    {
+      for (int n = 0; n < nRobots; n++)
+      {
+        robots.push_back(new CRRC_AirplaneSim_Playback(files[n % files.size()].c_str()));
+        robots[n]->initAirplaneState(0, 0, 0, 0, 0, 0, 0);
+      }
+    }
+
+    ~Population()
+    {
+      for (unsigned int n = 0; n < robots.size(); n++)
+        delete robots[n];
+    }
+
+    static void UpdateState(void* population, int n)
+    {
+      Population* self = (Population*)population;
+      TSimInputs  dummy;
+
+      self->robots[n]->update(&dummy, FDM_DT, MULTILOOP);
+      self->pos[n]   = self->robots[n]->getPos();
+      self->euler[n] = CRRCMath::Vector3(self->robots[n]->getPhi(),
+                                         self->robots[n]->getTheta(),
+                                         self->robots[n]->getPsi());
+    }
+
+    /**
+     * Like Video::set_position(): a transformation matrix per robot.
+     */
+    void Publish()
+    {
+      for (unsigned int n = 0; n < robots.size(); n++)
+      {
+        double sphi = sin(euler[n].r[0]), cphi = cos(euler[n].r[0]);
+        double sthe = sin(euler[n].r[1]), cthe = cos(euler[n].r[1]);
+        double spsi = sin(euler[n].r[2]), cpsi = cos(euler[n].r[2]);
+        float* m    = &scene[n*12];
+
+        m[0]  = cthe*cpsi;
+        m[1]  = cthe*spsi;
+        m[2]  = -sthe;
+        m[3]  = sphi*sthe*cpsi - cphi*spsi;
+        m[4]  = sphi*sthe*spsi + cphi*cpsi;
+        m[5]  = sphi*cthe;
+        m[6]  = cphi*sthe*cpsi + sphi*spsi;
+        m[7]  = cphi*sthe*spsi - sphi*cpsi;
+        m[8]  = cphi*cthe;
+        m[9]  = pos[n].r[0];
+        m[10] = -pos[n].r[2];
+        m[11] = pos[n].r[1];
+      }
+    }
+
+    std::vector<CRRC_AirplaneSim_Playback*> robots;
+    std::vector<CRRCMath::Vector3>          pos;
+    std::vector<CRRCMath::Vector3>          euler;
+    std::vector<float>                      scene;
+};
+
+
+int main(int argc, char** argv)
+{
+  int                      nFrames  = 500;
+  int                      nThreads = 0;
+  int                      nErrors  = 0;
+  std::string              dir      = ".";
+  std::vector<int>         counts;
+  std::vector<std::string> files;
+
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "-n") == 0 && i+1 < argc)
+      nFrames = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-t") == 0 && i+1 < argc)
+      nThreads = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-d") == 0 && i+1 < argc)
+      dir = argv[++i];
+    else
+      counts.push_back(atoi(argv[i]));
+  }
+  if (counts.size() == 0)
+  {
+    counts.push_back(100);
+    counts.push_back(200);
+    counts.push_back(500);
+  }
+
+  // enough steps for all frames
+  for (int f = 0; f < NUM_FILES; f++)
+    files.push_back(writeRecord(dir, f, (nFrames + 1) * MULTILOOP));
+
+  WorkerPool pool(nThreads);
+
+  for (unsigned int c = 0; c < counts.size(); c++)
+  {
+    Population serial(files, counts[c]);
+    Population parallel(files, counts[c]);
+    double     dTime[2] = {0, 0};
+    int        nErr     = 0;
+
+    for (int f = 0; f < nFrames; f++)
+    {
+      double dStart = Scheduler::getSeconds();
+      for (int n = 0; n < counts[c]; n++)
+        Population::UpdateState(&serial, n);
+      serial.Publish();
+
+      double dMid = Scheduler::getSeconds();
+      pool.run(Population::UpdateState, &parallel, counts[c]);
+      parallel.Publish();
+      double dEnd = Scheduler::getSeconds();
+
+      dTime[0] += dMid - dStart;
+      dTime[1] += dEnd - dMid;
+
+      if (memcmp(&serial.scene[0], &parallel.scene[0], serial.scene.size()*sizeof(float)) != 0)
+        nErr++;
+    }
+
+    printf("%4i robots, ms/frame: serial %.3f  %i threads %.3f, wrong frames: %i\n",
+           counts[c], 1e3*dTime[0]/nFrames,
+           pool.getThreadCount(), 1e3*dTime[1]/nFrames, nErr);
+    nErrors += nErr;
+  }
+
+  for (unsigned int f = 0; f < files.size(); f++)
+    remove(files[f].c_str());
+
+  return nErrors;
+}
@@ -25,14 +25,17 @@
  */
 #include "../i18n.h"
 #include "airplane_vis.h"
+#include "asset_cache.h"
 #include "crrc_ssgutils.h"
 #include "crrc_graphics.h"
+#include "ssg_partition.h"
 #include "shadow.h"
 #include <list>
 #include <string>
 #include <stdexcept>
 #include <iostream>
 #include <sstream>
+#include <SDL.h>
 
 #include "../global.h"  // only for LOG()
 
@@ -45,6 +48,11 @@ namespace Video
 #define EXPERIMENTAL_STENCIL_SHADOW 1
   
 
+// A coarse copy of the model is drawn when its grid cells, the radius
+// divided by LOD_CELLS, are smaller than LOD_PIXELS on the screen.
+#define LOD_CELLS         16
+#define LOD_PIXELS        1.0
+
 /// \todo there should be only one #define. Currently there are two
 ///       (inside and outside the namespace)
 #define INVALID_AIRPLANE_VISUALIZATION -1
@@ -53,6 +61,37 @@ namespace Video
 std::vector<AirplaneVisualization*> AirplaneVisualization::ListOfVisualizations;
 
 
+/**
+ *  Sets the range of the coarse copy of a model from the current
+ *  field of view and window size. The selector's first kid is the
+ *  model itself.
+ *
+ *  \param entity   the range selector
+ *  \param mask     traversal mask
+ *  \return 1 to go on with the traversal
+ */
+static int lod_callback(ssgEntity* entity, int mask)
+{
+  ssgRangeSelector* lod = (ssgRangeSelector*)entity;
+  float             w;
+  float             h;
+
+  ssgGetCurrentContext()->getFOV(&w, &h);
+  if (h > 0 && lod->getNumKids() > 0)
+  {
+    float radius   = lod->getKid(0)->getBSphere()->getRadius();
+    float halftan  = tan(h * SG_DEGREES_TO_RADIANS / 2);
+    float ranges[3];
+
+    ranges[0] = 0;
+    ranges[1] = radius * window_ysize / (2 * LOD_CELLS * LOD_PIXELS * halftan);
+    ranges[2] = SG_MAX;
+    lod->setRanges(ranges, 3);
+  }
+  return 1;
+}
+
+
 #if EXPERIMENTAL_STENCIL_SHADOW == 1
 int shadowPredrawCallback(ssgState*)
 {
@@ -156,49 +195,67 @@ bool makeShadow(ssgEntity *ent)
 
 
 
+/**
+ *  Traversal callback which marks the nodes initAnimations() is going
+ *  to animate, while the coarse copy is made before.
+ */
+static int animatedNodeCallback(ssgEntity*, int)
+{
+  return 1;
+}
+
+
+/**
+ *  Nodes of a model which initAnimations() animates.
+ */
+static void findAnimatedNodes(SimpleXMLTransfer *xml, ssgEntity* model,
+                              std::vector<ssgEntity*>& nodes)
+{
+  if (xml == NULL || xml->indexOfChild("animations") < 0)
+    return;
+
+  SimpleXMLTransfer *animations = xml->getChild("animations");
+  for (int i = 0; i < animations->getChildCount(); i++)
+  {
+    SimpleXMLTransfer *animation = animations->getChildAt(i);
+    if (animation->getName() == "animation" &&
+        animation->getString("type", "default") == "ControlSurface")
+    {
+      std::string node_name = animation->getString("object.name", "default");
+      ssgEntity*  node      = SSGUtil::findNamedNode(model, node_name.c_str());
+      if (node != NULL)
+        nodes.push_back(node);
+    }
+  }
+}
+
+
 AirplaneVisualization::AirplaneVisualization( std::string const& model_name,
                                               std::string const& texture_path,
                                               CRRCMath::Vector3 const& pCG,
                                               SimpleXMLTransfer *xml)
  :  initial_trans(NULL), 
     model_trans(NULL), model(NULL),
-    shadow(NULL), shadow_trans(NULL)
+    shadow(NULL), shadow_trans(NULL),
+    extras(NULL), fOwnExtras(false)
 {
-  ssgTexturePath(texture_path.c_str());
-  // load model
-  model = ssgLoad(model_name.c_str());
+  // Load the model or take it from the cache. The animations are
+  // part of the scenegraph, so the model can only be shared by
+  // visualizations made from the same description file.
+  bool fNew;
+  model = loadModel(model_name, texture_path,
+                    (xml != NULL) ? xml->getSourceDescr() : "", fNew);
 
   if (model != NULL)
   {
-#if (SHADOW_TYPE==SHADOW_VOLUME)
-    shadow = (ssgEntity*)new ShadowVolume(model);
-    scene->addKid(shadow);
-#endif
-    // transform model from SSG coordinates to CRRCsim coordinates
-    initial_trans = new ssgTransform();
-    model_trans = new ssgTransform();
-    scene->addKid(model_trans);
-    model_trans->addKid(initial_trans);
-    initial_trans->addKid(model);
-    
-    sgMat4 it = {  {1.0,  0.0,  0.0,  0},
-                   {0.0,  0.0, -1.0,  0},
-                   {0.0,  1.0,  0.0,  0},
-                   {pCG.r[1],  pCG.r[2],  -pCG.r[0],  1.0} };
-    
-    initial_trans->setTransform(it);
-
-    // add a simple shadow
-#if (SHADOW_TYPE==SHADOW_PROJECTION)
-    shadow = (ssgEntity*)initial_trans->clone(SSG_CLONE_RECURSIVE | SSG_CLONE_GEOMETRY | SSG_CLONE_STATE);
-    makeShadow(shadow);
-    shadow_trans = new ssgTransform();
-    scene->addKid(shadow_trans);
-    shadow_trans->addKid(shadow);
-#endif
-    
-    /// \todo add animations ("real" model only, without shadow)
-    initAnimations(xml, model);
+    extras = getModelExtras(model);
+    if (extras == NULL)
+    {
+      extras     = new ModelExtras();
+      fOwnExtras = true;
+    }
+    build(pCG, xml);
+    attach(xml, fNew);
   }
   else
   {
@@ -210,19 +267,151 @@ AirplaneVisualization::AirplaneVisualization( std::string const& model_name,
     throw std::runtime_error(msg);
   }
 }
+
+
+AirplaneVisualization::AirplaneVisualization( ssgEntity* model,
+                                              CRRCMath::Vector3 const& pCG,
+                                              SimpleXMLTransfer *xml)
+ :  initial_trans(NULL), 
+    model_trans(NULL), model(model),
+    shadow(NULL), shadow_trans(NULL),
+    extras(new ModelExtras()), fOwnExtras(true)
+{
+  model->ref();
+  build(pCG, xml);
+}
+
+
+void AirplaneVisualization::build(CRRCMath::Vector3 const& pCG,
+                                  SimpleXMLTransfer *xml)
+{
+#if (SHADOW_TYPE==SHADOW_VOLUME)
+  shadow = (ssgEntity*)new ShadowVolume(model);
+#endif
+#if (SHADOW_TYPE==SHADOW_MESH)
+  if (extras->shadowMesh == NULL)
+    extras->shadowMesh = ShadowVolume::makeMesh(model);
+  shadow = (ssgEntity*)new ShadowVolume(extras->shadowMesh);
+#endif
+  // transform model from SSG coordinates to CRRCsim coordinates
+  initial_trans = new ssgTransform();
+  model_trans = new ssgTransform();
+  model_trans->addKid(initial_trans);
+
+  // level of detail: the model itself when near, a coarse copy of
+  // it (without animations) when far away. The range depends on the
+  // zoom, it is set before each frame.
+  float radius = model->getBSphere()->getRadius();
+  float ranges[3] = { 0, SG_MAX, SG_MAX };
+  ssgRangeSelector *lod = new ssgRangeSelector();
+  lod->setRanges(ranges, 3);
+  lod->setTravCallback(SSG_CALLBACK_PRETRAV, lod_callback);
+  initial_trans->addKid(lod);
+  lod->addKid(model);
+  
+  sgMat4 it = {  {1.0,  0.0,  0.0,  0},
+                 {0.0,  0.0, -1.0,  0},
+                 {0.0,  1.0,  0.0,  0},
+                 {pCG.r[1],  pCG.r[2],  -pCG.r[0],  1.0} };
+  
+  initial_trans->setTransform(it);
+
+  // add a simple shadow
+#if (SHADOW_TYPE==SHADOW_PROJECTION)
+  shadow = (ssgEntity*)initial_trans->clone(SSG_CLONE_RECURSIVE | SSG_CLONE_GEOMETRY | SSG_CLONE_STATE);
+  makeShadow(shadow);
+  shadow_trans = new ssgTransform();
+  shadow_trans->addKid(shadow);
+#endif
+
+  // the animated parts are left away by the coarse copy; the
+  // animations are added by attach(), so their nodes are marked
+  // for the time being. The first user of a shared model makes it.
+  if (extras->coarse == NULL)
+  {
+    std::vector<ssgEntity*>      animated;
+    std::vector<ssgTravCallback> callbacks;
+    findAnimatedNodes(xml, model, animated);
+    for (unsigned int i = 0; i < animated.size(); i++)
+    {
+      callbacks.push_back(animated[i]->getTravCallback(SSG_CALLBACK_PRETRAV));
+      animated[i]->setTravCallback(SSG_CALLBACK_PRETRAV, animatedNodeCallback);
+    }
+
+    extras->coarse = SSGUtil::makeSimplifiedModel(model, radius / LOD_CELLS);
+    extras->coarse->ref();
+
+    for (unsigned int i = animated.size(); i-- > 0; )
+      animated[i]->setTravCallback(SSG_CALLBACK_PRETRAV, callbacks[i]);
+  }
+
+  ssgEntity* coarse = extras->coarse;
+  lod->addKid(coarse);
+#if (SHADOW_TYPE==SHADOW_PROJECTION)
+  ssgEntity* coarse_shadow = (ssgEntity*)coarse->clone(SSG_CLONE_RECURSIVE | SSG_CLONE_GEOMETRY | SSG_CLONE_STATE);
+  makeShadow(coarse_shadow);
+  ssgRangeSelector* shadow_lod = (ssgRangeSelector*)((ssgBranch*)shadow)->getKid(0);
+  shadow_lod->setTravCallback(SSG_CALLBACK_PRETRAV, lod_callback);
+  shadow_lod->addKid(coarse_shadow);
+#endif
+}
+
+
+void AirplaneVisualization::attach(SimpleXMLTransfer *xml, bool fNew)
+{
+  /// \todo add animations ("real" model only, without shadow)
+  if (fNew)
+  {
+    initAnimations(xml, model);
+  }
+
+#if (SHADOW_TYPE==SHADOW_VOLUME || SHADOW_TYPE==SHADOW_MESH)
+  scene->addKid(shadow);
+#endif
+  scene->addKid(model_trans);
+#if (SHADOW_TYPE==SHADOW_PROJECTION)
+  scene->addKid(shadow_trans);
+#endif
+}
   
+
+/**
+ *  Remove a node from the scenegraph, or delete it if it has never
+ *  been added.
+ */
+static void removeNode(ssgEntity* node)
+{
+  if (node == NULL)
+    return;
+
+  if (node->getNumParents() > 0)
+    node->getParent(0)->removeKid(node);
+  else
+    delete node;
+}
+
+
 AirplaneVisualization::~AirplaneVisualization()
 {
-  ssgBranch *parent = model_trans->getParent(0);
-  parent->removeKid(model_trans);
+  removeNode(model_trans);
 	
 #if (SHADOW_TYPE==SHADOW_PROJECTION)
-  parent->removeKid(shadow_trans);
+  removeNode(shadow_trans);
 #endif
-#if (SHADOW_TYPE==SHADOW_VOLUME)
-  parent->removeKid(shadow);
-  //parent->removeKid(shadow_draw);
+#if (SHADOW_TYPE==SHADOW_VOLUME || SHADOW_TYPE==SHADOW_MESH)
+  removeNode(shadow);
 #endif
+
+  if (fOwnExtras)
+    delete extras;
+  releaseModel(model);
+}
+
+
+StagedVisualization::~StagedVisualization()
+{
+  delete vis;
+  delete staged;
 }
   
 
@@ -278,12 +467,62 @@ void AirplaneVisualization::setPosition(CRRCMath::Vector3 const& pos,
   m[3][1] += .001;//JL
   shadow_trans->setTransform(m);
 #endif
-#if (SHADOW_TYPE==SHADOW_VOLUME)
+#if (SHADOW_TYPE==SHADOW_VOLUME || SHADOW_TYPE==SHADOW_MESH)
   ((ShadowVolume*)shadow)->update(pos.r[0], pos.r[1], pos.r[2], phi, theta, psi);
 #endif
 }
 
 
+/**
+ * Put a visualization into the list of all visualizations
+ */
+long AirplaneVisualization::addToList(AirplaneVisualization* vis)
+{
+  long id = INVALID_AIRPLANE_VISUALIZATION;
+
+  // add the new visualization to the list of all visualizations
+  // first search for an empty entry
+  std::vector<AirplaneVisualization*>::size_type pos;
+  for ( pos = 0;
+        pos < ListOfVisualizations.size();
+        pos++)
+  {
+    if (ListOfVisualizations[pos] == NULL)
+    {
+      ListOfVisualizations[pos] = vis;
+      id = (long)pos;
+      break;
+    }
+  }
+  
+  // if no empty entry was found, just add it to the end of the list
+  if (id == INVALID_AIRPLANE_VISUALIZATION)
+  {
+    ListOfVisualizations.push_back(vis);
+    id = (long)(ListOfVisualizations.size() - 1);
+  }
+
+  return id;
+}
+
+
+/**
+ * Log a new visualization
+ */
+static void log_visualization(std::string const& model_name, long id, Uint32 start)
+{
+  int nModels, nInstances, nTextures;
+  getAssetCacheStats(nModels, nInstances, nTextures);
+
+  std::ostringstream log;
+  log << _("Loaded model ") << model_name << " (ID " << id << ", "
+      << (SDL_GetTicks() - start) << " ms, "
+      << nInstances << " instances of " << nModels << " models, "
+      << nTextures << " textures, " << getResidentMemory() << " kB resident)";
+  LOG(log.str());
+}
+
+
 /**
  * Create a new airplane visualization
  */
@@ -294,36 +533,13 @@ long new_visualization( std::string const& model_name,
 {
   AirplaneVisualization* vis = NULL;
   long id = INVALID_AIRPLANE_VISUALIZATION;
+  Uint32 start = SDL_GetTicks();
   
   try
   {
     vis = new AirplaneVisualization(model_name, texture_path, pCG, xml);
-    
-    // add the new visualization to the list of all visualizations
-    // first search for an empty entry
-    std::vector<AirplaneVisualization*>::size_type pos;
-    for ( pos = 0;
-          pos < AirplaneVisualization::ListOfVisualizations.size();
-          pos++)
-    {
-      if (AirplaneVisualization::ListOfVisualizations[pos] == NULL)
-      {
-        AirplaneVisualization::ListOfVisualizations[pos] = vis;
-        id = (long)pos;
-        break;
-      }
-    }
-    
-    // if no empty entry was found, just add it to the end of the list
-    if (id == INVALID_AIRPLANE_VISUALIZATION)
-    {
-      AirplaneVisualization::ListOfVisualizations.push_back(vis);
-      id = (long)(AirplaneVisualization::ListOfVisualizations.size() - 1);
-    }
-    
-    std::ostringstream log;
-    log << _("Loaded model ") << model_name << " (ID " << id << ")";
-    LOG(log.str());
+    id  = AirplaneVisualization::addToList(vis);
+    log_visualization(model_name, id, start);
   }
   catch (std::runtime_error &e)
   {
@@ -337,6 +553,77 @@ long new_visualization( std::string const& model_name,
 }
 
 
+/**
+ * Load an airplane visualization without using it yet
+ */
+StagedVisualization* stage_visualization(std::string const& model_name,
+                                         std::string const& texture_path,
+                                         CRRCMath::Vector3 const& pCG,
+                                         SimpleXMLTransfer *xml)
+{
+  StagedVisualization* staged = new StagedVisualization();
+
+  staged->model_name   = model_name;
+  staged->texture_path = texture_path;
+  staged->pCG          = pCG;
+  staged->staged       = stageModel(model_name, texture_path);
+  if (staged->staged->fComplete)
+    staged->vis = new AirplaneVisualization(staged->staged->model, pCG, xml);
+
+  return staged;
+}
+
+
+/**
+ * Create a new airplane visualization from a staged one
+ */
+long new_visualization(StagedVisualization* staged,
+                       SimpleXMLTransfer *xml)
+{
+  AirplaneVisualization* vis   = staged->vis;
+  Uint32                 start = SDL_GetTicks();
+
+  if (vis == NULL)
+  {
+    long id = new_visualization(staged->model_name, staged->texture_path, staged->pCG, xml);
+    delete staged;
+    return id;
+  }
+
+  // the coarse copy shares the states of the model
+  staged->staged->commit();
+#if (SHADOW_TYPE==SHADOW_PROJECTION)
+  staged->staged->resolveTextures(vis->shadow_trans);
+#endif
+
+  // shared with the visualizations made later by the name, with
+  // its coarse copy and shadow
+  if (adoptModel(vis->model, staged->model_name, staged->texture_path,
+                 (xml != NULL) ? xml->getSourceDescr() : "", vis->extras))
+    vis->fOwnExtras = false;
+
+  vis->attach(xml, true);
+  staged->vis = NULL;
+
+  long id = AirplaneVisualization::addToList(vis);
+  log_visualization(staged->model_name, id, start);
+  delete staged;
+  return id;
+}
+
+
+void delete_staged_visualization(StagedVisualization* staged)
+{
+  delete staged;
+}
+
+
+void service_staging()
+{
+  serviceStaging();
+}
+
+
 /**
  * Deallocate an airplane visualization
  */
@@ -33,10 +33,14 @@
 #include "../mod_math/vector3.h"
 #include "../mod_misc/SimpleXMLTransfer.h"
 #include "crrc_animation.h"
+#include "asset_stage.h"
 
 namespace Video
 {
 
+class StagedVisualization;
+class ModelExtras;
+
 /**
  * \brief A class to visualize an airplane
  *
@@ -46,12 +50,35 @@ namespace Video
 class AirplaneVisualization
 {
   public:
+    /**
+     *  Loads the model or takes it from the cache and adds it to the
+     *  scenegraph. Main thread only.
+     */
     AirplaneVisualization(std::string const& model_name,
                           std::string const& texture_path,
                           CRRCMath::Vector3 const& pCG,
                           SimpleXMLTransfer *xml);
+
+    /**
+     *  Builds the visualization of a model loaded by the caller: the
+     *  shadow and the coarse copy, without the animations and without
+     *  adding it to the scenegraph, see attach(). Doesn't use OpenGL,
+     *  it may be called on any thread.
+     *
+     *  \param model  it is referenced and given to releaseModel() by
+     *                the destructor
+     */
+    AirplaneVisualization(ssgEntity* model,
+                          CRRCMath::Vector3 const& pCG,
+                          SimpleXMLTransfer *xml);
   
     ~AirplaneVisualization();
+
+    /**
+     *  Adds the animations if fNew and the visualization to the
+     *  scenegraph. Main thread only.
+     */
+    void attach(SimpleXMLTransfer *xml, bool fNew);
   
     void setPosition( CRRCMath::Vector3 const& pos,
                       double phi, double theta, double psi);
@@ -61,6 +88,9 @@ class AirplaneVisualization
                                   CRRCMath::Vector3 const& pCG,
                                   SimpleXMLTransfer *xml);
 
+    friend long new_visualization(StagedVisualization* staged,
+                                  SimpleXMLTransfer *xml);
+
     friend  void set_position(long id,
                               CRRCMath::Vector3 const &pos,
                               double phi,
@@ -70,16 +100,45 @@ class AirplaneVisualization
     friend  void delete_visualization(long id);
     
   private:
+    void build(CRRCMath::Vector3 const& pCG, SimpleXMLTransfer *xml);
+
+    /**
+     *  Put a visualization into the list.
+     *  \return its ID
+     */
+    static long addToList(AirplaneVisualization* vis);
+
     ssgTransform  *initial_trans;
     ssgTransform  *model_trans;
     ssgEntity     *model;
     ssgEntity     *shadow;
     ssgTransform  *shadow_trans;
+    ModelExtras   *extras;       ///< coarse copy and shadow adjacency of the model
+    bool           fOwnExtras;   ///< false if they are shared by the cache
 
     static std::vector<AirplaneVisualization*> ListOfVisualizations;
   
 };
 
+
+/**
+ *  An airplane visualization made by stage_visualization(), which
+ *  new_visualization() hasn't put into use yet. It has to be deleted
+ *  by the main thread.
+ */
+class StagedVisualization
+{
+  public:
+    StagedVisualization() : staged(NULL), vis(NULL) {};
+    ~StagedVisualization();
+
+    std::string            model_name;
+    std::string            texture_path;
+    CRRCMath::Vector3      pCG;
+    StagedModel*           staged;   ///< the model and its textures
+    AirplaneVisualization* vis;      ///< NULL if it has to be loaded by new_visualization()
+};
+
 } // end namespace Video::
 
 #endif // AIRPLANE_VISUALIZATION_H_
@@ -0,0 +1,664 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+/** \file asset_bundle.cpp
+ *
+ *  Precompiled models.
+ *
+ *  Layout of a bundle:
+ *  - the scenegraph as written by ssgSaveSSG(), without textures
+ *  - the image data of all mipmap levels of all textures
+ *  - the directory: texture path, source files, textures with their
+ *    levels, and which leaf uses which texture
+ *  - the trailer (T_BundleTrailer), which locates the directory
+ *
+ *  Saving the scenegraph without its textures keeps SSG from
+ *  loading them through OpenGL when the bundle is read, the
+ *  textures are attached to the leaves afterwards.
+ *
+ *  All numbers are stored in native byte order, a bundle written on
+ *  a machine of the other byte order fails the version check.
+ */
+
+#include "asset_bundle.h"
+#include "asset_cache.h"
+#include "asset_stage.h"
+#include "../mod_misc/filesystools.h"
+
+#include <vector>
+#include <cstdio>
+#include <cstring>
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef WIN32
+# include <windows.h>
+#else
+# include <fcntl.h>
+# include <unistd.h>
+# include <sys/mman.h>
+#endif
+
+
+namespace Video
+{
+
+/// version of the bundle layout, increment on every change
+#define ASSET_BUNDLE_VERSION (3)
+
+/// alignment of the image data
+#define ASSET_BUNDLE_ALIGN   (16)
+
+/// flags of a texture, as handed to ssgLoaderOptions::createTexture()
+#define ASSET_BUNDLE_WRAPU   (1)
+#define ASSET_BUNDLE_WRAPV   (2)
+#define ASSET_BUNDLE_MIPMAP  (4)
+
+static const char bundleMagic[8] = { 'C', 'R', 'R', 'C', 'B', 'N', 'D', 'L' };
+
+
+/**
+ *  The end of a bundle file.
+ */
+typedef struct
+{
+  char     magic[8];    ///< bundleMagic
+  uint32_t version;     ///< ASSET_BUNDLE_VERSION
+  uint32_t dirOffset;   ///< position of the directory in the file
+  uint32_t dirSize;     ///< size of the directory
+} T_BundleTrailer;
+
+
+/**
+ *  A file a bundle has been made from.
+ */
+typedef struct
+{
+  std::string path;
+  int64_t     size;
+  int64_t     mtime;
+} T_BundleSource;
+
+
+/**
+ *  One mipmap level of a texture. The image data is stored without
+ *  padding between rows.
+ */
+typedef struct
+{
+  uint32_t width;
+  uint32_t height;
+  uint32_t offset;      ///< position of the image data in the file
+} T_BundleLevel;
+
+
+/**
+ *  A texture of a bundle.
+ */
+typedef struct
+{
+  std::string                source;   ///< image file it has been decoded from
+  uint32_t                   depth;    ///< bytes per pixel, 1 ... 4
+  uint32_t                   flags;    ///< ASSET_BUNDLE_WRAPU etc.
+  std::vector<T_BundleLevel> level;    ///< level 0 is the largest one
+} T_BundleTexture;
+
+
+/**
+ *  A leaf using a texture.
+ */
+typedef struct
+{
+  uint32_t leaf;        ///< number of the leaf, depth first
+  uint32_t texture;     ///< number of the texture in the directory
+} T_BundleBinding;
+
+
+/**
+ *  A read-only file in memory, mapped if the OS supports it.
+ */
+class T_MappedFile
+{
+  public:
+    T_MappedFile(std::string const& filename);
+    ~T_MappedFile();
+
+    const unsigned char* data;   ///< NULL if the file couldn't be read
+    size_t               size;
+
+  private:
+#ifdef WIN32
+    std::vector<unsigned char> buffer;
+#endif
+};
+
+
+T_MappedFile::T_MappedFile(std::string const& filename)
+  : data(NULL), size(0)
+{
+#ifdef WIN32
+  FILE* fp = fopen(filename.c_str(), "rb");
+  if (fp != NULL)
+  {
+    if (fseek(fp, 0, SEEK_END) == 0)
+    {
+      long len = ftell(fp);
+      if (len > 0 && fseek(fp, 0, SEEK_SET) == 0)
+      {
+        buffer.resize(len);
+        if (fread(&buffer[0], 1, len, fp) == (size_t)len)
+        {
+          data = &buffer[0];
+          size = len;
+        }
+      }
+    }
+    fclose(fp);
+  }
+#else
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd >= 0)
+  {
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+    {
+      void* p = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (p != MAP_FAILED)
+      {
+        data = (const unsigned char*)p;
+        size = st.st_size;
+      }
+    }
+    close(fd);
+  }
+#endif
+}
+
+
+T_MappedFile::~T_MappedFile()
+{
+#ifndef WIN32
+  if (data != NULL)
+    munmap((void*)data, size);
+#endif
+}
+
+
+/**
+ *  Reads the directory of a bundle. Reading beyond the end makes
+ *  fOK false and returns zeros.
+ */
+class T_DirReader
+{
+  public:
+    T_DirReader(const unsigned char* begin, size_t len)
+      : p(begin), end(begin + len), fOK(true)
+    {
+    }
+
+    uint32_t getU32()
+    {
+      uint32_t val = 0;
+      get(&val, sizeof(val));
+      return val;
+    }
+
+    int64_t getI64()
+    {
+      int64_t val = 0;
+      get(&val, sizeof(val));
+      return val;
+    }
+
+    std::string getString()
+    {
+      uint32_t len = getU32();
+      if (!fOK || len > (size_t)(end - p))
+      {
+        fOK = false;
+        return "";
+      }
+      std::string s((const char*)p, len);
+      p += len;
+      return s;
+    }
+
+    const unsigned char* p;
+    const unsigned char* end;
+    bool                 fOK;
+
+  private:
+    void get(void* dest, size_t len)
+    {
+      if (fOK && len <= (size_t)(end - p))
+      {
+        memcpy(dest, p, len);
+        p += len;
+      }
+      else
+      {
+        fOK = false;
+      }
+    }
+};
+
+
+static void putU32(std::string& buf, uint32_t val)
+{
+  buf.append((const char*)&val, sizeof(val));
+}
+
+static void putI64(std::string& buf, int64_t val)
+{
+  buf.append((const char*)&val, sizeof(val));
+}
+
+static void putString(std::string& buf, std::string const& s)
+{
+  putU32(buf, s.length());
+  buf.append(s);
+}
+
+
+/**
+ *  File name of the bundle of a model.
+ */
+static std::string bundleFilename(std::string const& model_name)
+{
+  std::string home = FileSysTools::getHomePath();
+  if (home == "")
+    return "";
+
+  std::string name = canonicalPath(model_name);
+  for (std::string::size_type i = 0; i < name.length(); i++)
+  {
+    if (name[i] == '/' || name[i] == '\\' || name[i] == ':')
+      name[i] = '_';
+  }
+  return home + "/bundles/" + name + ".bundle";
+}
+
+
+/**
+ *  Size and time of modification of a file.
+ *  \return false if the file doesn't exist
+ */
+static bool getSourceInfo(std::string const& path, T_BundleSource& src)
+{
+  struct stat st;
+
+  if (stat(path.c_str(), &st) != 0)
+    return false;
+
+  src.path  = path;
+  src.size  = st.st_size;
+  src.mtime = st.st_mtime;
+  return true;
+}
+
+
+/**
+ *  All leaves below ent, depth first.
+ */
+static void findLeaves(ssgEntity* ent, std::vector<ssgLeaf*>& list)
+{
+  if (ent->isAKindOf(ssgTypeLeaf()))
+  {
+    list.push_back((ssgLeaf*)ent);
+  }
+  else if (ent->isAKindOf(ssgTypeBranch()))
+  {
+    ssgBranch* branch = (ssgBranch*)ent;
+    for (int i = 0; i < branch->getNumKids(); i++)
+      findLeaves(branch->getKid(i), list);
+  }
+}
+
+
+/**
+ *  The state of a leaf if it can have a texture, NULL otherwise.
+ */
+static ssgSimpleState* getSimpleState(ssgLeaf* leaf)
+{
+  if (leaf->hasState() && leaf->getState()->isAKindOf(ssgTypeSimpleState()))
+    return (ssgSimpleState*)leaf->getState();
+  return NULL;
+}
+
+
+/**
+ *  Checks the trailer, the texture path and the source files of a
+ *  bundle.
+ *  \param dir  set to the directory, positioned behind the sources
+ *  \return false if the bundle can't be used
+ */
+static bool openDirectory(T_MappedFile const& file, std::string const& texture_path,
+                          T_BundleTrailer& trailer, T_DirReader& dir)
+{
+  if (file.data == NULL || file.size < sizeof(T_BundleTrailer))
+    return false;
+
+  memcpy(&trailer, file.data + file.size - sizeof(trailer), sizeof(trailer));
+  if (memcmp(trailer.magic, bundleMagic, sizeof(bundleMagic)) != 0 ||
+      trailer.version != ASSET_BUNDLE_VERSION ||
+      trailer.dirOffset > file.size - sizeof(trailer) ||
+      trailer.dirSize   > file.size - sizeof(trailer) - trailer.dirOffset)
+    return false;
+
+  dir = T_DirReader(file.data + trailer.dirOffset, trailer.dirSize);
+
+  // the textures are looked up in a different directory
+  if (dir.getString() != canonicalPath(texture_path))
+    return false;
+
+  // stale?
+  uint32_t nSources = dir.getU32();
+  for (uint32_t i = 0; i < nSources && dir.fOK; i++)
+  {
+    T_BundleSource src;
+    T_BundleSource now;
+    src.path  = dir.getString();
+    src.size  = dir.getI64();
+    src.mtime = dir.getI64();
+    if (!getSourceInfo(src.path, now) || now.size != src.size || now.mtime != src.mtime)
+      return false;
+  }
+  return dir.fOK;
+}
+
+
+bool loadBundle(std::string const& model_name,
+                std::string const& texture_path,
+                StagedModel*       staged)
+{
+  std::string filename = bundleFilename(model_name);
+  if (filename == "")
+    return false;
+
+  T_MappedFile    file(filename);
+  T_BundleTrailer trailer;
+  T_DirReader     dir(NULL, 0);
+  if (!openDirectory(file, texture_path, trailer, dir))
+    return false;
+
+  std::vector<T_BundleTexture> textures;
+  uint32_t nTextures = dir.getU32();
+  for (uint32_t i = 0; i < nTextures && dir.fOK; i++)
+  {
+    T_BundleTexture bt;
+    bt.source = dir.getString();
+    bt.depth  = dir.getU32();
+    bt.flags  = dir.getU32();
+
+    uint32_t nLevels = dir.getU32();
+    for (uint32_t n = 0; n < nLevels && dir.fOK; n++)
+    {
+      T_BundleLevel level;
+      level.width  = dir.getU32();
+      level.height = dir.getU32();
+      level.offset = dir.getU32();
+      if (bt.depth < 1 || bt.depth > 4 || level.width == 0 || level.height == 0 ||
+          level.offset > trailer.dirOffset ||
+          (uint64_t)level.width * level.height * bt.depth > trailer.dirOffset - level.offset)
+        dir.fOK = false;
+      bt.level.push_back(level);
+    }
+    if (nLevels == 0)
+      dir.fOK = false;
+    textures.push_back(bt);
+  }
+
+  std::vector<T_BundleBinding> bindings;
+  uint32_t nBindings = dir.getU32();
+  for (uint32_t i = 0; i < nBindings && dir.fOK; i++)
+  {
+    T_BundleBinding b;
+    b.leaf    = dir.getU32();
+    b.texture = dir.getU32();
+    if (b.texture >= textures.size())
+      dir.fOK = false;
+    bindings.push_back(b);
+  }
+  if (!dir.fOK)
+    return false;
+
+  lockLoader();
+  ssgEntity* model = ssgLoadSSG(filename.c_str());
+  unlockLoader();
+  if (model == NULL)
+    return false;
+  model->ref();
+
+  // it has no textures yet, so it may be deleted here
+  std::vector<ssgLeaf*> leaves;
+  findLeaves(model, leaves);
+  for (unsigned int i = 0; i < bindings.size(); i++)
+  {
+    if (bindings[i].leaf >= leaves.size() || getSimpleState(leaves[bindings[i].leaf]) == NULL)
+    {
+      ssgDeRefDelete(model);
+      return false;
+    }
+  }
+
+  for (unsigned int i = 0; i < textures.size(); i++)
+  {
+    T_BundleTexture const& bt = textures[i];
+    TextureImage           img;
+
+    img.depth = bt.depth;
+    img.level.resize(bt.level.size());
+    for (unsigned int n = 0; n < bt.level.size(); n++)
+    {
+      const unsigned char* data = file.data + bt.level[n].offset;
+      img.level[n].width  = bt.level[n].width;
+      img.level[n].height = bt.level[n].height;
+      img.level[n].data.assign(data, data + (size_t)bt.level[n].width * bt.level[n].height * bt.depth);
+    }
+
+    StagedTexture* tex = makeStagedTexture(bt.source, img.hasAlpha());
+    tex->setImage(img,
+                  (bt.flags & ASSET_BUNDLE_WRAPU)  != 0,
+                  (bt.flags & ASSET_BUNDLE_WRAPV)  != 0,
+                  (bt.flags & ASSET_BUNDLE_MIPMAP) != 0);
+    staged->add(tex);
+  }
+
+  for (unsigned int i = 0; i < bindings.size(); i++)
+    getSimpleState(leaves[bindings[i].leaf])->setTexture(staged->textures[bindings[i].texture]);
+
+  staged->model       = model;
+  staged->fFromBundle = true;
+  return true;
+}
+
+
+bool compileBundle(std::string const& model_name,
+                   std::string const& texture_path,
+                   StagedModel*       staged)
+{
+  std::string filename = bundleFilename(model_name);
+  if (filename == "" || staged->model == NULL || !staged->fComplete)
+    return false;
+
+  std::vector<T_BundleSource>  sources;
+  std::vector<T_BundleTexture> textures;
+  std::vector<T_BundleBinding> bindings;
+  std::string                  imagedata;
+  T_BundleSource               src;
+
+  if (!getSourceInfo(canonicalPath(model_name), src))
+    return false;
+  sources.push_back(src);
+
+  for (unsigned int i = 0; i < staged->textures.size(); i++)
+  {
+    StagedTexture const* tex = staged->textures[i];
+    T_BundleTexture      bt;
+
+    // committed textures have dropped their image
+    if (tex->image.level.size() == 0 || !getSourceInfo(tex->source, src))
+      return false;
+    sources.push_back(src);
+
+    bt.source = tex->source;
+    bt.depth  = tex->image.depth;
+    bt.flags  = 0;
+    if (tex->fWrapU)
+      bt.flags |= ASSET_BUNDLE_WRAPU;
+    if (tex->fWrapV)
+      bt.flags |= ASSET_BUNDLE_WRAPV;
+    if (tex->fMipmap)
+      bt.flags |= ASSET_BUNDLE_MIPMAP;
+
+    for (unsigned int n = 0; n < tex->image.level.size(); n++)
+    {
+      TextureImage::T_Level const& l = tex->image.level[n];
+      T_BundleLevel                level;
+
+      level.width  = l.width;
+      level.height = l.height;
+      level.offset = imagedata.size();    // relative to the image data for now
+      imagedata.append((const char*)&l.data[0], l.data.size());
+      bt.level.push_back(level);
+    }
+    textures.push_back(bt);
+  }
+
+  // detach the textures while the scenegraph is saved
+  std::vector<ssgLeaf*>        leaves;
+  std::vector<ssgSimpleState*> states;
+  std::vector<ssgTexture*>     detached;
+  findLeaves(staged->model, leaves);
+  for (unsigned int n = 0; n < leaves.size(); n++)
+  {
+    ssgSimpleState* state = getSimpleState(leaves[n]);
+    if (state == NULL || state->getTexture() == NULL)
+      continue;
+
+    ssgTexture* tex = state->getTexture();
+    for (unsigned int i = 0; i < staged->textures.size(); i++)
+    {
+      if (tex == staged->textures[i])
+      {
+        T_BundleBinding b;
+        b.leaf    = n;
+        b.texture = i;
+        bindings.push_back(b);
+        break;
+      }
+    }
+    states.push_back(state);
+    detached.push_back(tex);
+  }
+  for (unsigned int i = 0; i < states.size(); i++)
+    states[i]->setTexture(NULL);
+
+  FileSysTools::makeSurePathExists(FileSysTools::getHomePath() + "/bundles");
+  std::string tmpname = filename + ".tmp";
+
+  lockLoader();
+  int fSaved = ssgSaveSSG(tmpname.c_str(), staged->model);
+  unlockLoader();
+
+  for (unsigned int i = 0; i < states.size(); i++)
+    states[i]->setTexture(detached[i]);
+
+  // every texture of the model has to be a staged one
+  if (bindings.size() != states.size())
+    fSaved = FALSE;
+
+  FILE* fp = NULL;
+  if (fSaved)
+    fp = fopen(tmpname.c_str(), "ab");
+  if (fp == NULL)
+  {
+    remove(tmpname.c_str());
+    return false;
+  }
+
+  fseek(fp, 0, SEEK_END);
+  long pos = ftell(fp);
+  while (pos % ASSET_BUNDLE_ALIGN)
+  {
+    fputc(0, fp);
+    pos++;
+  }
+
+  std::string directory;
+  putString(directory, canonicalPath(texture_path));
+  putU32(directory, sources.size());
+  for (unsigned int i = 0; i < sources.size(); i++)
+  {
+    putString(directory, sources[i].path);
+    putI64(directory, sources[i].size);
+    putI64(directory, sources[i].mtime);
+  }
+  putU32(directory, textures.size());
+  for (unsigned int i = 0; i < textures.size(); i++)
+  {
+    putString(directory, textures[i].source);
+    putU32(directory, textures[i].depth);
+    putU32(directory, textures[i].flags);
+    putU32(directory, textures[i].level.size());
+    for (unsigned int n = 0; n < textures[i].level.size(); n++)
+    {
+      putU32(directory, textures[i].level[n].width);
+      putU32(directory, textures[i].level[n].height);
+      putU32(directory, textures[i].level[n].offset + pos);
+    }
+  }
+  putU32(directory, bindings.size());
+  for (unsigned int i = 0; i < bindings.size(); i++)
+  {
+    putU32(directory, bindings[i].leaf);
+    putU32(directory, bindings[i].texture);
+  }
+
+  T_BundleTrailer trailer;
+  memcpy(trailer.magic, bundleMagic, sizeof(bundleMagic));
+  trailer.version   = ASSET_BUNDLE_VERSION;
+  trailer.dirOffset = pos + imagedata.size();
+  trailer.dirSize   = directory.size();
+
+  bool fOK = (fwrite(imagedata.data(), 1, imagedata.size(), fp) == imagedata.size() &&
+              fwrite(directory.data(), 1, directory.size(), fp) == directory.size() &&
+              fwrite(&trailer, sizeof(trailer), 1, fp) == 1);
+  fOK = (fclose(fp) == 0) && fOK;
+
+  // replace an existing bundle only by a complete one, in one step
+  // so there is always a bundle for others to read
+  if (fOK)
+  {
+#ifdef WIN32
+    fOK = (MoveFileExA(tmpname.c_str(), filename.c_str(), MOVEFILE_REPLACE_EXISTING) != 0);
+#else
+    fOK = (rename(tmpname.c_str(), filename.c_str()) == 0);
+#endif
+  }
+  if (!fOK)
+    remove(tmpname.c_str());
+
+  return fOK;
+}
+
+} // end namespace Video::
@@ -0,0 +1,77 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+/** \file asset_bundle.h
+ *
+ *  Precompiled models.
+ *
+ *  Loading a model from its source files means parsing the geometry
+ *  text and decoding every texture, scaling it and building its
+ *  mipmaps. A bundle is a single file holding the result of all this:
+ *  the scenegraph in the binary format of SSG, followed by the
+ *  decoded texture images of all mipmap levels.
+ *
+ *  Bundles live in the bundles directory below
+ *  FileSysTools::getHomePath(). A bundle knows the size and time of
+ *  modification of all files it has been made from, it is ignored
+ *  if any of them has changed.
+ *
+ *  Neither function uses OpenGL, they may be called on any thread,
+ *  see asset_stage.h.
+ */
+
+#ifndef ASSET_BUNDLE_H_
+#define ASSET_BUNDLE_H_
+
+#include <string>
+
+namespace Video
+{
+
+class StagedModel;
+
+/**
+ *  Load a model from its bundle: the scenegraph, and the texture
+ *  images into StagedTextures.
+ *
+ *  \param model_name    file name of the model source
+ *  \param texture_path  directory of the textures
+ *  \param staged        gets the model and its textures
+ *  \return false if there is no bundle or it is stale
+ */
+bool loadBundle(std::string const& model_name,
+                std::string const& texture_path,
+                StagedModel*       staged);
+
+/**
+ *  Write the bundle of a model which has just been loaded from its
+ *  source files, before its textures are committed: the images are
+ *  taken from the StagedTextures.
+ *
+ *  \return true if the bundle has been written
+ */
+bool compileBundle(std::string const& model_name,
+                   std::string const& texture_path,
+                   StagedModel*       staged);
+
+} // end namespace Video::
+
+#endif // ASSET_BUNDLE_H_
@@ -0,0 +1,438 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+/**
+ * \file asset_bundle_test.cpp
+ *
+ * Checks models staged from their source files and from their bundles:
+ * their textures have to be shared through the texture cache and the
+ * images decoded off the main thread have to be the ones SSG makes.
+ *
+ * Usage: asset_bundle_test -d dir texture_dir file.ac [file.ac ...]
+ *
+ * The bundles are written below dir, which is used as the home
+ * directory; bundles of earlier runs are removed first. An OpenGL
+ * context is made with EGL, the test is skipped if there is none.
+ *
+ * - all models are staged from their source, which writes the bundles;
+ *   every mipmap level of their textures is compared to the texture
+ *   SSG loads from the same file
+ * - all models are staged from their bundles: every texture has to be
+ *   the very one the source model uses, with the same name
+ * - everything is dropped, the models are staged from their bundles
+ *   by another thread and committed by this one, then staged from
+ *   their bundles again: the textures have to be shared
+ *
+ * The time taken by the loads is printed. The return value is the
+ * number of errors.
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <dirent.h>
+#include <SDL.h>
+#include <SDL_thread.h>
+
+#include "asset_cache.h"
+#include "asset_stage.h"
+#include "offscreen.h"
+#include "../mod_misc/filesystools.h"
+#include "../mod_misc/SimpleXMLTransfer.h"
+#include "../mod_misc/scheduler.h"
+
+
+/**
+ * A model staged by another thread.
+ */
+typedef struct
+{
+  std::string         filename;
+  std::string         texture_path;
+  SDL_mutex*          mutex;
+  Video::StagedModel* staged;    ///< set by stageThread() when done
+} T_StageJob;
+
+
+/// offscreen.cpp reads its configuration from here, the simulation
+/// sets it up in config.cpp
+SimpleXMLTransfer* cfgfile = NULL;
+
+
+/**
+ * Collects the textures of all leaves below ent.
+ */
+static void findTextures(ssgEntity* ent, std::vector<ssgTexture*>& list)
+{
+  if (ent->isAKindOf(ssgTypeLeaf()))
+  {
+    ssgLeaf* leaf = (ssgLeaf*)ent;
+    if (leaf->hasState() && leaf->getState()->isAKindOf(ssgTypeSimpleState()))
+    {
+      ssgTexture* tex = ((ssgSimpleState*)leaf->getState())->getTexture();
+      if (tex != NULL)
+        list.push_back(tex);
+    }
+  }
+  else if (ent->isAKindOf(ssgTypeBranch()))
+  {
+    ssgBranch* branch = (ssgBranch*)ent;
+    for (int i = 0; i < branch->getNumKids(); i++)
+      findTextures(branch->getKid(i), list);
+  }
+}
+
+
+/**
+ * Compares the textures of two loads of the same model, leaf by leaf.
+ * \return number of textures which differ
+ */
+static int compareTextures(const char* filename, const char* what,
+                           ssgEntity* expected, ssgEntity* model)
+{
+  std::vector<ssgTexture*> a;
+  std::vector<ssgTexture*> b;
+  findTextures(expected, a);
+  findTextures(model, b);
+
+  if (a.size() != b.size())
+  {
+    printf("%s: %s has %d textured leaves instead of %d\n",
+           filename, what, (int)b.size(), (int)a.size());
+    return 1;
+  }
+
+  int nErrors = 0;
+  for (unsigned int i = 0; i < a.size(); i++)
+  {
+    const char* na = a[i]->getFilename();
+    const char* nb = b[i]->getFilename();
+    if (a[i] != b[i] || na == NULL || nb == NULL || strcmp(na, nb) != 0)
+    {
+      printf("%s: %s doesn't share texture %s (%s)\n", filename, what,
+             (na != NULL) ? na : "?", (nb != NULL) ? nb : "?");
+      nErrors++;
+    }
+  }
+  return nErrors;
+}
+
+
+/**
+ * Reads back all mipmap levels of a texture as RGBA.
+ */
+static void readTexture(ssgTexture* tex, std::vector< std::vector<unsigned char> >& levels)
+{
+  glBindTexture(GL_TEXTURE_2D, tex->getHandle());
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+  for (int lev = 0; lev < 16; lev++)
+  {
+    GLint w = 0;
+    GLint h = 0;
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, lev, GL_TEXTURE_WIDTH,  &w);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, lev, GL_TEXTURE_HEIGHT, &h);
+    if (w == 0 || h == 0)
+      break;
+
+    levels.push_back(std::vector<unsigned char>((size_t)w * h * 4));
+    glGetTexImage(GL_TEXTURE_2D, lev, GL_RGBA, GL_UNSIGNED_BYTE, &levels.back()[0]);
+  }
+  glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+
+/**
+ * Compares the textures of a model to the ones SSG loads from the
+ * same files.
+ * \return number of textures which differ
+ */
+static int compareImages(const char* filename, ssgEntity* model)
+{
+  std::vector<ssgTexture*> list;
+  std::vector<ssgTexture*> done;
+  findTextures(model, list);
+
+  int nErrors = 0;
+  for (unsigned int i = 0; i < list.size(); i++)
+  {
+    bool fDone = false;
+    for (unsigned int j = 0; j < done.size(); j++)
+      fDone = fDone || (done[j] == list[i]);
+    if (fDone)
+      continue;
+    done.push_back(list[i]);
+
+    ssgTexture* expected = new ssgTexture(list[i]->getFilename());
+    std::vector< std::vector<unsigned char> > a;
+    std::vector< std::vector<unsigned char> > b;
+    readTexture(expected, a);
+    readTexture(list[i], b);
+    delete expected;
+
+    if (a.size() == 0 || a != b)
+    {
+      printf("%s: texture %s differs from the one of SSG\n", filename,
+             list[i]->getFilename());
+      nErrors++;
+    }
+  }
+  return nErrors;
+}
+
+
+/**
+ * Commits a staged model and takes it over.
+ */
+static ssgEntity* takeModel(Video::StagedModel* staged)
+{
+  ssgEntity* model = NULL;
+  if (staged->fComplete)
+  {
+    staged->commit();
+    model = staged->model;
+    model->ref();
+  }
+  delete staged;
+  return model;
+}
+
+
+/**
+ * Stages a model on this thread and commits it.
+ */
+static ssgEntity* loadStaged(std::string const& filename, std::string const& texture_path,
+                             bool& fFromBundle)
+{
+  Video::StagedModel* staged = Video::stageModel(filename, texture_path);
+  fFromBundle = staged->fFromBundle;
+  return takeModel(staged);
+}
+
+
+static int stageThread(void* data)
+{
+  T_StageJob*         job    = (T_StageJob*)data;
+  Video::StagedModel* staged = Video::stageModel(job->filename, job->texture_path);
+
+  SDL_LockMutex(job->mutex);
+  job->staged = staged;
+  SDL_UnlockMutex(job->mutex);
+  return 0;
+}
+
+
+/**
+ * Stages a model on another thread, serving it meanwhile.
+ */
+static Video::StagedModel* stageOnThread(std::string const& filename,
+                                         std::string const& texture_path)
+{
+  T_StageJob job;
+  job.filename     = filename;
+  job.texture_path = texture_path;
+  job.mutex        = SDL_CreateMutex();
+  job.staged       = NULL;
+
+  SDL_Thread* thread = SDL_CreateThread(stageThread, &job);
+  bool        fDone  = false;
+  while (!fDone)
+  {
+    Video::serviceStaging();
+    SDL_LockMutex(job.mutex);
+    fDone = (job.staged != NULL);
+    SDL_UnlockMutex(job.mutex);
+    if (!fDone)
+      SDL_Delay(1);
+  }
+  SDL_WaitThread(thread, NULL);
+  SDL_DestroyMutex(job.mutex);
+  return job.staged;
+}
+
+
+/**
+ * Removes the bundles of earlier runs, so the first load is a cold one.
+ */
+static void removeBundles(std::string const& bundledir)
+{
+  DIR* d = opendir(bundledir.c_str());
+  if (d == NULL)
+    return;
+
+  struct dirent* entry;
+  while ((entry = readdir(d)) != NULL)
+  {
+    std::string name = entry->d_name;
+    if (name.length() > 7 && name.substr(name.length() - 7) == ".bundle")
+      remove((bundledir + "/" + name).c_str());
+  }
+  closedir(d);
+}
+
+
+static void dropAll(std::vector<ssgEntity*>& models)
+{
+  for (unsigned int i = 0; i < models.size(); i++)
+    ssgDeRefDelete(models[i]);
+  models.clear();
+  Video::purgeAssetCache();
+}
+
+
+int main(int argc, char** argv)
+{
+  std::string              dir = ".";
+  std::string              texture_path;
+  std::vector<std::string> files;
+
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "-d") == 0 && i+1 < argc)
+      dir = argv[++i];
+    else if (texture_path == "")
+      texture_path = argv[i];
+    else
+      files.push_back(argv[i]);
+  }
+  if (files.size() == 0)
+  {
+    printf("Usage: asset_bundle_test -d dir texture_dir file.ac [file.ac ...]\n");
+    return 1;
+  }
+
+  if (!Video::createOffscreenContext(16, 16))
+  {
+    printf("No OpenGL context, skipped\n");
+    return 0;
+  }
+
+  // the bundles are written below the home directory
+  setenv("HOME", dir.c_str(), 1);
+  FileSysTools::SetAppname("crrcsim");
+  removeBundles(FileSysTools::getHomePath() + "/bundles");
+  ssgInit();
+  Video::initStaging();
+
+  std::vector<ssgEntity*> sources;
+  std::vector<ssgEntity*> bundles;
+  int                     nErrors = 0;
+  bool                    fFromBundle;
+  double                  t0;
+  double                  dSource;
+  double                  dBundle;
+  double                  dCommit;
+
+  // cold: from the source, writing the bundles
+  t0 = Scheduler::getSeconds();
+  for (unsigned int i = 0; i < files.size(); i++)
+  {
+    ssgEntity* model = loadStaged(files[i], texture_path, fFromBundle);
+    if (model == NULL)
+    {
+      printf("%s: can't be staged\n", files[i].c_str());
+      return 1;
+    }
+    if (fFromBundle)
+    {
+      printf("%s: loaded from a bundle of an earlier run\n", files[i].c_str());
+      nErrors++;
+    }
+    sources.push_back(model);
+  }
+  dSource = Scheduler::getSeconds() - t0;
+
+  for (unsigned int i = 0; i < files.size(); i++)
+    nErrors += compareImages(files[i].c_str(), sources[i]);
+
+  t0 = Scheduler::getSeconds();
+  for (unsigned int i = 0; i < files.size(); i++)
+  {
+    ssgEntity* model = loadStaged(files[i], texture_path, fFromBundle);
+    bundles.push_back(fFromBundle ? model : NULL);
+    if (!fFromBundle && model != NULL)
+      ssgDeRefDelete(model);
+  }
+  dBundle = Scheduler::getSeconds() - t0;
+
+  for (unsigned int i = 0; i < files.size(); i++)
+  {
+    if (bundles[i] == NULL)
+    {
+      printf("%s: no bundle\n", files[i].c_str());
+      nErrors++;
+    }
+    else
+    {
+      nErrors += compareTextures(files[i].c_str(), "bundle after source",
+                                 sources[i], bundles[i]);
+    }
+  }
+  printf("Load from source:  %7.1f ms\n", 1e3 * dSource);
+  printf("Load from bundle:  %7.1f ms with the textures in the cache\n", 1e3 * dBundle);
+
+  // staged by another thread, with an empty cache
+  dropAll(sources);
+  dropAll(bundles);
+
+  dBundle = 0;
+  dCommit = 0;
+  for (unsigned int i = 0; i < files.size(); i++)
+  {
+    t0 = Scheduler::getSeconds();
+    Video::StagedModel* staged = stageOnThread(files[i], texture_path);
+    dBundle += Scheduler::getSeconds() - t0;
+
+    if (!staged->fFromBundle)
+    {
+      printf("%s: not staged from its bundle\n", files[i].c_str());
+      nErrors++;
+    }
+    t0 = Scheduler::getSeconds();
+    bundles.push_back(takeModel(staged));
+    dCommit += Scheduler::getSeconds() - t0;
+  }
+
+  for (unsigned int i = 0; i < files.size(); i++)
+    sources.push_back(loadStaged(files[i], texture_path, fFromBundle));
+
+  for (unsigned int i = 0; i < files.size(); i++)
+  {
+    if (bundles[i] == NULL || sources[i] == NULL)
+    {
+      printf("%s: can't be loaded\n", files[i].c_str());
+      nErrors++;
+    }
+    else
+    {
+      nErrors += compareTextures(files[i].c_str(), "bundle after thread",
+                                 bundles[i], sources[i]);
+    }
+  }
+  printf("Stage from bundle: %7.1f ms on a thread with an empty cache\n", 1e3 * dBundle);
+  printf("Commit:            %7.1f ms on this thread\n", 1e3 * dCommit);
+
+  dropAll(sources);
+  dropAll(bundles);
+
+  printf("%d errors\n", nErrors);
+  return nErrors;
+}
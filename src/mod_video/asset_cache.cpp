@@ -0,0 +1,402 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+/** \file asset_cache.cpp
+ *
+ *  A cache for 3D models and textures.
+ */
+
+#include "asset_cache.h"
+#include "asset_stage.h"
+#include "shadow_mesh.h"
+
+#include <map>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <climits>
+
+#ifdef WIN32
+# include <stdlib.h>
+#else
+# include <unistd.h>
+#endif
+
+
+namespace Video
+{
+
+/// number of unused models which are kept in the cache
+#define ASSET_CACHE_UNUSED_MODELS (8)
+
+
+/**
+ *  Loader options which take textures from the cache.
+ */
+class CachedLoaderOptions : public ssgLoaderOptions
+{
+  public:
+    ssgTexture* createTexture(char* tfname, int wrapu = TRUE, int wrapv = TRUE,
+                              int mipmap = TRUE);
+};
+
+
+/**
+ *  A model in the cache
+ */
+typedef struct
+{
+  std::string   key;      ///< canonical file names and variant
+  ssgEntity*    model;    ///< the scenegraph, referenced by the cache
+  ModelExtras*  extras;   ///< made from the model by its first user
+  int           nUsers;   ///< number of loadModel() calls not released yet
+  unsigned long lastUse;  ///< value of useCounter when last used
+} T_CachedModel;
+
+
+static std::map<std::string, ssgTexture*> textures;   ///< referenced by the cache
+static std::vector<T_CachedModel>         models;
+static CachedLoaderOptions*               options    = NULL;
+static unsigned long                      useCounter = 0;
+
+
+ModelExtras::~ModelExtras()
+{
+  if (coarse != NULL)
+    ssgDeRefDelete(coarse);
+  delete shadowMesh;
+}
+
+
+std::string canonicalPath(std::string const& path)
+{
+#ifdef WIN32
+  char buf[_MAX_PATH];
+  if (_fullpath(buf, path.c_str(), _MAX_PATH) != NULL)
+    return std::string(buf);
+#else
+  char buf[PATH_MAX];
+  if (realpath(path.c_str(), buf) != NULL)
+    return std::string(buf);
+#endif
+  return path;
+}
+
+
+/**
+ *  Key of a texture in the cache
+ */
+static std::string textureKey(std::string const& source, int wrapu, int wrapv, int mipmap)
+{
+  std::string key = source;
+  key += wrapu  ? "|u" : "|-";
+  key += wrapv  ? "v"  : "-";
+  key += mipmap ? "m"  : "-";
+  return key;
+}
+
+
+ssgTexture* CachedLoaderOptions::createTexture(char* tfname, int wrapu, int wrapv,
+                                               int mipmap)
+{
+  char filename[1024];
+  makeTexturePath(filename, tfname);
+
+  std::string source = canonicalPath(filename);
+  ssgTexture* tex    = findTexture(source, wrapu, wrapv, mipmap);
+  if (tex != NULL)
+  {
+    return tex;
+  }
+
+  tex = new ssgTexture(filename, wrapu, wrapv, mipmap);
+  addTexture(tex, source, wrapu, wrapv, mipmap);
+  return tex;
+}
+
+
+ssgTexture* findTexture(std::string const& source, int wrapu, int wrapv, int mipmap)
+{
+  std::map<std::string, ssgTexture*>::iterator it =
+    textures.find(textureKey(source, wrapu, wrapv, mipmap));
+
+  return (it != textures.end()) ? it->second : NULL;
+}
+
+
+void addTexture(ssgTexture* tex, std::string const& source,
+                int wrapu, int wrapv, int mipmap)
+{
+  tex->ref();
+  textures[textureKey(source, wrapu, wrapv, mipmap)] = tex;
+}
+
+
+/**
+ *  Delete all textures which are only used by the cache.
+ */
+static void purgeTextures()
+{
+  std::map<std::string, ssgTexture*>::iterator it = textures.begin();
+
+  while (it != textures.end())
+  {
+    if (it->second->getRef() <= 1)
+    {
+      ssgDeRefDelete(it->second);
+      textures.erase(it++);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+}
+
+
+/**
+ *  Delete the least recently used models which are not used, until
+ *  there are no more than nKeep of them.
+ */
+static void trimModels(int nKeep)
+{
+  for (;;)
+  {
+    int nUnused = 0;
+    int nOldest = -1;
+
+    for (int i = 0; i < (int)models.size(); i++)
+    {
+      if (models[i].nUsers == 0)
+      {
+        nUnused++;
+        if (nOldest < 0 || models[i].lastUse < models[nOldest].lastUse)
+          nOldest = i;
+      }
+    }
+    if (nUnused <= nKeep)
+      break;
+
+    delete models[nOldest].extras;
+    ssgDeRefDelete(models[nOldest].model);
+    models.erase(models.begin() + nOldest);
+  }
+  purgeTextures();
+}
+
+
+/**
+ *  Key of a model in the cache
+ */
+static std::string modelKey(std::string const& model_name,
+                            std::string const& texture_path,
+                            std::string const& variant)
+{
+  return canonicalPath(model_name) + "|" + canonicalPath(texture_path) + "|" + variant;
+}
+
+
+/**
+ *  Load a model by the loaders of SSG, for image formats TextureImage
+ *  doesn't know. The textures are decoded and uploaded right here.
+ */
+static ssgEntity* loadModelClassic(std::string const& model_name,
+                                   std::string const& texture_path)
+{
+  if (options == NULL)
+  {
+    options = new CachedLoaderOptions();
+    options->ref();
+  }
+
+  lockLoader();
+  // ssgTexturePath() sets the path of the current options
+  ssgSetCurrentOptions(options);
+  ssgTexturePath(texture_path.c_str());
+  ssgEntity* model = ssgLoad(model_name.c_str(), options);
+  unlockLoader();
+
+  return model;
+}
+
+
+ssgEntity* loadModelUncached(std::string const& model_name,
+                             std::string const& texture_path)
+{
+  StagedModel* staged = stageModel(model_name, texture_path);
+  ssgEntity*   model  = NULL;
+
+  if (staged->fComplete)
+  {
+    staged->commit();
+    model = staged->model;
+    model->ref();
+  }
+  delete staged;
+
+  if (model == NULL)
+    return loadModelClassic(model_name, texture_path);
+
+  // owned by the caller
+  model->deRef();
+  return model;
+}
+
+
+ssgEntity* loadModel(std::string const& model_name,
+                     std::string const& texture_path,
+                     std::string const& variant,
+                     bool& fNew)
+{
+  ssgEntity*  model;
+  std::string key;
+
+  fNew = false;
+  if (variant != "")
+  {
+    key = modelKey(model_name, texture_path, variant);
+
+    for (unsigned int i = 0; i < models.size(); i++)
+    {
+      if (models[i].key == key)
+      {
+        models[i].nUsers++;
+        models[i].lastUse = ++useCounter;
+        return models[i].model;
+      }
+    }
+  }
+
+  model = loadModelUncached(model_name, texture_path);
+  if (model != NULL)
+  {
+    model->ref();
+    fNew = true;
+
+    if (variant != "")
+    {
+      ModelExtras* extras = new ModelExtras();
+      if (!adoptModel(model, model_name, texture_path, variant, extras))
+        delete extras;
+    }
+  }
+  return model;
+}
+
+
+ModelExtras* getModelExtras(ssgEntity* model)
+{
+  for (unsigned int i = 0; i < models.size(); i++)
+  {
+    if (models[i].model == model)
+      return models[i].extras;
+  }
+  return NULL;
+}
+
+
+bool adoptModel(ssgEntity* model,
+                std::string const& model_name,
+                std::string const& texture_path,
+                std::string const& variant,
+                ModelExtras* extras)
+{
+  if (variant == "")
+    return false;
+
+  std::string key = modelKey(model_name, texture_path, variant);
+  for (unsigned int i = 0; i < models.size(); i++)
+  {
+    if (models[i].key == key)
+      return false;
+  }
+
+  T_CachedModel entry;
+  entry.key     = key;
+  entry.model   = model;
+  entry.extras  = extras;
+  entry.nUsers  = 1;
+  entry.lastUse = ++useCounter;
+  models.push_back(entry);
+  return true;
+}
+
+
+void releaseModel(ssgEntity* model)
+{
+  if (model == NULL)
+    return;
+
+  for (unsigned int i = 0; i < models.size(); i++)
+  {
+    if (models[i].model == model)
+    {
+      if (--models[i].nUsers == 0)
+      {
+        models[i].lastUse = ++useCounter;
+        trimModels(ASSET_CACHE_UNUSED_MODELS);
+      }
+      return;
+    }
+  }
+
+  // not shared
+  ssgDeRefDelete(model);
+  purgeTextures();
+}
+
+
+void purgeAssetCache()
+{
+  trimModels(0);
+}
+
+
+void getAssetCacheStats(int& nModels, int& nInstances, int& nTextures)
+{
+  nModels    = models.size();
+  nInstances = 0;
+  for (unsigned int i = 0; i < models.size(); i++)
+    nInstances += models[i].nUsers;
+  nTextures  = textures.size();
+}
+
+
+long getResidentMemory()
+{
+  long rss = -1;
+
+#if defined(__linux__)
+  FILE* fp = fopen("/proc/self/statm", "r");
+  if (fp != NULL)
+  {
+    long size;
+    long resident;
+    if (fscanf(fp, "%ld %ld", &size, &resident) == 2)
+      rss = resident * (sysconf(_SC_PAGESIZE) / 1024);
+    fclose(fp);
+  }
+#endif
+
+  return rss;
+}
+
+} // end namespace Video::
@@ -0,0 +1,165 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+/** \file asset_cache.h
+ *
+ *  A cache for 3D models and textures.
+ *
+ *  Models which are displayed more than once (robots flying the same
+ *  airplane, the plane selection preview) are only loaded once. All
+ *  instances use the same scenegraph below their own transforms.
+ *  Textures are shared by all models and sceneries which are loaded
+ *  through the cache, no matter which model uses them first. What the
+ *  visualizations make from a model (its coarse copy, the adjacency of
+ *  its shadow) is kept next to it and made only once, too.
+ */
+
+#ifndef ASSET_CACHE_H_
+#define ASSET_CACHE_H_
+
+#include <plib/ssg.h>
+#include <string>
+
+namespace Video
+{
+
+class ShadowMesh;
+
+/**
+ *  What the visualizations make from a model, kept next to it in the
+ *  cache under the same key and deleted with it.
+ */
+class ModelExtras
+{
+  public:
+    ModelExtras() : coarse(NULL), shadowMesh(NULL) {};
+    ~ModelExtras();
+
+    ssgEntity*  coarse;       ///< coarse copy of the model, referenced
+    ShadowMesh* shadowMesh;   ///< adjacency of the shadow volume, NULL if there is none
+};
+
+/**
+ *  Load a model or take it from the cache.
+ *
+ *  The returned entity must not be modified by the caller, except
+ *  when fNew is true: then the caller is the first one to use it and
+ *  may set it up (animations and the like) before anybody else gets
+ *  it. Every call has to be matched by a call to releaseModel().
+ *
+ *  \param model_name    file name of the model
+ *  \param texture_path  directory of the textures
+ *  \param variant       anything else the setup of the model depends
+ *                       on; an empty string disables sharing, only
+ *                       textures are taken from the cache then
+ *  \param fNew          set to true if the model has been loaded
+ *  \return the model or NULL if it couldn't be loaded
+ */
+ssgEntity* loadModel(std::string const& model_name,
+                     std::string const& texture_path,
+                     std::string const& variant,
+                     bool& fNew);
+
+/**
+ *  Give back a model returned by loadModel(). It has to be removed
+ *  from the scenegraph before. Unused models are kept for a while,
+ *  in case they are needed again.
+ */
+void releaseModel(ssgEntity* model);
+
+/**
+ *  The extras of a model returned by loadModel(), empty until its
+ *  first user fills them in. Main thread only.
+ *
+ *  \return NULL if the model is not shared
+ */
+ModelExtras* getModelExtras(ssgEntity* model);
+
+/**
+ *  Put a model into the cache which has been loaded without it, by
+ *  stageModel() for example, as if loadModel() had just loaded it. If
+ *  the cache has a model with the same key already, this one is not
+ *  shared. Either way it is given back by releaseModel().
+ *
+ *  \param model   referenced once, the reference is taken over
+ *  \param extras  made from the model, taken over if it is shared
+ *  \return true if the model is shared
+ */
+bool adoptModel(ssgEntity* model,
+                std::string const& model_name,
+                std::string const& texture_path,
+                std::string const& variant,
+                ModelExtras* extras);
+
+/**
+ *  Load a model with textures from the cache, but without putting the
+ *  model itself into the cache. The caller owns the model.
+ *
+ *  The model is loaded by stageModel() and committed right away. If
+ *  it can't be staged, the loaders of SSG are used.
+ */
+ssgEntity* loadModelUncached(std::string const& model_name,
+                             std::string const& texture_path);
+
+/**
+ *  Texture of the cache which has been made from an image file. The
+ *  texture cache is used by the main thread only.
+ *
+ *  \param source  canonical path of the image file
+ *  \return the texture or NULL if there is none
+ */
+ssgTexture* findTexture(std::string const& source,
+                        int wrapu, int wrapv, int mipmap);
+
+/**
+ *  Put a texture into the cache which has been made from an image
+ *  file without the cache (a committed StagedTexture, for example),
+ *  so everybody loading that file later gets it.
+ *
+ *  \param source  canonical path of the image file
+ */
+void addTexture(ssgTexture* tex, std::string const& source,
+                int wrapu, int wrapv, int mipmap);
+
+/**
+ *  Delete all unused models and textures.
+ */
+void purgeAssetCache();
+
+/**
+ *  Number of models, model instances and textures in the cache.
+ */
+void getAssetCacheStats(int& nModels, int& nInstances, int& nTextures);
+
+/**
+ *  Absolute path without symbolic links, "." and "..", so a
+ *  file is found no matter how it has been specified.
+ */
+std::string canonicalPath(std::string const& path);
+
+/**
+ *  Resident memory of the process in kB or -1 if unknown.
+ */
+long getResidentMemory();
+
+} // end namespace Video::
+
+#endif // ASSET_CACHE_H_
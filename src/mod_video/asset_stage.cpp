@@ -0,0 +1,332 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+/** \file asset_stage.cpp
+ *
+ *  Loading models off the main thread.
+ */
+
+#include "asset_stage.h"
+#include "asset_bundle.h"
+#include "asset_cache.h"
+
+#include <SDL.h>
+#include <SDL_thread.h>
+
+
+namespace Video
+{
+
+/**
+ *  A texture requested by another thread from the main thread.
+ */
+typedef struct
+{
+  std::string    source;
+  bool           fAlpha;
+  StagedTexture* tex;      ///< set by serviceStaging()
+} T_TextureRequest;
+
+
+static bool                           fStaging    = false;  ///< initStaging() has been called
+static Uint32                         mainThread  = 0;
+static SDL_mutex*                     mutex       = NULL;
+static SDL_cond*                      cond        = NULL;   ///< signals requests done, lock released
+static std::vector<T_TextureRequest*> requests;
+static bool                           fLoaderBusy = false;
+
+
+/**
+ *  Loader options which decode the textures into memory and use
+ *  StagedTextures for them.
+ */
+class StagingLoaderOptions : public ssgLoaderOptions
+{
+  public:
+    StagingLoaderOptions(StagedModel* staged) : staged(staged) {};
+
+    ssgTexture* createTexture(char* tfname, int wrapu = TRUE, int wrapv = TRUE,
+                              int mipmap = TRUE);
+
+  private:
+    StagedModel* staged;
+};
+
+
+static bool isMainThread()
+{
+  return (!fStaging || SDL_ThreadID() == mainThread);
+}
+
+
+StagedTexture::StagedTexture(std::string const& source, bool fAlpha)
+  // a 1x1 image (taken over by PLIB) for a texture object with hasAlpha()
+  : ssgTexture(source.c_str(), new GLubyte[4], 1, 1, fAlpha ? 4 : 3),
+    source(source), fWrapU(TRUE), fWrapV(TRUE), fMipmap(TRUE)
+{
+}
+
+
+void StagedTexture::setImage(TextureImage& img, int wrapu, int wrapv, int mipmap)
+{
+  image.depth = img.depth;
+  image.level.swap(img.level);
+  img.clear();
+
+  fWrapU  = wrapu;
+  fWrapV  = wrapv;
+  fMipmap = mipmap;
+}
+
+
+void StagedTexture::upload()
+{
+  glBindTexture(GL_TEXTURE_2D, getHandle());
+  image.upload();
+
+  // as set by ssgTexture
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
+                  fMipmap ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, fWrapU ? GL_REPEAT : GL_CLAMP);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, fWrapV ? GL_REPEAT : GL_CLAMP);
+  glBindTexture(GL_TEXTURE_2D, 0);
+
+  image.clear();
+}
+
+
+StagedModel::~StagedModel()
+{
+  if (model != NULL)
+    ssgDeRefDelete(model);
+
+  for (unsigned int i = 0; i < textures.size(); i++)
+    ssgDeRefDelete(textures[i]);
+}
+
+
+void StagedModel::add(StagedTexture* tex)
+{
+  tex->ref();
+  textures.push_back(tex);
+}
+
+
+void StagedModel::commit()
+{
+  committed.clear();
+  for (unsigned int i = 0; i < textures.size(); i++)
+  {
+    StagedTexture* tex = textures[i];
+    ssgTexture*    cached = findTexture(tex->source, tex->fWrapU, tex->fWrapV, tex->fMipmap);
+
+    if (cached == NULL)
+    {
+      tex->upload();
+      addTexture(tex, tex->source, tex->fWrapU, tex->fWrapV, tex->fMipmap);
+      cached = tex;
+    }
+    committed.push_back(cached);
+  }
+
+  if (model != NULL)
+    resolveTextures(model);
+}
+
+
+void StagedModel::resolveTextures(ssgEntity* ent)
+{
+  if (ent->isAKindOf(ssgTypeLeaf()))
+  {
+    ssgLeaf* leaf = (ssgLeaf*)ent;
+    if (leaf->hasState() && leaf->getState()->isAKindOf(ssgTypeSimpleState()))
+    {
+      ssgSimpleState* state = (ssgSimpleState*)leaf->getState();
+      ssgTexture*     tex   = state->getTexture();
+
+      for (unsigned int i = 0; i < committed.size(); i++)
+      {
+        if (tex == textures[i] && committed[i] != tex)
+        {
+          state->setTexture(committed[i]);
+          break;
+        }
+      }
+    }
+  }
+  else if (ent->isAKindOf(ssgTypeBranch()))
+  {
+    ssgBranch* branch = (ssgBranch*)ent;
+    for (int i = 0; i < branch->getNumKids(); i++)
+      resolveTextures(branch->getKid(i));
+  }
+}
+
+
+ssgTexture* StagingLoaderOptions::createTexture(char* tfname, int wrapu, int wrapv,
+                                                int mipmap)
+{
+  char filename[1024];
+  makeTexturePath(filename, tfname);
+
+  std::string source = canonicalPath(filename);
+  for (unsigned int i = 0; i < staged->textures.size(); i++)
+  {
+    StagedTexture* tex = staged->textures[i];
+    if (tex->source == source && tex->fWrapU == wrapu &&
+        tex->fWrapV == wrapv && tex->fMipmap == mipmap)
+      return tex;
+  }
+
+  // the model is loaded again by the classic loader if this fails,
+  // the texture is only needed to finish this load
+  TextureImage img;
+  if (!img.load(source))
+    staged->fComplete = false;
+
+  StagedTexture* tex = makeStagedTexture(source, img.hasAlpha());
+  tex->setImage(img, wrapu, wrapv, mipmap);
+  staged->add(tex);
+  return tex;
+}
+
+
+StagedModel* stageModel(std::string const& model_name,
+                        std::string const& texture_path)
+{
+  StagedModel* staged = new StagedModel();
+
+  if (loadBundle(model_name, texture_path, staged))
+    return staged;
+
+  StagingLoaderOptions* options = new StagingLoaderOptions(staged);
+  options->ref();
+
+  lockLoader();
+  ssgLoaderOptions* previous = ssgGetCurrentOptions();
+  options->setTextureDir(texture_path.c_str());
+  staged->model = ssgLoad(model_name.c_str(), options);
+  ssgSetCurrentOptions(previous);
+  unlockLoader();
+
+  ssgDeRefDelete(options);
+
+  if (staged->model == NULL)
+  {
+    staged->fComplete = false;
+  }
+  else
+  {
+    staged->model->ref();
+    if (staged->fComplete)
+      compileBundle(model_name, texture_path, staged);
+  }
+  return staged;
+}
+
+
+StagedTexture* makeStagedTexture(std::string const& source, bool fAlpha)
+{
+  if (isMainThread())
+    return new StagedTexture(source, fAlpha);
+
+  T_TextureRequest req;
+  req.source = source;
+  req.fAlpha = fAlpha;
+  req.tex    = NULL;
+
+  SDL_LockMutex(mutex);
+  requests.push_back(&req);
+  while (req.tex == NULL)
+    SDL_CondWait(cond, mutex);
+  SDL_UnlockMutex(mutex);
+
+  return req.tex;
+}
+
+
+void initStaging()
+{
+  if (fStaging)
+    return;
+
+  mutex      = SDL_CreateMutex();
+  cond       = SDL_CreateCond();
+  mainThread = SDL_ThreadID();
+  fStaging   = true;
+}
+
+
+void serviceStaging()
+{
+  if (!fStaging)
+    return;
+
+  SDL_LockMutex(mutex);
+  if (requests.size() > 0)
+  {
+    for (unsigned int i = 0; i < requests.size(); i++)
+      requests[i]->tex = new StagedTexture(requests[i]->source, requests[i]->fAlpha);
+    requests.clear();
+    SDL_CondBroadcast(cond);
+  }
+  SDL_UnlockMutex(mutex);
+}
+
+
+void lockLoader()
+{
+  if (!fStaging)
+    return;
+
+  SDL_LockMutex(mutex);
+  while (fLoaderBusy)
+  {
+    if (isMainThread())
+    {
+      SDL_UnlockMutex(mutex);
+      serviceStaging();
+      SDL_Delay(1);
+      SDL_LockMutex(mutex);
+    }
+    else
+    {
+      SDL_CondWait(cond, mutex);
+    }
+  }
+  fLoaderBusy = true;
+  SDL_UnlockMutex(mutex);
+}
+
+
+void unlockLoader()
+{
+  if (!fStaging)
+    return;
+
+  SDL_LockMutex(mutex);
+  fLoaderBusy = false;
+  SDL_CondBroadcast(cond);
+  SDL_UnlockMutex(mutex);
+}
+
+} // end namespace Video::
@@ -0,0 +1,172 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+/** \file asset_stage.h
+ *
+ *  Loading models off the main thread.
+ *
+ *  SSG creates an OpenGL texture object for every texture of a model
+ *  it loads, so only the thread owning the OpenGL context could load
+ *  models. stageModel() does everything else on any thread: it parses
+ *  the model or reads its bundle and decodes the texture images into
+ *  memory. The textures it puts into the scenegraph are
+ *  StagedTextures, empty OpenGL textures which the main thread makes
+ *  on request. StagedModel::commit() uploads the images later, on the
+ *  main thread.
+ *
+ *  The loaders of PLIB keep their state in globals, so only one
+ *  thread uses them at a time, see lockLoader().
+ */
+
+#ifndef ASSET_STAGE_H_
+#define ASSET_STAGE_H_
+
+#include <plib/ssg.h>
+#include <string>
+#include <vector>
+
+#include "texture_image.h"
+
+namespace Video
+{
+
+/**
+ *  A texture whose image is uploaded after the model using it has
+ *  been loaded.
+ */
+class StagedTexture : public ssgTexture
+{
+  public:
+    /**
+     *  An empty texture named source. It is made by the main thread
+     *  only, use makeStagedTexture() on the others.
+     *
+     *  \param fAlpha  value of hasAlpha(), the loaders set up the
+     *                 states using the texture by it
+     */
+    StagedTexture(std::string const& source, bool fAlpha);
+
+    /**
+     *  Take over the image (img is swapped with an empty one) and the
+     *  parameters given to ssgLoaderOptions::createTexture(). Doesn't
+     *  use OpenGL.
+     */
+    void setImage(TextureImage& img, int wrapu, int wrapv, int mipmap);
+
+    /**
+     *  Upload the image to OpenGL and drop it. Main thread only.
+     */
+    void upload();
+
+    std::string  source;    ///< canonical path of the image file
+    int          fWrapU;
+    int          fWrapV;
+    int          fMipmap;
+    TextureImage image;     ///< empty once uploaded
+};
+
+
+/**
+ *  A model loaded by stageModel().
+ *
+ *  It has to be deleted by the main thread, as its textures are
+ *  OpenGL objects.
+ */
+class StagedModel
+{
+  public:
+    StagedModel() : model(NULL), fFromBundle(false), fComplete(true) {};
+    ~StagedModel();
+
+    /**
+     *  Keep a texture used by the model.
+     */
+    void add(StagedTexture* tex);
+
+    /**
+     *  Make the textures usable: the ones the texture cache already
+     *  has are replaced by those, the others are uploaded and put
+     *  into the cache. Main thread only.
+     */
+    void commit();
+
+    /**
+     *  Replace the textures in the states below ent which commit()
+     *  has replaced by cached ones. The model itself is done by
+     *  commit(), this is for copies of it with cloned states.
+     */
+    void resolveTextures(ssgEntity* ent);
+
+    ssgEntity*                  model;        ///< referenced, NULL if it couldn't be loaded
+    std::vector<StagedTexture*> textures;     ///< referenced
+    std::vector<ssgTexture*>    committed;    ///< what commit() has made of textures
+    bool                        fFromBundle;  ///< model has been read from its bundle
+    bool                        fComplete;    ///< false if a texture couldn't be decoded
+};
+
+
+/**
+ *  Load a model from its bundle if there is an up to date one,
+ *  otherwise from its source files, writing the bundle for the next
+ *  time. May be called on any thread; a thread other than the main
+ *  thread waits for the main thread to call serviceStaging() while
+ *  the model is loaded.
+ *
+ *  If the result is not fComplete, the model has to be loaded by
+ *  the classic loaders of SSG on the main thread, which know more
+ *  image formats.
+ *
+ *  \return the staged model, never NULL
+ */
+StagedModel* stageModel(std::string const& model_name,
+                        std::string const& texture_path);
+
+/**
+ *  An empty texture for a thread other than the main thread: the
+ *  request is handed to the main thread, which makes it in
+ *  serviceStaging(). On the main thread it is made right away.
+ */
+StagedTexture* makeStagedTexture(std::string const& source, bool fAlpha);
+
+/**
+ *  To be called by the main thread once, with the OpenGL context
+ *  current, before other threads load models. Until then everything
+ *  is done on the calling thread.
+ */
+void initStaging();
+
+/**
+ *  Make the textures requested by other threads. To be called by the
+ *  main thread once per frame while models are loaded.
+ */
+void serviceStaging();
+
+/**
+ *  Serialize the use of the loaders and writers of SSG. The main
+ *  thread keeps calling serviceStaging() while it waits, as the
+ *  thread holding the lock may be waiting for a texture.
+ */
+void lockLoader();
+void unlockLoader();
+
+} // end namespace Video::
+
+#endif // ASSET_STAGE_H_
@@ -26,6 +26,8 @@
  *  Classes for animated 3D model parts.
  */
 
+#include <iostream>
+
 #include "crrc_animation.h"
 #include "crrc_ssgutils.h"
 
@@ -177,7 +179,7 @@ CRRCAnimation::~CRRCAnimation()
  */
 CRRCControlSurfaceAnimation::CRRCControlSurfaceAnimation(SimpleXMLTransfer *xml)
  : CRRCAnimation(new ssgTransform()), fallback_data(0.0f),
-   eventAdapter(this, &CRRCControlSurfaceAnimation::axisValueCallback, Event::Input),
+   eventAdapter(this, &CRRCControlSurfaceAnimation::axisValueCallback),
     aileron(0.0f), elevator(0.0f), rudder(0.0f), throttle(0.0f),
     spoiler(0.0f), flap(0.0f), retract(0.0f), pitch(0.0f)
 {
@@ -406,19 +408,14 @@ void CRRCControlSurfaceAnimation::transformPoint(CRRCMath::Vector3& point)
 }
 
 
-void CRRCControlSurfaceAnimation::axisValueCallback(const Event* ev)
+void CRRCControlSurfaceAnimation::axisValueCallback(const AxisUpdateEvent& ev)
 {
-  const AxisUpdateEvent* aue = dynamic_cast<const AxisUpdateEvent*>(ev);
-  
-  if (aue != NULL)
-  {
-    aileron = aue->getAileron();
-    elevator = aue->getElevator();
-    rudder = aue->getRudder();
-    throttle = aue->getThrottle();
-    flap = aue->getFlap();
-    spoiler = aue->getSpoiler();
-    retract = aue->getRetract();
-    pitch = aue->getPitch();
-  }
+  aileron = ev.getAileron();
+  elevator = ev.getElevator();
+  rudder = ev.getRudder();
+  throttle = ev.getThrottle();
+  flap = ev.getFlap();
+  spoiler = ev.getSpoiler();
+  retract = ev.getRetract();
+  pitch = ev.getPitch();
 }
@@ -32,7 +32,7 @@
 #include <vector>
 
 #include <plib/ssg.h>
-#include "../mod_main/EventDispatcher.h"
+#include "../mod_main/EventBus.h"
 #include "../mod_misc/SimpleXMLTransfer.h"
 #include "../mod_fdm/fdm_inputs.h"
 #include "../mod_math/vector3.h"
@@ -110,7 +110,7 @@ class CRRCControlSurfaceAnimation : public CRRCAnimation
     void transformPoint(CRRCMath::Vector3& point);
   
     /// Callback for receiving control input values
-    void axisValueCallback(const Event* ev);
+    void axisValueCallback(const AxisUpdateEvent& ev);
   
   private:
     std::vector<float*> datasource;
@@ -124,7 +124,7 @@ class CRRCControlSurfaceAnimation : public CRRCAnimation
     float  max_angle;
     float  abs_max_angle;
     sgMat4 current_transformation;
-    EventAdapter<CRRCControlSurfaceAnimation> eventAdapter;
+    EventAdapter<CRRCControlSurfaceAnimation, AxisUpdateEvent> eventAdapter;
   
     float aileron;
     float elevator;
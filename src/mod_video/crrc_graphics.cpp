@@ -33,6 +33,7 @@
 #include "../global.h"
 #include "../aircraft.h"
 #include "../SimStateHandler.h"
+#include "../sim_thread.h"
 #include "../mod_mode/T_GameHandler.h"
 #include "crrc_graphics.h"
 #include "../crrc_main.h"
@@ -45,6 +46,9 @@
 #include "../defines.h"
 #include "../mod_landscape/crrc_scenery.h"
 #include "crrc_sky.h"
+#include "asset_stage.h"
+#include "offscreen.h"
+#include "render_stats.h"
 #include "glconsole.h"
 #include "gloverlay.h"
 #include "../zoom.h"
@@ -432,6 +436,9 @@ void initialize_scenegraph()
   
   // add to SSG function for read JPEG Textures 
   ::ssgAddTextureFormat ( ".jpg", ssgLoadJPG);
+
+  // models may be loaded by other threads from now on
+  initStaging();
   
   // font
   puSetDefaultFonts ( FONT_HELVETICA_14, FONT_HELVETICA_14 );
@@ -634,7 +641,7 @@ CRRCMath::Vector3 FDM2Graphics(CRRCMath::Vector3 const& v)
  */
 void display()
 {
-  CRRCMath::Vector3 plane_pos = FDM2Graphics(Global::aircraft->getPos());
+  CRRCMath::Vector3 plane_pos = FDM2Graphics(Global::aircraft->getDisplayFDM()->getPos());
 
   // Prepare the current frame buffer and reset
   // the modelview matrix (for non-SSG drawing)
@@ -659,6 +666,9 @@ void display()
   sgSetVec3(up, 0.0, 1.0, 0.0);
   context->setCameraLookAt(viewpos, planepos, up);
 
+  // count what is drawn for the 3D scene
+  beginRenderStats();
+
   // 3D scene
   if( Global::scenery != NULL)
   {
@@ -673,7 +683,7 @@ void display()
       glDisable(GL_TEXTURE_2D);
       glEnable(GL_LIGHTING);
       glEnable(GL_LIGHT0);
-      Global::aircraft->getModel()->draw(Global::aircraft->getFDM());
+      Global::aircraft->getModel()->draw(Global::aircraft->getDisplayFDM());
     }
   
     // 3D scene: scenery
@@ -700,11 +710,21 @@ void display()
   
   if (Global::training_mode==TRUE)
   {
-    draw_thermals(Global::aircraft->getPos());
+    // the simulation thread moves the thermals, it hands
+    // out copies with its snapshots
+    if (Global::simThread)
+    {
+      const T_SimSnapshot* snap = Global::simThread->getSnapshot();
+      if (snap)
+        draw_thermals(Global::aircraft->getDisplayFDM()->getPos(), snap->thermals);
+    }
+    else
+      draw_thermals(Global::aircraft->getDisplayFDM()->getPos());
   }
   
   // 3D scene: game-mode-specific stuff (pylons etc.)
   Global::gameHandler->draw();
+  endRenderStats();
 
   glPopMatrix();
 
@@ -738,7 +758,7 @@ void display()
     int r   = window_ysize >> 5;
     int w   = r >> 1;
     int h   = window_ysize >> 3;
-    int ht  = (int)(Global::aircraft->getFDM()->getBatCapLeft() * h);
+    int ht  = (int)(Global::aircraft->getDisplayFDM()->getBatCapLeft() * h);
                     
 #if 0
     glDisable(GL_LIGHTING);
@@ -780,7 +800,10 @@ void display()
 
   // Force pipeline flushing and flip front and back buffer
   glFlush();
-  SDL_GL_SwapBuffers();
+  if (offscreenEnabled())
+    captureFrame();
+  else
+    SDL_GL_SwapBuffers();
 }
 
 
@@ -911,7 +934,7 @@ SDL_Surface* video_setup_colordepth(int& nX, int& nY, int& nFullscreen, int colo
   SDL_GL_SetAttribute(SDL_GL_GREEN_SIZE, cbits);
   SDL_GL_SetAttribute(SDL_GL_BLUE_SIZE, cbits);
 //  SDL_GL_SetAttribute(SDL_GL_ALPHA_SIZE, cbits);
-  SDL_GL_SetAttribute(SDL_GL_STENCIL_SIZE,1);
+  SDL_GL_SetAttribute(SDL_GL_STENCIL_SIZE,8);
   SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, zbits);
   SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
 
@@ -979,9 +1002,45 @@ SDL_Surface* video_setup_colordepth(int& nX, int& nY, int& nFullscreen, int colo
   return(screen);
 }
 
+/**
+ *  Set up offscreen rendering instead of a window.
+ */
+static int setupOffscreenScreen()
+{
+  int nX = cfgfile->getInt("video.resolution.window.x", 800);
+  int nY = cfgfile->getInt("video.resolution.window.y", 600);
+
+  if (setupOffscreen(nX, nY) != 0)
+  {
+    crrc_exit(CRRC_EXIT_FAILURE, "Unable to set up offscreen rendering.");
+  }
+
+  screen_xsize = window_xsize = nX;
+  screen_ysize = window_ysize = nY;
+
+  glGetIntegerv(GL_RED_BITS,     &(vidbits.red));
+  glGetIntegerv(GL_GREEN_BITS,   &(vidbits.green));
+  glGetIntegerv(GL_BLUE_BITS,    &(vidbits.blue));
+  glGetIntegerv(GL_ALPHA_BITS,   &(vidbits.alpha));
+  glGetIntegerv(GL_DEPTH_BITS,   &(vidbits.depth));
+  glGetIntegerv(GL_STENCIL_BITS, &(vidbits.stencil));
+  setupRenderStats();
+
+  std::string s = GetVideoInfoString("  ");
+  printf("Using the following rendering mode:\n%s", s.c_str());
+
+  return(0);
+}
+
 int setupScreen(int nX, int nY, int nFullscreen)
 {
   int resolution_auto = 0;
+
+  if (offscreenEnabled())
+  {
+    return(setupOffscreenScreen());
+  }
+
   if((nX==0)&&(nY==0)&&(nFullscreen==0))//intialization
   {
     const SDL_VideoInfo* vi = SDL_GetVideoInfo();
@@ -1062,6 +1121,7 @@ int setupScreen(int nX, int nY, int nFullscreen)
   SDL_GL_GetAttribute(SDL_GL_ALPHA_SIZE, &(vidbits.alpha));
   SDL_GL_GetAttribute(SDL_GL_DEPTH_SIZE, &(vidbits.depth));
   SDL_GL_GetAttribute(SDL_GL_STENCIL_SIZE, &(vidbits.stencil));
+  setupRenderStats();
   
   std::string s = GetVideoInfoString("  ");
   printf("Using the following rendering mode:\n%s", s.c_str());
@@ -1129,6 +1189,7 @@ void cleanup()
 {
   delete console;
   cleanup_sky();
+  cleanupOffscreen();
 }
 
 
@@ -1208,7 +1269,7 @@ void UpdateCamera(float flDeltaT)
   double  phimax    = flSloppyCam*zoom_get();
   double  max       = cos(phimax)*cos(phimax);
   
-  CRRCMath::Vector3 plane_pos = FDM2Graphics(Global::aircraft->getPos());
+  CRRCMath::Vector3 plane_pos = FDM2Graphics(Global::aircraft->getDisplayFDM()->getPos());
   CRRCMath::Vector3 look_dir  = looking_pos - player_pos;
   CRRCMath::Vector3 plane_dir = plane_pos - player_pos;
   
@@ -28,6 +28,8 @@
  *  \author Jan Reucker (slowhand_47@gmx.de)
  */
  
+#include <iostream>
+
 #include "../include_gl.h"
 #include "glconsole.h"
 #include "../mod_misc/filesystools.h"
@@ -43,8 +45,7 @@
  * \param yorig     vertical position of lower left corner
  */
 GlConsole::GlConsole(int xsize, int ysize, int xorig, int yorig)
- : EventListener(Event::Logging),
-   lastActivity(0.0), display_time(0), fade_time(0), state(VISIBLE),
+ : lastActivity(0.0), display_time(0), fade_time(0), state(VISIBLE),
    stateTimer(0.0), size_x(xsize), size_y(ysize), pos_x(xorig), pos_y(yorig),
    vspace(2), inner_border(5), fadeStarted(0.0), fontRenderer(),
    text_r(1.0), text_g(1.0), text_b(1.0), text_a(1.0),
@@ -58,11 +59,14 @@ GlConsole::GlConsole(int xsize, int ysize, int xorig, int yorig)
   {
     std::cout << "GlConsole: Unable to find font " << GLCONSOLE_FONT_FILE << ", falling back to bitmap font!" << std::endl;
     fontRenderer.setFont(fntGetBitmapFont(FNT_BITMAP_8_BY_13));
+    fTextureFont = false;
   }
   else
   {
     fontRenderer.setFont(textureFont);
+    fTextureFont = true;
   }
+  fTextChanged = true;
   fontRenderer.setPointSize(13);
 
   visibleLines = (unsigned int)((size_y - (2 * inner_border)) / (fontRenderer.getPointSize() + vspace));
@@ -98,25 +102,42 @@ void GlConsole::render(int window_width, int window_height)
     setOpenGLState(window_width, window_height);
     
     // render the background quad
-    glBegin(GL_QUADS);
     glColor4f(bg_r, bg_g, bg_b, bg_a * relativeOpacity);
-    glVertex2i(pos_x,           pos_y);
-    glVertex2i(pos_x + size_x,  pos_y);
-    glVertex2i(pos_x + size_x,  pos_y + size_y);
-    glVertex2i(pos_x,           pos_y + size_y);
-    glEnd();
+    glRecti(pos_x, pos_y, pos_x + size_x, pos_y + size_y);
     
     // render the text
     glDisable(GL_BLEND);
     fontRenderer.begin();
     glColor4f(text_r, text_g, text_b, text_a * relativeOpacity);
-    int i = 0;
-    for (it = lines.begin(); it != lines.end(); it++)
+    if (fTextureFont)
+    {
+      if (fTextChanged)
+      {
+        buildText();
+      }
+      if (textVertices.size() > 0)
+      {
+        glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+        glDisableClientState(GL_NORMAL_ARRAY);
+        glDisableClientState(GL_COLOR_ARRAY);
+        glEnableClientState(GL_VERTEX_ARRAY);
+        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+        glVertexPointer(2, GL_FLOAT, 0, &textVertices[0]);
+        glTexCoordPointer(2, GL_FLOAT, 0, &textTexCoords[0]);
+        glDrawArrays(GL_QUADS, 0, textVertices.size() / 2);
+        glPopClientAttrib();
+      }
+    }
+    else
     {
-      fontRenderer.start2f( pos_x + inner_border,
-                            pos_y + inner_border + i * (fontRenderer.getPointSize() + vspace));
-      fontRenderer.puts(it->c_str());
-      i++;
+      int i = 0;
+      for (it = lines.begin(); it != lines.end(); it++)
+      {
+        fontRenderer.start2f( pos_x + inner_border,
+                              pos_y + inner_border + i * (fontRenderer.getPointSize() + vspace));
+        fontRenderer.puts(it->c_str());
+        i++;
+      }
     }
     fontRenderer.end();
     glEnable(GL_BLEND);
@@ -125,6 +146,68 @@ void GlConsole::render(int window_width, int window_height)
   } // state != HIDDEN
 }
     
+/**
+ * Build the quads of all glyphs of all lines, the same way
+ * fntTexFont::puts() would draw them.
+ */
+void GlConsole::buildText()
+{
+  std::list<std::string>::iterator it;
+  float size   = fontRenderer.getPointSize();
+  float italic = fontRenderer.getSlant();
+  float gap    = textureFont->getGap();
+  int   i      = 0;
+
+  textVertices.clear();
+  textTexCoords.clear();
+
+  for (it = lines.begin(); it != lines.end(); it++)
+  {
+    float x = pos_x + inner_border;
+    float y = pos_y + inner_border + i * (size + vspace);
+
+    for (std::string::size_type n = 0; n < it->length(); n++)
+    {
+      char  c = (*it)[n];
+      float wid, t_left, t_right, t_bot, t_top, v_left, v_right, v_bot, v_top;
+
+      if (!textureFont->getGlyph(c, &wid, &t_left, &t_right, &t_bot, &t_top,
+                                 &v_left, &v_right, &v_bot, &v_top))
+      {
+        // try the other case, spaces don't need a glyph
+        if (c >= 'A' && c <= 'Z')
+          c = c - 'A' + 'a';
+        else if (c >= 'a' && c <= 'z')
+          c = c - 'a' + 'A';
+
+        if (c == ' ')
+        {
+          x += size / 2.0f;
+          continue;
+        }
+        if (!textureFont->getGlyph(c, &wid, &t_left, &t_right, &t_bot, &t_top,
+                                   &v_left, &v_right, &v_bot, &v_top))
+          continue;
+      }
+
+      GLfloat quad[8] = { x + v_left  * size,          y + v_bot * size,
+                          x + v_right * size,          y + v_bot * size,
+                          x + v_right * size + italic, y + v_top * size,
+                          x + v_left  * size + italic, y + v_top * size };
+      GLfloat tex[8]  = { t_left,  t_bot,
+                          t_right, t_bot,
+                          t_right, t_top,
+                          t_left,  t_top };
+      textVertices.insert(textVertices.end(), quad, quad + 8);
+      textTexCoords.insert(textTexCoords.end(), tex, tex + 8);
+
+      x += (gap + (textureFont->isFixedPitch() ? textureFont->getWidth() : wid)) * size;
+    }
+    i++;
+  }
+  fTextChanged = false;
+}
+
 /**
  * The internal state machine of the console.
  */
@@ -218,6 +301,7 @@ void GlConsole::addLine(std::string theLine)
   {
     lines.pop_back();
   }
+  fTextChanged = true;
 }
 
 
@@ -361,18 +445,14 @@ void GlConsole::setTextColor(float r, float g, float b, float a)
 
 
 /**
- * interface to the EventDispatcher
+ * interface to the EventBus
  *
- * This method is called by the EventDispatcher every time
+ * This method is called by the EventBus every time
  * a logging event is raised somewhere in CRRCsim.
  *
- * \param Event   the raised event
+ * \param ev      the raised event
  */
-void GlConsole::operator()(const Event* ev)
+void GlConsole::operator()(const LogMessageEvent& ev)
 {
-  if (ev->getGroup() == Event::Logging)
-  {
-    const LogMessageEvent *msg = static_cast<const LogMessageEvent*>(ev);
-    print(msg->get());
-  }
+  print(ev.get());
 }
@@ -34,11 +34,12 @@
 
 #include <string>
 #include <list>
+#include <vector>
 
 #include <plib/ul.h>
 #include <plib/fnt.h>
 
-#include "../mod_main/EventDispatcher.h"
+#include "../mod_main/EventBus.h"
 
 
 /**
@@ -51,7 +52,7 @@
  * - call render() once each frame
  * - send text to the console using print()
  */
-class GlConsole : public EventListener
+class GlConsole : public EventListener<LogMessageEvent>
 {
   public:
     /** default constructor */
@@ -84,8 +85,8 @@ class GlConsole : public EventListener
     /** set the color of the console text */
     void setTextColor(float r, float g, float b, float a);
     
-    /** interface to the EventDispatcher */
-    void operator()(const Event* ev);
+    /** interface to the EventBus */
+    void operator()(const LogMessageEvent& ev);
     
   private:
     /** possible states of the console */
@@ -129,6 +130,12 @@ class GlConsole : public EventListener
     float   bg_a;                 ///< background color, alpha channel (transparency)
 
     fntTexFont    *textureFont;   ///< Texture font object
+    bool          fTextureFont;   ///< textureFont is used, not the bitmap font
+
+    // glyphs of all lines, drawn with one call if the texture font is used
+    std::vector<GLfloat> textVertices;   ///< x, y of all glyph quads
+    std::vector<GLfloat> textTexCoords;  ///< texture coordinates of all glyph quads
+    bool                 fTextChanged;   ///< the glyphs have to be rebuilt
 
     /** setup the OpenGL-state for console rendering */
     void setOpenGLState(int w, int h);
@@ -147,6 +154,9 @@ class GlConsole : public EventListener
     
     /** internally add a line to the console */
     void addLine(std::string theLine);
+
+    /** rebuild the glyph quads of all lines */
+    void buildText();
 };
 
 #endif /*GLCONSOLE_H_*/
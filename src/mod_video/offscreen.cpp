@@ -0,0 +1,473 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+/** \file offscreen.cpp
+ *
+ *  Rendering without a window.
+ */
+
+#include <crrc_config.h>
+
+#include "offscreen.h"
+#include "../config.h"
+#include "../include_gl.h"
+#include "../mod_misc/filesystools.h"
+
+#include <SDL.h>
+#include <SDL_thread.h>
+#include <deque>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstring>
+
+#if OFFSCREEN > 0
+# include <EGL/egl.h>
+# include <EGL/eglext.h>
+# include <GL/glext.h>
+#endif
+
+
+namespace Video
+{
+
+#if OFFSCREEN > 0
+
+/// number of pixel buffers, frames are copied to main memory this
+/// many frames after they have been read
+#define OFFSCREEN_PBOS    (3)
+
+/// number of frames which may wait for the writer thread
+#define OFFSCREEN_QUEUE   (4)
+
+
+/**
+ *  A frame in main memory
+ */
+typedef struct
+{
+  unsigned char* pixels;  ///< RGB, bottom row first
+  unsigned long  nFrame;  ///< number of the frame
+} T_Frame;
+
+
+static EGLDisplay display = EGL_NO_DISPLAY;
+static EGLSurface surface = EGL_NO_SURFACE;
+static EGLContext context = EGL_NO_CONTEXT;
+
+static PFNGLGENBUFFERSPROC    glGenBuffersP    = NULL;
+static PFNGLDELETEBUFFERSPROC glDeleteBuffersP = NULL;
+static PFNGLBINDBUFFERPROC    glBindBufferP    = NULL;
+static PFNGLBUFFERDATAPROC    glBufferDataP    = NULL;
+static PFNGLMAPBUFFERPROC     glMapBufferP     = NULL;
+static PFNGLUNMAPBUFFERPROC   glUnmapBufferP   = NULL;
+
+static GLuint        pbo[OFFSCREEN_PBOS];
+static long          pboFrame[OFFSCREEN_PBOS]; ///< frame read into pbo, -1 if none
+static bool          fUsePBO     = false;
+
+static int           width       = 0;
+static int           height      = 0;
+static std::string   directory;
+static unsigned long nFrames     = 0;  ///< number of frames to capture, 0 for no limit
+static unsigned long nCaptured   = 0;  ///< number of frames captured so far
+
+// shared with the writer thread, protected by lock
+static SDL_mutex*                  lock        = NULL;
+static SDL_cond*                   cond        = NULL;
+static SDL_Thread*                 writer      = NULL;
+static std::deque<T_Frame>         queue;
+static std::vector<unsigned char*> freeBuffers;
+static bool                        fStopWriter = false;
+
+
+/**
+ *  Write a frame to a PPM file.
+ */
+static void writeFrame(T_Frame const& frame)
+{
+  char name[32];
+  sprintf(name, "/frame%06lu.ppm", frame.nFrame);
+
+  std::string filename = directory + name;
+  FILE* fp = fopen(filename.c_str(), "wb");
+  if (fp == NULL)
+  {
+    fprintf(stderr, "Unable to write %s\n", filename.c_str());
+    return;
+  }
+
+  fprintf(fp, "P6\n%d %d\n255\n", width, height);
+  for (int y = height - 1; y >= 0; y--)
+    fwrite(frame.pixels + y * width * 3, 3, width, fp);
+  fclose(fp);
+}
+
+
+static int writerThread(void*)
+{
+  SDL_LockMutex(lock);
+  for (;;)
+  {
+    while (queue.empty() && !fStopWriter)
+      SDL_CondWait(cond, lock);
+    if (queue.empty())
+      break;
+
+    T_Frame frame = queue.front();
+    queue.pop_front();
+    SDL_UnlockMutex(lock);
+
+    writeFrame(frame);
+
+    SDL_LockMutex(lock);
+    freeBuffers.push_back(frame.pixels);
+    SDL_CondBroadcast(cond);
+  }
+  SDL_UnlockMutex(lock);
+
+  return 0;
+}
+
+
+/**
+ *  Get a buffer for a frame, waits for the writer thread if all of
+ *  them are queued.
+ */
+static unsigned char* getBuffer()
+{
+  unsigned char* pixels;
+
+  SDL_LockMutex(lock);
+  while (freeBuffers.empty())
+    SDL_CondWait(cond, lock);
+  pixels = freeBuffers.back();
+  freeBuffers.pop_back();
+  SDL_UnlockMutex(lock);
+
+  return pixels;
+}
+
+
+static void queueFrame(unsigned char* pixels, unsigned long nFrame)
+{
+  T_Frame frame;
+  frame.pixels = pixels;
+  frame.nFrame = nFrame;
+
+  SDL_LockMutex(lock);
+  queue.push_back(frame);
+  SDL_CondBroadcast(cond);
+  SDL_UnlockMutex(lock);
+}
+
+
+/**
+ *  Copy the frame read into a pixel buffer to main memory and queue
+ *  it for writing.
+ */
+static void retirePBO(int nSlot)
+{
+  if (pboFrame[nSlot] < 0)
+    return;
+
+  unsigned char* pixels = getBuffer();
+
+  glBindBufferP(GL_PIXEL_PACK_BUFFER, pbo[nSlot]);
+  void* data = glMapBufferP(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+  if (data != NULL)
+  {
+    memcpy(pixels, data, width * height * 3);
+    glUnmapBufferP(GL_PIXEL_PACK_BUFFER);
+  }
+  glBindBufferP(GL_PIXEL_PACK_BUFFER, 0);
+
+  queueFrame(pixels, pboFrame[nSlot]);
+  pboFrame[nSlot] = -1;
+}
+
+
+/**
+ *  Get a display which doesn't need a display server, if the EGL
+ *  implementation knows about it.
+ */
+static EGLDisplay getDisplay()
+{
+  EGLDisplay  dpy        = EGL_NO_DISPLAY;
+  const char* extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+
+#ifdef EGL_PLATFORM_SURFACELESS_MESA
+  if (extensions != NULL && strstr(extensions, "EGL_MESA_platform_surfaceless") != NULL)
+  {
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+      (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (getPlatformDisplay != NULL)
+      dpy = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+  }
+#endif
+
+  if (dpy == EGL_NO_DISPLAY)
+    dpy = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+  return dpy;
+}
+
+
+#endif // OFFSCREEN > 0
+
+
+bool createOffscreenContext(int nX, int nY)
+{
+#if OFFSCREEN > 0
+  EGLint configAttribs[] =
+  {
+    EGL_SURFACE_TYPE,    EGL_PBUFFER_BIT,
+    EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+    EGL_RED_SIZE,        8,
+    EGL_GREEN_SIZE,      8,
+    EGL_BLUE_SIZE,       8,
+    EGL_DEPTH_SIZE,      24,
+    EGL_STENCIL_SIZE,    8,
+    EGL_NONE
+  };
+  EGLint pbufferAttribs[] =
+  {
+    EGL_WIDTH,  nX,
+    EGL_HEIGHT, nY,
+    EGL_NONE
+  };
+  EGLConfig config;
+  EGLint    nConfigs = 0;
+
+  display = getDisplay();
+  if (display == EGL_NO_DISPLAY || !eglInitialize(display, NULL, NULL))
+  {
+    fprintf(stderr, "Unable to initialize EGL\n");
+    return false;
+  }
+
+  if (!eglChooseConfig(display, configAttribs, &config, 1, &nConfigs) || nConfigs < 1)
+  {
+    // try without stencil buffer, there are no shadows then
+    configAttribs[12] = EGL_NONE;
+    if (!eglChooseConfig(display, configAttribs, &config, 1, &nConfigs) || nConfigs < 1)
+    {
+      fprintf(stderr, "No EGL configuration for OpenGL pbuffers\n");
+      return false;
+    }
+  }
+
+  eglBindAPI(EGL_OPENGL_API);
+  surface = eglCreatePbufferSurface(display, config, pbufferAttribs);
+  context = eglCreateContext(display, config, EGL_NO_CONTEXT, NULL);
+  if (surface == EGL_NO_SURFACE || context == EGL_NO_CONTEXT
+      || !eglMakeCurrent(display, surface, surface, context))
+  {
+    fprintf(stderr, "Unable to create an EGL pbuffer context (0x%x)\n", eglGetError());
+    return false;
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+
+#if OFFSCREEN > 0
+
+/**
+ *  Set up the pixel buffers, if they are supported.
+ */
+static void setupPBOs()
+{
+  int major = 0;
+  int minor = 0;
+  const char* version = (const char*)glGetString(GL_VERSION);
+  if (version != NULL)
+    sscanf(version, "%d.%d", &major, &minor);
+
+  fUsePBO = false;
+  if (major > 2 || (major == 2 && minor >= 1))
+  {
+    glGenBuffersP    = (PFNGLGENBUFFERSPROC)eglGetProcAddress("glGenBuffers");
+    glDeleteBuffersP = (PFNGLDELETEBUFFERSPROC)eglGetProcAddress("glDeleteBuffers");
+    glBindBufferP    = (PFNGLBINDBUFFERPROC)eglGetProcAddress("glBindBuffer");
+    glBufferDataP    = (PFNGLBUFFERDATAPROC)eglGetProcAddress("glBufferData");
+    glMapBufferP     = (PFNGLMAPBUFFERPROC)eglGetProcAddress("glMapBuffer");
+    glUnmapBufferP   = (PFNGLUNMAPBUFFERPROC)eglGetProcAddress("glUnmapBuffer");
+
+    fUsePBO = (glGenBuffersP != NULL && glDeleteBuffersP != NULL
+               && glBindBufferP != NULL && glBufferDataP != NULL
+               && glMapBufferP != NULL && glUnmapBufferP != NULL);
+  }
+
+  if (fUsePBO)
+  {
+    glGenBuffersP(OFFSCREEN_PBOS, pbo);
+    for (int i = 0; i < OFFSCREEN_PBOS; i++)
+    {
+      glBindBufferP(GL_PIXEL_PACK_BUFFER, pbo[i]);
+      glBufferDataP(GL_PIXEL_PACK_BUFFER, width * height * 3, NULL, GL_STREAM_READ);
+      pboFrame[i] = -1;
+    }
+    glBindBufferP(GL_PIXEL_PACK_BUFFER, 0);
+  }
+  else
+  {
+    printf("Pixel buffer objects not supported, frames are read synchronously.\n");
+  }
+}
+
+#endif // OFFSCREEN > 0
+
+
+bool offscreenEnabled()
+{
+  // called every frame, so the path is resolved only once
+  static XMLHandle enabled;
+
+  if (!enabled.isValid())
+    enabled = cfgfile->getHandle("video.offscreen.enabled", "0");
+  return (enabled.getInt(0) != 0);
+}
+
+
+int setupOffscreen(int nX, int nY)
+{
+#if OFFSCREEN > 0
+  SimpleXMLTransfer* cfg = cfgfile->getChild("video.offscreen", true);
+
+  directory = cfg->getString("dir", FileSysTools::getHomePath() + "/frames");
+  nFrames   = cfg->getInt("frames", 0);
+  nCaptured = 0;
+  width     = nX;
+  height    = nY;
+
+  if (!createOffscreenContext(nX, nY))
+    return -1;
+
+  FileSysTools::makeSurePathExists(directory);
+  setupPBOs();
+
+  lock        = SDL_CreateMutex();
+  cond        = SDL_CreateCond();
+  fStopWriter = false;
+  for (int i = 0; i < OFFSCREEN_QUEUE; i++)
+    freeBuffers.push_back(new unsigned char[nX * nY * 3]);
+  writer = SDL_CreateThread(writerThread, NULL);
+
+  printf("Rendering offscreen to %s, %dx%d\n", directory.c_str(), nX, nY);
+  return 0;
+#else
+  fprintf(stderr, "Offscreen rendering is not supported by this build.\n");
+  return -1;
+#endif
+}
+
+
+void captureFrame()
+{
+#if OFFSCREEN > 0
+  if (offscreenCaptureDone())
+    return;
+
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+  if (fUsePBO)
+  {
+    // the pixel buffer read OFFSCREEN_PBOS frames ago should be
+    // ready by now
+    int nSlot = nCaptured % OFFSCREEN_PBOS;
+    retirePBO(nSlot);
+
+    glBindBufferP(GL_PIXEL_PACK_BUFFER, pbo[nSlot]);
+    glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, 0);
+    glBindBufferP(GL_PIXEL_PACK_BUFFER, 0);
+    pboFrame[nSlot] = nCaptured;
+  }
+  else
+  {
+    unsigned char* pixels = getBuffer();
+    glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, pixels);
+    queueFrame(pixels, nCaptured);
+  }
+  nCaptured++;
+#endif
+}
+
+
+bool offscreenCaptureDone()
+{
+#if OFFSCREEN > 0
+  return (nFrames > 0 && nCaptured >= nFrames);
+#else
+  return false;
+#endif
+}
+
+
+void* getOffscreenProcAddress(const char* name)
+{
+#if OFFSCREEN > 0
+  return (void*)eglGetProcAddress(name);
+#else
+  return NULL;
+#endif
+}
+
+
+void cleanupOffscreen()
+{
+#if OFFSCREEN > 0
+  if (context == EGL_NO_CONTEXT)
+    return;
+
+  if (fUsePBO)
+  {
+    // oldest first
+    for (int i = 0; i < OFFSCREEN_PBOS; i++)
+      retirePBO((nCaptured + i) % OFFSCREEN_PBOS);
+    glDeleteBuffersP(OFFSCREEN_PBOS, pbo);
+  }
+
+  if (writer != NULL)
+  {
+    SDL_LockMutex(lock);
+    fStopWriter = true;
+    SDL_CondBroadcast(cond);
+    SDL_UnlockMutex(lock);
+    SDL_WaitThread(writer, NULL);
+    writer = NULL;
+  }
+  for (unsigned int i = 0; i < freeBuffers.size(); i++)
+    delete[] freeBuffers[i];
+  freeBuffers.clear();
+  SDL_DestroyCond(cond);
+  SDL_DestroyMutex(lock);
+
+  eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+  eglDestroyContext(display, context);
+  eglDestroySurface(display, surface);
+  eglTerminate(display);
+  context = EGL_NO_CONTEXT;
+#endif
+}
+
+} // end namespace Video::
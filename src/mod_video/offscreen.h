@@ -0,0 +1,106 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+/** \file offscreen.h
+ *
+ *  Rendering without a window.
+ *
+ *  Instead of an SDL window, an EGL pbuffer is rendered to, which
+ *  works without any display server (Mesa's software renderer with
+ *  EGL_PLATFORM=surfaceless, for example). Every frame is written to
+ *  a PPM file. The simulation time advances by a fixed amount per
+ *  frame, so the image sequence doesn't depend on how fast the
+ *  frames can be rendered.
+ *
+ *  The pixels are read back through a ring of pixel buffer objects:
+ *  the copy to main memory is done some frames after glReadPixels()
+ *  has been issued, and the files are written by a separate thread.
+ *
+ *  Configuration (video.offscreen):
+ *  - enabled:  1 to render offscreen
+ *  - dir:      directory for the frames
+ *  - interval: simulation time per frame in ms
+ *  - frames:   number of frames to write before the simulation
+ *              terminates, 0 for no limit
+ *
+ *  The image size is taken from video.resolution.window.
+ */
+
+#ifndef OFFSCREEN_H_
+#define OFFSCREEN_H_
+
+namespace Video
+{
+
+/**
+ *  True if offscreen rendering is configured. It is used instead of
+ *  an SDL window then.
+ */
+bool offscreenEnabled();
+
+/**
+ *  Create an EGL pbuffer context and make it current, without a
+ *  display server if the EGL implementation allows it. It has a
+ *  stencil buffer if there is a configuration with one. This is
+ *  the context setupOffscreen() renders to; the tests which draw
+ *  without a window use it, too.
+ *
+ *  \param nX  pbuffer width
+ *  \param nY  pbuffer height
+ *  \return false if there is no such context
+ */
+bool createOffscreenContext(int nX, int nY);
+
+/**
+ *  Create the rendering context and start the frame writer.
+ *
+ *  \param nX  image width
+ *  \param nY  image height
+ *  \return 0 on success, -1 if offscreen rendering is not available
+ */
+int setupOffscreen(int nX, int nY);
+
+/**
+ *  Queue the frame which has just been rendered for writing. This
+ *  replaces swapping the buffers of a window.
+ */
+void captureFrame();
+
+/**
+ *  True if the configured number of frames has been captured.
+ */
+bool offscreenCaptureDone();
+
+/**
+ *  Address of an OpenGL function for the offscreen context, NULL if
+ *  it isn't available.
+ */
+void* getOffscreenProcAddress(const char* name);
+
+/**
+ *  Write all frames still in flight, stop the writer and destroy
+ *  the rendering context.
+ */
+void cleanupOffscreen();
+
+} // end namespace Video::
+
+#endif // OFFSCREEN_H_
@@ -0,0 +1,154 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+/** \file render_stats.cpp
+ *
+ *  Counts the primitives sent to OpenGL for the 3D scene.
+ */
+
+#include <crrc_config.h>
+
+#include <SDL.h>
+#include <cstdio>
+
+#include "../include_gl.h"
+#include "render_stats.h"
+#include "offscreen.h"
+
+#ifndef APIENTRY
+# define APIENTRY
+#endif
+
+#ifndef GL_QUERY_RESULT
+# define GL_QUERY_RESULT            0x8866
+# define GL_QUERY_RESULT_AVAILABLE  0x8867
+#endif
+#ifndef GL_PRIMITIVES_GENERATED
+# define GL_PRIMITIVES_GENERATED    0x8C87
+#endif
+
+/// number of query objects, a result is read this many frames
+/// after the query has been issued
+#define RENDER_STATS_QUERIES  (3)
+
+
+namespace Video
+{
+
+typedef void (APIENTRY *T_GenQueries)(GLsizei n, GLuint* ids);
+typedef void (APIENTRY *T_BeginQuery)(GLenum target, GLuint id);
+typedef void (APIENTRY *T_EndQuery)(GLenum target);
+typedef void (APIENTRY *T_GetQueryObjectuiv)(GLuint id, GLenum pname, GLuint* params);
+
+static T_GenQueries        glGenQueriesP        = NULL;
+static T_BeginQuery        glBeginQueryP        = NULL;
+static T_EndQuery          glEndQueryP          = NULL;
+static T_GetQueryObjectuiv glGetQueryObjectuivP = NULL;
+
+static bool   fAvailable = false;
+static GLuint queries[RENDER_STATS_QUERIES];
+static bool   fPending[RENDER_STATS_QUERIES];
+static bool   fCounting   = false;
+static int    nSlot       = 0;
+static int    nPrimitives = -1;
+
+
+static void* getProcAddress(const char* name)
+{
+  if (offscreenEnabled())
+    return getOffscreenProcAddress(name);
+  return SDL_GL_GetProcAddress(name);
+}
+
+
+void setupRenderStats()
+{
+  int major = 0;
+  int minor = 0;
+  const char* version = (const char*)glGetString(GL_VERSION);
+  if (version != NULL)
+    sscanf(version, "%d.%d", &major, &minor);
+
+  fAvailable = false;
+  if (major >= 3)
+  {
+    glGenQueriesP        = (T_GenQueries)getProcAddress("glGenQueries");
+    glBeginQueryP        = (T_BeginQuery)getProcAddress("glBeginQuery");
+    glEndQueryP          = (T_EndQuery)getProcAddress("glEndQuery");
+    glGetQueryObjectuivP = (T_GetQueryObjectuiv)getProcAddress("glGetQueryObjectuiv");
+
+    fAvailable = (glGenQueriesP != NULL && glBeginQueryP != NULL
+                  && glEndQueryP != NULL && glGetQueryObjectuivP != NULL);
+  }
+
+  if (fAvailable)
+  {
+    glGenQueriesP(RENDER_STATS_QUERIES, queries);
+    for (int i = 0; i < RENDER_STATS_QUERIES; i++)
+      fPending[i] = false;
+  }
+  nPrimitives = -1;
+}
+
+
+void beginRenderStats()
+{
+  fCounting = false;
+  if (!fAvailable)
+    return;
+
+  // the oldest query should be done by now, but don't wait for it
+  if (fPending[nSlot])
+  {
+    GLuint fDone = 0;
+    glGetQueryObjectuivP(queries[nSlot], GL_QUERY_RESULT_AVAILABLE, &fDone);
+    if (!fDone)
+      return;
+
+    GLuint nResult = 0;
+    glGetQueryObjectuivP(queries[nSlot], GL_QUERY_RESULT, &nResult);
+    nPrimitives = nResult;
+    fPending[nSlot] = false;
+  }
+
+  glBeginQueryP(GL_PRIMITIVES_GENERATED, queries[nSlot]);
+  fPending[nSlot] = true;
+  fCounting       = true;
+}
+
+
+void endRenderStats()
+{
+  if (!fCounting)
+    return;
+
+  glEndQueryP(GL_PRIMITIVES_GENERATED);
+  fCounting = false;
+  nSlot = (nSlot + 1) % RENDER_STATS_QUERIES;
+}
+
+
+int getPrimitivesPerFrame()
+{
+  return nPrimitives;
+}
+
+} // end namespace Video::
@@ -0,0 +1,67 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+/** \file render_stats.h
+ *
+ *  Counts the primitives (triangles, quads, lines) which are sent to
+ *  OpenGL for the 3D scene. The OpenGL implementation counts them
+ *  with a query object, so it works for SSG as well as for the
+ *  built-in sceneries which are drawn without SSG. The result is
+ *  fetched a few frames later, without waiting for the GPU.
+ *
+ *  The terrain of the built-in sceneries alone is 163 primitives
+ *  (davis-orig) and 10 (cape_cod-orig) with textures, 150 and 5
+ *  without; the rest of the count is the sky, the models and their
+ *  shadows.
+ *
+ *  Needs OpenGL 3.0, the count stays at -1 otherwise.
+ */
+
+#ifndef RENDER_STATS_H_
+#define RENDER_STATS_H_
+
+namespace Video
+{
+
+/**
+ *  Set up the queries, after the rendering context has been created.
+ */
+void setupRenderStats();
+
+/**
+ *  Start counting the primitives of a frame.
+ */
+void beginRenderStats();
+
+/**
+ *  Stop counting the primitives of a frame.
+ */
+void endRenderStats();
+
+/**
+ *  Primitives of the last frame which has been counted, -1 if they
+ *  can't be counted.
+ */
+int getPrimitivesPerFrame();
+
+} // end namespace Video::
+
+#endif // RENDER_STATS_H_
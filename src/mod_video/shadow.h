@@ -23,6 +23,10 @@
  * 
  *  -choice of shadow algorithm
  *  -class definition of shadow volume algorithm
+ *
+ *  SHADOW_MESH makes the volume from the silhouette edges of the model
+ *  for its current attitude, see shadow_mesh.h. Drawing it is still
+ *  slower than the flat silhouette of SHADOW_VOLUME.
  */
 
 #ifndef SHADOW_H_
@@ -31,6 +35,7 @@
 //define shadow algorithm
 #define SHADOW_PROJECTION 1 // shadow projection algorithm (initial CRRCSIM algo)
 #define SHADOW_VOLUME 2     // shadow volume algorithm (new)
+#define SHADOW_MESH 3       // shadow volume for the current attitude of the model
 #define SHADOW_TYPE  SHADOW_VOLUME
 
 #if (SHADOW_TYPE==SHADOW_VOLUME)
@@ -88,5 +93,55 @@ class ShadowVolume : public ssgBranch
 };
 }// end namespace Video::
 
-#endif //(SHADOW_TYPE==SHADOW_VOLUME)
+#elif (SHADOW_TYPE==SHADOW_MESH)
+
+#include "shadow_mesh.h"
+
+namespace Video
+{
+
+class ShadowVolume : public ssgBranch
+{
+  public: 
+    /**
+     *  \param mesh  made by makeMesh(), it may be shared by several
+     *               shadows and is not deleted
+     */
+    ShadowVolume(ShadowMesh *mesh);
+    ~ShadowVolume();
+    int update(float x, float y, float z, float phi, float theta, float psi);
+
+    /// adjacency of the triangles of a model which cast a shadow
+    static ShadowMesh *makeMesh(ssgEntity *model);
+    
+  private:
+    /**
+     *  Draws the volume made by ShadowMesh. It changes every frame,
+     *  its bounding sphere covers all possible volumes instead of
+     *  being recalculated.
+     */
+    class VolumeTable : public ssgVtxTable
+    {
+      public:
+        VolumeTable(ShadowMesh::Volume *v, float r)
+          : ssgVtxTable(GL_TRIANGLES, NULL, NULL, NULL, NULL), volume(v), radius(r) {};
+        virtual void draw_geometry();
+      protected:
+        virtual void recalcBSphere();
+      private:
+        ShadowMesh::Volume *volume;
+        float radius;
+    };
+
+    ShadowMesh     *mesh;
+    ShadowMesh::Volume volume;
+    ssgEntity     *vshadow_draw;
+    ssgTransform  *vshadow_trans;
+    ssgBranch *makeShadowVolumeDraw();
+    static void collectTriangles(ssgEntity * e, sgMat4 xform,
+                                 std::vector<float>& vert, std::vector<int>& tri);
+};
+}// end namespace Video::
+
+#endif //(SHADOW_TYPE==SHADOW_MESH)
 #endif // SHADOW_H_
@@ -0,0 +1,385 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+/** \file shadow_mesh.cpp
+ *
+ *  Edge adjacency of a model for shadow volumes.
+ */
+
+#include "shadow_mesh.h"
+#include "../include_gl.h"
+
+#include <map>
+#include <algorithm>
+#include <cstdlib>
+#include <math.h>
+
+
+namespace Video
+{
+
+/**
+ *  Orders vertex indices by the position of the vertices.
+ */
+class VertexLess
+{
+  public:
+    VertexLess(const float* v) : vertices(v) {};
+
+    bool operator()(int a, int b) const
+    {
+      const float* va = vertices + 3 * a;
+      const float* vb = vertices + 3 * b;
+      if (va[0] != vb[0])
+        return va[0] < vb[0];
+      if (va[1] != vb[1])
+        return va[1] < vb[1];
+      return va[2] < vb[2];
+    };
+
+  private:
+    const float* vertices;
+};
+
+
+static inline unsigned int* putTriangle(unsigned int* out, int a, int b, int c)
+{
+  out[0] = a;
+  out[1] = b;
+  out[2] = c;
+  return out + 3;
+}
+
+
+ShadowMesh::ShadowMesh(const float* vertices, int nVertices,
+                       const int* triangles, int nTriangles,
+                       float cellSize)
+  : nClosedTriangles(0), radius(0)
+{
+  // merge the vertices in the same cell of a grid, or at the same
+  // position: sorted by the cell, each run of them is one vertex
+  std::vector<float> keys(vertices, vertices + 3 * nVertices);
+  std::vector<int>   order(nVertices);
+  std::vector<int>   merged(nVertices);
+  std::vector<int>   count;
+  if (cellSize > 0)
+  {
+    for (int i = 0; i < 3 * nVertices; i++)
+      keys[i] = floor(keys[i] / cellSize);
+  }
+  for (int i = 0; i < nVertices; i++)
+    order[i] = i;
+
+  VertexLess less(nVertices ? &keys[0] : NULL);
+  std::sort(order.begin(), order.end(), less);
+
+  for (int i = 0; i < nVertices; i++)
+  {
+    const float* v = vertices + 3 * order[i];
+    if (i == 0 || less(order[i - 1], order[i]))
+    {
+      verts.push_back(0);
+      verts.push_back(0);
+      verts.push_back(0);
+      count.push_back(0);
+    }
+    int k = count.size() - 1;
+    verts[3 * k]     += v[0];
+    verts[3 * k + 1] += v[1];
+    verts[3 * k + 2] += v[2];
+    count[k]++;
+    merged[order[i]] = k;
+  }
+
+  for (int k = 0; k < (int)count.size(); k++)
+  {
+    float* v = &verts[3 * k];
+    for (int i = 0; i < 3; i++)
+      v[i] /= count[k];
+
+    float r = sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+    if (r > radius)
+      radius = r;
+  }
+
+  // triangles with normals
+  for (int i = 0; i < nTriangles; i++)
+  {
+    T_Triangle t;
+    t.v[0] = merged[triangles[3 * i]];
+    t.v[1] = merged[triangles[3 * i + 1]];
+    t.v[2] = merged[triangles[3 * i + 2]];
+    if (t.v[0] == t.v[1] || t.v[1] == t.v[2] || t.v[2] == t.v[0])
+      continue;
+
+    const float* a = &verts[3 * t.v[0]];
+    const float* b = &verts[3 * t.v[1]];
+    const float* c = &verts[3 * t.v[2]];
+    float ab[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+    float ac[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+    t.n[0] = ab[1] * ac[2] - ab[2] * ac[1];
+    t.n[1] = ab[2] * ac[0] - ab[0] * ac[2];
+    t.n[2] = ab[0] * ac[1] - ab[1] * ac[0];
+    tris.push_back(t);
+  }
+
+  // edges: each one is shared by at most two triangles, if there
+  // are more of them the others get edges of their own
+  const int sentinel = tris.size();
+  std::map<std::pair<int, int>, int> edgeIndex;
+  std::vector<int> triEdges(3 * tris.size());
+
+  for (int i = 0; i < (int)tris.size(); i++)
+  {
+    for (int k = 0; k < 3; k++)
+    {
+      int v0 = tris[i].v[k];
+      int v1 = tris[i].v[(k + 1) % 3];
+      std::pair<int, int> key(std::min(v0, v1), std::max(v0, v1));
+
+      std::map<std::pair<int, int>, int>::iterator it = edgeIndex.find(key);
+      if (it != edgeIndex.end() && edges[it->second].t1 == sentinel)
+      {
+        T_Edge& e = edges[it->second];
+        e.t1 = i;
+        e.o1 = (e.v0 == v0) ? 1 : -1;
+        triEdges[3 * i + k] = it->second;
+      }
+      else
+      {
+        T_Edge e;
+        e.v0 = v0;
+        e.v1 = v1;
+        e.t0 = i;
+        e.t1 = sentinel;
+        e.o1 = 0;
+        triEdges[3 * i + k] = edges.size();
+        edgeIndex[key] = edges.size();
+        edges.push_back(e);
+      }
+    }
+  }
+
+  // Turn the triangles of each connected part the same way: a
+  // neighbour has to run along the common edge in the other direction.
+  // A part is closed if each of its edges has two triangles and they
+  // could all be turned that way.
+  std::vector<int> turn(tris.size(), 0);   // 1 keep, -1 turn, 0 not reached
+  std::vector<int> todo;
+
+  for (int s = 0; s < (int)tris.size(); s++)
+  {
+    if (turn[s] != 0)
+      continue;
+
+    bool fClosed = true;
+    turn[s] = 1;
+    todo.push_back(s);
+    while (!todo.empty())
+    {
+      int t = todo.back();
+      todo.pop_back();
+      tris[t].part = closed.size();
+
+      for (int k = 0; k < 3; k++)
+      {
+        const T_Edge& e = edges[triEdges[3 * t + k]];
+        if (e.t1 == sentinel)
+        {
+          fClosed = false;
+          continue;
+        }
+
+        int u = (e.t0 == t) ? e.t1 : e.t0;
+        int o = -e.o1 * turn[t];
+        if (turn[u] == 0)
+        {
+          turn[u] = o;
+          todo.push_back(u);
+        }
+        else if (turn[u] != o)
+          fClosed = false;
+      }
+    }
+    closed.push_back(fClosed);
+  }
+
+  for (int i = 0; i < (int)tris.size(); i++)
+  {
+    T_Triangle& t = tris[i];
+    if (turn[i] < 0)
+    {
+      std::swap(t.v[1], t.v[2]);
+      for (int k = 0; k < 3; k++)
+        t.n[k] = -t.n[k];
+    }
+    if (closed[t.part])
+      nClosedTriangles++;
+  }
+  for (int i = 0; i < (int)edges.size(); i++)
+  {
+    T_Edge& e = edges[i];
+    if (turn[e.t0] < 0)
+      std::swap(e.v0, e.v1);
+    if (e.t1 != sentinel)
+      e.o1 *= turn[e.t0] * turn[e.t1];
+  }
+
+}
+
+
+int ShadowMesh::makeVolume(const float light[3], float offset, float length,
+                           Volume& volume) const
+{
+  const int nVerts = verts.size();
+  const int nTris  = tris.size();
+  const int nEdges = edges.size();
+  const int far    = nVerts / 3;    // index of the first far vertex
+
+  std::vector<int>&          facing  = volume.facing;
+  std::vector<float>&        lit     = volume.lit;
+  std::vector<float>&        unlit   = volume.unlit;
+  std::vector<float>&        moved   = volume.moved;
+  std::vector<unsigned int>& indices = volume.indices;
+
+  // the first volume made from this mesh: two caps per triangle, each
+  // edge twice at most
+  facing.resize(nTris + 1, 0);
+  lit.resize(closed.size());
+  unlit.resize(closed.size());
+  moved.resize(2 * nVerts);
+  indices.resize(6 * nTris + 12 * nEdges);
+
+  // move the vertices away from the light
+  float* top    = moved.empty() ? NULL : &moved[0];
+  float* bottom = top + nVerts;
+  for (int i = 0; i < nVerts; i += 3)
+  {
+    for (int k = 0; k < 3; k++)
+    {
+      top[i + k]    = verts[i + k] - offset * light[k];
+      bottom[i + k] = verts[i + k] - length * light[k];
+    }
+  }
+
+  // How much of each part faces the light, and how much faces away.
+  // A part casts the shadow of the side which covers more: the lit
+  // side of a closed part, the unlit triangles are inside its volume.
+  // The other side of an open part may be the one which faces the
+  // light, if the triangles could have been turned the other way.
+  for (int i = 0; i < (int)closed.size(); i++)
+  {
+    lit[i]   = 0;
+    unlit[i] = 0;
+  }
+  for (int i = 0; i < nTris; i++)
+  {
+    const float* n = tris[i].n;
+    float        d = n[0] * light[0] + n[1] * light[1] + n[2] * light[2];
+    if (d >= 0)
+    {
+      lit[tris[i].part] += d;
+      facing[i] = 1;
+    }
+    else
+    {
+      unlit[tris[i].part] -= d;
+      facing[i] = -1;
+    }
+  }
+  for (int i = 0; i < nTris; i++)
+  {
+    int k = tris[i].part;
+    if (closed[k] || lit[k] >= unlit[k])
+      facing[i] = (facing[i] > 0) ? 1 : 0;
+    else
+      facing[i] = (facing[i] < 0) ? -1 : 0;
+  }
+
+  // caps of the triangles which cast a shadow
+  unsigned int* p = indices.empty() ? NULL : &indices[0];
+  for (int i = 0; i < nTris; i++)
+  {
+    if (facing[i] == 0)
+      continue;
+
+    const int* v = tris[i].v;
+    int        a = v[0];
+    int        b = (facing[i] > 0) ? v[1] : v[2];
+    int        c = (facing[i] > 0) ? v[2] : v[1];
+
+    p = putTriangle(p, a, b, c);
+    p = putTriangle(p, far + a, far + c, far + b);
+  }
+
+  // quads of the edges which don't cancel out: +1/-1 between a lit
+  // and an unlit triangle and at the border of an open part, +2/-2
+  // where two triangles which couldn't be turned the same way meet
+  volume.nSilhouetteQuads = 0;
+  for (int i = 0; i < nEdges; i++)
+  {
+    const T_Edge& e = edges[i];
+    int n = facing[e.t0] + e.o1 * facing[e.t1];
+    if (n == 0)
+      continue;
+
+    int v0 = (n > 0) ? e.v0 : e.v1;
+    int v1 = (n > 0) ? e.v1 : e.v0;
+
+    for (n = abs(n); n > 0; n--)
+    {
+      p = putTriangle(p, v0, far + v0, far + v1);
+      p = putTriangle(p, v0, far + v1, v1);
+      volume.nSilhouetteQuads++;
+    }
+  }
+
+  volume.nIndices = p - (indices.empty() ? NULL : &indices[0]);
+  return volume.nIndices / 3;
+}
+
+
+void ShadowMesh::Volume::draw() const
+{
+  if (nIndices == 0)
+    return;
+
+  glEnableClientState(GL_VERTEX_ARRAY);
+  glVertexPointer(3, GL_FLOAT, 0, &moved[0]);
+  glDrawElements(GL_TRIANGLES, nIndices, GL_UNSIGNED_INT, &indices[0]);
+  glDisableClientState(GL_VERTEX_ARRAY);
+}
+
+
+int ShadowMesh::Volume::getTriangles(std::vector<float>& out) const
+{
+  out.resize(3 * nIndices);
+  for (int i = 0; i < nIndices; i++)
+  {
+    const float* v = &moved[3 * indices[i]];
+    out[3 * i]     = v[0];
+    out[3 * i + 1] = v[1];
+    out[3 * i + 2] = v[2];
+  }
+  return nIndices;
+}
+
+} // end namespace Video::
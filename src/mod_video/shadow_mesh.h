@@ -0,0 +1,175 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+/** \file shadow_mesh.h
+ *
+ *  Edge adjacency of a model for shadow volumes.
+ *
+ *  The triangles of each connected part of the model are turned the
+ *  same way when the adjacency is built. Each triangle of a part which
+ *  faces the light casts a prism: the triangle itself (near cap), the
+ *  triangle moved away from the light (far cap) and one quad for each
+ *  edge. The quads between two lit triangles cancel out and are left
+ *  away, what is left are the quads of the silhouette edges between a
+ *  lit and an unlit triangle. The unlit triangles of a closed part are
+ *  inside this volume and cast nothing.
+ *
+ *  An open part (a surface with borders, or one which can't be turned
+ *  consistently) has no inside, its triangles may have been turned
+ *  away from the light. It casts the shadow of the side which covers
+ *  more, seen from the light, with quads at its borders too. The
+ *  volume has to be counted with increments and decrements in the
+ *  stencil buffer: points in the shadow of several parts are inside
+ *  several prisms.
+ *
+ *  The grid which merges the vertices closes small gaps between the
+ *  parts and drops details which don't show in the shadow.
+ *
+ *  The adjacency is built once per model, each frame only needs one
+ *  linear pass over the vertices, triangles and edges. The volume is
+ *  drawn with indices into the vertices moved to the near and the
+ *  far cap, so the caps don't need vertices of their own and the
+ *  quads share their corners exactly.
+ */
+
+#ifndef SHADOW_MESH_H_
+#define SHADOW_MESH_H_
+
+#include <vector>
+
+namespace Video
+{
+
+class ShadowMesh
+{
+  public:
+    /**
+     *  Build the adjacency. The vertices in the same cell of a grid
+     *  are merged, or those at the same position if there is no grid,
+     *  triangles which degenerate are dropped.
+     *
+     *  \param vertices    x, y, z of each vertex
+     *  \param nVertices   number of vertices
+     *  \param triangles   three vertex indices per triangle
+     *  \param nTriangles  number of triangles
+     *  \param cellSize    size of the grid cells, 0 for no grid
+     */
+    ShadowMesh(const float* vertices, int nVertices,
+               const int* triangles, int nTriangles,
+               float cellSize = 0);
+
+    /**
+     *  A volume made by makeVolume(), kept between frames. The mesh
+     *  may be shared by several shadows, each of them has a volume of
+     *  its own.
+     */
+    class Volume
+    {
+      public:
+        Volume() : nIndices(0), nSilhouetteQuads(0) {};
+
+        /**
+         *  Draw the volume as triangles, in the current OpenGL state.
+         */
+        void draw() const;
+
+        /**
+         *  Triangles of the volume, the way draw() draws them.
+         *
+         *  \param out  x, y, z of each vertex, replaced
+         *  \return number of vertices
+         */
+        int getTriangles(std::vector<float>& out) const;
+
+        /// number of silhouette quads
+        int getNumSilhouetteQuads() const { return nSilhouetteQuads; };
+
+      private:
+        friend class ShadowMesh;
+
+        std::vector<int>          facing;    ///< per triangle +1 lit, -1 turned to the light, 0 casting nothing (and the sentinel)
+        std::vector<float>        lit;       ///< per part twice the area facing the light, seen from the light
+        std::vector<float>        unlit;     ///< per part twice the area facing away from it
+        std::vector<float>        moved;     ///< vertices moved to the near cap, then to the far cap
+        std::vector<unsigned int> indices;   ///< triangles of the volume, into moved
+        int                       nIndices;
+        int                       nSilhouetteQuads;
+    };
+
+    /**
+     *  Make the shadow volume for a direction of the light.
+     *
+     *  \param light   unit vector towards the light, in model coordinates
+     *  \param offset  distance of the near cap from the model
+     *  \param length  distance of the far cap from the model
+     *  \param volume  replaced by the new volume
+     *  \return number of triangles of the volume
+     */
+    int makeVolume(const float light[3], float offset, float length,
+                   Volume& volume) const;
+
+    /// number of triangles of the model
+    int getNumTriangles() const { return (int)tris.size(); };
+
+    /// number of triangles in closed parts of the model
+    int getNumClosedTriangles() const { return nClosedTriangles; };
+
+    /// number of edges
+    int getNumEdges() const { return (int)edges.size(); };
+
+    /// radius of a sphere around the origin which contains the model
+    float getRadius() const { return radius; };
+
+  private:
+    /**
+     *  An edge and the triangles next to it
+     */
+    typedef struct
+    {
+      int v0;   ///< first vertex, in the order of t0
+      int v1;   ///< second vertex
+      int t0;   ///< first triangle
+      int t1;   ///< second triangle, the sentinel if there is none
+      int o1;   ///< 1 if t1 runs from v0 to v1, -1 if from v1 to v0, 0 if none
+    } T_Edge;
+
+    /**
+     *  A triangle
+     */
+    typedef struct
+    {
+      int   v[3];   ///< vertices
+      float n[3];   ///< normal (not normalized)
+      int   part;   ///< connected part of the model
+    } T_Triangle;
+
+    std::vector<float>      verts;    ///< x, y, z of the merged vertices
+    std::vector<T_Triangle> tris;
+    std::vector<T_Edge>     edges;
+    std::vector<bool>       closed;   ///< per part: no borders, all triangles turned the same way
+
+    int   nClosedTriangles;
+    float radius;
+};
+
+} // end namespace Video::
+
+#endif // SHADOW_MESH_H_
@@ -0,0 +1,754 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+/**
+ * \file shadow_mesh_test.cpp
+ *
+ * Compares the shadow volumes of ShadowMesh to the way the shadow
+ * used to be made: all triangles of the model were projected onto a
+ * horizontal plane and merged by the GLU tessellator once per model.
+ * For every frame, ShadowVolume::update() only sheared this flat
+ * silhouette towards the light, so the shadow didn't follow the
+ * attitude of the model. The "baseline" is the time of that update
+ * and of drawing its volume, "new" is the time of makeVolume() and
+ * of drawing the volume for the current attitude. The old volume
+ * reached 10000 ft down, the new one only a little below the ground.
+ * SHADOW_MESH (shadow.h) should only become the default shadow when
+ * "new" takes less time than "baseline".
+ *
+ * Usage: shadow_test [-n frames] file.ac [file.ac ...]
+ *
+ * The models are read from AC3D files, the light is turned around
+ * the model from frame to frame. Every volume has to be a closed
+ * surface: each edge of its triangles has to be used once in each
+ * direction. The return value is the number of volumes which are
+ * not closed.
+ *
+ * The volumes are drawn into the stencil buffer of an EGL pbuffer
+ * the way the simulation draws them, over a ground plane below the
+ * model, if the test is built with SHADOW_TEST_EGL. Otherwise only
+ * the time of the updates is measured.
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+#include <math.h>
+
+#include "../include_gl.h"
+#include "shadow_mesh.h"
+
+#ifdef SHADOW_TEST_EGL
+# include "offscreen.h"
+# include "../mod_misc/SimpleXMLTransfer.h"
+#endif
+
+#define TEST_OFFSET  (0.01f)
+#define TEST_LENGTH  (10000.0f)
+/// the vertices are merged on a grid of the radius / TEST_CELLS, as
+/// LOD_CELLS in airplane_vis.cpp
+#define TEST_CELLS   (16)
+
+/// size of the pbuffer
+#define TEST_WIDTH   (800)
+#define TEST_HEIGHT  (600)
+
+#ifndef APIENTRY
+# define APIENTRY
+#endif
+
+
+/**
+ * A model as a triangle soup
+ */
+typedef struct
+{
+  std::vector<float> vertices;
+  std::vector<int>   triangles;
+} T_Model;
+
+
+/**
+ * Reads the polygons of an AC3D file and splits them into triangles.
+ * Returns false if the file can't be read.
+ */
+static bool loadAC(const char* filename, T_Model& model)
+{
+  FILE* fp = fopen(filename, "r");
+  if (fp == NULL)
+    return false;
+
+  // translation of the current object and its parents
+  std::vector<float> loc(3, 0.0f);
+  std::vector<int>   kidsLeft;  // of the objects above the current one
+  std::vector<float> locStack;
+  int                base = 0;
+  char               line[1024];
+
+  while (fgets(line, sizeof(line), fp) != NULL)
+  {
+    char  word[32] = "";
+    sscanf(line, "%31s", word);
+
+    if (strcmp(word, "OBJECT") == 0)
+    {
+      // leave the objects which are complete
+      while (!kidsLeft.empty() && kidsLeft.back() == 0)
+      {
+        kidsLeft.pop_back();
+        loc.assign(locStack.end() - 3, locStack.end());
+        locStack.resize(locStack.size() - 3);
+      }
+      if (!kidsLeft.empty())
+        kidsLeft.back()--;
+      locStack.insert(locStack.end(), loc.begin(), loc.end());
+      kidsLeft.push_back(0);
+    }
+    else if (strcmp(word, "loc") == 0)
+    {
+      float x, y, z;
+      sscanf(line, "%*s %f %f %f", &x, &y, &z);
+      loc[0] = locStack[locStack.size() - 3] + x;
+      loc[1] = locStack[locStack.size() - 2] + y;
+      loc[2] = locStack[locStack.size() - 1] + z;
+    }
+    else if (strcmp(word, "data") == 0)
+    {
+      int n = 0;
+      sscanf(line, "%*s %d", &n);
+      for (int i = 0; i < n + 1; i++)
+        fgetc(fp);
+    }
+    else if (strcmp(word, "numvert") == 0)
+    {
+      int n = 0;
+      sscanf(line, "%*s %d", &n);
+      base = model.vertices.size() / 3;
+      for (int i = 0; i < n && fgets(line, sizeof(line), fp) != NULL; i++)
+      {
+        float v[3];
+        sscanf(line, "%f %f %f", &v[0], &v[1], &v[2]);
+        for (int k = 0; k < 3; k++)
+          model.vertices.push_back(v[k] + loc[k]);
+      }
+    }
+    else if (strcmp(word, "SURF") == 0)
+    {
+      unsigned int flags = 0;
+      sscanf(line, "%*s %x", &flags);
+
+      std::vector<int> refs;
+      while (fgets(line, sizeof(line), fp) != NULL)
+      {
+        sscanf(line, "%31s", word);
+        if (strcmp(word, "refs") == 0)
+        {
+          int n = 0;
+          sscanf(line, "%*s %d", &n);
+          for (int i = 0; i < n && fgets(line, sizeof(line), fp) != NULL; i++)
+            refs.push_back(base + atoi(line));
+          break;
+        }
+      }
+
+      // polygons only, no lines
+      if ((flags & 0x0F) == 0)
+      {
+        for (unsigned int i = 2; i < refs.size(); i++)
+        {
+          model.triangles.push_back(refs[0]);
+          model.triangles.push_back(refs[i - 1]);
+          model.triangles.push_back(refs[i]);
+        }
+      }
+    }
+    else if (strcmp(word, "kids") == 0)
+    {
+      int n = 0;
+      sscanf(line, "%*s %d", &n);
+      kidsLeft.back() = n;
+    }
+  }
+
+  fclose(fp);
+  return true;
+}
+
+
+/**
+ * Unit vector towards the light for a frame: turns around the model
+ * and goes up and down.
+ */
+static void getLight(int nFrame, float light[3])
+{
+  double a = nFrame * 0.37;
+  double e = 0.8 * sin(nFrame * 0.11);
+  light[0] = cos(a) * cos(e);
+  light[1] = sin(e);
+  light[2] = sin(a) * cos(e);
+}
+
+
+/**
+ * Unit vector towards the sun for a frame: turns around the model,
+ * 25 to 75 degrees above the horizon.
+ */
+static void getSun(int nFrame, float light[3])
+{
+  double a = nFrame * 0.37;
+  double e = 0.87 + 0.44 * sin(nFrame * 0.11);
+  light[0] = cos(a) * cos(e);
+  light[1] = sin(e);
+  light[2] = sin(a) * cos(e);
+}
+
+
+/**
+ * Length of the new volume for the sun: it reaches a radius below the
+ * ground plane of drawGround(), the way ShadowVolume::update() makes
+ * it reach below the scenery.
+ */
+static float getLength(const float light[3], float radius)
+{
+  float d = 5 * radius;
+  if (d >= TEST_LENGTH * light[1])
+    return TEST_LENGTH;
+  return d / light[1];
+}
+
+
+/**
+ * Wall clock time in seconds, the drawing may not run on this thread.
+ */
+static double getSeconds()
+{
+#ifdef SHADOW_TEST_EGL
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + 1e-9 * ts.tv_nsec;
+#else
+  return (double)clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+
+/**
+ * Counts the edges of a volume which are not used once in each
+ * direction.
+ */
+static int countOpenEdges(const float* vertices, int nVertices)
+{
+  typedef std::vector<float>                    T_Pos;
+  std::map<std::pair<T_Pos, T_Pos>, int>        edges;
+  std::map<std::pair<T_Pos, T_Pos>, int>::iterator it;
+  int                                           nOpen = 0;
+
+  for (int t = 0; t < nVertices; t += 3)
+  {
+    for (int k = 0; k < 3; k++)
+    {
+      const float* a = vertices + 3 * (t + k);
+      const float* b = vertices + 3 * (t + (k + 1) % 3);
+      T_Pos        pa(a, a + 3);
+      T_Pos        pb(b, b + 3);
+      // far away vertices may end up at the same position
+      if (pa < pb)
+        edges[std::make_pair(pa, pb)]++;
+      else if (pb < pa)
+        edges[std::make_pair(pb, pa)]--;
+    }
+  }
+
+  for (it = edges.begin(); it != edges.end(); ++it)
+  {
+    if (it->second != 0)
+      nOpen++;
+  }
+  return nOpen;
+}
+
+
+/**
+ * The old silhouette: all triangles are projected onto the plane
+ * perpendicular to the light and merged by the tessellator.
+ */
+class OldSilhouette
+{
+  public:
+    OldSilhouette(T_Model const& m) : model(m) {};
+
+    /// returns the number of vertices of the outline
+    int make(const float light[3]);
+
+    /// two coordinates in the plane per vertex
+    std::vector<float> const& getOutline() const { return outline; };
+
+    /// first vertex of each contour of the outline
+    std::vector<int> const& getContours() const { return contours; };
+
+  private:
+    static void APIENTRY beginCallback(GLenum, OldSilhouette* sh);
+    static void APIENTRY vertexCallback(GLdouble* v, OldSilhouette* sh);
+    static void APIENTRY combineCallback(GLdouble coords[3], void* vertex_data[4],
+                                         GLfloat weight[4], GLdouble** dataOut,
+                                         OldSilhouette* sh);
+
+    typedef struct
+    {
+      GLdouble v[3];
+    } T_Vertex;
+
+    T_Model const&        model;
+    std::vector<GLdouble> projected;
+    std::deque<T_Vertex>  combined;   ///< doesn't move when growing
+    std::vector<float>    outline;
+    std::vector<int>      contours;
+};
+
+
+void APIENTRY OldSilhouette::beginCallback(GLenum, OldSilhouette* sh)
+{
+  sh->contours.push_back(sh->outline.size() / 2);
+}
+
+
+void APIENTRY OldSilhouette::vertexCallback(GLdouble* v, OldSilhouette* sh)
+{
+  sh->outline.push_back(v[0]);
+  sh->outline.push_back(v[1]);
+}
+
+
+void APIENTRY OldSilhouette::combineCallback(GLdouble coords[3], void**, GLfloat*,
+                                             GLdouble** dataOut, OldSilhouette* sh)
+{
+  T_Vertex vertex;
+  vertex.v[0] = coords[0];
+  vertex.v[1] = coords[1];
+  vertex.v[2] = coords[2];
+  sh->combined.push_back(vertex);
+  *dataOut = sh->combined.back().v;
+}
+
+
+int OldSilhouette::make(const float light[3])
+{
+  // two axes in the plane
+  float u[3] = { -light[1], light[0], 0 };
+  if (fabs(light[2]) > 0.9)
+  {
+    u[0] = 0;
+    u[1] = -light[2];
+    u[2] = light[1];
+  }
+  float len = sqrt(u[0] * u[0] + u[1] * u[1] + u[2] * u[2]);
+  u[0] /= len;
+  u[1] /= len;
+  u[2] /= len;
+  float w[3] = { light[1] * u[2] - light[2] * u[1],
+                 light[2] * u[0] - light[0] * u[2],
+                 light[0] * u[1] - light[1] * u[0] };
+
+  int nTris = model.triangles.size() / 3;
+  projected.resize(9 * nTris);
+  combined.clear();
+  outline.clear();
+  contours.clear();
+
+  GLUtesselator* tobj = gluNewTess();
+  gluTessProperty(tobj, GLU_TESS_BOUNDARY_ONLY, GL_TRUE);
+  gluTessProperty(tobj, GLU_TESS_WINDING_RULE, GLU_TESS_WINDING_NONZERO);
+  gluTessProperty(tobj, GLU_TESS_TOLERANCE, 0.01);
+  gluTessNormal(tobj, 0, 0, 1);
+  gluTessCallback(tobj, GLU_TESS_BEGIN_DATA,   (void (APIENTRY*) ()) beginCallback);
+  gluTessCallback(tobj, GLU_TESS_VERTEX_DATA,  (void (APIENTRY*) ()) vertexCallback);
+  gluTessCallback(tobj, GLU_TESS_COMBINE_DATA, (void (APIENTRY*) ()) combineCallback);
+
+  gluTessBeginPolygon(tobj, this);
+  for (int t = 0; t < nTris; t++)
+  {
+    GLdouble* p = &projected[9 * t];
+    for (int k = 0; k < 3; k++)
+    {
+      const float* v = &model.vertices[3 * model.triangles[3 * t + k]];
+      p[3 * k]     = v[0] * u[0] + v[1] * u[1] + v[2] * u[2];
+      p[3 * k + 1] = v[0] * w[0] + v[1] * w[1] + v[2] * w[2];
+      p[3 * k + 2] = 0;
+    }
+
+    // counterclockwise
+    double cross = (p[3] - p[0]) * (p[7] - p[1]) - (p[4] - p[1]) * (p[6] - p[0]);
+    if (cross == 0)
+      continue;
+    int b = (cross > 0) ? 1 : 2;
+    int c = (cross > 0) ? 2 : 1;
+
+    gluTessBeginContour(tobj);
+    gluTessVertex(tobj, p, p);
+    gluTessVertex(tobj, p + 3 * b, p + 3 * b);
+    gluTessVertex(tobj, p + 3 * c, p + 3 * c);
+    gluTessEndContour(tobj);
+  }
+  gluTessEndPolygon(tobj);
+  gluDeleteTess(tobj);
+
+  return outline.size() / 2;
+}
+
+
+/**
+ * The old shadow volume: the outline of the model seen from above,
+ * made once. Each contour is closed by a polygon at the top and a
+ * triangle fan to a point far below.
+ */
+class OldVolume
+{
+  public:
+    OldVolume(T_Model const& model);
+
+    /// what ShadowVolume::update() did besides the attitude
+    void update(const float light[3]);
+
+    /// draws the volume without face culling, as SSG did
+    void draw() const;
+
+    int getNumVertices() const { return outline.size() / 3; };
+
+  private:
+    std::vector<float> outline;    ///< x, y, z
+    std::vector<int>   contours;   ///< first vertex of each contour and the end
+    float              shear[16];  ///< leans the volume away from the light
+    float              bottom[3];  ///< the point far below
+};
+
+
+OldVolume::OldVolume(T_Model const& model)
+{
+  const float   up[3] = { 0, 1, 0 };
+  OldSilhouette sil(model);
+  sil.make(up);
+
+  // the plane's axes for this light are -x and z
+  std::vector<float> const& o = sil.getOutline();
+  for (unsigned int i = 0; i < o.size(); i += 2)
+  {
+    outline.push_back(-o[i]);
+    outline.push_back(0);
+    outline.push_back(o[i + 1]);
+  }
+  contours = sil.getContours();
+  contours.push_back(outline.size() / 3);
+
+  for (int i = 0; i < 16; i++)
+    shear[i] = (i % 5 == 0) ? 1 : 0;
+}
+
+
+void OldVolume::update(const float light[3])
+{
+  bottom[0] = 0;
+  bottom[1] = -TEST_LENGTH;
+  bottom[2] = 0;
+  shear[4] = -light[0] / light[1];
+  shear[6] = -light[2] / light[1];
+}
+
+
+void OldVolume::draw() const
+{
+  glPushMatrix();
+  glMultMatrixf(shear);
+  for (unsigned int c = 0; c + 1 < contours.size(); c++)
+  {
+    glBegin(GL_POLYGON);
+    for (int i = contours[c]; i < contours[c + 1]; i++)
+      glVertex3fv(&outline[3 * i]);
+    glEnd();
+
+    glBegin(GL_TRIANGLE_FAN);
+    glVertex3fv(bottom);
+    for (int i = contours[c]; i < contours[c + 1]; i++)
+      glVertex3fv(&outline[3 * i]);
+    glVertex3fv(&outline[3 * contours[c]]);
+    glEnd();
+  }
+  glPopMatrix();
+}
+
+
+#ifdef SHADOW_TEST_EGL
+/// offscreen.cpp reads its configuration from here, the simulation
+/// sets it up in config.cpp
+SimpleXMLTransfer* cfgfile = NULL;
+
+/**
+ * Makes an OpenGL context with a stencil buffer, without a display
+ * server. Returns false if there is none.
+ */
+static bool createContext()
+{
+  GLint nStencilBits = 0;
+
+  if (!Video::createOffscreenContext(TEST_WIDTH, TEST_HEIGHT))
+    return false;
+  glGetIntegerv(GL_STENCIL_BITS, &nStencilBits);
+  return (nStencilBits > 0);
+}
+
+
+/**
+ * Clears the pbuffer and draws the ground below the model, seen from
+ * a little above the model.
+ */
+static void drawGround(float radius)
+{
+  glViewport(0, 0, TEST_WIDTH, TEST_HEIGHT);
+  glMatrixMode(GL_PROJECTION);
+  glLoadIdentity();
+  glFrustum(-0.5 * radius, 0.5 * radius, -0.375 * radius, 0.375 * radius,
+            radius, 2 * TEST_LENGTH);
+  glMatrixMode(GL_MODELVIEW);
+  glLoadIdentity();
+  glTranslatef(0, 0, -4 * radius);
+  glRotatef(20, 1, 0, 0);
+
+  glStencilMask(0xff);
+  glDepthMask(1);
+  glColorMask(1, 1, 1, 1);
+  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+  glEnable(GL_DEPTH_TEST);
+  glDisable(GL_STENCIL_TEST);
+  glDisable(GL_CULL_FACE);
+
+  float y = -3 * radius;
+  float d = TEST_LENGTH;
+  glBegin(GL_QUADS);
+  glVertex3f(-d, y, -d);
+  glVertex3f(-d, y,  d);
+  glVertex3f( d, y,  d);
+  glVertex3f( d, y, -d);
+  glEnd();
+
+  // the state of the shadow volume passes
+  glColorMask(0, 0, 0, 0);
+  glDepthMask(0);
+  glEnable(GL_STENCIL_TEST);
+  glStencilFunc(GL_ALWAYS, 0, 0);
+  glFinish();
+}
+
+
+/**
+ * Time of drawing the old volume, the way its state callbacks did:
+ * inverting the stencil, both faces at once.
+ */
+static double drawOld(OldVolume& old, int nFrames, float radius)
+{
+  double dDraw = 0;
+
+  for (int f = 0; f < nFrames; f++)
+  {
+    float light[3];
+    getSun(f, light);
+    old.update(light);
+    drawGround(radius);
+
+    double start = getSeconds();
+    glStencilOp(GL_KEEP, GL_KEEP, GL_INVERT);
+    old.draw();
+    glFinish();
+    dDraw += getSeconds() - start;
+  }
+  return dDraw;
+}
+
+
+/**
+ * Time of drawing the new volume, the way its state callbacks do:
+ * incrementing on front faces, decrementing on back faces.
+ */
+static double drawNew(Video::ShadowMesh& mesh, int nFrames, float radius)
+{
+  Video::ShadowMesh::Volume volume;
+  double                    dDraw = 0;
+
+  for (int f = 0; f < nFrames; f++)
+  {
+    float light[3];
+    getSun(f, light);
+    mesh.makeVolume(light, TEST_OFFSET, getLength(light, radius), volume);
+    drawGround(radius);
+
+    double start = getSeconds();
+    glEnable(GL_CULL_FACE);
+    glCullFace(GL_BACK);
+    glStencilOp(GL_KEEP, GL_KEEP, GL_INCR);
+    volume.draw();
+    glCullFace(GL_FRONT);
+    glStencilOp(GL_KEEP, GL_KEEP, GL_DECR);
+    volume.draw();
+    glFinish();
+    dDraw += getSeconds() - start;
+  }
+  return dDraw;
+}
+#endif
+
+
+/**
+ * Runs the test on one model, returns the number of volumes which are
+ * not closed.
+ */
+static int testModel(const char* filename, int nFrames, bool fDraw)
+{
+  T_Model model;
+  if (!loadAC(filename, model))
+  {
+    printf("%s: unable to read\n", filename);
+    return 1;
+  }
+
+  float radius = 0;
+  for (unsigned int i = 0; i < model.vertices.size(); i += 3)
+  {
+    const float* v = &model.vertices[i];
+    float        r = sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+    if (r > radius)
+      radius = r;
+  }
+
+  double start = getSeconds();
+  Video::ShadowMesh mesh(&model.vertices[0], model.vertices.size() / 3,
+                         &model.triangles[0], model.triangles.size() / 3,
+                         radius / TEST_CELLS);
+  double dBuild = getSeconds() - start;
+
+  OldVolume                 old(model);
+  Video::ShadowMesh::Volume volume;
+  std::vector<float>        triangles;
+  double                    dOld       = 0;
+  double                    dNew       = 0;
+  double                    dOldDraw   = 0;
+  double                    dNewDraw   = 0;
+  long                      nQuads     = 0;
+  long                      nTriangles = 0;
+  int                       nErrors    = 0;
+
+  start = getSeconds();
+  for (int f = 0; f < nFrames; f++)
+  {
+    float light[3];
+    getSun(f, light);
+    old.update(light);
+  }
+  dOld = getSeconds() - start;
+
+  for (int f = 0; f < nFrames; f++)
+  {
+    float light[3];
+    getSun(f, light);
+    start = getSeconds();
+    nTriangles += mesh.makeVolume(light, TEST_OFFSET,
+                                  getLength(light, mesh.getRadius()), volume);
+    dNew += getSeconds() - start;
+    nQuads += volume.getNumSilhouetteQuads();
+  }
+
+#ifdef SHADOW_TEST_EGL
+  if (fDraw)
+  {
+    dOldDraw = drawOld(old, nFrames, mesh.getRadius());
+    dNewDraw = drawNew(mesh, nFrames, mesh.getRadius());
+  }
+#endif
+
+  // check some of the volumes, with the light from all directions
+  for (int f = 0; f < nFrames; f += 16)
+  {
+    float light[3];
+    getLight(f, light);
+    mesh.makeVolume(light, TEST_OFFSET, TEST_LENGTH, volume);
+    int nVertices = volume.getTriangles(triangles);
+    int nOpen     = countOpenEdges(&triangles[0], nVertices);
+    if (nOpen != 0)
+    {
+      printf("  frame %d: %d open edges\n", f, nOpen);
+      nErrors++;
+    }
+  }
+
+  printf("%s: %d triangles (%d in closed parts), %d edges, adjacency built in %.2f ms\n",
+         filename, mesh.getNumTriangles(), mesh.getNumClosedTriangles(),
+         mesh.getNumEdges(), 1e3 * dBuild);
+  if (fDraw)
+  {
+    printf("  baseline %8.2f us update + %8.1f us draw per frame, %d outline vertices\n",
+           1e6 * dOld / nFrames, 1e6 * dOldDraw / nFrames, old.getNumVertices());
+    printf("  new      %8.2f us update + %8.1f us draw per frame, %ld triangles, %ld silhouette quads\n",
+           1e6 * dNew / nFrames, 1e6 * dNewDraw / nFrames, nTriangles / nFrames, nQuads / nFrames);
+  }
+  else
+  {
+    printf("  baseline %8.2f us update per frame, %d outline vertices, not drawn\n",
+           1e6 * dOld / nFrames, old.getNumVertices());
+    printf("  new      %8.2f us update per frame, %ld triangles, %ld silhouette quads, not drawn\n",
+           1e6 * dNew / nFrames, nTriangles / nFrames, nQuads / nFrames);
+  }
+
+  return nErrors;
+}
+
+
+int main(int argc, char** argv)
+{
+  int nFrames = 100;
+  int nErrors = 0;
+  int i       = 1;
+
+  if (argc > 2 && strcmp(argv[1], "-n") == 0)
+  {
+    nFrames = atoi(argv[2]);
+    if (nFrames < 1)
+      nFrames = 1;
+    i = 3;
+  }
+  if (i >= argc)
+  {
+    printf("Usage: %s [-n frames] file.ac [file.ac ...]\n", argv[0]);
+    return 1;
+  }
+
+  bool fDraw = false;
+#ifdef SHADOW_TEST_EGL
+  fDraw = createContext();
+  if (!fDraw)
+    printf("No OpenGL context, the volumes are not drawn\n");
+#endif
+
+  for (; i < argc; i++)
+    nErrors += testModel(argv[i], nFrames, fDraw);
+
+  return nErrors;
+}
@@ -0,0 +1,346 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *
+ * Copyright (C) 2011 JOel Lienard (original author)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+  
+/** \file shadow_mesh_volume.cpp
+ * 
+ *  Shadow volume made from the silhouette edges of the model for its
+ *  current attitude (SHADOW_TYPE SHADOW_MESH), see shadow_volume.cpp
+ *  for the flat silhouette made once (SHADOW_VOLUME).
+ *
+ */
+ 
+/*
+*silhouette :
+  -The adjacency of the triangles is built once per model (ShadowMesh), on a grid of the size of the
+   coarse copy of the model. For every frame the silhouette edges for the current attitude of the model
+   are extracted in one pass over the edges, so the shadow follows the attitude of the model.
+  -The volume is drawn from the vertices moved to both caps with indices, the caps need no vertices
+   of their own.
+  -The volume is counted in the stencil buffer (increment on front faces, decrement on back faces), the
+   models may have open parts, see shadow_mesh.h.
+  -The volume reaches a little below the ground under the model instead of VOLUME_LENGTH.
+
+*Drawing this volume is still slower than the flat silhouette of SHADOW_VOLUME (shadow_mesh_test),
+ which is why SHADOW_VOLUME is the default.
+*/
+
+
+#include <vector>
+#include <math.h>
+#include "crrc_ssgutils.h"
+#include "crrc_graphics.h"
+#include "shadow.h"
+#if (SHADOW_TYPE==SHADOW_MESH)
+#include "../global.h"
+#include "../mod_landscape/crrc_scenery.h"
+
+#define VOLUME_LENGTH 10000 // " #infinity"   
+
+#define VOLUME_MARGIN 50 /*The volume reaches this much (ft) below the ground under the model, where the ground falls away under the shadow. */
+
+#define SHADOW_CELLS 16 // vertices closer than the radius / SHADOW_CELLS are merged, as LOD_CELLS of airplane_vis.cpp
+
+#define CAP_OFFSET  .01 /*The volume starts slightly below the model to avoid self-shadowing of the lit faces. Do not put too much, otherwise lacks of shadow right below the model. */
+
+#define SHADOW_VOLUME_VISIBLE 0 // 1 to see the shadowVolume (TEST)
+
+namespace Video
+{
+extern sgVec3     lightposn;
+
+/*************************************/
+static void shadowVolumeStencilSetup()
+{
+  glStencilMask(0xff);
+#if (!SHADOW_VOLUME_VISIBLE)
+  glColorMask(0,0,0,0);
+#endif
+  glEnable(GL_STENCIL_TEST);
+  glDepthMask(0);
+  glStencilFunc(GL_ALWAYS, 0, 0);
+  glEnable( GL_CULL_FACE );
+}
+
+//front faces of the volume
+int PredrawCallback1(ssgState*)
+{
+  shadowVolumeStencilSetup();
+  glCullFace(GL_BACK);
+  glStencilOp(GL_KEEP, GL_KEEP, GL_INCR);
+  return 0;
+}
+
+//back faces of the volume
+int PredrawCallback1b(ssgState*)
+{
+  shadowVolumeStencilSetup();
+  glCullFace(GL_FRONT);
+  glStencilOp(GL_KEEP, GL_KEEP, GL_DECR);
+  return 0;
+}
+
+int PostdrawCallback1(ssgState*)
+{
+  glCullFace(GL_BACK);
+  glDisable(GL_STENCIL_TEST);
+  glColorMask(1,1,1,1);
+  glDepthMask(1);
+
+  return 0;
+}
+/*************************************/
+/*************************************/
+int shadowVolumePredrawCallback2(ssgState*)
+{
+  glStencilMask(0xff);
+  glDisable(GL_DEPTH_TEST);
+  glEnable(GL_STENCIL_TEST);
+  //draw where the count is not zero and clear it for the next model
+  glStencilFunc(GL_NOTEQUAL, 0, 0xff);
+  glStencilOp(GL_KEEP, GL_ZERO, GL_ZERO);
+  glDisable( GL_CULL_FACE );///
+  return 0;
+}
+int shadowVolumePostdrawCallback2(ssgState*)
+{
+  glEnable(GL_DEPTH_TEST);
+  glDisable(GL_STENCIL_TEST);
+  return 0;
+}
+/**************************************/
+/******************************/
+ssgBranch *ShadowVolume::makeShadowVolumeDraw()
+//pour mettre de l'ombre la ou le volume d'ombre à mis des marques dans le stencil
+//il suffirait de dessiner un rectangle sur tout l'écran
+// on met un cube pour ne pas changer la vue (TODO ??)
+{
+	ssgBranch *branch;
+	branch = new ssgBranch();
+	ssgSimpleState *state2 = new ssgSimpleState ;
+  state2->disable( GL_CULL_FACE );
+  state2->disable(GL_COLOR_MATERIAL);
+  state2->disable(GL_TEXTURE_2D);
+  state2->enable(GL_LIGHTING);
+  state2->enable(GL_BLEND);
+  //state2->disable(GL_DEPTH_TEST);fonctionne pas ->mis dans callback
+  state2->setMaterial(GL_AMBIENT, 0.0, 0.0, 0.0, 0.);
+  state2->setMaterial(GL_DIFFUSE, 0.0, 0.0, 0.0, 0.6);
+  state2->setMaterial(GL_SPECULAR, 0.0, 0.0, 0.0, 0.);
+	state2->setStateCallback(SSG_CALLBACK_PREDRAW, shadowVolumePredrawCallback2);
+  state2->setStateCallback(SSG_CALLBACK_POSTDRAW, shadowVolumePostdrawCallback2);
+  ssgVertexArray *vertices = new ssgVertexArray( 8 );
+  float q=1000;
+  sgVec3 nn1 = { -q,  q, -q };
+  sgVec3 nn2 = { -q,  q,  q };
+  sgVec3 nn3 = {  q,  q,  q };
+  sgVec3 nn4 = {  q,  q, -q };
+  
+  sgVec3 nn5 = { -q, -q, -q };
+  sgVec3 nn6 = { -q, -q,  q };
+  sgVec3 nn7 = {  q, -q,  q };
+  sgVec3 nn8 = {  q, -q, -q };
+  vertices->add( nn1 );vertices->add( nn2 );vertices->add( nn3 );vertices->add( nn4 );
+  vertices->add( nn5 );vertices->add( nn6 );vertices->add( nn7 );vertices->add( nn8 );
+  vertices->add( nn1 );vertices->add( nn5 );vertices->add( nn8 );vertices->add( nn4 );
+  vertices->add( nn2 );vertices->add( nn1 );vertices->add( nn5 );vertices->add( nn6 );
+  vertices->add( nn2 );vertices->add( nn6 );vertices->add( nn7 );vertices->add( nn3 );
+  vertices->add( nn4 );vertices->add( nn8 );vertices->add( nn7 );vertices->add( nn3 );
+	ssgLeaf *l = new ssgVtxTable( GL_QUADS, vertices, NULL, NULL, NULL);
+
+	l->setState ( state2 );
+	branch->addKid( l );
+	return branch;		
+}
+
+/********************************************************************/
+int ShadowVolume::update(float p0, float p1, float p2, float phi, float theta, float psi)
+{
+//Shadow volume for the current attitude of the plane and the direction of the light.
+
+
+  //rotation and translation (same as aiplane)
+  sgMat4 m, temp;
+  sgVec3 rvec;
+  sgMakeIdentMat4(m);
+  
+  sgSetVec3(rvec, 0.0, 1.0, 0.0);
+  sgMakeRotMat4(temp, 180.0f - (float)psi * SG_RADIANS_TO_DEGREES, rvec);
+  sgPreMultMat4(m, temp);
+  
+  sgSetVec3(rvec, -1.0, 0.0, 0.0);
+  sgMakeRotMat4(temp, (float)theta * SG_RADIANS_TO_DEGREES, rvec);
+  sgPreMultMat4(m, temp);
+  
+  sgSetVec3(rvec, 0.0, 0.0, 1.0);
+  sgMakeRotMat4(temp, (float)phi * SG_RADIANS_TO_DEGREES, rvec);
+  sgPreMultMat4(m, temp);
+
+  sgMakeIdentMat4(temp);
+  temp[3][0] = p1;
+  temp[3][1] = -1 * p2;
+  temp[3][2] = -1 * p0;
+  sgPostMultMat4(m, temp);
+
+  vshadow_trans->setTransform(m);
+  
+  if (mesh->getNumTriangles() == 0)
+    return 1;
+
+  /* direction of the light in model coordinates : inverse rotation */
+  sgVec3 lw, lm;
+  sgNormaliseVec3(lw, lightposn);
+  for (int i = 0; i < 3; i++)
+    lm[i] = m[i][0] * lw[0] + m[i][1] * lw[1] + m[i][2] * lw[2];
+
+  /* down to the ground under the model, and a little further */
+  float depth  = -p2 - Global::scenery->getHeight(p0, p1)
+                 + mesh->getRadius() + VOLUME_MARGIN;
+  float length = VOLUME_LENGTH;
+  if (depth < VOLUME_LENGTH * lw[1])
+    length = depth / lw[1];
+
+  mesh->makeVolume(lm, CAP_OFFSET, length, volume);
+
+  return 1;
+}
+
+void ShadowVolume::VolumeTable::draw_geometry()
+{
+  volume->draw();
+}
+
+void ShadowVolume::VolumeTable::recalcBSphere()
+{
+  bsphere.setCenter(0, 0, 0);
+  bsphere.setRadius(radius);
+  bsphere_is_invalid = FALSE;
+}
+
+/************************************************/
+ShadowMesh *ShadowVolume::makeMesh(ssgEntity *model)
+{
+//Adjacency of the model triangles
+  std::vector<float> vert;
+  std::vector<int>   tri;
+  sgMat4 xform = { {1.0,  0.0,  0.0,  0}, 
+                   {0.0,  0.0, -1.0,  0},
+                   {0.0,  1.0,  0.0,  0},
+                   {0.0,  0.0,  0.0,  0} };
+  collectTriangles(model, xform, vert, tri);
+  ShadowMesh *mesh = new ShadowMesh(vert.empty() ? NULL : &vert[0], vert.size() / 3,
+                                    tri.empty() ? NULL : &tri[0], tri.size() / 3,
+                                    model->getBSphere()->getRadius() / SHADOW_CELLS);
+  printf("## Shadow mesh %d triangles, %d edges\n",
+         mesh->getNumTriangles(), mesh->getNumEdges());
+  return mesh;
+}
+
+/************************************************/
+ShadowVolume::ShadowVolume(ShadowMesh *mesh)
+  :  mesh(mesh), vshadow_draw(NULL), vshadow_trans(NULL)
+{
+
+	vshadow_trans = new ssgTransform();
+  this->addKid(vshadow_trans);
+  vshadow_draw = (ssgEntity*)makeShadowVolumeDraw();
+  this->addKid(vshadow_draw);
+
+//The volume is drawn twice : front faces, then back faces
+  float radius = mesh->getRadius() + VOLUME_LENGTH;
+
+  for (int pass = 0; pass < 2; pass++)
+  {
+    ssgSimpleState *state1 = new ssgSimpleState;
+    state1->enable(GL_COLOR_MATERIAL);
+    state1->disable(GL_TEXTURE_2D);
+    state1->disable( GL_LIGHTING );
+    state1->setStateCallback(SSG_CALLBACK_PREDRAW,
+                             (pass == 0) ? PredrawCallback1 : PredrawCallback1b);
+    state1->setStateCallback(SSG_CALLBACK_POSTDRAW, PostdrawCallback1);
+
+    ssgVtxTable *l = new VolumeTable(&volume, radius);
+    l->setState ( state1 );
+    vshadow_trans->addKid( l );
+  }
+}
+
+/*****************************/
+ShadowVolume::~ShadowVolume()
+{
+//The mesh belongs to the model, see ModelExtras
+}
+
+/**********************************************/
+void ShadowVolume::collectTriangles(ssgEntity * e, sgMat4 xform,
+                                    std::vector<float>& vert, std::vector<int>& tri)
+  /*Investigate all the branches of the model
+   and collect the triangles which cast a shadow*/
+{
+  if ( e->isAKindOf(ssgTypeBranch()) )
+  {
+    ssgBranch *br = (ssgBranch *) e ;
+    if ( e -> isA ( ssgTypeTransform() ) )
+    {
+      sgMat4 xform1;
+      ((ssgTransform *)e)->getTransform ( xform1 ) ;
+      sgPreMultMat4  ( xform, xform1 ) ;
+    }
+    sgMat4 local_xform;
+    sgCopyMat4(local_xform, xform);// save transformation matrix
+    for ( int i = 0 ; i < br -> getNumKids () ; i++ )
+    {
+      collectTriangles ( br -> getKid ( i ), xform, vert, tri );
+      // restore transformation matrix
+      sgCopyMat4(xform, local_xform);
+    }
+  }
+  else if ( e -> isAKindOf ( ssgTypeLeaf() ) )
+  {
+    ssgLeaf  *leaf = (ssgLeaf  *) e ;
+    SSGUtil::NodeAttributes attr = SSGUtil::getNodeAttributes(leaf);
+    if (attr.checkAttribute("shadow") != -1)
+    {
+      //Apply the transform to each vertex
+      int first = vert.size() / 3;
+      int nv = leaf->getNumVertices();
+      for ( int i = 0 ; i < nv ; i++ )
+      {
+        sgVec3 v;
+        sgXformPnt3( v,  leaf->getVertex(i), xform);
+        vert.push_back(v[0]);
+        vert.push_back(v[1]);
+        vert.push_back(v[2]);
+      }
+      int nt = leaf->getNumTriangles();
+      for ( int i = 0 ; i < nt ; i++ )//for  each triangle
+      {
+        short iv1,iv2,iv3;
+        leaf->getTriangle ( i, &iv1, &iv2,  &iv3 );
+        tri.push_back(first + iv1);
+        tri.push_back(first + iv2);
+        tri.push_back(first + iv3);
+      }
+    }
+  }
+}
+} // end of namespace Video::
+#endif //(SHADOW_TYPE==SHADOW_MESH)
+///////////////
@@ -25,64 +25,33 @@ call  	ssgAddTextureFormat ( ".jpg",ssgLoadJPG)  before use
 ************/
 
 #include <iostream>
+#include <cstdio>
+#include <cstring>
 #include <plib/ssg.h>
-#define XMD_H	//for not redefine INT32 in jpeglib.h
-extern "C"
-{
-#include <jpeglib.h>
-}
+#include "texture_image.h"
 
 namespace Video
 {
 
 bool ssgLoadJPG ( const char *fname, ssgTextureInfo* info )
 {
-  FILE * infile;
-  struct jpeg_decompress_struct cinfo;
-  struct jpeg_error_mgr jerr;
-
-  cinfo.err = jpeg_std_error(&jerr);
-  jpeg_create_decompress(&cinfo);
+  TextureImage img;
 
-  if ((infile = fopen(fname, "rb")) == NULL)
+  if (!img.decode(fname))
   {
     fprintf(stderr, "can't open %s\n", fname);
     return false ;
   }
-  jpeg_stdio_src(&cinfo, infile);
-  jpeg_read_header(&cinfo, TRUE);
-  jpeg_start_decompress(&cinfo);
-  JDIMENSION w = cinfo.output_width;
-  JDIMENSION h = cinfo.output_height;
-  JDIMENSION z = cinfo.output_components;
-  GLubyte *image;
-  image	= new GLubyte [ w * h * z ] ;
-  JSAMPROW row_pointer[1];	/* pointer to a single row */
-  int row_stride;			/* physical row width in buffer */
-  row_stride = w * z;	/* JSAMPLEs per row in image_buffer */
-  //std::cout <<"ssgLoadJPG " <<fname<<" "<<cinfo.image_height<<" x "<<cinfo.image_width<<std::endl;
-#if 1
-  while (cinfo.output_scanline < h)
-  {
-    row_pointer[0] = & image[(h -1 -cinfo.output_scanline) * row_stride];
-    jpeg_read_scanlines(&cinfo, row_pointer, 1 );
-  }
-#else
-//litle faster
-  JSAMPROW row_pointer2[h];
-  for (int i=0; i< h; i++)
-  {
-    row_pointer2[i] = & image[(h -1 -i) * row_stride];
-  }
-  while (cinfo.output_scanline < h)
-  {
-    jpeg_read_scanlines(&cinfo, & row_pointer2[cinfo.output_scanline], h );
-  }
-#endif
-  jpeg_finish_decompress(&cinfo);
-  jpeg_destroy_decompress(&cinfo);
-  fclose(infile);
-  
+
+  int w = img.level[0].width;
+  int h = img.level[0].height;
+  int z = img.depth;
+
+  // taken over by ssgMakeMipMaps()
+  GLubyte *image = new GLubyte [ w * h * z ] ;
+  memcpy(image, &img.level[0].data[0], w * h * z);
+  img.clear();
+
   if ( info != NULL )
   {
     info -> width = w ;
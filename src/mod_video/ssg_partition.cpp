@@ -0,0 +1,498 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+/** \file ssg_partition.cpp
+ *
+ *  Restructuring of the static geometry of SSG models.
+ */
+
+#include "ssg_partition.h"
+
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <math.h>
+
+
+namespace SSGUtil
+{
+
+/**
+ *  A vertex with all its attributes, transformations applied
+ */
+typedef struct
+{
+  sgVec3 p;
+  sgVec3 n;
+  sgVec2 t;
+  sgVec4 c;
+} T_Vertex;
+
+/**
+ *  Properties of leaves whose triangles can be drawn together
+ */
+typedef struct
+{
+  ssgState* state;
+  int       mask;           ///< traversal mask of the leaf and its parents
+  int       cullFace;
+  bool      hasNormals;
+  bool      hasTexCoords;
+  bool      hasColours;
+} T_Bucket;
+
+
+/**
+ *  Collects the triangles of a model.
+ */
+class GeometryCollector
+{
+  public:
+    /**
+     *  \param others  branch to which all nodes are added which are
+     *                 not collected, NULL to drop them
+     */
+    GeometryCollector(ssgBranch* others) : otherNodes(others) {};
+
+    /**
+     *  Walk down the model.
+     *
+     *  \param e      current node
+     *  \param xform  transformation of the parents
+     *  \param mask   traversal mask of the parents
+     */
+    void collect(ssgEntity* e, sgMat4 xform, int mask);
+
+    std::vector<T_Vertex> vertices;   ///< three per triangle
+    std::vector<int>      buckets;    ///< bucket of each triangle
+    std::vector<T_Bucket> bucketList;
+
+  private:
+    void addLeaf(ssgLeaf* leaf, sgMat4 xform, int mask);
+
+    ssgBranch* otherNodes;
+};
+
+
+void GeometryCollector::collect(ssgEntity* e, sgMat4 xform, int mask)
+{
+  int own_mask = mask & e->getTraversalMask();
+
+  // Nodes with a traversal callback (animations) change at runtime,
+  // they are not part of the static geometry.
+  bool fStatic = (e->getTravCallback(SSG_CALLBACK_PRETRAV) == NULL &&
+                  e->getTravCallback(SSG_CALLBACK_POSTTRAV) == NULL);
+
+  if (fStatic && (e->isA(ssgTypeBranch()) || e->isA(ssgTypeTransform())))
+  {
+    sgMat4 local_xform;
+    sgCopyMat4(local_xform, xform);
+    if (e->isA(ssgTypeTransform()))
+    {
+      sgMat4 xform1;
+      ((ssgTransform*)e)->getTransform(xform1);
+      sgPreMultMat4(local_xform, xform1);
+    }
+
+    ssgBranch* br = (ssgBranch*)e;
+    for (int i = 0; i < br->getNumKids(); i++)
+    {
+      collect(br->getKid(i), local_xform, own_mask);
+    }
+  }
+  else if (fStatic && e->isAKindOf(ssgTypeLeaf()) && ((ssgLeaf*)e)->getNumTriangles() > 0)
+  {
+    addLeaf((ssgLeaf*)e, xform, own_mask);
+  }
+  else if (otherNodes != NULL)
+  {
+    // keep it at the same place
+    ssgTransform* trans = new ssgTransform();
+    trans->setTransform(xform);
+    trans->setTraversalMask(mask);
+    trans->addKid(e);
+    otherNodes->addKid(trans);
+  }
+}
+
+
+void GeometryCollector::addLeaf(ssgLeaf* leaf, sgMat4 xform, int mask)
+{
+  int nNormals   = leaf->getNumNormals();
+  int nTexCoords = leaf->getNumTexCoords();
+  int nColours   = leaf->getNumColours();
+
+  T_Bucket b;
+  b.state        = leaf->hasState() ? leaf->getState() : NULL;
+  b.mask         = mask;
+  b.cullFace     = leaf->getCullFace();
+  b.hasNormals   = (nNormals > 0);
+  b.hasTexCoords = (nTexCoords > 0);
+  b.hasColours   = (nColours > 0);
+
+  int bucket = 0;
+  while (bucket < (int)bucketList.size())
+  {
+    const T_Bucket& x = bucketList[bucket];
+    if (x.state == b.state && x.mask == b.mask && x.cullFace == b.cullFace
+        && x.hasNormals == b.hasNormals && x.hasTexCoords == b.hasTexCoords
+        && x.hasColours == b.hasColours)
+      break;
+    bucket++;
+  }
+  if (bucket == (int)bucketList.size())
+    bucketList.push_back(b);
+
+  // a single normal, texture coordinate or colour is used for all vertices
+  int nTris = leaf->getNumTriangles();
+  for (int i = 0; i < nTris; i++)
+  {
+    short iv[3];
+    leaf->getTriangle(i, &iv[0], &iv[1], &iv[2]);
+
+    for (int k = 0; k < 3; k++)
+    {
+      T_Vertex v;
+      int      j = iv[k];
+
+      sgXformPnt3(v.p, leaf->getVertex(j), xform);
+      if (nNormals > 0)
+      {
+        sgXformVec3(v.n, leaf->getNormal((j < nNormals) ? j : 0), xform);
+        sgNormaliseVec3(v.n);
+      }
+      else
+        sgSetVec3(v.n, 0, 0, 1);
+      if (nTexCoords > 0)
+        sgCopyVec2(v.t, leaf->getTexCoord((j < nTexCoords) ? j : 0));
+      else
+        sgSetVec2(v.t, 0, 0);
+      if (nColours > 0)
+        sgCopyVec4(v.c, leaf->getColour((j < nColours) ? j : 0));
+      else
+        sgSetVec4(v.c, 1, 1, 1, 1);
+
+      vertices.push_back(v);
+    }
+    buckets.push_back(bucket);
+  }
+}
+
+
+/**
+ *  Orders triangles by one coordinate of their centre.
+ */
+class CentreLess
+{
+  public:
+    CentreLess(const std::vector<float>& c, int a) : centres(c), axis(a) {};
+
+    bool operator()(int a, int b) const
+    {
+      return centres[3 * a + axis] < centres[3 * b + axis];
+    };
+
+  private:
+    const std::vector<float>& centres;
+    int axis;
+};
+
+/**
+ *  Orders triangles by their bucket.
+ */
+class BucketLess
+{
+  public:
+    BucketLess(const std::vector<int>& b) : buckets(b) {};
+
+    bool operator()(int a, int b) const
+    {
+      return buckets[a] < buckets[b];
+    };
+
+  private:
+    const std::vector<int>& buckets;
+};
+
+
+/**
+ *  Builds the hierarchy from the collected triangles.
+ */
+class HierarchyBuilder
+{
+  public:
+    HierarchyBuilder(const GeometryCollector& g, int nMax);
+
+    /**
+     *  Make the node for the triangles tris[begin] to tris[end-1].
+     */
+    ssgEntity* build(int begin, int end);
+
+  private:
+    ssgEntity* makeNode(int begin, int end);
+    ssgLeaf*   makeLeaf(int begin, int end);
+
+    const GeometryCollector& geo;
+    int                      nMaxTriangles;
+    std::vector<int>         tris;
+    std::vector<float>       centres;
+};
+
+
+HierarchyBuilder::HierarchyBuilder(const GeometryCollector& g, int nMax)
+  : geo(g), nMaxTriangles(nMax)
+{
+  int nTris = geo.buckets.size();
+
+  tris.resize(nTris);
+  centres.resize(3 * nTris);
+  for (int i = 0; i < nTris; i++)
+  {
+    tris[i] = i;
+    for (int k = 0; k < 3; k++)
+    {
+      centres[3 * i + k] = (geo.vertices[3 * i].p[k]
+                            + geo.vertices[3 * i + 1].p[k]
+                            + geo.vertices[3 * i + 2].p[k]) / 3;
+    }
+  }
+}
+
+
+ssgEntity* HierarchyBuilder::build(int begin, int end)
+{
+  if (end - begin <= nMaxTriangles)
+    return makeNode(begin, end);
+
+  // split at the median of the longest axis
+  float lo[3];
+  float hi[3];
+  for (int k = 0; k < 3; k++)
+    lo[k] = hi[k] = centres[3 * tris[begin] + k];
+  for (int i = begin + 1; i < end; i++)
+  {
+    for (int k = 0; k < 3; k++)
+    {
+      float c = centres[3 * tris[i] + k];
+      if (c < lo[k])
+        lo[k] = c;
+      if (c > hi[k])
+        hi[k] = c;
+    }
+  }
+  int axis = 0;
+  for (int k = 1; k < 3; k++)
+  {
+    if (hi[k] - lo[k] > hi[axis] - lo[axis])
+      axis = k;
+  }
+
+  int mid = (begin + end) / 2;
+  std::nth_element(tris.begin() + begin, tris.begin() + mid, tris.begin() + end,
+                   CentreLess(centres, axis));
+
+  ssgBranch* br = new ssgBranch();
+  br->addKid(build(begin, mid));
+  br->addKid(build(mid, end));
+  return br;
+}
+
+
+ssgEntity* HierarchyBuilder::makeNode(int begin, int end)
+{
+  std::sort(tris.begin() + begin, tris.begin() + end, BucketLess(geo.buckets));
+
+  // one leaf for each bucket
+  ssgBranch* br  = NULL;
+  ssgLeaf*   leaf = NULL;
+  int        first = begin;
+  for (int i = begin + 1; i <= end; i++)
+  {
+    if (i == end || geo.buckets[tris[i]] != geo.buckets[tris[first]])
+    {
+      if (leaf != NULL && br == NULL)
+      {
+        br = new ssgBranch();
+        br->addKid(leaf);
+      }
+      leaf = makeLeaf(first, i);
+      if (br != NULL)
+        br->addKid(leaf);
+      first = i;
+    }
+  }
+
+  if (br != NULL)
+    return br;
+  return leaf;
+}
+
+
+ssgLeaf* HierarchyBuilder::makeLeaf(int begin, int end)
+{
+  const T_Bucket& b = geo.bucketList[geo.buckets[tris[begin]]];
+  int             n = 3 * (end - begin);
+
+  ssgVertexArray*   va = new ssgVertexArray(n);
+  ssgNormalArray*   na = b.hasNormals   ? new ssgNormalArray(n)   : NULL;
+  ssgTexCoordArray* ta = b.hasTexCoords ? new ssgTexCoordArray(n) : NULL;
+  ssgColourArray*   ca = b.hasColours   ? new ssgColourArray(n)   : NULL;
+
+  for (int i = begin; i < end; i++)
+  {
+    for (int k = 0; k < 3; k++)
+    {
+      const T_Vertex& v = geo.vertices[3 * tris[i] + k];
+      va->add(v.p);
+      if (na != NULL)
+        na->add(v.n);
+      if (ta != NULL)
+        ta->add(v.t);
+      if (ca != NULL)
+        ca->add(v.c);
+    }
+  }
+
+  ssgVtxTable* leaf = new ssgVtxTable(GL_TRIANGLES, va, na, ta, ca);
+  if (b.state != NULL)
+    leaf->setState(b.state);
+  leaf->setCullFace(b.cullFace);
+  leaf->setTraversalMask(b.mask);
+  return leaf;
+}
+
+
+/**
+ *  A cell of the grid for one bucket
+ */
+typedef struct T_CellKey
+{
+  int bucket;
+  int x, y, z;
+
+  bool operator<(const T_CellKey& o) const
+  {
+    if (bucket != o.bucket)
+      return bucket < o.bucket;
+    if (x != o.x)
+      return x < o.x;
+    if (y != o.y)
+      return y < o.y;
+    return z < o.z;
+  };
+} T_CellKey;
+
+
+/**
+ *  Merge all vertices in a cell of the grid to one at their mean
+ *  position, drop the triangles which degenerate.
+ */
+static void clusterVertices(GeometryCollector& geo, float cellSize)
+{
+  std::map<T_CellKey, int> cells;
+  std::vector<T_Vertex>    merged;
+  std::vector<int>         count;
+  std::vector<int>         id(geo.vertices.size());
+
+  for (int i = 0; i < (int)geo.vertices.size(); i++)
+  {
+    const T_Vertex& v = geo.vertices[i];
+    T_CellKey key;
+    key.bucket = geo.buckets[i / 3];
+    key.x = (int)floor(v.p[0] / cellSize);
+    key.y = (int)floor(v.p[1] / cellSize);
+    key.z = (int)floor(v.p[2] / cellSize);
+
+    std::map<T_CellKey, int>::iterator it = cells.find(key);
+    if (it == cells.end())
+    {
+      id[i] = merged.size();
+      cells[key] = id[i];
+      merged.push_back(v);
+      count.push_back(1);
+    }
+    else
+    {
+      id[i] = it->second;
+      sgAddVec3(merged[id[i]].p, v.p);
+      count[id[i]]++;
+    }
+  }
+  for (int i = 0; i < (int)merged.size(); i++)
+    sgScaleVec3(merged[i].p, 1.0f / count[i]);
+
+  std::vector<T_Vertex> vertices;
+  std::vector<int>      buckets;
+  for (int i = 0; i < (int)geo.buckets.size(); i++)
+  {
+    int a = id[3 * i];
+    int b = id[3 * i + 1];
+    int c = id[3 * i + 2];
+    if (a != b && b != c && c != a)
+    {
+      vertices.push_back(merged[a]);
+      vertices.push_back(merged[b]);
+      vertices.push_back(merged[c]);
+      buckets.push_back(geo.buckets[i]);
+    }
+  }
+  geo.vertices.swap(vertices);
+  geo.buckets.swap(buckets);
+}
+
+
+ssgEntity* makePartitionedModel(ssgEntity* model, int nMaxTriangles)
+{
+  ssgBranch*        root = new ssgBranch();
+  GeometryCollector geo(root);
+  sgMat4            xform;
+
+  sgMakeIdentMat4(xform);
+  geo.collect(model, xform, ~0);
+
+  if (!geo.buckets.empty())
+  {
+    HierarchyBuilder builder(geo, nMaxTriangles);
+    root->addKid(builder.build(0, geo.buckets.size()));
+  }
+  return root;
+}
+
+
+ssgEntity* makeSimplifiedModel(ssgEntity* model, float cellSize)
+{
+  ssgBranch*        root = new ssgBranch();
+  GeometryCollector geo(NULL);
+  sgMat4            xform;
+
+  sgMakeIdentMat4(xform);
+  geo.collect(model, xform, ~0);
+  clusterVertices(geo, cellSize);
+
+  if (!geo.buckets.empty())
+  {
+    HierarchyBuilder builder(geo, geo.buckets.size());
+    root->addKid(builder.build(0, geo.buckets.size()));
+  }
+  return root;
+}
+
+} // end namespace
@@ -0,0 +1,69 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+/** \file ssg_partition.h
+ *
+ *  Restructuring of the static geometry of SSG models.
+ *
+ *  All triangles below plain branches and transformations are
+ *  collected with the transformations applied. Nodes of other types
+ *  (selectors, invisible nodes etc.), nodes with a traversal callback
+ *  (animations) and leaves without triangles are kept as they are,
+ *  below a transformation which puts them at the same place as before.
+ */
+
+#ifndef SSG_PARTITION_H_
+#define SSG_PARTITION_H_
+
+#include <plib/ssg.h>
+
+namespace SSGUtil
+{
+
+/**
+ *  Rebuild the static geometry of a model as a bounding volume
+ *  hierarchy: the triangles are split at the median of the longest
+ *  axis until there are at most nMaxTriangles in a node, each node
+ *  gets a bounding sphere which contains only its own triangles.
+ *  Triangles with the same state in a node are drawn as one leaf.
+ *
+ *  \param model          the model, it is not changed
+ *  \param nMaxTriangles  maximum number of triangles in a leaf node
+ *  \return the new model
+ */
+ssgEntity* makePartitionedModel(ssgEntity* model, int nMaxTriangles);
+
+/**
+ *  Make a coarse copy of the static geometry of a model for drawing
+ *  it at a distance: all vertices in a cell of a grid are merged,
+ *  triangles which degenerate are dropped. Nodes which are not
+ *  plain branches or transformations are left away, as are animated
+ *  nodes: the model has to be animated before it is simplified.
+ *
+ *  \param model     the model, it is not changed
+ *  \param cellSize  size of the grid cells
+ *  \return the new model
+ */
+ssgEntity* makeSimplifiedModel(ssgEntity* model, float cellSize);
+
+} // end namespace
+
+#endif // SSG_PARTITION_H_
@@ -0,0 +1,378 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+/** \file texture_image.cpp
+ *
+ *  Texture images decoded into memory.
+ */
+
+#include "texture_image.h"
+#include "../include_gl.h"
+
+#include <cstdio>
+#include <cstring>
+#include <setjmp.h>
+
+#define XMD_H	//for not redefine INT32 in jpeglib.h
+extern "C"
+{
+#include <jpeglib.h>
+}
+
+
+namespace Video
+{
+
+/// size of the header of an SGI image
+#define SGI_HEADER_SIZE  (512)
+
+/// magic number of an SGI image
+#define SGI_MAGIC        (474)
+
+
+/**
+ *  Read a file from start to end.
+ */
+static bool readFile(std::string const& filename, std::vector<unsigned char>& contents)
+{
+  FILE* fp = fopen(filename.c_str(), "rb");
+  if (fp == NULL)
+    return false;
+
+  unsigned char buf[65536];
+  size_t        n;
+  while ((n = fread(buf, 1, sizeof(buf), fp)) > 0)
+    contents.insert(contents.end(), buf, buf + n);
+  fclose(fp);
+  return true;
+}
+
+
+static unsigned int getU16(const unsigned char* p)
+{
+  return (p[0] << 8) | p[1];
+}
+
+
+static unsigned long getU32(const unsigned char* p)
+{
+  return ((unsigned long)p[0] << 24) | ((unsigned long)p[1] << 16) | (p[2] << 8) | p[3];
+}
+
+
+/**
+ *  Decode an SGI image with one byte per channel, verbatim or RLE.
+ *  The channels are stored one after the other, each one bottom row
+ *  first.
+ */
+static bool decodeSGI(std::string const& filename, TextureImage& img)
+{
+  std::vector<unsigned char> file;
+  if (!readFile(filename, file) || file.size() < SGI_HEADER_SIZE)
+    return false;
+
+  const unsigned char* p    = &file[0];
+  size_t               size = file.size();
+  if (getU16(p) != SGI_MAGIC || p[3] != 1)
+    return false;
+
+  bool         fRLE = (p[2] != 0);
+  unsigned int dim  = getU16(p + 4);
+  int          w    = getU16(p + 6);
+  int          h    = (dim < 2) ? 1 : getU16(p + 8);
+  int          z    = (dim < 3) ? 1 : getU16(p + 10);
+  if (w == 0 || h == 0 || z < 1 || z > 4)
+    return false;
+  if (fRLE && size < SGI_HEADER_SIZE + (size_t)h * z * 4)
+    return false;
+
+  TextureImage::T_Level& level = img.level[0];
+  level.width  = w;
+  level.height = h;
+  level.data.resize((size_t)w * h * z);
+  img.depth    = z;
+
+  std::vector<unsigned char> row(w);
+  for (int c = 0; c < z; c++)
+  {
+    for (int y = 0; y < h; y++)
+    {
+      if (fRLE)
+      {
+        size_t start = getU32(p + SGI_HEADER_SIZE + 4 * ((size_t)c * h + y));
+        size_t n     = start;
+        int    x     = 0;
+
+        while (x < w)
+        {
+          if (n >= size)
+            return false;
+          int count = p[n] & 0x7F;
+          int fCopy = p[n] & 0x80;
+          n++;
+          if (count == 0 || x + count > w)
+            return false;
+
+          if (fCopy)
+          {
+            if (size - n < (size_t)count)
+              return false;
+            memcpy(&row[x], p + n, count);
+            n += count;
+          }
+          else
+          {
+            if (n >= size)
+              return false;
+            memset(&row[x], p[n], count);
+            n++;
+          }
+          x += count;
+        }
+      }
+      else
+      {
+        size_t start = SGI_HEADER_SIZE + ((size_t)c * h + y) * w;
+        if (start + w > size)
+          return false;
+        memcpy(&row[0], p + start, w);
+      }
+
+      unsigned char* dest = &level.data[(size_t)y * w * z + c];
+      for (int x = 0; x < w; x++)
+        dest[x * z] = row[x];
+    }
+  }
+  return true;
+}
+
+
+/**
+ *  Error handler of libjpeg which returns to decodeJPG() instead of
+ *  leaving the program, the loader thread may run into a broken file.
+ */
+typedef struct
+{
+  struct jpeg_error_mgr mgr;
+  jmp_buf               env;
+} T_JPEGError;
+
+static void jpegErrorExit(j_common_ptr cinfo)
+{
+  (*cinfo->err->output_message)(cinfo);
+  longjmp(((T_JPEGError*)cinfo->err)->env, 1);
+}
+
+
+/**
+ *  Decode a JPEG image, turned upside down to have the bottom row
+ *  first.
+ */
+static bool decodeJPG(std::string const& filename, TextureImage& img)
+{
+  FILE* infile = fopen(filename.c_str(), "rb");
+  if (infile == NULL)
+    return false;
+
+  struct jpeg_decompress_struct cinfo;
+  T_JPEGError                   jerr;
+
+  cinfo.err = jpeg_std_error(&jerr.mgr);
+  jerr.mgr.error_exit = jpegErrorExit;
+  if (setjmp(jerr.env))
+  {
+    jpeg_destroy_decompress(&cinfo);
+    fclose(infile);
+    return false;
+  }
+  jpeg_create_decompress(&cinfo);
+  jpeg_stdio_src(&cinfo, infile);
+  jpeg_read_header(&cinfo, TRUE);
+  jpeg_start_decompress(&cinfo);
+
+  TextureImage::T_Level& level = img.level[0];
+  int                    w     = cinfo.output_width;
+  int                    h     = cinfo.output_height;
+  int                    z     = cinfo.output_components;
+  level.width  = w;
+  level.height = h;
+  level.data.resize((size_t)w * h * z);
+  img.depth    = z;
+
+  while (cinfo.output_scanline < (JDIMENSION)h)
+  {
+    JSAMPROW row_pointer = &level.data[(size_t)(h - 1 - cinfo.output_scanline) * w * z];
+    jpeg_read_scanlines(&cinfo, &row_pointer, 1);
+  }
+  jpeg_finish_decompress(&cinfo);
+  jpeg_destroy_decompress(&cinfo);
+  fclose(infile);
+
+  return (z >= 1 && z <= 4);
+}
+
+
+/**
+ *  Pixel format of a texture with depth bytes per pixel.
+ */
+static GLenum pixelFormat(int depth)
+{
+  switch (depth)
+  {
+    case 1:
+      return GL_LUMINANCE;
+    case 2:
+      return GL_LUMINANCE_ALPHA;
+    case 3:
+      return GL_RGB;
+    default:
+      return GL_RGBA;
+  }
+}
+
+
+bool TextureImage::decode(std::string const& filename)
+{
+  std::string ext;
+  std::string::size_type dot = filename.rfind('.');
+  if (dot != std::string::npos)
+  {
+    ext = filename.substr(dot + 1);
+    for (std::string::size_type i = 0; i < ext.length(); i++)
+      ext[i] = tolower(ext[i]);
+  }
+
+  clear();
+  level.resize(1);
+
+  bool fOK = false;
+  if (ext == "rgb" || ext == "rgba" || ext == "bw" || ext == "sgi" ||
+      ext == "int" || ext == "inta")
+    fOK = decodeSGI(filename, *this);
+  else if (ext == "jpg" || ext == "jpeg")
+    fOK = decodeJPG(filename, *this);
+
+  if (!fOK)
+    clear();
+  return fOK;
+}
+
+
+bool TextureImage::load(std::string const& filename)
+{
+  if (!decode(filename))
+    return false;
+
+  int w = level[0].width;
+  int h = level[0].height;
+  if ((w & (w - 1)) != 0 || (h & (h - 1)) != 0)
+  {
+    clear();
+    return false;
+  }
+
+  makeMipMaps();
+  return true;
+}
+
+
+void TextureImage::makeMipMaps()
+{
+  level.resize(1);
+
+  int w0 = level[0].width;
+  int h0 = level[0].height;
+  for (int lev = 0; (w0 >> (lev + 1)) != 0 || (h0 >> (lev + 1)) != 0; lev++)
+  {
+    T_Level& l1 = level[lev];
+    T_Level  l2;
+    int      w1 = l1.width;
+    int      h1 = l1.height;
+
+    l2.width  = (w1 > 1) ? w1 / 2 : 1;
+    l2.height = (h1 > 1) ? h1 / 2 : 1;
+    l2.data.resize((size_t)l2.width * l2.height * depth);
+
+    for (int y2 = 0; y2 < l2.height; y2++)
+    {
+      for (int x2 = 0; x2 < l2.width; x2++)
+      {
+        int x1   = x2 + x2;
+        int x1_1 = (x1 + 1) % w1;
+        int y1   = y2 + y2;
+        int y1_1 = (y1 + 1) % h1;
+
+        for (int c = 0; c < depth; c++)
+        {
+          int t1 = l1.data[((size_t)y1   * w1 + x1  ) * depth + c];
+          int t2 = l1.data[((size_t)y1_1 * w1 + x1  ) * depth + c];
+          int t3 = l1.data[((size_t)y1   * w1 + x1_1) * depth + c];
+          int t4 = l1.data[((size_t)y1_1 * w1 + x1_1) * depth + c];
+          int t;
+
+          if (c == 3)
+          {
+            t = t1;
+            if (t2 > t) t = t2;
+            if (t3 > t) t = t3;
+            if (t4 > t) t = t4;
+          }
+          else
+          {
+            t = (t1 + t2 + t3 + t4) / 4;
+          }
+          l2.data[((size_t)y2 * l2.width + x2) * depth + c] = (unsigned char)t;
+        }
+      }
+    }
+    level.push_back(l2);
+  }
+}
+
+
+void TextureImage::upload() const
+{
+  GLint maxSize;
+  glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+
+  // skip the levels this OpenGL can't take
+  unsigned int first = 0;
+  while (first + 1 < level.size() &&
+         (level[first].width > maxSize || level[first].height > maxSize))
+    first++;
+
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  for (unsigned int i = first; i < level.size(); i++)
+  {
+    glTexImage2D(GL_TEXTURE_2D, i - first, depth,
+                 level[i].width, level[i].height, 0,
+                 pixelFormat(depth), GL_UNSIGNED_BYTE, &level[i].data[0]);
+  }
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
+
+
+void TextureImage::clear()
+{
+  depth = 0;
+  level.clear();
+}
+
+} // end namespace Video::
@@ -0,0 +1,99 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+/** \file texture_image.h
+ *
+ *  Texture images decoded into memory.
+ *
+ *  The texture loaders of PLIB decode an image file and hand it to
+ *  OpenGL in one go, so they can only be used by the thread which
+ *  owns the OpenGL context. TextureImage decodes the image and makes
+ *  its mipmaps without OpenGL, only upload() is left to that thread.
+ */
+
+#ifndef TEXTURE_IMAGE_H_
+#define TEXTURE_IMAGE_H_
+
+#include <string>
+#include <vector>
+
+namespace Video
+{
+
+class TextureImage
+{
+  public:
+    /**
+     *  One mipmap level. The rows are stored without padding, the
+     *  bottom row first.
+     */
+    typedef struct
+    {
+      int                        width;
+      int                        height;
+      std::vector<unsigned char> data;
+    } T_Level;
+
+    TextureImage() : depth(0) {};
+
+    /**
+     *  Decode an SGI (.rgb, .rgba, .bw, .sgi, .int, .inta) or JPEG
+     *  (.jpg, .jpeg) image file into level 0.
+     *
+     *  \return false if the file can't be read or its format is not
+     *          one of these
+     */
+    bool decode(std::string const& filename);
+
+    /**
+     *  Decode an image file and make its mipmap levels, like
+     *  ssgLoadTexture() does.
+     *
+     *  \return false if it can't be decoded or its size is not a
+     *          power of two, which ssgMakeMipMaps() refuses as well
+     */
+    bool load(std::string const& filename);
+
+    /**
+     *  Make levels 1 and up from level 0, the way ssgMakeMipMaps()
+     *  does: each texel is the average of four, alpha is the maximum.
+     */
+    void makeMipMaps();
+
+    /**
+     *  Upload all levels to the texture bound to GL_TEXTURE_2D,
+     *  leaving away the ones which are too large for this OpenGL.
+     */
+    void upload() const;
+
+    /**
+     *  Drop the image data.
+     */
+    void clear();
+
+    bool hasAlpha() const { return (depth == 2 || depth == 4); };
+
+    int                  depth;   ///< bytes per texel, 1 ... 4
+    std::vector<T_Level> level;   ///< level 0 is the largest one
+};
+
+} // end namespace Video::
+
+#endif // TEXTURE_IMAGE_H_
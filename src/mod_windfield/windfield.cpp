@@ -33,6 +33,7 @@
 #include "../include_gl.h"
 #include <math.h>
 #include <stdio.h>
+#include <vector>
 #include <plib/ssg.h>   // for ssgSimpleState
 #include "../mod_windfield_config.h"
 #include "../mod_misc/ls_constants.h"
@@ -194,10 +195,137 @@ const double dAltitudeZeroStrength =  4/0.3048;
 static ssgSimpleState   *td_state_noblend = NULL;
 static ssgSimpleState   *td_state_blend   = NULL;
 
+/// number of slices of the thermal discs
+#define THERM_DISC_SLICES (16)
+
+/// number of slices of the wind indicator background
+#define WIND_DISC_SLICES  (32)
+
+/**
+ *  Geometry of all thermals of one frame. add_thermal_to_batch() adds to
+ *  these arrays, draw_thermals() draws them with one call each.
+ *  The arrays keep their size from one frame to the next.
+ */
+static std::vector<GLfloat> therm_marker_vtx;   ///< markers, GL_TRIANGLES
+static std::vector<GLfloat> therm_disc_vtx;     ///< discs, GL_TRIANGLES
+static std::vector<GLfloat> therm_disc_col;     ///< RGBA of each disc vertex
+
+/// the marker, a sphere with three slices and stacks, GL_TRIANGLES
+static GLfloat therm_sphere[3*3*2*3][3];
+
+/// cos/sin of the slices of a thermal disc
+static GLfloat therm_circle[THERM_DISC_SLICES+1][2];
+
+/// background of the wind indicator, unit radius, GL_TRIANGLE_FAN
+static GLfloat wind_disc[WIND_DISC_SLICES+2][2];
+
+/**
+ *  Set up the geometry which is the same for all thermals.
+ */
+static void init_thermal_geometry()
+{
+  int n = 0;
+
+  for (int stack = 0; stack < 3; stack++)
+  {
+    double z0 = cos(M_PI * stack / 3);
+    double r0 = sin(M_PI * stack / 3);
+    double z1 = cos(M_PI * (stack + 1) / 3);
+    double r1 = sin(M_PI * (stack + 1) / 3);
+
+    for (int slice = 0; slice < 3; slice++)
+    {
+      double a0 = 2 * M_PI * slice / 3;
+      double a1 = 2 * M_PI * (slice + 1) / 3;
+      double quad[4][3] = { { r0*sin(a0), r0*cos(a0), z0 },
+                            { r1*sin(a0), r1*cos(a0), z1 },
+                            { r1*sin(a1), r1*cos(a1), z1 },
+                            { r0*sin(a1), r0*cos(a1), z0 } };
+      static const int tri[6] = { 0, 1, 2, 0, 2, 3 };
+
+      for (int i = 0; i < 6; i++, n++)
+      {
+        therm_sphere[n][0] = quad[tri[i]][0];
+        therm_sphere[n][1] = quad[tri[i]][1];
+        therm_sphere[n][2] = quad[tri[i]][2];
+      }
+    }
+  }
+
+  for (int i = 0; i <= THERM_DISC_SLICES; i++)
+  {
+    therm_circle[i][0] = sin(2 * M_PI * i / THERM_DISC_SLICES);
+    therm_circle[i][1] = cos(2 * M_PI * i / THERM_DISC_SLICES);
+  }
+
+  wind_disc[0][0] = 0;
+  wind_disc[0][1] = 0;
+  for (int i = 0; i <= WIND_DISC_SLICES; i++)
+  {
+    wind_disc[i+1][0] = sin(2 * M_PI * i / WIND_DISC_SLICES);
+    wind_disc[i+1][1] = cos(2 * M_PI * i / WIND_DISC_SLICES);
+  }
+}
+
+/**
+ *  Add a vertex to the thermal discs.
+ */
+static inline void add_disc_vertex(GLfloat x, GLfloat y, GLfloat z, const GLfloat* rgba)
+{
+  therm_disc_vtx.push_back(x);
+  therm_disc_vtx.push_back(y);
+  therm_disc_vtx.push_back(z);
+  therm_disc_col.insert(therm_disc_col.end(), rgba, rgba + 4);
+}
+
 /**
- *  A GLU quadric object for thermal drawing
+ *  Add a horizontal disc (r0 == 0) or ring to the thermal discs.
  */
-static GLUquadricObj *therm_quadric;
+static void add_thermal_disc(GLfloat x, GLfloat y, GLfloat z,
+                             GLfloat r0, GLfloat r1, const GLfloat* rgba)
+{
+  for (int i = 0; i < THERM_DISC_SLICES; i++)
+  {
+    GLfloat x0 = x + r1 * therm_circle[i][0];
+    GLfloat z0 = z + r1 * therm_circle[i][1];
+    GLfloat x1 = x + r1 * therm_circle[i+1][0];
+    GLfloat z1 = z + r1 * therm_circle[i+1][1];
+
+    if (r0 == 0)
+    {
+      add_disc_vertex(x,  y, z,  rgba);
+      add_disc_vertex(x0, y, z0, rgba);
+      add_disc_vertex(x1, y, z1, rgba);
+    }
+    else
+    {
+      GLfloat xi0 = x + r0 * therm_circle[i][0];
+      GLfloat zi0 = z + r0 * therm_circle[i][1];
+      GLfloat xi1 = x + r0 * therm_circle[i+1][0];
+      GLfloat zi1 = z + r0 * therm_circle[i+1][1];
+
+      add_disc_vertex(xi0, y, zi0, rgba);
+      add_disc_vertex(x0,  y, z0,  rgba);
+      add_disc_vertex(x1,  y, z1,  rgba);
+      add_disc_vertex(xi0, y, zi0, rgba);
+      add_disc_vertex(x1,  y, z1,  rgba);
+      add_disc_vertex(xi1, y, zi1, rgba);
+    }
+  }
+}
+
+/**
+ *  Add the marker of a thermal.
+ */
+static void add_thermal_marker(GLfloat x, GLfloat y, GLfloat z)
+{
+  for (int i = 0; i < 3*3*2*3; i++)
+  {
+    therm_marker_vtx.push_back(x + therm_sphere[i][0]);
+    therm_marker_vtx.push_back(y + therm_sphere[i][1]);
+    therm_marker_vtx.push_back(z + therm_sphere[i][2]);
+  }
+}
 
 /**
  * calculates grid coordinate from absolute coordinate
@@ -226,40 +354,19 @@ inline float gridToAbsCoor(int gridKoor, float rel=0.5)
          );
 }
 
+/**
+ * Random numbers for thermals and turbulence. Seeded in
+ * initialize_wind_field(), so the windfield doesn't depend on
+ * random numbers drawn by anybody else.
+ */
+CRRC_RandomStream windRand;
+
 /**
  * Returns random numbers with normal (gaussian) distribution.
- *
- * Thanks to rhoads@paul.rutgers.edu for this code!
- * http://remus.rutgers.edu/~rhoads/Code/code.html
  */
-double gaussrand()
+inline double gaussrand()
 {
-  static double V2, fac;
-  static int phase = 0;
-  double S, Z, U1, U2, V1;
-
-  if (phase)
-    Z = V2 * fac;
-  else
-  {
-    do
-    {
-      U1 = (double)rand() / RAND_MAX;
-      U2 = (double)rand() / RAND_MAX;
-
-      V1 = 2 * U1 - 1;
-      V2 = 2 * U2 - 1;
-      S = V1 * V1 + V2 * V2;
-    }
-    while(S >= 1);
-
-    fac = sqrt (-2 * log(S) / S);
-    Z = V1 * fac;
-  }
-
-  phase = 1 - phase;
-
-  return Z;
+  return(windRand.gauss());
 }
 
 /**
@@ -323,12 +430,12 @@ bool find_new_thermal_position(float *xpos, float *ypos,
       6580, 6934, 7064, 7136, 7372, 7474, 7586, 7592 };
 
   // choose a poly
-  unsigned int uPoly = aPoly[CRRC_Random::rand() % (sizeof(aPoly)/sizeof(unsigned int))];
+  unsigned int uPoly = aPoly[windRand.next32() % (sizeof(aPoly)/sizeof(unsigned int))];
     
   // find an initial value
-  unsigned int uCRCVal = CRRC_Random::rand();
+  unsigned int uCRCVal = windRand.next32() & 0x7FFFFFFF;
   while (uCRCVal == 0)
-    CRRC_Random::rand();
+    uCRCVal = windRand.next32() & 0x7FFFFFFF;
 
   *xcoord = (uCRCVal >> occupancy_grid_size_exp) & (occupancy_grid_size-1);
   *ycoord = uCRCVal & (occupancy_grid_size-1);
@@ -348,8 +455,8 @@ bool find_new_thermal_position(float *xpos, float *ypos,
     *xcoord = (uCRCVal >> occupancy_grid_size_exp) & (occupancy_grid_size-1);
     *ycoord = uCRCVal & (occupancy_grid_size-1);
   }
-  *xpos = gridToAbsCoor(*xcoord, (float)(CRRC_Random::rand())/CRRC_Random::max());
-  *ypos = gridToAbsCoor(*ycoord, (float)(CRRC_Random::rand())/CRRC_Random::max());
+  *xpos = gridToAbsCoor(*xcoord, (float)windRand.uniform());
+  *ypos = gridToAbsCoor(*ycoord, (float)windRand.uniform());
 
   // If no such square could be found, thermal density is set way too high.
   // No visible thermal should be created.
@@ -382,8 +489,6 @@ void clear_wind_field()
   td_state_noblend = NULL;
   delete td_state_blend;
   td_state_blend = NULL;
-
-  gluDeleteQuadric(therm_quadric);
 }
 
 // Description: see header file
@@ -395,6 +500,8 @@ void initialize_wind_field(SimpleXMLTransfer* el)
 
   dWindVelVar = 1;
 
+  windRand = CRRC_Random::createStream("windfield");
+
   ThermalVersion = THERMAL_CODE;
   // Use version 3?
   {
@@ -505,7 +612,7 @@ void initialize_wind_field(SimpleXMLTransfer* el)
   }
 #endif
 
-  therm_quadric = gluNewQuadric();  
+  init_thermal_geometry();
 }
 
 SimpleXMLTransfer* GetDefaultConf_Thermal()
@@ -741,14 +848,67 @@ int calculate_wind(double  X_cg,      double  Y_cg,     double  Z_cg,
   }
 }
 
+/**
+ *  Adds a thermal to the geometry drawn by draw_thermals()
+ *
+ *  \param thermal  the thermal
+ *  \param H_cg_rwy height at which the thermal shall be drawn
+ */
+static void add_thermal_to_batch(const T_ThermalState& thermal, double H_cg_rwy)
+{
+#if THERMAL_TEST != 0
+  if (H_cg_rwy < 3*dAltitudeFullStrength)
+    H_cg_rwy = 3*dAltitudeFullStrength;
+#endif
+
+  GLfloat x = thermal.center_y_position;
+  GLfloat y = H_cg_rwy;
+  GLfloat z = -thermal.center_x_position;
+
+#if (THERMAL_CODE == 0)
+  static const GLfloat col_disc[4] = { 0.4, 0, 0, 0.2 };
+
+  add_thermal_marker(x, y, z);
+  add_thermal_disc(x, y, z, 0, thermal.radius + thermal.boundary_thickness, col_disc);
+#endif
+
+#if (THERMAL_CODE == 1)
+  if (H_cg_rwy > dAltitudeZeroStrength)
+  {
+    double strength_height;
+
+    if (H_cg_rwy < dAltitudeFullStrength)
+      strength_height = 0.2 * (H_cg_rwy - dAltitudeZeroStrength) / (dAltitudeFullStrength - dAltitudeZeroStrength);
+    else
+      strength_height = 0.2;
+
+    GLfloat alpha        = strength_height;
+    GLfloat col_inner[4] = { 0.4, 0,   0, alpha };
+    GLfloat col_outer[4] = { 0,   0.4, 0, alpha };
+
+    add_thermal_marker(x, y, z);
+    add_thermal_disc(x, y, z, 0, thermal.radius, col_inner);
+
+    // The whole radius of the thermal is limited to not get annoying.
+    double RadiusInnerPartRel = ThermalRadius;
+    if (RadiusInnerPartRel < 0.4)
+      RadiusInnerPartRel = 0.4;
+
+    double dRadius = thermal.radius / RadiusInnerPartRel;
+    add_thermal_disc(x, y, z, thermal.radius, dRadius, col_outer);
+  }
+#endif
+}
+
 // Description: see header file
-void draw_thermals(CRRCMath::Vector3 pos)
+void get_thermals(CRRCMath::Vector3 pos, std::vector<T_ThermalState>& list)
 {
   Thermal* thermal_ptr;
 
   double X_cg_rwy =  pos.r[0];
   double Y_cg_rwy =  pos.r[1];
-  double H_cg_rwy = -pos.r[2];
+
+  list.clear();
 
   if (nDrawThermalsFromGrid)
   {
@@ -777,7 +937,8 @@ void draw_thermals(CRRCMath::Vector3 pos)
         thermal_ptr = thermal_occupancy_grid[x][y];
         if (thermal_ptr != NULL)
         {
-          thermal_ptr->draw(H_cg_rwy);
+          list.resize(list.size() + 1);
+          thermal_ptr->getState(list.back());
         }
       }
   }
@@ -789,12 +950,60 @@ void draw_thermals(CRRCMath::Vector3 pos)
       if (fabs(X_cg_rwy - thermal_ptr->center_x_position) < flThermalDistMax &&
           fabs(Y_cg_rwy - thermal_ptr->center_y_position) < flThermalDistMax)
       {
-        thermal_ptr->draw(H_cg_rwy);
+        list.resize(list.size() + 1);
+        thermal_ptr->getState(list.back());
       }
       thermal_ptr = thermal_ptr->next_thermal;
     }
   }
+}
+
+// Description: see header file
+void draw_thermals(CRRCMath::Vector3 pos)
+{
+  static std::vector<T_ThermalState> list;
+
+  get_thermals(pos, list);
+  draw_thermals(pos, list);
+}
+
+// Description: see header file
+void draw_thermals(CRRCMath::Vector3 pos, const std::vector<T_ThermalState>& list)
+{
+  double H_cg_rwy = -pos.r[2];
+
+  therm_marker_vtx.clear();
+  therm_disc_vtx.clear();
+  therm_disc_col.clear();
+
+  for (unsigned int n=0; n<list.size(); n++)
+    add_thermal_to_batch(list[n], H_cg_rwy);
+
+  if (therm_marker_vtx.size() == 0)
+    return;
+
+  glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+  glDisableClientState(GL_NORMAL_ARRAY);
+  glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+  glEnableClientState(GL_VERTEX_ARRAY);
+
+  td_state_noblend->apply();
+  glColor4f(1,0,0,1);
+  glDisableClientState(GL_COLOR_ARRAY);
+  glVertexPointer(3, GL_FLOAT, 0, &therm_marker_vtx[0]);
+  glDrawArrays(GL_TRIANGLES, 0, therm_marker_vtx.size() / 3);
+
+  if (therm_disc_vtx.size() > 0)
+  {
+    td_state_blend->apply();
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(3, GL_FLOAT, 0, &therm_disc_vtx[0]);
+    glColorPointer(4, GL_FLOAT, 0, &therm_disc_col[0]);
+    glDrawArrays(GL_TRIANGLES, 0, therm_disc_vtx.size() / 3);
+  }
 
+  glPopClientAttrib();
 }
 
 void draw_wind(double direction_face)
@@ -822,20 +1031,32 @@ void draw_wind(double direction_face)
   gluOrtho2D (0, xsize-1, 0, ysize);
 #endif
 
+  GLint arrow[4][2] = { { xsize - r - h/2 - dxC, r+h/2 - dyC },
+                        { xsize - r - h/2 - dxA, r+h/2 - dyA },
+                        { xsize - r - h/2 - dxB, r+h/2 - dyB },
+                        { xsize - r - h/2 - dxC, r+h/2 - dyC } };
+
+  glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+  glDisableClientState(GL_NORMAL_ARRAY);
+  glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+  glDisableClientState(GL_COLOR_ARRAY);
+  glEnableClientState(GL_VERTEX_ARRAY);
+
   // Hintergrund
   glColor3f (0, 0, 0);
   glTranslatef(xsize-r-h/2, r+h/2, 0);
-  gluDisk(therm_quadric, 0, h/2, 32, 1);
+  glScalef(h/2, h/2, 1);
+  glVertexPointer(2, GL_FLOAT, 0, wind_disc);
+  glDrawArrays(GL_TRIANGLE_FAN, 0, WIND_DISC_SLICES+2);
+  glScalef(2.0/h, 2.0/h, 1);
   glTranslatef(-(xsize-r-h/2),-(r+h/2),0.1);
 
   // Anzeiger
   glColor3f (0, 1, 0.);
-  glBegin(GL_LINE_STRIP);
-  glVertex2i(xsize - r - h/2 - dxC, r+h/2 - dyC);
-  glVertex2i(xsize - r - h/2 - dxA, r+h/2 - dyA);
-  glVertex2i(xsize - r - h/2 - dxB, r+h/2 - dyB);
-  glVertex2i(xsize - r - h/2 - dxC, r+h/2 - dyC);
-  glEnd();
+  glVertexPointer(2, GL_INT, 0, arrow);
+  glDrawArrays(GL_LINE_STRIP, 0, 4);
+
+  glPopClientAttrib();
 
 #if 0
   glPopMatrix();
@@ -998,7 +1219,7 @@ Thermal::Thermal()
 {
   random_init();
   // to have a higher level of initial randomness:
-  lifetime *= rand()/(RAND_MAX+1.0);
+  lifetime *= windRand.uniform();
 }
 
 /**
@@ -1203,62 +1424,14 @@ double Thermal::getVelocity(double dX, double dY, double dZ)
 }
 #endif
 
-/**
- *  Draws a thermal
- *
- *  \param H_cg_rwy height at which the thermal shall be drawn
- */
-void Thermal::draw(double H_cg_rwy)
+void Thermal::getState(T_ThermalState& state) const
 {
-#if THERMAL_TEST != 0
-  if (H_cg_rwy < 3*dAltitudeFullStrength)
-    H_cg_rwy = 3*dAltitudeFullStrength;
-#endif
-
-  glPushMatrix();
-  td_state_noblend->apply();
-
+  state.center_x_position  = center_x_position;
+  state.center_y_position  = center_y_position;
+  state.radius             = radius;
 #if (THERMAL_CODE == 0)
-  glColor4f(1,0,0,1);
-  glTranslatef(center_y_position, H_cg_rwy, -center_x_position);
-  gluSphere(therm_quadric,1,3,3);
-  td_state_blend->apply();
-  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-  glRotatef(90,1,0,0);
-  glColor4f(0.4,0,0,0.2);
-  gluDisk(therm_quadric,0, radius + boundary_thickness,16,1);
+  state.boundary_thickness = boundary_thickness;
 #endif
-
-#if (THERMAL_CODE == 1)
-  if (H_cg_rwy > dAltitudeZeroStrength)
-  {
-    double strength_height;
-
-    if (H_cg_rwy < dAltitudeFullStrength)
-      strength_height = 0.2 * (H_cg_rwy - dAltitudeZeroStrength) / (dAltitudeFullStrength - dAltitudeZeroStrength);
-    else
-      strength_height = 0.2;
-
-    glColor4f(1,0,0,1);
-    glTranslatef(center_y_position, H_cg_rwy, -center_x_position);
-    gluSphere(therm_quadric,1,3,3);
-    td_state_blend->apply();
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glRotatef(90,1,0,0);
-    glColor4f(0.4,0,0, strength_height);
-    gluDisk(therm_quadric,0, radius, 16, 1);
-
-    // The whole radius of the thermal is limited to not get annoying.
-    double RadiusInnerPartRel = ThermalRadius;
-    if (RadiusInnerPartRel < 0.4)
-      RadiusInnerPartRel = 0.4;
-
-    double dRadius = radius / RadiusInnerPartRel;
-    glColor4f(0,0.4,0, strength_height);
-    gluDisk(therm_quadric, radius, dRadius, 16,1);
-  }
-#endif
-  glPopMatrix();
 }
 
 void Thermal::sumVelocity(double X_cg, double Y_cg, double Z_cg,
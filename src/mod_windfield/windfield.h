@@ -25,6 +25,8 @@
 #ifndef WINDFIELD_H
 #define WINDFIELD_H
 
+#include <vector>
+
 #include "../mod_windfield_config.h"
 #include "../mod_math/vector3.h"
 #include "../mod_misc/SimpleXMLTransfer.h"
@@ -32,6 +34,20 @@
 
 class ThermikSchalen;
 
+/**
+ *  What is drawn of a thermal. The simulation thread hands out
+ *  copies, so the thermals can be drawn while they are moved.
+ */
+typedef struct
+{
+  float center_x_position;
+  float center_y_position;
+  float radius;
+#if (THERMAL_CODE == 0)
+  float boundary_thickness;
+#endif
+} T_ThermalState;
+
 /** \brief A class that represents a thermal
  *
  *  This class replaces the old "thermal" data struct.
@@ -81,8 +97,8 @@ class Thermal
      */    
     double getVelocity(double dX, double dY, double dZ);
     
-    /// draw the thermal
-    void draw(double H_cg_rwy);
+    /// what is drawn of the thermal
+    void getState(T_ThermalState& state) const;
 };
 //} Thermal;
 
@@ -118,12 +134,25 @@ int calculate_wind(double  X_cg,      double  Y_cg,     double  Z_cg,
                    double& Vel_north, double& Vel_east, double& Vel_down);
 
 
+/**
+ *  Replaces the contents of list by the thermals within a given square
+ *  around the aircraft.
+ */
+void get_thermals(CRRCMath::Vector3 pos, std::vector<T_ThermalState>& list);
+
 /** \brief Draw the thermals.
  *
  *  Draws a sphere for each thermal within a given square around the aircraft.
+ *  All thermals are drawn at once from vertex arrays.
  */
 void draw_thermals(CRRCMath::Vector3 pos);
 
+/**
+ *  Draws the thermals of a list from get_thermals(), at the height of
+ *  the aircraft. Doesn't look at the thermals themselves.
+ */
+void draw_thermals(CRRCMath::Vector3 pos, const std::vector<T_ThermalState>& list);
+
 /** 
  *
  *  Draws an indicator for wind strength and direction
@@ -20,12 +20,15 @@
 
 #include "record.h"
 
+#include "global.h"
+#include "mod_misc/crrc_rand.h"
 #include "mod_misc/filesystools.h"
 #include "mod_misc/lib_conversions.h"
 #include "mod_robots/robotfile.h"
 #include <crrc_config.h>
 
 #include <iostream>
+#include <sstream>
 #include <cerrno>
 #include <cstring>
 
@@ -33,6 +36,10 @@ FlightRecorder::FlightRecorder(std::string output_directory)
 {
   outdir = output_directory;
   state  = eNoFile;
+  num    = 0;
+  fDeterministic = false;
+  fCompress      = false;
+  fCompressFile  = false;
   if (outdir.length())
     outdir += "/";
 }
@@ -43,6 +50,22 @@ void FlightRecorder::Start(SimpleXMLTransfer* data)
   data->setAttribute("CRRCSim", PACKAGE_VERSION);  
   data->setName("CRRCSim_record");
   
+  if (fDeterministic)
+  {
+    // dt with all digits, it has to be exactly the same on replay
+    std::ostringstream seed;
+    std::ostringstream dt;
+    seed << CRRC_Random::getSeed();
+    dt.precision(17);
+    dt << (double)Global::dt;
+    data->setAttribute("deterministic", "1");
+    data->setAttribute("seed", seed.str());
+    data->setAttribute("dt",   dt.str());
+  }
+  
+  if (state == eDisabled)
+    return;
+  
   if (state == eRecording)
     Stop();
       
@@ -57,6 +80,8 @@ void FlightRecorder::Start(SimpleXMLTransfer* data)
   data->print(out, 0);
   state = eRecording;
   descr = "";
+  fCompressFile = fCompress;
+  block.Clear();
 }
 
 void FlightRecorder::Stop()
@@ -79,8 +104,25 @@ void FlightRecorder::Stop()
       std::string fn = "record" + itoStr(num, '0', 3) + ".crrclog_";
       FileSysTools::move(outdir+filename+".crrclog", outdir+fn);
     }
+    state = eNoFile;
   }
-  state = eNoFile;
+}
+
+void FlightRecorder::Disable()
+{
+  Stop();
+  state = eDisabled;
+}
+
+void FlightRecorder::SetDeterministic(bool fDet)
+{
+  fDeterministic = fDet;
+  CRRC_Random::setDeterministic(fDet);
+}
+
+void FlightRecorder::SetCompress(bool fComp)
+{
+  fCompress = fComp;
 }
 
 void FlightRecorder::SetFilename(std::string newname)
@@ -96,6 +138,8 @@ void FlightRecorder::InsertMarker(int data)
 {
   if (state == eRecording)
   {
+    block.Write(out);
+    
     const char rt = 0x02;
     out.write((char*)&rt, 1);
     RobotFile::WriteInt32(out, data);
@@ -106,6 +150,8 @@ void FlightRecorder::InsertXML(SimpleXMLTransfer* data)
 {
   if (state == eRecording)
   {
+    block.Write(out);
+    
     const char rt = 0x03;
     out.write((char*)&rt, 1);
     data->print(out, 0);
@@ -114,7 +160,19 @@ void FlightRecorder::InsertXML(SimpleXMLTransfer* data)
 
 void FlightRecorder::AirplanePosition(double dt, int multiloop, FDMBase* fdm)
 {
-  if (state == eRecording)
+  if (state == eRecording && fCompressFile)
+  {
+    CRRCMath::Vector3 pos = fdm->getPos();
+    double            euler[3];
+    
+    euler[0] = fdm->getPhi();
+    euler[1] = fdm->getTheta();
+    euler[2] = fdm->getPsi();
+    block.Add(dt*multiloop, pos.r, euler);
+    if (block.IsFull())
+      block.Write(out);
+  }
+  else if (state == eRecording)
   {
     const char rt = 0x00;
     out.write((char*)&rt, 1);
@@ -130,6 +188,96 @@ void FlightRecorder::AirplanePosition(double dt, int multiloop, FDMBase* fdm)
   }
 }
 
+void FlightRecorder::SimulationStep(int multiloop, TSimInputs* inputs, FDMBase* fdm)
+{
+  if (state == eRecording && fDeterministic)
+  {
+    const char rt = 0x04;
+    out.write((char*)&rt, 1);
+
+    RobotFile::WriteInt32(out, multiloop);
+    RobotFile::WriteFloat(out, inputs->aileron);
+    RobotFile::WriteFloat(out, inputs->elevator);
+    RobotFile::WriteFloat(out, inputs->rudder);
+    RobotFile::WriteFloat(out, inputs->throttle);
+    RobotFile::WriteFloat(out, inputs->flap);
+    RobotFile::WriteFloat(out, inputs->spoiler);
+    RobotFile::WriteFloat(out, inputs->retract);
+    RobotFile::WriteFloat(out, inputs->pitch);
+    for (int i = 0; i < TSimInputs::NUM_AUX_INPUTS; i++)
+      RobotFile::WriteFloat(out, inputs->aux[i]);
+    RobotFile::WriteFloat(out, inputs->heli_fixed_z);
+
+    const std::set<int>& keys = inputs->GetKeys();
+    RobotFile::WriteInt32(out, keys.size());
+    for (std::set<int>::const_iterator it = keys.begin(); it != keys.end(); ++it)
+      RobotFile::WriteInt32(out, *it);
+
+    RobotFile::WriteUInt64(out, StateHash(fdm));
+  }
+}
+
+bool FlightRecorder::ReadSimulationStep(std::ifstream& in, int& multiloop,
+                                        TSimInputs& inputs, uint64_t& hash)
+{
+  inputs = TSimInputs();
+  
+  multiloop       = RobotFile::ReadInt32(in);
+  inputs.aileron  = RobotFile::ReadFloat(in);
+  inputs.elevator = RobotFile::ReadFloat(in);
+  inputs.rudder   = RobotFile::ReadFloat(in);
+  inputs.throttle = RobotFile::ReadFloat(in);
+  inputs.flap     = RobotFile::ReadFloat(in);
+  inputs.spoiler  = RobotFile::ReadFloat(in);
+  inputs.retract  = RobotFile::ReadFloat(in);
+  inputs.pitch    = RobotFile::ReadFloat(in);
+  for (int i = 0; i < TSimInputs::NUM_AUX_INPUTS; i++)
+    inputs.aux[i] = RobotFile::ReadFloat(in);
+  inputs.heli_fixed_z = RobotFile::ReadFloat(in);
+
+  int nKeys = RobotFile::ReadInt32(in);
+  for (int i = 0; i < nKeys && !in.eof(); i++)
+    inputs.AddKey(RobotFile::ReadInt32(in));
+
+  hash = RobotFile::ReadUInt64(in);
+  
+  return(!in.eof());
+}
+
+/**
+ * Adds the bit pattern of a double to a hash.
+ */
+static inline uint64_t hashDouble(uint64_t hash, double dVal)
+{
+  uint64_t bits;
+  memcpy(&bits, &dVal, sizeof(bits));
+  return(CRRC_RandomStream::mix64(hash ^ bits));
+}
+
+static inline uint64_t hashVector(uint64_t hash, const CRRCMath::Vector3& v)
+{
+  hash = hashDouble(hash, v.r[0]);
+  hash = hashDouble(hash, v.r[1]);
+  return(hashDouble(hash, v.r[2]));
+}
+
+uint64_t FlightRecorder::StateHash(FDMBase* fdm)
+{
+  uint64_t hash = 0;
+  
+  hash = hashVector(hash, fdm->getPos());
+  hash = hashVector(hash, fdm->getVel());
+  hash = hashVector(hash, fdm->getPQR());
+  hash = hashDouble(hash, fdm->getPhi());
+  hash = hashDouble(hash, fdm->getTheta());
+  hash = hashDouble(hash, fdm->getPsi());
+  hash = hashDouble(hash, fdm->getPropFreq());
+  hash = hashDouble(hash, fdm->getBatCapLeft());
+  hash = hashDouble(hash, fdm->getVRelAirmass());
+  
+  return(hash);
+}
+
 std::string FlightRecorder::GetFilename() 
 {
   return(filename); 
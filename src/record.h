@@ -23,8 +23,11 @@
 
 #include <fstream>
 #include <string>
+#include <stdint.h>
 #include "mod_misc/SimpleXMLTransfer.h"
 #include "mod_fdm/fdm.h"
+#include "mod_fdm/fdm_inputs.h"
+#include "mod_robots/robotblock.h"
 
 /**
  * Record airplane position, attitude, control inputs, settings, results, 
@@ -34,6 +37,18 @@
  * 
  * See documentation/record_playback/
  *
+ * In deterministic mode every call of the simulation is recorded
+ * with its number of steps, its inputs and a hash of the state of the
+ * aircraft afterwards (record type 0x04). Together with the seed of
+ * the simulation, which is stored in the header, this is everything
+ * needed to re-run the flight model and compare the result step by
+ * step, see ReplayVerifier.
+ *
+ * Positions are collected into compressed blocks (record type 0x05,
+ * see RobotPositionBlock) unless this is turned off. A block is
+ * written when it is full and before any other record except the
+ * simulation steps.
+ *
  * todo: all binary storage code needs to be reviewed regarding endianess
  * and other portability issues which I do not know about. Recorded files
  * should work on any platform!
@@ -65,6 +80,53 @@ public:
    */
   void AirplanePosition(double dt, int multiloop, FDMBase* fdm);
   
+  /**
+   * Deterministic mode only: write the number of steps done by one
+   * call of the simulation, the inputs it has been called with and the
+   * hash of the state of the aircraft afterwards.
+   * 
+   * \param inputs  the inputs as they have been before the call,
+   *                including the keys which have not been consumed
+   */
+  void SimulationStep(int multiloop, TSimInputs* inputs, FDMBase* fdm);
+  
+  /**
+   * Reads a record written by SimulationStep(), the record type has
+   * already been read.
+   * 
+   * \return false at the end of the file
+   */
+  static bool ReadSimulationStep(std::ifstream& in, int& multiloop,
+                                 TSimInputs& inputs, uint64_t& hash);
+  
+  /**
+   * Hash over the bit patterns of the state of the aircraft: position,
+   * velocity, attitude, rates, propeller, battery and airspeed.
+   */
+  static uint64_t StateHash(FDMBase* fdm);
+  
+  /**
+   * Turn deterministic recording on or off. Takes effect with the
+   * next Start(), the random streams of the flight models with the
+   * next launch.
+   */
+  void SetDeterministic(bool fDet);
+  
+  bool IsDeterministic() const { return(fDeterministic); };
+  
+  /**
+   * Turn the compression of positions on or off. Takes effect with
+   * the next Start(). Off by default (record.compress="0"), because
+   * older versions don't know records of type 0x05.
+   */
+  void SetCompress(bool fComp);
+  
+  /**
+   * Don't write any files from now on, for example while a record is
+   * replayed.
+   */
+  void Disable();
+  
   /**
    * Insert some marker.
    */
@@ -105,9 +167,18 @@ private:
    */
   std::string outdir;
   
-  enum eState { eNoFile, eRecording };
+  enum eState { eNoFile, eRecording, eDisabled };
   eState state;
   int num;
+  
+  bool fDeterministic;
+  
+  /**
+   * Compression of positions: requested, and in the current file
+   */
+  bool fCompress;
+  bool fCompressFile;
+  RobotPositionBlock block;
 };
 
 #endif
@@ -0,0 +1,144 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+/** \file replay_verifier.cpp
+ *
+ *  Re-runs a flight which has been recorded in deterministic mode.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "replay_verifier.h"
+#include "global.h"
+#include "record.h"
+#include "mod_fdm/fdm.h"
+#include "mod_misc/scheduler.h"
+#include "mod_robots/robotblock.h"
+#include "mod_robots/robotfile.h"
+
+
+ReplayVerifier::ReplayVerifier(std::string filename)
+  : sFilename(filename), fDeterministic(false), uSeed(0), dDt(0)
+{
+  char buf;
+
+  infile.open(filename.c_str(), std::ios::binary);
+  if (!infile)
+    throw XMLException("unable to open " + filename);
+
+  SimpleXMLTransfer header(infile);
+  // skip trailing '\n'
+  infile.read(&buf, 1);
+
+  fDeterministic = (header.getInt("deterministic", 0) != 0);
+  uSeed          = strtoull(header.getString("seed", "0").c_str(), NULL, 10);
+  dDt            = header.getDouble("dt", 0);
+  sAirplaneFile  = header.getString("airplane.file", "");
+}
+
+
+ReplayVerifier::~ReplayVerifier()
+{
+  infile.close();
+}
+
+
+unsigned long ReplayVerifier::Run(std::ostream& out, T_Step step, ModFDMInterface* fdm)
+{
+  TSimInputs    inputs;
+  int           multiloop;
+  uint64_t      hash;
+  unsigned long nCalls      = 0;
+  unsigned long nSteps      = 0;
+  unsigned long nMismatches = 0;
+  char          rt;
+  char          line[200];
+  double        dStart      = Scheduler::getSeconds();
+
+  out << "Replaying " << sFilename << std::endl;
+  if (!fDeterministic)
+  {
+    out << "  not recorded in deterministic mode (-e), nothing to verify" << std::endl;
+    return(1);
+  }
+
+  while (infile.read(&rt, 1))
+  {
+    switch (rt)
+    {
+      case 0x00: // position
+        infile.ignore(8+3*4+3*2);
+        break;
+
+      case 0x02: // marker
+        RobotFile::ReadInt32(infile);
+        break;
+
+      case 0x03: // xml
+        {
+          char buf;
+          SimpleXMLTransfer data(infile);
+          // skip trailing '\n'
+          infile.read(&buf, 1);
+        }
+        break;
+
+      case 0x05: // compressed positions
+        RobotPositionBlock::Skip(infile);
+        break;
+
+      case 0x04: // simulation step
+        if (FlightRecorder::ReadSimulationStep(infile, multiloop, inputs, hash))
+        {
+          step(&inputs, multiloop);
+          nCalls++;
+          nSteps += multiloop;
+
+          if (FlightRecorder::StateHash(fdm->fdm) != hash)
+          {
+            if (nMismatches == 0)
+            {
+              snprintf(line, sizeof(line), "  first difference after step %lu (%.3f s)",
+                       nSteps, nSteps * Global::dt);
+              out << line << std::endl;
+            }
+            nMismatches++;
+          }
+        }
+        break;
+
+      default:
+        out << "  unknown record type: " << (int)rt << std::endl;
+        return(nMismatches + 1);
+    }
+  }
+
+  double dTime = Scheduler::getSeconds() - dStart;
+
+  snprintf(line, sizeof(line), "  %lu steps (%.1f s of flight) in %.3f s, %.0f steps/s",
+           nSteps, nSteps * Global::dt, dTime, (dTime > 0) ? nSteps / dTime : 0);
+  out << line << std::endl;
+  out << "  " << nMismatches << " of " << nCalls << " calls differ" << std::endl;
+
+  if (nCalls == 0)
+    return(1);
+  return(nMismatches);
+}
@@ -0,0 +1,95 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+/** \file replay_verifier.h
+ *
+ *  Re-runs a flight which has been recorded in deterministic mode.
+ */
+
+#ifndef REPLAY_VERIFIER_H
+#define REPLAY_VERIFIER_H
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <stdint.h>
+#include "mod_misc/SimpleXMLTransfer.h"
+
+class ModFDMInterface;
+class TSimInputs;
+
+
+/**
+ *  Feeds the inputs and step counts of a record written in
+ *  deterministic mode (see FlightRecorder::SimulationStep()) into the
+ *  simulation again and compares the hash of the aircraft's state
+ *  after every call with the recorded one.
+ *
+ *  The simulation has to be set up like it was when the flight was
+ *  recorded: the seed, the FDM step and the airplane are taken from the
+ *  header, location, wind, thermals and game mode have to be configured
+ *  the same way. Run() has to be called right after a reset, like the
+ *  record has been started.
+ *
+ *  This checks optimisations of the flight models and of the
+ *  environment: they must not change a single bit of a recorded flight.
+ */
+class ReplayVerifier
+{
+  public:
+    /**
+     *  One call of the simulation, see simulation_step()
+     */
+    typedef void (*T_Step)(TSimInputs* inputs, int multiloop);
+
+    /**
+     *  Opens the record and reads its header. Throws XMLException if
+     *  it is no valid record.
+     */
+    ReplayVerifier(std::string filename);
+    ~ReplayVerifier();
+
+    /// true if the record contains simulation steps
+    bool isDeterministic() const { return(fDeterministic); };
+
+    uint64_t    getSeed()         const { return(uSeed); };
+    double      getDt()           const { return(dDt); };
+    std::string getAirplaneFile() const { return(sAirplaneFile); };
+
+    /**
+     *  Replays all steps and prints the result.
+     *
+     *  \param step  called with the recorded inputs and step counts
+     *  \param fdm   the state of fdm->fdm is compared after every call
+     *  \return number of calls after which the state differs
+     */
+    unsigned long Run(std::ostream& out, T_Step step, ModFDMInterface* fdm);
+
+  private:
+    std::string   sFilename;
+    std::ifstream infile;
+
+    bool          fDeterministic;
+    uint64_t      uSeed;
+    double        dDt;
+    std::string   sAirplaneFile;
+};
+
+#endif
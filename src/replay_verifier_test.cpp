@@ -0,0 +1,247 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+/**
+ * \file replay_verifier_test.cpp
+ *
+ * Records a short flight in deterministic mode (option -e) and
+ * replays it with ReplayVerifier, without a window.
+ *
+ * Usage: replay_verifier_test [-n frames] [-d dir] model.xml [model.xml ...]
+ *
+ * Every model is flown for some frames (default 300) with changing
+ * inputs, keys and 1 to 4 steps per frame, in calm air far above the
+ * ground. The FlightRecorder writes the simulation steps and the
+ * positions, once compressed and once not, plus a marker and some
+ * XML, to dir (default: the current directory).
+ *
+ * Each record is replayed from the same start: ReplayVerifier::Run()
+ * has to return 0. It is replayed once more from a start 1 ft higher,
+ * then it has to find the difference. RobotFile, which skips the
+ * simulation steps, has to find the description at the end.
+ *
+ * The return value is the number of failed replays.
+ */
+#include <iostream>
+#include <sstream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <math.h>
+
+#include "global.h"
+#include "record.h"
+#include "replay_verifier.h"
+#include "mod_fdm/fdm.h"
+#include "mod_fdm/fdm_test_env.h"
+#include "mod_fdm/xmlmodelfile.h"
+#include "mod_robots/robotfile.h"
+#include "mod_misc/SimpleXMLTransfer.h"
+
+/**
+ * Default FDM step (simulation.flightModel.dt)
+ */
+#define FDM_DT  0.002777
+
+static FDMTestEnviroment env;
+static ModFDMInterface* fdm = NULL;
+
+/**
+ * The flight model's part of simulation_step()
+ */
+static void step(TSimInputs* inputs, int multiloop)
+{
+  fdm->update(inputs, Global::dt, multiloop);
+}
+
+/**
+ * Loads the model and puts it at its start, dHeight above the usual
+ * one. Returns false if it can't be loaded.
+ */
+static bool start(const char* filename, double dHeight)
+{
+  delete fdm;
+  fdm = new ModFDMInterface();
+
+  try
+  {
+    SimpleXMLTransfer xml(filename);
+    SimpleXMLTransfer cfg;
+
+    XMLModelFile::SetGraphics(&xml, 0);
+    XMLModelFile::SetConfig  (&xml, 0);
+    fdm->loadAirplane(&xml, &env, &cfg);
+  }
+  catch (XMLException& e)
+  {
+    std::cout << e.what() << "\n";
+    return(false);
+  }
+
+  fdm->initAirplaneState(1.0, 0, 0, M_PI/2, 0, 0, -300 - dHeight);
+  return(true);
+}
+
+/**
+ * Flies the model for nFrames frames and records it like
+ * SimStateHandler does with option -e.
+ */
+static void record(FlightRecorder& recorder, const char* filename,
+                   std::string const& name, int nFrames)
+{
+  SimpleXMLTransfer header;
+  SimpleXMLTransfer marker;
+  TSimInputs        inputs;
+
+  header.setAttribute("airplane.file", filename);
+  recorder.Start(&header);
+  recorder.SetFilename(name);
+
+  marker.setName("test");
+  marker.setAttribute("name", name);
+
+  for (int n = 0; n < nFrames; n++)
+  {
+    int        multiloop = 1 + n % 4;
+    TSimInputs recorded;
+
+    inputs.aileron  = (float)(0.3*sin(0.031*n));
+    inputs.elevator = (float)(0.2*sin(0.05*n));
+    inputs.rudder   = (float)(0.1*cos(0.02*n));
+    inputs.throttle = (float)(0.5 + 0.5*sin(0.01*n));
+    inputs.aux[0]   = (float)(0.4*sin(0.07*n));
+    if (n % 50 == 25)
+      inputs.AddKey(n);
+
+    // the inputs as the flight model gets them, it consumes the keys
+    recorded.CopyFrom(&inputs);
+    step(&inputs, multiloop);
+    recorder.SimulationStep(multiloop, &recorded, fdm->fdm);
+    recorder.AirplanePosition(Global::dt, multiloop, fdm->fdm);
+    inputs.ClearKeys();
+
+    if (n == nFrames/2)
+    {
+      recorder.InsertMarker(n);
+      recorder.InsertXML(&marker);
+    }
+  }
+  recorder.descr = name;
+  recorder.Stop();
+}
+
+/**
+ * Replays a record from a start dHeight above the recorded one.
+ * \return what ReplayVerifier::Run() returns, 1 if it can't be done
+ */
+static unsigned long replay(std::string const& file, double dHeight, std::string& msg)
+{
+  std::ostringstream out;
+  unsigned long      nResult = 1;
+
+  try
+  {
+    ReplayVerifier verifier(file);
+
+    Global::dt = verifier.getDt();
+    if (start(verifier.getAirplaneFile().c_str(), dHeight))
+      nResult = verifier.Run(out, step, fdm);
+  }
+  catch (XMLException& e)
+  {
+    out << file << ": " << e.what() << "\n";
+  }
+  msg += out.str();
+  return(nResult);
+}
+
+
+int main(int argc, char** argv)
+{
+  int                      nFrames = 300;
+  std::string              dir     = ".";
+  std::vector<std::string> files;
+
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "-n") == 0 && i+1 < argc)
+      nFrames = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-d") == 0 && i+1 < argc)
+      dir = argv[++i];
+    else
+      files.push_back(argv[i]);
+  }
+  if (files.size() == 0)
+  {
+    printf("Usage: replay_verifier_test [-n frames] [-d dir] model.xml [model.xml ...]\n");
+    return 1;
+  }
+
+  FlightRecorder recorder(dir);
+  std::string    results;
+  int            nErrors = 0;
+
+  Global::dt = FDM_DT;
+  recorder.SetDeterministic(true);
+
+  for (unsigned int f = 0; f < files.size(); f++)
+  {
+    const char* filename = files[f].c_str();
+
+    for (int nCompress = 0; nCompress < 2; nCompress++)
+    {
+      std::string name = "replay_verifier_test" + std::string(nCompress ? "_c" : "");
+      std::string file = dir + "/" + name + ".crrclog";
+
+      Global::dt = FDM_DT;
+      if (!start(filename, 0))
+      {
+        results += files[f] + ": can't be loaded\n";
+        nErrors++;
+        break;
+      }
+      recorder.SetCompress(nCompress != 0);
+      record(recorder, filename, name, nFrames);
+
+      if (RobotFile(file).ReadDescription() != name)
+      {
+        results += file + ": RobotFile doesn't find the description\n";
+        nErrors++;
+      }
+
+      if (replay(file, 0, results) != 0)
+      {
+        results += "  the replay differs\n";
+        nErrors++;
+      }
+      if (replay(file, 1.0, results) == 0)
+      {
+        results += "  a different start hasn't been found\n";
+        nErrors++;
+      }
+    }
+  }
+  delete fdm;
+
+  // the FDMs print a lot while loading
+  printf("\n%s%d errors\n", results.c_str(), nErrors);
+  return nErrors;
+}
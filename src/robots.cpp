@@ -22,12 +22,30 @@
 #include "mod_misc/filesystools.h"
 #include "mod_fdm/xmlmodelfile.h"
 #include "mod_robots/robot.h"
+#include "crrc_sound.h"
+#include "global.h"
+#include "mod_landscape/crrc_scenery.h"
+#include "mod_misc/scheduler.h"
+#include "mod_misc/worker_pool.h"
 
 
 #include <iostream>
+#include <cstdio>
+
+/// with less robots the update is done without the worker threads
+#define ROBOTS_PARALLEL_MIN  (32)
 
 Robots::Robots()
+  : pool(0), dUpdateDt(0), nUpdateSteps(0),
+    nStateUpdates(0), nPublishes(0), nMaxRobots(0),
+    dStateTime(0), dPublishTime(0)
+{
+}
+
+Robots::~Robots()
 {
+  if (pool)
+    delete pool;
 }
 
 void Robots::AddRobot(std::string robotfilename)
@@ -39,12 +57,13 @@ void Robots::AddRobot(std::string robotfilename)
   robot->fi->loadAirplane(robotfilename.c_str(), (FDMEnviroment*)0, (SimpleXMLTransfer*)0);  
   if (robot->fi->robot)
   {    
-    SimpleXMLTransfer* header = robot->fi->robot->GetHeader();
+    SimpleXMLTransfer* header   = robot->fi->robot->GetHeader();
+    SimpleXMLTransfer* airplane = header->getChild("airplane");
     
-    std::string filename = FileSysTools::getDataPath(header->getString("airplane.file"));
+    std::string filename = FileSysTools::getDataPath(airplane->getHandle("file").getString());
     
     SimpleXMLTransfer* xml = new SimpleXMLTransfer(filename);
-    XMLModelFile::SetGraphics(xml, header->getInt("airplane.graphics"));
+    XMLModelFile::SetGraphics(xml, airplane->getHandle("graphics").getInt());
     SimpleXMLTransfer* graphics = XMLModelFile::getGraphics(xml);
     
     // 
@@ -52,24 +71,159 @@ void Robots::AddRobot(std::string robotfilename)
                                              "textures",
                                              CRRCMath::Vector3(), // todo
                                              xml);
+
+    AddSounds(robot, xml);
   
     list.push_back(robot);
   }
 }
 
+void Robots::AddSounds(Robot* robot, SimpleXMLTransfer* xml)
+{
+  if (Global::soundserver == (CRRCAudioServer*)0)
+    return;
+
+  SimpleXMLTransfer* sndcfg = XMLModelFile::getConfig(xml)->getChild("sound", true);
+
+  for (int i = 0; i < sndcfg->getChildCount(); i++)
+  {
+    SimpleXMLTransfer* child = sndcfg->getChildAt(i);
+
+    // glider sounds depend on the velocity relative to the trimmed
+    // flight velocity, which is only known for the player's model
+    if (child->getName().compare("sample") != 0 ||
+        child->getHandle("type").getInt(SOUND_TYPE_GLIDER) == SOUND_TYPE_GLIDER)
+      continue;
+
+    std::string soundfile = child->attribute("filename");
+    if (soundfile != "")
+      soundfile = FileSysTools::getDataPath("sounds/" + soundfile);
+    if (!FileSysTools::fileExists(soundfile))
+      soundfile = FileSysTools::getDataPath("sounds/fan.wav");
+
+    double dMaxVolume = child->getHandle("maxvolume").getDouble(1.0);
+    if (dMaxVolume < 0.0)
+      dMaxVolume = 0.0;
+    else if (dMaxVolume > 1.0)
+      dMaxVolume = 1.0;
+
+    try
+    {
+      robot->sound.push_back(new T_EngineVoice(soundfile.c_str(),
+                                               child->getHandle("pitchfactor").getDouble(0.002),
+                                               dMaxVolume));
+    }
+    catch (std::runtime_error& e)
+    {
+      std::cerr << "Robot sound: " << e.what() << std::endl;
+    }
+  }
+}
+
+void Robots::UpdateState(void* robots, int n)
+{
+  Robots*     self = (Robots*)robots;
+  TSimInputs  dummy;
+  FDMBase*    fdm  = self->list[n]->fi->fdm;
+
+  self->list[n]->fi->update(&dummy, self->dUpdateDt, self->nUpdateSteps);
+
+  self->states[n].pos      = fdm->getPos();
+  self->states[n].euler    = CRRCMath::Vector3(fdm->getPhi(), fdm->getTheta(), fdm->getPsi());
+  self->states[n].propFreq = fdm->getPropFreq();
+}
+
 void Robots::Update(double dt, int multiloop)
 {
-  TSimInputs dummy;
-  for (unsigned int n=0; n<list.size(); n++)
+  UpdateStates(dt, multiloop);
+  Publish(states);
+}
+
+void Robots::UpdateStates(double dt, int multiloop)
+{
+  unsigned int nRobots = list.size();
+
+  if (nRobots == 0)
+    return;
+
+  double dStart = Scheduler::getSeconds();
+
+  // every robot only touches its own state
+  dUpdateDt    = dt;
+  nUpdateSteps = multiloop;
+  states.resize(nRobots);
+
+  if (nRobots >= ROBOTS_PARALLEL_MIN)
   {
-    list[n]->fi->update(&dummy, dt, multiloop);
-    
+    if (pool == 0)
+      pool = new WorkerPool();
+    pool->run(UpdateState, this, nRobots);
+  }
+  else
+  {
+    for (unsigned int n=0; n<nRobots; n++)
+      UpdateState(this, n);
+  }
+
+  dStateTime += Scheduler::getSeconds() - dStart;
+  nStateUpdates++;
+  if (nRobots > nMaxRobots)
+    nMaxRobots = nRobots;
+}
+
+void Robots::Publish(const std::vector<T_RobotState>& states)
+{
+  CRRCMath::Vector3 player_pos;
+  // robots which have been added after the last state update
+  // are left out
+  unsigned int      nRobots = states.size();
+
+  if (nRobots > list.size())
+    nRobots = list.size();
+  if (nRobots == 0)
+    return;
+
+  if (Global::soundserver != (CRRCAudioServer*)0)
+    player_pos = Global::scenery->getPlayerPosition();
+
+  double dStart = Scheduler::getSeconds();
+
+  for (unsigned int n=0; n<nRobots; n++)
+  {
+    const T_RobotState& state = states[n];
+
     Video::set_position(list[n]->vis_id,
-                        list[n]->fi->fdm->getPos(),
-                        list[n]->fi->fdm->getPhi(),
-                        list[n]->fi->fdm->getTheta(),
-                        list[n]->fi->fdm->getPsi());
+                        state.pos,
+                        state.euler.r[0],
+                        state.euler.r[1],
+                        state.euler.r[2]);
+
+    if (list[n]->sound.size())
+    {
+      CRRCMath::Vector3 vPos(state.pos.r[0], -1 * state.pos.r[2], state.pos.r[1]);
+      float             flDist = (vPos - player_pos).length();
+
+      for (unsigned int i=0; i<list[n]->sound.size(); i++)
+        list[n]->sound[i]->update(flDist, state.propFreq);
+    }
   }
+
+  dPublishTime += Scheduler::getSeconds() - dStart;
+  nPublishes++;
+}
+
+void Robots::printStats(std::ostream& out)
+{
+  if (nStateUpdates == 0 || nPublishes == 0)
+    return;
+
+  char line[160];
+  snprintf(line, sizeof(line), "Robots: up to %u, ms/update: state %.3f (%lu, %i threads)  publish %.3f (%lu)",
+          nMaxRobots,
+          1e3*dStateTime/nStateUpdates, nStateUpdates,
+          (pool != 0) ? pool->getThreadCount() : 1,
+          1e3*dPublishTime/nPublishes, nPublishes);
+  out << line << std::endl;
 }
 
 void Robots::Reset()
@@ -85,6 +239,8 @@ void Robots::RemoveAll()
   for (unsigned int n=0; n<list.size(); n++)
   {
     Video::delete_visualization(list[n]->vis_id);
+    for (unsigned int i=0; i<list[n]->sound.size(); i++)
+      delete list[n]->sound[i];
     delete list[n]->fi;
   }
   list.clear();
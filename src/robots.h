@@ -22,9 +22,14 @@
 # define ROBOTS_H
 
 #include <string>
+#include <vector>
+#include <iostream>
 #include "global_video.h"
 
 class ModRobotInterface;
+class SimpleXMLTransfer;
+class T_EngineVoice;
+class WorkerPool;
 
 /**
  * data for one robot
@@ -36,12 +41,31 @@ class Robot
 public:
   ModRobotInterface* fi;
   long vis_id;
+  std::vector<T_EngineVoice*> sound;  ///< engine sounds, if there is a sound server
 };
 
+/**
+ * What is displayed of a robot after a state update
+ */
+typedef struct
+{
+  CRRCMath::Vector3 pos;
+  CRRCMath::Vector3 euler;    ///< phi, theta, psi
+  float             propFreq;
+} T_RobotState;
+
 /**
  * Handles the list of robots (adding, removing, calling their
  * state update, updating their display, ..)
  * 
+ * The update is done in two phases: the states of all robots are
+ * updated on a pool of threads, every robot writes its pose to its
+ * own entry of an array. Then the poses are handed to the scene graph
+ * and the sounds one after the other. The robots don't share any
+ * state, and they don't query the environment. With a SimThread the
+ * states are updated by it every step, it hands them to the main
+ * thread with its snapshots, and they are published once per frame.
+ *
  * See documentation/record_playback/
  *
  * @author Jens W. Wulf
@@ -55,6 +79,8 @@ public:
    */
   Robots();
   
+  ~Robots();
+  
   /**
    * call this to load and add a robot
    */
@@ -62,8 +88,28 @@ public:
   
   void RemoveAll();
   
+  /**
+   * Updates the states of all robots, then publishes them.
+   */
   void Update(double dt, int steps);
   
+  /**
+   * Updates the states of all robots (the parallel phase)
+   */
+  void UpdateStates(double dt, int steps);
+  
+  /**
+   * The states of the last update, call on the thread which
+   * updates them
+   */
+  const std::vector<T_RobotState>& getStates() const { return(states); };
+  
+  /**
+   * Hands states from getStates() to the scene graph and the sounds
+   * (the serial phase). Doesn't look at the states of the robots.
+   */
+  void Publish(const std::vector<T_RobotState>& states);
+  
   void Reset();
   
   /**
@@ -71,8 +117,36 @@ public:
    */
   void AnnounceMarker(int id);
   
+  /**
+   * Prints the time used by Update()
+   */
+  void printStats(std::ostream& out);
+  
 private:
+  /**
+   * Creates a voice for every engine sound of the airplane
+   */
+  void AddSounds(Robot* robot, SimpleXMLTransfer* xml);
+
+  /**
+   * Updates the state of robot n, runs on the worker threads
+   */
+  static void UpdateState(void* robots, int n);
+
   std::vector<Robot*> list;
+  
+  /// state of every robot after the last update
+  std::vector<T_RobotState> states;
+  
+  WorkerPool* pool;               ///< created with the first big update
+  double      dUpdateDt;
+  int         nUpdateSteps;
+  
+  unsigned long nStateUpdates;    ///< state updates with robots
+  unsigned long nPublishes;
+  unsigned int  nMaxRobots;
+  double        dStateTime;       ///< total time of the parallel phase
+  double        dPublishTime;     ///< total time of the serial phase
 };
 
 #endif
@@ -0,0 +1,165 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+/** \file sim_thread.cpp
+ *
+ *  Runs the simulation on its own thread, at a fixed step rate.
+ */
+
+#include <math.h>
+
+#include "sim_thread.h"
+#include "global.h"
+#include "aircraft.h"
+#include "SimStateHandler.h"
+#include "mod_misc/scheduler.h"
+
+
+T_SnapshotFDM::T_SnapshotFDM()
+{
+  header = 0;
+  state.propFreq              = 0;
+  state.vRelAirmass           = 0;
+  state.batCapLeft            = 1;
+  state.trimmedFlightVelocity = 1;
+}
+
+
+void T_SnapshotFDM::set(const T_AircraftState& state)
+{
+  this->state = state;
+  v3Pos       = state.pos;
+  v3Euler     = state.euler;
+}
+
+
+SimThread::SimThread()
+  : FixedStepThread(Global::dt),
+    nFrameSteps(0), fHaveLast(false), fHaveSnapshot(false)
+{
+}
+
+
+SimThread::~SimThread()
+{
+  stop();
+}
+
+
+int SimThread::takeSteps()
+{
+  int n = nFrameSteps;
+  nFrameSteps = 0;
+  return n;
+}
+
+
+void SimThread::readState(T_AircraftState& state)
+{
+  FDMBase* fdm = Global::aircraft->getFDM();
+
+  if (fdm == NULL)
+    return;
+
+  state.pos                   = fdm->getPos();
+  state.euler                 = CRRCMath::Vector3(fdm->getPhi(), fdm->getTheta(), fdm->getPsi());
+  state.vel                   = fdm->getVel();
+  state.propFreq              = fdm->getPropFreq();
+  state.vRelAirmass           = fdm->getVRelAirmass();
+  state.batCapLeft            = fdm->getBatCapLeft();
+  state.trimmedFlightVelocity = fdm->getTrimmedFlightVelocity();
+}
+
+
+void SimThread::Step(unsigned long nStep)
+{
+  // a paused simulation is still published, the aircraft might
+  // have been reset or replaced
+  if (Global::Simulation->isStepping())
+  {
+    simulation_thread_step(&inputs);
+    nFrameSteps++;
+  }
+
+  T_SimSnapshot& snap = snapshots.getWriteBuffer();
+  readState(snap.cur);
+  snap.prev  = fHaveLast ? last : snap.cur;
+  if (Global::training_mode==TRUE)
+    get_thermals(snap.cur.pos, snap.thermals);
+  else
+    snap.thermals.clear();
+  snap.robots = Global::robots->getStates();
+  snap.dTime = getStepTime(nStep + 1);   // the state at the end of the step
+  last       = snap.cur;
+  fHaveLast  = true;
+  snapshots.publish();
+}
+
+
+/**
+ *  Difference of two angles, -pi..pi
+ */
+static double angleDiff(double a, double b)
+{
+  double d = fmod(a - b, 2*M_PI);
+  if (d > M_PI)
+    d -= 2*M_PI;
+  else if (d < -M_PI)
+    d += 2*M_PI;
+  return d;
+}
+
+
+void SimThread::updateDisplay()
+{
+  if (snapshots.update())
+    fHaveSnapshot = true;
+
+  if (!fHaveSnapshot)
+  {
+    // not a single step yet
+    T_AircraftState state;
+    state.propFreq              = 0;
+    state.vRelAirmass           = 0;
+    state.batCapLeft            = 1;
+    state.trimmedFlightVelocity = 1;
+    lock();
+    readState(state);
+    unlock();
+    displayFDM.set(state);
+    return;
+  }
+
+  const T_SimSnapshot& snap = snapshots.getReadBuffer();
+  T_AircraftState      state = snap.cur;
+
+  // snap.cur is valid at snap.dTime, snap.prev one step earlier
+  double a = (Scheduler::getSeconds() - snap.dTime) / getStep() + 1;
+  if (a < 0)
+    a = 0;
+  else if (a > 1)
+    a = 1;
+
+  state.pos = snap.prev.pos + (snap.cur.pos - snap.prev.pos) * a;
+  for (int i = 0; i < 3; i++)
+    state.euler.r[i] = snap.prev.euler.r[i] + a * angleDiff(snap.cur.euler.r[i], snap.prev.euler.r[i]);
+
+  displayFDM.set(state);
+}
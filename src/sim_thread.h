@@ -0,0 +1,155 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+/** \file sim_thread.h
+ *
+ *  Runs the simulation on its own thread, at a fixed step rate.
+ */
+
+#ifndef SIM_THREAD_H
+#define SIM_THREAD_H
+
+#include <vector>
+
+#include "mod_fdm/fdm_inputs.h"
+#include "mod_math/vector3.h"
+#include "mod_misc/fixed_step_thread.h"
+#include "mod_misc/triple_buffer.h"
+#include "mod_robots/robot.h"
+#include "mod_windfield/windfield.h"
+#include "robots.h"
+
+
+/**
+ *  What is displayed of the aircraft after a simulation step.
+ */
+typedef struct
+{
+  CRRCMath::Vector3 pos;
+  CRRCMath::Vector3 euler;            ///< phi, theta, psi
+  CRRCMath::Vector3 vel;
+  double            propFreq;
+  double            vRelAirmass;
+  double            batCapLeft;
+  double            trimmedFlightVelocity;
+} T_AircraftState;
+
+/**
+ *  Published after every simulation step: the state of this step
+ *  and of the one before, and the wall clock time at which this
+ *  state is valid. The thermals around the aircraft (in training
+ *  mode only) and the robots are those of this step.
+ */
+typedef struct
+{
+  double                      dTime;
+  T_AircraftState             cur;
+  T_AircraftState             prev;
+  std::vector<T_ThermalState> thermals;
+  std::vector<T_RobotState>   robots;
+} T_SimSnapshot;
+
+
+/**
+ *  Hands out an interpolated T_AircraftState to code which only
+ *  displays the aircraft, like CRRCAirplane::draw() and the sound.
+ */
+class T_SnapshotFDM : public RobotBase
+{
+  public:
+    T_SnapshotFDM();
+
+    void set(const T_AircraftState& state);
+
+    virtual CRRCMath::Vector3 getVel()  { return(state.vel); };
+    virtual double getPropFreq()        { return(state.propFreq); };
+    virtual double getVRelAirmass()     { return(state.vRelAirmass); };
+    virtual double getBatCapLeft()      { return(state.batCapLeft); };
+    virtual double getTrimmedFlightVelocity() { return(state.trimmedFlightVelocity); };
+
+    virtual void initAirplaneState(double dRelVel, double dPhi, double dTheta,
+                                   double dPsi, double X, double Y, double Z,
+                                   double R_X = 0.0, double R_Y = 0.0,
+                                   double R_Z = 0.0) {};
+
+    virtual void update(TSimInputs* inputs, double dt, int multiloop) {};
+
+  private:
+    T_AircraftState state;
+};
+
+
+/**
+ *  Runs thermals, the aircraft's FDM and the robots one step of
+ *  Global::dt at a time, no matter how long the frames take. Every
+ *  step publishes a T_SimSnapshot, the main thread interpolates the
+ *  aircraft between the last two steps for display.
+ *
+ *  Everything else stays on the main thread. It holds the lock while
+ *  it handles events and input, calls doIdle() (which follows the
+ *  steps done since the last frame) and runs the GUI tasks. It
+ *  releases it while the robots are published, the scene is culled,
+ *  drawn and swapped, and for the sound. Those only look at the
+ *  snapshot.
+ */
+class SimThread : public FixedStepThread
+{
+  public:
+    SimThread();
+    ~SimThread();
+
+    /// Control inputs for the next steps, call with the lock held
+    void setInputs(const TSimInputs& in) { inputs = in; };
+
+    /// Steps done since the last call, call with the lock held
+    int takeSteps();
+
+    /// Interpolates the aircraft for the current time, call without
+    /// the lock
+    void updateDisplay();
+
+    /// The interpolated aircraft
+    FDMBase* getDisplayFDM() { return &displayFDM; };
+
+    /// The snapshot taken by updateDisplay(), NULL before the first
+    /// step, call without the lock
+    const T_SimSnapshot* getSnapshot() const
+    {
+      return fHaveSnapshot ? &snapshots.getReadBuffer() : NULL;
+    };
+
+  protected:
+    void Step(unsigned long nStep);
+
+  private:
+    /// Reads the state of the aircraft, call with the lock held
+    static void readState(T_AircraftState& state);
+
+    TSimInputs                   inputs;
+    int                          nFrameSteps;
+    T_AircraftState              last;
+    bool                         fHaveLast;
+    bool                         fHaveSnapshot;
+
+    TripleBuffer<T_SimSnapshot>  snapshots;
+    T_SnapshotFDM                displayFDM;
+};
+
+#endif
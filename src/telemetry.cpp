@@ -0,0 +1,99 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+/** \file telemetry.cpp
+ *
+ *  Publishes every step of the flight model to shared memory.
+ */
+
+#include <cstring>
+
+#include "telemetry.h"
+#include "config.h"
+#include "mod_fdm/fdm.h"
+#include "mod_fdm/fdm_inputs.h"
+
+
+TelemetryExport::TelemetryExport(std::string name, unsigned int capacity)
+  : nResets(0)
+{
+  telemetry = crrc_telemetry_create(name.c_str(), capacity);
+  memset(&sample, 0, sizeof(sample));
+}
+
+
+TelemetryExport::~TelemetryExport()
+{
+  crrc_telemetry_close(&telemetry);
+}
+
+
+void TelemetryExport::reset(double dt)
+{
+  if (telemetry == NULL)
+    return;
+
+  nResets++;
+  crrc_telemetry_set_info(telemetry, dt, nResets,
+                          cfgfile->getString("airplane.file", "").c_str());
+}
+
+
+void TelemetryExport::step(double dTime, const TSimInputs* inputs, FDMBase* fdm)
+{
+  if (telemetry == NULL)
+    return;
+
+  CRRCMath::Vector3 pos   = fdm->getPos();
+  CRRCMath::Vector3 vel   = fdm->getVel();
+  CRRCMath::Vector3 accel = fdm->getAccel();
+  CRRCMath::Vector3 pqr   = fdm->getPQR();
+  double            wind[3];
+
+  fdm->GetEnv()->CalculateWind(pos.r[0], pos.r[1], pos.r[2], wind[0], wind[1], wind[2]);
+
+  sample.reset = nResets;
+  sample.time  = dTime;
+  for (int i = 0; i < 3; i++)
+  {
+    sample.pos[i]   = pos.r[i];
+    sample.vel[i]   = vel.r[i];
+    sample.accel[i] = accel.r[i];
+    sample.pqr[i]   = pqr.r[i];
+    sample.wind[i]  = wind[i];
+  }
+  sample.euler[0]      = fdm->getPhi();
+  sample.euler[1]      = fdm->getTheta();
+  sample.euler[2]      = fdm->getPsi();
+  sample.v_rel_airmass = fdm->getVRelAirmass();
+
+  sample.inputs[0] = inputs->aileron;
+  sample.inputs[1] = inputs->elevator;
+  sample.inputs[2] = inputs->rudder;
+  sample.inputs[3] = inputs->throttle;
+  sample.inputs[4] = inputs->flap;
+  sample.inputs[5] = inputs->spoiler;
+  sample.inputs[6] = inputs->retract;
+  sample.inputs[7] = inputs->pitch;
+  for (int i = 0; i < TSimInputs::NUM_AUX_INPUTS && 8+i < CRRC_TELEMETRY_INPUTS; i++)
+    sample.inputs[8+i] = inputs->aux[i];
+
+  crrc_telemetry_write(telemetry, &sample);
+}
@@ -0,0 +1,83 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *   Copyright (C) 2026 - The CRRCsim team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+/** \file telemetry.h
+ *
+ *  Publishes every step of the flight model to shared memory.
+ */
+
+#ifndef TELEMETRY_H
+# define TELEMETRY_H
+
+# include <string>
+
+# include "mod_misc/telemetry_shm.h"
+
+class FDMBase;
+class TSimInputs;
+
+/**
+ * Writes state, inputs and wind of every step of the flight model
+ * into a telemetry ring (see telemetry_shm.h), where other programs
+ * like crrc_telemetry can follow them while the simulation runs.
+ *
+ * Writing a sample doesn't involve a system call and never waits for
+ * a reader. step() has to be called from the thread which steps the
+ * flight model.
+ */
+class TelemetryExport
+{
+public:
+
+  /**
+   * Creates the shared memory object name with capacity samples.
+   * Check isOpen() afterwards.
+   */
+  TelemetryExport(std::string name, unsigned int capacity);
+
+  /**
+   * Removes the shared memory object.
+   */
+  ~TelemetryExport();
+
+  bool isOpen() const { return(telemetry != NULL); };
+
+  /**
+   * The simulation has been reset: the time starts at zero again,
+   * the aircraft or the time step might have changed.
+   */
+  void reset(double dt);
+
+  /**
+   * Publishes the state after a step of the flight model.
+   *
+   * \param dTime  simulation time since the last reset [s]
+   * \param inputs inputs of the step
+   * \param fdm    the flight model
+   */
+  void step(double dTime, const TSimInputs* inputs, FDMBase* fdm);
+
+private:
+  CrrcTelemetry         telemetry;
+  uint32_t              nResets;
+  crrc_telemetry_sample sample;
+};
+
+#endif